@@ -27,7 +27,7 @@ option(USE_MALI "set use mali for parallel or not" OFF)
 option(USE_FP32 "set use ARM NEON FP32 instruction or not" ON)
 option(USE_FP16 "set use ARM NEON FP16 instruction or not" ON)
 option(USE_F16_MIX_PRECISION "set use ARM NEON mix precision f16/f32 instruction or not" ON)
-option(USE_INT8 "set use ARM NEON INT8 instruction or not" ON)
+option(USE_INT8 "set use ARM NEON or x86 INT8 instruction or not" ON)
 
 option(USE_OPENMP "set use openmp to run test(tinybert) or not" OFF)
 option(USE_LIBRARY_TUNING "set use algorithm tuning or not" OFF)
@@ -94,6 +94,9 @@ macro (set_c_cxx_flags)
     
     if (USE_X86)
         set(COMMON_FLAGS "${COMMON_FLAGS} -D_USE_X86 -mavx2 -mfma")
+        if (USE_INT8)
+            set(COMMON_FLAGS "${COMMON_FLAGS} -D_USE_INT8")
+        endif (USE_INT8)
     endif(USE_X86)
 
     if (USE_IOS_CLANG)
@@ -379,7 +382,7 @@ endmacro()
 macro(flow_test name src_name)
     include_protobuf()
     include_directories(${BOLT_ROOT}/flow/include)
-    if ("${name}" STREQUAL "flow_asr")
+    if ("${name}" STREQUAL "flow_asr" OR "${name}" STREQUAL "audio_feature_benchmark")
         set_policy()
         find_package(FFTW)
         add_executable(${name} ${src_name})
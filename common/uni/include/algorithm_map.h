@@ -41,6 +41,7 @@ public:
         this->commonAlgoFileName += "_";
         this->commonAlgoFileName += std::to_string(dt);
         this->hasCommonAlgoFile = false;
+        this->tuning = false;
     }
 
     void setAlgorithmInfoToMap(
@@ -83,6 +84,20 @@ public:
         return true;
     }
 
+    void setAlgorithmInfoToMap(std::string name, std::string algoInfo)
+    {
+        this->algorithmMap[name] = algoInfo;
+    }
+
+    std::string getAlgorithmInfoFromMap(std::string name)
+    {
+        std::string algoInfo;
+        if (this->algorithmMap.find(name) != this->algorithmMap.end()) {
+            algoInfo = this->algorithmMap[name];
+        }
+        return algoInfo;
+    }
+
     void loadAlgorithmMapFromFileStream(const char *algoFileStream)
     {
         U32 be = 0;
@@ -112,6 +127,15 @@ public:
         this->hasAlgorithmFile = readTextForMap(algorithmFileName, algorithmMapPath, &algorithmMap);
         this->hasCommonAlgoFile =
             readTextForMap(commonAlgoFileName, algorithmMapPath, &commonAlgoMap);
+        this->tuning = !this->hasAlgorithmFile;
+    }
+
+    // The algorithms are timed on this machine when the algorithm file will be created. The
+    // tuned entries also record the measured latency in us after the algorithm, the readers that
+    // only ask for the algorithm are not affected.
+    bool needTuning()
+    {
+        return this->tuning;
     }
 
     void saveAlgorithmMapToText(std::string algorithmMapPath)
@@ -396,5 +420,6 @@ private:
     std::map<std::string, std::string> commonAlgoMap;
     std::string commonAlgoFileName;
     bool hasCommonAlgoFile;
+    bool tuning;
 };
 #endif
@@ -25,6 +25,8 @@ void print_operator_tensor_relationship(const ModelSpec ms, bool delete_deprecat
 
 void print_weights(const ModelSpec ms);
 
+void print_packed_weights(const ModelSpec ms);
+
 void print_relationship(const ModelSpec ms);
 
 void print_ms(const ModelSpec ms);
@@ -25,7 +25,11 @@ EE serialize_header(const ModelSpec *spec, std::string *tmp);
 
 EE serialize_operators(const ModelSpec *spec, std::string *tmp);
 
-EE serialize_weights(const ModelSpec *spec, std::string *tmp);
+// offset is the position of weight section in .bolt file, it is used to align weight data
+EE serialize_weights(const ModelSpec *spec, std::string *tmp, U32 offset = 0);
+
+// offset is the position of packed weight section in .bolt file
+EE serialize_packed_weights(const ModelSpec *spec, std::string *tmp, U32 offset = 0);
 
 EE serialize_model(const ModelSpec *spec, std::string *bytes);
 
@@ -45,9 +49,33 @@ EE deserialize_operator(char *bytes, ModelSpec *spec, U32 *pos);
 
 EE deserialize_weight(char *bytes, ModelSpec *spec, U32 *pos);
 
+EE deserialize_packed_weight(const char *bytes, ModelSpec *spec, U32 *pos);
+
 EE operator_relationship(ModelSpec *spec);
 
-EE deserialize_model_from_file(const char *fn, ModelSpec *spec, bool useFileStream = false);
+// if zeroCopy is set, .bolt file will keep mapped and aligned weights will directly point to it,
+// mt_destroy_model or the inference engine which takes ModelSpec::mfd will release the file.
+EE deserialize_model_from_file(
+    const char *fn, ModelSpec *spec, bool useFileStream = false, bool zeroCopy = false);
+
+bool is_model_file_memory(const ModelSpec *spec, const void *ptr);
+
+EE release_model_file(void *mfd);
+
+inline U32 weight_align_padding(const ModelSpec *spec, U32 pos)
+{
+    U32 padding = 0;
+    if (spec->version >= sg_boltAlignedWeightVersion) {
+        padding = (sg_weightAlignment - pos % sg_weightAlignment) % sg_weightAlignment;
+    }
+    return padding;
+}
+
+// padding to place packed weight at the address offset modulo sg_weightAlignment
+inline U32 packed_weight_padding(U32 pos, U32 offset)
+{
+    return (sg_weightAlignment + offset - pos % sg_weightAlignment) % sg_weightAlignment;
+}
 
 inline std::string concat_dir_file(std::string dir, std::string file)
 {
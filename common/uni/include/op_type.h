@@ -91,7 +91,8 @@ typedef enum {
     OT_Tile = 64,
     OT_Splice = 65,
     OT_Neg = 66,
-    OT_Greater = 67  // Temporary support for special case
+    OT_Greater = 67,  // Temporary support for special case
+    OT_ScaledDotProductAttention = 68
 } OperatorType;
 
 inline const char *const *OperatorTypeName()
@@ -116,7 +117,7 @@ inline const char *const *OperatorTypeName()
         "OT_AttentionMask", "OT_RelativePositionEmbedding", "OT_RelativeShift", "OT_PriorBox",
 
         "OT_DetectionOutput", "OT_Yolov3DetectionOutput", "OT_MultiHeadAttention", "OT_SqDiff",
-        "OT_Tile", "OT_Splice", "OT_Neg", "OT_Greater"};
+        "OT_Tile", "OT_Splice", "OT_Neg", "OT_Greater", "OT_ScaledDotProductAttention"};
     return names;
 }
 
@@ -14,6 +14,8 @@
 #ifndef _H_PROFILING
 #define _H_PROFILING
 
+#include <atomic>
+#include <vector>
 #include "ut_util.h"
 
 std::string extract_class_function(std::string &&pretty_function);
@@ -28,6 +30,51 @@ void ut_time_process(
     const std::string &name, const std::string &category, double time_start_ms, double time_end_ms);
 void ut_time_statistics();
 
+// The runtime profiler is built in all the time, and is switched on by
+// runtime_profile_set_enable or the environment variable BOLT_RUNTIME_PROFILE=1.
+// Every thread writes its records into its own ring buffer without any lock, the oldest records
+// are overwritten when a ring is full. Read the records when no model is running.
+typedef struct {
+    char name[64];
+    char type[32];
+    char algorithm[64];
+    char shapes[128];
+    double flops;
+    double bytes;
+    double start_ms;
+    double duration_ms;
+    // system thread id of the thread that ran the operator
+    int tid;
+    // number of layout transforms (e.g. NCHWC8 to NCHW) done inside the operator
+    int transforms;
+} ProfileRecord;
+
+extern std::atomic<bool> runtimeProfileEnable;
+
+inline bool runtime_profile_enabled()
+{
+    return runtimeProfileEnable.load(std::memory_order_relaxed);
+}
+
+void runtime_profile_set_enable(bool enable);
+
+// get a free record of the current thread, fill it and commit it
+ProfileRecord *runtime_profile_new_record();
+void runtime_profile_commit_record();
+
+// the records of all the threads, sorted by the start time
+std::vector<ProfileRecord> runtime_profile_get_records();
+void runtime_profile_clear();
+
+// the layout transform functions count themselves on the current thread when the profiler is on
+void runtime_profile_count_transform();
+U32 runtime_profile_get_transforms();
+
+// write the records in the Chrome trace event format, open the file in chrome://tracing
+EE runtime_profile_dump_chrome_trace(const char *path);
+// print the time, GFLOP/s, GB/s and layout transforms of each operator type
+void runtime_profile_summary();
+
 #ifdef _PROFILE_STATISTICS
 #define UNI_TIME_INIT ut_time_init();
 #define UNI_TIME_STATISTICS ut_time_statistics();
@@ -16,7 +16,8 @@
 
 #define _USE_WEIGHT_SHARE
 
-#include <queue>
+#include <atomic>
+#include <algorithm>
 #include <map>
 #include <vector>
 #include <string>
@@ -24,23 +25,94 @@
 #include "graph.h"
 #include "task.h"
 
+/**
+ * task queue owned by one worker, the other workers can steal tasks from it.
+ * tasks are ordered by priority, then deadline, then submission order.
+ */
+class TaskQueue {
+public:
+    TaskQueue()
+    {
+        pthread_mutex_init(&(this->lock), NULL);
+    }
+
+    ~TaskQueue()
+    {
+        pthread_mutex_destroy(&(this->lock));
+    }
+
+    void push(Task *task, unsigned long long order)
+    {
+        pthread_mutex_lock(&(this->lock));
+        this->tasks.push_back(std::make_pair(order, task));
+        std::push_heap(this->tasks.begin(), this->tasks.end(), later);
+        pthread_mutex_unlock(&(this->lock));
+    }
+
+    Task *pop()
+    {
+        Task *task = nullptr;
+        pthread_mutex_lock(&(this->lock));
+        if (!this->tasks.empty()) {
+            std::pop_heap(this->tasks.begin(), this->tasks.end(), later);
+            task = this->tasks.back().second;
+            this->tasks.pop_back();
+        }
+        pthread_mutex_unlock(&(this->lock));
+        return task;
+    }
+
+private:
+    pthread_mutex_t lock;
+    std::vector<std::pair<unsigned long long, Task *>> tasks;
+
+    // whether task a should be processed after task b
+    static bool later(const std::pair<unsigned long long, Task *> &a,
+        const std::pair<unsigned long long, Task *> &b)
+    {
+        if (a.second->priority != b.second->priority) {
+            return a.second->priority < b.second->priority;
+        }
+        if (a.second->deadline != b.second->deadline) {
+            if (a.second->deadline <= 0) {
+                return true;
+            }
+            if (b.second->deadline <= 0) {
+                return false;
+            }
+            return a.second->deadline > b.second->deadline;
+        }
+        return a.first > b.first;
+    }
+};
+
 template <class GraphParameter, class ComputeNode, class DataTensor>
 class Schedule {
 public:
     Schedule()
     {
-        pthread_mutex_init(&(this->taskQueueLock), NULL);
-        pthread_cond_init(&(this->condition), NULL);
+        pthread_mutex_init(&(this->idleLock), NULL);
+        pthread_cond_init(&(this->idleCondition), NULL);
+        pthread_mutex_init(&(this->finishLock), NULL);
+        pthread_cond_init(&(this->finishCondition), NULL);
         this->threadNum = 0;
+        this->threads = nullptr;
+        this->taskQueues = nullptr;
         this->stop = false;
+        this->taskNum = 0;
+        this->idleNum = 0;
+        this->workerNum = 0;
+        this->taskOrder = 0;
     }
 
     ~Schedule()
     {
-        pthread_mutex_lock(&(this->taskQueueLock));
-        pthread_mutex_destroy(&(this->taskQueueLock));
-        pthread_cond_destroy(&(this->condition));
+        pthread_mutex_destroy(&(this->idleLock));
+        pthread_cond_destroy(&(this->idleCondition));
+        pthread_mutex_destroy(&(this->finishLock));
+        pthread_cond_destroy(&(this->finishCondition));
         delete[] this->threads;
+        delete[] this->taskQueues;
     }
 
     int init(std::vector<std::string> graphPath,
@@ -53,12 +125,6 @@ public:
         if (threadNum <= 0) {
             return 1;
         }
-        if (pthread_mutex_init(&(this->taskQueueLock), NULL)) {
-            return 1;
-        }
-        if (pthread_cond_init(&(this->condition), NULL)) {
-            return 1;
-        }
         this->precision = dataType;
         this->deviceInfo = get_cpu_info(affinityPolicy);
         this->graphPath = graphPath;
@@ -76,17 +142,19 @@ public:
             cpuId = 4;
         }
         set_thread_affinity(0, &cpuId, 1);
+        this->useGPU = useGPU;
+        this->taskQueues = new TaskQueue[threadNum];
         this->threadNum = threadNum;
         this->threads = new pthread_t[threadNum];
         for (int i = 0; i < threadNum; i++) {
             if (pthread_create(this->threads + i, NULL, worker, reinterpret_cast<void *>(this)) !=
                 0) {
+                this->threadNum = i;
                 this->end();
                 UNI_ERROR_LOG("schedule create thread pool fail\n");
                 return 1;
             }
         }
-        this->useGPU = useGPU;
         UNI_DEBUG_LOG("schedule init end\n");
         return 0;
     }
@@ -94,22 +162,25 @@ public:
     int end()
     {
         UNI_DEBUG_LOG("schedule exit begin\n");
-        if (pthread_mutex_lock(&(this->taskQueueLock)) != 0) {
+        if (pthread_mutex_lock(&(this->idleLock)) != 0) {
             return 1;
         }
-
         this->stop = true;
-
-        if ((pthread_cond_broadcast(&(this->condition)) != 0) ||
-            (pthread_mutex_unlock(&(this->taskQueueLock)) != 0)) {
+        if ((pthread_cond_broadcast(&(this->idleCondition)) != 0) ||
+            (pthread_mutex_unlock(&(this->idleLock)) != 0)) {
             return 1;
         }
+        // wake up users who are still waiting for unfinished tasks
+        pthread_mutex_lock(&(this->finishLock));
+        pthread_cond_broadcast(&(this->finishCondition));
+        pthread_mutex_unlock(&(this->finishLock));
 
         for (int i = 0; i < this->threadNum; i++) {
             if (pthread_join(this->threads[i], NULL) != 0) {
                 return 1;
             }
         }
+        this->threadNum = 0;
         UNI_DEBUG_LOG("schedule exit end\n");
         return 0;
     }
@@ -122,32 +193,79 @@ public:
                             "deprecated\n");
             return 1;
         }
-        if (pthread_mutex_lock(&(this->taskQueueLock)) != 0) {
-            UNI_WARNING_LOG("schedule enqueue task failed because of can not acquire task queue "
-                            "lock\n");
-            return 1;
-        }
         if (this->stop) {
             UNI_WARNING_LOG("schedule enqueue task failed because schedule has end\n");
             return 1;
         }
-        this->taskQueue.push(task);
-        if (pthread_cond_signal(&(this->condition)) != 0) {
-            UNI_WARNING_LOG("schedule enqueue task failed because can not find worker\n");
-            return 1;
+        // distribute tasks to workers in turn, idle workers will steal the rest
+        unsigned long long order = this->taskOrder++;
+        this->taskQueues[order % this->threadNum].push(task, order);
+        this->taskNum++;
+        if (this->idleNum > 0) {
+            pthread_mutex_lock(&(this->idleLock));
+            if (pthread_cond_signal(&(this->idleCondition)) != 0) {
+                UNI_WARNING_LOG("schedule enqueue task failed because can not find worker\n");
+                pthread_mutex_unlock(&(this->idleLock));
+                return 1;
+            }
+            pthread_mutex_unlock(&(this->idleLock));
         }
-        pthread_mutex_unlock(&(this->taskQueueLock));
         UNI_DEBUG_LOG("schedule enqueue task end\n");
         return 0;
     }
 
+    /**
+     * @brief block until task has been finished
+     * @param  task           task that has been enqueued
+     *
+     * @return finished : false if schedule exits before task is finished
+     */
+    bool wait(Task *task)
+    {
+        pthread_mutex_lock(&(this->finishLock));
+        while (task->status != TASK_END && !(this->stop)) {
+            this->waitTasks[task]++;
+            pthread_cond_wait(&(this->finishCondition), &(this->finishLock));
+            if (--this->waitTasks[task] == 0) {
+                this->waitTasks.erase(task);
+            }
+        }
+        bool finished = (task->status == TASK_END);
+        pthread_mutex_unlock(&(this->finishLock));
+        return finished;
+    }
+
+    /**
+     * @brief check whether task has been finished without blocking
+     * @param  task           task that has been enqueued
+     *
+     * @return finished
+     */
+    bool finished(Task *task)
+    {
+        pthread_mutex_lock(&(this->finishLock));
+        bool finished = (task->status == TASK_END);
+        pthread_mutex_unlock(&(this->finishLock));
+        return finished;
+    }
+
 private:
     int threadNum;
-    pthread_mutex_t taskQueueLock;
-    std::queue<Task *> taskQueue;
-    pthread_cond_t condition;
     pthread_t *threads;
-    int stop;
+    TaskQueue *taskQueues;
+    // number of tasks that are in queues
+    std::atomic<int> taskNum;
+    // number of workers that are waiting for tasks
+    std::atomic<int> idleNum;
+    std::atomic<int> workerNum;
+    std::atomic<unsigned long long> taskOrder;
+    std::atomic<bool> stop;
+    pthread_mutex_t idleLock;
+    pthread_cond_t idleCondition;
+    // tasks that users are waiting for, protected by finishLock
+    std::map<Task *, int> waitTasks;
+    pthread_mutex_t finishLock;
+    pthread_cond_t finishCondition;
 
     std::vector<std::string> graphPath;
     std::map<std::string, Graph<GraphParameter, ComputeNode, DataTensor>> graph;
@@ -156,20 +274,32 @@ private:
     DeviceInfo deviceInfo;
     DataType precision;
 
-    int getThreadId(pthread_t tid)
+    Task *fetch(int threadId)
     {
-        for (int i = 0; i < this->threadNum; i++) {
-            if (this->threads[i] == tid) {
-                return i;
-            }
+        Task *task = nullptr;
+        for (int i = 0; i < this->threadNum && task == nullptr; i++) {
+            task = this->taskQueues[(threadId + i) % this->threadNum].pop();
+        }
+        if (task != nullptr) {
+            this->taskNum--;
+        }
+        return task;
+    }
+
+    void finish(Task *task)
+    {
+        pthread_mutex_lock(&(this->finishLock));
+        task->status = TASK_END;
+        if (this->waitTasks.find(task) != this->waitTasks.end()) {
+            pthread_cond_broadcast(&(this->finishCondition));
         }
-        return -1;
+        pthread_mutex_unlock(&(this->finishLock));
     }
 
     static void *worker(void *_schedule)
     {
         Schedule *schedule = reinterpret_cast<Schedule *>(_schedule);
-        int threadId = schedule->getThreadId(pthread_self());
+        int threadId = schedule->workerNum++;
         UNI_DEBUG_LOG("worker(%d) begin\n", threadId);
         std::map<std::string, Graph<GraphParameter, ComputeNode, DataTensor>> threadPrivateGraph;
         double timeStart = ut_time_ms();
@@ -215,30 +345,23 @@ private:
         UNI_DEBUG_LOG("start to wait task\n");
         double timeEnd = ut_time_ms();
         UNI_PROFILE_INFO("graphs init", "init", timeStart * 1000, (timeEnd - timeStart) * 1000);
-        while (1) {
-            pthread_mutex_lock(&(schedule->taskQueueLock));
-            while (schedule->taskQueue.empty() && !(schedule->stop)) {
-                pthread_cond_wait(&(schedule->condition), &(schedule->taskQueueLock));
-            }
-            if (schedule->stop) {
-                break;
-            }
-
-            Task *task = nullptr;
-            if (!(schedule->taskQueue.empty())) {
-                task = schedule->taskQueue.front();
-                schedule->taskQueue.pop();
-            }
-            pthread_mutex_unlock(&(schedule->taskQueueLock));
+        while (!(schedule->stop)) {
+            Task *task = schedule->fetch(threadId);
             if (task != nullptr) {
                 threadPrivateGraph[task->graphPath].run(task->data);
-                task->status = TASK_END;
+                schedule->finish(task);
+                continue;
+            }
+            pthread_mutex_lock(&(schedule->idleLock));
+            schedule->idleNum++;
+            while (schedule->taskNum <= 0 && !(schedule->stop)) {
+                pthread_cond_wait(&(schedule->idleCondition), &(schedule->idleLock));
             }
+            schedule->idleNum--;
+            pthread_mutex_unlock(&(schedule->idleLock));
         }
-
-        pthread_mutex_unlock(&(schedule->taskQueueLock));
-        pthread_exit(NULL);
         UNI_DEBUG_LOG("worker end\n");
+        pthread_exit(NULL);
         return (NULL);
     }
 };
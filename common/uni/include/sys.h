@@ -19,13 +19,15 @@
 #endif
 #define IS_GENERAL(arch) (arch == CPU_GENERAL)
 #define IS_X86_AVX2(arch) (arch == X86_AVX2)
+#define IS_X86_AVX512(arch) (arch == X86_AVX512)
+#define IS_X86(arch) (IS_X86_AVX2(arch) || IS_X86_AVX512(arch))
 #define IS_ARM_V7(arch) (arch == ARM_V7)
 #define IS_ARM_V8(arch) (arch == ARM_V8)
 #define IS_ARM_A55(arch) (arch == ARM_A55)
 #define IS_ARM_A76(arch) (arch == ARM_A76)
 #define IS_ARM_LG_V8(arch) (IS_ARM_A55(arch) || IS_ARM_A76(arch))
 #define IS_ARM(arch) (IS_ARM_LG_V8(arch) || IS_ARM_V8(arch) || IS_ARM_V7(arch))
-#define IS_CPU(arch) (IS_GENERAL(arch) || IS_X86_AVX2(arch) || IS_ARM(arch))
+#define IS_CPU(arch) (IS_GENERAL(arch) || IS_X86(arch) || IS_ARM(arch))
 #define IS_MALI_GPU(arch) (arch == MALI)
 
 #ifdef __cplusplus
@@ -40,6 +42,7 @@ typedef enum {
     ARM_A55 = 5,
     ARM_A76 = 6,
     X86_AVX2 = 7,
+    X86_AVX512 = 8,
 } Arch;
 
 typedef struct {
@@ -49,6 +49,8 @@ public:
     Task()
     {
         this->status = TASK_CREATE;
+        this->priority = 0;
+        this->deadline = 0;
     }
 
     /**
@@ -84,7 +86,8 @@ public:
      */
     Task(Task *task)
     {
-        this->set(task->id, task->graphPath, task->data, task->status);
+        this->set(task->id, task->graphPath, task->data, task->status, task->priority,
+            task->deadline);
     }
 
     /**
@@ -93,24 +96,46 @@ public:
      * @param  graphPath      predefined flow graph file path
      * @param  data           graph input data map
      * @param  status         task status
+     * @param  priority       task priority, task with bigger value will be processed first
+     * @param  deadline       expected finish time stamp(ms), 0 means no deadline
      *
      * @return
      */
     void set(int id,
         std::string graphPath,
         std::map<std::string, std::shared_ptr<Tensor>> data,
-        TaskStatus status)
+        TaskStatus status,
+        int priority = 0,
+        double deadline = 0)
     {
         this->id = id;
         this->graphPath = graphPath;
         this->data = data;
         this->status = status;
+        this->priority = priority;
+        this->deadline = deadline;
+    }
+
+    /**
+     * @brief Task set priority function
+     * @param  priority       task priority, task with bigger value will be processed first
+     * @param  deadline       expected finish time stamp(ms, same clock as ut_time_ms), task with
+     *                        earlier deadline will be processed first when priority is equal,
+     *                        0 means no deadline
+     *
+     * @return
+     */
+    void set_priority(int priority, double deadline = 0)
+    {
+        this->priority = priority;
+        this->deadline = deadline;
     }
 
     friend std::ostream &operator<<(std::ostream &os, const Task &task)
     {
         os << "Task " << task.id << "(timestamp " << task.id << ", status " << task.status
-           << ", graph " << task.graphPath << ", data " << std::endl;
+           << ", priority " << task.priority << ", deadline " << task.deadline << ", graph "
+           << task.graphPath << ", data " << std::endl;
         for (auto iter : task.data) {
             os << "tensor name " << iter.first << " " << iter.second->string(1) << std::endl;
         }
@@ -122,6 +147,10 @@ public:
     int id;
     /** task status */
     TaskStatus status;
+    /** task priority */
+    int priority;
+    /** task deadline */
+    double deadline;
     /** predefined flow graph file path */
     std::string graphPath;
     /** graph data */
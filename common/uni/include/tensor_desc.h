@@ -79,16 +79,35 @@ typedef enum {
     DT_F32 = 6,
     DT_BIN01 = 7,
     DT_BIN11 = 8,
-    DT_NUM = 9
+    DT_F32_8Q = 9,
+    DT_NUM = 10
 } DataType;
 
 inline U32 bytesOf(DataType dt)
 {
-    U32 bytes[] = {1, 1, 4, 4, 2, 2, 4, 1, 1,
+    U32 bytes[] = {1, 1, 4, 4, 2, 2, 4, 1, 1, 4,
         8};  // Please divide number of elements by 8 first in the case of binary data types
     return dt < DT_NUM ? bytes[dt] : 0;
 }
 
+// DT_F16_8Q and DT_F32_8Q models run convolution and FC in int8, other operators and the
+// activations between them use the float type returned here
+inline bool isQuantMixDataType(DataType dt)
+{
+    return (dt == DT_F16_8Q) || (dt == DT_F32_8Q);
+}
+
+inline DataType noQuantDataType(DataType dt)
+{
+    if (dt == DT_F16_8Q) {
+        return DT_F16;
+    }
+    if (dt == DT_F32_8Q) {
+        return DT_F32;
+    }
+    return dt;
+}
+
 typedef enum {
     DF_NCHW,
     DF_NCHWN16,     // vectorize for N=16, for filter
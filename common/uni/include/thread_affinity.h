@@ -21,17 +21,23 @@
 #include "sys.h"
 #include "error.h"
 #include "tensor_desc.h"
+#ifdef _USE_OPENMP
+#include <omp.h>
+#endif
 
 #ifdef _USE_X86
 #define __cpuid(data, eaxIn, ecxIn)                                                   \
     __asm__ __volatile__("cpuid\n"                                                    \
                          : "=a"(data[0]), "=b"(data[1]), "=c"(data[2]), "=d"(data[3]) \
                          : "0"(eaxIn), "2"(ecxIn))
+#define __xgetbv(eax, ecxIn) __asm__ __volatile__("xgetbv\n" : "=a"(eax) : "c"(ecxIn) : "%edx")
 #endif
 
 const int CPU_MAX_NUMBER = 64;
 #ifdef _USE_OPENMP
-const int OMP_NUM_THREADS = 2;
+// number of threads used by the intra-op parallel region of the calling thread,
+// thread local so that models running on different threads can use different settings.
+extern thread_local int OMP_NUM_THREADS;
 #else
 const int OMP_NUM_THREADS = 1;
 #endif
@@ -105,21 +111,10 @@ inline int get_cpus_num()
 #endif
 }
 
-inline void get_cpus_arch(Arch *archs, int cpuNum)
+#ifdef _USE_X86
+// the widest vector extension that both the CPU and the OS support
+inline Arch get_x86_cpu_arch()
 {
-#ifdef _USE_IOS
-    for (int cpuid = 0; cpuid < cpuNum; cpuid++) {
-        archs[cpuid] = ARM_A76;
-    }
-    return;
-#endif
-    FILE *fp = fopen("/proc/cpuinfo", "rb");
-    *archs = CPU_GENERAL;
-    if (!fp) {
-        return;
-    }
-
-#if defined(_USE_FP32) && defined(_USE_X86)
     U32 data[4] = {};
     const U32 &ebx = data[1];
     const U32 &ecx = data[2];
@@ -127,6 +122,7 @@ inline void get_cpus_arch(Arch *archs, int cpuNum)
     const U32 osxsave = 1U << 0;
     const U32 avx = 1U << 1;
     const U32 avx2 = 1U << 2;
+    const U32 avx512 = 1U << 3;
 
     U32 cpuArch = 0;
     __cpuid(data, 0, 0);
@@ -143,10 +139,53 @@ inline void get_cpus_arch(Arch *archs, int cpuNum)
     if ((cpuArch & avx) && (ebx & (1U << 5))) {
         cpuArch |= avx2;
     }
+    if ((cpuArch & avx2) && (ebx & (1U << 16))) {
+        // the OS must save the opmask and the upper halves of zmm registers
+        U32 xcr0;
+        __xgetbv(xcr0, 0);
+        if ((xcr0 & 0xE6) == 0xE6) {
+            cpuArch |= avx512;
+        }
+    }
 
-    if (cpuArch & avx2) {
-        archs[0] = X86_AVX2;
-    } else {
+    Arch arch = CPU_GENERAL;
+    if (cpuArch & avx512) {
+        arch = X86_AVX512;
+    } else if (cpuArch & avx2) {
+        arch = X86_AVX2;
+    }
+    return arch;
+}
+
+// whether the int8 dot products of AVX-512 VNNI can be used, they need the X86_AVX512 arch
+inline bool x86_cpu_has_avx512_vnni()
+{
+    static const bool vnni = [] {
+        U32 data[4] = {};
+        __cpuid(data, 7, 0);
+        return (get_x86_cpu_arch() == X86_AVX512) && (data[2] & (1U << 11));
+    }();
+    return vnni;
+}
+#endif
+
+inline void get_cpus_arch(Arch *archs, int cpuNum)
+{
+#ifdef _USE_IOS
+    for (int cpuid = 0; cpuid < cpuNum; cpuid++) {
+        archs[cpuid] = ARM_A76;
+    }
+    return;
+#endif
+    FILE *fp = fopen("/proc/cpuinfo", "rb");
+    *archs = CPU_GENERAL;
+    if (!fp) {
+        return;
+    }
+
+#if defined(_USE_FP32) && defined(_USE_X86)
+    archs[0] = get_x86_cpu_arch();
+    if (archs[0] == CPU_GENERAL) {
         UNI_WARNING_LOG("AVX2 is not available, use general implementation.");
     }
 #endif
@@ -505,6 +544,66 @@ inline void thread_affinity_set_by_arch(
     }
 }
 
+inline int get_cpu_num_threads()
+{
+    return OMP_NUM_THREADS;
+}
+
+inline void set_cpu_num_threads(int threadNum)
+{
+#ifdef _USE_OPENMP
+    if (threadNum < 1) {
+        threadNum = 1;
+    }
+    if (threadNum > CPU_MAX_NUMBER) {
+        threadNum = CPU_MAX_NUMBER;
+    }
+    OMP_NUM_THREADS = threadNum;
+#else
+    if (threadNum > 1) {
+        UNI_WARNING_LOG("this binary is not compiled with OpenMP, can not use %d threads.\n",
+            threadNum);
+    }
+#endif
+}
+
+// bind each thread of the OpenMP thread pool to a different core that matches the schedule arch,
+// the pool of the calling thread is persistent, so this only need to be done when it is resized.
+inline void thread_affinity_set_omp_threads(DeviceInfo *deviceInfo, int threadNum)
+{
+#ifdef _USE_OPENMP
+    if (deviceInfo->affinityPolicy == AFFINITY_GPU) {
+        return;
+    }
+    int count = 0;
+    int candidates[CPU_MAX_NUMBER];
+    for (int i = 0; i < deviceInfo->cpuNum; i++) {
+        int index = i;
+        if (deviceInfo->affinityPolicy == AFFINITY_CPU_HIGH_PERFORMANCE) {
+            index = deviceInfo->cpuNum - 1 - i;
+        }
+        if (deviceInfo->archs[index] == deviceInfo->schedule && deviceInfo->cpuids[index] != -1) {
+            candidates[count++] = deviceInfo->cpuids[index];
+        }
+    }
+    if (count == 0) {
+        return;
+    }
+    if (count < threadNum) {
+        UNI_WARNING_LOG("there are only %d idle cores for %d threads\n", count, threadNum);
+    }
+#pragma omp parallel num_threads(threadNum)
+    {
+        int threadId = omp_get_thread_num();
+        if (threadId < count) {
+            set_thread_affinity(threadId, candidates + threadId, 1);
+        } else {
+            set_thread_affinity(threadId, candidates, count);
+        }
+    }
+#endif
+}
+
 inline DeviceInfo get_cpu_info(AffinityPolicy affinityPolicy)
 {
     DeviceInfo deviceInfo;
@@ -21,8 +21,15 @@
 extern "C" {
 #endif
 
-static const int sg_boltVersion = 20201120;
+static const int sg_boltVersion = 20201230;
 static const int sg_magicNumber = 1141119;
+// oldest .bolt version that can still be deserialized
+static const int sg_boltCompatibleVersion = 20201120;
+// weight data is aligned to sg_weightAlignment bytes in .bolt file since this version
+static const int sg_boltAlignedWeightVersion = 20201220;
+static const int sg_weightAlignment = 64;
+// .bolt file can carry offline transformed weights since this version
+static const int sg_boltPackedWeightVersion = 20201230;
 
 typedef enum { POOLING_MAX, POOLING_MEAN } PoolingMode;
 
@@ -111,6 +118,13 @@ typedef enum {
     CONVOLUTION_ALGORITHM_NULL
 } ConvolutionForwardAlgorithm;
 
+inline const char *const *ConvolutionForwardAlgorithmName()
+{
+    static const char *const names[] = {"POINTWISE", "DIRECT", "IM2COL_GEMM", "GEMM",
+        "GEMM_ICNCHW", "WINOGRAD", "BNN", "DIRECT_SPE_CK", "GROUP_DECONV", "NULL"};
+    return names;
+}
+
 typedef struct {
     F32 xmin;
     F32 ymin;
@@ -146,6 +160,14 @@ typedef enum {
     DEPTHWISE_CONVOLUTION_ALGORITHM_NULL
 } DepthwiseConvolutionForwardAlgorithm;
 
+inline const char *const *DepthwiseConvolutionForwardAlgorithmName()
+{
+    static const char *const names[] = {"DEPTHWISE_DIRECT", "DEPTHWISE_POINTWISE_DIRECT",
+        "DEPTHWISE_POINTWISE_DIRECT_NO_PADDING", "DEPTHWISE_POINTWISE_3X3S1P1",
+        "DEPTHWISE_POINTWISE_GEMM", "NULL"};
+    return names;
+}
+
 typedef struct {
     char mode[NAME_LEN];
     U32 sizes[2];
@@ -467,6 +489,11 @@ typedef struct {
     EltwiseParamSpec eltwiseDesc[2];
 } MultiheadAttentionParamSpec;
 
+// softmax(Q * K^T * scale + mask) * V of every head, Q/K/V are [batch, length, heads, size]
+typedef struct {
+    F32 scale;
+} ScaledDotProductAttentionParamSpec;
+
 typedef union ParameterSpec {
     ParameterSpec()
     {}
@@ -514,6 +541,7 @@ typedef union ParameterSpec {
     MultiheadAttentionParamSpec multiheadAttention_spec;
     TileParamSpec tile_spec;
     SpliceParamSpec splice_spec;
+    ScaledDotProductAttentionParamSpec scaled_dot_product_attention_spec;
 } ParameterSpec;
 
 typedef struct {
@@ -553,6 +581,30 @@ typedef struct {
     I8 **output_op_names;
 } OperatorRelationshipMapEntry;
 
+// weights of an operator that have been transformed by transform_filter offline,
+// they can only be used on the same architecture and inference precision.
+typedef struct {
+    I8 op_name[NAME_LEN];
+    I32 arch;  // Arch
+    DataType dt;
+    // algorithm info string of AlgorithmMap that weights are transformed for, such as "/1/"
+    I8 algorithm[NAME_LEN];
+    U32 num_weights;
+    TensorDesc *weight_descs;
+    // transformed weight buffer may be larger than its TensorDesc, kernels align the buffer
+    // address themselves, so buffer should be placed at the same address offset
+    // modulo sg_weightAlignment.
+    U32 *weight_bytes;
+    U32 *weight_offsets;
+    U8 **weights;
+} PackedWeightSpec;
+
+typedef struct {
+    int fd;
+    I8 *bytes;
+    U32 fileLength;
+} ModelFileDescriptor;
+
 typedef struct {
     I32 version;
     I32 magic_number;
@@ -575,6 +627,13 @@ typedef struct {
 
     I32 num_op_tensor_entries;
     OperatorRelationshipMapEntry *op_relationship_entries;
+
+    I32 num_packed_weight_specs;
+    PackedWeightSpec *pws;
+
+    // ModelFileDescriptor of the memory mapped .bolt file that weights point to,
+    // nullptr means that weights are allocated on heap
+    void *mfd;
 } ModelSpec;
 #pragma pack()
 
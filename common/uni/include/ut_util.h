@@ -23,11 +23,13 @@
 #include "sys.h"
 #include "types.h"
 #include "error.h"
+#include "thread_affinity.h"
 
 #if defined(_USE_NEON)
 const Arch UT_ARCH = ARM_A76;
 #elif defined(_USE_X86)
-const Arch UT_ARCH = X86_AVX2;
+// the AVX-512 kernels are tested on the machines that support them
+const Arch UT_ARCH = get_x86_cpu_arch();
 #else
 const Arch UT_ARCH = CPU_GENERAL;
 #endif
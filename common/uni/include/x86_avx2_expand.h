@@ -137,4 +137,41 @@ inline F32 _mm256_hmax_ps(__m256 x)
     max = _mm_max_ss(low, high);
     return _mm_cvtss_f32(max);
 }
+// transpose the 8x8 block of 32-bit values at src, the rows of src and dst are
+// srcStride and dstStride elements apart
+inline void _mm256_transpose8x8_ps(const F32 *src, U32 srcStride, F32 *dst, U32 dstStride)
+{
+    __m256 r0 = _mm256_loadu_ps(src);
+    __m256 r1 = _mm256_loadu_ps(src + srcStride);
+    __m256 r2 = _mm256_loadu_ps(src + srcStride * 2);
+    __m256 r3 = _mm256_loadu_ps(src + srcStride * 3);
+    __m256 r4 = _mm256_loadu_ps(src + srcStride * 4);
+    __m256 r5 = _mm256_loadu_ps(src + srcStride * 5);
+    __m256 r6 = _mm256_loadu_ps(src + srcStride * 6);
+    __m256 r7 = _mm256_loadu_ps(src + srcStride * 7);
+    __m256 t0 = _mm256_unpacklo_ps(r0, r1);
+    __m256 t1 = _mm256_unpackhi_ps(r0, r1);
+    __m256 t2 = _mm256_unpacklo_ps(r2, r3);
+    __m256 t3 = _mm256_unpackhi_ps(r2, r3);
+    __m256 t4 = _mm256_unpacklo_ps(r4, r5);
+    __m256 t5 = _mm256_unpackhi_ps(r4, r5);
+    __m256 t6 = _mm256_unpacklo_ps(r6, r7);
+    __m256 t7 = _mm256_unpackhi_ps(r6, r7);
+    r0 = _mm256_shuffle_ps(t0, t2, 0x44);
+    r1 = _mm256_shuffle_ps(t0, t2, 0xEE);
+    r2 = _mm256_shuffle_ps(t1, t3, 0x44);
+    r3 = _mm256_shuffle_ps(t1, t3, 0xEE);
+    r4 = _mm256_shuffle_ps(t4, t6, 0x44);
+    r5 = _mm256_shuffle_ps(t4, t6, 0xEE);
+    r6 = _mm256_shuffle_ps(t5, t7, 0x44);
+    r7 = _mm256_shuffle_ps(t5, t7, 0xEE);
+    _mm256_storeu_ps(dst, _mm256_permute2f128_ps(r0, r4, 0x20));
+    _mm256_storeu_ps(dst + dstStride, _mm256_permute2f128_ps(r1, r5, 0x20));
+    _mm256_storeu_ps(dst + dstStride * 2, _mm256_permute2f128_ps(r2, r6, 0x20));
+    _mm256_storeu_ps(dst + dstStride * 3, _mm256_permute2f128_ps(r3, r7, 0x20));
+    _mm256_storeu_ps(dst + dstStride * 4, _mm256_permute2f128_ps(r0, r4, 0x31));
+    _mm256_storeu_ps(dst + dstStride * 5, _mm256_permute2f128_ps(r1, r5, 0x31));
+    _mm256_storeu_ps(dst + dstStride * 6, _mm256_permute2f128_ps(r2, r6, 0x31));
+    _mm256_storeu_ps(dst + dstStride * 7, _mm256_permute2f128_ps(r3, r7, 0x31));
+}
 #endif  //CHEETAH_X86_AVX2_EXPAND_H
@@ -0,0 +1,93 @@
+// Copyright (C) 2019. Huawei Technologies Co., Ltd. All rights reserved.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef CHEETAH_X86_AVX512_EXPAND_H
+#define CHEETAH_X86_AVX512_EXPAND_H
+#include <immintrin.h>
+#include "types.h"
+
+// The library is built with -mavx2 -mfma, AVX-512 code is only compiled for the functions
+// marked with AVX512_TARGET and must only be called when the arch is X86_AVX512.
+#define AVX512_TARGET __attribute__((target("avx512f")))
+// the int8 kernels also need the VNNI dot products, see x86_cpu_has_avx512_vnni
+#define AVX512_VNNI_TARGET __attribute__((target("avx512f,avx512bw,avx512vnni")))
+
+// GCC 12 passes an _mm512_undefined_* merge source to the unmasked forms of insert, extract,
+// broadcast, min/max and shift, and warns that it is uninitialized once they are inlined
+// (bug 105593). The helpers below use the zero-masked forms with a full mask, they compile
+// to the same instructions.
+
+// NCHWC8 data of 16 channels is kept in two planes, the low 8 lanes come from lo
+AVX512_TARGET inline __m512 _mm512_loadu_2x256_ps(const F32 *lo, const F32 *hi)
+{
+    __m512d low = _mm512_castpd256_pd512(_mm256_castps_pd(_mm256_loadu_ps(lo)));
+    return _mm512_castpd_ps(
+        _mm512_maskz_insertf64x4(0xFF, low, _mm256_castps_pd(_mm256_loadu_ps(hi)), 1));
+}
+
+AVX512_TARGET inline void _mm512_storeu_2x256_ps(F32 *lo, F32 *hi, __m512 x)
+{
+    _mm512_mask_storeu_ps(lo, 0x00FF, x);
+    _mm512_mask_storeu_ps(hi - 8, 0xFF00, x);
+}
+
+// the 8 floats at addr in the low half, the high half is zero. Unlike the masked loads, it
+// does not prevent GCC from keeping the accumulators of a loop in registers.
+AVX512_TARGET inline __m512 _mm512_loadu_256_ps(const F32 *addr)
+{
+    return _mm512_castpd_ps(_mm512_maskz_insertf64x4(
+        0xFF, _mm512_setzero_pd(), _mm256_castps_pd(_mm256_loadu_ps(addr)), 0));
+}
+
+// the 8 floats at addr in both halves
+AVX512_TARGET inline __m512 _mm512_broadcast_256_ps(const F32 *addr)
+{
+    return _mm512_castpd_ps(
+        _mm512_maskz_broadcast_f64x4(0xFF, _mm256_castps_pd(_mm256_loadu_ps(addr))));
+}
+
+// mask of the first num lanes
+AVX512_TARGET inline __mmask16 _mm512_lane_mask(U32 num)
+{
+    return (num >= 16) ? (__mmask16)0xFFFF : (__mmask16)((1U << num) - 1);
+}
+
+// horizontal add, replaces _mm512_reduce_add_ps
+AVX512_TARGET inline F32 _mm512_sum_ps(__m512 x)
+{
+    __m512d y = _mm512_castps_pd(x);
+    __m256 sum8 = _mm256_add_ps(_mm256_castpd_ps(_mm512_maskz_extractf64x4_pd(0xF, y, 0)),
+        _mm256_castpd_ps(_mm512_maskz_extractf64x4_pd(0xF, y, 1)));
+    __m128 sum4 = _mm_add_ps(_mm256_castps256_ps128(sum8), _mm256_extractf128_ps(sum8, 1));
+    sum4 = _mm_hadd_ps(sum4, sum4);
+    return _mm_cvtss_f32(_mm_hadd_ps(sum4, sum4));
+}
+
+// the 32-bit lanes of x shifted left by num bits
+AVX512_TARGET inline __m512i _mm512_shl_epi32(__m512i x, U32 num)
+{
+    return _mm512_maskz_slli_epi32(0xFFFF, x, num);
+}
+
+// activation of the convolution kernels, mode is the ActivationMode
+AVX512_TARGET inline __m512 _mm512_activate_ps(__m512 x, U32 mode)
+{
+    if (mode == ACTIVATION_RELU) {
+        x = _mm512_maskz_max_ps(0xFFFF, x, _mm512_setzero_ps());
+    } else if (mode == ACTIVATION_RELU6) {
+        x = _mm512_maskz_max_ps(0xFFFF, x, _mm512_setzero_ps());
+        x = _mm512_maskz_min_ps(0xFFFF, x, _mm512_set1_ps(6.0f));
+    }
+    return x;
+}
+#endif  //CHEETAH_X86_AVX512_EXPAND_H
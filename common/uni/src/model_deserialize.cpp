@@ -53,7 +53,8 @@ int get_operator_parameter_size(OperatorType operatorType)
         {OT_DetectionOutput, sizeof(DetectionOutputParamSpec)},
         {OT_Yolov3DetectionOutput, sizeof(Yolov3DetectionOutputParamSpec)},
         {OT_MultiHeadAttention, sizeof(MultiheadAttentionParamSpec)},
-        {OT_Tile, sizeof(TileParamSpec)}, {OT_Splice, sizeof(SpliceParamSpec)}};
+        {OT_Tile, sizeof(TileParamSpec)}, {OT_Splice, sizeof(SpliceParamSpec)},
+        {OT_ScaledDotProductAttention, sizeof(ScaledDotProductAttentionParamSpec)}};
     int size;
     if (operatorParameterSizeMap.find(operatorType) == operatorParameterSizeMap.end()) {
         size = 0;
@@ -253,7 +254,7 @@ EE deserialize_header(const char *bytes, ModelSpec *spec, U32 *pos)
     memcpy(&spec->version, pointer, sizeof(I32));
     pointer += sizeof(I32);
     *pos += sizeof(I32);
-    if (spec->version != sg_boltVersion) {
+    if (spec->version < sg_boltCompatibleVersion || spec->version > sg_boltVersion) {
         UNI_ERROR_LOG("X2bolt version is [%d], but your model version is : [%d].\n Please update "
                       "X2bolt to version[%d].\n",
             sg_boltVersion, spec->version, spec->version);
@@ -421,7 +422,7 @@ EE deserialize_weight(const char *bytes, ModelSpec *spec, U32 *pos)
             ptr[i].mdt = DT_F32;
             quantFP16 = true;
         } else if (DT_I8 == ptr[i].mdt && DT_I8 != spec->dt) {
-            ptr[i].mdt = (spec->dt == DT_F16_8Q) ? DT_F16 : spec->dt;
+            ptr[i].mdt = noQuantDataType(spec->dt);
             quantInt8 = true;
         }
 
@@ -437,7 +438,9 @@ EE deserialize_weight(const char *bytes, ModelSpec *spec, U32 *pos)
         pointer += sizeof(U32);
         *pos += sizeof(U32);
 
-        ptr[i].weight = (U8 *)mt_new_storage(ptr[i].bytes_of_weight);
+        U32 padding = weight_align_padding(spec, *pos);
+        pointer += padding;
+        *pos += padding;
         U8 *serialWeight = (U8 *)pointer;
 
         pointer += alignSize;
@@ -448,6 +451,9 @@ EE deserialize_weight(const char *bytes, ModelSpec *spec, U32 *pos)
         pointer += sizeof(U32);
         *pos += sizeof(U32);
 
+        padding = weight_align_padding(spec, *pos);
+        pointer += padding;
+        *pos += padding;
         alignSize = ptr[i].bytes_of_vec;
         if (quantFP16) {
             ptr[i].bytes_of_vec *= 2;
@@ -455,9 +461,23 @@ EE deserialize_weight(const char *bytes, ModelSpec *spec, U32 *pos)
         U8 *serialBias = nullptr;
         if (0 != ptr[i].bytes_of_vec) {
             serialBias = (U8 *)pointer;
-            ptr[i].vec = (U8 *)mt_new_storage(ptr[i].bytes_of_vec);
+        }
+
+        // weight and bias directly use the mapped file when they needn't be converted and
+        // are well aligned, otherwise they are copied to heap together.
+        bool zeroCopy = spec->mfd != nullptr && !quantFP16 && !quantInt8 &&
+            (uintptr_t)serialWeight % sg_weightAlignment == 0 &&
+            (uintptr_t)serialBias % sg_weightAlignment == 0;
+        if (zeroCopy) {
+            ptr[i].weight = (0 != ptr[i].bytes_of_weight) ? serialWeight : nullptr;
+            ptr[i].vec = serialBias;
         } else {
-            ptr[i].vec = nullptr;
+            ptr[i].weight = (U8 *)mt_new_storage(ptr[i].bytes_of_weight);
+            if (0 != ptr[i].bytes_of_vec) {
+                ptr[i].vec = (U8 *)mt_new_storage(ptr[i].bytes_of_vec);
+            } else {
+                ptr[i].vec = nullptr;
+            }
         }
 
         pointer += alignSize;
@@ -486,6 +506,9 @@ EE deserialize_weight(const char *bytes, ModelSpec *spec, U32 *pos)
 
         CHECK_REQUIREMENT(*length == weightBiasBytes);
 
+        if (zeroCopy) {
+            continue;
+        }
         if (quantFP16) {
             dequantize_fp16(
                 ptr[i].bytes_of_weight / 4, (unsigned short *)serialWeight, (F32 *)ptr[i].weight);
@@ -514,23 +537,101 @@ EE deserialize_weight(const char *bytes, ModelSpec *spec, U32 *pos)
     return SUCCESS;
 }
 
+EE deserialize_packed_weight(const char *bytes, ModelSpec *spec, U32 *pos)
+{
+    spec->num_packed_weight_specs = 0;
+    spec->pws = nullptr;
+    if (spec->version < sg_boltPackedWeightVersion) {
+        return SUCCESS;
+    }
+    const char *pointer = bytes + *pos;
+    spec->num_packed_weight_specs = *((I32 *)pointer);
+    pointer += sizeof(I32);
+    *pos += sizeof(I32);
+    if (0 == spec->num_packed_weight_specs) {
+        return SUCCESS;
+    }
+
+    PackedWeightSpec *ptr = (PackedWeightSpec *)mt_new_storage(
+        spec->num_packed_weight_specs * sizeof(PackedWeightSpec));
+    spec->pws = ptr;
+    for (int i = 0; i < spec->num_packed_weight_specs; i++) {
+        str_copy(ptr[i].op_name, pointer, NAME_LEN);
+        pointer += NAME_LEN;
+        *pos += NAME_LEN;
+
+        memcpy(&(ptr[i].arch), pointer, sizeof(I32));
+        pointer += sizeof(I32);
+        *pos += sizeof(I32);
+
+        memcpy(&(ptr[i].dt), pointer, sizeof(DataType));
+        pointer += sizeof(DataType);
+        *pos += sizeof(DataType);
+
+        str_copy(ptr[i].algorithm, pointer, NAME_LEN);
+        pointer += NAME_LEN;
+        *pos += NAME_LEN;
+
+        memcpy(&(ptr[i].num_weights), pointer, sizeof(U32));
+        pointer += sizeof(U32);
+        *pos += sizeof(U32);
+
+        U32 num = ptr[i].num_weights;
+        ptr[i].weight_descs = (TensorDesc *)mt_new_storage(num * sizeof(TensorDesc));
+        ptr[i].weight_bytes = (U32 *)mt_new_storage(num * sizeof(U32));
+        ptr[i].weight_offsets = (U32 *)mt_new_storage(num * sizeof(U32));
+        ptr[i].weights = (U8 **)mt_new_storage(num * sizeof(U8 *));
+        for (U32 j = 0; j < num; j++) {
+            memcpy(&(ptr[i].weight_descs[j]), pointer, sizeof(TensorDesc));
+            pointer += sizeof(TensorDesc);
+            *pos += sizeof(TensorDesc);
+
+            U32 bytes = *((U32 *)pointer);
+            ptr[i].weight_bytes[j] = bytes;
+            pointer += sizeof(U32);
+            *pos += sizeof(U32);
+            CHECK_REQUIREMENT(bytes >= tensorNumBytes(ptr[i].weight_descs[j]));
+
+            ptr[i].weight_offsets[j] = *((U32 *)pointer);
+            pointer += sizeof(U32);
+            *pos += sizeof(U32);
+
+            U32 padding = packed_weight_padding(*pos, ptr[i].weight_offsets[j]);
+            pointer += padding;
+            *pos += padding;
+            if (spec->mfd != nullptr &&
+                (uintptr_t)pointer % sg_weightAlignment == ptr[i].weight_offsets[j]) {
+                ptr[i].weights[j] = (U8 *)pointer;
+            } else {
+                ptr[i].weights[j] = (U8 *)mt_new_storage(bytes);
+                memcpy(ptr[i].weights[j], pointer, bytes);
+            }
+            pointer += bytes;
+            *pos += bytes;
+        }
+    }
+    return SUCCESS;
+}
+
 EE deserialize_model(const char *bytes, ModelSpec *spec)
 {
     U32 pos = 0;
     CHECK_STATUS(deserialize_header(bytes, spec, &pos));
     CHECK_STATUS(deserialize_operator(bytes, spec, &pos));
     CHECK_STATUS(deserialize_weight(bytes, spec, &pos));
+    CHECK_STATUS(deserialize_packed_weight(bytes, spec, &pos));
     CHECK_STATUS(operator_relationship(spec));
     return SUCCESS;
 }
 
-EE deserialize_model_from_file(const char *fn, ModelSpec *spec, bool useFileStream)
+EE deserialize_model_from_file(const char *fn, ModelSpec *spec, bool useFileStream, bool zeroCopy)
 {
     UNI_PROFILE(
         {
+            spec->mfd = nullptr;
             char *bytes = nullptr;
-            int fd;
-            int fileLength;
+            int fd = -1;
+            int fileLength = 0;
             if (useFileStream) {
                 bytes = (char *)fn;
             } else {
@@ -543,26 +644,66 @@ EE deserialize_model_from_file(const char *fn, ModelSpec *spec, bool useFileStre
                 struct stat ss;
                 if (-1 == fstat(fd, &ss)) {
                     UNI_ERROR_LOG("Cannot get size from file descriptor. File Name: %s\n", fn);
+                    close(fd);
                     return FILE_ERROR;
                 }
 
                 fileLength = ss.st_size;
-                bytes = (char *)mmap(nullptr, fileLength, PROT_READ, MAP_SHARED, fd, 0);
+                if (zeroCopy) {
+                    // private writable mapping, pages are shared with page cache until written
+                    bytes = (char *)mmap(
+                        nullptr, fileLength, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+                } else {
+                    bytes = (char *)mmap(nullptr, fileLength, PROT_READ, MAP_SHARED, fd, 0);
+                }
                 if (MAP_FAILED == bytes) {
                     UNI_ERROR_LOG("Mmap failed. File Name: %s\n", fn);
+                    close(fd);
                     return FILE_ERROR;
                 }
+                if (zeroCopy) {
+                    ModelFileDescriptor *mfd = new ModelFileDescriptor();
+                    mfd->fd = fd;
+                    mfd->bytes = bytes;
+                    mfd->fileLength = fileLength;
+                    spec->mfd = mfd;
+                }
             }
 
             CHECK_STATUS(deserialize_model(bytes, spec));
 
-            if (!useFileStream) {
+            if (!useFileStream && nullptr == spec->mfd) {
                 munmap(bytes, fileLength);
-                if (-1 != fd) {
-                    close(fd);
-                }
+                close(fd);
             }
         },
         std::string("deserialize_model_from_file"), std::string("prepare"));
     return SUCCESS;
 }
+
+bool is_model_file_memory(const ModelSpec *spec, const void *ptr)
+{
+    bool ret = false;
+    if (nullptr != spec->mfd) {
+        ModelFileDescriptor *mfd = (ModelFileDescriptor *)spec->mfd;
+        ret = (const I8 *)ptr >= mfd->bytes && (const I8 *)ptr < mfd->bytes + mfd->fileLength;
+    }
+    return ret;
+}
+
+EE release_model_file(void *mfd)
+{
+    ModelFileDescriptor *descriptor = (ModelFileDescriptor *)mfd;
+    if (nullptr == descriptor) {
+        return NULL_POINTER;
+    }
+    EE ret = SUCCESS;
+    if (0 != munmap(descriptor->bytes, descriptor->fileLength)) {
+        ret = FILE_ERROR;
+    }
+    if (-1 != descriptor->fd) {
+        close(descriptor->fd);
+    }
+    delete descriptor;
+    return ret;
+}
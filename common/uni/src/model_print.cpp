@@ -101,6 +101,20 @@ void print_weights(const ModelSpec ms)
     }
 }
 
+void print_packed_weights(const ModelSpec ms)
+{
+    int number = ms.num_packed_weight_specs;
+    printf("    [Packed Weights] %d\n", number);
+    for (int i = 0; i < number; i++) {
+        printf("        Packed Weight %3d %32s | arch %d dt %d algorithm %s", i,
+            ms.pws[i].op_name, ms.pws[i].arch, ms.pws[i].dt, ms.pws[i].algorithm);
+        for (U32 j = 0; j < ms.pws[i].num_weights; j++) {
+            printf(" %s", tensorDesc2Str(ms.pws[i].weight_descs[j]).c_str());
+        }
+        printf("\n");
+    }
+}
+
 void print_relationship(const ModelSpec ms)
 {
     int number = ms.num_op_tensor_entries;
@@ -123,5 +137,6 @@ void print_ms(const ModelSpec ms)
     print_header(ms);
     print_operator_tensor_relationship(ms);
     print_weights(ms);
+    print_packed_weights(ms);
     print_relationship(ms);
 }
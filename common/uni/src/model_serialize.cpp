@@ -177,7 +177,7 @@ EE serialize_operators(const ModelSpec *spec, std::string *tmp)
     return SUCCESS;
 }
 
-EE serialize_weights(const ModelSpec *spec, std::string *tmp)
+EE serialize_weights(const ModelSpec *spec, std::string *tmp, U32 offset)
 {
     WeightSpec *tmpPointer = spec->ws;
     U32 bufSize = sizeof(I32);
@@ -188,8 +188,11 @@ EE serialize_weights(const ModelSpec *spec, std::string *tmp)
         }
 
         // U32 x 5: length, mdt, bytes_of_weight, bytes_of_vec, num_quant_scale
-        bufSize += sizeof(I8) * NAME_LEN + sizeof(U32) * 5 + tmpPointer[i].bytes_of_weight +
-            tmpPointer[i].bytes_of_vec;
+        bufSize += sizeof(I8) * NAME_LEN + sizeof(U32) * 3;
+        bufSize += weight_align_padding(spec, offset + bufSize) + tmpPointer[i].bytes_of_weight;
+        bufSize += sizeof(U32);
+        bufSize += weight_align_padding(spec, offset + bufSize) + tmpPointer[i].bytes_of_vec;
+        bufSize += sizeof(U32);
         for (U32 j = 0; j < tmpPointer[i].num_quant_scale; j++) {
             bufSize += sizeof(int);  // num_scale
             bufSize += tmpPointer[i].weight_scale[j].num_scale * sizeof(F32);
@@ -228,6 +231,9 @@ EE serialize_weights(const ModelSpec *spec, std::string *tmp)
         pointer4wsBytesOfWeight++;
 
         U8 *pointer4wsWeight = (U8 *)pointer4wsBytesOfWeight;
+        U32 padding = weight_align_padding(spec, offset + (pointer4wsWeight - (U8 *)data));
+        memset(pointer4wsWeight, 0, padding);
+        pointer4wsWeight += padding;
         memcpy(pointer4wsWeight, wsPointer[i].weight, wsPointer[i].bytes_of_weight);
         pointer4wsWeight += wsPointer[i].bytes_of_weight;
 
@@ -236,6 +242,9 @@ EE serialize_weights(const ModelSpec *spec, std::string *tmp)
         pointer4wsBytesOfVec++;
 
         U8 *pointer4wsVec = (U8 *)pointer4wsBytesOfVec;
+        padding = weight_align_padding(spec, offset + (pointer4wsVec - (U8 *)data));
+        memset(pointer4wsVec, 0, padding);
+        pointer4wsVec += padding;
         memcpy(pointer4wsVec, wsPointer[i].vec, wsPointer[i].bytes_of_vec);
         pointer4wsVec += wsPointer[i].bytes_of_vec;
 
@@ -262,6 +271,73 @@ EE serialize_weights(const ModelSpec *spec, std::string *tmp)
     return SUCCESS;
 }
 
+EE serialize_packed_weights(const ModelSpec *spec, std::string *tmp, U32 offset)
+{
+    PackedWeightSpec *pwsPointer = spec->pws;
+    U32 bufSize = sizeof(I32);
+    for (int i = 0; i < spec->num_packed_weight_specs; i++) {
+        // op_name, arch, dt, algorithm, num_weights
+        bufSize += sizeof(I8) * NAME_LEN + sizeof(I32) + sizeof(DataType) +
+            sizeof(I8) * NAME_LEN + sizeof(U32);
+        for (U32 j = 0; j < pwsPointer[i].num_weights; j++) {
+            bufSize += sizeof(TensorDesc) + sizeof(U32) * 2;
+            bufSize += packed_weight_padding(offset + bufSize, pwsPointer[i].weight_offsets[j]) +
+                pwsPointer[i].weight_bytes[j];
+        }
+    }
+    char *data = (char *)mt_new_storage(bufSize);
+
+    I32 *pointer4numPackedWeightSpecs = (I32 *)data;
+    *pointer4numPackedWeightSpecs = spec->num_packed_weight_specs;
+    pointer4numPackedWeightSpecs++;
+
+    char *pointer4pwsOpName = (char *)pointer4numPackedWeightSpecs;
+    for (int i = 0; i < spec->num_packed_weight_specs; i++) {
+        str_copy(pointer4pwsOpName, pwsPointer[i].op_name, NAME_LEN);
+        pointer4pwsOpName += NAME_LEN;
+
+        I32 *pointer4pwsArch = (I32 *)pointer4pwsOpName;
+        *pointer4pwsArch = pwsPointer[i].arch;
+        pointer4pwsArch++;
+
+        DataType *pointer4pwsDt = (DataType *)pointer4pwsArch;
+        *pointer4pwsDt = pwsPointer[i].dt;
+        pointer4pwsDt++;
+
+        I8 *pointer4pwsAlgorithm = (I8 *)pointer4pwsDt;
+        str_copy(pointer4pwsAlgorithm, pwsPointer[i].algorithm, NAME_LEN);
+        pointer4pwsAlgorithm += NAME_LEN;
+
+        U32 *pointer4pwsNumWeights = (U32 *)pointer4pwsAlgorithm;
+        *pointer4pwsNumWeights = pwsPointer[i].num_weights;
+        pointer4pwsNumWeights++;
+
+        U8 *pointer4pwsWeight = (U8 *)pointer4pwsNumWeights;
+        for (U32 j = 0; j < pwsPointer[i].num_weights; j++) {
+            memcpy(pointer4pwsWeight, &(pwsPointer[i].weight_descs[j]), sizeof(TensorDesc));
+            pointer4pwsWeight += sizeof(TensorDesc);
+            memcpy(pointer4pwsWeight, &(pwsPointer[i].weight_bytes[j]), sizeof(U32));
+            pointer4pwsWeight += sizeof(U32);
+            memcpy(pointer4pwsWeight, &(pwsPointer[i].weight_offsets[j]), sizeof(U32));
+            pointer4pwsWeight += sizeof(U32);
+
+            U32 padding = packed_weight_padding(
+                offset + (pointer4pwsWeight - (U8 *)data), pwsPointer[i].weight_offsets[j]);
+            memset(pointer4pwsWeight, 0, padding);
+            pointer4pwsWeight += padding;
+            memcpy(pointer4pwsWeight, pwsPointer[i].weights[j], pwsPointer[i].weight_bytes[j]);
+            pointer4pwsWeight += pwsPointer[i].weight_bytes[j];
+        }
+        pointer4pwsOpName = (char *)pointer4pwsWeight;
+    }
+
+    tmp->clear();
+    CHECK_REQUIREMENT((U32)(pointer4pwsOpName - data) == bufSize);
+    tmp->assign(data, data + bufSize);
+    delete data;
+    return SUCCESS;
+}
+
 EE serialize_model(const ModelSpec *spec, std::string *bytes)
 {
     bytes->clear();
@@ -273,8 +349,13 @@ EE serialize_model(const ModelSpec *spec, std::string *bytes)
     CHECK_STATUS(serialize_operators(spec, &tmp));
     *bytes += tmp;
 
-    CHECK_STATUS(serialize_weights(spec, &tmp));
+    CHECK_STATUS(serialize_weights(spec, &tmp, bytes->size()));
     *bytes += tmp;
+
+    if (spec->version >= sg_boltPackedWeightVersion) {
+        CHECK_STATUS(serialize_packed_weights(spec, &tmp, bytes->size()));
+        *bytes += tmp;
+    }
     return SUCCESS;
 }
 
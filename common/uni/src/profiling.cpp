@@ -15,6 +15,8 @@
 #include <map>
 #include <vector>
 #include <algorithm>
+#include <memory>
+#include <mutex>
 
 #include "profiling.h"
 
@@ -89,3 +91,200 @@ void ut_time_statistics()
         UNI_INFO_LOG("%s\t%lfms\n", vec[i].first.c_str(), vec[i].second);
     }
 }
+
+static bool runtime_profile_env()
+{
+    const char *env = getenv("BOLT_RUNTIME_PROFILE");
+    return env != nullptr && std::string(env) == "1";
+}
+
+std::atomic<bool> runtimeProfileEnable(runtime_profile_env());
+
+void runtime_profile_set_enable(bool enable)
+{
+    runtimeProfileEnable.store(enable, std::memory_order_relaxed);
+}
+
+#define PROFILE_RING_SIZE 2048
+
+// only the owner thread writes a ring, the count is published after the record is filled
+struct ProfileRing {
+    ProfileRing() : records(PROFILE_RING_SIZE), count(0), used(true), tid(0)
+    {}
+
+    std::vector<ProfileRecord> records;
+    std::atomic<U32> count;
+    std::atomic<bool> used;
+    // system thread id of the owner, it is the tid of the trace events
+    pid_t tid;
+};
+
+static std::mutex profileRingsMutex;
+static std::vector<std::shared_ptr<ProfileRing>> profileRings;
+
+// the ring of an exited thread is given to the next new thread, so that the number of rings
+// does not grow with the thread pools that are created again and again
+struct ProfileRingOwner {
+    ~ProfileRingOwner()
+    {
+        if (ring != nullptr) {
+            ring->used.store(false, std::memory_order_release);
+        }
+    }
+
+    std::shared_ptr<ProfileRing> ring;
+};
+
+static ProfileRing *runtime_profile_ring()
+{
+    static thread_local ProfileRingOwner owner;
+    if (owner.ring == nullptr) {
+        std::lock_guard<std::mutex> guard(profileRingsMutex);
+        for (auto &ring : profileRings) {
+            bool used = false;
+            if (ring->used.compare_exchange_strong(used, true)) {
+                owner.ring = ring;
+                break;
+            }
+        }
+        if (owner.ring == nullptr) {
+            owner.ring = std::make_shared<ProfileRing>();
+            profileRings.push_back(owner.ring);
+        }
+        UNI_THREADID;
+        owner.ring->tid = tid;
+    }
+    return owner.ring.get();
+}
+
+ProfileRecord *runtime_profile_new_record()
+{
+    ProfileRing *ring = runtime_profile_ring();
+    U32 count = ring->count.load(std::memory_order_relaxed);
+    ProfileRecord *record = &(ring->records[count % PROFILE_RING_SIZE]);
+    record->tid = ring->tid;
+    return record;
+}
+
+void runtime_profile_commit_record()
+{
+    ProfileRing *ring = runtime_profile_ring();
+    ring->count.store(ring->count.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+static thread_local U32 profileTransforms = 0;
+
+void runtime_profile_count_transform()
+{
+    if (runtime_profile_enabled()) {
+        profileTransforms++;
+    }
+}
+
+U32 runtime_profile_get_transforms()
+{
+    return profileTransforms;
+}
+
+std::vector<ProfileRecord> runtime_profile_get_records()
+{
+    std::vector<ProfileRecord> records;
+    {
+        std::lock_guard<std::mutex> guard(profileRingsMutex);
+        for (auto &ring : profileRings) {
+            U32 count = ring->count.load(std::memory_order_acquire);
+            U32 start = (count > PROFILE_RING_SIZE) ? count - PROFILE_RING_SIZE : 0;
+            for (U32 i = start; i < count; i++) {
+                records.push_back(ring->records[i % PROFILE_RING_SIZE]);
+            }
+        }
+    }
+    std::stable_sort(records.begin(), records.end(),
+        [](const ProfileRecord &a, const ProfileRecord &b) { return a.start_ms < b.start_ms; });
+    return records;
+}
+
+void runtime_profile_clear()
+{
+    std::lock_guard<std::mutex> guard(profileRingsMutex);
+    for (auto &ring : profileRings) {
+        ring->count.store(0, std::memory_order_release);
+    }
+}
+
+static std::string json_string(const char *str)
+{
+    std::string ret = "\"";
+    for (const char *p = str; *p != '\0'; p++) {
+        if (*p == '"' || *p == '\\') {
+            ret += '\\';
+            ret += *p;
+        } else if ((unsigned char)(*p) < 0x20) {
+            ret += ' ';
+        } else {
+            ret += *p;
+        }
+    }
+    ret += "\"";
+    return ret;
+}
+
+EE runtime_profile_dump_chrome_trace(const char *path)
+{
+    FILE *file = fopen(path, "w");
+    if (file == nullptr) {
+        UNI_ERROR_LOG("can not write runtime profile to %s.\n", path);
+        return FILE_ERROR;
+    }
+    std::vector<ProfileRecord> records = runtime_profile_get_records();
+    fprintf(file, "{\"traceEvents\": [");
+    for (U32 i = 0; i < records.size(); i++) {
+        const ProfileRecord &r = records[i];
+        fprintf(file,
+            "%s\n{\"name\": %s, \"cat\": %s, \"ph\": \"X\", \"ts\": %.3lf, "
+            "\"dur\": %.3lf, \"pid\": 0, \"tid\": %d, \"args\": {\"algorithm\": %s, "
+            "\"shapes\": %s, \"flops\": %.0lf, \"bytes\": %.0lf, \"transforms\": %d}}",
+            (i == 0) ? "" : ",", json_string(r.name).c_str(), json_string(r.type).c_str(),
+            r.start_ms * 1000, r.duration_ms * 1000, r.tid, json_string(r.algorithm).c_str(),
+            json_string(r.shapes).c_str(), r.flops, r.bytes, r.transforms);
+    }
+    fprintf(file, "\n], \"displayTimeUnit\": \"ms\"}\n");
+    fclose(file);
+    return SUCCESS;
+}
+
+void runtime_profile_summary()
+{
+    struct Summary {
+        U32 count;
+        double ms;
+        double flops;
+        double bytes;
+        U32 transforms;
+    };
+    std::map<std::string, Summary> summary;
+    double total = 0;
+    for (auto &r : runtime_profile_get_records()) {
+        Summary &s = summary[r.type];
+        s.count++;
+        s.ms += r.duration_ms;
+        s.flops += r.flops;
+        s.bytes += r.bytes;
+        s.transforms += r.transforms;
+        total += r.duration_ms;
+    }
+    std::vector<std::pair<std::string, Summary>> vec(summary.begin(), summary.end());
+    sort(vec.begin(), vec.end(),
+        [](const std::pair<std::string, Summary> &a, const std::pair<std::string, Summary> &b) {
+            return (a.second.ms > b.second.ms);
+        });
+    UNI_INFO_LOG("%-32s %8s %12s %8s %10s %10s %10s\n", "type", "count", "time(ms)", "ratio",
+        "GFLOP/s", "GB/s", "transforms");
+    for (auto &v : vec) {
+        const Summary &s = v.second;
+        double gflops = (s.ms > 0) ? s.flops / s.ms * 1e-6 : 0;
+        double gbs = (s.ms > 0) ? s.bytes / s.ms * 1e-6 : 0;
+        UNI_INFO_LOG("%-32s %8u %12.3lf %7.2lf%% %10.2lf %10.2lf %10u\n", v.first.c_str(),
+            s.count, s.ms, (total > 0) ? s.ms / total * 100 : 0, gflops, gbs, s.transforms);
+    }
+}
@@ -14,6 +14,7 @@
 #include <string.h>
 #include <bitset>
 #include "tensor_desc.h"
+#include "profiling.h"
 
 void UNI_memcpy(void *dst, const void *src, int size)
 {
@@ -49,6 +50,10 @@ void transformFromFloat(DataType dataType, float *src, void *dst, int num, float
             UNI_memcpy(dst, src, sizeof(float) * num);
             break;
         }
+        case DT_F32_8Q: {
+            UNI_memcpy(dst, src, sizeof(float) * num);
+            break;
+        }
         case DT_U32: {
             U32 *ptr = (U32 *)dst;
             for (int i = 0; i < num; i++) {
@@ -107,6 +112,10 @@ void transformToFloat(DataType dataType, void *src, float *dst, int num, float s
             UNI_memcpy(dst, src, sizeof(float) * num);
             break;
         }
+        case DT_F32_8Q: {
+            UNI_memcpy(dst, src, sizeof(float) * num);
+            break;
+        }
         case DT_U32: {
             U32 *ptr = (U32 *)src;
             for (int i = 0; i < num; i++) {
@@ -209,7 +218,7 @@ static void transformToNCHWKernel(
         case DF_NCHW: {
             CHECK_REQUIREMENT(tensorNumElements(inputDesc) == size);
             if (output != input) {
-                memcpy(output, input, size);
+                memcpy(output, input, size * sizeof(T));
             }
             break;
         }
@@ -270,6 +279,9 @@ EE transformToNCHW(TensorDesc inputDesc, const void *input, TensorDesc outputDes
     if (nullptr == input || nullptr == output) {
         return NULL_POINTER;
     }
+    if (inputDesc.df != DF_NCHW) {
+        runtime_profile_count_transform();
+    }
     switch (inputDesc.dt) {
 #ifdef _USE_FP32
         case DT_F32: {
@@ -323,7 +335,7 @@ static void transformToNHWCKernel(
         case DF_NHWC: {
             CHECK_REQUIREMENT(tensorNumElements(inputDesc) == size);
             if (input != output) {
-                memcpy(output, input, size);
+                memcpy(output, input, size * sizeof(T));
             }
             break;
         }
@@ -365,6 +377,9 @@ EE transformToNHWC(TensorDesc inputDesc, const void *input, TensorDesc outputDes
     if (nullptr == input || nullptr == output) {
         return NULL_POINTER;
     }
+    if (inputDesc.df != DF_NHWC) {
+        runtime_profile_count_transform();
+    }
     switch (inputDesc.dt) {
 #ifdef _USE_FP32
         case DT_F32: {
@@ -404,6 +419,7 @@ EE transformNCHWToNCHWC8(
     CHECK_STATUS(tensor4dGet(outputDesc, &odt, &odf, &on, &oc, &oh, &ow));
     CHECK_REQUIREMENT(in == on && idf == DF_NCHW && odf == DF_NCHWC8 && idt == odt && ic <= oc &&
         ih == oh && iw == ow);
+    runtime_profile_count_transform();
     int elementSize = bytesOf(idt);
     oc /= 8;
     U32 ohow = oh * ow;
@@ -439,6 +455,7 @@ EE transformNCHWC8ToNCHWC8ByGroup(
         }
         return SUCCESS;
     }
+    runtime_profile_count_transform();
 
     U32 channelAlignSize = 8;
     DataType dtBefore, dtAfter;
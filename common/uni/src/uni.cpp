@@ -12,6 +12,7 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include "tensor_desc.h"
+#include "thread_affinity.h"
 
 #include <cmath>
 
@@ -40,3 +41,7 @@ extern "C" int UNI_ISNAN(float a)
 #endif
 #endif
 }
+
+#ifdef _USE_OPENMP
+thread_local int OMP_NUM_THREADS = 2;
+#endif
@@ -22,6 +22,11 @@
 extern "C" {
 #endif
 
+// called on the rows [rowStart, rowStart + rowNum) and the columns [colStart, colStart + colNum)
+// of C once they are final, which is while the x86 kernels still have them in the cache
+typedef void (*MatrixEpilogueFunction)(
+    U32 rowStart, U32 rowNum, U32 colStart, U32 colNum, void *param);
+
 EE matrix_matrix_multiply_tmp_bytes(
     TensorDesc matrixADesc, TensorDesc matrixBDesc, U32 *bytes, Arch arch);
 
@@ -35,6 +40,40 @@ EE matrix_matrix_multiply(TensorDesc matrixADesc,
     void *matrixC,
     Arch arch);
 
+// C = A * B, and then the epilogue is called on every block of C
+EE matrix_matrix_multiply_with_epilogue(TensorDesc matrixADesc,
+    const void *matrixA,
+    TensorDesc matrixBDesc,
+    const void *matrixB,
+    U32 bytes,
+    void *tmp,
+    TensorDesc matrixCDesc,
+    void *matrixC,
+    MatrixEpilogueFunction epilogue,
+    void *epilogueParam,
+    Arch arch);
+
+// numB is the number of different B matrices, each of them is packed only once
+EE matrix_matrix_multiply_batch_tmp_bytes(
+    TensorDesc matrixADesc, TensorDesc matrixBDesc, U32 numB, U32 *bytes, Arch arch);
+
+// C[i] = A[indexA[i]] * B[indexB[i]] for i < batch. The 2D matrices described by the descs are
+// contiguous in A, B and C, and B is the original matrix instead of the transformed one.
+// The batches are computed in parallel, and C is overwritten.
+EE matrix_matrix_multiply_batch(U32 batch,
+    TensorDesc matrixADesc,
+    const void *matrixA,
+    const U32 *indexA,
+    TensorDesc matrixBDesc,
+    const void *matrixB,
+    U32 numB,
+    const U32 *indexB,
+    U32 bytes,
+    void *tmp,
+    TensorDesc matrixCDesc,
+    void *matrixC,
+    Arch arch);
+
 EE matrix_vector_multiply_tmp_bytes(TensorDesc matrixDesc, TensorDesc vectorDesc, U32 *bytes, Arch);
 
 EE matrix_vector_multiply(TensorDesc matrixDesc,
@@ -61,7 +100,11 @@ inline DataFormat targetFormat4MatrixB(DataType dt)
 #endif
         }
         case DT_I8: {
+#ifdef _USE_X86
+            return DF_NKN32K4;
+#else
             return DF_NKN12K4;
+#endif
         }
         default: {
             CHECK_STATUS(NOT_SUPPORTED);
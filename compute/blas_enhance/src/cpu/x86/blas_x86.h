@@ -17,16 +17,22 @@
 #include "error.h"
 #include "sys.h"
 #include "tensor_desc.h"
+#include "blas_enhance.h"
 
 EE matrix_vector_multiply_tmp_bytes_x86(bool transpose, DataType dt, U32 *bytes);
 
+EE matrix_vector_multiply_transform_weight_x86(
+    TensorDesc desc, const void *src, TensorDesc *descTran, void *dst);
+
+// the int8 matrix must be transformed by matrix_vector_multiply_transform_weight_x86
 EE mvm_x86(U32 row,
     U32 col,
     DataType dt,
-    bool transpose,
+    DataFormat df,
     const void *matrix,
     const void *vector,
-    void *result);
+    void *result,
+    Arch arch);
 
 EE matrix_matrix_multiply_tmp_bytes_x86(
     U32 matrixA_M, U32 matrixA_K, U32 matrixB_K, U32 matrixB_N, DataType dt, U32 *bytes);
@@ -42,6 +48,9 @@ EE mmm_x86(U32 matrixC_N,
     const void *matrixAData,
     const void *matrixBData,
     void *tmp,
-    void *matrixCData);
+    void *matrixCData,
+    MatrixEpilogueFunction epilogue,
+    void *epilogueParam,
+    Arch arch);
 
 #endif
@@ -19,6 +19,7 @@
 #include "error.h"
 #include "tensor_desc.h"
 #include "thread_affinity.h"
+#include "blas_enhance.h"
 
 void mvm_col_fp32(U32 row, U32 col, F32 *matrix, F32 *vector, F32 *result);
 
@@ -34,6 +35,20 @@ inline EE mvm_avx2_fp32(U32 row, U32 col, bool transpose, F32 *matrix, F32 *vect
     return SUCCESS;
 }
 
+void mvm_col_avx512_fp32(U32 row, U32 col, F32 *matrix, F32 *vector, F32 *result);
+
+void mvm_row_avx512_fp32(U32 row, U32 col, F32 *matrix, F32 *vector, F32 *result);
+
+inline EE mvm_avx512_fp32(U32 row, U32 col, bool transpose, F32 *matrix, F32 *vector, F32 *result)
+{
+    if (transpose) {
+        mvm_col_avx512_fp32(row, col, matrix, vector, result);
+    } else {
+        mvm_row_avx512_fp32(row, col, matrix, vector, result);
+    }
+    return SUCCESS;
+}
+
 void matrix_matrix_multiply_tmp_bytes_fp32(
     U32 row1, U32 col1, U32 row2, U32 col2, DataType dt, U32 *bytes);
 
@@ -41,7 +56,26 @@ EE matrix_matrix_multiply_transform_rhsN_fp32(TensorDesc desc, F32 *src, F32 *ds
 
 EE matrix_matrix_multiply_transform_rhsT_fp32(TensorDesc desc, F32 *src, F32 *dst);
 
-EE mmm_avx2_fp32(
-    int M, int N, int K, bool transposeA, F32 *matrix1, F32 *matrix2, F32 *tmp, F32 *result);
+EE mmm_avx2_fp32(int M,
+    int N,
+    int K,
+    bool transposeA,
+    F32 *matrix1,
+    F32 *matrix2,
+    F32 *tmp,
+    F32 *result,
+    MatrixEpilogueFunction epilogue,
+    void *epilogueParam);
+
+EE mmm_avx512_fp32(int M,
+    int N,
+    int K,
+    bool transposeA,
+    F32 *matrix1,
+    F32 *matrix2,
+    F32 *tmp,
+    F32 *result,
+    MatrixEpilogueFunction epilogue,
+    void *epilogueParam);
 
 #endif
\ No newline at end of file
@@ -1401,8 +1401,36 @@ void mmm_avx2_n_mtail(U32 um, U32 un, U32 bk, F32 *matrixA, F32 *matrixB, F32 *m
     }
 }
 
-EE mmm_avx2_fp32(
-    int N, int M, int K, bool transposeA, F32 *matrix1, F32 *matrix2, F32 *tmp, F32 *result)
+// size of the block of B columns that starts at n, it is the split of the transform of B:
+// 24 columns, then 16, 8, 4 and the last 1 ~ 3 columns of the tail
+inline U32 mmm_avx2_block_size_n(U32 N, U32 n)
+{
+    U32 unrollNSize[4] = {4, 8, 16, 24};
+    U32 size = UNI_MIN(UNROLL_N, N - n);
+    return UNI_MIN(unrollNSize[size >> 3], size);
+}
+
+// first column of the nIdx-th block of B, and its size
+inline U32 mmm_avx2_block_n(U32 N, U32 nIdx, U32 *blockSizeN)
+{
+    U32 n = UNI_MIN(nIdx, N / UNROLL_N) * UNROLL_N;
+    for (U32 i = N / UNROLL_N; i < nIdx; i++) {
+        n += mmm_avx2_block_size_n(N, n);
+    }
+    *blockSizeN = mmm_avx2_block_size_n(N, n);
+    return n;
+}
+
+EE mmm_avx2_fp32(int N,
+    int M,
+    int K,
+    bool transposeA,
+    F32 *matrix1,
+    F32 *matrix2,
+    F32 *tmp,
+    F32 *result,
+    MatrixEpilogueFunction epilogue,
+    void *epilogueParam)
 {
     // buffer addr algined to 32
     F32 *packA = (F32 *)align_addr(tmp, 32);
@@ -1413,7 +1441,10 @@ EE mmm_avx2_fp32(
         {mmm_avx2_n_mtail, mmm_avx2_4x4_asm, mmm_avx2_4x8_asm, mmm_avx2_4x16_asm, mmm_avx2_4x24_asm}};
     F32 unrollNSize[4] = {4, 8, 16, 24};
     F32 unrollMSize[3] = {1, 2, 4};
-    U32 blockNNum = N / 24 + (N % 8 != 0) + (N % 24 > 4);
+    U32 blockNNum = N / UNROLL_N;
+    for (U32 n = blockNNum * UNROLL_N; n < (U32)N; n += mmm_avx2_block_size_n(N, n)) {
+        blockNNum++;
+    }
 
 #ifdef _USE_OPENMP
 #pragma omp parallel num_threads(OMP_NUM_THREADS)
@@ -1445,21 +1476,16 @@ EE mmm_avx2_fp32(
                     }
                     kernel[unrollSizeM >> 1][(blockSizeN >> 3) + (blockSizeN > 3)](
                         unrollSizeM, blockSizeN, blockSizeK, curA, curB, result + (m + j) * N, N);
+                    if (epilogue != nullptr && k + blockSizeK == (U32)K) {
+                        epilogue(j + m, unrollSizeM, 0, blockSizeN, epilogueParam);
+                    }
                 }
 #ifdef _USE_OPENMP
 #pragma omp for
 #endif
                 for (int mnIdx = blockMNum; mnIdx < blockNNum * blockMNum; ++mnIdx) {
-                    I32 nIdx = mnIdx / blockMNum;
-                    I32 n = (nIdx - 1) * UNROLL_N;
-                    U32 blockSizeN = UNROLL_N;
-                    if (n + UNROLL_N >= N) {
-                        blockSizeN = UNI_MIN(UNROLL_N, N - n);
-                        blockSizeN = UNI_MIN(unrollNSize[blockSizeN >> 3], blockSizeN);
-                    }
-                    n = n + blockSizeN;
-                    blockSizeN = UNI_MIN(UNROLL_N, N - n);
-                    blockSizeN = UNI_MIN(unrollNSize[blockSizeN >> 3], blockSizeN);
+                    U32 blockSizeN;
+                    U32 n = mmm_avx2_block_n(N, mnIdx / blockMNum, &blockSizeN);
                     F32 *curB = packB + k * N + n * blockSizeK;
 
                     I32 mIdx = mnIdx % blockMNum;
@@ -1469,6 +1495,9 @@ EE mmm_avx2_fp32(
                     kernel[unrollSizeM >> 1][(blockSizeN >> 3) + (blockSizeN > 3)](unrollSizeM,
                         blockSizeN, blockSizeK, packA + m * blockSizeK, curB,
                         result + (m + j) * N + n, N);
+                    if (epilogue != nullptr && k + blockSizeK == (U32)K) {
+                        epilogue(j + m, unrollSizeM, n, blockSizeN, epilogueParam);
+                    }
                 }
             }
         }
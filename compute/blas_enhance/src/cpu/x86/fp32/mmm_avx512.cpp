@@ -0,0 +1,206 @@
+// Copyright (C) 2019. Huawei Technologies Co., Ltd. All rights reserved.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include <vector>
+#include "cpu/x86/fp32/blas_fp32.h"
+#include "error.h"
+#include "types.h"
+#include "x86_avx512_expand.h"
+#ifdef _USE_OPENMP
+#include <omp.h>
+#endif
+
+// B is packed by matrix_matrix_multiply_transform_rhs{N,T}_fp32 in the same layout as the AVX2
+// kernels, so the transformed weights can be used by both archs.
+#define UNROLL_N 24
+#define UNROLL_M 12
+#define BOLCK_M_DIM 768
+#define BOLCK_K_DIM 768
+#define align_addr(addr, unit) (((uintptr_t)addr + unit - 1) / unit * unit)
+
+typedef void (*kernel_func)(
+    U32 un, U32 bk, const F32 *matrixA, const F32 *matrixB, F32 *matrixC, U32 N);
+
+// load the j-th 16 columns of a B row whose width is UN, UN = 0 means un < 4
+template <U32 UN>
+AVX512_TARGET inline __m512 mmm_avx512_load_b(const F32 *matrixB, U32 j, __mmask16 mask)
+{
+    __m512 b;
+    if (UN == 4) {
+        b = _mm512_zextps128_ps512(_mm_loadu_ps(matrixB));
+    } else if (UN == 8 || (UN == 24 && j == 1)) {
+        b = _mm512_loadu_256_ps(matrixB + j * 16);
+    } else if (UN == 0) {
+        b = _mm512_maskz_loadu_ps(mask, matrixB);
+    } else {
+        b = _mm512_loadu_ps(matrixB + j * 16);
+    }
+    return b;
+}
+
+// C[UM][un] += A[bk][UM] * B[bk][un], un is UN except the B blocks narrower than 4
+template <U32 UM, U32 UN>
+AVX512_TARGET void mmm_avx512_kernel(
+    U32 un, U32 bk, const F32 *matrixA, const F32 *matrixB, F32 *matrixC, U32 N)
+{
+    const U32 NV = (UN > 16) ? 2 : 1;
+    const U32 bStep = (UN == 0) ? un : UN;
+    __mmask16 mask[2];
+    mask[0] = _mm512_lane_mask(UNI_MIN(un, 16));
+    mask[1] = _mm512_lane_mask(un - UNI_MIN(un, 16));
+    __m512 c[UM][NV];
+    for (U32 i = 0; i < UM; i++) {
+        for (U32 j = 0; j < NV; j++) {
+            c[i][j] = _mm512_setzero_ps();
+        }
+    }
+    for (U32 k = 0; k < bk; k++) {
+        __m512 b[NV];
+        for (U32 j = 0; j < NV; j++) {
+            b[j] = mmm_avx512_load_b<UN>(matrixB, j, mask[j]);
+        }
+        for (U32 i = 0; i < UM; i++) {
+            __m512 a = _mm512_set1_ps(matrixA[i]);
+            for (U32 j = 0; j < NV; j++) {
+                c[i][j] = _mm512_fmadd_ps(a, b[j], c[i][j]);
+            }
+        }
+        matrixA += UM;
+        matrixB += bStep;
+    }
+    for (U32 i = 0; i < UM; i++) {
+        for (U32 j = 0; j < NV; j++) {
+            F32 *ptr = matrixC + (I64)i * N + j * 16;
+            __m512 x = _mm512_add_ps(c[i][j], _mm512_maskz_loadu_ps(mask[j], ptr));
+            _mm512_mask_storeu_ps(ptr, mask[j], x);
+        }
+    }
+}
+
+template <U32 UN>
+inline kernel_func mmm_avx512_kernel_select(U32 um)
+{
+    kernel_func kernel[UNROLL_M] = {mmm_avx512_kernel<1, UN>, mmm_avx512_kernel<2, UN>,
+        mmm_avx512_kernel<3, UN>, mmm_avx512_kernel<4, UN>, mmm_avx512_kernel<5, UN>,
+        mmm_avx512_kernel<6, UN>, mmm_avx512_kernel<7, UN>, mmm_avx512_kernel<8, UN>,
+        mmm_avx512_kernel<9, UN>, mmm_avx512_kernel<10, UN>, mmm_avx512_kernel<11, UN>,
+        mmm_avx512_kernel<12, UN>};
+    return kernel[um - 1];
+}
+
+// the width of the packed B block that starts at column n
+inline U32 mmm_avx512_unroll_n(U32 N, U32 n)
+{
+    U32 unrollNSize[4] = {4, 8, 16, 24};
+    U32 un = UNI_MIN(UNROLL_N, N - n);
+    return UNI_MIN(unrollNSize[un >> 3], un);
+}
+
+// pack um rows of A to [bk][um]
+static void mmm_avx512_pack_a(
+    U32 um, U32 bk, bool transposeA, U32 M, U32 K, const F32 *src, F32 *dst)
+{
+    if (transposeA) {
+        for (U32 k = 0; k < bk; k++) {
+            memcpy(dst + k * um, src + k * M, um * sizeof(F32));
+        }
+    } else {
+        for (U32 i = 0; i < um; i++) {
+            for (U32 k = 0; k < bk; k++) {
+                dst[k * um + i] = src[i * K + k];
+            }
+        }
+    }
+}
+
+EE mmm_avx512_fp32(int N,
+    int M,
+    int K,
+    bool transposeA,
+    F32 *matrix1,
+    F32 *matrix2,
+    F32 *tmp,
+    F32 *result,
+    MatrixEpilogueFunction epilogue,
+    void *epilogueParam)
+{
+    F32 *packA = (F32 *)align_addr(tmp, 32);
+    F32 *packB = (F32 *)align_addr(matrix2, 32);
+    std::vector<U32> blockNOffset;
+    for (int n = 0; n < N; n += mmm_avx512_unroll_n(N, n)) {
+        blockNOffset.push_back(n);
+    }
+    U32 blockNNum = blockNOffset.size();
+    blockNOffset.push_back(N);
+
+#ifdef _USE_OPENMP
+#pragma omp parallel num_threads(OMP_NUM_THREADS)
+    {
+#endif
+        U32 blockSizeM = 0, blockSizeK = 0;
+        for (int k = 0; k < K; k += blockSizeK) {
+            blockSizeK = UNI_MIN(BOLCK_K_DIM, K - k);
+            for (int j = 0; j < M; j += blockSizeM) {
+                blockSizeM = UNI_MIN(BOLCK_M_DIM, M - j);
+                U32 blockMNum = (blockSizeM + UNROLL_M - 1) / UNROLL_M;
+#ifdef _USE_OPENMP
+#pragma omp for
+#endif
+                for (U32 mIdx = 0; mIdx < blockMNum; ++mIdx) {
+                    U32 m = mIdx * UNROLL_M;
+                    U32 um = UNI_MIN(UNROLL_M, blockSizeM - m);
+                    const F32 *curA = transposeA ? matrix1 + (j + m) + k * M
+                                                 : matrix1 + (j + m) * K + k;
+                    mmm_avx512_pack_a(
+                        um, blockSizeK, transposeA, M, K, curA, packA + m * blockSizeK);
+                }
+#ifdef _USE_OPENMP
+#pragma omp for
+#endif
+                for (U32 mnIdx = 0; mnIdx < blockNNum * blockMNum; ++mnIdx) {
+                    U32 nIdx = mnIdx / blockMNum;
+                    U32 n = blockNOffset[nIdx];
+                    U32 un = blockNOffset[nIdx + 1] - n;
+                    U32 m = (mnIdx % blockMNum) * UNROLL_M;
+                    U32 um = UNI_MIN(UNROLL_M, blockSizeM - m);
+                    kernel_func kernel;
+                    switch (un) {
+                        case 24:
+                            kernel = mmm_avx512_kernel_select<24>(um);
+                            break;
+                        case 16:
+                            kernel = mmm_avx512_kernel_select<16>(um);
+                            break;
+                        case 8:
+                            kernel = mmm_avx512_kernel_select<8>(um);
+                            break;
+                        case 4:
+                            kernel = mmm_avx512_kernel_select<4>(um);
+                            break;
+                        default:
+                            kernel = mmm_avx512_kernel_select<0>(um);
+                            break;
+                    }
+                    kernel(un, blockSizeK, packA + m * blockSizeK,
+                        packB + k * N + n * blockSizeK, result + (j + m) * N + n, N);
+                    if (epilogue != nullptr && k + blockSizeK == (U32)K) {
+                        epilogue(j + m, um, n, un, epilogueParam);
+                    }
+                }
+            }
+        }
+#ifdef _USE_OPENMP
+    }
+#endif
+    return SUCCESS;
+}
@@ -0,0 +1,127 @@
+// Copyright (C) 2019. Huawei Technologies Co., Ltd. All rights reserved.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "cpu/x86/fp32/blas_fp32.h"
+#include "error.h"
+#include "types.h"
+#include "x86_avx512_expand.h"
+
+#define UNROLL_N 8
+#define UNROLL_COL 64
+#define BOLCK_K_DIM 512
+
+typedef void (*kernel_func)(U32 bk, U32 lda, const F32 *matrix, const F32 *vector, F32 *result);
+
+// result[UN] += matrix[UN][bk] * vector[bk], the rows of matrix are lda apart
+template <U32 UN>
+AVX512_TARGET void mvm_row_avx512_kernel(
+    U32 bk, U32 lda, const F32 *matrix, const F32 *vector, F32 *result)
+{
+    __m512 c[UN];
+    for (U32 i = 0; i < UN; i++) {
+        c[i] = _mm512_setzero_ps();
+    }
+    U32 k = 0;
+    for (; k + 16 <= bk; k += 16) {
+        __m512 v = _mm512_loadu_ps(vector + k);
+        for (U32 i = 0; i < UN; i++) {
+            c[i] = _mm512_fmadd_ps(_mm512_loadu_ps(matrix + (I64)i * lda + k), v, c[i]);
+        }
+    }
+    if (k < bk) {
+        __mmask16 mask = _mm512_lane_mask(bk - k);
+        __m512 v = _mm512_maskz_loadu_ps(mask, vector + k);
+        for (U32 i = 0; i < UN; i++) {
+            c[i] = _mm512_fmadd_ps(
+                _mm512_maskz_loadu_ps(mask, matrix + (I64)i * lda + k), v, c[i]);
+        }
+    }
+    for (U32 i = 0; i < UN; i++) {
+        result[i] += _mm512_sum_ps(c[i]);
+    }
+}
+
+void mvm_row_avx512_fp32(U32 numRows, U32 numColumns, F32 *matrix, F32 *vector, F32 *result)
+{
+    // Actual layout is NK, and vector is K
+    kernel_func kernel[UNROLL_N] = {mvm_row_avx512_kernel<1>, mvm_row_avx512_kernel<2>,
+        mvm_row_avx512_kernel<3>, mvm_row_avx512_kernel<4>, mvm_row_avx512_kernel<5>,
+        mvm_row_avx512_kernel<6>, mvm_row_avx512_kernel<7>, mvm_row_avx512_kernel<8>};
+    U32 blockNum = (numRows + UNROLL_N - 1) / UNROLL_N;
+#ifdef _USE_OPENMP
+#pragma omp parallel num_threads(OMP_NUM_THREADS)
+    {
+#endif
+        U32 private_blockKSize = 0;
+        for (U32 bk = 0; bk < numColumns; bk += private_blockKSize) {
+            private_blockKSize = UNI_MIN(numColumns - bk, BOLCK_K_DIM);
+#ifdef _USE_OPENMP
+#pragma omp for
+#endif
+            for (U32 bIdx = 0; bIdx < blockNum; ++bIdx) {
+                U32 bn = bIdx * UNROLL_N;
+                U32 blockNSize = UNI_MIN(numRows - bn, UNROLL_N);
+                kernel[blockNSize - 1](private_blockKSize, numColumns,
+                    matrix + (I64)bn * numColumns + bk, vector + bk, result + bn);
+            }
+        }
+#ifdef _USE_OPENMP
+    }
+#endif
+}
+
+// result[un] += vector[numColumns] * matrix[numColumns][un], the rows of matrix are ldb apart,
+// un is UNROLL_COL if FULL
+template <bool FULL>
+AVX512_TARGET void mvm_col_avx512_kernel(
+    U32 un, U32 numColumns, U32 ldb, const F32 *matrix, const F32 *vector, F32 *result)
+{
+    __mmask16 mask[4];
+    __m512 c[4];
+    for (U32 j = 0; j < 4; j++) {
+        mask[j] = _mm512_lane_mask(un - UNI_MIN(un, j * 16));
+        c[j] = _mm512_maskz_loadu_ps(mask[j], result + j * 16);
+    }
+    for (U32 k = 0; k < numColumns; k++) {
+        __m512 v = _mm512_set1_ps(vector[k]);
+        const F32 *row = matrix + (I64)k * ldb;
+        for (U32 j = 0; j < 4; j++) {
+            __m512 m = FULL ? _mm512_loadu_ps(row + j * 16)
+                            : _mm512_maskz_loadu_ps(mask[j], row + j * 16);
+            c[j] = _mm512_fmadd_ps(m, v, c[j]);
+        }
+    }
+    for (U32 j = 0; j < 4; j++) {
+        _mm512_mask_storeu_ps(result + j * 16, mask[j], c[j]);
+    }
+}
+
+void mvm_col_avx512_fp32(U32 numRows, U32 numColumns, F32 *matrix, F32 *vector, F32 *result)
+{
+    // Actual layout is KN, and vector is K
+    U32 blockNum = (numRows + UNROLL_COL - 1) / UNROLL_COL;
+#ifdef _USE_OPENMP
+#pragma omp parallel for num_threads(OMP_NUM_THREADS)
+#endif
+    for (U32 bIdx = 0; bIdx < blockNum; ++bIdx) {
+        U32 bn = bIdx * UNROLL_COL;
+        U32 blockNSize = UNI_MIN(numRows - bn, UNROLL_COL);
+        if (blockNSize == UNROLL_COL) {
+            mvm_col_avx512_kernel<true>(
+                blockNSize, numColumns, numRows, matrix + bn, vector, result + bn);
+        } else {
+            mvm_col_avx512_kernel<false>(
+                blockNSize, numColumns, numRows, matrix + bn, vector, result + bn);
+        }
+    }
+}
@@ -0,0 +1,67 @@
+// Copyright (C) 2019. Huawei Technologies Co., Ltd. All rights reserved.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#ifndef _H_BLAS_INT8
+#define _H_BLAS_INT8
+
+#include "sys.h"
+#include "types.h"
+#include "error.h"
+#include "tensor_desc.h"
+#include "thread_affinity.h"
+
+// The packed int8 matrix (DF_NKN32K4) is shared by MMM and MVM. It has panels of 32 columns, the
+// last one is padded with zeros, and in each panel 4 consecutive K of a column are adjacent:
+// [N / 32][K4 / 4][32][4]. K4 is K padded to a multiple of 4.
+// The products are exact for the range [-127, 127] of quantize_tensor, the AVX2 kernels may
+// saturate when both INT8 are -128.
+inline U32 pad_to_4_multiple(U32 k)
+{
+    return (k + 3) / 4 * 4;
+}
+
+inline U32 pad_to_32_multiple(U32 n)
+{
+    return (n + 31) / 32 * 32;
+}
+
+EE matrix_vector_multiply_transform_weight_int8(TensorDesc desc, INT8 *src, INT8 *dst);
+
+EE mvm_int8(U32 row, U32 col, INT8 *matrix, INT8 *vector, I32 *result, Arch arch);
+
+void matrix_matrix_multiply_tmp_bytes_int8(
+    U32 row1, U32 col1, U32 row2, U32 col2, DataType dt, U32 *bytes);
+
+EE matrix_matrix_multiply_transform_rhsN_int8(TensorDesc desc, INT8 *src, INT8 *dst);
+
+EE matrix_matrix_multiply_transform_rhsT_int8(TensorDesc desc, INT8 *src, INT8 *dst);
+
+// C[um][un] += A[um][K4] * B[K4][un] for a block of at most 32 columns
+typedef void (*mmm_int8_kernel_func)(
+    U32 un, U32 K4, const INT8 *matrixA, const INT8 *matrixB, I32 *matrixC, U32 N);
+
+// the VNNI kernel of um rows, um is at most 8. A is flipped by 0x80 to be unsigned.
+mmm_int8_kernel_func mmm_avx512_vnni_kernel_select(U32 um);
+
+EE mmm_int8(int N,
+    int M,
+    int K,
+    bool transposeA,
+    INT8 *matrix1,
+    INT8 *matrix2,
+    INT8 *tmp,
+    I32 *result,
+    Arch arch);
+
+#endif
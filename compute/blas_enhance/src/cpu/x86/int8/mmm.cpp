@@ -0,0 +1,203 @@
+// Copyright (C) 2019. Huawei Technologies Co., Ltd. All rights reserved.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#include <string.h>
+#include "cpu/x86/int8/blas_int8.h"
+#include "error.h"
+#include "types.h"
+#ifdef _USE_OPENMP
+#include <omp.h>
+#endif
+
+#define UNROLL_N 32
+#define UNROLL_M 2
+#define UNROLL_M_VNNI 8
+
+void matrix_matrix_multiply_tmp_bytes_int8(
+    U32 row1, U32 col1, U32 row2, U32 col2, DataType dt, U32 *bytes)
+{
+    // the packed A and, if B is not transformed, the packed B
+    U32 K4 = pad_to_4_multiple(col1);
+    *bytes = (row1 + pad_to_32_multiple(col2)) * K4 * bytesOf(dt);
+}
+
+// pack B[K][N] to DF_NKN32K4, the element (k, n) is at src[k * strideK + n * strideN]
+static void matrix_pack_int8(U32 N, U32 K, U32 strideN, U32 strideK, const INT8 *src, INT8 *dst)
+{
+    U32 K4 = pad_to_4_multiple(K);
+    U32 N32 = pad_to_32_multiple(N);
+#ifdef _USE_OPENMP
+#pragma omp parallel for num_threads(OMP_NUM_THREADS)
+#endif
+    for (U32 n = 0; n < N32; n += UNROLL_N) {
+        INT8 *panel = dst + n * K4;
+        for (U32 k = 0; k < K4; k += 4) {
+            for (U32 i = 0; i < UNROLL_N; i++) {
+                for (U32 j = 0; j < 4; j++) {
+                    bool valid = (n + i < N) && (k + j < K);
+                    *(panel++) = valid ? src[(k + j) * strideK + (n + i) * strideN] : 0;
+                }
+            }
+        }
+    }
+}
+
+EE matrix_matrix_multiply_transform_rhsN_int8(TensorDesc desc, INT8 *src, INT8 *dst)
+{
+    DataType dt;
+    DataFormat df;
+    U32 N, K;
+    CHECK_STATUS(tensor2dGet(desc, &dt, &df, &K, &N));
+    matrix_pack_int8(N, K, 1, N, src, dst);
+    return SUCCESS;
+}
+
+EE matrix_matrix_multiply_transform_rhsT_int8(TensorDesc desc, INT8 *src, INT8 *dst)
+{
+    DataType dt;
+    DataFormat df;
+    U32 N, K;
+    CHECK_STATUS(tensor2dGet(desc, &dt, &df, &N, &K));
+    matrix_pack_int8(N, K, K, 1, src, dst);
+    return SUCCESS;
+}
+
+EE matrix_vector_multiply_transform_weight_int8(TensorDesc desc, INT8 *src, INT8 *dst)
+{
+    DataType dt;
+    DataFormat df;
+    U32 N, K;
+    EE ret = SUCCESS;
+    switch (desc.df) {
+        case DF_NORMAL: {
+            CHECK_STATUS(tensor2dGet(desc, &dt, &df, &N, &K));
+            matrix_pack_int8(N, K, K, 1, src, dst);
+            break;
+        }
+        case DF_TRANSPOSE: {
+            CHECK_STATUS(tensor2dGet(desc, &dt, &df, &K, &N));
+            matrix_pack_int8(N, K, 1, N, src, dst);
+            break;
+        }
+        default:
+            ret = NOT_SUPPORTED;
+            break;
+    }
+    return ret;
+}
+
+// pack A[M][K] to [M][K4], the padded K are 0 and all bytes are xor-ed with flip
+static void mmm_int8_pack_a(
+    U32 M, U32 K, bool transposeA, const INT8 *src, INT8 flip, INT8 *dst)
+{
+    U32 K4 = pad_to_4_multiple(K);
+#ifdef _USE_OPENMP
+#pragma omp parallel for num_threads(OMP_NUM_THREADS)
+#endif
+    for (U32 i = 0; i < M; i++) {
+        INT8 *row = dst + i * K4;
+        for (U32 k = 0; k < K; k++) {
+            row[k] = (transposeA ? src[k * M + i] : src[i * K + k]) ^ flip;
+        }
+        for (U32 k = K; k < K4; k++) {
+            row[k] = flip;
+        }
+    }
+}
+
+inline __m256i _mm256_lane_mask_epi32(I32 num)
+{
+    return _mm256_cmpgt_epi32(_mm256_set1_epi32(num), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+}
+
+// The u8 x s8 products of maddubs are summed to int16 in pairs, so they are made of |a| and the
+// b with the sign of a. Unlike the offset 128 of VNNI, this can not saturate in [-127, 127].
+template <U32 UM>
+void mmm_avx2_int8_kernel(
+    U32 un, U32 K4, const INT8 *matrixA, const INT8 *matrixB, I32 *matrixC, U32 N)
+{
+    const __m256i ones = _mm256_set1_epi16(1);
+    __m256i c[UM][4];
+    for (U32 i = 0; i < UM; i++) {
+        for (U32 j = 0; j < 4; j++) {
+            c[i][j] = _mm256_setzero_si256();
+        }
+    }
+    for (U32 k = 0; k < K4; k += 4) {
+        __m256i b[4];
+        for (U32 j = 0; j < 4; j++) {
+            b[j] = _mm256_loadu_si256((const __m256i *)(matrixB + j * 32));
+        }
+        for (U32 i = 0; i < UM; i++) {
+            __m256i a = _mm256_set1_epi32(*(const I32 *)(matrixA + i * K4 + k));
+            __m256i absA = _mm256_abs_epi8(a);
+            for (U32 j = 0; j < 4; j++) {
+                __m256i p = _mm256_maddubs_epi16(absA, _mm256_sign_epi8(b[j], a));
+                c[i][j] = _mm256_add_epi32(c[i][j], _mm256_madd_epi16(p, ones));
+            }
+        }
+        matrixB += UNROLL_N * 4;
+    }
+    for (U32 i = 0; i < UM; i++) {
+        for (U32 j = 0; j < 4 && j * 8 < un; j++) {
+            I32 *ptr = matrixC + i * N + j * 8;
+            if (un >= j * 8 + 8) {
+                __m256i x = _mm256_loadu_si256((const __m256i *)ptr);
+                _mm256_storeu_si256((__m256i *)ptr, _mm256_add_epi32(x, c[i][j]));
+            } else {
+                __m256i mask = _mm256_lane_mask_epi32(un - j * 8);
+                __m256i x = _mm256_maskload_epi32(ptr, mask);
+                _mm256_maskstore_epi32(ptr, mask, _mm256_add_epi32(x, c[i][j]));
+            }
+        }
+    }
+}
+
+EE mmm_int8(int N,
+    int M,
+    int K,
+    bool transposeA,
+    INT8 *matrix1,
+    INT8 *matrix2,
+    INT8 *tmp,
+    I32 *result,
+    Arch arch)
+{
+    bool vnni = IS_X86_AVX512(arch) && x86_cpu_has_avx512_vnni();
+    U32 unrollM = vnni ? UNROLL_M_VNNI : UNROLL_M;
+    U32 K4 = pad_to_4_multiple(K);
+    INT8 *packA = tmp;
+    mmm_int8_pack_a(M, K, transposeA, matrix1, vnni ? (INT8)0x80 : 0, packA);
+
+    U32 blockNNum = (N + UNROLL_N - 1) / UNROLL_N;
+    U32 blockMNum = (M + unrollM - 1) / unrollM;
+    // the blocks of a B panel are adjacent to reuse it in the cache
+#ifdef _USE_OPENMP
+#pragma omp parallel for num_threads(OMP_NUM_THREADS)
+#endif
+    for (U32 mnIdx = 0; mnIdx < blockNNum * blockMNum; ++mnIdx) {
+        U32 n = (mnIdx / blockMNum) * UNROLL_N;
+        U32 m = (mnIdx % blockMNum) * unrollM;
+        U32 un = UNI_MIN(UNROLL_N, N - n);
+        U32 um = UNI_MIN(unrollM, M - m);
+        mmm_int8_kernel_func kernel;
+        if (vnni) {
+            kernel = mmm_avx512_vnni_kernel_select(um);
+        } else {
+            kernel = (um == 2) ? mmm_avx2_int8_kernel<2> : mmm_avx2_int8_kernel<1>;
+        }
+        kernel(un, K4, packA + m * K4, matrix2 + n * K4, result + m * N + n, N);
+    }
+    return SUCCESS;
+}
@@ -0,0 +1,70 @@
+// Copyright (C) 2019. Huawei Technologies Co., Ltd. All rights reserved.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#include "x86_avx512_expand.h"
+#include "cpu/x86/int8/blas_int8.h"
+#include "error.h"
+#include "types.h"
+
+// A is flipped to a + 128, so C = sum((a + 128) * b) - 128 * sum(b), and the column sums of B
+// are computed by the kernel with one more dot product for every um rows.
+template <U32 UM>
+AVX512_VNNI_TARGET void mmm_avx512_vnni_kernel(
+    U32 un, U32 K4, const INT8 *matrixA, const INT8 *matrixB, I32 *matrixC, U32 N)
+{
+    const __m512i ones = _mm512_set1_epi8(1);
+    __m512i c[UM][2], s[2];
+    for (U32 j = 0; j < 2; j++) {
+        s[j] = _mm512_setzero_si512();
+        for (U32 i = 0; i < UM; i++) {
+            c[i][j] = _mm512_setzero_si512();
+        }
+    }
+    for (U32 k = 0; k < K4; k += 4) {
+        __m512i b[2];
+        for (U32 j = 0; j < 2; j++) {
+            b[j] = _mm512_loadu_si512(matrixB + j * 64);
+            s[j] = _mm512_dpbusd_epi32(s[j], ones, b[j]);
+        }
+        for (U32 i = 0; i < UM; i++) {
+            __m512i a = _mm512_set1_epi32(*(const I32 *)(matrixA + (I64)i * K4 + k));
+            for (U32 j = 0; j < 2; j++) {
+                c[i][j] = _mm512_dpbusd_epi32(c[i][j], a, b[j]);
+            }
+        }
+        matrixB += 128;
+    }
+    for (U32 j = 0; j < 2; j++) {
+        s[j] = _mm512_shl_epi32(s[j], 7);
+    }
+    __mmask16 mask[2];
+    mask[0] = _mm512_lane_mask(UNI_MIN(un, 16));
+    mask[1] = _mm512_lane_mask(un - UNI_MIN(un, 16));
+    for (U32 i = 0; i < UM; i++) {
+        for (U32 j = 0; j < 2; j++) {
+            I32 *ptr = matrixC + (I64)i * N + j * 16;
+            __m512i x = _mm512_sub_epi32(c[i][j], s[j]);
+            x = _mm512_add_epi32(x, _mm512_maskz_loadu_epi32(mask[j], ptr));
+            _mm512_mask_storeu_epi32(ptr, mask[j], x);
+        }
+    }
+}
+
+mmm_int8_kernel_func mmm_avx512_vnni_kernel_select(U32 um)
+{
+    mmm_int8_kernel_func kernel[8] = {mmm_avx512_vnni_kernel<1>, mmm_avx512_vnni_kernel<2>,
+        mmm_avx512_vnni_kernel<3>, mmm_avx512_vnni_kernel<4>, mmm_avx512_vnni_kernel<5>,
+        mmm_avx512_vnni_kernel<6>, mmm_avx512_vnni_kernel<7>, mmm_avx512_vnni_kernel<8>};
+    return kernel[um - 1];
+}
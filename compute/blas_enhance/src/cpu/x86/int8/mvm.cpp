@@ -0,0 +1,113 @@
+// Copyright (C) 2019. Huawei Technologies Co., Ltd. All rights reserved.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#include <string.h>
+#include "x86_avx512_expand.h"
+#include "cpu/x86/int8/blas_int8.h"
+#include "error.h"
+#include "types.h"
+#ifdef _USE_OPENMP
+#include <omp.h>
+#endif
+
+#define UNROLL_N 32
+
+// the 4 elements of the vector from k, the elements beyond K are 0
+inline I32 mvm_int8_load_vector(U32 K, U32 k, const INT8 *vector)
+{
+    I32 v = 0;
+    if (k + 4 <= K) {
+        v = *(const I32 *)(vector + k);
+    } else {
+        memcpy(&v, vector + k, K - k);
+    }
+    return v;
+}
+
+// result[un] += panel[un][K] * vector[K] for one panel of the packed matrix
+static void mvm_avx2_int8_panel(U32 un, U32 K, const INT8 *panel, const INT8 *vector, I32 *result)
+{
+    const __m256i ones = _mm256_set1_epi16(1);
+    __m256i c[4];
+    for (U32 j = 0; j < 4; j++) {
+        c[j] = _mm256_setzero_si256();
+    }
+    for (U32 k = 0; k < K; k += 4) {
+        __m256i a = _mm256_set1_epi32(mvm_int8_load_vector(K, k, vector));
+        __m256i absA = _mm256_abs_epi8(a);
+        for (U32 j = 0; j < 4; j++) {
+            __m256i b = _mm256_loadu_si256((const __m256i *)(panel + j * 32));
+            __m256i p = _mm256_maddubs_epi16(absA, _mm256_sign_epi8(b, a));
+            c[j] = _mm256_add_epi32(c[j], _mm256_madd_epi16(p, ones));
+        }
+        panel += UNROLL_N * 4;
+    }
+    I32 buffer[UNROLL_N];
+    for (U32 j = 0; j < 4; j++) {
+        _mm256_storeu_si256((__m256i *)(buffer + j * 8), c[j]);
+    }
+    for (U32 j = 0; j < un; j++) {
+        result[j] += buffer[j];
+    }
+}
+
+// the vector is flipped by 0x80 like the A of mmm_avx512_vnni_kernel
+AVX512_VNNI_TARGET static void mvm_avx512_vnni_panel(
+    U32 un, U32 K, const INT8 *panel, const INT8 *vector, I32 *result)
+{
+    const __m512i ones = _mm512_set1_epi8(1);
+    const __m512i flip = _mm512_set1_epi8((char)0x80);
+    __m512i c[2], s[2];
+    for (U32 j = 0; j < 2; j++) {
+        c[j] = _mm512_setzero_si512();
+        s[j] = _mm512_setzero_si512();
+    }
+    for (U32 k = 0; k < K; k += 4) {
+        __m512i a = _mm512_set1_epi32(mvm_int8_load_vector(K, k, vector));
+        a = _mm512_xor_si512(a, flip);
+        for (U32 j = 0; j < 2; j++) {
+            __m512i b = _mm512_loadu_si512(panel + j * 64);
+            c[j] = _mm512_dpbusd_epi32(c[j], a, b);
+            s[j] = _mm512_dpbusd_epi32(s[j], ones, b);
+        }
+        panel += 128;
+    }
+    __mmask16 mask[2];
+    mask[0] = _mm512_lane_mask(UNI_MIN(un, 16));
+    mask[1] = _mm512_lane_mask(un - UNI_MIN(un, 16));
+    for (U32 j = 0; j < 2; j++) {
+        I32 *ptr = result + j * 16;
+        __m512i x = _mm512_sub_epi32(c[j], _mm512_shl_epi32(s[j], 7));
+        x = _mm512_add_epi32(x, _mm512_maskz_loadu_epi32(mask[j], ptr));
+        _mm512_mask_storeu_epi32(ptr, mask[j], x);
+    }
+}
+
+EE mvm_int8(U32 row, U32 col, INT8 *matrix, INT8 *vector, I32 *result, Arch arch)
+{
+    bool vnni = IS_X86_AVX512(arch) && x86_cpu_has_avx512_vnni();
+    U32 K4 = pad_to_4_multiple(col);
+#ifdef _USE_OPENMP
+#pragma omp parallel for num_threads(OMP_NUM_THREADS)
+#endif
+    for (U32 n = 0; n < row; n += UNROLL_N) {
+        U32 un = UNI_MIN(UNROLL_N, row - n);
+        if (vnni) {
+            mvm_avx512_vnni_panel(un, col, matrix + n * K4, vector, result + n);
+        } else {
+            mvm_avx2_int8_panel(un, col, matrix + n * K4, vector, result + n);
+        }
+    }
+    return SUCCESS;
+}
@@ -18,6 +18,9 @@
 #ifdef _USE_FP32
 #include "cpu/x86/fp32/blas_fp32.h"
 #endif
+#ifdef _USE_INT8
+#include "cpu/x86/int8/blas_int8.h"
+#endif
 
 EE matrix_matrix_multiply_tmp_bytes_x86(
     U32 matrixA_M, U32 matrixA_K, U32 matrixB_K, U32 matrixB_N, DataType dt, U32 *bytes)
@@ -30,6 +33,13 @@ EE matrix_matrix_multiply_tmp_bytes_x86(
                 matrixA_M, matrixA_K, matrixB_K, matrixB_N, dt, bytes);
             break;
         }
+#endif
+#ifdef _USE_INT8
+        case DT_I8: {
+            matrix_matrix_multiply_tmp_bytes_int8(
+                matrixA_M, matrixA_K, matrixB_K, matrixB_N, dt, bytes);
+            break;
+        }
 #endif
         default:
             ret = NOT_SUPPORTED;
@@ -49,6 +59,12 @@ static EE matrix_matrix_multiply_transform_rhsN(
             ret = matrix_matrix_multiply_transform_rhsN_fp32(desc, (F32 *)src, (F32 *)dst);
             break;
         }
+#endif
+#ifdef _USE_INT8
+        case DT_I8: {
+            ret = matrix_matrix_multiply_transform_rhsN_int8(desc, (INT8 *)src, (INT8 *)dst);
+            break;
+        }
 #endif
         default:
             ret = NOT_SUPPORTED;
@@ -69,6 +85,12 @@ static EE matrix_matrix_multiply_transform_rhsT(
             ret = matrix_matrix_multiply_transform_rhsT_fp32(desc, (F32 *)src, (F32 *)dst);
             break;
         }
+#endif
+#ifdef _USE_INT8
+        case DT_I8: {
+            ret = matrix_matrix_multiply_transform_rhsT_int8(desc, (INT8 *)src, (INT8 *)dst);
+            break;
+        }
 #endif
         default:
             ret = NOT_SUPPORTED;
@@ -111,14 +133,34 @@ EE mmm_x86(U32 matrixC_N,
     const void *matrixAData,
     const void *matrixBData,
     void *tmp,
-    void *matrixCData)
+    void *matrixCData,
+    MatrixEpilogueFunction epilogue,
+    void *epilogueParam,
+    Arch arch)
 {
     EE ret = SUCCESS;
     switch (dt) {
 #ifdef _USE_FP32
         case DT_F32: {
-            ret = mmm_avx2_fp32(matrixC_N, matrixC_M, matrixA_K, transposeA, (F32 *)matrixAData,
-                (F32 *)matrixBData, (F32 *)tmp, (F32 *)matrixCData);
+            if (IS_X86_AVX512(arch)) {
+                ret = mmm_avx512_fp32(matrixC_N, matrixC_M, matrixA_K, transposeA,
+                    (F32 *)matrixAData, (F32 *)matrixBData, (F32 *)tmp, (F32 *)matrixCData,
+                    epilogue, epilogueParam);
+            } else {
+                ret = mmm_avx2_fp32(matrixC_N, matrixC_M, matrixA_K, transposeA,
+                    (F32 *)matrixAData, (F32 *)matrixBData, (F32 *)tmp, (F32 *)matrixCData,
+                    epilogue, epilogueParam);
+            }
+            break;
+        }
+#endif
+#ifdef _USE_INT8
+        case DT_I8: {
+            ret = mmm_int8(matrixC_N, matrixC_M, matrixA_K, transposeA, (INT8 *)matrixAData,
+                (INT8 *)matrixBData, (INT8 *)tmp, (I32 *)matrixCData, arch);
+            if (ret == SUCCESS && epilogue != nullptr) {
+                epilogue(0, matrixC_M, 0, matrixC_N, epilogueParam);
+            }
             break;
         }
 #endif
@@ -18,6 +18,9 @@
 #ifdef _USE_FP32
 #include "cpu/x86/fp32/blas_fp32.h"
 #endif
+#ifdef _USE_INT8
+#include "cpu/x86/int8/blas_int8.h"
+#endif
 
 EE matrix_vector_multiply_tmp_bytes_x86(bool transpose, DataType dt, U32 *bytes)
 {
@@ -29,6 +32,11 @@ EE matrix_vector_multiply_tmp_bytes_x86(bool transpose, DataType dt, U32 *bytes)
         case DT_F32:
             *bytes = 0;
             break;
+#endif
+#ifdef _USE_INT8
+        case DT_I8:
+            *bytes = 0;
+            break;
 #endif
         default:
             break;
@@ -36,14 +44,59 @@ EE matrix_vector_multiply_tmp_bytes_x86(bool transpose, DataType dt, U32 *bytes)
     return SUCCESS;
 }
 
-EE mvm_x86(
-    U32 row, U32 col, DataType dt, bool transpose, const void *matrix, const void *vector, void *result)
+EE matrix_vector_multiply_transform_weight_x86(
+    TensorDesc desc, const void *src, TensorDesc *descTran, void *dst)
+{
+    EE ret = NOT_SUPPORTED;
+    switch (desc.dt) {
+#ifdef _USE_INT8
+        case DT_I8: {
+            ret = matrix_vector_multiply_transform_weight_int8(desc, (INT8 *)src, (INT8 *)dst);
+            *descTran = desc;
+            if (DF_TRANSPOSE == desc.df) {
+                std::swap(descTran->dims[0], descTran->dims[1]);
+            }
+            descTran->df = targetFormat4mvmMatrix(desc.dt);
+            break;
+        }
+#endif
+        default:
+            break;
+    }
+    return ret;
+}
+
+EE mvm_x86(U32 row,
+    U32 col,
+    DataType dt,
+    DataFormat df,
+    const void *matrix,
+    const void *vector,
+    void *result,
+    Arch arch)
 {
     EE ret = SUCCESS;
+    bool transpose = (DF_TRANSPOSE == df);
     switch (dt) {
 #ifdef _USE_FP32
         case DT_F32: {
-            ret = mvm_avx2_fp32(row, col, transpose, (F32 *)matrix, (F32 *)vector, (F32 *)result);
+            if (IS_X86_AVX512(arch)) {
+                ret = mvm_avx512_fp32(
+                    row, col, transpose, (F32 *)matrix, (F32 *)vector, (F32 *)result);
+            } else {
+                ret = mvm_avx2_fp32(
+                    row, col, transpose, (F32 *)matrix, (F32 *)vector, (F32 *)result);
+            }
+            break;
+        }
+#endif
+#ifdef _USE_INT8
+        case DT_I8: {
+            if (df != targetFormat4mvmMatrix(dt)) {
+                ret = NOT_SUPPORTED;
+                break;
+            }
+            ret = mvm_int8(row, col, (INT8 *)matrix, (INT8 *)vector, (I32 *)result, arch);
             break;
         }
 #endif
@@ -12,6 +12,7 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include "blas_enhance.h"
+#include "thread_affinity.h"
 #ifdef _USE_GENERAL
 #include "cpu/general/blas_general.h"
 #endif
@@ -42,7 +43,7 @@ EE matrix_matrix_multiply_tmp_bytes(
         ret = SUCCESS;
 #endif
 #ifdef _USE_X86
-    } else if (IS_X86_AVX2(arch)) {
+    } else if (IS_X86(arch)) {
         ret = matrix_matrix_multiply_tmp_bytes_x86(
             matrixA_M, matrixA_K, matrixB_K, matrixB_N, matrixADataType, bytes);
 #endif
@@ -72,7 +73,7 @@ EE matrix_matrix_multiply_transform_rhs(
     }
 #endif
 #ifdef _USE_X86
-    if (IS_X86_AVX2(arch)) {
+    if (IS_X86(arch)) {
         ret = matrix_matrix_multiply_transform_rhs_x86(desc, src, descTran, dst);
     }
 #endif
@@ -88,6 +89,22 @@ EE matrix_matrix_multiply(TensorDesc matrixADesc,
     TensorDesc matrixCDesc,
     void *matrixCData,
     Arch arch)
+{
+    return matrix_matrix_multiply_with_epilogue(matrixADesc, matrixAData, matrixBDesc,
+        matrixBData, bytes, tmp, matrixCDesc, matrixCData, nullptr, nullptr, arch);
+}
+
+EE matrix_matrix_multiply_with_epilogue(TensorDesc matrixADesc,
+    const void *matrixAData,
+    TensorDesc matrixBDesc,
+    const void *matrixBData,
+    U32 bytes,
+    void *tmp,
+    TensorDesc matrixCDesc,
+    void *matrixCData,
+    MatrixEpilogueFunction epilogue,
+    void *epilogueParam,
+    Arch arch)
 {
     if (bytes != 0 && tmp == nullptr) {
         CHECK_STATUS(NULL_POINTER);
@@ -133,18 +150,25 @@ EE matrix_matrix_multiply(TensorDesc matrixADesc,
 #ifdef _USE_GENERAL
         ret = mmm_general(matrixC_N, matrixC_M, matrixA_K, transposeA, transposeB, matrixADataType,
             matrixAData, matrixBData, matrixCData);
+        if (ret == SUCCESS && epilogue != nullptr) {
+            epilogue(0, matrixC_M, 0, matrixC_N, epilogueParam);
+        }
 #endif
 #ifdef _USE_X86
-    } else if (IS_X86_AVX2(arch)) {
+    } else if (IS_X86(arch)) {
         TensorDesc tranDescB;
         U8 *dataB = (U8 *)matrixBData;
         if (matrixBDataFormat != targetFormat4MatrixB(matrixBDataType)) {
-            dataB = ((U8 *)tmp) + matrixA_M * matrixA_K * bytesOf(matrixADataType);
+            U32 K = matrixA_K;
+            if (DT_I8 == matrixADataType) {
+                K = (K + 3) / 4 * 4;
+            }
+            dataB = ((U8 *)tmp) + matrixA_M * K * bytesOf(matrixADataType);
             ret = matrix_matrix_multiply_transform_rhs_x86(
                 matrixBDesc, matrixBData, &tranDescB, dataB);
         }
         ret = mmm_x86(matrixC_N, matrixC_M, matrixA_K, matrixADataType, transposeA, matrixAData,
-            dataB, tmp, matrixCData);
+            dataB, tmp, matrixCData, epilogue, epilogueParam, arch);
 #endif
 #ifdef _USE_NEON
     } else {
@@ -161,7 +185,170 @@ EE matrix_matrix_multiply(TensorDesc matrixADesc,
         }
         ret = mmm_arm(matrixC_N, matrixC_M, matrixA_K, matrixADataType, transposeA, matrixAData,
             dataB, tmp, matrixCData, arch);
+        if (ret == SUCCESS && epilogue != nullptr) {
+            epilogue(0, matrixC_M, 0, matrixC_N, epilogueParam);
+        }
+#endif
+    }
+    return ret;
+}
+
+// the workspace of one multiplication, it is also the size of a packed B
+static U32 matrix_matrix_multiply_slice_bytes(
+    TensorDesc matrixADesc, TensorDesc matrixBDesc, Arch arch)
+{
+    U32 bytes = 0;
+    CHECK_STATUS(matrix_matrix_multiply_tmp_bytes(matrixADesc, matrixBDesc, &bytes, arch));
+    return (bytes + 63) / 64 * 64;
+}
+
+EE matrix_matrix_multiply_batch_tmp_bytes(
+    TensorDesc matrixADesc, TensorDesc matrixBDesc, U32 numB, U32 *bytes, Arch arch)
+{
+    if (bytes == nullptr) {
+        CHECK_STATUS(NULL_POINTER);
+    }
+    // the packed B matrices and a workspace for the packed A of each thread
+    *bytes = matrix_matrix_multiply_slice_bytes(matrixADesc, matrixBDesc, arch) *
+        (numB + OMP_NUM_THREADS);
+    return SUCCESS;
+}
+
+// C = A * B, B has been transformed to targetFormat4MatrixB
+static EE mmm_packed(U32 N,
+    U32 M,
+    U32 K,
+    DataType dt,
+    bool transposeA,
+    const void *matrixA,
+    const void *matrixB,
+    void *tmp,
+    void *matrixC,
+    Arch arch)
+{
+    EE ret = NOT_SUPPORTED;
+#ifdef _USE_X86
+    if (IS_X86(arch)) {
+        ret = mmm_x86(N, M, K, dt, transposeA, matrixA, matrixB, tmp, matrixC, nullptr, nullptr,
+            arch);
+    }
+#endif
+#ifdef _USE_NEON
+    if (IS_ARM(arch)) {
+        ret = mmm_arm(N, M, K, dt, transposeA, matrixA, matrixB, tmp, matrixC, arch);
+    }
 #endif
+    return ret;
+}
+
+EE matrix_matrix_multiply_batch(U32 batch,
+    TensorDesc matrixADesc,
+    const void *matrixA,
+    const U32 *indexA,
+    TensorDesc matrixBDesc,
+    const void *matrixB,
+    U32 numB,
+    const U32 *indexB,
+    U32 bytes,
+    void *tmp,
+    TensorDesc matrixCDesc,
+    void *matrixC,
+    Arch arch)
+{
+    if (nullptr == matrixA || nullptr == matrixB || nullptr == matrixC || nullptr == indexA ||
+        nullptr == indexB) {
+        CHECK_STATUS(NULL_POINTER);
+    }
+    DataType adt, bdt, cdt;
+    DataFormat adf, bdf, cdf;
+    U32 M, K, bK, N, cM, cN;
+    CHECK_STATUS(tensor2dGet(matrixADesc, &adt, &adf, &M, &K));
+    CHECK_STATUS(tensor2dGet(matrixBDesc, &bdt, &bdf, &bK, &N));
+    CHECK_STATUS(tensor2dGet(matrixCDesc, &cdt, &cdf, &cM, &cN));
+    bool transposeA = (adf == DF_TRANSPOSE);
+    bool transposeB = (bdf == DF_TRANSPOSE);
+    if (transposeA) {
+        std::swap(M, K);
+    }
+    if (transposeB) {
+        std::swap(bK, N);
+    }
+    if (adt != bdt || (adt != cdt && (adt != DT_I8 || cdt != DT_I32))) {
+        CHECK_STATUS(NOT_MATCH);
+    }
+    if (M != cM || N != cN || K != bK) {
+        CHECK_STATUS(NOT_MATCH);
+    }
+    if (bdf != DF_NORMAL && bdf != DF_TRANSPOSE) {
+        CHECK_STATUS(NOT_SUPPORTED);
+    }
+    U32 aBytes = tensorNumBytes(matrixADesc);
+    U32 bBytes = tensorNumBytes(matrixBDesc);
+    U32 cBytes = tensorNumBytes(matrixCDesc);
+    const U8 *aPtr = (const U8 *)matrixA;
+    const U8 *bPtr = (const U8 *)matrixB;
+    U8 *cPtr = (U8 *)matrixC;
+
+    if (IS_GENERAL(arch)) {
+        EE ret = NOT_SUPPORTED;
+#ifdef _USE_GENERAL
+        ret = SUCCESS;
+#ifdef _USE_OPENMP
+#pragma omp parallel for num_threads(OMP_NUM_THREADS)
+#endif
+        for (U32 i = 0; i < batch; i++) {
+            U8 *c = cPtr + i * cBytes;
+            memset(c, 0, cBytes);
+            mmm_general(N, M, K, transposeA, transposeB, adt, aPtr + indexA[i] * aBytes,
+                bPtr + indexB[i] * bBytes, c);
+        }
+#endif
+        return ret;
+    }
+
+    // every B is packed once, and then shared by the batches that use it
+    U32 sliceBytes = matrix_matrix_multiply_slice_bytes(matrixADesc, matrixBDesc, arch);
+    if (tmp == nullptr || bytes < sliceBytes * (numB + 1)) {
+        CHECK_STATUS(NOT_MATCH);
+    }
+    U8 *packB = (U8 *)tmp;
+    U8 *workspace = packB + sliceBytes * numB;
+    EE ret = SUCCESS;
+#ifdef _USE_OPENMP
+#pragma omp parallel for num_threads(OMP_NUM_THREADS)
+#endif
+    for (U32 i = 0; i < numB; i++) {
+        TensorDesc desc;
+        if (matrix_matrix_multiply_transform_rhs(
+                matrixBDesc, bPtr + i * bBytes, &desc, packB + i * sliceBytes, arch) != SUCCESS) {
+            ret = NOT_SUPPORTED;
+        }
+    }
+    if (ret != SUCCESS) {
+        return ret;
+    }
+
+    // small batches use the threads of the kernel inside one multiplication
+    U32 threadNum = UNI_MIN((U32)OMP_NUM_THREADS, bytes / sliceBytes - numB);
+    if (batch < threadNum) {
+        threadNum = 1;
+    }
+    // the kernels accumulate to C, so every C is cleared right before it is computed
+#ifdef _USE_OPENMP
+#pragma omp parallel for num_threads(threadNum) if (threadNum > 1)
+#endif
+    for (U32 i = 0; i < batch; i++) {
+        U32 threadId = 0;
+#ifdef _USE_OPENMP
+        threadId = (threadNum > 1) ? omp_get_thread_num() : 0;
+#endif
+        U8 *c = cPtr + i * cBytes;
+        memset(c, 0, cBytes);
+        if (mmm_packed(N, M, K, adt, transposeA, aPtr + indexA[i] * aBytes,
+                packB + indexB[i] * sliceBytes, workspace + threadId * sliceBytes, c,
+                arch) != SUCCESS) {
+            ret = NOT_SUPPORTED;
+        }
     }
     return ret;
 }
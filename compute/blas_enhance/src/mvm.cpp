@@ -34,7 +34,7 @@ EE matrix_vector_multiply_tmp_bytes(
         ret = SUCCESS;
 #endif
 #ifdef _USE_X86
-    } else if (IS_X86_AVX2(arch)) {
+    } else if (IS_X86(arch)) {
         ret = matrix_vector_multiply_tmp_bytes_x86(transpose, matrixDesc.dt, bytes);
 #endif
 #ifdef _USE_NEON
@@ -60,6 +60,11 @@ EE matrix_vector_multiply_transform_weight(
         (*descTran) = desc;
         ret = SUCCESS;
     }
+#endif
+#ifdef _USE_X86
+    if (IS_X86(arch)) {
+        ret = matrix_vector_multiply_transform_weight_x86(desc, src, descTran, dst);
+    }
 #endif
     return ret;
 }
@@ -112,8 +117,9 @@ EE matrix_vector_multiply(TensorDesc matrixDesc,
             mvm_general(matrixRow, matrixColumn, matrixDataType, transpose, matrix, vector, result);
 #endif
 #ifdef _USE_X86
-    } else if (IS_X86_AVX2(arch)) {
-        ret = mvm_x86(matrixRow, matrixColumn, matrixDataType, transpose, matrix, vector, result);
+    } else if (IS_X86(arch)) {
+        ret = mvm_x86(matrixRow, matrixColumn, matrixDataType, matrixDataFormat, matrix, vector,
+            result, arch);
 #endif
 #ifdef _USE_NEON
     } else {
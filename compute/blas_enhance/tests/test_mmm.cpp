@@ -15,13 +15,8 @@
 #include "blas_enhance.h"
 #include "ut_util.h"
 
-int mmmTest(int argc, char **argv, DataType dt)
+int mmmTest(U32 m, U32 k, U32 n, DataType dt)
 {
-    CHECK_REQUIREMENT(argc == 4);
-    U32 m = atoi(argv[1]);
-    U32 k = atoi(argv[2]);
-    U32 n = atoi(argv[3]);
-
     TensorDesc A_desc = tensor2df(dt, DF_TRANSPOSE, k, m);
     TensorDesc B_desc = tensor2df(dt, DF_NORMAL, k, n);
     TensorDesc tranDescB;
@@ -47,6 +42,19 @@ int mmmTest(int argc, char **argv, DataType dt)
 
         // check
         ut_check_v(C, C_ref, m * n, dt, 10, __FILE__, __LINE__);
+#ifdef _USE_X86
+        // the AVX-512 kernels against the AVX2 ones, both read the same packing of B
+        if (IS_X86_AVX512(UT_ARCH)) {
+            U32 avx2Bytes = 0;
+            CHECK_STATUS(matrix_matrix_multiply_tmp_bytes(A_desc, B_desc, &avx2Bytes, X86_AVX2));
+            U8 *avx2Tmp = ut_input_v(avx2Bytes / bytesOf(dt), dt, UT_INIT_ZERO);
+            memset(C_ref, 0, m * n * bytesOf(dt));
+            CHECK_STATUS(matrix_matrix_multiply(A_desc, A, tranDescB, B_tran, avx2Bytes, avx2Tmp,
+                C_desc, C_ref, X86_AVX2));
+            ut_check_v(C, C_ref, m * n, dt, 0.01, __FILE__, __LINE__);
+            free(avx2Tmp);
+        }
+#endif
     }
 
     // benchmark
@@ -75,13 +83,109 @@ int mmmTest(int argc, char **argv, DataType dt)
     return 0;
 }
 
+// batch multiplications of the same shape, B is broadcast to all batches if numB is 1
+int mmmBatchTest(U32 m, U32 k, U32 n, U32 batch, U32 numB, DataType dt)
+{
+    CHECK_REQUIREMENT(numB == 1 || numB == batch);
+    TensorDesc A_desc = tensor2df(dt, DF_NORMAL, m, k);
+    TensorDesc B_desc = tensor2df(dt, DF_NORMAL, k, n);
+    TensorDesc C_desc = tensor2df(dt, DF_NORMAL, m, n);
+    U32 *indexA = (U32 *)malloc(batch * sizeof(U32));
+    U32 *indexB = (U32 *)malloc(batch * sizeof(U32));
+    for (U32 i = 0; i < batch; i++) {
+        indexA[i] = i;
+        indexB[i] = i % numB;
+    }
+
+    U32 bytes = 0, sliceBytes = 0;
+    U8 *A = ut_input_v(batch * m * k, dt, UT_INIT_RANDOM);
+    U8 *B = ut_input_v(numB * k * n, dt, UT_INIT_RANDOM);
+    U8 *C = ut_input_v(batch * m * n, dt, UT_INIT_RANDOM);
+    U8 *C_ref = ut_input_v(batch * m * n, dt, UT_INIT_ZERO);
+    CHECK_STATUS(matrix_matrix_multiply_batch_tmp_bytes(A_desc, B_desc, numB, &bytes, UT_ARCH));
+    CHECK_STATUS(matrix_matrix_multiply_tmp_bytes(A_desc, B_desc, &sliceBytes, UT_ARCH));
+    U8 *tmp = ut_input_v(UNI_MAX(bytes, sliceBytes) / bytesOf(dt) + 1, dt, UT_INIT_ZERO);
+    U32 aBytes = tensorNumBytes(A_desc);
+    U32 bBytes = tensorNumBytes(B_desc);
+    U32 cBytes = tensorNumBytes(C_desc);
+    if (UT_CHECK) {
+        CHECK_STATUS(matrix_matrix_multiply_batch(batch, A_desc, A, indexA, B_desc, B, numB,
+            indexB, bytes, tmp, C_desc, C, UT_ARCH));
+
+        // naive implement
+        for (U32 i = 0; i < batch; i++) {
+            CHECK_STATUS(matrix_matrix_multiply(A_desc, A + i * aBytes, B_desc,
+                B + indexB[i] * bBytes, 0, nullptr, C_desc, C_ref + i * cBytes, CPU_GENERAL));
+        }
+
+        // check
+        ut_check_v(C, C_ref, batch * m * n, dt, 10, __FILE__, __LINE__);
+    }
+
+    // benchmark
+    double time_start = ut_time_ms();
+    for (int iter = 0; iter < UT_LOOPS; iter++) {
+        matrix_matrix_multiply_batch(batch, A_desc, A, indexA, B_desc, B, numB, indexB, bytes, tmp,
+            C_desc, C, UT_ARCH);
+    }
+    double time_end = ut_time_ms();
+    double time = (time_end - time_start) / UT_LOOPS;
+
+    // the multiplications one by one
+    time_start = ut_time_ms();
+    for (int iter = 0; iter < UT_LOOPS; iter++) {
+        memset(C, 0, batch * cBytes);
+        for (U32 i = 0; i < batch; i++) {
+            matrix_matrix_multiply(A_desc, A + i * aBytes, B_desc, B + indexB[i] * bBytes,
+                sliceBytes, tmp, C_desc, C + i * cBytes, UT_ARCH);
+        }
+    }
+    time_end = ut_time_ms();
+    double timeLoop = (time_end - time_start) / UT_LOOPS;
+
+    // log performance data
+    char buffer[150];
+    char params[120];
+    double ops = (2.0 * m * n * k + 1.0 * m * n) * batch;
+    sprintf(params, "%u x (%u %u)+%u x (%u %u)=(%u %u)", batch, m, k, numB, k, n, m, n);
+    sprintf(buffer, "%20s, %80s", "MatrixMultiplyBatch", params);
+    ut_log(dt, buffer, ops, time);
+    sprintf(buffer, "%20s, %80s", "MatrixMultiplyLoop", params);
+    ut_log(dt, buffer, ops, timeLoop);
+
+    free(indexA);
+    free(indexB);
+    free(A);
+    free(B);
+    free(C);
+    free(C_ref);
+    free(tmp);
+
+    return 0;
+}
+
 int main(int argc, char **argv)
 {
+    CHECK_REQUIREMENT(argc == 4 || argc == 6);
+    U32 m = atoi(argv[1]);
+    U32 k = atoi(argv[2]);
+    U32 n = atoi(argv[3]);
+    // test_mmm m k n [batch numB], e.g. 128 64 128 12 12 is the attention score of BERT base
+    U32 batch = (argc == 6) ? atoi(argv[4]) : 0;
+    U32 numB = (argc == 6) ? atoi(argv[5]) : 0;
 #ifdef _USE_FP16
-    mmmTest(argc, argv, DT_F16);
+    if (batch > 0) {
+        mmmBatchTest(m, k, n, batch, numB, DT_F16);
+    } else {
+        mmmTest(m, k, n, DT_F16);
+    }
 #endif
 #ifdef _USE_FP32
-    mmmTest(argc, argv, DT_F32);
+    if (batch > 0) {
+        mmmBatchTest(m, k, n, batch, numB, DT_F32);
+    } else {
+        mmmTest(m, k, n, DT_F32);
+    }
 #endif
     return 0;
 }
@@ -37,7 +37,9 @@ int main(int argc, char **argv)
     }
     INT8 *A = (INT8 *)ut_input_v(m * k, DT_I8, UT_INIT_RANDOM);
     INT8 *B = (INT8 *)ut_input_v(k * n, DT_I8, UT_INIT_RANDOM);
-    INT8 *B_tran = (INT8 *)ut_input_v(k4 * n + 32, DT_I8, UT_INIT_ZERO);
+    // the x86 kernels pad n to a multiple of 32
+    U32 n32 = (n + 31) / 32 * 32;
+    INT8 *B_tran = (INT8 *)ut_input_v(k4 * n32 + 32, DT_I8, UT_INIT_ZERO);
     I32 *C = (I32 *)ut_input_v(m * n, DT_I32, UT_INIT_ZERO);
     I32 *C_ref = (I32 *)ut_input_v(m * n, DT_I32, UT_INIT_ZERO);
     CHECK_STATUS(matrix_matrix_multiply_tmp_bytes(A_desc, B_desc, &bytes, UT_ARCH));
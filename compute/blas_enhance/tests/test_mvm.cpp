@@ -57,6 +57,15 @@ int mvmTest(int argc, char **argv, DataType dt)
             mat_desc, mat, vec_desc, vec, bytes, tmp, res_desc, res_ref, CPU_GENERAL));
 
         ut_check_v(res, res_ref, rc, dt, threshold, __FILE__, __LINE__);
+#ifdef _USE_X86
+        // the AVX-512 kernels against the AVX2 ones
+        if (IS_X86_AVX512(UT_ARCH)) {
+            memset(res_ref, 0, rc * bytesOf(dt));
+            CHECK_STATUS(matrix_vector_multiply(
+                mat_desc, mat, vec_desc, vec, bytes, tmp, res_desc, res_ref, X86_AVX2));
+            ut_check_v(res, res_ref, rc, dt, threshold, __FILE__, __LINE__);
+        }
+#endif
     }
 
     // benchmark
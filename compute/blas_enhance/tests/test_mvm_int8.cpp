@@ -45,7 +45,9 @@ int main(int argc, char **argv)
     }
 
     INT8 *mat = (INT8 *)ut_input_v(m * k, DT_I8, UT_INIT_RANDOM);
-    INT8 *matTran = (INT8 *)ut_input_v(m * k4, DT_I8, UT_INIT_ZERO);
+    // the x86 kernels pad m to a multiple of 32
+    U32 m32 = (m + 31) / 32 * 32;
+    INT8 *matTran = (INT8 *)ut_input_v(m32 * k4, DT_I8, UT_INIT_ZERO);
     INT8 *vec = (INT8 *)ut_input_v(vc, DT_I8, UT_INIT_RANDOM);
     I32 *res = (I32 *)ut_input_v(rc, DT_I32, UT_INIT_ZERO);
     I32 *res_ref = (I32 *)ut_input_v(rc, DT_I32, UT_INIT_ZERO);
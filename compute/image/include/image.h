@@ -35,4 +35,31 @@ EE resize_infer_output_size(Tensor *inputTensor,
     ArchInfo_t archInfo);
 
 EE resize(Tensor inputTensor, Tensor tmpTensor, Tensor outputTensor, ArchInfo_t archInfo);
+
+// Preprocessing of an 8-bit 3-channel image in one pass. The input is DF_NHWC (interleaved) or
+// DF_RGB/DF_NCHW (planar). It is resized to resize_h x resize_w with the bilinear interpolation
+// of resize, and the output window starts at (crop_h, crop_w) of the resized image.
+// Output channel c is (input channel order[c] - mean[c]) * scale[c], the output is DF_NCHW with
+// 3 channels or DF_NCHWC8 with 8 channels, the channels after the 3rd are zero.
+typedef struct {
+    U32 resize_h;
+    U32 resize_w;
+    U32 crop_h;
+    U32 crop_w;
+    U32 order[3];
+    F32 mean[3];
+    F32 scale[3];
+} ImagePreprocessParamSpec;
+
+EE image_preprocess_infer_forward_tmp_bytes(Tensor inputTensor,
+    ImagePreprocessParamSpec p,
+    Tensor outputTensor,
+    U32 *bytes,
+    ArchInfo_t archInfo);
+
+EE image_preprocess(Tensor inputTensor,
+    ImagePreprocessParamSpec p,
+    Tensor tmpTensor,
+    Tensor outputTensor,
+    ArchInfo_t archInfo);
 #endif
@@ -0,0 +1,259 @@
+// Copyright (C) 2019. Huawei Technologies Co., Ltd. All rights reserved.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+#include "thread_affinity.h"
+#include "cpu/image_cpu.h"
+#ifdef _USE_X86
+#include "x86_avx2_expand.h"
+#endif
+
+// The source position of index i of a bilinear resize from in to out, the corners are aligned
+// as in resize_bilinear.
+inline F32 image_source_position(U32 i, U32 in, U32 out)
+{
+    if (out <= 1) {
+        return 0;
+    }
+    F32 stride = (F32)(in - 1) / (F32)(out - 1);
+    return stride * i;
+}
+
+// For output index i of the window starting at start, offset0 and offset1 are the two nearest
+// source indexes multiplied by stride, and alpha is the weight of offset1.
+static void image_coefficients(
+    U32 start, U32 num, U32 in, U32 out, U32 stride, U32 *offset0, U32 *offset1, F32 *alpha)
+{
+    for (U32 i = 0; i < num; i++) {
+        F32 position = image_source_position(start + i, in, out);
+        U32 left = UNI_MIN((U32)floor(position), in - 1);
+        offset0[i] = left * stride;
+        offset1[i] = UNI_MIN(left + 1, in - 1) * stride;
+        alpha[i] = position - left;
+    }
+}
+
+// interpolate the 3 channels of a source row to the planar F32 buffer of 3 * ow elements
+static void image_horizontal(const U8 *row,
+    U32 channelStride,
+    const U32 *offset0,
+    const U32 *offset1,
+    const F32 *alpha,
+    U32 ow,
+    F32 *buffer)
+{
+    for (U32 c = 0; c < 3; c++) {
+        const U8 *src = row + c * channelStride;
+        F32 *dst = buffer + c * ow;
+        for (U32 x = 0; x < ow; x++) {
+            F32 a = alpha[x];
+            dst[x] = src[offset0[x]] * (1 - a) + src[offset1[x]] * a;
+        }
+    }
+}
+
+// interpolate two rows of a channel and normalize
+static void image_vertical(const F32 *top,
+    const F32 *bottom,
+    F32 alpha,
+    F32 mean,
+    F32 scale,
+    U32 ow,
+    F32 *dst,
+    Arch arch)
+{
+    UNUSED(arch);
+    U32 x = 0;
+#ifdef _USE_X86
+    if (IS_X86(arch)) {
+        __m256 a0 = _mm256_set1_ps(1 - alpha);
+        __m256 a1 = _mm256_set1_ps(alpha);
+        __m256 m = _mm256_set1_ps(mean);
+        __m256 s = _mm256_set1_ps(scale);
+        for (; x + 8 <= ow; x += 8) {
+            __m256 v = _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(top + x), a0),
+                _mm256_mul_ps(_mm256_loadu_ps(bottom + x), a1));
+            _mm256_storeu_ps(dst + x, _mm256_mul_ps(_mm256_sub_ps(v, m), s));
+        }
+    }
+#endif
+    for (; x < ow; x++) {
+        dst[x] = (top[x] * (1 - alpha) + bottom[x] * alpha - mean) * scale;
+    }
+}
+
+inline U32 image_thread_bytes(U32 ow)
+{
+    // the two interpolated source rows and the normalized output row
+    return 3 * 3 * ow * sizeof(F32);
+}
+
+template <typename OT>
+static void image_preprocess_kernel(const U8 *input,
+    U32 ih,
+    U32 iw,
+    DataFormat idf,
+    ImagePreprocessParamSpec p,
+    void *tmp,
+    U32 oh,
+    U32 ow,
+    DataFormat odf,
+    OT *output,
+    Arch arch)
+{
+    U32 pixelStride = (idf == DF_NHWC) ? 3 : 1;
+    U32 channelStride = (idf == DF_NHWC) ? 1 : ih * iw;
+    U32 *xoffset0 = (U32 *)tmp;
+    U32 *xoffset1 = xoffset0 + ow;
+    F32 *xalpha = (F32 *)(xoffset1 + ow);
+    U32 *yoffset0 = (U32 *)(xalpha + ow);
+    U32 *yoffset1 = yoffset0 + oh;
+    F32 *yalpha = (F32 *)(yoffset1 + oh);
+    U8 *buffer = (U8 *)(yalpha + oh);
+    image_coefficients(p.crop_w, ow, iw, p.resize_w, pixelStride, xoffset0, xoffset1, xalpha);
+    image_coefficients(p.crop_h, oh, ih, p.resize_h, iw * pixelStride, yoffset0, yoffset1, yalpha);
+
+    int threads = OMP_NUM_THREADS;
+    U32 rows = (oh + threads - 1) / threads;
+#ifdef _USE_OPENMP
+#pragma omp parallel for num_threads(OMP_NUM_THREADS)
+#endif
+    for (int t = 0; t < threads; t++) {
+        F32 *top = (F32 *)(buffer + image_thread_bytes(ow) * t);
+        F32 *bottom = top + 3 * ow;
+        F32 *line = bottom + 3 * ow;
+        // the source rows in top and bottom, consecutive output rows often share them
+        I64 topRow = -1, bottomRow = -1;
+        for (U32 y = t * rows; y < UNI_MIN(oh, (t + 1) * rows); y++) {
+            I64 row0 = yoffset0[y], row1 = yoffset1[y];
+            if (row0 != topRow) {
+                if (row0 == bottomRow) {
+                    std::swap(top, bottom);
+                    std::swap(topRow, bottomRow);
+                } else {
+                    image_horizontal(
+                        input + row0, channelStride, xoffset0, xoffset1, xalpha, ow, top);
+                    topRow = row0;
+                }
+            }
+            if (row1 != bottomRow) {
+                image_horizontal(
+                    input + row1, channelStride, xoffset0, xoffset1, xalpha, ow, bottom);
+                bottomRow = row1;
+            }
+            for (U32 c = 0; c < 3; c++) {
+                F32 *dst = line + c * ow;
+                if (odf == DF_NCHW && sizeof(OT) == sizeof(F32)) {
+                    dst = (F32 *)output + (c * oh + y) * ow;
+                }
+                image_vertical(top + p.order[c] * ow, bottom + p.order[c] * ow, yalpha[y],
+                    p.mean[c], p.scale[c], ow, dst, arch);
+            }
+            if (odf == DF_NCHWC8) {
+                OT *dst = output + y * ow * 8;
+                memset(dst, 0, ow * 8 * sizeof(OT));
+                for (U32 x = 0; x < ow; x++) {
+                    for (U32 c = 0; c < 3; c++) {
+                        dst[x * 8 + c] = line[c * ow + x];
+                    }
+                }
+            } else if (sizeof(OT) != sizeof(F32)) {
+                for (U32 c = 0; c < 3; c++) {
+                    OT *dst = output + (c * oh + y) * ow;
+                    for (U32 x = 0; x < ow; x++) {
+                        dst[x] = line[c * ow + x];
+                    }
+                }
+            }
+        }
+    }
+}
+
+EE image_preprocess_infer_forward_tmp_bytes_cpu(
+    TensorDesc inputDesc, ImagePreprocessParamSpec p, TensorDesc outputDesc, U32 *bytes)
+{
+    UNUSED(inputDesc);
+    UNUSED(p);
+    if (nullptr == bytes) {
+        CHECK_STATUS(NULL_POINTER);
+    }
+    U32 oh = outputDesc.dims[1];
+    U32 ow = outputDesc.dims[0];
+    *bytes = (3 * ow + 3 * oh) * sizeof(F32) + image_thread_bytes(ow) * OMP_NUM_THREADS;
+    return SUCCESS;
+}
+
+EE image_preprocess_cpu(TensorDesc inputDesc,
+    const void *input,
+    ImagePreprocessParamSpec p,
+    U32 tmpBytes,
+    void *tmp,
+    TensorDesc outputDesc,
+    void *output,
+    Arch arch)
+{
+    if (nullptr == input || nullptr == tmp || nullptr == output) {
+        CHECK_STATUS(NULL_POINTER);
+    }
+    DataType idt, odt;
+    DataFormat idf, odf;
+    U32 in, ic, ih, iw;
+    U32 on, oc, oh, ow;
+    CHECK_STATUS(tensor4dGet(inputDesc, &idt, &idf, &in, &ic, &ih, &iw));
+    CHECK_STATUS(tensor4dGet(outputDesc, &odt, &odf, &on, &oc, &oh, &ow));
+    if (idt != DT_U8 || ic != 3 || in != on) {
+        CHECK_STATUS(NOT_MATCH);
+    }
+    if (idf != DF_NHWC && idf != DF_RGB && idf != DF_NCHW) {
+        CHECK_STATUS(NOT_SUPPORTED);
+    }
+    if (!((odf == DF_NCHW && oc == 3) || (odf == DF_NCHWC8 && oc == 8))) {
+        CHECK_STATUS(NOT_SUPPORTED);
+    }
+    if (p.crop_h + oh > p.resize_h || p.crop_w + ow > p.resize_w) {
+        CHECK_STATUS(NOT_MATCH);
+    }
+    for (U32 c = 0; c < 3; c++) {
+        CHECK_REQUIREMENT(p.order[c] < 3);
+    }
+    U32 bytes = 0;
+    CHECK_STATUS(image_preprocess_infer_forward_tmp_bytes_cpu(inputDesc, p, outputDesc, &bytes));
+    CHECK_REQUIREMENT(tmpBytes >= bytes);
+
+    EE ret = SUCCESS;
+    for (U32 n = 0; n < in && ret == SUCCESS; n++) {
+        const U8 *src = (const U8 *)input + n * ic * ih * iw;
+        switch (odt) {
+#ifdef _USE_FP32
+            case DT_F32: {
+                image_preprocess_kernel<F32>(src, ih, iw, idf, p, tmp, oh, ow, odf,
+                    (F32 *)output + n * oc * oh * ow, arch);
+                break;
+            }
+#endif
+#ifdef __aarch64__
+            case DT_F16: {
+                image_preprocess_kernel<F16>(src, ih, iw, idf, p, tmp, oh, ow, odf,
+                    (F16 *)output + n * oc * oh * ow, arch);
+                break;
+            }
+#endif
+            default:
+                ret = NOT_SUPPORTED;
+                break;
+        }
+    }
+    return ret;
+}
@@ -0,0 +1,56 @@
+// Copyright (C) 2019. Huawei Technologies Co., Ltd. All rights reserved.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "image.h"
+#ifdef _USE_CPU
+#include "cpu/image_cpu.h"
+#endif
+
+EE image_preprocess_infer_forward_tmp_bytes(Tensor inputTensor,
+    ImagePreprocessParamSpec p,
+    Tensor outputTensor,
+    U32 *bytes,
+    ArchInfo_t archInfo)
+{
+    TensorDesc inputDesc = inputTensor.get_desc();
+    TensorDesc outputDesc = outputTensor.get_desc();
+    EE ret = NOT_SUPPORTED;
+    if (IS_CPU(archInfo->arch)) {
+#ifdef _USE_CPU
+        ret = image_preprocess_infer_forward_tmp_bytes_cpu(inputDesc, p, outputDesc, bytes);
+#endif
+    }
+    return ret;
+}
+
+EE image_preprocess(Tensor inputTensor,
+    ImagePreprocessParamSpec p,
+    Tensor tmpTensor,
+    Tensor outputTensor,
+    ArchInfo_t archInfo)
+{
+    auto arch = archInfo->arch;
+    TensorDesc inputDesc = inputTensor.get_desc();
+    void *input = get_ptr_from_tensor(inputTensor, arch);
+    U32 tmpBytes = tmpTensor.bytes();
+    void *tmp = get_ptr_from_tensor(tmpTensor, arch);
+    TensorDesc outputDesc = outputTensor.get_desc();
+    void *output = get_ptr_from_tensor(outputTensor, arch);
+    EE ret = NOT_SUPPORTED;
+    if (IS_CPU(arch)) {
+#ifdef _USE_CPU
+        ret = image_preprocess_cpu(inputDesc, input, p, tmpBytes, tmp, outputDesc, output, arch);
+#endif
+    }
+    return ret;
+}
@@ -19,159 +19,105 @@
 #include "tensor.hpp"
 #include "types.h"
 #include "error.h"
+#include "thread_affinity.h"
+
+// the mean and the standard deviation of the RGB channels of ImageNet, in [0, 255] and [0, 1]
+static const F32 imagenetMean[3] = {122.6789143406786, 116.66876761696767, 104.0069879317889};
+static const F32 imagenetMeanSC[3] = {0.485, 0.456, 0.406};
+static const F32 imagenetStdSC[3] = {0.229, 0.224, 0.225};
 
-template <typename T>
 std::shared_ptr<Tensor> get_resize_image(
     Tensor rgbTensor, TensorDesc imageDesc, ImageFormat targetImageFormat, float scaleValue)
 {
     ArchInfo archInfo;
-    auto arch = CPU_GENERAL;
-    archInfo.arch = arch;
-    DataType rgbDt = DT_F16, imageDt = DT_F16;
-    DataFormat rgbDf = DF_RGB, imageDf = DF_RGB;
+#ifdef _USE_X86
+    archInfo.arch = get_x86_cpu_arch();
+#else
+    archInfo.arch = CPU_GENERAL;
+#endif
+    DataType rgbDt = DT_U8, imageDt = DT_F32;
+    DataFormat rgbDf = DF_RGB, imageDf = DF_NCHW;
     U32 rgbNum = 0, rgbChannel = 0, rgbHeight = 0, rgbWidth = 0;
     U32 imageNum = 0, imageChannel = 0, imageHeight = 0, imageWidth = 0;
     TensorDesc rgbDesc = rgbTensor.get_desc();
     CHECK_STATUS(tensor4dGet(rgbDesc, &rgbDt, &rgbDf, &rgbNum, &rgbChannel, &rgbHeight, &rgbWidth));
-    CHECK_REQUIREMENT(rgbDf == DF_RGB);
+    CHECK_REQUIREMENT(rgbDf == DF_RGB || rgbDf == DF_NHWC);
     CHECK_REQUIREMENT(rgbChannel == 3);
     CHECK_REQUIREMENT(rgbNum == 1);
 
     CHECK_STATUS(tensor4dGet(
         imageDesc, &imageDt, &imageDf, &imageNum, &imageChannel, &imageHeight, &imageWidth));
-    CHECK_REQUIREMENT(imageDf == DF_NCHW);
+    CHECK_REQUIREMENT(imageDf == DF_NCHW || imageDf == DF_NCHWC8);
     CHECK_REQUIREMENT(imageNum == 1);
 
-    U32 height = rgbHeight;
-    U32 width = rgbWidth;
-
-    Tensor temp;
-    std::shared_ptr<Tensor> transferSpaceTensor(new Tensor());
-    transferSpaceTensor->resize(imageDesc);
-    transferSpaceTensor->alloc();
-    T *transferSpacePtrMov = (T *)get_ptr_from_tensor(*transferSpaceTensor, arch);
-
-    // magic number
-    float meanRGB[3] = {122.6789143406786, 116.66876761696767, 104.0069879317889};
-    float meanRGBSC[3] = {0.485, 0.456, 0.406};
-    float stdRGBSC[3] = {0.229, 0.224, 0.225};
-
-    U32 transform[3];
+    ImagePreprocessParamSpec p;
+    p.resize_h = imageHeight;
+    p.resize_w = imageWidth;
+    p.crop_h = 0;
+    p.crop_w = 0;
     switch (targetImageFormat) {
         case RGB:
-            transform[0] = 0;
-            transform[1] = 1;
-            transform[2] = 2;
-            break;
-        case BGR:
-            transform[0] = 2;
-            transform[1] = 1;
-            transform[2] = 0;
-            break;
-        case BGR_SC_RAW:
-            transform[0] = 2;
-            transform[1] = 1;
-            transform[2] = 0;
-            break;
         case RGB_SC:
-            transform[0] = 0;
-            transform[1] = 1;
-            transform[2] = 2;
-            break;
         case RGB_RAW:
-            transform[0] = 0;
-            transform[1] = 1;
-            transform[2] = 2;
-            break;
         case RGB_SC_RAW:
-            transform[0] = 0;
-            transform[1] = 1;
-            transform[2] = 2;
+            p.order[0] = 0;
+            p.order[1] = 1;
+            p.order[2] = 2;
+            break;
+        case BGR:
+        case BGR_SC_RAW:
+            p.order[0] = 2;
+            p.order[1] = 1;
+            p.order[2] = 0;
             break;
         default:
             UNI_ERROR_LOG("[ERROR] unsupported image format\n");
             return nullptr;
     }
+    for (U32 c = 0; c < 3; c++) {
+        p.mean[c] = 0;
+        p.scale[c] = 1;
+    }
 
     // consider the dataformat
-    if (targetImageFormat == RGB_SC) {  // Specific for Birealnet18, scale short edge to 224 first
-        F32 scale = 224.0 / UNI_MIN(height, width);
-        if (height < width) {
-            height = 224;
-            width = (U32)(scale * width + 0.5);
+    if (targetImageFormat == RGB_SC || targetImageFormat == RGB_SC_RAW ||
+        targetImageFormat == BGR_SC_RAW) {
+        // scale the short edge to 224 (Birealnet18) or 256 first, and crop the center
+        U32 shortEdge = (targetImageFormat == RGB_SC) ? 224 : 256;
+        F32 scale = (F32)shortEdge / UNI_MIN(rgbHeight, rgbWidth);
+        if (rgbHeight < rgbWidth) {
+            p.resize_h = shortEdge;
+            p.resize_w = (U32)(scale * (F32)rgbWidth + 0.5);
         } else {
-            height = (U32)(scale * height + 0.5);
-            width = 224;
+            p.resize_h = (U32)(scale * (F32)rgbHeight + 0.5);
+            p.resize_w = shortEdge;
         }
-        Tensor scaleTensor;
-        TensorDesc scaledDesc = tensor4df(imageDt, imageDf, imageNum, imageChannel, height, width);
-        scaleTensor.resize(scaledDesc);
-        scaleTensor.alloc();
-        resize(rgbTensor, temp, scaleTensor, &archInfo);
-
-        U32 h0 = (U32)((height - 224) * 0.5);
-        U32 w0 = (U32)((width - 224) * 0.5);
-
-        T *scaled = (T *)get_ptr_from_tensor(scaleTensor, arch);
-        for (U32 c : transform) {
-            for (U32 h = h0; h < h0 + imageHeight; h++) {
-                for (U32 w = w0; w < w0 + imageWidth; w++) {
-                    T value = (scaled[c * height * width + h * width + w] / 255 - meanRGBSC[c]) /
-                        stdRGBSC[c];
-                    CHECK_REQUIREMENT(!UNI_ISNAN(value));
-                    *transferSpacePtrMov = value;
-                    transferSpacePtrMov++;
-                }
-            }
-        }
-    } else if (targetImageFormat == RGB_RAW) {
-        resize(rgbTensor, temp, *transferSpaceTensor.get(), &archInfo);
-    } else if (targetImageFormat == RGB_SC_RAW || targetImageFormat == BGR_SC_RAW) {
-        F32 scale = 256.0 / UNI_MIN(height, width);
-        if (height < width) {
-            height = 256;
-            width = (U32)(scale * (F32)width + 0.5);
-        } else {
-            height = (U32)(scale * (F32)height + 0.5);
-            width = 256;
-        }
-        Tensor scaleTensor;
-        TensorDesc scaledDesc = tensor4df(imageDt, imageDf, imageNum, imageChannel, height, width);
-        scaleTensor.resize(scaledDesc);
-        scaleTensor.alloc();
-        resize(rgbTensor, temp, scaleTensor, &archInfo);
-
-        U32 h0 = (U32)((height - 224) * 0.5);
-        U32 w0 = (U32)((width - 224) * 0.5);
-
-        T *scaled = (T *)get_ptr_from_tensor(scaleTensor, arch);
-        for (U32 c : transform) {
-            for (U32 h = h0; h < h0 + 224; h++) {
-                memcpy(transferSpacePtrMov, scaled + c * height * width + h * width + w0,
-                    224 * bytesOf(imageDt));
-                transferSpacePtrMov += 224;
-            }
+        p.crop_h = (U32)((p.resize_h - 224) * 0.5);
+        p.crop_w = (U32)((p.resize_w - 224) * 0.5);
+    }
+    if (targetImageFormat == RGB_SC) {
+        // (x / 255 - mean) / std
+        for (U32 c = 0; c < 3; c++) {
+            p.mean[c] = imagenetMeanSC[p.order[c]] * 255;
+            p.scale[c] = 1 / (imagenetStdSC[p.order[c]] * 255);
         }
-    } else {
-        Tensor scaleTensor;
-        scaleTensor.resize(imageDesc);
-        scaleTensor.alloc();
-        resize(rgbTensor, temp, scaleTensor, &archInfo);
-
-        T *resized = (T *)get_ptr_from_tensor(scaleTensor, arch);
-        for (U32 c : transform) {
-            for (U32 h = 0; h < imageHeight; h++) {
-                for (U32 w = 0; w < imageWidth; w++) {
-                    T value = (resized[c * imageHeight * imageWidth + h * imageWidth + w] -
-                                  1.0 * meanRGB[c]) *
-                        scaleValue;
-                    CHECK_REQUIREMENT(!UNI_ISNAN(value));
-                    *transferSpacePtrMov = value;
-                    transferSpacePtrMov++;
-                }
-            }
+    } else if (targetImageFormat == RGB || targetImageFormat == BGR) {
+        for (U32 c = 0; c < 3; c++) {
+            p.mean[c] = imagenetMean[p.order[c]];
+            p.scale[c] = scaleValue;
         }
     }
+
+    std::shared_ptr<Tensor> transferSpaceTensor(new Tensor());
+    transferSpaceTensor->resize(imageDesc);
+    transferSpaceTensor->alloc();
+    U32 bytes = 0;
+    CHECK_STATUS(image_preprocess_infer_forward_tmp_bytes(
+        rgbTensor, p, *transferSpaceTensor, &bytes, &archInfo));
+    Tensor tmpTensor;
+    tmpTensor.resize(tensor1d(DT_U8, bytes));
+    tmpTensor.alloc();
+    CHECK_STATUS(image_preprocess(rgbTensor, p, tmpTensor, *transferSpaceTensor, &archInfo));
     return transferSpaceTensor;
 }
 
@@ -195,15 +141,12 @@ std::shared_ptr<Tensor> load_resize_image(
 
     switch (imageDt) {
 #ifdef __aarch64__
-        case DT_F16: {
-            return get_resize_image<F16>(rgbTensor, imageDesc, targetImageFormat, scaleValue);
-        }
+        case DT_F16:
 #endif
 #ifdef _USE_FP32
-        case DT_F32: {
-            return get_resize_image<F32>(rgbTensor, imageDesc, targetImageFormat, scaleValue);
-        }
+        case DT_F32:
 #endif
+            return get_resize_image(rgbTensor, imageDesc, targetImageFormat, scaleValue);
         default: {
             CHECK_STATUS(NOT_SUPPORTED);
             return nullptr;
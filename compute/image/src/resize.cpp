@@ -134,7 +134,7 @@ EE resize(Tensor inputTensor, Tensor tmpTensor, Tensor outputTensor, ArchInfo_t
     }
     EE ret = NOT_SUPPORTED;
 
-    if (IS_GENERAL(arch) || IS_X86_AVX2(arch)) {
+    if (IS_GENERAL(arch) || IS_X86(arch)) {
 #if defined(_USE_GENERAL) || defined(_USE_X86)
         ret = resize_bilinear_general(inputDesc, input, outputDesc, output);
 #endif
@@ -0,0 +1,160 @@
+// Copyright (C) 2019. Huawei Technologies Co., Ltd. All rights reserved.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include <vector>
+
+#include "image.h"
+#include "ut_util.h"
+
+// the multi-pass reference: deinterleave, resize, then crop and normalize
+static void image_preprocess_reference(Tensor rgbTensor,
+    ImagePreprocessParamSpec p,
+    Tensor planarTensor,
+    Tensor resizedTensor,
+    Tensor outputTensor)
+{
+    ArchInfo archInfo;
+    archInfo.arch = CPU_GENERAL;
+    TensorDesc rgbDesc = rgbTensor.get_desc();
+    U32 ih = rgbDesc.dims[1], iw = rgbDesc.dims[0];
+    U8 *rgb = (U8 *)get_ptr_from_tensor(rgbTensor, CPU_GENERAL);
+    U8 *planar = (U8 *)get_ptr_from_tensor(planarTensor, CPU_GENERAL);
+    for (U32 i = 0; i < ih * iw; i++) {
+        for (U32 c = 0; c < 3; c++) {
+            planar[c * ih * iw + i] = rgb[i * 3 + c];
+        }
+    }
+    Tensor tmpTensor;
+    CHECK_STATUS(resize(planarTensor, tmpTensor, resizedTensor, &archInfo));
+    F32 *resized = (F32 *)get_ptr_from_tensor(resizedTensor, CPU_GENERAL);
+    F32 *output = (F32 *)get_ptr_from_tensor(outputTensor, CPU_GENERAL);
+    TensorDesc outputDesc = outputTensor.get_desc();
+    U32 oh = outputDesc.dims[1], ow = outputDesc.dims[0];
+    for (U32 c = 0; c < 3; c++) {
+        for (U32 h = 0; h < oh; h++) {
+            for (U32 w = 0; w < ow; w++) {
+                F32 value = resized[(p.order[c] * p.resize_h + p.crop_h + h) * p.resize_w +
+                    p.crop_w + w];
+                *output++ = (value - p.mean[c]) * p.scale[c];
+            }
+        }
+    }
+}
+
+int imagePreprocessTest(U32 ih, U32 iw, U32 resizeH, U32 resizeW, U32 oh, U32 ow)
+{
+    ArchInfo archInfo;
+    archInfo.arch = UT_ARCH;
+    ArchInfo archInfo_org;
+    archInfo_org.arch = CPU_GENERAL;
+
+    ImagePreprocessParamSpec p;
+    p.resize_h = resizeH;
+    p.resize_w = resizeW;
+    p.crop_h = (resizeH - oh) / 2;
+    p.crop_w = (resizeW - ow) / 2;
+    // BGR
+    F32 mean[3] = {104.0, 116.7, 122.7};
+    for (U32 c = 0; c < 3; c++) {
+        p.order[c] = 2 - c;
+        p.mean[c] = mean[c];
+        p.scale[c] = 0.017;
+    }
+
+    TensorDesc rgbDesc = tensor4df(DT_U8, DF_NHWC, 1, 3, ih, iw);
+    Tensor rgbTensor = Tensor::alloc_sized<CPUMem>(rgbDesc);
+    U8 *rgb = (U8 *)get_ptr_from_tensor(rgbTensor, UT_ARCH);
+    for (U32 i = 0; i < tensorNumElements(rgbDesc); i++) {
+        rgb[i] = rand() % 256;
+    }
+    TensorDesc outputDesc = tensor4df(DT_F32, DF_NCHW, 1, 3, oh, ow);
+    Tensor outputTensor = Tensor::alloc_sized<CPUMem>(outputDesc);
+    Tensor outputTensorRef = Tensor::alloc_sized<CPUMem>(outputDesc);
+    TensorDesc outputDescC8 = tensor4df(DT_F32, DF_NCHWC8, 1, 8, oh, ow);
+    Tensor outputTensorC8 = Tensor::alloc_sized<CPUMem>(outputDescC8);
+    U32 bytes = 0;
+    CHECK_STATUS(
+        image_preprocess_infer_forward_tmp_bytes(rgbTensor, p, outputTensorC8, &bytes, &archInfo));
+    Tensor tmpTensor = Tensor::alloc_sized<CPUMem>(tensor1d(DT_U8, bytes));
+
+    Tensor planarTensor = Tensor::alloc_sized<CPUMem>(tensor4df(DT_U8, DF_RGB, 1, 3, ih, iw));
+    Tensor resizedTensor =
+        Tensor::alloc_sized<CPUMem>(tensor4df(DT_F32, DF_NCHW, 1, 3, resizeH, resizeW));
+    U32 len = tensorNumElements(outputDesc);
+    if (UT_CHECK) {
+        CHECK_STATUS(image_preprocess(rgbTensor, p, tmpTensor, outputTensor, &archInfo));
+        image_preprocess_reference(rgbTensor, p, planarTensor, resizedTensor, outputTensorRef);
+        ut_check_v(get_ptr_from_tensor(outputTensor, UT_ARCH),
+            get_ptr_from_tensor(outputTensorRef, UT_ARCH), len, DT_F32, 0.001, __FILE__, __LINE__);
+
+        CHECK_STATUS(image_preprocess(rgbTensor, p, tmpTensor, outputTensorRef, &archInfo_org));
+        ut_check_v(get_ptr_from_tensor(outputTensor, UT_ARCH),
+            get_ptr_from_tensor(outputTensorRef, UT_ARCH), len, DT_F32, 0.001, __FILE__, __LINE__);
+
+        CHECK_STATUS(image_preprocess(rgbTensor, p, tmpTensor, outputTensorC8, &archInfo));
+        CHECK_STATUS(transformToNCHW(outputDescC8, get_ptr_from_tensor(outputTensorC8, UT_ARCH),
+            outputDesc, get_ptr_from_tensor(outputTensorRef, UT_ARCH)));
+        ut_check_v(get_ptr_from_tensor(outputTensor, UT_ARCH),
+            get_ptr_from_tensor(outputTensorRef, UT_ARCH), len, DT_F32, 0, __FILE__, __LINE__);
+    }
+
+    double time_start = ut_time_ms();
+    for (int iter = 0; iter < UT_LOOPS; iter++) {
+        CHECK_STATUS(image_preprocess(rgbTensor, p, tmpTensor, outputTensor, &archInfo));
+    }
+    double time_end = ut_time_ms();
+    double time = (time_end - time_start) / UT_LOOPS;
+
+    // the multi-pass reference, to show the gain
+    time_start = ut_time_ms();
+    for (int iter = 0; iter < UT_LOOPS; iter++) {
+        image_preprocess_reference(rgbTensor, p, planarTensor, resizedTensor, outputTensorRef);
+    }
+    time_end = ut_time_ms();
+    double timeRef = (time_end - time_start) / UT_LOOPS;
+
+    // log performance data
+    char buffer[150];
+    char params[120];
+    sprintf(params, "(%u %u)->(%u %u)->(%u %u)", ih, iw, resizeH, resizeW, oh, ow);
+    sprintf(buffer, "%20s, %80s", "ImagePreprocess", params);
+    double ops = 3.0 * oh * ow * 8;
+    ut_log(DT_F32, buffer, ops, time);
+    sprintf(buffer, "%20s, %80s", "ImagePreprocess(ref)", params);
+    ut_log(DT_F32, buffer, ops, timeRef);
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc == 1) {
+        // the resize and center crop of ImageNet classification
+        std::vector<std::vector<U32>> cases = {
+            {1280, 960, 224, 224, 224, 224},
+            {1280, 960, 298, 224, 224, 224},
+            {480, 640, 256, 341, 224, 224},
+            {1080, 1920, 256, 455, 224, 224},
+            {128, 96, 320, 240, 299, 224},
+        };
+        for (auto c : cases) {
+            imagePreprocessTest(c[0], c[1], c[2], c[3], c[4], c[5]);
+        }
+        return 0;
+    }
+    CHECK_REQUIREMENT(argc == 7);
+    U32 dims[6];
+    for (int i = 0; i < 6; i++) {
+        dims[i] = atoi(argv[i + 1]);
+    }
+    return imagePreprocessTest(dims[0], dims[1], dims[2], dims[3], dims[4], dims[5]);
+}
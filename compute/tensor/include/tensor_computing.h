@@ -37,6 +37,18 @@ EE convolution_infer_forward_algorithm(Tensor inputTensor,
     ActivationParamSpec activationDesc,
     ArchInfo_t archInfo);
 
+// time the algorithms that support the convolution on this machine and choose the fastest one,
+// time is its latency in ms, or 0 if there is only one algorithm and nothing was measured
+EE convolution_tune_forward_algorithm(Tensor inputTensor,
+    Tensor filterTensor,
+    Tensor outputTensor,
+    ConvolutionParamSpec convParamSpec,
+    ConvolutionForwardAlgorithm *algorithm,
+    F32 *time,
+    DataType targetDataType,
+    ActivationParamSpec activationDesc,
+    ArchInfo_t archInfo);
+
 EE convolution_transform_filter_bytes(Tensor filterTensor,
     ConvolutionParamSpec convParamSpec,
     ConvolutionForwardAlgorithm algorithm,
@@ -69,6 +81,20 @@ EE convolution(Tensor inputTensor,
     ActivationParamSpec activationDesc,
     ArchInfo_t archInfo);
 
+// output = activation(convolution(input) + residual). The residual has the layout of the output,
+// and the x86 direct kernels add it to each output block while the block is in the cache.
+EE convolution_with_epilogue(Tensor inputTensor,
+    Tensor filterTensor,
+    ConvolutionParamSpec convParamSpec,
+    ConvolutionForwardAlgorithm algorithm,
+    void *scale,
+    Tensor biasTensor,
+    Tensor tmpTensor,
+    Tensor outputTensor,
+    Tensor *residualTensor,
+    ActivationParamSpec activationDesc,
+    ArchInfo_t archInfo);
+
 EE deconvolution_infer_output_size(Tensor *inputTensor,
     Tensor filterTensor,
     ConvolutionParamSpec convParamSpec,
@@ -228,8 +254,14 @@ EE detectionoutput_infer_output_size(std::vector<Tensor *> inputTensor,
     Tensor *outputTensor,
     ArchInfo_t archInfo);
 
+EE detectionoutput_infer_forward_tmp_bytes(std::vector<Tensor> inputTensor,
+    DetectionOutputParamSpec detectionOutputParamSpec,
+    U32 *bytes,
+    ArchInfo_t archInfo);
+
 EE detectionoutput(std::vector<Tensor> inputTensor,
     DetectionOutputParamSpec detectionOutputParamSpec,
+    Tensor tmpTensor,
     Tensor outputTensor,
     ArchInfo_t archInfo);
 
@@ -313,6 +345,17 @@ EE fully_connected(Tensor inputTensor,
     Tensor outputTensor,
     ArchInfo_t archInfo);
 
+// output = activation(fully_connected(input) + residual), the residual has the shape of the
+// output and is added to each block of the matrix multiplication while it is in the cache
+EE fully_connected_with_epilogue(Tensor inputTensor,
+    Tensor filterTensor,
+    Tensor biasTensor,
+    Tensor tmpTensor,
+    Tensor outputTensor,
+    Tensor *residualTensor,
+    ActivationParamSpec activationDesc,
+    ArchInfo_t archInfo);
+
 EE softmax_infer_output_size(Tensor *inputTensor, Tensor *outputTensor, ArchInfo_t archInfo);
 
 EE softmax(Tensor inputTensor,
@@ -563,6 +606,19 @@ EE attention_mask(
 
 EE attention_mask_infer_output_size(Tensor *inputTensor, Tensor *outputTensor);
 
+// inputTensors are Q, K, V and an optional additive mask that is broadcast to the scores
+EE scaled_dot_product_attention_infer_output_size(
+    std::vector<Tensor *> inputTensors, Tensor *outputTensor, ArchInfo_t archInfo);
+
+EE scaled_dot_product_attention_infer_forward_tmp_bytes(
+    std::vector<Tensor> inputTensors, U32 *bytes, ArchInfo_t archInfo);
+
+EE scaled_dot_product_attention(std::vector<Tensor> inputTensors,
+    ScaledDotProductAttentionParamSpec p,
+    Tensor tmpTensor,
+    Tensor outputTensor,
+    ArchInfo_t archInfo);
+
 EE padding_infer_output_size(
     Tensor *inputTensor, PadParamSpec padParamSpec, Tensor *outputTensor, ArchInfo_t archInfo);
 
@@ -585,8 +641,15 @@ EE yolov3detectionoutput_infer_output_size(std::vector<Tensor *> inputTensor,
     Tensor *outputTensor,
     ArchInfo_t archInfo);
 
+EE yolov3detectionoutput_infer_forward_tmp_bytes(std::vector<Tensor> inputTensor,
+    Yolov3DetectionOutputParamSpec yolov3DetectionOutputParamSpec,
+    Tensor outputTensor,
+    U32 *bytes,
+    ArchInfo_t archInfo);
+
 EE yolov3detectionoutput(std::vector<Tensor> inputTensor,
     Yolov3DetectionOutputParamSpec yolov3DetectionOutputParamSpec,
+    Tensor tmpTensor,
     Tensor outputTensor,
     ArchInfo_t archInfo);
 
@@ -609,8 +672,12 @@ EE non_max_suppression_infer_output_size(std::vector<Tensor *> inputTensor,
     Tensor *outputTensor,
     ArchInfo_t archInfo);
 
+EE non_max_suppression_infer_forward_tmp_bytes(
+    std::vector<Tensor> inputTensor, NonMaxSuppressionParamSpec p, U32 *bytes, ArchInfo_t archInfo);
+
 EE non_max_suppression(std::vector<Tensor> inputTensor,
     NonMaxSuppressionParamSpec p,
+    Tensor tmpTensor,
     Tensor outputTensor,
     ArchInfo_t archInfo);
 
@@ -692,11 +759,26 @@ void dequantize_int32_to_fp16(
     U32 len, I32 *q, F32 scale, F16 *d, U32 biasLen = 0, F16 *biasPtr = nullptr);
 #endif
 
+#ifdef _USE_INT8
+void dequantize_int8_to_fp32(U32 len, INT8 *q, F32 scale, F32 *d);
+
+void dequantize_int32_to_fp32(
+    U32 len, I32 *q, F32 scale, F32 *d, U32 biasLen = 0, F32 *biasPtr = nullptr);
+#endif
+
 #ifdef _USE_FP16
 void update_histogram(U32 len, const F16 *data, int numBins, F32 interval, F32 *histo);
 #endif
 
 std::vector<F32> compress_histogram(std::vector<F32> &histogram, F32 numPerBin, F32 last_max);
 
+// The histograms count the absolute values of a tensor in bins of the same interval. KL chooses
+// the threshold whose 128 levels keep the distribution, percentile the threshold that covers the
+// given ratio of values, and MSE the threshold with the least clipping and rounding error.
 std::vector<F32> compute_scale_with_KL(std::vector<F32> &histogram, F32 interval);
+
+std::vector<F32> compute_scale_with_percentile(
+    std::vector<F32> &histogram, F32 interval, F32 percentile);
+
+std::vector<F32> compute_scale_with_MSE(std::vector<F32> &histogram, F32 interval);
 #endif
@@ -33,7 +33,7 @@ EE attention(Tensor inputTensor, Tensor outputTensor, ArchInfo_t archInfo)
         ret = attention_general(inputDesc, input, outputDesc, output);
 #endif
 #ifdef _USE_X86
-    } else if (IS_X86_AVX2(arch)) {
+    } else if (IS_X86(arch)) {
         UNI_WARNING_LOG("The x86 attention operator is not optimized now.\n");
         ret = attention_general(inputDesc, input, outputDesc, output);
 #endif
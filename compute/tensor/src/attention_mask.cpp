@@ -41,7 +41,7 @@ EE attention_mask(
         ret = attention_mask_general(inputDesc, input, p, outputDesc, output);
 #endif
 #ifdef _USE_X86
-    } else if (IS_X86_AVX2(arch)) {
+    } else if (IS_X86(arch)) {
         ret = attention_mask_x86(inputDesc, input, p, outputDesc, output);
 #endif
 #ifdef _USE_NEON
@@ -44,7 +44,7 @@ EE check(Tensor inputTensorA,
         ret = check_general(inputDescA, inputA, inputDescB, inputB, p, outputDesc, output);
 #endif
 #ifdef _USE_X86
-    } else if (IS_X86_AVX2(arch)) {
+    } else if (IS_X86(arch)) {
         ret = check_x86(inputDescA, inputA, inputDescB, inputB, p, outputDesc, output);
 #endif
 #ifdef _USE_NEON
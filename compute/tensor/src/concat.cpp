@@ -55,7 +55,7 @@ inline EE concat_infer_output_size_cpu(
         return SUCCESS;
     }
 
-    bool hasC8 = false;
+    bool hasC8 = (inputDesc[0].df == DF_NCHWC8);
     for (U32 i = 1; i < inputDesc.size(); i++) {
         if (inputDesc[i].nDims != 0) {
             *outputDesc = inputDesc[i];
@@ -92,7 +92,8 @@ inline EE concat_infer_output_size_cpu(
         }
     }
 
-    if ((outputDesc->dims[3] % 8 == 0) && hasC8) {
+    // the output stays in NCHWC8 if any input is, the others are transformed once
+    if (hasC8 && dim >= 4 && (outputDesc->dims[dim - 2] % 8 == 0)) {
         outputDesc->df = DF_NCHWC8;
     }
 
@@ -12,6 +12,9 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include "tensor_computing.h"
+#if defined(_USE_GENERAL) || defined(_USE_X86) || defined(_USE_NEON)
+#include "cpu/tensor_computing_cpu.h"
+#endif
 #ifdef _USE_GENERAL
 #include "cpu/general/tensor_computing_general.h"
 #endif
@@ -127,7 +130,7 @@ EE convolution_infer_forward_algorithm(Tensor inputTensor,
         ret = SUCCESS;
 #endif
 #ifdef _USE_X86
-    } else if (IS_X86_AVX2(arch)) {
+    } else if (IS_X86(arch)) {
         ret = convolution_infer_forward_algorithm_x86(
             inputDesc, filterDesc, outputDesc, convParamSpec, policy, algorithm, targetDataType);
 #endif
@@ -148,6 +151,37 @@ EE convolution_infer_forward_algorithm(Tensor inputTensor,
     return ret;
 }
 
+EE convolution_tune_forward_algorithm(Tensor inputTensor,
+    Tensor filterTensor,
+    Tensor outputTensor,
+    ConvolutionParamSpec convParamSpec,
+    ConvolutionForwardAlgorithm *algorithm,
+    F32 *time,
+    DataType targetDataType,
+    ActivationParamSpec activationDesc,
+    ArchInfo_t archInfo)
+{
+    if (nullptr == algorithm || nullptr == time) {
+        CHECK_STATUS(NULL_POINTER);
+    }
+    *time = 0;
+    EE ret = NOT_SUPPORTED;
+    auto arch = archInfo->arch;
+#ifdef _USE_X86
+    if (IS_X86(arch)) {
+        ret = convolution_tune_forward_algorithm_x86(inputTensor.get_desc(),
+            filterTensor.get_desc(), outputTensor.get_desc(), convParamSpec, targetDataType,
+            activationDesc, algorithm, time, arch);
+        return ret;
+    }
+#endif
+    // the other architectures have no measured tuning on the CPU, MALI tunes by itself
+    ConvolutionPolicy policy = IS_MALI_GPU(arch) ? CONVOLUTION_TUNNING : CONVOLUTION_FASTEST;
+    ret = convolution_infer_forward_algorithm(inputTensor, filterTensor, outputTensor,
+        convParamSpec, policy, algorithm, targetDataType, activationDesc, archInfo);
+    return ret;
+}
+
 EE convolution_transform_filter_bytes(Tensor filterTensor,
     ConvolutionParamSpec convParamSpec,
     ConvolutionForwardAlgorithm algorithm,
@@ -164,7 +198,7 @@ EE convolution_transform_filter_bytes(Tensor filterTensor,
         ret = SUCCESS;
 #endif
 #ifdef _USE_X86
-    } else if (IS_X86_AVX2(arch)) {
+    } else if (IS_X86(arch)) {
         ret = convolution_transform_filter_bytes_x86(filterDesc, convParamSpec, algorithm, bytes);
 #endif
 #ifdef _USE_NEON
@@ -202,7 +236,7 @@ EE convolution_transform_filter(Tensor filterTensor,
         ret = SUCCESS;
 #endif
 #ifdef _USE_X86
-    } else if (IS_X86_AVX2(arch)) {
+    } else if (IS_X86(arch)) {
         ret = convolution_transform_filter_x86(
             filterDesc, filter, convParamSpec, algorithm, &ftmDesc, filterTransformed);
 #endif
@@ -242,7 +276,7 @@ EE convolution_infer_forward_tmp_bytes(Tensor inputTensor,
         ret = SUCCESS;
 #endif
 #ifdef _USE_X86
-    } else if (IS_X86_AVX2(arch)) {
+    } else if (IS_X86(arch)) {
         ret = convolution_infer_forward_tmp_bytes_x86(
             inputDesc, filterDesc, outputDesc, convParamSpec, algorithm, bytes);
 #endif
@@ -280,6 +314,22 @@ EE convolution(Tensor inputTensor,
     Tensor outputTensor,
     ActivationParamSpec activationDesc,
     ArchInfo_t archInfo)
+{
+    return convolution_with_epilogue(inputTensor, filterTensor, convParamSpec, algorithm, scale,
+        biasTensor, tmpTensor, outputTensor, nullptr, activationDesc, archInfo);
+}
+
+EE convolution_with_epilogue(Tensor inputTensor,
+    Tensor filterTensor,
+    ConvolutionParamSpec convParamSpec,
+    ConvolutionForwardAlgorithm algorithm,
+    void *scale,
+    Tensor biasTensor,
+    Tensor tmpTensor,
+    Tensor outputTensor,
+    Tensor *residualTensor,
+    ActivationParamSpec activationDesc,
+    ArchInfo_t archInfo)
 {
     auto arch = archInfo->arch;
     TensorDesc inputDesc = inputTensor.get_desc();
@@ -297,6 +347,18 @@ EE convolution(Tensor inputTensor,
     TensorDesc outputDesc = outputTensor.get_desc();
     void *output = get_ptr_from_tensor(outputTensor, arch);
     TensorDesc scaleDesc = filterDesc;
+    void *residual = nullptr;
+    if (residualTensor != nullptr) {
+        if (tensorNumElements(residualTensor->get_desc()) != tensorNumElements(outputDesc)) {
+            return NOT_MATCH;
+        }
+        residual = get_ptr_from_tensor(*residualTensor, arch);
+    }
+    // only the x86 kernels add the residual, the others activate after it is added
+    ActivationParamSpec kernelActivationDesc = activationDesc;
+    if (residual != nullptr && !IS_X86(arch)) {
+        kernelActivationDesc.mode = ACTIVATION_NULL;
+    }
 
     EE ret = NOT_SUPPORTED;
 #ifdef _USE_FP16
@@ -313,22 +375,25 @@ EE convolution(Tensor inputTensor,
     if (IS_GENERAL(arch)) {
 #ifdef _USE_GENERAL
         ret = convolution_general(inputDesc, input, filterDesc, filter, convParamSpec, scaleDesc,
-            scale, biasDesc, bias, outputDesc, output, activationDesc);
+            scale, biasDesc, bias, outputDesc, output, kernelActivationDesc);
 #endif
 #ifdef _USE_X86
-    } else if (IS_X86_AVX2(arch)) {
+    } else if (IS_X86(arch)) {
         ret = convolution_x86(inputDesc, input, filterDesc, filter, convParamSpec, algorithm,
-            scaleDesc, scale, biasDesc, bias, tmpBytes, tmp, outputDesc, output, activationDesc,
-            archInfo->arch);
+            scaleDesc, scale, biasDesc, bias, tmpBytes, tmp, outputDesc, output, residual,
+            activationDesc, archInfo->arch);
 #endif
 #ifdef _USE_NEON
     } else if (IS_ARM(arch)) {
         ret = convolution_arm(inputDesc, input, filterDesc, filter, convParamSpec, algorithm,
-            scaleDesc, scale, biasDesc, bias, tmpBytes, tmp, outputDesc, output, activationDesc,
-            archInfo->arch);
+            scaleDesc, scale, biasDesc, bias, tmpBytes, tmp, outputDesc, output,
+            kernelActivationDesc, archInfo->arch);
 #endif
 #ifdef _USE_MALI
     } else if (IS_MALI_GPU(arch)) {
+        if (residual != nullptr) {
+            return NOT_SUPPORTED;
+        }
         ret = convolution_mali(((MaliPara_t)(archInfo->archPara))->handle, inputDesc,
             (GCLMem_t)input, filterDesc, (GCLMem_t)filter, convParamSpec,
             ((MaliPara_t)(archInfo->archPara))->forwardRunInfo, scaleDesc, (GCLMem_t)scale,
@@ -336,5 +401,10 @@ EE convolution(Tensor inputTensor,
             activationDesc.mode);
 #endif
     }
+#if defined(_USE_GENERAL) || defined(_USE_NEON)
+    if (ret == SUCCESS && residual != nullptr && !IS_X86(arch)) {
+        ret = residual_activation_cpu(outputDesc, output, residual, activationDesc, arch);
+    }
+#endif
     return ret;
 }
@@ -30,3 +30,25 @@ EE activation_cpu(TensorDesc inputDesc,
     ArrayActivationFunction activation_func = get_array_activation_function(arch);
     return activation_func(idt, input, len, activationDesc, output);
 }
+
+EE residual_activation_cpu(TensorDesc outputDesc,
+    void *output,
+    const void *residual,
+    ActivationParamSpec activationDesc,
+    Arch arch)
+{
+    if (nullptr == output) {
+        CHECK_STATUS(NULL_POINTER);
+    }
+    DataType odt = outputDesc.dt;
+    U32 len = tensorNumElements(outputDesc);
+    if (nullptr != residual) {
+        ArrayAddFunction add_func = get_array_add_function(arch);
+        add_func(odt, output, residual, output, len);
+    }
+    if (activationDesc.mode == ACTIVATION_NULL) {
+        return SUCCESS;
+    }
+    ArrayActivationFunction activation_func = get_array_activation_function(arch);
+    return activation_func(odt, output, len, activationDesc, output);
+}
@@ -103,6 +103,34 @@ void softmax_anyAxis_fp16(const F16 *input, I32 loopOuter, I32 loops, I32 loopIn
     }
 }
 
+// The 8 channels of a block are one vector, and the block c of a pixel is at c * hw * 8. The
+// maximum and the sum over the blocks are reduced over the lanes at the end.
+void softmax_nchwc8_channel_fp16(const F16 *input, I32 batch, I32 blocks, I32 hw, F16 *output)
+{
+    I32 blockStride = hw * 8;
+    for (I32 n = 0; n < batch * hw; n++) {
+        const F16 *inputPtr = input + (n / hw) * blocks * blockStride + (n % hw) * 8;
+        F16 *outputPtr = output + (n / hw) * blocks * blockStride + (n % hw) * 8;
+        float16x8_t max_v = vld1q_f16(inputPtr);
+        for (I32 c = 1; c < blocks; c++) {
+            max_v = vmaxq_f16(max_v, vld1q_f16(inputPtr + c * blockStride));
+        }
+        max_v = vdupq_n_f16(vmaxvq_f16(max_v));
+        float16x8_t sum_v = vdupq_n_f16(0);
+        for (I32 c = 0; c < blocks; c++) {
+            float16x8_t in_v = vld1q_f16(inputPtr + c * blockStride);
+            float16x8_t exp_v = vexpq_f16_f32(vsubq_f16(in_v, max_v));
+            sum_v = vaddq_f16(sum_v, exp_v);
+            vst1q_f16(outputPtr + c * blockStride, exp_v);
+        }
+        F16 scale = 1.0 / vaddvq_f16(sum_v);
+        for (I32 c = 0; c < blocks; c++) {
+            F16 *out = outputPtr + c * blockStride;
+            vst1q_f16(out, vmulq_n_f16(vld1q_f16(out), scale));
+        }
+    }
+}
+
 EE softmax_fp16(TensorDesc inputDesc, const F16 *input, int axis, TensorDesc outputDesc, F16 *output)
 {
     UNUSED(outputDesc);
@@ -113,6 +141,13 @@ EE softmax_fp16(TensorDesc inputDesc, const F16 *input, int axis, TensorDesc out
     U32 size = tensorNumElements(inputDesc);
     axis = (axis + inputDesc.nDims) % inputDesc.nDims;
     axis = inputDesc.nDims - 1 - axis;
+    // the other axes of NCHWC8 are given as 5D NCHW by softmax
+    if (DF_NCHWC8 == inputDesc.df) {
+        CHECK_REQUIREMENT(4 == inputDesc.nDims && 2 == axis);
+        softmax_nchwc8_channel_fp16(input, inputDesc.dims[3], inputDesc.dims[2] / 8,
+            inputDesc.dims[1] * inputDesc.dims[0], output);
+        return SUCCESS;
+    }
     I32 loops = inputDesc.dims[axis];
 
     I32 loopInner = 1;
@@ -122,17 +157,8 @@ EE softmax_fp16(TensorDesc inputDesc, const F16 *input, int axis, TensorDesc out
     U32 loopOuter = size / loops / loopInner;
 
     if (loopInner == 1) {
-        if (DF_NCHWC8 == inputDesc.df && 4 == inputDesc.nDims &&
-            (inputDesc.dims[1] != 1 || inputDesc.dims[0] != 1)) {
-            CHECK_REQUIREMENT(2 != axis);
-            loopInner *= 8;
-            loopOuter /= 8;
-            softmax_anyAxis_fp16(input, loopOuter, loops, loopInner, output);
-        } else {
-            softmax_lastAxis_fp16(input, loopOuter, loops, output);
-        }
+        softmax_lastAxis_fp16(input, loopOuter, loops, output);
     } else {
-        CHECK_REQUIREMENT(DF_NCHWC8 != inputDesc.df);
         softmax_anyAxis_fp16(input, loopOuter, loops, loopInner, output);
     }
     return SUCCESS;
@@ -103,6 +103,39 @@ void softmax_anyAxis_fp32(const F32 *input, I32 loopOuter, I32 loops, I32 loopIn
     }
 }
 
+// The 8 channels of a block are two vectors, and the block c of a pixel is at c * hw * 8. The
+// maximum and the sum over the blocks are reduced over the lanes at the end.
+void softmax_nchwc8_channel_fp32(const F32 *input, I32 batch, I32 blocks, I32 hw, F32 *output)
+{
+    I32 blockStride = hw * 8;
+    for (I32 n = 0; n < batch * hw; n++) {
+        const F32 *inputPtr = input + (n / hw) * blocks * blockStride + (n % hw) * 8;
+        F32 *outputPtr = output + (n / hw) * blocks * blockStride + (n % hw) * 8;
+        float32x4_t max_v = vmaxq_f32(vld1q_f32(inputPtr), vld1q_f32(inputPtr + 4));
+        for (I32 c = 1; c < blocks; c++) {
+            const F32 *in = inputPtr + c * blockStride;
+            max_v = vmaxq_f32(max_v, vmaxq_f32(vld1q_f32(in), vld1q_f32(in + 4)));
+        }
+        max_v = vdupq_n_f32(vmaxvq_f32(max_v));
+        float32x4_t sum_v = vdupq_n_f32(0);
+        for (I32 c = 0; c < blocks; c++) {
+            const F32 *in = inputPtr + c * blockStride;
+            F32 *out = outputPtr + c * blockStride;
+            float32x4_t exp0_v = vexpq_f32_03_percent_error(vsubq_f32(vld1q_f32(in), max_v));
+            float32x4_t exp1_v = vexpq_f32_03_percent_error(vsubq_f32(vld1q_f32(in + 4), max_v));
+            sum_v = vaddq_f32(sum_v, vaddq_f32(exp0_v, exp1_v));
+            vst1q_f32(out, exp0_v);
+            vst1q_f32(out + 4, exp1_v);
+        }
+        F32 scale = 1.0 / vaddvq_f32(sum_v);
+        for (I32 c = 0; c < blocks; c++) {
+            F32 *out = outputPtr + c * blockStride;
+            vst1q_f32(out, vmulq_n_f32(vld1q_f32(out), scale));
+            vst1q_f32(out + 4, vmulq_n_f32(vld1q_f32(out + 4), scale));
+        }
+    }
+}
+
 EE softmax_fp32(TensorDesc inputDesc, const F32 *input, int axis, TensorDesc outputDesc, F32 *output)
 {
     UNUSED(outputDesc);
@@ -113,6 +146,13 @@ EE softmax_fp32(TensorDesc inputDesc, const F32 *input, int axis, TensorDesc out
     U32 size = tensorNumElements(inputDesc);
     axis = (axis + inputDesc.nDims) % inputDesc.nDims;
     axis = inputDesc.nDims - 1 - axis;
+    // the other axes of NCHWC8 are given as 5D NCHW by softmax
+    if (DF_NCHWC8 == inputDesc.df) {
+        CHECK_REQUIREMENT(4 == inputDesc.nDims && 2 == axis);
+        softmax_nchwc8_channel_fp32(input, inputDesc.dims[3], inputDesc.dims[2] / 8,
+            inputDesc.dims[1] * inputDesc.dims[0], output);
+        return SUCCESS;
+    }
     I32 loops = inputDesc.dims[axis];
 
     I32 loopInner = 1;
@@ -122,17 +162,8 @@ EE softmax_fp32(TensorDesc inputDesc, const F32 *input, int axis, TensorDesc out
     U32 loopOuter = size / loops / loopInner;
 
     if (loopInner == 1) {
-        if (DF_NCHWC8 == inputDesc.df && 4 == inputDesc.nDims &&
-            (inputDesc.dims[1] != 1 || inputDesc.dims[0] != 1)) {
-            CHECK_REQUIREMENT(2 != axis);
-            loopInner *= 8;
-            loopOuter /= 8;
-            softmax_anyAxis_fp32(input, loopOuter, loops, loopInner, output);
-        } else {
-            softmax_lastAxis_fp32(input, loopOuter, loops, output);
-        }
+        softmax_lastAxis_fp32(input, loopOuter, loops, output);
     } else {
-        CHECK_REQUIREMENT(DF_NCHWC8 != inputDesc.df);
         softmax_anyAxis_fp32(input, loopOuter, loops, loopInner, output);
     }
     return SUCCESS;
@@ -53,34 +53,39 @@ static EE concat(std::vector<TensorDesc> inputDesc,
 
     bool isC8 = DF_NCHWC8 == outputDesc.df;
 
-    U8 *ptr = (U8 *)output;
+    // the inputs of the other format are transformed once, not in every loop
     U8 *tmpPtr = (U8 *)tmp;
+    for (U32 j = 0; j < num; j++) {
+        if (nullptr == input[j] || tensorNumElements(inputDesc[j]) == 0) {
+            continue;
+        }
+        if ((4 != inputDesc[j].nDims) || (1 != inputDesc[j].dims[1]) ||
+            (1 != inputDesc[j].dims[0])) {
+            if (isC8 && (DF_NCHW == inputDesc[j].df)) {
+                TensorDesc tmpDesc = inputDesc[j];
+                tmpDesc.df = DF_NCHWC8;
+                transformNCHWToNCHWC8(inputDesc[j], input[j], tmpDesc, tmpPtr);
+                input[j] = tmpPtr;
+            } else if (!isC8 && (DF_NCHWC8 == inputDesc[j].df)) {
+                TensorDesc tmpDesc = inputDesc[j];
+                tmpDesc.df = DF_NCHW;
+                transformToNCHW(inputDesc[j], input[j], tmpDesc, tmpPtr);
+                input[j] = tmpPtr;
+            }
+        }
+        tmpPtr += tensorNumBytes(inputDesc[j]);
+    }
+
+    U8 *ptr = (U8 *)output;
     for (U32 i = 0; i < loops; i++) {
         for (U32 j = 0; j < num; j++) {
-            U8 *inPtr = (U8 *)((input)[j]);
             if (nullptr == input[j] || tensorNumElements(inputDesc[j]) == 0) {
                 continue;
             }
-
-            if ((4 != inputDesc[j].nDims) || (1 != inputDesc[j].dims[1]) ||
-                (1 != inputDesc[j].dims[0])) {
-                if (isC8 && (DF_NCHW == inputDesc[j].df)) {
-                    TensorDesc tmpDesc = inputDesc[j];
-                    tmpDesc.df = DF_NCHWC8;
-                    transformNCHWToNCHWC8(inputDesc[j], inPtr, tmpDesc, tmpPtr);
-                    inPtr = tmpPtr;
-                } else if (!isC8 && (DF_NCHWC8 == inputDesc[j].df)) {
-                    TensorDesc tmpDesc = inputDesc[j];
-                    tmpDesc.df = DF_NCHW;
-                    transformToNCHW(inputDesc[j], inPtr, tmpDesc, tmpPtr);
-                    inPtr = tmpPtr;
-                }
-            }
             U32 blockSize = inputDesc[j].dims[axis] * tileSize;
-            U8 *srcPtr = inPtr + i * blockSize;
+            U8 *srcPtr = (U8 *)input[j] + i * blockSize;
             memcpy(ptr, srcPtr, blockSize);
             ptr += blockSize;
-            tmpPtr += tensorNumBytes(inputDesc[j]);
         }
     }
     return SUCCESS;
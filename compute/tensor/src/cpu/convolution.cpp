@@ -46,10 +46,10 @@ EE convolution_cpu(TensorDesc inputDesc,
             scale, biasDesc, bias, outputDesc, output, activationDesc);
 #endif
 #ifdef _USE_X86
-    } else if (IS_X86_AVX2(arch)) {
+    } else if (IS_X86(arch)) {
         ret = convolution_x86(inputDesc, input, filterDesc, filter, convParamSpec, algorithm,
-            scaleDesc, scale, biasDesc, bias, tmpBytes, tmp, outputDesc, output, activationDesc,
-            arch);
+            scaleDesc, scale, biasDesc, bias, tmpBytes, tmp, outputDesc, output, nullptr,
+            activationDesc, arch);
 #endif
 #ifdef _USE_NEON
     } else if (IS_ARM(arch)) {
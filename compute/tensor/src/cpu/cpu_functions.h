@@ -55,7 +55,7 @@ inline ArrayScaleFunction get_array_scale_function(Arch arch)
         find = true;
 #endif
 #ifdef _USE_X86
-    } else if (IS_X86_AVX2(arch)) {
+    } else if (IS_X86(arch)) {
         func = array_scale_x86;
         find = true;
 #endif
@@ -79,7 +79,7 @@ inline ArrayAddFunction get_array_add_function(Arch arch)
         find = true;
 #endif
 #ifdef _USE_X86
-    } else if (IS_X86_AVX2(arch)) {
+    } else if (IS_X86(arch)) {
         func = array_add_x86;
         find = true;
 #endif
@@ -103,7 +103,7 @@ inline ArrayMeanFunction get_array_mean_function(Arch arch)
         find = true;
 #endif
 #ifdef _USE_X86
-    } else if (IS_X86_AVX2(arch)) {
+    } else if (IS_X86(arch)) {
         func = array_mean_x86;
         find = true;
 #endif
@@ -127,7 +127,7 @@ inline ArrayVarFunction get_array_var_function(Arch arch)
         find = true;
 #endif
 #ifdef _USE_X86
-    } else if (IS_X86_AVX2(arch)) {
+    } else if (IS_X86(arch)) {
         func = array_var_x86;
         find = true;
 #endif
@@ -151,7 +151,7 @@ inline ArrayPowerFunction get_array_power_function(Arch arch)
         find = true;
 #endif
 #ifdef _USE_X86
-    } else if (IS_X86_AVX2(arch)) {
+    } else if (IS_X86(arch)) {
         func = array_power_x86;
         find = true;
 #endif
@@ -175,7 +175,7 @@ inline ArraySumFunction get_array_sum_function(Arch arch)
         find = true;
 #endif
 #ifdef _USE_X86
-    } else if (IS_X86_AVX2(arch)) {
+    } else if (IS_X86(arch)) {
         func = array_sum_x86;
         find = true;
 #endif
@@ -199,7 +199,7 @@ inline ArraySquareAndAddFunction get_array_square_and_add_function(Arch arch)
         find = true;
 #endif
 #ifdef _USE_X86
-    } else if (IS_X86_AVX2(arch)) {
+    } else if (IS_X86(arch)) {
         func = array_square_and_add_x86;
         find = true;
 #endif
@@ -223,7 +223,7 @@ inline ArrayActivationFunction get_array_activation_function(Arch arch)
         find = true;
 #endif
 #ifdef _USE_X86
-    } else if (IS_X86_AVX2(arch)) {
+    } else if (IS_X86(arch)) {
         func = array_activation_x86;
         find = true;
 #endif
@@ -247,7 +247,7 @@ inline ArrayMaxValueFunction get_array_max_value_function(Arch arch)
         find = true;
 #endif
 #ifdef _USE_X86
-    } else if (IS_X86_AVX2(arch)) {
+    } else if (IS_X86(arch)) {
         func = array_max_value_x86;
         find = true;
 #endif
@@ -271,7 +271,7 @@ inline ArrayMaxFunction get_array_max_function(Arch arch)
         find = true;
 #endif
 #ifdef _USE_X86
-    } else if (IS_X86_AVX2(arch)) {
+    } else if (IS_X86(arch)) {
         func = array_max_x86;
         find = true;
 #endif
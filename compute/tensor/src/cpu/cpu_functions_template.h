@@ -28,7 +28,10 @@ void get_vector(T *input, int lda, T **output, int ldb, int index, int length, T
         *output = buffer;
         (*output)[0] = input[local];
     } else if (lda == 1) {
-        *output = input;
+        *output = buffer;
+        for (int i = 0; i < length; i++) {
+            (*output)[i] = input[0];
+        }
     } else {
         int remain = lda - local;
         if (remain >= length) {
@@ -233,4 +236,32 @@ F32 array_max_value_template(const T *data, I32 len)
     }
     return max_s;
 }
+
+// keys of one attention head are visited in tiles of this length by the online softmax
+#define ATTENTION_KEY_TILE 64
+
+// strides of the additive attention mask broadcast to the [batch, heads, qLength, kLength]
+// scores, in the order of kLength, qLength, heads and batch, broadcast dimensions have stride 0
+inline void attention_mask_strides(TensorDesc maskDesc, U32 *strides)
+{
+    U32 stride = 1;
+    for (U32 i = 0; i < 4; i++) {
+        strides[i] = 0;
+        if (i < maskDesc.nDims) {
+            if (maskDesc.dims[i] > 1) {
+                strides[i] = stride;
+            }
+            stride *= maskDesc.dims[i];
+        }
+    }
+}
+
+// the activations that only take a few instructions per element, which are done by the epilogues
+// on the small blocks that the kernels have just written. The others are done in one pass after
+// the kernel, because calling them on the narrow blocks costs more than the cache misses it saves.
+inline bool is_block_activation(ActivationMode mode)
+{
+    return mode == ACTIVATION_RELU || mode == ACTIVATION_RELU6 || mode == ACTIVATION_H_SIGMOID ||
+        mode == ACTIVATION_H_SWISH;
+}
 #endif
@@ -92,7 +92,7 @@ EE deconvolution_infer_forward_algorithm_cpu(TensorDesc inputDesc,
             inPaddedDesc, filterDesc, outputDesc, transposedCD, policy, algorithm, targetDataType);
 #endif
 #ifdef _USE_X86
-    } else if (IS_X86_AVX2(arch)) {
+    } else if (IS_X86(arch)) {
         ret = convolution_infer_forward_algorithm_x86(
             inPaddedDesc, filterDesc, outputDesc, transposedCD, policy, algorithm, targetDataType);
 #endif
@@ -120,7 +120,7 @@ EE deconvolution_transform_filter_bytes_cpu(TensorDesc filterDesc,
                 convolution_transform_filter_bytes_arm(filterDesc, convParamSpec, algorithm, bytes);
 #endif
 #ifdef _USE_X86
-        } else if (IS_X86_AVX2(arch)) {
+        } else if (IS_X86(arch)) {
             ret =
                 convolution_transform_filter_bytes_x86(filterDesc, convParamSpec, algorithm, bytes);
 #endif
@@ -197,7 +197,7 @@ EE deconvolution_transform_filter_cpu(TensorDesc filterDesc,
             filterDesc, filter, algorithm, ftmDesc, filterTransformed);
 #endif
 #ifdef _USE_X86
-    } else if (IS_X86_AVX2(arch)) {
+    } else if (IS_X86(arch)) {
         ret = deconvolution_transform_filter_x86(
             filterDesc, filter, algorithm, ftmDesc, filterTransformed);
 #endif
@@ -281,7 +281,7 @@ EE deconvolution_infer_forward_tmp_bytes_cpu(TensorDesc inputDesc,
             inPaddedDesc, filterDesc, outputDesc, transposedCD, algorithm, &convolution_tmp_bytes);
 #endif
 #ifdef _USE_X86
-    } else if (IS_X86_AVX2(arch)) {
+    } else if (IS_X86(arch)) {
         ret = convolution_infer_forward_tmp_bytes_x86(
             inPaddedDesc, filterDesc, outputDesc, transposedCD, algorithm, &convolution_tmp_bytes);
 #endif
@@ -50,7 +50,7 @@ EE depthwise_pointwise_convolution_cpu(TensorDesc inputDesc,
             tmp, outputDesc, output, depthwiseActivationParamSpec, pointwiseActivationParamSpec);
 #endif
 #ifdef _USE_X86
-    } else if (IS_X86_AVX2(arch)) {
+    } else if (IS_X86(arch)) {
         ret = depthwise_pointwise_convolution_x86(inputDesc, input, dwFilterDesc, dwFilter,
             pwFilterDesc, pwFilter, convParamSpec, algorithm, dwBiasDesc, dwBias, pwBiasDesc,
             pwBias, tmpBytes, tmp, outputDesc, output, depthwiseActivationParamSpec,
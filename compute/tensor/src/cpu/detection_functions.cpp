@@ -0,0 +1,93 @@
+// Copyright (C) 2019. Huawei Technologies Co., Ltd. All rights reserved.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "cpu/detection_functions.h"
+#ifdef _USE_X86
+#include "x86_avx2_expand.h"
+#endif
+
+// The IoU is computed as the previous per-operator implementations did, so that the suppression
+// decisions stay the same: disjoint boxes have no intersection, the union is (a + b) - inter.
+inline bool box_iou_greater(BoxArray boxes, U32 i, BoxArray kept, U32 k, F32 threshold)
+{
+    F32 inter = 0;
+    if (!(boxes.xmin[i] > kept.xmax[k] || boxes.xmax[i] < kept.xmin[k] ||
+            boxes.ymin[i] > kept.ymax[k] || boxes.ymax[i] < kept.ymin[k])) {
+        F32 w = std::min(boxes.xmax[i], kept.xmax[k]) - std::max(boxes.xmin[i], kept.xmin[k]);
+        F32 h = std::min(boxes.ymax[i], kept.ymax[k]) - std::max(boxes.ymin[i], kept.ymin[k]);
+        inter = w * h;
+    }
+    F32 area = boxes.area[i] + kept.area[k] - inter;
+    return inter / area > threshold;
+}
+
+static bool box_suppressed(BoxArray boxes, U32 i, BoxArray kept, U32 num, F32 threshold)
+{
+    U32 k = 0;
+#ifdef _USE_X86
+    __m256 xmin = _mm256_set1_ps(boxes.xmin[i]);
+    __m256 ymin = _mm256_set1_ps(boxes.ymin[i]);
+    __m256 xmax = _mm256_set1_ps(boxes.xmax[i]);
+    __m256 ymax = _mm256_set1_ps(boxes.ymax[i]);
+    __m256 area = _mm256_set1_ps(boxes.area[i]);
+    __m256 thr = _mm256_set1_ps(threshold);
+    for (; k + 8 <= num; k += 8) {
+        __m256 kxmin = _mm256_loadu_ps(kept.xmin + k);
+        __m256 kymin = _mm256_loadu_ps(kept.ymin + k);
+        __m256 kxmax = _mm256_loadu_ps(kept.xmax + k);
+        __m256 kymax = _mm256_loadu_ps(kept.ymax + k);
+        __m256 disjoint = _mm256_or_ps(
+            _mm256_or_ps(_mm256_cmp_ps(xmin, kxmax, _CMP_GT_OQ),
+                _mm256_cmp_ps(xmax, kxmin, _CMP_LT_OQ)),
+            _mm256_or_ps(_mm256_cmp_ps(ymin, kymax, _CMP_GT_OQ),
+                _mm256_cmp_ps(ymax, kymin, _CMP_LT_OQ)));
+        __m256 w = _mm256_sub_ps(_mm256_min_ps(xmax, kxmax), _mm256_max_ps(xmin, kxmin));
+        __m256 h = _mm256_sub_ps(_mm256_min_ps(ymax, kymax), _mm256_max_ps(ymin, kymin));
+        __m256 inter = _mm256_andnot_ps(disjoint, _mm256_mul_ps(w, h));
+        __m256 u = _mm256_sub_ps(_mm256_add_ps(area, _mm256_loadu_ps(kept.area + k)), inter);
+        __m256 iou = _mm256_div_ps(inter, u);
+        if (_mm256_movemask_ps(_mm256_cmp_ps(iou, thr, _CMP_GT_OQ)) != 0) {
+            return true;
+        }
+    }
+#endif
+    for (; k < num; k++) {
+        if (box_iou_greater(boxes, i, kept, k, threshold)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+U32 detection_nms(BoxArray boxes,
+    const U32 *order,
+    U32 num,
+    F32 threshold,
+    U32 maxKeep,
+    BoxArray kept,
+    U32 *keep)
+{
+    U32 count = 0;
+    for (U32 i = 0; i < num && count < maxKeep; i++) {
+        U32 id = order[i];
+        if (!box_suppressed(boxes, id, kept, count, threshold)) {
+            kept.xmin[count] = boxes.xmin[id];
+            kept.ymin[count] = boxes.ymin[id];
+            kept.xmax[count] = boxes.xmax[id];
+            kept.ymax[count] = boxes.ymax[id];
+            kept.area[count] = boxes.area[id];
+            keep[count++] = id;
+        }
+    }
+    return count;
+}
@@ -0,0 +1,96 @@
+// Copyright (C) 2019. Huawei Technologies Co., Ltd. All rights reserved.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef _H_DETECTION_FUNCTIONS
+#define _H_DETECTION_FUNCTIONS
+
+#include <algorithm>
+#include "types.h"
+
+// Boxes stored as a structure of arrays, so that the IoU of one box against many boxes can be
+// vectorized. Box i is [xmin[i], ymin[i], xmax[i], ymax[i]] and its area is area[i].
+typedef struct {
+    F32 *xmin;
+    F32 *ymin;
+    F32 *xmax;
+    F32 *ymax;
+    F32 *area;
+} BoxArray;
+
+inline U32 box_array_stride(U32 num)
+{
+    return (num + 7) / 8 * 8;
+}
+
+inline U32 box_array_bytes(U32 num)
+{
+    return 5 * box_array_stride(num) * sizeof(F32);
+}
+
+// place a BoxArray of num boxes in a buffer of box_array_bytes(num) bytes
+inline BoxArray box_array_create(void *buffer, U32 num)
+{
+    U32 stride = box_array_stride(num);
+    F32 *ptr = (F32 *)buffer;
+    BoxArray boxes = {ptr, ptr + stride, ptr + 2 * stride, ptr + 3 * stride, ptr + 4 * stride};
+    return boxes;
+}
+
+inline void box_array_set(BoxArray boxes, U32 i, F32 xmin, F32 ymin, F32 xmax, F32 ymax)
+{
+    boxes.xmin[i] = xmin;
+    boxes.ymin[i] = ymin;
+    boxes.xmax[i] = xmax;
+    boxes.ymax[i] = ymax;
+    boxes.area[i] = (xmax - xmin) * (ymax - ymin);
+}
+
+// Write the indexes of the scores greater than threshold to index, scores[i * stride] is the
+// score of box i. Only the topK highest scores are sorted, by descending score and then by
+// ascending index, so that the order does not depend on the sorting algorithm.
+// index needs num elements, returns the number of sorted indexes.
+template <typename T>
+inline U32 detection_top_k(
+    const T *scores, U32 num, U32 stride, F32 threshold, U32 topK, U32 *index)
+{
+    U32 count = 0;
+    for (U32 i = 0; i < num; i++) {
+        if (scores[i * stride] > threshold) {
+            index[count++] = i;
+        }
+    }
+    auto greater = [&](const U32 &a, const U32 &b) {
+        F32 sa = scores[a * stride];
+        F32 sb = scores[b * stride];
+        return (sa > sb) || (sa == sb && a < b);
+    };
+    if (count > topK) {
+        std::nth_element(index, index + topK, index + count, greater);
+        count = topK;
+    }
+    std::sort(index, index + count, greater);
+    return count;
+}
+
+// Greedy non-maximum suppression of boxes visited in order. A box is kept if its IoU with every
+// kept box is not greater than threshold, and the visit stops after maxKeep boxes are kept.
+// The indexes of the kept boxes are written to keep, kept is the buffer of the kept boxes with
+// maxKeep elements. Returns the number of kept boxes.
+U32 detection_nms(BoxArray boxes,
+    const U32 *order,
+    U32 num,
+    F32 threshold,
+    U32 maxKeep,
+    BoxArray kept,
+    U32 *keep);
+#endif
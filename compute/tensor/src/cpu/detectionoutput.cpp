@@ -11,96 +11,36 @@
 // COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
-#include "error.h"
+#ifdef _USE_OPENMP
+#include <omp.h>
+#endif
+#include "thread_affinity.h"
 #include "cpu/tensor_computing_cpu.h"
+#include "cpu/detection_functions.h"
 
-inline EE qsort_descent(std::vector<BoxRect> &boxes, std::vector<F32> &scores, int left, int right)
-{
-    if (boxes.empty() || scores.empty()) {
-        return NOT_SUPPORTED;
-    }
-
-    int i = left;
-    int j = right;
-    F32 temp = scores[(left + right) / 2];
-
-    while (i <= j) {
-        while (scores[i] > temp) {
-            i++;
-        }
-        while (scores[j] < temp) {
-            j--;
-        }
-        if (i <= j) {
-            std::swap(boxes[i], boxes[j]);
-            std::swap(scores[i], scores[j]);
-            i++;
-            j--;
-        }
-    }
-
-    if (left < j) {
-        qsort_descent(boxes, scores, left, j);
-    }
-    if (i < right) {
-        qsort_descent(boxes, scores, i, right);
-    }
-
-    return SUCCESS;
-}
-
-inline F32 intersectionarea(BoxRect a, BoxRect b)
+// The decoded boxes, the picked boxes of every class and the merged scores are shared, the
+// candidate indexes and the kept boxes are private to each thread.
+static U32 detectionoutput_shared_bytes(U32 num_priorbox, U32 num_class, U32 max_keep)
 {
-    if (a.xmin > b.xmax || a.xmax < b.xmin || a.ymin > b.ymax || a.ymax < b.ymin) {
-        return 0.f;
-    }
-    F32 inter_width = std::min(a.xmax, b.xmax) - std::max(a.xmin, b.xmin);
-    F32 inter_height = std::min(a.ymax, b.ymax) - std::max(a.ymin, b.ymin);
-
-    return inter_width * inter_height;
+    return box_array_bytes(num_priorbox) + num_class * sizeof(U32) +
+        num_class * max_keep * (2 * sizeof(U32) + sizeof(F32));
 }
 
-inline EE nms_pickedboxes(std::vector<BoxRect> boxes, std::vector<I64> &picked, F32 nms_threshold)
+static U32 detectionoutput_thread_bytes(U32 num_priorbox, U32 max_keep)
 {
-    I64 n = boxes.size();
-
-    std::vector<F32> areas(n);
-    for (I64 i = 0; i < n; i++) {
-        BoxRect box = boxes[i];
-
-        F32 width = box.xmax - box.xmin;
-        F32 height = box.ymax - box.ymin;
-
-        areas[i] = width * height;
-    }
-    for (I64 i = 0; i < n; i++) {
-        BoxRect a = boxes[i];
-        int keep = 1;
-        for (int j = 0; j < (int)picked.size(); j++) {
-            BoxRect b = boxes[picked[j]];
-            F32 inter_area = intersectionarea(a, b);
-            F32 union_area = areas[i] + areas[picked[j]] - inter_area;
-
-            if (inter_area / union_area > nms_threshold) {
-                keep = 0;
-            }
-        }
-        if (keep) {
-            picked.push_back(i);
-        }
-    }
-    return SUCCESS;
+    return num_priorbox * sizeof(U32) + box_array_bytes(max_keep);
 }
 
 template <typename T>
-EE detectionoutput_kernel(std::vector<void *> input,
+static EE detectionoutput_kernel(std::vector<void *> input,
     T *output,
     U32 priorbox_width,
     U32 num_class,
     F32 nms_threshold,
     U32 nms_top_k,
     U32 keep_top_k,
-    F32 confidence_threshold)
+    F32 confidence_threshold,
+    void *tmp)
 {
     T *location = (T *)input[0];
     T *confidence = (T *)input[1];
@@ -108,9 +48,9 @@ EE detectionoutput_kernel(std::vector<void *> input,
 
     U32 num_total_priorbox = priorbox_width / 4;
     U32 numclass = num_class;
+    U32 max_keep = UNI_MIN(nms_top_k, num_total_priorbox);
 
-    std::vector<std::vector<F32>> boxes;
-    boxes.resize(num_total_priorbox);
+    BoxArray boxes = box_array_create(tmp, num_total_priorbox);
     T *variance = priorbox + priorbox_width;
     // decode priorbox
     for (U32 i = 0; i < num_total_priorbox; i++) {
@@ -128,102 +68,96 @@ EE detectionoutput_kernel(std::vector<void *> input,
         F32 box_w = static_cast<F32>(exp(var[2] * loc[2]) * pb_w);
         F32 box_h = static_cast<F32>(exp(var[3] * loc[3]) * pb_h);
 
-        std::vector<F32> box;
-        box.resize(4);
-        box[0] = box_cx - box_w * 0.5f;
-        box[1] = box_cy - box_h * 0.5f;
-        box[2] = box_cx + box_w * 0.5f;
-        box[3] = box_cy + box_h * 0.5f;
-        // give box to boxes
-        boxes[i].assign(box.begin(), box.end());
+        box_array_set(boxes, i, box_cx - box_w * 0.5f, box_cy - box_h * 0.5f,
+            box_cx + box_w * 0.5f, box_cy + box_h * 0.5f);
     }
 
-    std::vector<std::vector<BoxRect>> allclass_boxrects;
-    std::vector<std::vector<F32>> allclass_boxscores;
-    allclass_boxrects.resize(numclass);
-    allclass_boxscores.resize(numclass);
-
-    for (U32 i = 1; i < numclass; i++) {
-        std::vector<BoxRect> class_boxrects;
-        std::vector<F32> class_boxscores;
-        for (U32 j = 0; j < num_total_priorbox; j++) {
-            F32 score = confidence[j * numclass + i];
-
-            if (score > confidence_threshold) {
-                std::vector<F32> inbox;
-                inbox.assign(boxes[j].begin(), boxes[j].end());
-                BoxRect b = {inbox[0], inbox[1], inbox[2], inbox[3], i};
-                class_boxrects.push_back(b);
-                class_boxscores.push_back(score);
-            }
-        }
-        // sort the boxes with scores
-        qsort_descent(
-            class_boxrects, class_boxscores, 0, static_cast<int>(class_boxscores.size() - 1));
-
-        if (nms_top_k < (U32)class_boxrects.size()) {
-            class_boxrects.resize(nms_top_k);
-            class_boxscores.resize(nms_top_k);
-        }
-        // apply nms
-        std::vector<I64> picked;
-        nms_pickedboxes(class_boxrects, picked, nms_threshold);
-
-        for (I64 j = 0; j < (I64)picked.size(); j++) {
-            I64 picked_box = picked[j];
-            allclass_boxrects[i].push_back(class_boxrects[picked_box]);
-            allclass_boxscores[i].push_back(class_boxscores[picked_box]);
-        }
-    }
-
-    std::vector<BoxRect> boxrects;
-    std::vector<F32> boxscores;
-
+    U32 *counts = (U32 *)((U8 *)tmp + box_array_bytes(num_total_priorbox));
+    U32 *picked = counts + numclass;
+    F32 *merged_scores = (F32 *)(picked + numclass * max_keep);
+    U32 *merged_index = (U32 *)(merged_scores + numclass * max_keep);
+    U8 *buffer = (U8 *)tmp + detectionoutput_shared_bytes(num_total_priorbox, numclass, max_keep);
+    U32 thread_bytes = detectionoutput_thread_bytes(num_total_priorbox, max_keep);
+    counts[0] = 0;
+#ifdef _USE_OPENMP
+#pragma omp parallel for num_threads(OMP_NUM_THREADS)
+#endif
     for (U32 i = 1; i < numclass; i++) {
-        boxrects.insert(boxrects.end(), allclass_boxrects[i].begin(), allclass_boxrects[i].end());
-        boxscores.insert(
-            boxscores.end(), allclass_boxscores[i].begin(), allclass_boxscores[i].end());
+#ifdef _USE_OPENMP
+        U32 threadId = omp_get_thread_num();
+#else
+        U32 threadId = 0;
+#endif
+        U32 *index = (U32 *)(buffer + thread_bytes * threadId);
+        BoxArray kept = box_array_create(index + num_total_priorbox, max_keep);
+        U32 num = detection_top_k(confidence + i, num_total_priorbox, numclass,
+            confidence_threshold, nms_top_k, index);
+        counts[i] = detection_nms(
+            boxes, index, num, nms_threshold, max_keep, kept, picked + i * max_keep);
     }
 
-    qsort_descent(boxrects, boxscores, 0, static_cast<int>(boxscores.size() - 1));
-
-    if (keep_top_k < (U32)boxrects.size()) {
-        boxrects.resize(keep_top_k);
-        boxscores.resize(keep_top_k);
+    // The slots of every class are merged in the order of class, the slots without box get the
+    // threshold score, so that they are dropped by the selection of the keep_top_k boxes.
+    for (U32 i = 0; i < numclass; i++) {
+        for (U32 j = 0; j < max_keep; j++) {
+            U32 k = i * max_keep + j;
+            merged_scores[k] = (j < counts[i]) ? (F32)confidence[picked[k] * numclass + i]
+                                               : confidence_threshold;
+        }
     }
+    U32 num_detected = detection_top_k(merged_scores, numclass * max_keep, 1,
+        confidence_threshold, keep_top_k, merged_index);
 
-    U32 num_detected = static_cast<U32>(boxrects.size());
     // the first box contains the number of availble boxes in the first element.
     output[0] = num_detected;
     output[1] = output[2] = output[3] = output[4] = output[5] = 0;
 
     for (U32 i = 0; i < num_detected; i++) {
-        BoxRect b = boxrects[i];
-        F32 score = boxscores[i];
-
-        output[(i + 1) * 6] = b.label;
-        output[(i + 1) * 6 + 1] = score;
-        output[(i + 1) * 6 + 2] = b.xmin;
-        output[(i + 1) * 6 + 3] = b.ymin;
-        output[(i + 1) * 6 + 4] = b.xmax;
-        output[(i + 1) * 6 + 5] = b.ymax;
+        U32 k = merged_index[i];
+        U32 box = picked[k];
+
+        output[(i + 1) * 6] = k / max_keep;
+        output[(i + 1) * 6 + 1] = merged_scores[k];
+        output[(i + 1) * 6 + 2] = boxes.xmin[box];
+        output[(i + 1) * 6 + 3] = boxes.ymin[box];
+        output[(i + 1) * 6 + 4] = boxes.xmax[box];
+        output[(i + 1) * 6 + 5] = boxes.ymax[box];
     }
     return SUCCESS;
 }
 
+EE detectionoutput_infer_forward_tmp_bytes_cpu(
+    std::vector<TensorDesc> inputDesc, DetectionOutputParamSpec p, U32 *bytes)
+{
+    if (nullptr == bytes) {
+        CHECK_STATUS(NULL_POINTER);
+    }
+    if (inputDesc.size() != 3) {
+        CHECK_STATUS(NOT_MATCH);
+    }
+    U32 num_priorbox = inputDesc[2].dims[0] / 4;
+    U32 max_keep = UNI_MIN(p.nms_top_k, num_priorbox);
+    *bytes = detectionoutput_shared_bytes(num_priorbox, p.num_class, max_keep) +
+        detectionoutput_thread_bytes(num_priorbox, max_keep) * OMP_NUM_THREADS;
+    return SUCCESS;
+}
+
 EE detectionoutput_cpu(std::vector<TensorDesc> inputDesc,
     std::vector<void *> input,
     DetectionOutputParamSpec detectionOutputParamSpec,
+    U32 tmpBytes,
+    void *tmp,
     TensorDesc outputDesc,
     void *output)
 {
     UNUSED(outputDesc);
-    if (nullptr == output) {
+    if (nullptr == output || nullptr == tmp) {
         CHECK_STATUS(NULL_POINTER);
     }
-    if (inputDesc.size() != 3) {
-        CHECK_STATUS(NOT_MATCH);
-    }
+    U32 bytes = 0;
+    CHECK_STATUS(
+        detectionoutput_infer_forward_tmp_bytes_cpu(inputDesc, detectionOutputParamSpec, &bytes));
+    CHECK_REQUIREMENT(tmpBytes >= bytes);
     DataType idt0 = inputDesc[0].dt;
     U32 ilens2 = inputDesc[2].dims[0];
     U32 numclass = detectionOutputParamSpec.num_class;
@@ -235,14 +169,14 @@ EE detectionoutput_cpu(std::vector<TensorDesc> inputDesc,
     switch (idt0) {
 #ifdef _USE_FP32
         case DT_F32:
-            detectionoutput_kernel(input, (F32 *)output, ilens2, numclass, nmsthreshold, nmstopk,
-                keeptopk, confidencethreshold);
+            ret = detectionoutput_kernel(input, (F32 *)output, ilens2, numclass, nmsthreshold,
+                nmstopk, keeptopk, confidencethreshold, tmp);
             break;
 #endif
 #ifdef _USE_FP16
         case DT_F16:
-            detectionoutput_kernel(input, (F16 *)output, ilens2, numclass, nmsthreshold, nmstopk,
-                keeptopk, confidencethreshold);
+            ret = detectionoutput_kernel(input, (F16 *)output, ilens2, numclass, nmsthreshold,
+                nmstopk, keeptopk, confidencethreshold, tmp);
             break;
 #endif
         default:
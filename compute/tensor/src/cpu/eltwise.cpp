@@ -32,6 +32,128 @@ static std::vector<U32> calculateRelativeLocalIndex_cpu(U32 *indexes, U32 *dims,
     return relativeIndexes;
 }
 
+static EE eltwise_kernel_cpu(DataType dt,
+    std::vector<void *> input,
+    std::vector<int> inputSize,
+    U32 num,
+    U32 len,
+    void *output,
+    EltwiseMode mode,
+    Arch arch)
+{
+    EE ret = NOT_SUPPORTED;
+    if (IS_GENERAL(arch)) {
+#ifdef _USE_GENERAL
+        ret = eltwise_general(dt, input, inputSize, num, len, output, mode);
+#endif
+#ifdef _USE_NEON
+    } else if (IS_ARM(arch)) {
+        ret = eltwise_arm(dt, input, inputSize, num, len, output, mode);
+#endif
+#ifdef _USE_X86
+    } else if (IS_X86(arch)) {
+        ret = eltwise_x86(dt, input, inputSize, num, len, output, mode);
+#endif
+    }
+    return ret;
+}
+
+static EE eltwise_activation_cpu(
+    EE ret, EltwiseParamSpec eltwiseDesc, TensorDesc outputDesc, void *output, Arch arch)
+{
+    if (ret == SUCCESS && eltwiseDesc.activation_type != ACTIVATION_NULL) {
+        ActivationParamSpec p;
+        p.mode = eltwiseDesc.activation_type;
+        ret = activation_cpu(outputDesc, output, p, outputDesc, output, arch);
+    }
+    return ret;
+}
+
+// The values of an [N, C, 1, 1] tensor are in the same order in NCHW and NCHWC8, so the
+// per-channel inputs of an SE block or a bias are broadcast to the NCHWC8 inputs of the output
+// shape without transforming any of them.
+bool eltwise_nchwc8_broadcast_cpu(std::vector<TensorDesc> inputDesc)
+{
+    I32 full = -1;
+    for (U32 i = 0; i < inputDesc.size(); i++) {
+        if (inputDesc[i].df == DF_NCHWC8 && tensorIs4d(inputDesc[i]) &&
+            (full < 0 || tensorNumElements(inputDesc[i]) > tensorNumElements(inputDesc[full]))) {
+            full = i;
+        }
+    }
+    if (full < 0 || inputDesc[full].dims[2] % 8 != 0) {
+        return false;
+    }
+    const TensorDesc &fullDesc = inputDesc[full];
+    bool broadcast = false;
+    for (U32 i = 0; i < inputDesc.size(); i++) {
+        const TensorDesc &desc = inputDesc[i];
+        if (desc.df == DF_NCHWC8 && tensorIs4d(desc) && desc.dims[0] == fullDesc.dims[0] &&
+            desc.dims[1] == fullDesc.dims[1] && desc.dims[2] == fullDesc.dims[2] &&
+            desc.dims[3] == fullDesc.dims[3]) {
+            continue;
+        }
+        if (desc.nDims > 0 && tensorNumElements(desc) == 1) {
+            broadcast = true;
+            continue;
+        }
+        if (tensorIs4d(desc) && desc.dims[0] == 1 && desc.dims[1] == 1 &&
+            desc.dims[2] == fullDesc.dims[2] &&
+            (desc.dims[3] == fullDesc.dims[3] || desc.dims[3] == 1)) {
+            broadcast = true;
+            continue;
+        }
+        return false;
+    }
+    return broadcast;
+}
+
+static EE eltwise_nchwc8_cpu(std::vector<TensorDesc> inputDesc,
+    std::vector<void *> input,
+    EltwiseParamSpec eltwiseDesc,
+    TensorDesc outputDesc,
+    void *output,
+    Arch arch)
+{
+    DataType odt;
+    DataFormat odf;
+    U32 on, oc, oh, ow;
+    CHECK_STATUS(tensor4dGet(outputDesc, &odt, &odf, &on, &oc, &oh, &ow));
+    U32 num = inputDesc.size();
+    U32 block = oh * ow * 8;
+    U32 bytes = bytesOf(odt);
+    std::vector<int> inputSize(num);
+    for (U32 j = 0; j < num; j++) {
+        U32 elements = tensorNumElements(inputDesc[j]);
+        if (elements == 1) {
+            inputSize[j] = 1;
+        } else if (elements == tensorNumElements(outputDesc)) {
+            inputSize[j] = block;
+        } else {
+            inputSize[j] = 8;
+        }
+    }
+    std::vector<void *> newInput(num);
+    EE ret = SUCCESS;
+    for (U32 n = 0; n < on && ret == SUCCESS; n++) {
+        for (U32 c = 0; c < oc && ret == SUCCESS; c += 8) {
+            for (U32 j = 0; j < num; j++) {
+                U32 offset = 0;
+                if (inputSize[j] == (int)block) {
+                    offset = (n * oc + c) * oh * ow;
+                } else if (inputSize[j] == 8) {
+                    offset = (inputDesc[j].dims[3] == 1) ? c : n * oc + c;
+                }
+                newInput[j] = (U8 *)input[j] + offset * bytes;
+            }
+            U8 *newOutput = (U8 *)output + (n * oc + c) * oh * ow * bytes;
+            ret = eltwise_kernel_cpu(
+                odt, newInput, inputSize, num, block, newOutput, eltwiseDesc.elt_mode, arch);
+        }
+    }
+    return eltwise_activation_cpu(ret, eltwiseDesc, outputDesc, output, arch);
+}
+
 // [1, 10, 10] + [1, 10, 10] = [1, 10, 10]
 // [1, 10, 1] + [1, 1, 10] = [1, 10, 10]
 // [1, 20, 10] + [10] = [1. 20, 10] + [1, 1, 10] = [1, 20, 10]
@@ -48,6 +170,9 @@ EE eltwise_cpu(std::vector<TensorDesc> inputDesc,
     if (num <= 1 || outputDesc.nDims < 1) {
         return NOT_MATCH;
     }
+    if (outputDesc.df == DF_NCHWC8 && eltwise_nchwc8_broadcast_cpu(inputDesc)) {
+        return eltwise_nchwc8_cpu(inputDesc, input_, eltwiseDesc, outputDesc, output, arch);
+    }
     std::vector<void *> input = input_;
     U32 nchwc8Count = 0;
     U32 minDims = inputDesc[0].nDims;
@@ -143,27 +268,8 @@ EE eltwise_cpu(std::vector<TensorDesc> inputDesc,
             newInput[j] = (U8 *)(input[j]) + globalIndex * bytesOf(newInputDesc[j].dt);
         }
         U8 *newOutput = (U8 *)output + i * bytesOf(newOutputDesc.dt);
-        if (IS_GENERAL(arch)) {
-#ifdef _USE_GENERAL
-            ret = eltwise_general(newOutputDesc.dt, newInput, lastDimSizes, num, lastDimSize,
-                newOutput, eltwiseDesc.elt_mode);
-#endif
-#ifdef _USE_NEON
-        } else if (IS_ARM(arch)) {
-            ret = eltwise_arm(newOutputDesc.dt, newInput, lastDimSizes, num, lastDimSize, newOutput,
-                eltwiseDesc.elt_mode);
-#endif
-#ifdef _USE_X86
-        } else if (IS_X86_AVX2(arch)) {
-            ret = eltwise_x86(newOutputDesc.dt, newInput, lastDimSizes, num, lastDimSize, newOutput,
-                eltwiseDesc.elt_mode);
-#endif
-        }
-    }
-    if (ret == SUCCESS && eltwiseDesc.activation_type != ACTIVATION_NULL) {
-        ActivationParamSpec p;
-        p.mode = eltwiseDesc.activation_type;
-        ret = activation_cpu(outputDesc, output, p, outputDesc, output, arch);
+        ret = eltwise_kernel_cpu(newOutputDesc.dt, newInput, lastDimSizes, num, lastDimSize,
+            newOutput, eltwiseDesc.elt_mode, arch);
     }
-    return ret;
+    return eltwise_activation_cpu(ret, eltwiseDesc, outputDesc, output, arch);
 }
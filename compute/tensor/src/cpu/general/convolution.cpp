@@ -195,7 +195,7 @@ EE convolution_general(TensorDesc inputDesc,
                 convParamSpec, (F16 *)bias, (F16 *)scale, outputDesc, (F16 *)output, activationDesc);
             break;
 #endif
-#ifdef _USE_INT8
+#if defined(_USE_INT8) && defined(_USE_FP16)
         case DT_I8:
             ret = convolution<INT8, F16, F16, F16>(inputDesc, (INT8 *)input, filterDesc,
                 (F16 *)filter, convParamSpec, (F16 *)bias, (F16 *)scale, outputDesc, (F16 *)output,
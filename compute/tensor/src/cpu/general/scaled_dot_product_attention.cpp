@@ -0,0 +1,131 @@
+// Copyright (C) 2019. Huawei Technologies Co., Ltd. All rights reserved.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include <math.h>
+#include <float.h>
+#include "cpu/general/tensor_computing_general.h"
+#include "cpu/general/general_functions.h"
+
+// every query row keeps the running max and sum of the online softmax, so the scores of a
+// row are only stored for one key tile
+template <typename T>
+static EE scaled_dot_product_attention(TensorDesc qDesc,
+    const T *q,
+    TensorDesc kDesc,
+    const T *k,
+    TensorDesc vDesc,
+    const T *v,
+    TensorDesc maskDesc,
+    const T *mask,
+    F32 scale,
+    T *output)
+{
+    if (nullptr == q || nullptr == k || nullptr == v || nullptr == output) {
+        CHECK_STATUS(NULL_POINTER);
+    }
+    U32 batch = qDesc.dims[3];
+    U32 qLength = qDesc.dims[2];
+    U32 heads = qDesc.dims[1];
+    U32 size = qDesc.dims[0];
+    U32 kLength = kDesc.dims[2];
+    U32 vSize = vDesc.dims[0];
+    U32 maskStrides[4];
+    attention_mask_strides(maskDesc, maskStrides);
+    F32 score[ATTENTION_KEY_TILE];
+    std::vector<F32> sum(vSize);
+    for (U32 b = 0; b < batch; b++) {
+        for (U32 n = 0; n < heads; n++) {
+            for (U32 i = 0; i < qLength; i++) {
+                const T *qRow = q + ((b * qLength + i) * heads + n) * size;
+                const T *maskRow = mask + b * maskStrides[3] + n * maskStrides[2] +
+                    i * maskStrides[1];
+                F32 maxValue = -FLT_MAX;
+                F32 expSum = 0;
+                memset(sum.data(), 0, vSize * sizeof(F32));
+                for (U32 j0 = 0; j0 < kLength; j0 += ATTENTION_KEY_TILE) {
+                    U32 tile = UNI_MIN(ATTENTION_KEY_TILE, kLength - j0);
+                    F32 tileMax = -FLT_MAX;
+                    for (U32 j = 0; j < tile; j++) {
+                        const T *kRow = k + ((b * kLength + j0 + j) * heads + n) * size;
+                        F32 value = 0;
+                        for (U32 d = 0; d < size; d++) {
+                            value += qRow[d] * kRow[d];
+                        }
+                        value *= scale;
+                        if (mask != nullptr) {
+                            value += maskRow[(j0 + j) * maskStrides[0]];
+                        }
+                        score[j] = value;
+                        tileMax = UNI_MAX(tileMax, value);
+                    }
+                    F32 newMax = UNI_MAX(maxValue, tileMax);
+                    F32 correction = exp(maxValue - newMax);
+                    expSum *= correction;
+                    for (U32 d = 0; d < vSize; d++) {
+                        sum[d] *= correction;
+                    }
+                    for (U32 j = 0; j < tile; j++) {
+                        const T *vRow = v + ((b * kLength + j0 + j) * heads + n) * vSize;
+                        F32 value = exp(score[j] - newMax);
+                        expSum += value;
+                        for (U32 d = 0; d < vSize; d++) {
+                            sum[d] += value * vRow[d];
+                        }
+                    }
+                    maxValue = newMax;
+                }
+                T *outputRow = output + ((b * qLength + i) * heads + n) * vSize;
+                for (U32 d = 0; d < vSize; d++) {
+                    outputRow[d] = sum[d] / expSum;
+                }
+            }
+        }
+    }
+    return SUCCESS;
+}
+
+EE scaled_dot_product_attention_general(TensorDesc qDesc,
+    const void *q,
+    TensorDesc kDesc,
+    const void *k,
+    TensorDesc vDesc,
+    const void *v,
+    TensorDesc maskDesc,
+    const void *mask,
+    ScaledDotProductAttentionParamSpec p,
+    TensorDesc outputDesc,
+    void *output)
+{
+    UNUSED(outputDesc);
+    EE ret = SUCCESS;
+    switch (qDesc.dt) {
+#ifdef _USE_FP16
+        case DT_F16: {
+            ret = scaled_dot_product_attention<F16>(qDesc, (const F16 *)q, kDesc, (const F16 *)k,
+                vDesc, (const F16 *)v, maskDesc, (const F16 *)mask, p.scale, (F16 *)output);
+            break;
+        }
+#endif
+#ifdef _USE_FP32
+        case DT_F32: {
+            ret = scaled_dot_product_attention<F32>(qDesc, (const F32 *)q, kDesc, (const F32 *)k,
+                vDesc, (const F32 *)v, maskDesc, (const F32 *)mask, p.scale, (F32 *)output);
+            break;
+        }
+#endif
+        default:
+            ret = NOT_SUPPORTED;
+            break;
+    }
+    return ret;
+}
@@ -26,6 +26,35 @@ static F32 array_max(const T *input, U32 len, U32 stride)
     return tmp;
 }
 
+// the block c of 8 channels of a pixel is at c * hw * 8
+template <typename T>
+static void softmax_nchwc8_channel(const T *input, U32 batch, U32 blocks, U32 hw, T *output)
+{
+    U32 blockStride = hw * 8;
+    for (U32 n = 0; n < batch * hw; n++) {
+        const T *in = input + (n / hw) * blocks * blockStride + (n % hw) * 8;
+        T *out = output + (n / hw) * blocks * blockStride + (n % hw) * 8;
+        F32 max_value = in[0];
+        for (U32 c = 0; c < blocks; c++) {
+            max_value = UNI_MAX(max_value, array_max<T>(in + c * blockStride, 8, 1));
+        }
+        F32 sum = 0;
+        for (U32 c = 0; c < blocks; c++) {
+            for (U32 i = 0; i < 8; i++) {
+                F32 tmp = exp(in[c * blockStride + i] - max_value);
+                sum += tmp;
+                out[c * blockStride + i] = tmp;
+            }
+        }
+        sum = 1 / sum;
+        for (U32 c = 0; c < blocks; c++) {
+            for (U32 i = 0; i < 8; i++) {
+                out[c * blockStride + i] *= sum;
+            }
+        }
+    }
+}
+
 template <typename T>
 static EE softmax(TensorDesc inputDesc, const T *input, int axis, TensorDesc outputDesc, T *output)
 {
@@ -37,25 +66,12 @@ static EE softmax(TensorDesc inputDesc, const T *input, int axis, TensorDesc out
     U32 size = tensorNumElements(inputDesc);
     axis = (axis + inputDesc.nDims) % inputDesc.nDims;
     axis = inputDesc.nDims - 1 - axis;
-    std::vector<T> buffer;
-    if (inputDesc.df == DF_NCHWC8) {
-        if (axis == 2) {
-            if (inputDesc.dims[0] != 1 || inputDesc.dims[1] != 1) {
-                buffer = std::vector<T>(size);
-                TensorDesc tmpInputDesc = inputDesc;
-                tmpInputDesc.df = DF_NCHW;
-                transformToNCHW(inputDesc, input, tmpInputDesc, buffer.data());
-                input = (const T *)(buffer.data());
-            }
-        } else {
-            for (I32 i = (int)inputDesc.nDims; i > 0; i--) {
-                inputDesc.dims[i] = inputDesc.dims[i - 1];
-            }
-            inputDesc.dims[inputDesc.nDims - 1] /= 8;
-            inputDesc.dims[0] = 8;
-            inputDesc.nDims += 1;
-            axis += 1;
-        }
+    // the other axes of NCHWC8 are given as 5D NCHW by softmax
+    if (DF_NCHWC8 == inputDesc.df) {
+        CHECK_REQUIREMENT(4 == inputDesc.nDims && 2 == axis);
+        softmax_nchwc8_channel<T>(input, inputDesc.dims[3], inputDesc.dims[2] / 8,
+            inputDesc.dims[1] * inputDesc.dims[0], output);
+        return SUCCESS;
     }
     U32 loops = inputDesc.dims[axis];
 
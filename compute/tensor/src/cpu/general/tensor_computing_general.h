@@ -156,6 +156,18 @@ EE attention_mask_general(TensorDesc inputDesc,
     TensorDesc outputDesc,
     void *output);
 
+EE scaled_dot_product_attention_general(TensorDesc qDesc,
+    const void *q,
+    TensorDesc kDesc,
+    const void *k,
+    TensorDesc vDesc,
+    const void *v,
+    TensorDesc maskDesc,
+    const void *mask,
+    ScaledDotProductAttentionParamSpec p,
+    TensorDesc outputDesc,
+    void *output);
+
 EE prelu_general(TensorDesc inputDesc,
     void *input,
     void *weight,
@@ -191,7 +191,7 @@ EE priorbox_cpu(std::vector<TensorDesc> inputDesc,
                 ars, flip, clip, vars, imageW, imageH, stepW, stepH, offset, arch);
             break;
 #endif
-#ifdef _USE_INT8
+#if defined(_USE_INT8) && defined(_USE_FP16)
         case DT_I8: {
             ret = priorbox_kernel<F16>(idt0, (F16 *)output, ih0, iw0, ih1, iw1, minsizes, maxsizes,
                 ars, flip, clip, vars, imageW, imageH, stepW, stepH, offset, arch);
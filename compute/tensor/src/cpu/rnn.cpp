@@ -164,6 +164,11 @@ EE rnn_infer_forward_tmp_bytes_cpu(TensorDesc inputDesc,
     if (nullptr == bytes) {
         CHECK_STATUS(NULL_POINTER);
     }
+#ifdef _USE_X86
+    if (IS_X86(arch)) {
+        return rnn_infer_forward_tmp_bytes_x86(inputDesc, rnnParamSpec, bytes, arch);
+    }
+#endif
     DataType idt;
     DataFormat idf;
     U32 batch, step, xDim;
@@ -201,7 +206,7 @@ EE rnncell_cpu(TensorDesc xDesc,
             tmp, rnnParamSpec, batchStrideX, batchStrideH, hDesc, currentH);
 #endif
 #ifdef _USE_X86
-    } else if (IS_X86_AVX2(arch)) {
+    } else if (IS_X86(arch)) {
         ret = rnncell_x86(xDesc, currentX, filterDesc, filter, biasDesc, bias, state, tmpBytes, tmp,
             rnnParamSpec, batchStrideX, batchStrideH, hDesc, currentH, arch);
 #endif
@@ -233,6 +238,12 @@ EE rnn_cpu(TensorDesc inputDesc,
         nullptr == output) {
         CHECK_STATUS(NULL_POINTER);
     }
+#ifdef _USE_X86
+    if (IS_X86(arch)) {
+        return rnn_x86(inputDesc, input, filterDesc, filter, biasDesc, bias, rnnParamSpec, tmpBytes,
+            tmp, outputDesc, output, arch);
+    }
+#endif
 
     DataType idt;
     DataFormat idf;
@@ -97,6 +97,10 @@ EE reshape_cpu(TensorDesc inputDesc, void *input, TensorDesc outputDesc, void *o
 EE depthwise_convolution_transform_filter_bytes_cpu(
     TensorDesc filterDesc, DepthwiseConvolutionForwardAlgorithm algorithm, U32 *bytes);
 
+// whether the NCHWC8 inputs can be computed in place with the per-channel or scalar inputs
+// broadcast to them, which keeps the output in NCHWC8
+bool eltwise_nchwc8_broadcast_cpu(std::vector<TensorDesc> inputDesc);
+
 EE eltwise_cpu(std::vector<TensorDesc> inputDesc,
     std::vector<void *> input,
     EltwiseParamSpec eltwiseDesc,
@@ -131,9 +135,14 @@ EE reduction_cpu(TensorDesc inputDesc,
     void *output,
     Arch arch);
 
+EE non_max_suppression_infer_forward_tmp_bytes_cpu(
+    std::vector<TensorDesc> inputDesc, NonMaxSuppressionParamSpec p, U32 *bytes);
+
 EE non_max_suppression_cpu(std::vector<TensorDesc> inputDesc,
     std::vector<void *> input,
     NonMaxSuppressionParamSpec nonMaxSuppressionParamSpec,
+    U32 tmpBytes,
+    void *tmp,
     TensorDesc outputDesc,
     void *output);
 
@@ -175,9 +184,14 @@ EE clip_cpu(TensorDesc inputDesc,
     void *output,
     Arch arch);
 
+EE detectionoutput_infer_forward_tmp_bytes_cpu(
+    std::vector<TensorDesc> inputDesc, DetectionOutputParamSpec p, U32 *bytes);
+
 EE detectionoutput_cpu(std::vector<TensorDesc> inputDesc,
     std::vector<void *> input,
     DetectionOutputParamSpec detectionOutputParamSpec,
+    U32 tmpBytes,
+    void *tmp,
     TensorDesc outputDesc,
     void *output);
 
@@ -273,9 +287,24 @@ EE activation_cpu(TensorDesc inputDesc,
     void *output,
     Arch arch);
 
+// output = activation(output + residual), the residual can be null
+EE residual_activation_cpu(TensorDesc outputDesc,
+    void *output,
+    const void *residual,
+    ActivationParamSpec activationDesc,
+    Arch arch);
+
+// maxOutput is the capacity of the output in boxes
+EE yolov3detectionoutput_infer_forward_tmp_bytes_cpu(std::vector<TensorDesc> inputDesc,
+    Yolov3DetectionOutputParamSpec p,
+    U32 maxOutput,
+    U32 *bytes);
+
 EE yolov3detectionoutput_cpu(std::vector<TensorDesc> inputDesc,
     std::vector<void *> input,
     Yolov3DetectionOutputParamSpec yolov3DetectionOutputParamSpec,
+    U32 tmpBytes,
+    void *tmp,
     TensorDesc outputDesc,
     void *output,
     Arch arch);
@@ -11,7 +11,152 @@
 // COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
+#include <string.h>
+#include <algorithm>
+#include <vector>
+#ifdef _USE_OPENMP
+#include <omp.h>
+#endif
+#include "thread_affinity.h"
 #include "cpu/tensor_computing_cpu.h"
+#ifdef _USE_X86
+#include "x86_avx2_expand.h"
+#endif
+
+// the rows and columns of the cache block of a 2-D transpose
+#define TRANSPOSE_BLOCK 64
+
+// Simplify the permutation before copying. The axes are ordered from the outermost, output
+// axis i reads input axis perm[i]. The axes of size 1 are removed, and the input axes that
+// are still next to each other in the output are merged into one.
+static void transpose_merge_axes(const U32 *inputDims,
+    const U32 *transposeDims,
+    int dimsNum,
+    std::vector<U32> &shape,
+    std::vector<U32> &perm)
+{
+    std::vector<int> keptIndex(dimsNum, -1);
+    std::vector<U32> keptShape;
+    for (int i = 0; i < dimsNum; i++) {
+        U32 size = inputDims[dimsNum - 1 - i];
+        if (size > 1) {
+            keptIndex[i] = keptShape.size();
+            keptShape.push_back(size);
+        }
+    }
+    std::vector<U32> runStart, runLength;
+    for (int i = 0; i < dimsNum; i++) {
+        int axis = keptIndex[transposeDims[i]];
+        if (axis < 0) {
+            continue;
+        }
+        if (runStart.size() > 0 && (U32)axis == runStart.back() + runLength.back()) {
+            runLength.back()++;
+        } else {
+            runStart.push_back(axis);
+            runLength.push_back(1);
+        }
+    }
+    U32 num = runStart.size();
+    std::vector<U32> order(num);
+    for (U32 i = 0; i < num; i++) {
+        order[i] = i;
+    }
+    std::sort(order.begin(), order.end(),
+        [&runStart](U32 a, U32 b) { return runStart[a] < runStart[b]; });
+    shape.resize(num);
+    perm.resize(num);
+    for (U32 i = 0; i < num; i++) {
+        U32 run = order[i];
+        shape[i] = 1;
+        for (U32 j = 0; j < runLength[run]; j++) {
+            shape[i] *= keptShape[runStart[run] + j];
+        }
+        perm[run] = i;
+    }
+}
+
+// dst[j * dstStride + i] = src[i * srcStride + j] for the rows x cols block at src
+template <typename T>
+static void transpose_block(
+    const T *src, U32 srcStride, T *dst, U32 dstStride, U32 rows, U32 cols)
+{
+    U32 i = 0;
+#ifdef _USE_X86
+    if (sizeof(T) == 4) {
+        for (; i + 8 <= rows; i += 8) {
+            U32 j = 0;
+            for (; j + 8 <= cols; j += 8) {
+                _mm256_transpose8x8_ps((const F32 *)(src + i * srcStride + j), srcStride,
+                    (F32 *)(dst + j * dstStride + i), dstStride);
+            }
+            for (; j < cols; j++) {
+                for (U32 k = i; k < i + 8; k++) {
+                    dst[j * dstStride + k] = src[k * srcStride + j];
+                }
+            }
+        }
+    }
+#endif
+    for (; i < rows; i++) {
+        for (U32 j = 0; j < cols; j++) {
+            dst[j * dstStride + i] = src[i * srcStride + j];
+        }
+    }
+}
+
+template <typename T>
+static void transpose_kernel(const std::vector<U32> &shape,
+    const std::vector<U32> &perm,
+    const std::vector<U32> &inputStrides,
+    const std::vector<U32> &outputStrides,
+    const T *input,
+    T *output)
+{
+    int num = shape.size();
+    // the input axis of the output rows, and the output axis of the input rows
+    U32 rowAxis = perm[num - 1];
+    int colAxis = std::find(perm.begin(), perm.end(), (U32)(num - 1)) - perm.begin();
+    U32 rows = shape[rowAxis];
+    U32 cols = shape[num - 1];
+    U32 rowBlocks = (rows + TRANSPOSE_BLOCK - 1) / TRANSPOSE_BLOCK;
+    U32 colBlocks = (cols + TRANSPOSE_BLOCK - 1) / TRANSPOSE_BLOCK;
+    U32 outer = 1;
+    for (int i = 0; i < num - 1; i++) {
+        if (i != colAxis) {
+            outer *= shape[perm[i]];
+        }
+    }
+    U32 inputRowStride = inputStrides[rowAxis];
+    U32 outputColStride = outputStrides[colAxis];
+#ifdef _USE_OPENMP
+#pragma omp parallel for num_threads(OMP_NUM_THREADS)
+#endif
+    for (U32 task = 0; task < outer * rowBlocks * colBlocks; task++) {
+        U32 cb = task % colBlocks;
+        U32 rb = task / colBlocks % rowBlocks;
+        U32 o = task / colBlocks / rowBlocks;
+        U32 inputOffset = 0, outputOffset = 0;
+        for (int i = num - 2; i >= 0; i--) {
+            if (i == colAxis) {
+                continue;
+            }
+            U32 size = shape[perm[i]];
+            U32 index = o % size;
+            o /= size;
+            inputOffset += index * inputStrides[perm[i]];
+            outputOffset += index * outputStrides[i];
+        }
+        U32 r = rb * TRANSPOSE_BLOCK;
+        U32 c = cb * TRANSPOSE_BLOCK;
+        inputOffset += r * inputRowStride + c;
+        outputOffset += c * outputColStride + r;
+        U32 blockRows = UNI_MIN(TRANSPOSE_BLOCK, rows - r);
+        U32 blockCols = UNI_MIN(TRANSPOSE_BLOCK, cols - c);
+        transpose_block<T>(input + inputOffset, inputRowStride, output + outputOffset,
+            outputColStride, blockRows, blockCols);
+    }
+}
 
 EE transpose_cpu(
     TensorDesc inputDesc, const void *input, U32 *dim, TensorDesc outputDesc, void *output)
@@ -19,6 +164,73 @@ EE transpose_cpu(
     if (nullptr == input || nullptr == output || nullptr == dim) {
         CHECK_STATUS(NULL_POINTER);
     }
-    return array_transpose(
-        inputDesc.dt, inputDesc.dims, input, outputDesc.dims, output, dim, inputDesc.nDims);
+    CHECK_REQUIREMENT(tensorNumElements(inputDesc) == tensorNumElements(outputDesc));
+    std::vector<U32> shape, perm;
+    transpose_merge_axes(inputDesc.dims, dim, inputDesc.nDims, shape, perm);
+    int num = shape.size();
+    U32 elementBytes = bytesOf(inputDesc.dt);
+    if (num <= 1) {
+        UNI_memcpy(output, input, tensorNumBytes(inputDesc));
+        return SUCCESS;
+    }
+    std::vector<U32> inputStrides(num), outputStrides(num);
+    inputStrides[num - 1] = 1;
+    outputStrides[num - 1] = 1;
+    for (int i = num - 2; i >= 0; i--) {
+        inputStrides[i] = inputStrides[i + 1] * shape[i + 1];
+        outputStrides[i] = outputStrides[i + 1] * shape[perm[i + 1]];
+    }
+
+    const U8 *inputPtr = (const U8 *)input;
+    U8 *outputPtr = (U8 *)output;
+    if (perm[num - 1] == (U32)(num - 1)) {
+        // the innermost axis is kept, copy it as a whole
+        U32 runBytes = shape[num - 1] * elementBytes;
+        U32 inner = shape[perm[num - 2]];
+        U32 innerStride = inputStrides[perm[num - 2]] * elementBytes;
+        U32 outer = tensorNumElements(inputDesc) / shape[num - 1] / inner;
+#ifdef _USE_OPENMP
+#pragma omp parallel for num_threads(OMP_NUM_THREADS)
+#endif
+        for (U32 o = 0; o < outer; o++) {
+            U32 inputOffset = 0;
+            U32 index = o;
+            for (int i = num - 3; i >= 0; i--) {
+                U32 size = shape[perm[i]];
+                inputOffset += index % size * inputStrides[perm[i]];
+                index /= size;
+            }
+            const U8 *src = inputPtr + inputOffset * elementBytes;
+            U8 *dst = outputPtr + o * inner * runBytes;
+            for (U32 i = 0; i < inner; i++, src += innerStride, dst += runBytes) {
+                memcpy(dst, src, runBytes);
+            }
+        }
+        return SUCCESS;
+    }
+    EE ret = SUCCESS;
+    switch (elementBytes) {
+        case 1:
+            transpose_kernel<U8>(
+                shape, perm, inputStrides, outputStrides, (const U8 *)input, (U8 *)output);
+            break;
+        case 2:
+            transpose_kernel<unsigned short>(
+                shape, perm, inputStrides, outputStrides, (const unsigned short *)input,
+                (unsigned short *)output);
+            break;
+        case 4:
+            transpose_kernel<U32>(
+                shape, perm, inputStrides, outputStrides, (const U32 *)input, (U32 *)output);
+            break;
+        case 8:
+            transpose_kernel<I64>(
+                shape, perm, inputStrides, outputStrides, (const I64 *)input, (I64 *)output);
+            break;
+        default:
+            ret = array_transpose(inputDesc.dt, inputDesc.dims, input, outputDesc.dims, output,
+                dim, inputDesc.nDims);
+            break;
+    }
+    return ret;
 }
@@ -12,10 +12,14 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include <string.h>
+#include <vector>
 #include "cpu/x86/tensor_computing_x86.h"
 #ifdef _USE_FP32
 #include "cpu/x86/fp32/tensor_computing_fp32.h"
 #endif
+#ifdef _USE_INT8
+#include "cpu/x86/int8/tensor_computing_int8.h"
+#endif
 #include "ut_util.h"
 
 EE convolution_infer_forward_algorithm_x86(TensorDesc inputDesc,
@@ -30,7 +34,6 @@ EE convolution_infer_forward_algorithm_x86(TensorDesc inputDesc,
     UNUSED(outputDesc);
     UNUSED(convParamSpec);
     UNUSED(policy);
-    UNUSED(targetDataType);
     if (nullptr == algorithm) {
         CHECK_STATUS(NULL_POINTER);
     }
@@ -54,6 +57,14 @@ EE convolution_infer_forward_algorithm_x86(TensorDesc inputDesc,
     U32 paddingL = convParamSpec.padding_left;
     U32 paddingR = convParamSpec.padding_right;
 
+#ifdef _USE_INT8
+    // the other int8 convolutions fall back to FP32
+    if (targetDataType == DT_I8 && idf == DF_NCHWC8 && ic % 8 == 0 && group == 1) {
+        *algorithm = CONVOLUTION_ALGORITHM_GEMM;
+        return SUCCESS;
+    }
+#endif
+
     if ((idf != DF_NCHWC8) || (ic / group % 8 != 0)) {
         *algorithm = CONVOLUTION_ALGORITHM_GEMM_ICNCHW;
         return SUCCESS;
@@ -64,10 +75,120 @@ EE convolution_infer_forward_algorithm_x86(TensorDesc inputDesc,
         return SUCCESS;
     }
 
+    // Winograd F(4x4, 3x3) is faster than the direct kernels when the GEMMs of the 36
+    // positions are big enough, it is slower on few channels or few 4x4 tiles.
+    U32 tiles = (oh + 3) / 4 * ((ow + 3) / 4);
+    if (targetDataType == DT_F32 && fh == 3 && fw == 3 && strideH == 1 && strideW == 1 &&
+        convParamSpec.dilatedRate_h == 1 && convParamSpec.dilatedRate_w == 1 && group == 1 &&
+        ic >= 64 && oc >= 64 && oc % 8 == 0 && tiles >= 16) {
+        *algorithm = CONVOLUTION_ALGORITHM_WINOGRAD;
+        return SUCCESS;
+    }
+
     *algorithm = CONVOLUTION_ALGORITHM_DIRECT;
     return SUCCESS;
 }
 
+EE convolution_tune_forward_algorithm_x86(TensorDesc inputDesc,
+    TensorDesc filterDesc,
+    TensorDesc outputDesc,
+    ConvolutionParamSpec convParamSpec,
+    DataType targetDataType,
+    ActivationParamSpec activationDesc,
+    ConvolutionForwardAlgorithm *algorithm,
+    F32 *time,
+    Arch arch)
+{
+    if (nullptr == algorithm || nullptr == time) {
+        CHECK_STATUS(NULL_POINTER);
+    }
+    *time = 0;
+    ConvolutionForwardAlgorithm fastest = CONVOLUTION_ALGORITHM_NULL;
+    CHECK_STATUS(convolution_infer_forward_algorithm_x86(inputDesc, filterDesc, outputDesc,
+        convParamSpec, CONVOLUTION_FASTEST, &fastest, targetDataType));
+    *algorithm = fastest;
+
+    // the NCHWC8 FP32 convolutions can use the direct kernels, and the pointwise or Winograd
+    // kernels on the shapes that they support, the others have only one algorithm
+    DataType idt, fdt, odt;
+    DataFormat idf, fdf, odf;
+    U32 in, ic, ih, iw;
+    U32 fn, fc, fh, fw;
+    U32 on, oc, oh, ow;
+    CHECK_STATUS(tensor4dGet(inputDesc, &idt, &idf, &in, &ic, &ih, &iw));
+    CHECK_STATUS(tensor4dGet(filterDesc, &fdt, &fdf, &fn, &fc, &fh, &fw));
+    CHECK_STATUS(tensor4dGet(outputDesc, &odt, &odf, &on, &oc, &oh, &ow));
+    std::vector<ConvolutionForwardAlgorithm> candidates;
+    if (idt == DT_F32 && fdt == DT_F32 &&
+        (fastest == CONVOLUTION_ALGORITHM_DIRECT || fastest == CONVOLUTION_ALGORITHM_POINTWISE ||
+            fastest == CONVOLUTION_ALGORITHM_WINOGRAD)) {
+        bool stride1 = convParamSpec.stride_h == 1 && convParamSpec.stride_w == 1;
+        candidates.push_back(CONVOLUTION_ALGORITHM_DIRECT);
+        if (stride1 && fh == 1 && fw == 1) {
+            candidates.push_back(CONVOLUTION_ALGORITHM_POINTWISE);
+        }
+        if (stride1 && fh == 3 && fw == 3 && convParamSpec.dilatedRate_h == 1 &&
+            convParamSpec.dilatedRate_w == 1 && convParamSpec.group == 1 && oc % 8 == 0) {
+            candidates.push_back(CONVOLUTION_ALGORITHM_WINOGRAD);
+        }
+    }
+    if (candidates.size() <= 1) {
+        return SUCCESS;
+    }
+
+    U32 filterBytes = 0;
+    U32 tmpBytes = 0;
+    for (U32 i = 0; i < candidates.size(); i++) {
+        U32 bytes = 0;
+        CHECK_STATUS(convolution_transform_filter_bytes_x86(
+            filterDesc, convParamSpec, candidates[i], &bytes));
+        filterBytes = UNI_MAX(filterBytes, bytes);
+        CHECK_STATUS(convolution_infer_forward_tmp_bytes_x86(
+            inputDesc, filterDesc, outputDesc, convParamSpec, candidates[i], &bytes));
+        tmpBytes = UNI_MAX(tmpBytes, bytes);
+    }
+    TensorDesc biasDesc = tensor1d(fdt, oc);
+    U8 *input = ut_input_v(tensorNumElements(inputDesc), idt, UT_INIT_RANDOM);
+    U8 *filter = ut_input_v(tensorNumElements(filterDesc), fdt, UT_INIT_RANDOM);
+    U8 *bias = ut_input_v(oc, fdt, UT_INIT_RANDOM);
+    U8 *filterTransformed = (U8 *)malloc(filterBytes);
+    U8 *tmp = (U8 *)malloc(tmpBytes);
+    U8 *output = (U8 *)malloc(tensorNumBytes(outputDesc));
+
+    // the first run warms up the caches, the best of the next runs is the latency
+    const int loops = 3;
+    F32 timeMin = 0;
+    for (U32 i = 0; i < candidates.size(); i++) {
+        TensorDesc ftmDesc;
+        CHECK_STATUS(convolution_transform_filter_x86(
+            filterDesc, filter, convParamSpec, candidates[i], &ftmDesc, filterTransformed));
+        F32 timeBest = 0;
+        for (int j = 0; j <= loops; j++) {
+            double timeStart = ut_time_ms();
+            CHECK_STATUS(convolution_x86(inputDesc, input, ftmDesc, filterTransformed,
+                convParamSpec, candidates[i], biasDesc, nullptr, biasDesc, bias, tmpBytes, tmp,
+                outputDesc, output, nullptr, activationDesc, arch));
+            F32 timeRun = ut_time_ms() - timeStart;
+            if (j == 1 || (j > 1 && timeRun < timeBest)) {
+                timeBest = timeRun;
+            }
+        }
+        UNI_DEBUG_LOG("convolution algorithm %d takes %f ms\n", candidates[i], timeBest);
+        if (i == 0 || timeBest < timeMin) {
+            timeMin = timeBest;
+            *algorithm = candidates[i];
+        }
+    }
+    free(input);
+    free(filter);
+    free(bias);
+    free(filterTransformed);
+    free(tmp);
+    free(output);
+    *time = timeMin;
+    return SUCCESS;
+}
+
 EE convolution_transform_filter_bytes_x86(TensorDesc filterDesc,
     ConvolutionParamSpec convParamSpec,
     ConvolutionForwardAlgorithm algorithm,
@@ -97,6 +218,13 @@ EE convolution_transform_filter_bytes_x86(TensorDesc filterDesc,
         case CONVOLUTION_ALGORITHM_POINTWISE:
             *bytes = fnPadding * fcPadding;
             break;
+        case CONVOLUTION_ALGORITHM_WINOGRAD:
+            *bytes = fnPadding * fcPadding * 36;
+            break;
+#ifdef _USE_INT8
+        case CONVOLUTION_ALGORITHM_GEMM:
+            return convolution_transform_filter_bytes_int8(filterDesc, bytes);
+#endif
         default:
             return NOT_SUPPORTED;
     }
@@ -120,6 +248,13 @@ EE convolution_transform_filter_x86(TensorDesc filterDesc,
                 algorithm, ftmDesc, (F32 *)filterTransformed);
             break;
         }
+#endif
+#ifdef _USE_INT8
+        case DT_I8: {
+            ret = convolution_transform_filter_int8(
+                filterDesc, (const INT8 *)filter, ftmDesc, (INT8 *)filterTransformed);
+            break;
+        }
 #endif
         default:
             ret = NOT_SUPPORTED;
@@ -143,6 +278,13 @@ EE convolution_infer_forward_tmp_bytes_x86(TensorDesc inputDesc,
                 inputDesc, filterDesc, outputDesc, convParamSpec, algorithm, bytes);
             break;
         }
+#endif
+#ifdef _USE_INT8
+        case DT_I8: {
+            ret = convolution_infer_forward_tmp_bytes_int8(
+                inputDesc, filterDesc, outputDesc, convParamSpec, bytes);
+            break;
+        }
 #endif
         default:
             CHECK_STATUS(NOT_SUPPORTED);
@@ -166,11 +308,22 @@ EE convolution_x86(TensorDesc inputDesc,
     void *tmp,
     TensorDesc outputDesc,
     void *output,
+    const void *residual,
     ActivationParamSpec activationDesc,
     Arch arch)
 {
     UNUSED(scaleDesc);
     UNUSED(scale);
+#ifdef _USE_INT8
+    if (filterDesc.dt == DT_I8) {
+        if (residual != nullptr) {
+            return NOT_SUPPORTED;
+        }
+        return convolution_int8(inputDesc, input, filterDesc, (const INT8 *)filter, (F32 *)scale,
+            convParamSpec, biasDesc, (const F32 *)bias, tmpBytes, tmp, outputDesc,
+            (F32 *)output, activationDesc, arch);
+    }
+#endif
     U32 group = convParamSpec.group;
     U32 batchAxis = inputDesc.nDims - 1;
     U32 dataChannelAxis = inputDesc.nDims - 2;
@@ -210,12 +363,17 @@ EE convolution_x86(TensorDesc inputDesc,
         const void *tmpFilter = (U8 *)filter + g * tensorNumBytes(paddingFilterDesc);
         const void *tmpBias = (U8 *)bias + g * tensorNumBytes(tmpBiasDesc);
         void *tmpOutput = (U8 *)output + g * tensorNumBytes(tmpOutputDesc);
+        const void *tmpResidual = nullptr;
+        if (residual != nullptr) {
+            tmpResidual = (const U8 *)residual + g * tensorNumBytes(tmpOutputDesc);
+        }
         switch (filterDesc.dt) {
 #ifdef _USE_FP32
             case DT_F32: {
                 ret = convolution_fp32(tmpInputDesc, (F32 *)tmpInput, tmpFilterDesc,
                     (F32 *)tmpFilter, convParamSpec, algorithm, tmpBiasDesc, (F32 *)tmpBias,
-                    tmpBytes, tmp, tmpOutputDesc, (F32 *)tmpOutput, activationDesc, arch);
+                    tmpBytes, tmp, tmpOutputDesc, (F32 *)tmpOutput, (const F32 *)tmpResidual,
+                    activationDesc, arch);
                 break;
             }
 #endif
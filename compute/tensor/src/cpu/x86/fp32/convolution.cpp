@@ -15,6 +15,7 @@
 #include "error.h"
 #include "types.h"
 
+#include "cpu/cpu_functions_template.h"
 #include "cpu/x86/fp32/tensor_computing_fp32.h"
 
 EE convolution_infer_forward_tmp_bytes_fp32(TensorDesc inputDesc,
@@ -57,6 +58,12 @@ EE convolution_infer_forward_tmp_bytes_fp32(TensorDesc inputDesc,
         case CONVOLUTION_ALGORITHM_GEMM_ICNCHW:
             *bytes = 0;
             break;
+        case CONVOLUTION_ALGORITHM_WINOGRAD: {
+            // the transformed input and output of a block of tiles, and the packed input of GEMM
+            U32 tiles = UNI_MIN((oh + 3) / 4 * ((ow + 3) / 4), WINOGRAD_TILE_BLOCK);
+            *bytes = 36 * tiles * (icPadding + oc) + tiles * icPadding;
+            break;
+        }
         default:
             ret = NOT_MATCH;
             break;
@@ -85,10 +92,10 @@ EE convolution_fp32(TensorDesc inputDesc,
     void *tmp,
     TensorDesc outputDesc,
     F32 *output,
+    const F32 *residual,
     ActivationParamSpec activationDesc,
     Arch arch)
 {
-    UNUSED(arch);
     if (nullptr == input || nullptr == filter || nullptr == output || nullptr == bias ||
         nullptr == tmp) {
         CHECK_STATUS(NULL_POINTER);
@@ -112,23 +119,60 @@ EE convolution_fp32(TensorDesc inputDesc,
         CHECK_STATUS(NOT_MATCH);
     }
 
+    // the direct kernels add the residual to the blocks they have just written, the other
+    // algorithms and the expensive activations are left to a pass over the whole output
+    bool blockEpilogue = (residual != nullptr &&
+        (algorithm == CONVOLUTION_ALGORITHM_DIRECT ||
+            algorithm == CONVOLUTION_ALGORITHM_POINTWISE));
+    ActivationParamSpec kernelActivationDesc = activationDesc;
+    ActivationParamSpec postActivationDesc = activationDesc;
+    if (residual == nullptr) {
+        postActivationDesc.mode = ACTIVATION_NULL;
+    } else if (blockEpilogue && is_block_activation(activationDesc.mode)) {
+        postActivationDesc.mode = ACTIVATION_NULL;
+    } else {
+        kernelActivationDesc.mode = ACTIVATION_NULL;
+    }
     EE ret = SUCCESS;
     switch (algorithm) {
+        // the AVX-512 kernels use the same filter layouts, so only the arch selects them
         case CONVOLUTION_ALGORITHM_DIRECT:
+            if (IS_X86_AVX512(arch)) {
+                ret = convolution_direct_avx512(inputDesc, input, filterDesc, filter,
+                    convParamSpec, biasDesc, bias, tmpBytes, tmp, outputDesc, output, residual,
+                    kernelActivationDesc);
+                break;
+            }
             ret = convolution_direct(inputDesc, input, filterDesc, filter, convParamSpec, biasDesc,
-                bias, tmpBytes, tmp, outputDesc, output, activationDesc);
+                bias, tmpBytes, tmp, outputDesc, output, residual, kernelActivationDesc);
             break;
         case CONVOLUTION_ALGORITHM_POINTWISE:
+            if (IS_X86_AVX512(arch)) {
+                ret = convolution_1x1_direct_avx512(inputDesc, input, filterDesc, filter,
+                    convParamSpec, bias, tmpBytes, tmp, outputDesc, output, residual,
+                    kernelActivationDesc);
+                break;
+            }
             ret = convolution_1x1_direct(inputDesc, input, filterDesc, filter, convParamSpec, bias,
-                tmpBytes, tmp, outputDesc, output, activationDesc);
+                tmpBytes, tmp, outputDesc, output, residual, kernelActivationDesc);
             break;
         case CONVOLUTION_ALGORITHM_GEMM_ICNCHW:
             ret = convolution_direct_nchw(inputDesc, input, filterDesc, filter, convParamSpec,
-                biasDesc, bias, tmpBytes, tmp, outputDesc, output, activationDesc);
+                biasDesc, bias, tmpBytes, tmp, outputDesc, output, kernelActivationDesc);
+            break;
+        case CONVOLUTION_ALGORITHM_WINOGRAD:
+            ret = convolution_winograd(inputDesc, input, filterDesc, filter, convParamSpec,
+                biasDesc, bias, tmpBytes, tmp, outputDesc, output, kernelActivationDesc, arch);
             break;
         default:
             ret = NOT_SUPPORTED;
             break;
     }
+    if (ret == SUCCESS && residual != nullptr && !blockEpilogue) {
+        convolution_epilogue_fp32(output, residual, 0, on * oc, oh * ow, 0, oh * ow,
+            postActivationDesc);
+    } else if (ret == SUCCESS && postActivationDesc.mode != ACTIVATION_NULL) {
+        ret = activation_fp32(output, on * oc * oh * ow, postActivationDesc, output);
+    }
     return ret;
 }
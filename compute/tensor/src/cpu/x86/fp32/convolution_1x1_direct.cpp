@@ -1591,6 +1591,7 @@ EE convolution_1x1_direct(TensorDesc inputDesc,
     void *tmp,
     TensorDesc outputDesc,
     F32 *outArray,
+    const F32 *residualArray,
     ActivationParamSpec activationDesc)
 {
     UNUSED(tmpBytes);
@@ -1644,6 +1645,12 @@ EE convolution_1x1_direct(TensorDesc inputDesc,
 
     U32 hwBlockNums = (ohow + block_hw_dim - 1) / block_hw_dim;
 
+    // the residual is added before the activation, so the kernels only add the bias
+    ActivationParamSpec epilogueDesc = activationDesc;
+    if (residualArray != nullptr) {
+        activationDesc.mode = ACTIVATION_NULL;
+    }
+
     if ((paddingT != 0) || (paddingB != 0) || (paddingL != 0) || (paddingR != 0)) {
         __m256 zero = _mm256_set1_ps(0.);
         switch (activationDesc.mode) {
@@ -1711,6 +1718,10 @@ EE convolution_1x1_direct(TensorDesc inputDesc,
                                     calI, curW, calO, curB, oStep, store, icSize, fStep);
                             }
                         }
+                        if (residualArray != nullptr && icb + icSize == icPadding) {
+                            convolution_epilogue_fp32(outArray, residualArray, ocbb,
+                                ocbb + ocBlocking, ohow, hw, hwSize, epilogueDesc);
+                        }
                     }
                 } else {
 #ifdef _USE_OPENMP
@@ -1744,12 +1755,19 @@ EE convolution_1x1_direct(TensorDesc inputDesc,
                                     calI, curW, calO, curB, oStep, store, icSize, fStep);
                             }
                         }
+                        if (residualArray != nullptr && icb + icSize == icPadding) {
+                            convolution_epilogue_fp32(outArray, residualArray, ocbb,
+                                ocbb + ocBlocking, ohow, h * ow, ow, epilogueDesc);
+                        }
                     }
                 }
             }
         }
         inArray += ic * ih * iw;
         outArray += oc * oh * ow;
+        if (residualArray != nullptr) {
+            residualArray += oc * oh * ow;
+        }
     }
     return SUCCESS;
 }
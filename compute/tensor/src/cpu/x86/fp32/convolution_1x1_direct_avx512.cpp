@@ -0,0 +1,273 @@
+// Copyright (C) 2019. Huawei Technologies Co., Ltd. All rights reserved.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "sys.h"
+#include "error.h"
+#include "types.h"
+#include "x86_avx512_expand.h"
+
+#include "cpu/x86/fp32/tensor_computing_fp32.h"
+
+#define UNROLL_HW 12
+#define SIMDW 8
+#define BLOCK_IC_DIM 128
+#define BLOCK_OC_DIM 96
+#define BLOCK_HW_DIM 128
+#define align_addr(addr, unit) (((uintptr_t)addr + unit - 1) / unit * unit)
+
+typedef void (*kernel_func)(const F32 *curI,
+    const F32 *curW,
+    F32 *curO,
+    const F32 *curB,
+    U32 oStep,
+    U32 store,
+    U32 ic,
+    U32 fStep,
+    U32 ocSize);
+
+// Compute P pixels and ocSize = 16 * NV (- 8 if HALF) output channels of a pointwise
+// convolution, the filter is in NCHWCxN24 or NCHWCxN32 layout and ic is a multiple of 8.
+template <U32 P, U32 NV, bool HALF>
+AVX512_TARGET void avx512_pointwise_kernel(const F32 *curI,
+    const F32 *curW,
+    F32 *curO,
+    const F32 *curB,
+    U32 oStep,
+    U32 store,
+    U32 ic,
+    U32 fStep,
+    U32 ocSize)
+{
+    const __mmask16 lastMask = HALF ? 0xFF : 0xFFFF;
+    __m512 c[P][NV];
+    if (store & 1) {
+        for (U32 p = 0; p < P; p++) {
+            for (U32 j = 0; j < NV; j++) {
+                const F32 *lo = curO + 2 * j * oStep + p * SIMDW;
+                if (HALF && j == NV - 1) {
+                    c[p][j] = _mm512_maskz_loadu_ps(lastMask, lo);
+                } else {
+                    c[p][j] = _mm512_loadu_2x256_ps(lo, lo + oStep);
+                }
+            }
+        }
+    } else {
+        for (U32 j = 0; j < NV; j++) {
+            __m512 b = _mm512_maskz_loadu_ps((j == NV - 1) ? lastMask : 0xFFFF, curB + j * 16);
+            for (U32 p = 0; p < P; p++) {
+                c[p][j] = b;
+            }
+        }
+    }
+    for (U32 icb = 0; icb < ic; icb += SIMDW) {
+        for (U32 ci = 0; ci < SIMDW; ci++) {
+            __m512 wv[NV];
+            for (U32 j = 0; j < NV; j++) {
+                wv[j] = (HALF && j == NV - 1) ? _mm512_loadu_256_ps(curW + j * 16)
+                                              : _mm512_loadu_ps(curW + j * 16);
+            }
+            for (U32 p = 0; p < P; p++) {
+                __m512 a = _mm512_set1_ps(curI[p * SIMDW + ci]);
+                for (U32 j = 0; j < NV; j++) {
+                    c[p][j] = _mm512_fmadd_ps(a, wv[j], c[p][j]);
+                }
+            }
+            curW += ocSize;
+        }
+        curI += fStep;
+    }
+    for (U32 p = 0; p < P; p++) {
+        for (U32 j = 0; j < NV; j++) {
+            F32 *lo = curO + 2 * j * oStep + p * SIMDW;
+            __m512 x = _mm512_activate_ps(c[p][j], store >> 1);
+            if (HALF && j == NV - 1) {
+                _mm512_mask_storeu_ps(lo, lastMask, x);
+            } else {
+                _mm512_storeu_2x256_ps(lo, lo + oStep, x);
+            }
+        }
+    }
+}
+
+template <U32 NV, bool HALF>
+inline kernel_func avx512_pointwise_kernel_select(U32 p)
+{
+    kernel_func kernel[UNROLL_HW] = {avx512_pointwise_kernel<1, NV, HALF>,
+        avx512_pointwise_kernel<2, NV, HALF>, avx512_pointwise_kernel<3, NV, HALF>,
+        avx512_pointwise_kernel<4, NV, HALF>, avx512_pointwise_kernel<5, NV, HALF>,
+        avx512_pointwise_kernel<6, NV, HALF>, avx512_pointwise_kernel<7, NV, HALF>,
+        avx512_pointwise_kernel<8, NV, HALF>, avx512_pointwise_kernel<9, NV, HALF>,
+        avx512_pointwise_kernel<10, NV, HALF>, avx512_pointwise_kernel<11, NV, HALF>,
+        avx512_pointwise_kernel<12, NV, HALF>};
+    return kernel[p - 1];
+}
+
+// ocSize is 8, 16, 24 or 32
+inline kernel_func avx512_pointwise_kernel_select(U32 ocSize, U32 p)
+{
+    kernel_func kernel = nullptr;
+    switch (ocSize) {
+        case 8:
+            kernel = avx512_pointwise_kernel_select<1, true>(p);
+            break;
+        case 16:
+            kernel = avx512_pointwise_kernel_select<1, false>(p);
+            break;
+        case 24:
+            kernel = avx512_pointwise_kernel_select<2, true>(p);
+            break;
+        default:
+            kernel = avx512_pointwise_kernel_select<2, false>(p);
+            break;
+    }
+    return kernel;
+}
+
+EE convolution_1x1_direct_avx512(TensorDesc inputDesc,
+    F32 *inArray,
+    TensorDesc filterDesc,
+    const F32 *filterArray,
+    ConvolutionParamSpec convParamSpec,
+    const F32 *biasArray,
+    U32 tmpBytes,
+    void *tmp,
+    TensorDesc outputDesc,
+    F32 *outArray,
+    const F32 *residualArray,
+    ActivationParamSpec activationDesc)
+{
+    UNUSED(tmpBytes);
+    DataType idt, odt, fdt;
+    DataFormat idf, odf, fdf;
+    U32 in, ic, ih, iw;
+    U32 fn, fc, fh, fw;
+    U32 on, oc, oh, ow;
+    CHECK_STATUS(tensor4dGet(inputDesc, &idt, &idf, &in, &ic, &ih, &iw));
+    CHECK_STATUS(tensor4dGet(filterDesc, &fdt, &fdf, &fn, &fc, &fh, &fw));
+    CHECK_STATUS(tensor4dGet(outputDesc, &odt, &odf, &on, &oc, &oh, &ow));
+
+    if (((fdf != DF_NCHWCxN24) && (fdf != DF_NCHWCxN32)) || (idf != DF_NCHWC8)) {
+        CHECK_STATUS(NOT_MATCH);
+    }
+
+    U32 paddingT = convParamSpec.padding_top;
+    U32 paddingB = convParamSpec.padding_bottom;
+    U32 paddingL = convParamSpec.padding_left;
+    U32 paddingR = convParamSpec.padding_right;
+    bool padding = (paddingT != 0) || (paddingB != 0) || (paddingL != 0) || (paddingR != 0);
+
+    F32 *btmp = (F32 *)align_addr(tmp, 32);
+    filterArray = (F32 *)align_addr(filterArray, 32);
+
+    U32 ohow = oh * ow;
+    U32 oStep = ohow * SIMDW;
+    U32 fStep = ih * iw * SIMDW;
+    U32 icPadding = (ic + 8 - 1) / 8 * 8;
+    U32 unroll_oc_array[4] = {8, 16, 24, 32};
+    U32 unroll_oc = 24;
+    if ((oc % 24 != 0) && (oc % 32 == 0)) {
+        unroll_oc = 32;
+    }
+
+#ifdef _USE_OPENMP
+    U32 alpha = (ohow + OMP_NUM_THREADS * BLOCK_HW_DIM - 1) / (OMP_NUM_THREADS * BLOCK_HW_DIM);
+    U32 block_hw_dim = (ohow + OMP_NUM_THREADS * alpha - 1) / (OMP_NUM_THREADS * alpha);
+#else
+    U32 block_hw_dim = BLOCK_HW_DIM;
+#endif
+    U32 hwBlockNums = (ohow + block_hw_dim - 1) / block_hw_dim;
+
+    // the residual is added before the activation, so the kernels only add the bias
+    ActivationParamSpec epilogueDesc = activationDesc;
+    if (residualArray != nullptr) {
+        activationDesc.mode = ACTIVATION_NULL;
+    }
+
+    // the output of padded pixels is the activated bias
+    if (padding) {
+        for (U32 ocb = 0; ocb < oc; ocb++) {
+            F32 value = biasArray[ocb];
+            if (activationDesc.mode == ACTIVATION_RELU) {
+                value = UNI_MAX(value, 0);
+            } else if (activationDesc.mode == ACTIVATION_RELU6) {
+                value = UNI_MIN(UNI_MAX(value, 0), 6);
+            } else if (activationDesc.mode != ACTIVATION_NULL) {
+                return NOT_SUPPORTED;
+            }
+            btmp[ocb] = value;
+        }
+    }
+
+    for (U32 n = 0; n < in; ++n) {
+        U32 ocBlocking = 0, icSize = 0;
+        for (U32 ocbb = 0; ocbb < oc; ocbb += ocBlocking) {
+            ocBlocking = UNI_MIN(oc - ocbb, BLOCK_OC_DIM);
+            for (U32 icb = 0; icb < icPadding; icb += icSize) {
+                icSize = UNI_MIN(icPadding - icb, BLOCK_IC_DIM);
+                U32 store = (icb > 0);
+                if (icb + icSize == icPadding) {
+                    store |= U32(activationDesc.mode) << 1;
+                }
+                F32 *curI = inArray + icb * ih * iw;
+                U32 rowNums = padding ? oh : hwBlockNums;
+#ifdef _USE_OPENMP
+#pragma omp parallel for num_threads(OMP_NUM_THREADS)
+#endif
+                for (U32 rIdx = 0; rIdx < rowNums; ++rIdx) {
+                    // a block of pixels, or an output row if there is padding
+                    U32 hw = padding ? rIdx * ow : rIdx * block_hw_dim;
+                    U32 hwSize = padding ? ow : UNI_MIN(block_hw_dim, ohow - hw);
+                    U32 ocSize = 0;
+                    for (U32 ocb = ocbb; ocb < ocbb + ocBlocking; ocb += ocSize) {
+                        ocSize = UNI_MIN(ocbb + ocBlocking - ocb, unroll_oc);
+                        ocSize = unroll_oc_array[(ocSize >> 3) - 1];
+                        const F32 *curW = filterArray + ocb * icPadding + icb * ocSize;
+                        F32 *curO = outArray + ocb * ohow;
+                        U32 ihwSize = 0;
+                        for (U32 ihw = hw; ihw < hw + hwSize; ihw += ihwSize) {
+                            ihwSize = UNI_MIN(hw + hwSize - ihw, UNROLL_HW);
+                            const F32 *calI = curI + ihw * SIMDW;
+                            if (padding) {
+                                I32 h = rIdx - paddingT;
+                                I32 w = ihw - hw - paddingL;
+                                if (h < 0 || h >= (I32)ih || w < 0 || w >= (I32)iw) {
+                                    for (U32 oci = 0; oci < ocSize; oci++) {
+                                        curO[(oci / 8) * oStep + ihw * SIMDW + oci % 8] =
+                                            btmp[ocb + oci];
+                                    }
+                                    ihwSize = 1;
+                                    continue;
+                                }
+                                ihwSize = UNI_MIN(ihwSize, iw - w);
+                                calI = curI + (h * iw + w) * SIMDW;
+                            }
+                            avx512_pointwise_kernel_select(ocSize, ihwSize)(calI, curW,
+                                curO + ihw * SIMDW, biasArray + ocb, oStep, store, icSize, fStep,
+                                ocSize);
+                        }
+                    }
+                    if (residualArray != nullptr && icb + icSize == icPadding) {
+                        convolution_epilogue_fp32(outArray, residualArray, ocbb,
+                            ocbb + ocBlocking, ohow, hw, hwSize, epilogueDesc);
+                    }
+                }
+            }
+        }
+        inArray += ic * ih * iw;
+        outArray += oc * oh * ow;
+        if (residualArray != nullptr) {
+            residualArray += oc * oh * ow;
+        }
+    }
+    return SUCCESS;
+}
@@ -581,6 +581,7 @@ EE convolution_direct(TensorDesc inputDesc,
     void *tmp,
     TensorDesc outputDesc,
     F32 *outArray,
+    const F32 *residualArray,
     ActivationParamSpec activationDesc)
 {
     UNUSED(biasDesc);
@@ -595,9 +596,20 @@ EE convolution_direct(TensorDesc inputDesc,
     CHECK_STATUS(tensor4dGet(filterDesc, &fdt, &fdf, &fn, &fc, &fh, &fw));
     CHECK_STATUS(tensor4dGet(outputDesc, &odt, &odf, &on, &oc, &oh, &ow));
 
+    // the residual is added before the activation, so the kernels only add the bias
+    ActivationParamSpec epilogueDesc = activationDesc;
+    if (residualArray != nullptr) {
+        activationDesc.mode = ACTIVATION_NULL;
+    }
+
     if ((2 == fh) && (2 == fw)) {
-        return convolution_2x2_direct(inputDesc, inArray, filterDesc, filterArray, convParamSpec,
+        EE ret = convolution_2x2_direct(inputDesc, inArray, filterDesc, filterArray, convParamSpec,
             biasDesc, biasArray, tmpBytes, tmp, outputDesc, outArray, activationDesc);
+        if (residualArray != nullptr) {
+            convolution_epilogue_fp32(
+                outArray, residualArray, 0, on * oc, oh * ow, 0, oh * ow, epilogueDesc);
+        }
+        return ret;
     }
 
     U32 strideH = convParamSpec.stride_h;
@@ -708,6 +720,10 @@ EE convolution_direct(TensorDesc inputDesc,
                                 store, curB, dw, in_1, in_2);
                         }
                     }
+                    if (residualArray != nullptr && icbb + private_icSize == ic) {
+                        convolution_epilogue_fp32(outArray, residualArray, ocb, ocb + ocSize,
+                            ohow, hw, hwSize, epilogueDesc);
+                    }
                 }
             }
 #ifdef _USE_OPENMP
@@ -715,6 +731,9 @@ EE convolution_direct(TensorDesc inputDesc,
 #endif
         inArray += ic * ih * iw;
         outArray += oc * oh * ow;
+        if (residualArray != nullptr) {
+            residualArray += oc * oh * ow;
+        }
     }
     return SUCCESS;
 }
@@ -0,0 +1,263 @@
+// Copyright (C) 2019. Huawei Technologies Co., Ltd. All rights reserved.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "sys.h"
+#include "error.h"
+#include "types.h"
+#include "x86_avx512_expand.h"
+
+#include "cpu/x86/fp32/tensor_computing_fp32.h"
+#include "cpu/x86/fp32/transform_functions_fp32.h"
+
+#define UNROLL_W 12
+#define BLOCK_OC_DIM 32
+#define BLOCK_IC_DIM 32
+#define BLOCK_HW_DIM 128
+#define align_addr(addr, unit) (((uintptr_t)addr + unit - 1) / unit * unit)
+
+typedef void (*kernel_func)(const F32 *curI,
+    const F32 *curW,
+    F32 *curO,
+    const F32 *curB,
+    U32 icBlocks,
+    U32 iPlane,
+    U32 fh,
+    U32 fw,
+    U32 hStep,
+    U32 dw,
+    U32 sw,
+    U32 ocSize,
+    U32 oStep,
+    U32 store);
+
+// Compute P pixels of one output row and ocSize = 16 * NV (8 if HALF) output channels.
+// Every zmm holds 16 channels of 2 NCHWC8 planes, so the weights of the NCHWCxN32 layout
+// and the activation layout are the same as the AVX2 kernels.
+template <U32 P, U32 NV, bool HALF>
+AVX512_TARGET void avx512_conv_kernel(const F32 *curI,
+    const F32 *curW,
+    F32 *curO,
+    const F32 *curB,
+    U32 icBlocks,
+    U32 iPlane,
+    U32 fh,
+    U32 fw,
+    U32 hStep,
+    U32 dw,
+    U32 sw,
+    U32 ocSize,
+    U32 oStep,
+    U32 store)
+{
+    const __mmask16 lastMask = HALF ? 0xFF : 0xFFFF;
+    __m512 c[P][NV];
+    if (store & 1) {
+        for (U32 p = 0; p < P; p++) {
+            for (U32 j = 0; j < NV; j++) {
+                const F32 *lo = curO + 2 * j * oStep + p * 8;
+                if (HALF && j == NV - 1) {
+                    c[p][j] = _mm512_maskz_loadu_ps(lastMask, lo);
+                } else {
+                    c[p][j] = _mm512_loadu_2x256_ps(lo, lo + oStep);
+                }
+            }
+        }
+    } else {
+        for (U32 j = 0; j < NV; j++) {
+            __m512 b = _mm512_maskz_loadu_ps((j == NV - 1) ? lastMask : 0xFFFF, curB + j * 16);
+            for (U32 p = 0; p < P; p++) {
+                c[p][j] = b;
+            }
+        }
+    }
+    const I64 pStep = sw;
+    for (U32 icb = 0; icb < icBlocks; icb++) {
+        const F32 *in = curI + (I64)icb * iPlane;
+        for (U32 h = 0; h < fh; h++) {
+            for (U32 w = 0; w < fw; w++) {
+                const F32 *ip = in + (I64)w * dw;
+                for (U32 ci = 0; ci < 8; ci++) {
+                    __m512 wv[NV];
+                    for (U32 j = 0; j < NV; j++) {
+                        wv[j] = (HALF && j == NV - 1) ? _mm512_loadu_256_ps(curW + j * 16)
+                                                      : _mm512_loadu_ps(curW + j * 16);
+                    }
+                    for (U32 p = 0; p < P; p++) {
+                        __m512 a = _mm512_set1_ps(ip[p * pStep + ci]);
+                        for (U32 j = 0; j < NV; j++) {
+                            c[p][j] = _mm512_fmadd_ps(a, wv[j], c[p][j]);
+                        }
+                    }
+                    curW += ocSize;
+                }
+            }
+            in += hStep;
+        }
+    }
+    for (U32 p = 0; p < P; p++) {
+        for (U32 j = 0; j < NV; j++) {
+            F32 *lo = curO + 2 * j * oStep + p * 8;
+            __m512 x = _mm512_activate_ps(c[p][j], store >> 1);
+            if (HALF && j == NV - 1) {
+                _mm512_mask_storeu_ps(lo, lastMask, x);
+            } else {
+                _mm512_storeu_2x256_ps(lo, lo + oStep, x);
+            }
+        }
+    }
+}
+
+template <U32 NV, bool HALF>
+inline kernel_func avx512_conv_kernel_select(U32 p)
+{
+    kernel_func kernel[UNROLL_W] = {avx512_conv_kernel<1, NV, HALF>,
+        avx512_conv_kernel<2, NV, HALF>, avx512_conv_kernel<3, NV, HALF>,
+        avx512_conv_kernel<4, NV, HALF>, avx512_conv_kernel<5, NV, HALF>,
+        avx512_conv_kernel<6, NV, HALF>, avx512_conv_kernel<7, NV, HALF>,
+        avx512_conv_kernel<8, NV, HALF>, avx512_conv_kernel<9, NV, HALF>,
+        avx512_conv_kernel<10, NV, HALF>, avx512_conv_kernel<11, NV, HALF>,
+        avx512_conv_kernel<12, NV, HALF>};
+    return kernel[p - 1];
+}
+
+EE convolution_direct_avx512(TensorDesc inputDesc,
+    F32 *inArray,
+    TensorDesc filterDesc,
+    const F32 *filterArray,
+    ConvolutionParamSpec convParamSpec,
+    TensorDesc biasDesc,
+    const F32 *biasArray,
+    U32 tmpBytes,
+    void *tmp,
+    TensorDesc outputDesc,
+    F32 *outArray,
+    const F32 *residualArray,
+    ActivationParamSpec activationDesc)
+{
+    UNUSED(biasDesc);
+    UNUSED(tmpBytes);
+
+    DataType idt, fdt, odt;
+    DataFormat idf, fdf, odf;
+    U32 in, ic, ih, iw;
+    U32 fn, fc, fh, fw;
+    U32 on, oc, oh, ow;
+    CHECK_STATUS(tensor4dGet(inputDesc, &idt, &idf, &in, &ic, &ih, &iw));
+    CHECK_STATUS(tensor4dGet(filterDesc, &fdt, &fdf, &fn, &fc, &fh, &fw));
+    CHECK_STATUS(tensor4dGet(outputDesc, &odt, &odf, &on, &oc, &oh, &ow));
+
+    U32 strideH = convParamSpec.stride_h;
+    U32 strideW = convParamSpec.stride_w;
+    U32 paddingT = convParamSpec.padding_top;
+    U32 paddingB = convParamSpec.padding_bottom;
+    U32 paddingL = convParamSpec.padding_left;
+    U32 paddingR = convParamSpec.padding_right;
+    U32 dilateH = convParamSpec.dilatedRate_h;
+    U32 dilateW = convParamSpec.dilatedRate_w;
+
+    if ((fdf != DF_NCHWCxN32) || (idf != DF_NCHWC8) || (ic % 8 != 0)) {
+        CHECK_STATUS(NOT_MATCH);
+    }
+
+    F32 *ftmp = (F32 *)align_addr(tmp, 32);
+    filterArray = (F32 *)align_addr(filterArray, 32);
+
+    U32 ih_pad = ih + paddingT + paddingB;
+    U32 iw_pad = iw + paddingL + paddingR;
+    U32 ohow = oh * ow;
+    U32 oStep = ohow * 8;
+    U32 iPlane = ih_pad * iw_pad * 8;
+    U32 hStep = dilateH * iw_pad * 8;
+    U32 dw = dilateW * 8;
+    U32 sw = strideW * 8;
+    U32 ocblocks[3] = {8, 16, 32};
+
+#ifdef _USE_OPENMP
+    U32 alpha = (ohow + OMP_NUM_THREADS * BLOCK_HW_DIM - 1) / (OMP_NUM_THREADS * BLOCK_HW_DIM);
+    U32 block_hw_dim = (ohow + OMP_NUM_THREADS * alpha - 1) / (OMP_NUM_THREADS * alpha);
+#else
+    U32 block_hw_dim = BLOCK_HW_DIM;
+#endif
+
+    // the same output channel blocks as the filter transform, 32 and then 16 and 8
+    std::vector<U32> ocbArray;
+    for (U32 ocb = 0; ocb < oc; ocb += ocblocks[UNI_MIN(oc - ocb, BLOCK_OC_DIM) >> 4]) {
+        ocbArray.push_back(ocb);
+    }
+    U32 ocBlockNums = ocbArray.size();
+    U32 hwBlockNums = (ohow + block_hw_dim - 1) / block_hw_dim;
+    U32 hwocBlockNums = hwBlockNums * ocBlockNums;
+
+    // the residual is added before the activation, so the kernels only add the bias
+    ActivationParamSpec epilogueDesc = activationDesc;
+    if (residualArray != nullptr) {
+        activationDesc.mode = ACTIVATION_NULL;
+    }
+
+    for (U32 n = 0; n < in; ++n) {
+        if ((paddingT == 0) && (paddingB == 0) && (paddingL == 0) && (paddingR == 0)) {
+            ftmp = inArray;
+        } else {
+            PaddingNCHWC8(inArray, ftmp, inputDesc, convParamSpec);
+        }
+#ifdef _USE_OPENMP
+#pragma omp parallel num_threads(OMP_NUM_THREADS)
+        {
+#endif
+            U32 icSize = 0;
+            for (U32 icbb = 0; icbb < ic; icbb += icSize) {
+                icSize = UNI_MIN(BLOCK_IC_DIM, ic - icbb);
+                U32 store = (icbb > 0);
+                if (icbb + icSize == ic) {
+                    store |= U32(activationDesc.mode) << 1;
+                }
+#ifdef _USE_OPENMP
+#pragma omp for
+#endif
+                for (U32 bIdx = 0; bIdx < hwocBlockNums; ++bIdx) {
+                    U32 hw = (bIdx / ocBlockNums) * block_hw_dim;
+                    U32 hwSize = UNI_MIN(block_hw_dim, ohow - hw);
+                    U32 ocb = ocbArray[bIdx % ocBlockNums];
+                    U32 ocSize = ocblocks[UNI_MIN(oc - ocb, BLOCK_OC_DIM) >> 4];
+                    const F32 *curW = filterArray + ocb * ic * fh * fw + ocSize * icbb * fh * fw;
+                    const F32 *curI = ftmp + icbb * ih_pad * iw_pad;
+                    U32 wSize = 0;
+                    for (U32 ihw = hw; ihw < hw + hwSize; ihw += wSize) {
+                        U32 h = ihw / ow;
+                        U32 w = ihw % ow;
+                        wSize = UNI_MIN(UNI_MIN(hw + hwSize - ihw, ow - w), UNROLL_W);
+                        kernel_func kernel;
+                        if (ocSize == 32) {
+                            kernel = avx512_conv_kernel_select<2, false>(wSize);
+                        } else if (ocSize == 16) {
+                            kernel = avx512_conv_kernel_select<1, false>(wSize);
+                        } else {
+                            kernel = avx512_conv_kernel_select<1, true>(wSize);
+                        }
+                        kernel(curI + (h * strideH * iw_pad + w * strideW) * 8, curW,
+                            outArray + (n * oc + ocb) * ohow + ihw * 8, biasArray + ocb,
+                            icSize / 8, iPlane, fh, fw, hStep, dw, sw, ocSize, oStep, store);
+                    }
+                    if (residualArray != nullptr && icbb + icSize == ic) {
+                        convolution_epilogue_fp32(outArray, residualArray, n * oc + ocb,
+                            n * oc + ocb + ocSize, ohow, hw, hwSize, epilogueDesc);
+                    }
+                }
+            }
+#ifdef _USE_OPENMP
+        }
+#endif
+        inArray += ic * ih * iw;
+    }
+    return SUCCESS;
+}
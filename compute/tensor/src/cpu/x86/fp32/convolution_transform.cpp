@@ -94,6 +94,11 @@ EE convolution_transform_filter_fp32(TensorDesc filterDesc,
     DataFormat fdf;
     U32 fn, fc, fh, fw;
     CHECK_STATUS(tensor4dGet(filterDesc, &fdt, &fdf, &fn, &fc, &fh, &fw));
+    if (algorithm == CONVOLUTION_ALGORITHM_WINOGRAD) {
+        filterTransformed = (F32 *)(((uintptr_t)filterTransformed + 32 - 1) / 32 * 32);
+        return convolution_winograd_transform_filter_fp32(
+            filterDesc, filter, ftmDesc, filterTransformed);
+    }
     switch (algorithm) {
         case CONVOLUTION_ALGORITHM_DIRECT: {
             ftmDataFormat = DF_NCHWCxN32;
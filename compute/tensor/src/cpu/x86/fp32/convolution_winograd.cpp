@@ -0,0 +1,283 @@
+// Copyright (C) 2019. Huawei Technologies Co., Ltd. All rights reserved.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include <string.h>
+#include "sys.h"
+#include "error.h"
+#include "types.h"
+#include "blas_enhance.h"
+
+#include "cpu/x86/fp32/tensor_computing_fp32.h"
+
+#define align_addr(addr, unit) (((uintptr_t)addr + unit - 1) / unit * unit)
+
+// F(4x4, 3x3): a 4x4 output tile is computed from a 6x6 input tile, the 36 positions of the
+// transformed tiles are 36 independent GEMMs of [tiles][ic] * [ic][oc].
+// The transforms are the same as the ARM ones, see arm/fp32/convolution_winograd_transform.h.
+
+// G * g * G^T of a 3x3 filter, g is strided by gStep and u is [6][6]
+inline void trans_W_4x4_3x3(const F32 *g, U32 gStep, F32 *u)
+{
+    F32 tmp[6][3];
+    for (U32 j = 0; j < 3; j++) {
+        F32 w0 = g[j * gStep];
+        F32 w1 = g[(3 + j) * gStep];
+        F32 w2 = g[(6 + j) * gStep];
+        F32 t0 = w2 / 6;
+        F32 t1 = -w0 / 6 - t0;
+        F32 t2 = t0 + w0 / 24;
+        tmp[0][j] = w0 / 4;
+        tmp[1][j] = t1 - w1 / 6;
+        tmp[2][j] = t1 + w1 / 6;
+        tmp[3][j] = t2 + w1 / 12;
+        tmp[4][j] = t2 - w1 / 12;
+        tmp[5][j] = w2;
+    }
+    for (U32 i = 0; i < 6; i++) {
+        F32 w0 = tmp[i][0];
+        F32 w1 = tmp[i][1];
+        F32 w2 = tmp[i][2];
+        F32 t0 = w2 / 6;
+        F32 t1 = -w0 / 6 - t0;
+        F32 t2 = t0 + w0 / 24;
+        u[i * 6 + 0] = w0 / 4;
+        u[i * 6 + 1] = t1 - w1 / 6;
+        u[i * 6 + 2] = t1 + w1 / 6;
+        u[i * 6 + 3] = t2 + w1 / 12;
+        u[i * 6 + 4] = t2 - w1 / 12;
+        u[i * 6 + 5] = w2;
+    }
+}
+
+// B^T * d of 6 vectors strided by step
+inline void trans_I_1d(const __m256 *d, U32 step, __m256 *r, U32 rStep)
+{
+    __m256 four = _mm256_set1_ps(4.0f);
+    __m256 five = _mm256_set1_ps(5.0f);
+    __m256 t0 = _mm256_fnmadd_ps(four, d[2 * step], d[4 * step]);
+    __m256 t1 = _mm256_fnmadd_ps(four, d[step], d[3 * step]);
+    __m256 t2 = _mm256_sub_ps(d[4 * step], d[2 * step]);
+    __m256 t3 = _mm256_sub_ps(d[3 * step], d[step]);
+    t3 = _mm256_add_ps(t3, t3);
+    __m256 t4 = _mm256_fmadd_ps(four, d[0], d[4 * step]);
+    __m256 t5 = _mm256_fmadd_ps(four, d[step], d[5 * step]);
+    r[0] = _mm256_fnmadd_ps(five, d[2 * step], t4);
+    r[rStep] = _mm256_add_ps(t1, t0);
+    r[2 * rStep] = _mm256_sub_ps(t0, t1);
+    r[3 * rStep] = _mm256_add_ps(t3, t2);
+    r[4 * rStep] = _mm256_sub_ps(t2, t3);
+    r[5 * rStep] = _mm256_fnmadd_ps(five, d[3 * step], t5);
+}
+
+// B^T * d * B of a [6][6] tile of 8 channels
+inline void trans_I_4x4_3x3(const __m256 *d, __m256 *v)
+{
+    __m256 tmp[36];
+    for (U32 j = 0; j < 6; j++) {
+        trans_I_1d(d + j, 6, tmp + j, 6);
+    }
+    for (U32 i = 0; i < 6; i++) {
+        trans_I_1d(tmp + i * 6, 1, v + i * 6, 1);
+    }
+}
+
+// A^T * m of 6 vectors strided by step
+inline void trans_O_1d(const __m256 *m, U32 step, __m256 *r, U32 rStep)
+{
+    __m256 two = _mm256_set1_ps(2.0f);
+    __m256 four = _mm256_set1_ps(4.0f);
+    __m256 eight = _mm256_set1_ps(8.0f);
+    __m256 t0 = _mm256_add_ps(m[step], m[2 * step]);
+    __m256 t1 = _mm256_add_ps(m[3 * step], m[4 * step]);
+    __m256 t2 = _mm256_sub_ps(m[step], m[2 * step]);
+    __m256 t3 = _mm256_sub_ps(m[3 * step], m[4 * step]);
+    r[0] = _mm256_add_ps(_mm256_add_ps(t0, t1), m[0]);
+    r[rStep] = _mm256_fmadd_ps(two, t3, t2);
+    r[2 * rStep] = _mm256_fmadd_ps(four, t1, t0);
+    r[3 * rStep] = _mm256_add_ps(_mm256_fmadd_ps(eight, t3, t2), m[5 * step]);
+}
+
+// A^T * m * A of a [6][6] tile of 8 channels
+inline void trans_O_4x4_3x3(const __m256 *m, __m256 *o)
+{
+    __m256 tmp[24];
+    for (U32 j = 0; j < 6; j++) {
+        trans_O_1d(m + j, 6, tmp + j, 6);
+    }
+    for (U32 i = 0; i < 4; i++) {
+        trans_O_1d(tmp + i * 6, 1, o + i * 4, 1);
+    }
+}
+
+EE convolution_winograd_transform_filter_fp32(
+    TensorDesc filterDesc, const F32 *filter, TensorDesc *ftmDesc, F32 *filterTransformed)
+{
+    DataType fdt;
+    DataFormat fdf;
+    U32 fn, fc, fh, fw;
+    CHECK_STATUS(tensor4dGet(filterDesc, &fdt, &fdf, &fn, &fc, &fh, &fw));
+    if (fdf != DF_NCHW || fh != 3 || fw != 3) {
+        CHECK_STATUS(NOT_SUPPORTED);
+    }
+    // [36][fc][fn], every position is packed as the B matrix of a GEMM
+    F32 *tmp = (F32 *)malloc(36 * fc * fn * bytesOf(fdt));
+    F32 u[36];
+    for (U32 o = 0; o < fn; o++) {
+        for (U32 c = 0; c < fc; c++) {
+            trans_W_4x4_3x3(filter + (o * fc + c) * 9, 1, u);
+            for (U32 p = 0; p < 36; p++) {
+                tmp[(p * fc + c) * fn + o] = u[p];
+            }
+        }
+    }
+    // the packed layout is the same for the AVX2 and AVX-512 GEMM kernels
+    TensorDesc matrixDesc = tensor2df(fdt, DF_NORMAL, fc, fn);
+    TensorDesc packDesc;
+    for (U32 p = 0; p < 36; p++) {
+        CHECK_STATUS(matrix_matrix_multiply_transform_rhs(matrixDesc, tmp + p * fc * fn,
+            &packDesc, filterTransformed + p * fc * fn, X86_AVX2));
+    }
+    free(tmp);
+    *ftmDesc = tensor4df(fdt, packDesc.df, fn, fc, 6, 6);
+    return SUCCESS;
+}
+
+EE convolution_winograd(TensorDesc inputDesc,
+    F32 *inArray,
+    TensorDesc filterDesc,
+    const F32 *filterArray,
+    ConvolutionParamSpec convParamSpec,
+    TensorDesc biasDesc,
+    const F32 *biasArray,
+    U32 tmpBytes,
+    void *tmp,
+    TensorDesc outputDesc,
+    F32 *outArray,
+    ActivationParamSpec activationDesc,
+    Arch arch)
+{
+    UNUSED(biasDesc);
+    UNUSED(tmpBytes);
+
+    DataType idt, fdt, odt;
+    DataFormat idf, fdf, odf;
+    U32 in, ic, ih, iw;
+    U32 fn, fc, fh, fw;
+    U32 on, oc, oh, ow;
+    CHECK_STATUS(tensor4dGet(inputDesc, &idt, &idf, &in, &ic, &ih, &iw));
+    CHECK_STATUS(tensor4dGet(filterDesc, &fdt, &fdf, &fn, &fc, &fh, &fw));
+    CHECK_STATUS(tensor4dGet(outputDesc, &odt, &odf, &on, &oc, &oh, &ow));
+    if (idf != DF_NCHWC8 || fdf != targetFormat4MatrixB(DT_F32) || fh != 6 || fw != 6 ||
+        ic % 8 != 0 || oc % 8 != 0) {
+        CHECK_STATUS(NOT_MATCH);
+    }
+    if (activationDesc.mode != ACTIVATION_NULL && activationDesc.mode != ACTIVATION_RELU &&
+        activationDesc.mode != ACTIVATION_RELU6) {
+        CHECK_STATUS(NOT_SUPPORTED);
+    }
+
+    I32 paddingT = convParamSpec.padding_top;
+    I32 paddingL = convParamSpec.padding_left;
+    U32 tileH = (oh + 3) / 4;
+    U32 tileW = (ow + 3) / 4;
+    U32 tiles = tileH * tileW;
+    U32 blockSize = UNI_MIN(tiles, WINOGRAD_TILE_BLOCK);
+    U32 ic8 = ic / 8;
+    U32 oc8 = oc / 8;
+
+    filterArray = (F32 *)align_addr(filterArray, 32);
+    F32 *itm = (F32 *)align_addr(tmp, 32);
+    F32 *otm = itm + 36 * blockSize * ic;
+    F32 *gemmTmp = otm + 36 * blockSize * oc;
+    __m256 zero = _mm256_setzero_ps();
+    __m256 six = _mm256_set1_ps(6.0f);
+
+    for (U32 n = 0; n < in; n++) {
+        const F32 *input = inArray + n * ic * ih * iw;
+        F32 *output = outArray + n * oc * oh * ow;
+        for (U32 t0 = 0; t0 < tiles; t0 += blockSize) {
+            U32 tb = UNI_MIN(blockSize, tiles - t0);
+            // input transform, [tb][ic8][6][6][8] => [36][tb][ic]
+#ifdef _USE_OPENMP
+#pragma omp parallel for num_threads(OMP_NUM_THREADS)
+#endif
+            for (U32 idx = 0; idx < tb * ic8; idx++) {
+                U32 t = idx / ic8;
+                U32 c = idx % ic8;
+                I32 h0 = (t0 + t) / tileW * 4 - paddingT;
+                I32 w0 = (t0 + t) % tileW * 4 - paddingL;
+                const F32 *src = input + c * ih * iw * 8;
+                __m256 d[36], v[36];
+                for (I32 i = 0; i < 6; i++) {
+                    for (I32 j = 0; j < 6; j++) {
+                        I32 h = h0 + i;
+                        I32 w = w0 + j;
+                        if (h >= 0 && h < (I32)ih && w >= 0 && w < (I32)iw) {
+                            d[i * 6 + j] = _mm256_loadu_ps(src + (h * iw + w) * 8);
+                        } else {
+                            d[i * 6 + j] = zero;
+                        }
+                    }
+                }
+                trans_I_4x4_3x3(d, v);
+                for (U32 p = 0; p < 36; p++) {
+                    _mm256_storeu_ps(itm + (p * blockSize + t) * ic + c * 8, v[p]);
+                }
+            }
+
+            // 36 GEMMs of [tb][ic] * [ic][oc]
+            TensorDesc matrixADesc = tensor2df(DT_F32, DF_NORMAL, tb, ic);
+            TensorDesc matrixBDesc = tensor2df(DT_F32, fdf, ic, oc);
+            TensorDesc matrixCDesc = tensor2df(DT_F32, DF_NORMAL, tb, oc);
+            U32 gemmBytes = 0;
+            CHECK_STATUS(
+                matrix_matrix_multiply_tmp_bytes(matrixADesc, matrixBDesc, &gemmBytes, arch));
+            memset(otm, 0, 36 * blockSize * oc * bytesOf(DT_F32));
+            for (U32 p = 0; p < 36; p++) {
+                CHECK_STATUS(matrix_matrix_multiply(matrixADesc, itm + p * blockSize * ic,
+                    matrixBDesc, filterArray + p * ic * oc, gemmBytes, gemmTmp, matrixCDesc,
+                    otm + p * blockSize * oc, arch));
+            }
+
+            // output transform, [36][tb][oc] => [tb][oc8][4][4][8]
+#ifdef _USE_OPENMP
+#pragma omp parallel for num_threads(OMP_NUM_THREADS)
+#endif
+            for (U32 idx = 0; idx < tb * oc8; idx++) {
+                U32 t = idx / oc8;
+                U32 o = idx % oc8;
+                U32 h0 = (t0 + t) / tileW * 4;
+                U32 w0 = (t0 + t) % tileW * 4;
+                F32 *dst = output + o * oh * ow * 8;
+                __m256 m[36], r[16];
+                for (U32 p = 0; p < 36; p++) {
+                    m[p] = _mm256_loadu_ps(otm + (p * blockSize + t) * oc + o * 8);
+                }
+                trans_O_4x4_3x3(m, r);
+                __m256 bias = _mm256_loadu_ps(biasArray + o * 8);
+                for (U32 i = 0; i < 4 && h0 + i < oh; i++) {
+                    for (U32 j = 0; j < 4 && w0 + j < ow; j++) {
+                        __m256 x = _mm256_add_ps(r[i * 4 + j], bias);
+                        if (activationDesc.mode == ACTIVATION_RELU) {
+                            x = _mm256_max_ps(x, zero);
+                        } else if (activationDesc.mode == ACTIVATION_RELU6) {
+                            x = _mm256_min_ps(_mm256_max_ps(x, zero), six);
+                        }
+                        _mm256_storeu_ps(dst + ((h0 + i) * ow + w0 + j) * 8, x);
+                    }
+                }
+            }
+        }
+    }
+    return SUCCESS;
+}
@@ -828,7 +828,8 @@ EE depthwise_convolution_direct(TensorDesc inputDesc,
         ConvolutionParamSpec p = createConvolutionParamSpec(
             1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 1, 1, 1, fn, Convolution_Pointwise);
         convolution_1x1_direct(pwInputDesc, useOutArray, pwFilterDesc, pwFilterArray, p,
-            pwBiasArray, tmpBytes, tmp, outputDesc, outArray, pointwiseActivationParamSpec);
+            pwBiasArray, tmpBytes, tmp, outputDesc, outArray, nullptr,
+            pointwiseActivationParamSpec);
     }
     return SUCCESS;
 }
@@ -0,0 +1,216 @@
+// Copyright (C) 2019. Huawei Technologies Co., Ltd. All rights reserved.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "x86_avx512_expand.h"
+#include "sys.h"
+#include "error.h"
+#include "types.h"
+#include "tensor_computing.h"
+
+#include "cpu/x86/fp32/tensor_computing_fp32.h"
+
+#define UNROLL_W 6
+#define SIMD_W 8
+#define UNROLL_OC_BLOCK_DIM 24
+#define align_addr(addr, unit) (((uintptr_t)addr + unit - 1) / unit * unit)
+
+typedef void (*kernel_func)(const F32 *curI,
+    I32 iOff,
+    const F32 *curW,
+    F32 *curO,
+    const F32 *curB,
+    U32 pixels,
+    I32 khs,
+    I32 khe,
+    I32 kws,
+    I32 kwe,
+    U32 fw,
+    U32 ocSize,
+    I32 hStep,
+    I32 dw,
+    I32 sw,
+    U32 mode);
+
+// Compute the 8 channels of pixels (<= 2 * P) continuous output pixels in an output row, two
+// pixels share a zmm register. Only the taps in [khs, khe) x [kws, kwe) are inside the input,
+// iOff is the offset of the first tap of the first pixel which may be outside.
+template <U32 P>
+AVX512_TARGET void avx512_dw_kernel(const F32 *curI,
+    I32 iOff,
+    const F32 *curW,
+    F32 *curO,
+    const F32 *curB,
+    U32 pixels,
+    I32 khs,
+    I32 khe,
+    I32 kws,
+    I32 kwe,
+    U32 fw,
+    U32 ocSize,
+    I32 hStep,
+    I32 dw,
+    I32 sw,
+    U32 mode)
+{
+    __mmask16 mask[P];
+    __m512 c[P];
+    __m512 b = _mm512_broadcast_256_ps(curB);
+    for (U32 p = 0; p < P; p++) {
+        mask[p] = (pixels >= 2 * p + 2) ? 0xFFFF : 0xFF;
+        c[p] = b;
+    }
+    for (I32 kh = khs; kh < khe; kh++) {
+        for (I32 kw = kws; kw < kwe; kw++) {
+            __m512 w = _mm512_broadcast_256_ps(curW + (kh * fw + kw) * ocSize);
+            const F32 *in = curI + iOff + kh * hStep + kw * dw;
+            for (U32 p = 0; p < P; p++) {
+                __m512 x;
+                if (sw == SIMD_W) {
+                    x = (mask[p] == 0xFFFF) ? _mm512_loadu_ps(in + 2 * p * SIMD_W)
+                                            : _mm512_loadu_256_ps(in + 2 * p * SIMD_W);
+                } else {
+                    const F32 *lo = in + 2 * p * sw;
+                    x = _mm512_loadu_2x256_ps(lo, (mask[p] == 0xFFFF) ? lo + sw : lo);
+                }
+                c[p] = _mm512_fmadd_ps(x, w, c[p]);
+            }
+        }
+    }
+    for (U32 p = 0; p < P; p++) {
+        _mm512_mask_storeu_ps(curO + 2 * p * SIMD_W, mask[p], _mm512_activate_ps(c[p], mode));
+    }
+}
+
+EE depthwise_convolution_direct_avx512(TensorDesc inputDesc,
+    F32 *inArray,
+    TensorDesc dwFilterDesc,
+    const F32 *dwFilterArray,
+    TensorDesc pwFilterDesc,
+    const F32 *pwFilterArray,
+    ConvolutionParamSpec convParamSpec,
+    TensorDesc dwBiasDesc,
+    const F32 *dwBiasArray,
+    TensorDesc pwBiasDesc,
+    const F32 *pwBiasArray,
+    U32 tmpBytes,
+    void *tmp,
+    TensorDesc outputDesc,
+    F32 *outArray,
+    ActivationParamSpec depthwiseActivationParamSpec,
+    ActivationParamSpec pointwiseActivationParamSpec)
+{
+    UNUSED(dwBiasDesc);
+    UNUSED(pwBiasDesc);
+    DataType idt, fdt, odt;
+    DataFormat idf, fdf, odf;
+    U32 in, ic, ih, iw;
+    U32 fn, fc, fh, fw;
+    U32 on, oc, oh, ow;
+    CHECK_STATUS(tensor4dGet(inputDesc, &idt, &idf, &in, &ic, &ih, &iw));
+    CHECK_STATUS(tensor4dGet(dwFilterDesc, &fdt, &fdf, &fn, &fc, &fh, &fw));
+    CHECK_STATUS(tensor4dGet(outputDesc, &odt, &odf, &on, &oc, &oh, &ow));
+    I32 strideH = convParamSpec.stride_h;
+    I32 strideW = convParamSpec.stride_w;
+    I32 paddingT = convParamSpec.padding_top;
+    I32 paddingL = convParamSpec.padding_left;
+    I32 dilateH = convParamSpec.dilatedRate_h;
+    I32 dilateW = convParamSpec.dilatedRate_w;
+
+    if (fdf != DF_NCHWC24 || idf != DF_NCHWC8) {
+        CHECK_STATUS(NOT_MATCH);
+    }
+
+    dwFilterArray = (F32 *)align_addr(dwFilterArray, 32);
+    U32 icPadding = (ic + SIMD_W - 1) / SIMD_W * SIMD_W;
+    F32 *useOutArray = (F32 *)align_addr(tmp, 32);
+    if (pwFilterArray == nullptr) {
+        useOutArray = outArray;
+    }
+
+    U32 ocblocks[3] = {8, 16, 24};
+    I32 hStep = dilateH * iw * SIMD_W;
+    I32 dw = dilateW * SIMD_W;
+    I32 sw = strideW * SIMD_W;
+    U32 mode = depthwiseActivationParamSpec.mode;
+    kernel_func kernel[UNROLL_W] = {avx512_dw_kernel<1>, avx512_dw_kernel<2>,
+        avx512_dw_kernel<3>, avx512_dw_kernel<4>, avx512_dw_kernel<5>, avx512_dw_kernel<6>};
+
+    // the output columns whose taps are all inside the input
+    I32 wl = UNI_MIN((paddingL + strideW - 1) / strideW, (I32)ow);
+    I32 wr = UNI_MAX((I32)(iw + paddingL - (fw - 1) * dilateW - 1) / strideW + 1, wl);
+    wr = UNI_MIN(wr, (I32)ow);
+    if ((I32)(iw + paddingL) < (I32)((fw - 1) * dilateW + 1)) {
+        wr = wl;
+    }
+
+    U32 planes = icPadding / SIMD_W;
+    for (U32 n = 0; n < in; ++n) {
+        const F32 *inputN = inArray + n * icPadding * ih * iw;
+        F32 *outputN = useOutArray + n * icPadding * oh * ow;
+#ifdef _USE_OPENMP
+#pragma omp parallel for num_threads(OMP_NUM_THREADS)
+#endif
+        for (U32 idx = 0; idx < planes * oh; ++idx) {
+            U32 c = idx / oh;
+            I32 h = idx % oh;
+            U32 ocb = c * SIMD_W / UNROLL_OC_BLOCK_DIM * UNROLL_OC_BLOCK_DIM;
+            U32 ocSize = ocblocks[(UNI_MIN(UNROLL_OC_BLOCK_DIM, icPadding - ocb) >> 3) - 1];
+            const F32 *curW = dwFilterArray + ocb * fh * fw + c * SIMD_W - ocb;
+            const F32 *curB = dwBiasArray + c * SIMD_W;
+            const F32 *curI = inputN + c * SIMD_W * ih * iw;
+            F32 *curO = outputN + (c * oh + h) * ow * SIMD_W;
+
+            I32 in_h = h * strideH - paddingT;
+            I32 khs = 0, khe = fh;
+            while (khs < khe && in_h + khs * dilateH < 0) {
+                khs++;
+            }
+            while (khe > khs && in_h + (khe - 1) * dilateH >= (I32)ih) {
+                khe--;
+            }
+            for (I32 w = 0; w < (I32)ow;) {
+                I32 in_w = w * strideW - paddingL;
+                I32 iOff = (in_h * (I32)iw + in_w) * SIMD_W;
+                if (w >= wl && w < wr) {
+                    U32 pixels = UNI_MIN(wr - w, UNROLL_W * 2);
+                    kernel[(pixels + 1) / 2 - 1](curI, iOff, curW, curO + w * SIMD_W, curB,
+                        pixels, khs, khe, 0, fw, fw, ocSize, hStep, dw, sw, mode);
+                    w += pixels;
+                } else {
+                    I32 kws = 0, kwe = fw;
+                    while (kws < kwe && in_w + kws * dilateW < 0) {
+                        kws++;
+                    }
+                    while (kwe > kws && in_w + (kwe - 1) * dilateW >= (I32)iw) {
+                        kwe--;
+                    }
+                    kernel[0](curI, iOff, curW, curO + w * SIMD_W, curB, 1, khs, khe, kws, kwe,
+                        fw, ocSize, hStep, dw, sw, mode);
+                    w++;
+                }
+            }
+        }
+    }
+
+    if (pwFilterArray != nullptr) {
+        TensorDesc pwInputDesc = tensor4df(odt, DF_NCHWC8, in, ic, oh, ow);
+        tmpBytes -= oh * ic * oh * ow + 32;
+        tmp = (void *)((F32 *)tmp + oh * ic * oh * ow + 32);
+        ConvolutionParamSpec p = createConvolutionParamSpec(
+            1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 1, 1, 1, fn, Convolution_Pointwise);
+        convolution_1x1_direct_avx512(pwInputDesc, useOutArray, pwFilterDesc, pwFilterArray, p,
+            pwBiasArray, tmpBytes, tmp, outputDesc, outArray, nullptr,
+            pointwiseActivationParamSpec);
+    }
+    return SUCCESS;
+}
@@ -34,7 +34,6 @@ EE depthwise_pointwise_convolution_fp32(TensorDesc inputDesc,
     ActivationParamSpec pointwiseActivationParamSpec,
     Arch arch)
 {
-    UNUSED(arch);
     if (nullptr == input || nullptr == dwFilter || nullptr == output || nullptr == dwBias ||
         nullptr == tmp) {
         CHECK_STATUS(NULL_POINTER);
@@ -61,6 +60,12 @@ EE depthwise_pointwise_convolution_fp32(TensorDesc inputDesc,
     EE ret = NOT_MATCH;
     if (algorithm == DEPTHWISE_POINTWISE_CONVOLUTION_ALGORITHM_DIRECT ||
         algorithm == DEPTHWISE_CONVOLUTION_ALGORITHM_DIRECT) {
+        if (IS_X86_AVX512(arch)) {
+            return depthwise_convolution_direct_avx512(inputDesc, input, dwFilterDesc, dwFilter,
+                pwFilterDesc, pwFilter, convParamSpec, dwBiasDesc, dwBias, pwBiasDesc, pwBias,
+                tmpBytes, tmp, outputDesc, output, depthwiseActivationParamSpec,
+                pointwiseActivationParamSpec);
+        }
         ret = depthwise_convolution_direct(inputDesc, input, dwFilterDesc, dwFilter, pwFilterDesc,
             pwFilter, convParamSpec, dwBiasDesc, dwBias, pwBiasDesc, pwBias, tmpBytes, tmp,
             outputDesc, output, depthwiseActivationParamSpec, pointwiseActivationParamSpec);
@@ -12,16 +12,33 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include <string.h>
+#include "blas_enhance.h"
 #include "cpu/x86/fp32/tensor_computing_fp32.h"
 
-void mvm_nkn32_with_bias(
-    U32 fn, U32 fk, const F32 *filterArray, const F32 *input, F32 *output, const F32 *bias)
+// The threads of a parallel region are split into teams, one team per direction of the RNN.
+// The threads of a team share the work of each step by their ranks in the team, and all teams
+// go through the same number of barriers.
+static inline void team_barrier()
 {
 #ifdef _USE_OPENMP
-#pragma omp parallel for num_threads(OMP_NUM_THREADS)
+#pragma omp barrier
 #endif
-    for (U32 n = 0; n < fn; ++n) {
-        const F32 *f = filterArray + n * fk * 32;
+}
+
+// the n-th 32 rows of the filter start at filterArray + n * filterStride, the thread of the rank
+// in the team computes every teamSize-th 32 rows
+static void mvm_nkn32_with_bias(U32 fn,
+    U32 fk,
+    U32 filterStride,
+    const F32 *filterArray,
+    const F32 *input,
+    F32 *output,
+    const F32 *bias,
+    U32 rank,
+    U32 teamSize)
+{
+    for (U32 n = rank; n < fn; n += teamSize) {
+        const F32 *f = filterArray + n * filterStride;
         F32 *out = output + n * 32;
         const F32 *b = bias + n * 32;
         if (bias == nullptr) {
@@ -168,67 +185,35 @@ void mvm_nkn32_with_bias(
     }
 }
 
-EE rnncell_fp32(TensorDesc xDesc,
-    const void *currentX,
-    const TensorDesc *filterDesc,
+// One LSTM step of the batch by a team of threads. When xProjection is not null, it holds
+// x * W_x + b of every batch with the stride batchStrideP, and only h * W_h is computed here.
+// The matrix vector products are shared by the team, the rest is done by its first thread.
+static void lstmcell_fp32(U32 batch,
+    U32 xDim,
+    const F32 *currentXArray,
+    U32 batchStrideX,
+    const F32 *xProjection,
+    U32 batchStrideP,
+    U32 fn,
+    U32 fk,
     const void **filter,
-    const TensorDesc *biasDesc,
     const void **bias,
-    void *state,
-    U32 tmpBytes,
-    void *tmp,
+    F32 *state,
+    F32 *tmpArray,
     RNNParamSpec rnnParamSpec,
-    U32 batchStrideX,
     U32 batchStrideH,
-    TensorDesc hDesc,
-    void *output,
-    Arch arch)
+    F32 *outputArray,
+    U32 rank,
+    U32 teamSize)
 {
-    UNUSED(biasDesc);
-    UNUSED(tmpBytes);
-    UNUSED(arch);
-    if (nullptr == currentX || nullptr == filter || nullptr == bias || nullptr == state ||
-        nullptr == tmp || nullptr == output) {
-        CHECK_STATUS(NULL_POINTER);
-    }
-
-    DataType idt, fdt, odt;
-    DataFormat idf, fdf, odf;
-    U32 in, ix;
-    U32 on, oh;
-    U32 fk, fn;
-    CHECK_STATUS(tensor2dGet(xDesc, &idt, &idf, &in, &ix));
-    CHECK_STATUS(tensor2dGet(filterDesc[0], &fdt, &fdf, &fn, &fk));
-    CHECK_STATUS(tensor2dGet(hDesc, &odt, &odf, &on, &oh));
-    if (fdf != DF_NKN32) {
-        CHECK_STATUS(NOT_MATCH);
-    }
-    fn /= 32;
-
-    U32 batch = in;
-    I32 xDim = ix;
     I32 hDim = rnnParamSpec.numOutput;
     I32 column = (rnnParamSpec.numProjection > 0) ? rnnParamSpec.numProjection
                                                   : rnnParamSpec.numOutput;
-    if (!(idt == DT_F32 && fdt == DT_F32 && odt == DT_F32)) {
-        CHECK_STATUS(NOT_MATCH);
-    }
-    if (!(4 * column == (I32)fn * 32 && (ix + oh) == fk && in == on)) {
-        CHECK_STATUS(NOT_MATCH);
-    }
     F32 forgetBias = rnnParamSpec.forgetBias;
-    ActivationMode activationMode = rnnParamSpec.activationMode;
-    if (activationMode != ACTIVATION_TANH) {
-        CHECK_STATUS(NOT_SUPPORTED);
-    }
-
-    const F32 *currentXArray = (const F32 *)currentX;
-    F32 *lastStateArray = (F32 *)state;
+    F32 *lastStateArray = state;
     F32 *lastHArray = lastStateArray + column;
-    F32 *tmpArray = (F32 *)tmp;
-    F32 *currentStateArray = (F32 *)state;
+    F32 *currentStateArray = state;
     F32 *currentHArray = currentStateArray + column;
-    F32 *outputArray = (F32 *)output;
     F32 *xhArray = tmpArray;
     F32 *intermediateH = xhArray + (xDim + hDim);
     U32 lastStateStride = column + hDim;
@@ -238,10 +223,19 @@ EE rnncell_fp32(TensorDesc xDesc,
     __m256 forgetBiasVector = _mm256_set1_ps(forgetBias);
     for (U32 m = 0; m < batch; m++) {
         F32 *lastBatchH = lastHArray + m * lastHStride;
-        memcpy(xhArray, currentXArray + m * batchStrideX, xDim * sizeof(F32));
-        memcpy(xhArray + xDim, lastBatchH, hDim * sizeof(F32));
-        mvm_nkn32_with_bias(
-            fn, fk, (const F32 *)filter[0], xhArray, intermediateH, (const F32 *)bias[0]);
+        if (xProjection == nullptr) {
+            if (rank == 0) {
+                memcpy(xhArray, currentXArray + m * batchStrideX, xDim * sizeof(F32));
+                memcpy(xhArray + xDim, lastBatchH, hDim * sizeof(F32));
+            }
+            team_barrier();
+            mvm_nkn32_with_bias(fn, fk, fk * 32, (const F32 *)filter[0], xhArray,
+                intermediateH, (const F32 *)bias[0], rank, teamSize);
+        } else {
+            mvm_nkn32_with_bias(fn, hDim, fk * 32, (const F32 *)filter[0] + xDim * 32,
+                lastBatchH, intermediateH, xProjection + m * batchStrideP, rank, teamSize);
+        }
+        team_barrier();
 
         F32 *out_i = intermediateH;
         F32 *out_g = out_i + column;
@@ -267,45 +261,50 @@ EE rnncell_fp32(TensorDesc xDesc,
             tmpH = out_g;
         }
 
-        I32 h = 0;
-        for (; h < column - 7; h += 8) {
-            __m256 out_i_v = _mm256_loadu_ps(out_i + h);
-            __m256 out_g_v = _mm256_loadu_ps(out_g + h);
-            __m256 out_f_v = _mm256_loadu_ps(out_f + h);
-            __m256 out_o_v = _mm256_loadu_ps(out_o + h);
-            __m256 C_v = _mm256_loadu_ps(lastBatchState + h);
-            __m256 I_v = _mm256_sigmod_ps(out_i_v);
-            __m256 F_v = _mm256_sigmod_ps(_mm256_add_ps(out_f_v, forgetBiasVector));
-            __m256 O_v = _mm256_sigmod_ps(out_o_v);
-            __m256 G_v = _mm256_tanh_ps(out_g_v);
-            C_v = _mm256_add_ps(_mm256_mul_ps(C_v, F_v), _mm256_mul_ps(I_v, G_v));
-            __m256 out_hidden_v = _mm256_mul_ps(O_v, _mm256_tanh_ps(C_v));
-            _mm256_storeu_ps(tmpState + h, C_v);
-            _mm256_storeu_ps(tmpHH + h, out_hidden_v);
-        }
-        for (; h < column; h++) {
-            F32 C_s = lastBatchState[h];
-            F32 I_s = 1.0 / (1.0 + exp(-out_i[h]));
-            F32 F_s = 1.0 / (1.0 + exp(-(out_f[h] + forgetBias)));
-            F32 O_s = 1.0 / (1.0 + exp(-out_o[h]));
-            F32 G_s = tanh(out_g[h]);
-            C_s = C_s * F_s + I_s * G_s;
-            F32 value = O_s * tanh(C_s);
-            tmpState[h] = C_s;
-            tmpHH[h] = value;
-        }
-        if (rnnParamSpec.zoneoutCell != 0) {
-            array_scale_f32(tmpState, tmpState, column, 1 - rnnParamSpec.zoneoutCell, 0);
-            array_scale_f32(lastBatchState, lastBatchState, column, rnnParamSpec.zoneoutCell, 0);
-            array_add_f32(tmpState, lastBatchState, currentBatchState, column);
+        if (rank == 0) {
+            I32 h = 0;
+            for (; h < column - 7; h += 8) {
+                __m256 out_i_v = _mm256_loadu_ps(out_i + h);
+                __m256 out_g_v = _mm256_loadu_ps(out_g + h);
+                __m256 out_f_v = _mm256_loadu_ps(out_f + h);
+                __m256 out_o_v = _mm256_loadu_ps(out_o + h);
+                __m256 C_v = _mm256_loadu_ps(lastBatchState + h);
+                __m256 I_v = _mm256_sigmod_ps(out_i_v);
+                __m256 F_v = _mm256_sigmod_ps(_mm256_add_ps(out_f_v, forgetBiasVector));
+                __m256 O_v = _mm256_sigmod_ps(out_o_v);
+                __m256 G_v = _mm256_tanh_ps(out_g_v);
+                C_v = _mm256_add_ps(_mm256_mul_ps(C_v, F_v), _mm256_mul_ps(I_v, G_v));
+                __m256 out_hidden_v = _mm256_mul_ps(O_v, _mm256_tanh_ps(C_v));
+                _mm256_storeu_ps(tmpState + h, C_v);
+                _mm256_storeu_ps(tmpHH + h, out_hidden_v);
+            }
+            for (; h < column; h++) {
+                F32 C_s = lastBatchState[h];
+                F32 I_s = 1.0 / (1.0 + exp(-out_i[h]));
+                F32 F_s = 1.0 / (1.0 + exp(-(out_f[h] + forgetBias)));
+                F32 O_s = 1.0 / (1.0 + exp(-out_o[h]));
+                F32 G_s = tanh(out_g[h]);
+                C_s = C_s * F_s + I_s * G_s;
+                F32 value = O_s * tanh(C_s);
+                tmpState[h] = C_s;
+                tmpHH[h] = value;
+            }
+            if (rnnParamSpec.zoneoutCell != 0) {
+                array_scale_f32(tmpState, tmpState, column, 1 - rnnParamSpec.zoneoutCell, 0);
+                array_scale_f32(
+                    lastBatchState, lastBatchState, column, rnnParamSpec.zoneoutCell, 0);
+                array_add_f32(tmpState, lastBatchState, currentBatchState, column);
+            }
         }
-
         if (rnnParamSpec.numProjection > 0) {
-            mvm_nkn32_with_bias(hDim / 32, rnnParamSpec.numProjection, (const F32 *)filter[1],
-                tmpHH, tmpH, nullptr);
+            team_barrier();
+            mvm_nkn32_with_bias(hDim / 32, rnnParamSpec.numProjection,
+                rnnParamSpec.numProjection * 32, (const F32 *)filter[1], tmpHH, tmpH, nullptr,
+                rank, teamSize);
         }
+        team_barrier();
 
-        if (rnnParamSpec.zoneoutOutput != 0) {
+        if (rank == 0 && rnnParamSpec.zoneoutOutput != 0) {
             if (rnnParamSpec.numProjection > 0) {
                 array_scale_f32(tmpH, out_f, hDim, 1 - rnnParamSpec.zoneoutOutput, 0);
             } else {
@@ -313,9 +312,208 @@ EE rnncell_fp32(TensorDesc xDesc,
             }
             array_scale_f32(lastBatchH, lastBatchH, hDim, rnnParamSpec.zoneoutOutput, 0);
             array_add_f32(out_f, lastBatchH, currentBatchH, hDim);
-        } else {
+        } else if (rank == 0) {
             memcpy(currentBatchH, currentOutput, sizeof(F32) * hDim);
         }
+        // the next step reads the state, and the next batch writes the gates
+        team_barrier();
+    }
+}
+
+static EE rnn_check_fp32(TensorDesc xDesc,
+    TensorDesc filterDesc,
+    TensorDesc hDesc,
+    RNNParamSpec rnnParamSpec,
+    U32 *fn,
+    U32 *fk)
+{
+    DataType idt, fdt, odt;
+    DataFormat idf, fdf, odf;
+    U32 in, ix;
+    U32 on, oh;
+    CHECK_STATUS(tensor2dGet(xDesc, &idt, &idf, &in, &ix));
+    CHECK_STATUS(tensor2dGet(filterDesc, &fdt, &fdf, fn, fk));
+    CHECK_STATUS(tensor2dGet(hDesc, &odt, &odf, &on, &oh));
+    if (fdf != DF_NKN32) {
+        CHECK_STATUS(NOT_MATCH);
+    }
+    *fn /= 32;
+
+    I32 column = (rnnParamSpec.numProjection > 0) ? rnnParamSpec.numProjection
+                                                  : rnnParamSpec.numOutput;
+    if (!(idt == DT_F32 && fdt == DT_F32 && odt == DT_F32)) {
+        CHECK_STATUS(NOT_MATCH);
+    }
+    if (!(4 * column == (I32)(*fn) * 32 && (ix + oh) == *fk && in == on)) {
+        CHECK_STATUS(NOT_MATCH);
+    }
+    if (rnnParamSpec.activationMode != ACTIVATION_TANH) {
+        CHECK_STATUS(NOT_SUPPORTED);
+    }
+    return SUCCESS;
+}
+
+EE rnncell_fp32(TensorDesc xDesc,
+    const void *currentX,
+    const TensorDesc *filterDesc,
+    const void **filter,
+    const TensorDesc *biasDesc,
+    const void **bias,
+    void *state,
+    U32 tmpBytes,
+    void *tmp,
+    RNNParamSpec rnnParamSpec,
+    U32 batchStrideX,
+    U32 batchStrideH,
+    TensorDesc hDesc,
+    void *output,
+    Arch arch)
+{
+    UNUSED(biasDesc);
+    UNUSED(tmpBytes);
+    UNUSED(arch);
+    if (nullptr == currentX || nullptr == filter || nullptr == bias || nullptr == state ||
+        nullptr == tmp || nullptr == output) {
+        CHECK_STATUS(NULL_POINTER);
+    }
+    U32 fn, fk;
+    CHECK_STATUS(rnn_check_fp32(xDesc, filterDesc[0], hDesc, rnnParamSpec, &fn, &fk));
+#ifdef _USE_OPENMP
+#pragma omp parallel num_threads(OMP_NUM_THREADS)
+#endif
+    {
+#ifdef _USE_OPENMP
+        U32 rank = omp_get_thread_num();
+        U32 teamSize = omp_get_num_threads();
+#else
+        U32 rank = 0;
+        U32 teamSize = 1;
+#endif
+        lstmcell_fp32(xDesc.dims[1], xDesc.dims[0], (const F32 *)currentX, batchStrideX, nullptr,
+            0, fn, fk, filter, bias, (F32 *)state, (F32 *)tmp, rnnParamSpec, batchStrideH,
+            (F32 *)output, rank, teamSize);
+    }
+    return SUCCESS;
+}
+
+// The input projection is the same for every step, so it is computed for the whole sequence
+// with one matrix multiplication before the recurrence.
+EE rnn_infer_forward_tmp_bytes_fp32(
+    TensorDesc inputDesc, RNNParamSpec rnnParamSpec, U32 *bytes, Arch arch)
+{
+    DataType idt;
+    DataFormat idf;
+    U32 batch, step, xDim;
+    CHECK_STATUS(tensor3dGet(inputDesc, &idt, &idf, &batch, &step, &xDim));
+    U32 num1 = rnnParamSpec.biDirection ? 2 : 1;
+    U32 hDim = rnnParamSpec.numOutput;
+    U32 column = (rnnParamSpec.numProjection > 0) ? rnnParamSpec.numProjection
+                                                  : rnnParamSpec.numOutput;
+    U32 gates = column * 4;
+    U32 mmmBytes = 0;
+    CHECK_STATUS(matrix_matrix_multiply_tmp_bytes(tensor2df(DT_F32, DF_NORMAL, batch * step, xDim),
+        tensor2df(DT_F32, DF_NORMAL, xDim, gates), &mmmBytes, arch));
+    // W_x, and the projection, state and cell buffer of each direction
+    U32 directionBytes =
+        (batch * step * gates + batch * (column + hDim) + hDim + xDim + gates) * sizeof(F32);
+    *bytes = xDim * gates * sizeof(F32) + num1 * directionBytes + mmmBytes;
+    return SUCCESS;
+}
+
+EE rnn_fp32(TensorDesc inputDesc,
+    const F32 *input,
+    const TensorDesc *filterDesc,
+    const void **filter,
+    const TensorDesc *biasDesc,
+    const void **bias,
+    RNNParamSpec rnnParamSpec,
+    U32 tmpBytes,
+    void *tmp,
+    TensorDesc outputDesc,
+    F32 *output,
+    Arch arch)
+{
+    UNUSED(biasDesc);
+    UNUSED(outputDesc);
+    DataType idt;
+    DataFormat idf;
+    U32 batch, step, xDim;
+    CHECK_STATUS(tensor3dGet(inputDesc, &idt, &idf, &batch, &step, &xDim));
+    U32 num1 = rnnParamSpec.biDirection ? 2 : 1;
+    U32 num2 = (rnnParamSpec.numProjection > 0) ? 2 : 1;
+    U32 hDim = rnnParamSpec.numOutput;
+    U32 column = (rnnParamSpec.numProjection > 0) ? rnnParamSpec.numProjection
+                                                  : rnnParamSpec.numOutput;
+    U32 gates = column * 4;
+    TensorDesc xDesc = tensor2df(idt, DF_NORMAL, batch, xDim);
+    TensorDesc hDesc = tensor2df(idt, DF_NORMAL, batch, hDim);
+    U32 fn, fk;
+    CHECK_STATUS(rnn_check_fp32(xDesc, filterDesc[0], hDesc, rnnParamSpec, &fn, &fk));
+
+    U32 bytes = 0;
+    CHECK_STATUS(rnn_infer_forward_tmp_bytes_fp32(inputDesc, rnnParamSpec, &bytes, arch));
+    if (tmpBytes < bytes) {
+        CHECK_STATUS(NOT_MATCH);
+    }
+    F32 *weight = (F32 *)tmp;
+    F32 *directionTmp = weight + xDim * gates;
+    U32 directionSize = batch * step * gates + batch * (column + hDim) + hDim + xDim + gates;
+    F32 *mmmTmp = directionTmp + num1 * directionSize;
+    U32 mmmBytes = bytes - (mmmTmp - weight) * sizeof(F32);
+
+    TensorDesc inputMatrixDesc = tensor2df(DT_F32, DF_NORMAL, batch * step, xDim);
+    TensorDesc weightDesc = tensor2df(DT_F32, DF_NORMAL, xDim, gates);
+    TensorDesc projectionDesc = tensor2df(DT_F32, DF_NORMAL, batch * step, gates);
+    for (U32 d = 0; d < num1; d++) {
+        const F32 *filterArray = (const F32 *)filter[d * num2];
+        F32 *projection = directionTmp + d * directionSize;
+        // the W_x rows of the NKN32 filter as a [xDim][gates] matrix
+        for (U32 n = 0; n < fn; n++) {
+            for (U32 k = 0; k < xDim; k++) {
+                memcpy(weight + k * gates + n * 32, filterArray + (n * fk + k) * 32,
+                    32 * sizeof(F32));
+            }
+        }
+        for (U32 i = 0; i < batch * step; i++) {
+            memcpy(projection + i * gates, bias[d * num2], gates * sizeof(F32));
+        }
+        CHECK_STATUS(matrix_matrix_multiply(inputMatrixDesc, input, weightDesc, weight, mmmBytes,
+            mmmTmp, projectionDesc, projection, arch));
+    }
+
+    // The directions run at the same time, each on its own team of threads in one parallel
+    // region. With one thread, they run one after another.
+#ifdef _USE_OPENMP
+#pragma omp parallel num_threads(OMP_NUM_THREADS)
+#endif
+    {
+#ifdef _USE_OPENMP
+        U32 threadId = omp_get_thread_num();
+        U32 threadNum = omp_get_num_threads();
+#else
+        U32 threadId = 0;
+        U32 threadNum = 1;
+#endif
+        U32 teamNum = UNI_MIN(num1, threadNum);
+        U32 team = threadId % teamNum;
+        U32 rank = threadId / teamNum;
+        U32 teamSize = (threadNum - team + teamNum - 1) / teamNum;
+        for (U32 d = team; d < num1; d += teamNum) {
+            F32 *projection = directionTmp + d * directionSize;
+            F32 *state = projection + batch * step * gates;
+            F32 *cellTmp = state + batch * (column + hDim);
+            if (rank == 0) {
+                memset(state, 0, batch * (column + hDim) * sizeof(F32));
+            }
+            team_barrier();
+            for (U32 s = 0; s < step; s++) {
+                U32 t = (d == 0) ? s : step - 1 - s;
+                F32 *currentH = output + (t * num1 + d) * hDim;
+                lstmcell_fp32(batch, xDim, input + t * xDim, step * xDim, projection + t * gates,
+                    step * gates, fn, fk, filter + d * num2, bias + d * num2, state, cellTmp,
+                    rnnParamSpec, step * hDim * num1, currentH, rank, teamSize);
+            }
+        }
     }
     return SUCCESS;
 }
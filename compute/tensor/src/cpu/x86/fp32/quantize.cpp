@@ -0,0 +1,70 @@
+// Copyright (C) 2019. Huawei Technologies Co., Ltd. All rights reserved.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "cpu/x86/fp32/tensor_computing_fp32.h"
+
+EE quantize_tensor_fp32(
+    TensorDesc dDesc, const void *data, TensorDesc *qDesc, void *qData, F32 *scale)
+{
+    if (nullptr == data || nullptr == qDesc || nullptr == qData || nullptr == scale) {
+        CHECK_STATUS(NULL_POINTER);
+    }
+    if (dDesc.dt != DT_F32) {
+        CHECK_STATUS(NOT_SUPPORTED);
+    }
+    *qDesc = dDesc;
+    qDesc->dt = DT_I8;
+    const F32 *array = (const F32 *)data;
+    INT8 *qArray = (INT8 *)qData;
+    I32 numData = tensorNumElements(dDesc);
+
+    __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+    __m256 max_v = _mm256_setzero_ps();
+    I32 i = 0;
+    for (; i < numData - 7; i += 8) {
+        max_v = _mm256_max_ps(max_v, _mm256_and_ps(_mm256_loadu_ps(array + i), absMask));
+    }
+    F32 max = _mm256_hmax_ps(max_v);
+    for (; i < numData; i++) {
+        max = UNI_MAX(max, UNI_ABS(array[i]));
+    }
+    if (max == 0) {
+        *scale = 1;
+        memset(qData, 0, tensorNumBytes(*qDesc));
+        return SUCCESS;
+    }
+    F32 scaleRaw = 127.0 / max;
+    UNI_DEBUG_LOG("%f is the max absolute FP32 value\n", max);
+    if (*scale < scaleRaw) {
+        *scale = scaleRaw;
+    }
+
+    // truncate towards zero like round_towards_zero, the values beyond the calibrated range
+    // are clamped to +-127
+    __m256 scale_v = _mm256_set1_ps(*scale);
+    __m256 max127 = _mm256_set1_ps(127.0f);
+    __m256 min127 = _mm256_set1_ps(-127.0f);
+    for (i = 0; i < numData - 7; i += 8) {
+        __m256 x = _mm256_mul_ps(_mm256_loadu_ps(array + i), scale_v);
+        x = _mm256_min_ps(_mm256_max_ps(x, min127), max127);
+        __m256i q32 = _mm256_cvttps_epi32(x);
+        __m128i q16 =
+            _mm_packs_epi32(_mm256_castsi256_si128(q32), _mm256_extracti128_si256(q32, 1));
+        _mm_storel_epi64((__m128i *)(qArray + i), _mm_packs_epi16(q16, q16));
+    }
+    for (; i < numData; i++) {
+        qArray[i] = round_towards_zero(array[i] * (*scale));
+    }
+    UNI_DEBUG_LOG("%f is the quantization scale\n", scale[0]);
+    return SUCCESS;
+}
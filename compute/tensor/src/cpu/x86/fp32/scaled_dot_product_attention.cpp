@@ -0,0 +1,323 @@
+// Copyright (C) 2019. Huawei Technologies Co., Ltd. All rights reserved.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include <math.h>
+#include <float.h>
+#include <string.h>
+#include "cpu/cpu_functions_template.h"
+#include "cpu/x86/fp32/tensor_computing_fp32.h"
+
+// query rows that share the loads of the transposed keys
+#define ATTENTION_QUERY_TILE 4
+// exp(x) of smaller x is flushed to zero
+#define ATTENTION_FLUSH_BOUND -80.0f
+
+// the keys of a head are transposed to [size][kStride] so that 16 scores are computed with
+// two vector loads, kStride pads kLength to the 16 columns of the score kernel
+static inline U32 attention_key_stride(U32 kLength)
+{
+    return (kLength + 15) / 16 * 16;
+}
+
+static inline U32 attention_thread_buffer_size(U32 size, U32 kLength)
+{
+    return size * attention_key_stride(kLength) + ATTENTION_QUERY_TILE * ATTENTION_KEY_TILE;
+}
+
+EE scaled_dot_product_attention_infer_forward_tmp_bytes_fp32(
+    TensorDesc qDesc, TensorDesc kDesc, U32 *bytes)
+{
+    if (nullptr == bytes) {
+        CHECK_STATUS(NULL_POINTER);
+    }
+    // every thread works on its own heads
+    *bytes = attention_thread_buffer_size(qDesc.dims[0], kDesc.dims[2]) * bytesOf(DT_F32) *
+        OMP_NUM_THREADS;
+    return SUCCESS;
+}
+
+// scores of ATTENTION_QUERY_TILE rows and tilePad (multiple of 16) keys
+static void attention_score_fp32(const F32 **qRows,
+    const F32 *keyT,
+    U32 kStride,
+    U32 size,
+    U32 tilePad,
+    F32 *score)
+{
+    for (U32 c = 0; c < tilePad; c += 16) {
+        __m256 acc[ATTENTION_QUERY_TILE][2];
+        for (U32 r = 0; r < ATTENTION_QUERY_TILE; r++) {
+            acc[r][0] = _mm256_setzero_ps();
+            acc[r][1] = _mm256_setzero_ps();
+        }
+        for (U32 d = 0; d < size; d++) {
+            __m256 k0 = _mm256_loadu_ps(keyT + d * kStride + c);
+            __m256 k1 = _mm256_loadu_ps(keyT + d * kStride + c + 8);
+            for (U32 r = 0; r < ATTENTION_QUERY_TILE; r++) {
+                __m256 qv = _mm256_broadcast_ss(qRows[r] + d);
+                acc[r][0] = _mm256_fmadd_ps(qv, k0, acc[r][0]);
+                acc[r][1] = _mm256_fmadd_ps(qv, k1, acc[r][1]);
+            }
+        }
+        for (U32 r = 0; r < ATTENTION_QUERY_TILE; r++) {
+            _mm256_storeu_ps(score + r * ATTENTION_KEY_TILE + c, acc[r][0]);
+            _mm256_storeu_ps(score + r * ATTENTION_KEY_TILE + c + 8, acc[r][1]);
+        }
+    }
+}
+
+// scale and mask the scores of a row in place, return their max
+static F32 attention_scale_mask_fp32(
+    F32 *score, U32 tile, F32 scale, const F32 *mask, U32 maskStride)
+{
+    __m256 scale_v = _mm256_set1_ps(scale);
+    __m256 max_v = _mm256_set1_ps(-FLT_MAX);
+    F32 maxValue = -FLT_MAX;
+    U32 j = 0;
+    for (; j + 8 <= tile; j += 8) {
+        __m256 s = _mm256_mul_ps(_mm256_loadu_ps(score + j), scale_v);
+        if (mask != nullptr) {
+            if (maskStride == 1) {
+                s = _mm256_add_ps(s, _mm256_loadu_ps(mask + j));
+            } else {
+                s = _mm256_add_ps(s, _mm256_set1_ps(mask[0]));
+            }
+        }
+        _mm256_storeu_ps(score + j, s);
+        max_v = _mm256_max_ps(max_v, s);
+    }
+    for (; j < tile; j++) {
+        score[j] *= scale;
+        if (mask != nullptr) {
+            score[j] += mask[j * maskStride];
+        }
+        maxValue = UNI_MAX(maxValue, score[j]);
+    }
+    F32 buffer[8];
+    _mm256_storeu_ps(buffer, max_v);
+    for (U32 i = 0; i < 8; i++) {
+        maxValue = UNI_MAX(maxValue, buffer[i]);
+    }
+    return maxValue;
+}
+
+// exp(score - maxValue) in place, return their sum. The masked keys are flushed to zero, their
+// tiny probabilities would make denormal products with V that are very slow.
+static F32 attention_exp_fp32(F32 *score, U32 tile, F32 maxValue)
+{
+    __m256 max_v = _mm256_set1_ps(maxValue);
+    __m256 sum_v = _mm256_setzero_ps();
+    __m256 flush_v = _mm256_set1_ps(ATTENTION_FLUSH_BOUND);
+    U32 j = 0;
+    for (; j + 8 <= tile; j += 8) {
+        __m256 x = _mm256_sub_ps(_mm256_loadu_ps(score + j), max_v);
+        __m256 e = _mm256_and_ps(_mm256_exp_ps(x), _mm256_cmp_ps(x, flush_v, _CMP_GT_OQ));
+        _mm256_storeu_ps(score + j, e);
+        sum_v = _mm256_add_ps(sum_v, e);
+    }
+    F32 sum = _mm256_sum_ps(sum_v);
+    for (; j < tile; j++) {
+        F32 x = score[j] - maxValue;
+        score[j] = (x > ATTENTION_FLUSH_BOUND) ? exp(x) : 0;
+        sum += score[j];
+    }
+    return sum;
+}
+
+// output = output * correction + p * V of a key tile for the rows of a query tile, p is the
+// score of the rows, V rows are vStride apart
+static void attention_accumulate_fp32(const F32 *p,
+    U32 tile,
+    const F32 *v,
+    U32 vStride,
+    U32 vSize,
+    const F32 *correction,
+    F32 **output)
+{
+    U32 d = 0;
+    for (; d + 16 <= vSize; d += 16) {
+        __m256 acc[ATTENTION_QUERY_TILE][2];
+        for (U32 r = 0; r < ATTENTION_QUERY_TILE; r++) {
+            __m256 correction_v = _mm256_set1_ps(correction[r]);
+            acc[r][0] = _mm256_mul_ps(_mm256_loadu_ps(output[r] + d), correction_v);
+            acc[r][1] = _mm256_mul_ps(_mm256_loadu_ps(output[r] + d + 8), correction_v);
+        }
+        const F32 *vPtr = v + d;
+        for (U32 j = 0; j < tile; j++, vPtr += vStride) {
+            __m256 v0 = _mm256_loadu_ps(vPtr);
+            __m256 v1 = _mm256_loadu_ps(vPtr + 8);
+            for (U32 r = 0; r < ATTENTION_QUERY_TILE; r++) {
+                __m256 pv = _mm256_broadcast_ss(p + r * ATTENTION_KEY_TILE + j);
+                acc[r][0] = _mm256_fmadd_ps(pv, v0, acc[r][0]);
+                acc[r][1] = _mm256_fmadd_ps(pv, v1, acc[r][1]);
+            }
+        }
+        for (U32 r = 0; r < ATTENTION_QUERY_TILE; r++) {
+            _mm256_storeu_ps(output[r] + d, acc[r][0]);
+            _mm256_storeu_ps(output[r] + d + 8, acc[r][1]);
+        }
+    }
+    for (; d + 8 <= vSize; d += 8) {
+        __m256 acc[ATTENTION_QUERY_TILE];
+        for (U32 r = 0; r < ATTENTION_QUERY_TILE; r++) {
+            acc[r] = _mm256_mul_ps(_mm256_loadu_ps(output[r] + d), _mm256_set1_ps(correction[r]));
+        }
+        const F32 *vPtr = v + d;
+        for (U32 j = 0; j < tile; j++, vPtr += vStride) {
+            __m256 v0 = _mm256_loadu_ps(vPtr);
+            for (U32 r = 0; r < ATTENTION_QUERY_TILE; r++) {
+                __m256 pv = _mm256_broadcast_ss(p + r * ATTENTION_KEY_TILE + j);
+                acc[r] = _mm256_fmadd_ps(pv, v0, acc[r]);
+            }
+        }
+        for (U32 r = 0; r < ATTENTION_QUERY_TILE; r++) {
+            _mm256_storeu_ps(output[r] + d, acc[r]);
+        }
+    }
+    for (; d < vSize; d++) {
+        F32 acc[ATTENTION_QUERY_TILE];
+        for (U32 r = 0; r < ATTENTION_QUERY_TILE; r++) {
+            acc[r] = output[r][d] * correction[r];
+            for (U32 j = 0; j < tile; j++) {
+                acc[r] += p[r * ATTENTION_KEY_TILE + j] * v[j * vStride + d];
+            }
+        }
+        for (U32 r = 0; r < ATTENTION_QUERY_TILE; r++) {
+            output[r][d] = acc[r];
+        }
+    }
+}
+
+// one head, the rows of q, k, v and output are rowStride/vRowStride apart
+static void attention_head_fp32(const F32 *q,
+    const F32 *k,
+    const F32 *v,
+    const F32 *mask,
+    const U32 *maskStrides,
+    U32 qLength,
+    U32 kLength,
+    U32 size,
+    U32 vSize,
+    U32 rowStride,
+    U32 vRowStride,
+    F32 scale,
+    F32 *buffer,
+    F32 *output)
+{
+    U32 kStride = attention_key_stride(kLength);
+    F32 *keyT = buffer;
+    F32 *score = keyT + size * kStride;
+    for (U32 d = 0; d < size; d++) {
+        F32 *keyTRow = keyT + d * kStride;
+        for (U32 j = 0; j < kLength; j++) {
+            keyTRow[j] = k[j * rowStride + d];
+        }
+        memset(keyTRow + kLength, 0, (kStride - kLength) * sizeof(F32));
+    }
+
+    for (U32 i0 = 0; i0 < qLength; i0 += ATTENTION_QUERY_TILE) {
+        U32 rows = UNI_MIN(ATTENTION_QUERY_TILE, qLength - i0);
+        // the missing rows of the last tile repeat the last query, they compute and write the
+        // same output as it
+        const F32 *qRows[ATTENTION_QUERY_TILE];
+        F32 *outputRows[ATTENTION_QUERY_TILE];
+        F32 rowMax[ATTENTION_QUERY_TILE];
+        F32 rowSum[ATTENTION_QUERY_TILE];
+        F32 correction[ATTENTION_QUERY_TILE];
+        for (U32 r = 0; r < ATTENTION_QUERY_TILE; r++) {
+            U32 row = i0 + UNI_MIN(r, rows - 1);
+            qRows[r] = q + row * rowStride;
+            outputRows[r] = output + row * vRowStride;
+            rowMax[r] = -FLT_MAX;
+            rowSum[r] = 0;
+        }
+        for (U32 r = 0; r < rows; r++) {
+            memset(outputRows[r], 0, vSize * sizeof(F32));
+        }
+        for (U32 j0 = 0; j0 < kLength; j0 += ATTENTION_KEY_TILE) {
+            U32 tile = UNI_MIN(ATTENTION_KEY_TILE, kLength - j0);
+            attention_score_fp32(qRows, keyT + j0, kStride, size, (tile + 15) / 16 * 16, score);
+            for (U32 r = 0; r < ATTENTION_QUERY_TILE; r++) {
+                F32 *p = score + r * ATTENTION_KEY_TILE;
+                const F32 *maskRow = nullptr;
+                if (mask != nullptr) {
+                    maskRow = mask + (i0 + UNI_MIN(r, rows - 1)) * maskStrides[1] +
+                        j0 * maskStrides[0];
+                }
+                F32 tileMax = attention_scale_mask_fp32(p, tile, scale, maskRow, maskStrides[0]);
+                F32 newMax = UNI_MAX(rowMax[r], tileMax);
+                correction[r] = exp(rowMax[r] - newMax);
+                rowSum[r] = rowSum[r] * correction[r] + attention_exp_fp32(p, tile, newMax);
+                rowMax[r] = newMax;
+            }
+            attention_accumulate_fp32(
+                score, tile, v + j0 * vRowStride, vRowStride, vSize, correction, outputRows);
+        }
+        for (U32 r = 0; r < rows; r++) {
+            array_scale_f32(outputRows[r], outputRows[r], vSize, 1.0 / rowSum[r], 0);
+        }
+    }
+}
+
+EE scaled_dot_product_attention_fp32(TensorDesc qDesc,
+    const F32 *q,
+    TensorDesc kDesc,
+    const F32 *k,
+    TensorDesc vDesc,
+    const F32 *v,
+    TensorDesc maskDesc,
+    const F32 *mask,
+    ScaledDotProductAttentionParamSpec p,
+    U32 tmpBytes,
+    void *tmp,
+    TensorDesc outputDesc,
+    F32 *output)
+{
+    UNUSED(outputDesc);
+    if (nullptr == q || nullptr == k || nullptr == v || nullptr == tmp || nullptr == output) {
+        CHECK_STATUS(NULL_POINTER);
+    }
+    U32 batch = qDesc.dims[3];
+    U32 qLength = qDesc.dims[2];
+    U32 heads = qDesc.dims[1];
+    U32 size = qDesc.dims[0];
+    U32 kLength = kDesc.dims[2];
+    U32 vSize = vDesc.dims[0];
+    U32 bufferSize = attention_thread_buffer_size(size, kLength);
+    if (tmpBytes < bufferSize * bytesOf(DT_F32) * OMP_NUM_THREADS) {
+        CHECK_STATUS(NOT_MATCH);
+    }
+    U32 maskStrides[4];
+    attention_mask_strides(maskDesc, maskStrides);
+#ifdef _USE_OPENMP
+#pragma omp parallel for num_threads(OMP_NUM_THREADS)
+#endif
+    for (U32 h = 0; h < batch * heads; h++) {
+#ifdef _USE_OPENMP
+        U32 threadId = omp_get_thread_num();
+#else
+        U32 threadId = 0;
+#endif
+        U32 b = h / heads;
+        U32 n = h % heads;
+        const F32 *maskHead = nullptr;
+        if (mask != nullptr) {
+            maskHead = mask + b * maskStrides[3] + n * maskStrides[2];
+        }
+        attention_head_fp32(q + (b * qLength * heads + n) * size,
+            k + (b * kLength * heads + n) * size, v + (b * kLength * heads + n) * vSize, maskHead,
+            maskStrides, qLength, kLength, size, vSize, heads * size, heads * vSize, p.scale,
+            (F32 *)tmp + threadId * bufferSize, output + (b * qLength * heads + n) * vSize);
+    }
+    return SUCCESS;
+}
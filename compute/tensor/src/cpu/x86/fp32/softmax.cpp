@@ -103,6 +103,34 @@ void softmax_anyAxis_fp32(const F32 *input, I32 loopOuter, I32 loops, I32 loopIn
     }
 }
 
+// The 8 channels of a block are the lanes of one vector, and the block c of a pixel is at
+// c * hw * 8. The maximum and the sum over the blocks are reduced over the lanes at the end.
+void softmax_nchwc8_channel_fp32(const F32 *input, I32 batch, I32 blocks, I32 hw, F32 *output)
+{
+    I32 blockStride = hw * 8;
+    for (I32 n = 0; n < batch * hw; n++) {
+        const F32 *inputPtr = input + (n / hw) * blocks * blockStride + (n % hw) * 8;
+        F32 *outputPtr = output + (n / hw) * blocks * blockStride + (n % hw) * 8;
+        __m256 max_v = _mm256_loadu_ps(inputPtr);
+        for (I32 c = 1; c < blocks; c++) {
+            max_v = _mm256_max_ps(max_v, _mm256_loadu_ps(inputPtr + c * blockStride));
+        }
+        max_v = _mm256_set1_ps(_mm256_hmax_ps(max_v));
+        __m256 sum_v = _mm256_set1_ps(0.f);
+        for (I32 c = 0; c < blocks; c++) {
+            __m256 in_v = _mm256_loadu_ps(inputPtr + c * blockStride);
+            __m256 exp_v = _mm256_exp_ps(_mm256_sub_ps(in_v, max_v));
+            sum_v = _mm256_add_ps(sum_v, exp_v);
+            _mm256_storeu_ps(outputPtr + c * blockStride, exp_v);
+        }
+        __m256 scale_v = _mm256_set1_ps(1.f / _mm256_sum_ps(sum_v));
+        for (I32 c = 0; c < blocks; c++) {
+            __m256 out_v = _mm256_loadu_ps(outputPtr + c * blockStride);
+            _mm256_storeu_ps(outputPtr + c * blockStride, _mm256_mul_ps(out_v, scale_v));
+        }
+    }
+}
+
 EE softmax_fp32(TensorDesc inputDesc, const F32 *input, int axis, TensorDesc outputDesc, F32 *output)
 {
     UNUSED(outputDesc);
@@ -113,6 +141,13 @@ EE softmax_fp32(TensorDesc inputDesc, const F32 *input, int axis, TensorDesc out
     U32 size = tensorNumElements(inputDesc);
     axis = (axis + inputDesc.nDims) % inputDesc.nDims;
     axis = inputDesc.nDims - 1 - axis;
+    // the other axes of NCHWC8 are given as 5D NCHW by softmax
+    if (DF_NCHWC8 == inputDesc.df) {
+        CHECK_REQUIREMENT(4 == inputDesc.nDims && 2 == axis);
+        softmax_nchwc8_channel_fp32(input, inputDesc.dims[3], inputDesc.dims[2] / 8,
+            inputDesc.dims[1] * inputDesc.dims[0], output);
+        return SUCCESS;
+    }
     I32 loops = inputDesc.dims[axis];
 
     I32 loopInner = 1;
@@ -122,17 +157,8 @@ EE softmax_fp32(TensorDesc inputDesc, const F32 *input, int axis, TensorDesc out
     U32 loopOuter = size / loops / loopInner;
 
     if (loopInner == 1) {
-        if (DF_NCHWC8 == inputDesc.df && 4 == inputDesc.nDims &&
-            (inputDesc.dims[1] != 1 || inputDesc.dims[0] != 1)) {
-            CHECK_REQUIREMENT(2 != axis);
-            loopInner *= 8;
-            loopOuter /= 8;
-            softmax_anyAxis_fp32(input, loopOuter, loops, loopInner, output);
-        } else {
-            softmax_lastAxis_fp32(input, loopOuter, loops, output);
-        }
+        softmax_lastAxis_fp32(input, loopOuter, loops, output);
     } else {
-        CHECK_REQUIREMENT(DF_NCHWC8 != inputDesc.df);
         softmax_anyAxis_fp32(input, loopOuter, loops, loopInner, output);
     }
     return SUCCESS;
@@ -53,6 +53,7 @@ EE convolution_fp32(TensorDesc inputDesc,
     void *tmp,
     TensorDesc outputDesc,
     F32 *output,
+    const F32 *residual,
     ActivationParamSpec activationDesc,
     Arch arch);
 
@@ -67,6 +68,7 @@ EE convolution_direct(TensorDesc inputDesc,
     void *tmp,
     TensorDesc outputDesc,
     F32 *outArray,
+    const F32 *residualArray,
     ActivationParamSpec activationDesc);
 
 EE convolution_1x1_direct(TensorDesc inputDesc,
@@ -79,6 +81,34 @@ EE convolution_1x1_direct(TensorDesc inputDesc,
     void *tmp,
     TensorDesc outputDesc,
     F32 *outArray,
+    const F32 *residualArray,
+    ActivationParamSpec activationDesc);
+
+EE convolution_direct_avx512(TensorDesc inputDesc,
+    F32 *inArray,
+    TensorDesc filterDesc,
+    const F32 *filterArray,
+    ConvolutionParamSpec convParamSpec,
+    TensorDesc biasDesc,
+    const F32 *biasArray,
+    U32 tmpBytes,
+    void *tmp,
+    TensorDesc outputDesc,
+    F32 *outArray,
+    const F32 *residualArray,
+    ActivationParamSpec activationDesc);
+
+EE convolution_1x1_direct_avx512(TensorDesc inputDesc,
+    F32 *inArray,
+    TensorDesc filterDesc,
+    const F32 *filterArray,
+    ConvolutionParamSpec convParamSpec,
+    const F32 *biasArray,
+    U32 tmpBytes,
+    void *tmp,
+    TensorDesc outputDesc,
+    F32 *outArray,
+    const F32 *residualArray,
     ActivationParamSpec activationDesc);
 
 EE convolution_2x2_direct(TensorDesc inputDesc,
@@ -107,6 +137,26 @@ EE convolution_direct_nchw(TensorDesc inputDesc,
     F32 *outArray,
     ActivationParamSpec activationDesc);
 
+// number of the tiles that are transformed and multiplied together by the Winograd convolution
+#define WINOGRAD_TILE_BLOCK 64
+
+EE convolution_winograd_transform_filter_fp32(
+    TensorDesc filterDesc, const F32 *filter, TensorDesc *ftmDesc, F32 *filterTransformed);
+
+EE convolution_winograd(TensorDesc inputDesc,
+    F32 *inArray,
+    TensorDesc filterDesc,
+    const F32 *filterArray,
+    ConvolutionParamSpec convParamSpec,
+    TensorDesc biasDesc,
+    const F32 *biasArray,
+    U32 tmpBytes,
+    void *tmp,
+    TensorDesc outputDesc,
+    F32 *outArray,
+    ActivationParamSpec activationDesc,
+    Arch arch);
+
 EE check_fp32(TensorDesc inputDescA,
     const F32 *inputA,
     TensorDesc inputDescB,
@@ -203,6 +253,24 @@ EE depthwise_convolution_direct(TensorDesc inputDesc,
     ActivationParamSpec depthwiseActivationParamSpec,
     ActivationParamSpec pointwiseActivationParamSpec);
 
+EE depthwise_convolution_direct_avx512(TensorDesc inputDesc,
+    F32 *inArray,
+    TensorDesc dwFilterDesc,
+    const F32 *dwFilterArray,
+    TensorDesc pwFilterDesc,
+    const F32 *pwFilterArray,
+    ConvolutionParamSpec convParamSpec,
+    TensorDesc dwBiasDesc,
+    const F32 *dwBiasArray,
+    TensorDesc pwBiasDesc,
+    const F32 *pwBiasArray,
+    U32 tmpBytes,
+    void *tmp,
+    TensorDesc outputDesc,
+    F32 *outArray,
+    ActivationParamSpec depthwiseActivationParamSpec,
+    ActivationParamSpec pointwiseActivationParamSpec);
+
 EE eltwise_fp32(std::vector<void *> input,
     std::vector<int> inputSize,
     U32 num,
@@ -231,12 +299,31 @@ EE rnncell_fp32(TensorDesc xDesc,
     void *output,
     Arch arch);
 
+EE rnn_infer_forward_tmp_bytes_fp32(
+    TensorDesc inputDesc, RNNParamSpec rnnParamSpec, U32 *bytes, Arch arch);
+
+EE rnn_fp32(TensorDesc inputDesc,
+    const F32 *input,
+    const TensorDesc *filterDesc,
+    const void **filter,
+    const TensorDesc *biasDesc,
+    const void **bias,
+    RNNParamSpec rnnParamSpec,
+    U32 tmpBytes,
+    void *tmp,
+    TensorDesc outputDesc,
+    F32 *output,
+    Arch arch);
+
 EE pooling_fp32(TensorDesc inputDesc,
     const F32 *input,
     PoolingParamSpec poolingParamSpec,
     TensorDesc outputDesc,
     F32 *output);
 
+EE quantize_tensor_fp32(
+    TensorDesc dDesc, const void *data, TensorDesc *qDesc, void *qData, F32 *scale);
+
 EE scale_fp32(F32 *input,
     I32 axis,
     I32 nDims,
@@ -247,6 +334,23 @@ EE scale_fp32(F32 *input,
     I32 elements_per_channel,
     F32 *output);
 
+EE scaled_dot_product_attention_infer_forward_tmp_bytes_fp32(
+    TensorDesc qDesc, TensorDesc kDesc, U32 *bytes);
+
+EE scaled_dot_product_attention_fp32(TensorDesc qDesc,
+    const F32 *q,
+    TensorDesc kDesc,
+    const F32 *k,
+    TensorDesc vDesc,
+    const F32 *v,
+    TensorDesc maskDesc,
+    const F32 *mask,
+    ScaledDotProductAttentionParamSpec p,
+    U32 tmpBytes,
+    void *tmp,
+    TensorDesc outputDesc,
+    F32 *output);
+
 EE softmax_fp32(
     TensorDesc inputDesc, const F32 *input, int axis, TensorDesc outputDesc, F32 *output);
 
@@ -342,6 +342,26 @@ inline void array_add_f32(const F32 *inputA, const F32 *inputB, F32 *output, I32
     }
 }
 
+// output = activation(output + residual) on the NCHWC8 pixels [hw, hw + hwSize) of the channels
+// [ocStart, ocEnd), which is called on a block that the convolution has just written
+inline void convolution_epilogue_fp32(F32 *output,
+    const F32 *residual,
+    U32 ocStart,
+    U32 ocEnd,
+    U32 ohow,
+    U32 hw,
+    U32 hwSize,
+    ActivationParamSpec activationDesc)
+{
+    for (U32 ocb = ocStart; ocb < ocEnd; ocb += 8) {
+        U32 offset = ocb * ohow + hw * 8;
+        array_add_f32(output + offset, residual + offset, output + offset, hwSize * 8);
+        if (activationDesc.mode != ACTIVATION_NULL) {
+            activation_fp32(output + offset, hwSize * 8, activationDesc, output + offset);
+        }
+    }
+}
+
 inline void array_square_and_add_f32(const F32 *inputA, const F32 *inputB, F32 *output, I32 len)
 {
     I32 i = 0;
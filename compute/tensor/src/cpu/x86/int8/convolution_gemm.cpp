@@ -0,0 +1,172 @@
+// Copyright (C) 2019. Huawei Technologies Co., Ltd. All rights reserved.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include <string.h>
+#include "cpu/x86/int8/tensor_computing_int8.h"
+#include "cpu/x86/tensor_computing_x86.h"
+#include "cpu/x86/x86_functions.h"
+#include "blas_enhance.h"
+#ifdef _USE_OPENMP
+#include <omp.h>
+#endif
+
+// lower the NCHWC8 input to [oh * ow][ic / 8][fh][fw][8], the padding is 0
+static void convolution_im2col_int8(U32 ic,
+    U32 ih,
+    U32 iw,
+    U32 fh,
+    U32 fw,
+    U32 oh,
+    U32 ow,
+    ConvolutionParamSpec p,
+    const INT8 *input,
+    INT8 *matrix,
+    U32 K)
+{
+    U32 ic8 = ic / 8;
+#ifdef _USE_OPENMP
+#pragma omp parallel for num_threads(OMP_NUM_THREADS)
+#endif
+    for (U32 m = 0; m < oh * ow; m++) {
+        I32 h = (m / ow) * p.stride_h - p.padding_top;
+        I32 w = (m % ow) * p.stride_w - p.padding_left;
+        INT8 *row = matrix + m * K;
+        for (U32 c = 0; c < ic8; c++) {
+            for (U32 i = 0; i < fh; i++) {
+                I32 hh = h + i * p.dilatedRate_h;
+                for (U32 j = 0; j < fw; j++, row += 8) {
+                    I32 ww = w + j * p.dilatedRate_w;
+                    if (hh < 0 || hh >= (I32)ih || ww < 0 || ww >= (I32)iw) {
+                        *(I64 *)row = 0;
+                    } else {
+                        *(I64 *)row = *(const I64 *)(input + ((c * ih + hh) * iw + ww) * 8);
+                    }
+                }
+            }
+        }
+        memset(row, 0, K - ic * fh * fw);
+    }
+}
+
+// the activations that the epilogue does on the dequantized registers
+inline bool is_epilogue_activation_int8(ActivationParamSpec activationDesc)
+{
+    return activationDesc.mode == ACTIVATION_NULL ||
+        (activationDesc.mode == ACTIVATION_RELU && activationDesc.value[0] == 0) ||
+        activationDesc.mode == ACTIVATION_RELU6;
+}
+
+// dequantize [oh * ow][oc] to NCHWC8 with the bias and the activation
+static void convolution_epilogue_int8(U32 M,
+    U32 oc,
+    const I32 *result,
+    F32 factor,
+    const F32 *bias,
+    ActivationParamSpec activationDesc,
+    F32 *output)
+{
+    __m256 factor_v = _mm256_set1_ps(factor);
+    __m256 zero = _mm256_setzero_ps();
+    __m256 six = _mm256_set1_ps(6.0f);
+#ifdef _USE_OPENMP
+#pragma omp parallel for num_threads(OMP_NUM_THREADS)
+#endif
+    for (U32 m = 0; m < M; m++) {
+        for (U32 o = 0; o < oc; o += 8) {
+            __m256i sum = _mm256_loadu_si256((const __m256i *)(result + m * oc + o));
+            __m256 x = _mm256_cvtepi32_ps(sum);
+            x = _mm256_fmadd_ps(x, factor_v, _mm256_loadu_ps(bias + o));
+            if (activationDesc.mode == ACTIVATION_RELU) {
+                x = _mm256_max_ps(x, zero);
+            } else if (activationDesc.mode == ACTIVATION_RELU6) {
+                x = _mm256_min_ps(_mm256_max_ps(x, zero), six);
+            }
+            _mm256_storeu_ps(output + (o * M + m * 8), x);
+        }
+    }
+}
+
+EE convolution_int8(TensorDesc inputDesc,
+    const void *input,
+    TensorDesc filterDesc,
+    const INT8 *filter,
+    F32 *scales,
+    ConvolutionParamSpec convParamSpec,
+    TensorDesc biasDesc,
+    const F32 *bias,
+    U32 tmpBytes,
+    void *tmp,
+    TensorDesc outputDesc,
+    F32 *output,
+    ActivationParamSpec activationDesc,
+    Arch arch)
+{
+    UNUSED(biasDesc);
+    UNUSED(tmpBytes);
+    if (nullptr == input || nullptr == filter || nullptr == scales || nullptr == bias ||
+        nullptr == tmp || nullptr == output) {
+        CHECK_STATUS(NULL_POINTER);
+    }
+    DataType idt, fdt, odt;
+    DataFormat idf, fdf, odf;
+    U32 in, ic, ih, iw;
+    U32 fn, fc, fh, fw;
+    U32 on, oc, oh, ow;
+    CHECK_STATUS(tensor4dGet(inputDesc, &idt, &idf, &in, &ic, &ih, &iw));
+    CHECK_STATUS(tensor4dGet(filterDesc, &fdt, &fdf, &fn, &fc, &fh, &fw));
+    CHECK_STATUS(tensor4dGet(outputDesc, &odt, &odf, &on, &oc, &oh, &ow));
+    if ((idt != DT_F32 && idt != DT_I8) || idf != DF_NCHWC8 || fdt != DT_I8 ||
+        fdf != DF_NKN32K4 || odt != DT_F32 || odf != DF_NCHWC8) {
+        CHECK_STATUS(NOT_MATCH);
+    }
+    if (ic != fc || oc != fn || ic % 8 != 0 || oc % 8 != 0) {
+        CHECK_STATUS(NOT_MATCH);
+    }
+
+    // the other activations are done on the whole output after it is dequantized
+    ActivationParamSpec kernelActivationDesc = activationDesc;
+    if (!is_epilogue_activation_int8(activationDesc)) {
+        kernelActivationDesc.mode = ACTIVATION_NULL;
+    }
+    U32 M = oh * ow;
+    U32 K = (fc * fh * fw + 3) / 4 * 4;
+    I32 *result = (I32 *)tmp;
+    INT8 *matrix = (INT8 *)(result + M * oc);
+    INT8 *quantized = matrix + M * K;
+    INT8 *gemmTmp = quantized + in * ic * ih * iw;
+    U32 gemmBytes = 0;
+    TensorDesc matrixDesc = tensor2df(DT_I8, DF_NORMAL, M, K);
+    TensorDesc filterMatrixDesc = tensor2df(DT_I8, DF_NKN32K4, K, oc);
+    TensorDesc resultDesc = tensor2df(DT_I32, DF_NORMAL, M, oc);
+    CHECK_STATUS(matrix_matrix_multiply_tmp_bytes(matrixDesc, filterMatrixDesc, &gemmBytes, arch));
+
+    const INT8 *image = (const INT8 *)input;
+    if (idt == DT_F32) {
+        TensorDesc qDesc;
+        CHECK_STATUS(quantize_tensor_x86(inputDesc, input, &qDesc, quantized, scales));
+        image = quantized;
+    }
+    for (U32 n = 0; n < in; n++, image += ic * ih * iw) {
+        convolution_im2col_int8(ic, ih, iw, fh, fw, oh, ow, convParamSpec, image, matrix, K);
+        memset(result, 0, M * oc * bytesOf(DT_I32));
+        CHECK_STATUS(matrix_matrix_multiply(matrixDesc, matrix, filterMatrixDesc, filter,
+            gemmBytes, gemmTmp, resultDesc, result, arch));
+        convolution_epilogue_int8(M, oc, result, 1 / (scales[0] * scales[2]), bias,
+            kernelActivationDesc, output + n * oc * M);
+    }
+    EE ret = SUCCESS;
+    if (kernelActivationDesc.mode != activationDesc.mode) {
+        ret = array_activation_x86(DT_F32, output, in * oc * M, activationDesc, output);
+    }
+    return ret;
+}
@@ -0,0 +1,91 @@
+// Copyright (C) 2019. Huawei Technologies Co., Ltd. All rights reserved.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include <vector>
+#include "cpu/x86/int8/tensor_computing_int8.h"
+#include "blas_enhance.h"
+
+inline U32 convolution_gemm_k(U32 fc, U32 fh, U32 fw)
+{
+    return (fc * fh * fw + 3) / 4 * 4;
+}
+
+EE convolution_transform_filter_bytes_int8(TensorDesc filterDesc, U32 *bytes)
+{
+    DataType fdt;
+    DataFormat fdf;
+    U32 fn, fc, fh, fw;
+    CHECK_STATUS(tensor4dGet(filterDesc, &fdt, &fdf, &fn, &fc, &fh, &fw));
+    *bytes = (fn + 31) / 32 * 32 * convolution_gemm_k(fc, fh, fw) + 32;
+    return SUCCESS;
+}
+
+EE convolution_transform_filter_int8(
+    TensorDesc filterDesc, const INT8 *filter, TensorDesc *ftmDesc, INT8 *filterTransformed)
+{
+    DataType fdt;
+    DataFormat fdf;
+    U32 fn, fc, fh, fw;
+    CHECK_STATUS(tensor4dGet(filterDesc, &fdt, &fdf, &fn, &fc, &fh, &fw));
+    if (fdf == DF_NKN32K4) {
+        *ftmDesc = filterDesc;
+        return SUCCESS;
+    }
+    if (fdt != DT_I8 || fdf != DF_NCHW || fc % 8 != 0) {
+        CHECK_STATUS(NOT_MATCH);
+    }
+    // reorder [fn][fc][fh][fw] to the order of the lowered input, [fn][fc / 8][fh][fw][8]
+    U32 fhfw = fh * fw;
+    U32 K = fc * fhfw;
+    std::vector<INT8> reorder(fn * K);
+    for (U32 n = 0; n < fn; n++) {
+        for (U32 c = 0; c < fc; c++) {
+            for (U32 hw = 0; hw < fhfw; hw++) {
+                U32 dst = n * K + ((c / 8) * fhfw + hw) * 8 + c % 8;
+                reorder[dst] = filter[(n * fc + c) * fhfw + hw];
+            }
+        }
+    }
+    // the packed layout is the same on all x86 archs
+    TensorDesc matrixDesc = tensor2df(DT_I8, DF_TRANSPOSE, fn, K);
+    TensorDesc packDesc;
+    CHECK_STATUS(matrix_matrix_multiply_transform_rhs(
+        matrixDesc, reorder.data(), &packDesc, filterTransformed, X86_AVX2));
+    *ftmDesc = tensor4df(DT_I8, DF_NKN32K4, fn, fc, fh, fw);
+    return SUCCESS;
+}
+
+EE convolution_infer_forward_tmp_bytes_int8(TensorDesc inputDesc,
+    TensorDesc filterDesc,
+    TensorDesc outputDesc,
+    ConvolutionParamSpec convParamSpec,
+    U32 *bytes)
+{
+    UNUSED(convParamSpec);
+    DataType idt, fdt, odt;
+    DataFormat idf, fdf, odf;
+    U32 in, ic, ih, iw;
+    U32 fn, fc, fh, fw;
+    U32 on, oc, oh, ow;
+    CHECK_STATUS(tensor4dGet(inputDesc, &idt, &idf, &in, &ic, &ih, &iw));
+    CHECK_STATUS(tensor4dGet(filterDesc, &fdt, &fdf, &fn, &fc, &fh, &fw));
+    CHECK_STATUS(tensor4dGet(outputDesc, &odt, &odf, &on, &oc, &oh, &ow));
+    U32 M = oh * ow;
+    U32 K = convolution_gemm_k(fc, fh, fw);
+    U32 gemmBytes = 0;
+    CHECK_STATUS(matrix_matrix_multiply_tmp_bytes(tensor2df(DT_I8, DF_NORMAL, M, K),
+        tensor2df(DT_I8, targetFormat4MatrixB(DT_I8), K, oc), &gemmBytes, X86_AVX2));
+    // the int32 result, the lowered input, the quantized input and the buffer of the GEMM
+    *bytes = M * oc * bytesOf(DT_I32) + M * K + in * ic * ih * iw + gemmBytes + 32;
+    return SUCCESS;
+}
@@ -0,0 +1,95 @@
+// Copyright (C) 2019. Huawei Technologies Co., Ltd. All rights reserved.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "cpu/x86/int8/tensor_computing_int8.h"
+#ifdef _USE_OPENMP
+#include <omp.h>
+#endif
+
+EE pooling_int8(TensorDesc inputDesc,
+    const INT8 *input,
+    PoolingParamSpec poolingParamSpec,
+    F32 *scale,
+    TensorDesc outputDesc,
+    INT8 *output)
+{
+    if (nullptr == input || nullptr == output || nullptr == scale) {
+        CHECK_STATUS(NULL_POINTER);
+    }
+    DataType idt, odt;
+    DataFormat idf, odf;
+    U32 in = 0, ic = 0, ih = 0, iw = 0, on = 0, oc = 0, oh = 0, ow = 0;
+    CHECK_STATUS(tensor4dGet(inputDesc, &idt, &idf, &in, &ic, &ih, &iw));
+    CHECK_STATUS(tensor4dGet(outputDesc, &odt, &odf, &on, &oc, &oh, &ow));
+    if (idt != DT_I8 || odt != DT_I8 || idf != DF_NCHWC8 || odf != DF_NCHWC8 || in != on ||
+        ic != oc || ic % 8 != 0) {
+        CHECK_STATUS(NOT_MATCH);
+    }
+    PoolingMode pm = poolingParamSpec.mode;
+    if (pm != POOLING_MAX && pm != POOLING_MEAN) {
+        CHECK_STATUS(NOT_SUPPORTED);
+    }
+    // the mean is rounded in FP32, so both modes keep the scale
+    scale[1] = scale[0];
+
+    U32 strideH = poolingParamSpec.stride_h;
+    U32 strideW = poolingParamSpec.stride_w;
+    U32 paddingT = poolingParamSpec.padding_top;
+    U32 paddingL = poolingParamSpec.padding_left;
+    U32 kernelSizeH = poolingParamSpec.kernel_h;
+    U32 kernelSizeW = poolingParamSpec.kernel_w;
+    U32 blockNum = in * ic / 8;
+#ifdef _USE_OPENMP
+#pragma omp parallel for num_threads(OMP_NUM_THREADS)
+#endif
+    for (U32 b = 0; b < blockNum; b++) {
+        const INT8 *inputPtr = input + b * ih * iw * 8;
+        INT8 *outputPtr = output + b * oh * ow * 8;
+        for (U32 h = 0; h < oh; h++) {
+            for (U32 w = 0; w < ow; w++, outputPtr += 8) {
+                int hstart = (int)h * (int)strideH - (int)paddingT;
+                int wstart = (int)w * (int)strideW - (int)paddingL;
+                int hend = UNI_MIN(hstart + kernelSizeH, ih);
+                int wend = UNI_MIN(wstart + kernelSizeW, iw);
+                hstart = UNI_MAX(hstart, 0);
+                wstart = UNI_MAX(wstart, 0);
+                if (pm == POOLING_MAX) {
+                    __m128i x = _mm_set1_epi8(-128);
+                    for (int kh = hstart; kh < hend; kh++) {
+                        for (int kw = wstart; kw < wend; kw++) {
+                            x = _mm_max_epi8(x,
+                                _mm_loadl_epi64((const __m128i *)(inputPtr + (kh * iw + kw) * 8)));
+                        }
+                    }
+                    _mm_storel_epi64((__m128i *)outputPtr, x);
+                } else {
+                    __m256i sum = _mm256_setzero_si256();
+                    for (int kh = hstart; kh < hend; kh++) {
+                        for (int kw = wstart; kw < wend; kw++) {
+                            sum = _mm256_add_epi32(sum,
+                                _mm256_cvtepi8_epi32(_mm_loadl_epi64(
+                                    (const __m128i *)(inputPtr + (kh * iw + kw) * 8))));
+                        }
+                    }
+                    __m256 mean = _mm256_mul_ps(_mm256_cvtepi32_ps(sum),
+                        _mm256_set1_ps(1.0f / ((hend - hstart) * (wend - wstart))));
+                    __m256i q32 = _mm256_cvtps_epi32(mean);
+                    __m128i q16 = _mm_packs_epi32(
+                        _mm256_castsi256_si128(q32), _mm256_extracti128_si256(q32, 1));
+                    _mm_storel_epi64((__m128i *)outputPtr, _mm_packs_epi16(q16, q16));
+                }
+            }
+        }
+    }
+    return SUCCESS;
+}
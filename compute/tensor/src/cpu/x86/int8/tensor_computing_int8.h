@@ -0,0 +1,58 @@
+// Copyright (C) 2019. Huawei Technologies Co., Ltd. All rights reserved.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef CHEETAH_TENSOR_COMPUTING_INT8_H
+#define CHEETAH_TENSOR_COMPUTING_INT8_H
+#include <immintrin.h>
+#include "sys.h"
+#include "error.h"
+#include "types.h"
+#include "thread_affinity.h"
+
+// The int8 convolution lowers the NCHWC8 input to [oh * ow][ic / 8][fh][fw][8] and multiplies it
+// with the filter packed by the int8 GEMM. The scales are [input, output, filter] like on ARM,
+// the FP32 input is quantized by quantize_tensor and the output is FP32.
+EE convolution_transform_filter_bytes_int8(TensorDesc filterDesc, U32 *bytes);
+
+EE convolution_transform_filter_int8(
+    TensorDesc filterDesc, const INT8 *filter, TensorDesc *ftmDesc, INT8 *filterTransformed);
+
+EE convolution_infer_forward_tmp_bytes_int8(TensorDesc inputDesc,
+    TensorDesc filterDesc,
+    TensorDesc outputDesc,
+    ConvolutionParamSpec convParamSpec,
+    U32 *bytes);
+
+EE convolution_int8(TensorDesc inputDesc,
+    const void *input,
+    TensorDesc filterDesc,
+    const INT8 *filter,
+    F32 *scales,
+    ConvolutionParamSpec convParamSpec,
+    TensorDesc biasDesc,
+    const F32 *bias,
+    U32 tmpBytes,
+    void *tmp,
+    TensorDesc outputDesc,
+    F32 *output,
+    ActivationParamSpec activationDesc,
+    Arch arch);
+
+// scale is [input, output]
+EE pooling_int8(TensorDesc inputDesc,
+    const INT8 *input,
+    PoolingParamSpec poolingParamSpec,
+    F32 *scale,
+    TensorDesc outputDesc,
+    INT8 *output);
+#endif  //CHEETAH_TENSOR_COMPUTING_INT8_H
@@ -15,11 +15,14 @@
 #ifdef _USE_FP32
 #include "cpu/x86/fp32/tensor_computing_fp32.h"
 #endif
+#ifdef _USE_INT8
+#include "cpu/x86/int8/tensor_computing_int8.h"
+#endif
 
 EE pooling_x86(TensorDesc inputDesc,
     const void *input,
     PoolingParamSpec poolingParamSpec,
-    const void *scale,
+    void *scale,
     TensorDesc outputDesc,
     void *output)
 {
@@ -32,6 +35,13 @@ EE pooling_x86(TensorDesc inputDesc,
                 inputDesc, (const F32 *)input, poolingParamSpec, outputDesc, (F32 *)output);
             break;
         }
+#endif
+#ifdef _USE_INT8
+        case DT_I8: {
+            ret = pooling_int8(inputDesc, (const INT8 *)input, poolingParamSpec, (F32 *)scale,
+                outputDesc, (INT8 *)output);
+            break;
+        }
 #endif
         default:
             ret = NOT_SUPPORTED;
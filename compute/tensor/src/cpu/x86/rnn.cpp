@@ -47,3 +47,50 @@ EE rnncell_x86(TensorDesc xDesc,
     }
     return ret;
 }
+
+EE rnn_infer_forward_tmp_bytes_x86(
+    TensorDesc inputDesc, RNNParamSpec rnnParamSpec, U32 *bytes, Arch arch)
+{
+    EE ret = SUCCESS;
+    switch (inputDesc.dt) {
+#ifdef _USE_FP32
+        case DT_F32: {
+            ret = rnn_infer_forward_tmp_bytes_fp32(inputDesc, rnnParamSpec, bytes, arch);
+            break;
+        }
+#endif
+        default:
+            ret = NOT_SUPPORTED;
+            break;
+    }
+    return ret;
+}
+
+EE rnn_x86(TensorDesc inputDesc,
+    const void *input,
+    const TensorDesc *filterDesc,
+    const void **filter,
+    const TensorDesc *biasDesc,
+    const void **bias,
+    RNNParamSpec rnnParamSpec,
+    U32 tmpBytes,
+    void *tmp,
+    TensorDesc outputDesc,
+    void *output,
+    Arch arch)
+{
+    EE ret = SUCCESS;
+    switch (inputDesc.dt) {
+#ifdef _USE_FP32
+        case DT_F32: {
+            ret = rnn_fp32(inputDesc, (const F32 *)input, filterDesc, filter, biasDesc, bias,
+                rnnParamSpec, tmpBytes, tmp, outputDesc, (F32 *)output, arch);
+            break;
+        }
+#endif
+        default:
+            ret = NOT_SUPPORTED;
+            break;
+    }
+    return ret;
+}
@@ -0,0 +1,66 @@
+// Copyright (C) 2019. Huawei Technologies Co., Ltd. All rights reserved.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "cpu/x86/tensor_computing_x86.h"
+#ifdef _USE_FP32
+#include "cpu/x86/fp32/tensor_computing_fp32.h"
+#endif
+
+EE scaled_dot_product_attention_infer_forward_tmp_bytes_x86(
+    TensorDesc qDesc, TensorDesc kDesc, U32 *bytes)
+{
+    EE ret = SUCCESS;
+    switch (qDesc.dt) {
+#ifdef _USE_FP32
+        case DT_F32: {
+            ret = scaled_dot_product_attention_infer_forward_tmp_bytes_fp32(qDesc, kDesc, bytes);
+            break;
+        }
+#endif
+        default:
+            ret = NOT_SUPPORTED;
+            break;
+    }
+    return ret;
+}
+
+EE scaled_dot_product_attention_x86(TensorDesc qDesc,
+    const void *q,
+    TensorDesc kDesc,
+    const void *k,
+    TensorDesc vDesc,
+    const void *v,
+    TensorDesc maskDesc,
+    const void *mask,
+    ScaledDotProductAttentionParamSpec p,
+    U32 tmpBytes,
+    void *tmp,
+    TensorDesc outputDesc,
+    void *output)
+{
+    EE ret = SUCCESS;
+    switch (qDesc.dt) {
+#ifdef _USE_FP32
+        case DT_F32: {
+            ret = scaled_dot_product_attention_fp32(qDesc, (const F32 *)q, kDesc, (const F32 *)k,
+                vDesc, (const F32 *)v, maskDesc, (const F32 *)mask, p, tmpBytes, tmp, outputDesc,
+                (F32 *)output);
+            break;
+        }
+#endif
+        default:
+            ret = NOT_SUPPORTED;
+            break;
+    }
+    return ret;
+}
@@ -43,6 +43,16 @@ EE convolution_infer_forward_algorithm_x86(TensorDesc inputDesc,
     ConvolutionForwardAlgorithm *algorithm,
     DataType targetDataType);
 
+EE convolution_tune_forward_algorithm_x86(TensorDesc inputDesc,
+    TensorDesc filterDesc,
+    TensorDesc outputDesc,
+    ConvolutionParamSpec convParamSpec,
+    DataType targetDataType,
+    ActivationParamSpec activationDesc,
+    ConvolutionForwardAlgorithm *algorithm,
+    F32 *time,
+    Arch arch);
+
 EE convolution_transform_filter_bytes_x86(TensorDesc filterDesc,
     ConvolutionParamSpec convParamSpec,
     ConvolutionForwardAlgorithm algorithm,
@@ -76,6 +86,7 @@ EE convolution_x86(TensorDesc inputDesc,
     void *tmp,
     TensorDesc outputDesc,
     void *output,
+    const void *residual,
     ActivationParamSpec activationDesc,
     Arch arch);
 
@@ -166,6 +177,22 @@ EE rnncell_x86(TensorDesc xDesc,
     void *currentH,
     Arch arch);
 
+EE rnn_infer_forward_tmp_bytes_x86(
+    TensorDesc inputDesc, RNNParamSpec rnnParamSpec, U32 *bytes, Arch arch);
+
+EE rnn_x86(TensorDesc inputDesc,
+    const void *input,
+    const TensorDesc *filterDesc,
+    const void **filter,
+    const TensorDesc *biasDesc,
+    const void **bias,
+    RNNParamSpec rnnParamSpec,
+    U32 tmpBytes,
+    void *tmp,
+    TensorDesc outputDesc,
+    void *output,
+    Arch arch);
+
 EE scale_x86(TensorDesc inputDesc,
     void *input,
     void *alpha,
@@ -177,12 +204,32 @@ EE scale_x86(TensorDesc inputDesc,
 EE pooling_x86(TensorDesc inputDesc,
     const void *input,
     PoolingParamSpec poolingParamSpec,
-    const void *scale,
+    void *scale,
     TensorDesc outputDesc,
     void *output);
 
+EE quantize_tensor_x86(
+    TensorDesc dDesc, const void *data, TensorDesc *qDesc, void *qData, void *scale);
+
 EE reshape_x86(TensorDesc inputDesc, void *input, TensorDesc outputDesc, void *output);
 
+EE scaled_dot_product_attention_infer_forward_tmp_bytes_x86(
+    TensorDesc qDesc, TensorDesc kDesc, U32 *bytes);
+
+EE scaled_dot_product_attention_x86(TensorDesc qDesc,
+    const void *q,
+    TensorDesc kDesc,
+    const void *k,
+    TensorDesc vDesc,
+    const void *v,
+    TensorDesc maskDesc,
+    const void *mask,
+    ScaledDotProductAttentionParamSpec p,
+    U32 tmpBytes,
+    void *tmp,
+    TensorDesc outputDesc,
+    void *output);
+
 EE softmax_x86(
     TensorDesc inputDesc, const void *input, SoftmaxParamSpec p, TensorDesc outputDesc, void *output);
 
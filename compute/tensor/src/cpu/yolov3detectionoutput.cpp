@@ -11,119 +11,71 @@
 // COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
-#include "error.h"
+#include <limits>
 #include "cpu/tensor_computing_cpu.h"
+#include "cpu/detection_functions.h"
 
-inline EE qsort_descent(std::vector<BoxRect> &boxes, std::vector<F32> &scores, int left, int right)
+// The candidates are the boxes of all the inputs, at most one per anchor, and an input in
+// NCHWC8 format is converted to NCHW in tmp first.
+static U32 yolov3detectionoutput_candidates(
+    std::vector<TensorDesc> inputDesc, U32 num_box, U32 *transformBytes)
 {
-    if (boxes.empty() || scores.empty()) {
-        return NOT_SUPPORTED;
-    }
-
-    int i = left;
-    int j = right;
-    F32 temp = scores[(left + right) / 2];
-
-    while (i <= j) {
-        while (scores[i] > temp) {
-            i++;
-        }
-        while (scores[j] < temp) {
-            j--;
-        }
-        if (i <= j) {
-            std::swap(boxes[i], boxes[j]);
-            std::swap(scores[i], scores[j]);
-            i++;
-            j--;
+    U32 num = 0;
+    *transformBytes = 0;
+    for (U32 i = 0; i < inputDesc.size(); i++) {
+        num += num_box * inputDesc[i].dims[0] * inputDesc[i].dims[1];
+        if (inputDesc[i].df == DF_NCHWC8) {
+            *transformBytes = UNI_MAX(*transformBytes, tensorNumBytes(inputDesc[i]));
         }
     }
-
-    if (left < j) {
-        qsort_descent(boxes, scores, left, j);
-    }
-    if (i < right) {
-        qsort_descent(boxes, scores, i, right);
-    }
-
-    return SUCCESS;
-}
-
-inline F32 intersectionarea(BoxRect a, BoxRect b)
-{
-    if (a.xmin > b.xmax || a.xmax < b.xmin || a.ymin > b.ymax || a.ymax < b.ymin) {
-        return 0.f;
-    }
-    F32 inter_width = std::min(a.xmax, b.xmax) - std::max(a.xmin, b.xmin);
-    F32 inter_height = std::min(a.ymax, b.ymax) - std::max(a.ymin, b.ymin);
-
-    return inter_width * inter_height;
+    return num;
 }
 
-inline EE nms_pickedboxes(std::vector<BoxRect> boxes, std::vector<I64> &picked, F32 nms_threshold)
+EE yolov3detectionoutput_infer_forward_tmp_bytes_cpu(std::vector<TensorDesc> inputDesc,
+    Yolov3DetectionOutputParamSpec p,
+    U32 maxOutput,
+    U32 *bytes)
 {
-    I64 n = boxes.size();
-
-    std::vector<F32> areas(n);
-    for (I64 i = 0; i < n; i++) {
-        BoxRect box = boxes[i];
-
-        F32 width = box.xmax - box.xmin;
-        F32 height = box.ymax - box.ymin;
-
-        areas[i] = width * height;
-    }
-    for (I64 i = 0; i < n; i++) {
-        BoxRect a = boxes[i];
-        int keep = 1;
-        for (int j = 0; j < (int)picked.size(); j++) {
-            BoxRect b = boxes[picked[j]];
-            F32 inter_area = intersectionarea(a, b);
-            F32 union_area = areas[i] + areas[picked[j]] - inter_area;
-
-            if (inter_area / union_area > nms_threshold) {
-                keep = 0;
-            }
-        }
-        if (keep) {
-            picked.push_back(i);
-        }
+    if (nullptr == bytes) {
+        CHECK_STATUS(NULL_POINTER);
     }
+    U32 transformBytes;
+    U32 num = yolov3detectionoutput_candidates(inputDesc, p.num_box, &transformBytes);
+    U32 max_keep = UNI_MIN(num, maxOutput);
+    *bytes = transformBytes + box_array_bytes(num) + num * (2 * sizeof(U32) + sizeof(F32)) +
+        box_array_bytes(max_keep) + max_keep * sizeof(U32);
     return SUCCESS;
 }
 
 template <typename T>
-EE yolov3detectionoutput(std::vector<void *> input,
+static EE yolov3detectionoutput(std::vector<void *> input,
     T *output,
     std::vector<TensorDesc> inputDesc,
     Yolov3DetectionOutputParamSpec yolov3DetectionOutputParamSpec,
+    U32 maxOutput,
+    void *tmp,
     Arch arch)
 {
     U32 num_class = yolov3DetectionOutputParamSpec.num_class;
     U32 num_box = yolov3DetectionOutputParamSpec.num_box;
     F32 confidence_threshold = yolov3DetectionOutputParamSpec.confidence_threshold;
     F32 nms_threshold = yolov3DetectionOutputParamSpec.nms_threshold;
-    std::vector<F32> biases;
-    for (int i = 0; i < 18; i++) {
-        if (yolov3DetectionOutputParamSpec.biases[i] == 0) {
-            break;
-        }
-        biases.push_back(yolov3DetectionOutputParamSpec.biases[i]);
-    }
-    std::vector<U32> anchors_scale;
-    for (int i = 0; i < 3; i++) {
-        if (yolov3DetectionOutputParamSpec.anchors_scale[i] == 0) {
-            break;
-        }
-        anchors_scale.push_back(yolov3DetectionOutputParamSpec.anchors_scale[i]);
-    }
-    std::vector<U32> mask;
-    for (int i = 0; i < (int)(yolov3DetectionOutputParamSpec.mask_group_num * 3); i++) {
-        mask.push_back(yolov3DetectionOutputParamSpec.mask[i]);
-    }
-
-    std::vector<BoxRect> all_boxrects;
-    std::vector<F32> all_boxscores;
+    F32 *biases = yolov3DetectionOutputParamSpec.biases;
+    U32 *anchors_scale = yolov3DetectionOutputParamSpec.anchors_scale;
+    U32 *mask = yolov3DetectionOutputParamSpec.mask;
+
+    U32 transformBytes;
+    U32 num = yolov3detectionoutput_candidates(inputDesc, num_box, &transformBytes);
+    U32 max_keep = UNI_MIN(num, maxOutput);
+    T *transformed = (T *)tmp;
+    BoxArray all_boxes = box_array_create((U8 *)tmp + transformBytes, num);
+    F32 *all_scores = (F32 *)((U8 *)tmp + transformBytes + box_array_bytes(num));
+    U32 *all_labels = (U32 *)(all_scores + num);
+    U32 *index = all_labels + num;
+    BoxArray kept = box_array_create(index + num, max_keep);
+    U32 *picked = (U32 *)((U8 *)kept.xmin + box_array_bytes(max_keep));
+
+    U32 count = 0;
     I64 input_size = inputDesc.size();
     U32 info_per_box = 4 + 1 + num_class;
     ActivationParamSpec activationdesc_sigmoid;
@@ -133,16 +85,11 @@ EE yolov3detectionoutput(std::vector<void *> input,
         T *in = (T *)input[i];
         CHECK_REQUIREMENT(inputDesc[i].df == DF_NCHWC8 || inputDesc[i].df == DF_NCHW);
         if (inputDesc[i].df == DF_NCHWC8) {
-            T *tmp = (T *)malloc(tensorNumBytes(inputDesc[0]));
-            memcpy(tmp, in, tensorNumBytes(inputDesc[0]));
-            CHECK_STATUS(transformToNCHW(inputDesc[0], tmp, inputDesc[0], in));
-            free(tmp);
+            TensorDesc nchwDesc = inputDesc[i];
+            nchwDesc.df = DF_NCHW;
+            CHECK_STATUS(transformToNCHW(inputDesc[i], in, nchwDesc, transformed));
+            in = transformed;
         }
-        std::vector<std::vector<BoxRect>> allbox_boxrects;
-        std::vector<std::vector<F32>> allbox_boxscores;
-        allbox_boxrects.resize(num_box);
-        allbox_boxscores.resize(num_box);
-
         U32 w = inputDesc[i].dims[0];
         U32 h = inputDesc[i].dims[1];
         U32 net_w = (U32)(anchors_scale[i] * w);
@@ -190,50 +137,34 @@ EE yolov3detectionoutput(std::vector<void *> input,
                         F32 box_ymin = box_cy - box_h * 0.5;
                         F32 box_xmax = box_cx + box_w * 0.5;
                         F32 box_ymax = box_cy + box_h * 0.5;
-                        BoxRect box = {box_xmin, box_ymin, box_xmax, box_ymax, label};
-                        allbox_boxrects[b].push_back(box);
-                        allbox_boxscores[b].push_back(score_conf);
+                        box_array_set(all_boxes, count, box_xmin, box_ymin, box_xmax, box_ymax);
+                        all_scores[count] = score_conf;
+                        all_labels[count] = label;
+                        count++;
                     }
                     idx++;
                 }
             }
         }
-
-        for (U32 b = 0; b < num_box; b++) {
-            all_boxrects.insert(
-                all_boxrects.end(), allbox_boxrects[b].begin(), allbox_boxrects[b].end());
-            all_boxscores.insert(
-                all_boxscores.end(), allbox_boxscores[b].begin(), allbox_boxscores[b].end());
-        }
     }
-    // sort boxes
-    qsort_descent(all_boxrects, all_boxscores, 0, static_cast<int>(all_boxscores.size() - 1));
+    // sort boxes, the candidates already passed the confidence threshold
+    F32 lowest = -std::numeric_limits<F32>::infinity();
+    U32 sorted = detection_top_k(all_scores, count, 1, lowest, count, index);
     // apply nms
-    std::vector<I64> picked;
-    nms_pickedboxes(all_boxrects, picked, nms_threshold);
+    U32 num_detected =
+        detection_nms(all_boxes, index, sorted, nms_threshold, max_keep, kept, picked);
 
-    std::vector<BoxRect> boxrects;
-    std::vector<F32> boxscores;
-    for (I64 p = 0; p < (I64)picked.size(); p++) {
-        I64 picked_box = picked[p];
-        boxrects.push_back(all_boxrects[picked_box]);
-        boxscores.push_back(all_boxscores[picked_box]);
-    }
-
-    U32 num_detected = static_cast<U32>(boxrects.size());
     // the first box contains the number of availble boxes
     output[0] = num_detected;
     output[1] = output[2] = output[3] = output[4] = output[5] = 0;
     for (U32 i = 0; i < num_detected; i++) {
-        BoxRect b = boxrects[i];
-        F32 score = boxscores[i];
-
-        output[(i + 1) * 6] = b.label + 1;
-        output[(i + 1) * 6 + 1] = score;
-        output[(i + 1) * 6 + 2] = b.xmin;
-        output[(i + 1) * 6 + 3] = b.ymin;
-        output[(i + 1) * 6 + 4] = b.xmax;
-        output[(i + 1) * 6 + 5] = b.ymax;
+        U32 k = picked[i];
+        output[(i + 1) * 6] = all_labels[k] + 1;
+        output[(i + 1) * 6 + 1] = all_scores[k];
+        output[(i + 1) * 6 + 2] = kept.xmin[i];
+        output[(i + 1) * 6 + 3] = kept.ymin[i];
+        output[(i + 1) * 6 + 4] = kept.xmax[i];
+        output[(i + 1) * 6 + 5] = kept.ymax[i];
     }
     return SUCCESS;
 }
@@ -241,27 +172,34 @@ EE yolov3detectionoutput(std::vector<void *> input,
 EE yolov3detectionoutput_cpu(std::vector<TensorDesc> inputDesc,
     std::vector<void *> input,
     Yolov3DetectionOutputParamSpec yolov3DetectionOutputParamSpec,
+    U32 tmpBytes,
+    void *tmp,
     TensorDesc outputDesc,
     void *output,
     Arch arch)
 {
-    UNUSED(outputDesc);
-    if (nullptr == output) {
+    if (nullptr == output || nullptr == tmp) {
         CHECK_STATUS(NULL_POINTER);
     }
+    // the first box saves the number of available boxes
+    U32 maxOutput = outputDesc.dims[1] - 1;
+    U32 bytes = 0;
+    CHECK_STATUS(yolov3detectionoutput_infer_forward_tmp_bytes_cpu(
+        inputDesc, yolov3DetectionOutputParamSpec, maxOutput, &bytes));
+    CHECK_REQUIREMENT(tmpBytes >= bytes);
     EE ret = SUCCESS;
     switch (inputDesc[0].dt) {
 #ifdef _USE_FP32
         case DT_F32: {
-            ret = yolov3detectionoutput(
-                input, (F32 *)output, inputDesc, yolov3DetectionOutputParamSpec, arch);
+            ret = yolov3detectionoutput(input, (F32 *)output, inputDesc,
+                yolov3DetectionOutputParamSpec, maxOutput, tmp, arch);
             break;
         }
 #endif
 #ifdef _USE_FP16
         case DT_F16: {
-            ret = yolov3detectionoutput(
-                input, (F16 *)output, inputDesc, yolov3DetectionOutputParamSpec, arch);
+            ret = yolov3detectionoutput(input, (F16 *)output, inputDesc,
+                yolov3DetectionOutputParamSpec, maxOutput, tmp, arch);
             break;
         }
 #endif
@@ -116,7 +116,7 @@ EE deconvolution_infer_forward_algorithm(Tensor inputTensor,
         ret = SUCCESS;
 #endif
 #if defined(_USE_NEON) || defined(_USE_X86)
-    } else if (IS_X86_AVX2(arch) || IS_ARM(arch)) {
+    } else if (IS_X86(arch) || IS_ARM(arch)) {
         ret = deconvolution_infer_forward_algorithm_cpu(inputDesc, filterDesc, outputDesc,
             convParamSpec, policy, algorithm, targetDataType, arch);
 #endif
@@ -146,7 +146,7 @@ EE deconvolution_transform_filter_bytes(Tensor filterTensor,
         ret = SUCCESS;
 #endif
 #if defined(_USE_NEON) || defined(_USE_X86)
-    } else if (IS_X86_AVX2(arch) || IS_ARM(arch)) {
+    } else if (IS_X86(arch) || IS_ARM(arch)) {
         ret = deconvolution_transform_filter_bytes_cpu(
             filterDesc, convParamSpec, algorithm, bytes, arch);
 #endif
@@ -181,7 +181,7 @@ EE deconvolution_transform_filter(Tensor filterTensor,
         ret = SUCCESS;
 #endif
 #if defined(_USE_NEON) || defined(_USE_X86)
-    } else if (IS_X86_AVX2(arch) || IS_ARM(arch)) {
+    } else if (IS_X86(arch) || IS_ARM(arch)) {
         ret = deconvolution_transform_filter_cpu(
             filterDesc, filter, convParamSpec, algorithm, &ftmDesc, filterTransformed, arch);
 #endif
@@ -216,7 +216,7 @@ EE deconvolution_infer_forward_tmp_bytes(Tensor inputTensor,
         ret = SUCCESS;
 #endif
 #if defined(_USE_NEON) || defined(_USE_X86)
-    } else if (IS_X86_AVX2(arch) || IS_ARM(arch)) {
+    } else if (IS_X86(arch) || IS_ARM(arch)) {
         ret = deconvolution_infer_forward_tmp_bytes_cpu(
             inputDesc, filterDesc, outputDesc, convParamSpec, algorithm, bytes, archInfo->arch);
 #endif
@@ -260,7 +260,7 @@ EE deconvolution(Tensor inputTensor,
             scale, biasDesc, bias, outputDesc, output, activationDesc);
 #endif
 #if defined(_USE_NEON) || defined(_USE_X86)
-    } else if (IS_X86_AVX2(arch) || IS_ARM(arch)) {
+    } else if (IS_X86(arch) || IS_ARM(arch)) {
         ret = deconvolution_cpu(inputDesc, input, filterDesc, filter, convParamSpec, algorithm,
             scaleDesc, scale, biasDesc, bias, tmpBytes, tmp, outputDesc, output, activationDesc,
             archInfo->arch);
@@ -121,7 +121,7 @@ EE depthwise_convolution_infer_forward_algorithm(Tensor inputTensor,
         ret = SUCCESS;
 #endif
 #ifdef _USE_X86
-    } else if (IS_X86_AVX2(arch)) {
+    } else if (IS_X86(arch)) {
         *algorithm = DEPTHWISE_CONVOLUTION_ALGORITHM_DIRECT;
         ret = SUCCESS;
 #endif
@@ -195,7 +195,7 @@ EE depthwise_convolution_transform_filter(Tensor filterTensor,
         ret = SUCCESS;
 #endif
 #ifdef _USE_X86
-    } else if (IS_X86_AVX2(arch)) {
+    } else if (IS_X86(arch)) {
         ret = depthwise_convolution_transform_filter_x86(
             filterDesc, filter, algorithm, &ftmDesc, filterTransformed);
 #endif
@@ -235,7 +235,7 @@ EE depthwise_convolution_infer_forward_tmp_bytes(Tensor inputTensor,
         ret = SUCCESS;
 #endif
 #ifdef _USE_X86
-    } else if (IS_X86_AVX2(arch)) {
+    } else if (IS_X86(arch)) {
         ret = depthwise_convolution_infer_forward_tmp_bytes_x86(
             inputDesc, outputDesc, convParamSpec, algorithm, bytes);
 #endif
@@ -283,7 +283,7 @@ EE depthwise_convolution(Tensor inputTensor,
             biasDesc, bias, tmpBytes, tmp, outputDesc, output, depthwiseActivationParamSpec);
 #endif
 #ifdef _USE_X86
-    } else if (IS_X86_AVX2(arch)) {
+    } else if (IS_X86(arch)) {
         ret = depthwise_convolution_x86(inputDesc, input, filterDesc, filter, convParamSpec,
             algorithm, biasDesc, bias, tmpBytes, tmp, outputDesc, output,
             depthwiseActivationParamSpec, archInfo->arch);
@@ -132,7 +132,7 @@ EE depthwise_pointwise_convolution_infer_forward_algorithm(Tensor inputTensor,
         ret = SUCCESS;
 #endif
 #ifdef _USE_X86
-    } else if (IS_X86_AVX2(arch)) {
+    } else if (IS_X86(arch)) {
         *algorithm = DEPTHWISE_POINTWISE_CONVOLUTION_ALGORITHM_DIRECT;
         ret = SUCCESS;
 #endif
@@ -172,7 +172,7 @@ EE depthwise_pointwise_convolution_transform_filter_bytes(Tensor dwFilterTensor,
         ret = SUCCESS;
 #endif
 #ifdef _USE_X86
-    } else if (IS_X86_AVX2(arch)) {
+    } else if (IS_X86(arch)) {
         *dwBytes = tensorNumBytes(dwFilterDesc) + 32;
         *pwBytes = tensorNumBytes(pwFilterDesc) + 32;
         ret = SUCCESS;
@@ -225,7 +225,7 @@ EE depthwise_pointwise_convolution_transform_filter(Tensor dwFilterTensor,
         ret = SUCCESS;
 #endif
 #ifdef _USE_X86
-    } else if (IS_X86_AVX2(arch)) {
+    } else if (IS_X86(arch)) {
         ret = depthwise_pointwise_convolution_transform_filter_x86(dwFilterDesc, dwFilter,
             pwFilterDesc, pwFilter, algorithm, &dwFtmDesc, dwFilterTransformed, &pwFtmDesc,
             pwFilterTransformed);
@@ -272,7 +272,7 @@ EE depthwise_pointwise_convolution_infer_forward_tmp_bytes(Tensor inputTensor,
             inputDesc, dwFilterDesc, pwFilterDesc, outputDesc, convParamSpec, algorithm, bytes);
 #endif
 #ifdef _USE_X86
-    } else if (IS_X86_AVX2(arch)) {
+    } else if (IS_X86(arch)) {
         ret = depthwise_convolution_infer_forward_tmp_bytes_x86(
             inputDesc, outputDesc, convParamSpec, algorithm, bytes);
 #endif
@@ -328,7 +328,7 @@ EE depthwise_pointwise_convolution(Tensor inputTensor,
             tmp, outputDesc, output, depthwiseActivationParamSpec, pointwiseActivationParamSpec);
 #endif
 #ifdef _USE_X86
-    } else if (IS_X86_AVX2(arch)) {
+    } else if (IS_X86(arch)) {
         ret = depthwise_pointwise_convolution_x86(inputDesc, input, dwFilterDesc, dwFilter,
             pwFilterDesc, pwFilter, convParamSpec, algorithm, dwBiasDesc, dwBias, pwBiasDesc,
             pwBias, tmpBytes, tmp, outputDesc, output, depthwiseActivationParamSpec,
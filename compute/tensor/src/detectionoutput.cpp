@@ -64,21 +64,41 @@ EE detectionoutput_infer_output_size(std::vector<Tensor *> inputTensor,
     return SUCCESS;
 }
 
+EE detectionoutput_infer_forward_tmp_bytes(std::vector<Tensor> inputTensor,
+    DetectionOutputParamSpec detectionOutputParamSpec,
+    U32 *bytes,
+    ArchInfo_t archInfo)
+{
+    std::vector<TensorDesc> inputDesc = get_desc_from_tensors(inputTensor);
+    EE ret = NOT_SUPPORTED;
+    if (IS_CPU(archInfo->arch)) {
+#ifdef _USE_CPU
+        ret = detectionoutput_infer_forward_tmp_bytes_cpu(
+            inputDesc, detectionOutputParamSpec, bytes);
+#endif
+    }
+    return ret;
+}
+
 EE detectionoutput(std::vector<Tensor> inputTensor,
     DetectionOutputParamSpec detectionOutputParamSpec,
+    Tensor tmpTensor,
     Tensor outputTensor,
     ArchInfo_t archInfo)
 {
     auto arch = archInfo->arch;
     std::vector<TensorDesc> inputDesc = get_desc_from_tensors(inputTensor);
     std::vector<void *> input = get_data_from_tensors<void *>(inputTensor, arch);
+    U32 tmpBytes = tmpTensor.bytes();
+    void *tmp = get_ptr_from_tensor(tmpTensor, arch);
     TensorDesc outputDesc = outputTensor.get_desc();
     void *output = get_ptr_from_tensor(outputTensor, arch);
 
     EE ret = NOT_SUPPORTED;
     if (IS_CPU(arch)) {
 #ifdef _USE_CPU
-        ret = detectionoutput_cpu(inputDesc, input, detectionOutputParamSpec, outputDesc, output);
+        ret = detectionoutput_cpu(
+            inputDesc, input, detectionOutputParamSpec, tmpBytes, tmp, outputDesc, output);
 #endif
     }
     return ret;
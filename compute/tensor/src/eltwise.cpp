@@ -64,6 +64,11 @@ inline EE eltwise_infer_output_size_cpu(std::vector<TensorDesc> inputDesc, Tenso
 
     if (nchwc8Count > 0 && nchwc8Count != num) {
         outputDesc->df = DF_NCHW;
+#ifdef _USE_CPU
+        if (eltwise_nchwc8_broadcast_cpu(inputDesc)) {
+            outputDesc->df = DF_NCHWC8;
+        }
+#endif
     }
 
     for (U32 i = 0; i < dim; i++) {
@@ -123,15 +128,27 @@ EE eltwise_infer_forward_tmp_bytes(
     if (nchwc8Count == inputDesc.size() || nchwc8Count == 0) {
         *bytes = 0;
     }
+#ifdef _USE_CPU
+    if (IS_CPU(archInfo->arch) && eltwise_nchwc8_broadcast_cpu(inputDesc)) {
+        *bytes = 0;
+    }
+#endif
     return SUCCESS;
 }
 
 #ifdef _USE_INT8
-inline void eltwise_process_int8(F32 scale, U8 **tmp, TensorDesc *desc, U8 **input)
+inline void eltwise_process_int8(
+    F32 scale, U8 **tmp, TensorDesc *desc, U8 **input, DataType floatType)
 {
     INT8 *inQ = (INT8 *)(*input);
-    dequantize_int8_to_fp16(tensorNumElements(*desc), inQ, scale, (F16 *)*tmp);
-    desc->dt = DT_F16;
+    if (floatType == DT_F32) {
+        dequantize_int8_to_fp32(tensorNumElements(*desc), inQ, scale, (F32 *)*tmp);
+    } else {
+#ifdef _USE_FP16
+        dequantize_int8_to_fp16(tensorNumElements(*desc), inQ, scale, (F16 *)*tmp);
+#endif
+    }
+    desc->dt = floatType;
     *input = *tmp;
     *tmp += tensorNumElements(*desc);
 }
@@ -155,7 +172,8 @@ EE eltwise(std::vector<Tensor> inputTensor,
         for (U32 i = 0; i < inputTensor.size(); i++) {
             if (inputDesc[i].dt == DT_I8) {
                 F32 scale = inputTensor[i].get_scale();
-                eltwise_process_int8(scale, (U8 **)&tmp, &inputDesc[i], (U8 **)&input[i]);
+                eltwise_process_int8(
+                    scale, (U8 **)&tmp, &inputDesc[i], (U8 **)&input[i], outputDesc.dt);
             }
         }
     }
@@ -15,6 +15,9 @@
 
 #include "tensor_computing.h"
 #include "blas_enhance.h"
+#if defined(_USE_GENERAL) || defined(_USE_X86) || defined(_USE_NEON)
+#include "cpu/cpu_functions.h"
+#endif
 #ifdef _USE_MALI
 #include "gpu/mali/tensor_computing_mali.h"
 #endif
@@ -152,11 +155,14 @@ EE fully_connected_infer_forward_tmp_bytes(
             ret = matrix_vector_multiply_tmp_bytes(filterDesc, in_desc, bytes, archInfo->arch);
         }
         if (DT_I8 == filterDesc.dt) {
-            if (DT_F16 == inputTensor.get_desc().dt) {
+            DataType floatType = inputTensor.get_desc().dt;
+            if (DT_F16 == floatType || DT_F32 == floatType) {
                 *bytes += tensorNumBytes(inputDesc);
             }
-            *bytes += filterDesc.dims[0] * bytesOf(DT_I32);       // Bias
-            *bytes += in * filterDesc.dims[1] * bytesOf(DT_I32);  // Results before quantization
+            // the order of dims depends on the transform of the weight
+            U32 num = UNI_MAX(filterDesc.dims[0], filterDesc.dims[1]);
+            *bytes += num * bytesOf(DT_I32);       // Bias
+            *bytes += in * num * bytesOf(DT_I32);  // Results before quantization
         }
     }
     return ret;
@@ -177,6 +183,13 @@ EE fully_connected_transform_filter_bytes(Tensor filterTensor, U32 *bytes, ArchI
             CHECK_STATUS(NULL_POINTER);
         }
         *bytes = tensorNumBytes(filterDesc) + 32;
+#ifdef _USE_X86
+        if (IS_X86(archInfo->arch) && DT_I8 == filterDesc.dt) {
+            // the packed int8 weight is padded to 32 columns and 4 rows
+            *bytes = (filterDesc.dims[0] + 31) / 32 * 32 * ((filterDesc.dims[1] + 31) / 32 * 32) +
+                32;
+        }
+#endif
     }
     return SUCCESS;
 }
@@ -315,14 +328,60 @@ EE fully_connected_transform_filter(
     return ret;
 }
 
+#ifdef _USE_CPU
+// the residual add and the activation that follow the multiplication, the functions are got
+// once because the epilogue is called on every small block of the output
+typedef struct {
+    TensorDesc outputDesc;
+    U8 *output;
+    const U8 *residual;
+    ActivationParamSpec activationDesc;
+    ArrayAddFunction add;
+    ArrayActivationFunction activation;
+} FullyConnectedEpilogue;
+
+static void fully_connected_epilogue(
+    U32 rowStart, U32 rowNum, U32 colStart, U32 colNum, void *param)
+{
+    FullyConnectedEpilogue *p = (FullyConnectedEpilogue *)param;
+    DataType dt = p->outputDesc.dt;
+    for (U32 i = rowStart; i < rowStart + rowNum; i++) {
+        U32 offset = (i * p->outputDesc.dims[0] + colStart) * bytesOf(dt);
+        U8 *output = p->output + offset;
+        if (p->residual != nullptr) {
+            p->add(dt, output, p->residual + offset, output, colNum);
+        }
+        if (p->activationDesc.mode != ACTIVATION_NULL) {
+            CHECK_STATUS(p->activation(dt, output, colNum, p->activationDesc, output));
+        }
+    }
+}
+#endif
+
 EE fully_connected(Tensor inputTensor,
     Tensor filterTensor,
     Tensor biasTensor,
     Tensor tmpTensor,
     Tensor outputTensor,
     ArchInfo_t archInfo)
+{
+    ActivationParamSpec activationDesc;
+    activationDesc.mode = ACTIVATION_NULL;
+    return fully_connected_with_epilogue(inputTensor, filterTensor, biasTensor, tmpTensor,
+        outputTensor, nullptr, activationDesc, archInfo);
+}
+
+EE fully_connected_with_epilogue(Tensor inputTensor,
+    Tensor filterTensor,
+    Tensor biasTensor,
+    Tensor tmpTensor,
+    Tensor outputTensor,
+    Tensor *residualTensor,
+    ActivationParamSpec activationDesc,
+    ArchInfo_t archInfo)
 {
     auto arch = archInfo->arch;
+    bool hasEpilogue = (residualTensor != nullptr || activationDesc.mode != ACTIVATION_NULL);
     TensorDesc inputDesc = inputTensor.get_desc();
     void *input = get_ptr_from_tensor(inputTensor, arch);
     TensorDesc filterDesc = filterTensor.get_desc();
@@ -337,6 +396,9 @@ EE fully_connected(Tensor inputTensor,
     EE ret = NOT_SUPPORTED;
     if (IS_MALI_GPU(arch)) {
 #ifdef _USE_MALI
+        if (hasEpilogue) {
+            return NOT_SUPPORTED;
+        }
         std::vector<GCLMem_t> filterVec;
         std::vector<GCLMem_t> biasVec;
         std::vector<GCLMem_t> outputVec;
@@ -351,10 +413,46 @@ EE fully_connected(Tensor inputTensor,
         if (input == nullptr || filter == nullptr || output == nullptr) {
             CHECK_STATUS(NULL_POINTER);
         }
+        if (residualTensor != nullptr &&
+            tensorNumElements(residualTensor->get_desc()) != tensorNumElements(outputDesc)) {
+            return NOT_MATCH;
+        }
+        // the int8 result is dequantized before the epilogue
+        bool fuseEpilogue = hasEpilogue && DT_I8 != filterDesc.dt;
+        MatrixEpilogueFunction epilogueFunction = nullptr;
+#ifdef _USE_CPU
+        FullyConnectedEpilogue epilogue;
+        epilogue.outputDesc = outputDesc;
+        epilogue.output = (U8 *)output;
+        epilogue.residual = nullptr;
+        if (residualTensor != nullptr) {
+            epilogue.residual = (const U8 *)get_ptr_from_tensor(*residualTensor, arch);
+        }
+        epilogue.activationDesc = activationDesc;
+        epilogue.add = get_array_add_function(arch);
+        epilogue.activation = get_array_activation_function(arch);
+        ActivationParamSpec postActivationDesc;
+        postActivationDesc.mode = ACTIVATION_NULL;
+        if (fuseEpilogue && !is_block_activation(activationDesc.mode)) {
+            postActivationDesc = activationDesc;
+            epilogue.activationDesc.mode = ACTIVATION_NULL;
+            fuseEpilogue = (residualTensor != nullptr);
+        }
+        if (fuseEpilogue) {
+            epilogueFunction = fully_connected_epilogue;
+        }
+#endif
 
 #ifdef _USE_INT8
         F32 scaleI = inputTensor.get_scale();
         if (DT_I8 == filterDesc.dt) {
+            if (DT_F32 == inputDesc.dt) {
+                INT8 *inQ = (INT8 *)tmp;
+                quantize_tensor(inputDesc, input, &inputDesc, inQ, &scaleI);
+                input = (U8 *)tmp;
+                tmp = (U8 *)tmp + tensorNumBytes(inputDesc);
+            }
+#ifdef _USE_FP16
             if (DT_F16 == inputDesc.dt) {
                 F16 *inD = (F16 *)input;
                 INT8 *inQ = (INT8 *)tmp;
@@ -364,11 +462,14 @@ EE fully_connected(Tensor inputTensor,
                 input = (U8 *)tmp;
                 tmp = (U8 *)tmp + tensorNumBytes(inputDesc);
             }
+#endif
             if (nullptr != bias) {
-                if (DT_F16 == outputDesc.dt) {  // dequantize and then add bias
+                // dequantize and then add bias
+                if (DT_F16 == outputDesc.dt || DT_F32 == outputDesc.dt) {
                     bias = nullptr;
                 } else {
                     CHECK_REQUIREMENT(DT_I8 == outputDesc.dt);
+#ifdef _USE_FP16
                     biasDesc.dt = DT_I32;
                     F16 *biasF = (F16 *)bias;
                     I32 *biasI = (I32 *)tmp;
@@ -378,6 +479,9 @@ EE fully_connected(Tensor inputTensor,
                     }
                     bias = tmp;
                     tmp = (U8 *)tmp + tensorNumBytes(biasDesc);
+#else
+                    CHECK_STATUS(NOT_SUPPORTED);
+#endif
                 }
             }
             outputDesc.dt = DT_I32;
@@ -419,17 +523,37 @@ EE fully_connected(Tensor inputTensor,
         } else {
             memset(output, 0, tensorNumBytes(outputDesc));
         }
-        if (in == 1 &&
-            fdf != targetFormat4MatrixB(fdt)) {  // If weight is transformed for mmm, don't run as mvm
+        // If weight is transformed for mmm, don't run as mvm
+        bool mvm = (in == 1 && fdf != targetFormat4MatrixB(fdt));
+#ifdef _USE_X86
+        if (IS_X86(arch) && DT_I8 == fdt) {
+            // mmm and mvm share the packed int8 weight of x86, only the order of dims differs
+            mvm = (in == 1);
+            filterDesc = mvm ? tensor2df(fdt, fdf, ow, ic * ih * iw)
+                             : tensor2df(fdt, fdf, ic * ih * iw, ow);
+        }
+#endif
+        if (mvm) {
             TensorDesc vectorDesc = tensor1d(idt, ic * ih * iw);
             TensorDesc resultDesc = tensor1d(odt, ow);
             ret = matrix_vector_multiply(filterDesc, filter, vectorDesc, input, tmpBytes, tmp,
                 resultDesc, output, archInfo->arch);
+            if (ret == SUCCESS && epilogueFunction != nullptr) {
+                epilogueFunction(0, 1, 0, ow, &epilogue);
+            }
         } else {
             TensorDesc in_desc = tensor2df(idt, DF_NORMAL, in, ic * ih * iw);
-            ret = matrix_matrix_multiply(in_desc, input, filterDesc, filter, tmpBytes, tmp,
-                outputDesc, output, archInfo->arch);
+            // the epilogue runs on the blocks of the output once the bias and the product have
+            // been accumulated, which keeps the order of the additions of the unfused operators
+            ret = matrix_matrix_multiply_with_epilogue(in_desc, input, filterDesc, filter,
+                tmpBytes, tmp, outputDesc, output, epilogueFunction, &epilogue, archInfo->arch);
         }
+#ifdef _USE_CPU
+        if (ret == SUCCESS && postActivationDesc.mode != ACTIVATION_NULL) {
+            ret = epilogue.activation(
+                odt, output, tensorNumElements(outputDesc), postActivationDesc, output);
+        }
+#endif
 #ifdef _USE_INT8
         F32 scale = scaleI * filterTensor.get_scale();
         if (DT_I8 == filterDesc.dt) {
@@ -437,12 +561,30 @@ EE fully_connected(Tensor inputTensor,
                 CHECK_STATUS(quantize_tensor(outputDesc, output, &outputDesc,
                     get_ptr_from_tensor(outputTensor, arch), &scale));
                 outputTensor.set_scale(scale);
+            } else if (DT_F32 == outputTensor.get_desc().dt) {
+                F32 *biasF = (F32 *)get_ptr_from_tensor(biasTensor, arch);
+                U32 biasLen = nullptr == biasF ? 0 : tensorNumElements(biasDesc);
+                dequantize_int32_to_fp32(tensorNumElements(outputDesc), (I32 *)output, scale,
+                    (F32 *)get_ptr_from_tensor(outputTensor, arch), biasLen, biasF);
             } else {
                 CHECK_REQUIREMENT(DT_F16 == outputTensor.get_desc().dt);
+#ifdef _USE_FP16
                 F16 *biasF = (F16 *)get_ptr_from_tensor(biasTensor, arch);
                 U32 biasLen = nullptr == biasF ? 0 : tensorNumElements(biasDesc);
                 dequantize_int32_to_fp16(tensorNumElements(outputDesc), (I32 *)output, scale,
                     (F16 *)get_ptr_from_tensor(outputTensor, arch), biasLen, biasF);
+#endif
+            }
+            if (hasEpilogue) {
+                if (DT_I8 == outputTensor.get_desc().dt) {
+                    return NOT_SUPPORTED;
+                }
+#ifdef _USE_CPU
+                epilogue.outputDesc = outputTensor.get_desc();
+                epilogue.output = (U8 *)get_ptr_from_tensor(outputTensor, arch);
+                epilogue.activationDesc = activationDesc;
+                fully_connected_epilogue(0, oh, 0, ow, &epilogue);
+#endif
             }
         }
 #endif
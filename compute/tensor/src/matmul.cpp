@@ -14,6 +14,7 @@
 #include "tensor_computing.h"
 #include "blas_enhance.h"
 #include <string.h>
+#include <vector>
 #ifdef _USE_MALI
 #include "gpu/mali/tensor_computing_mali.h"
 #endif
@@ -45,28 +46,16 @@ EE matmul_infer_output_size_cpu(TensorDesc matrixADesc,
         CHECK_REQUIREMENT(1 == matrixBDesc.dims[1] && 1 == matrixBDesc.dims[0]);
     }
 
-    int i = 0;
-    int j = 0;
-    int dimA = matrixADesc.nDims;
-    int dimB = matrixBDesc.nDims;
-    while (i < dimA - 2 || j < dimB - 2) {
-        if (matrixADesc.dims[dimA - 1 - i] != matrixBDesc.dims[dimB - 1 - j]) {
-            if (matrixADesc.dims[dimA - 1 - i] == 1) {
-                i++;
-                continue;
-            }
-            if (matrixBDesc.dims[dimB - 1 - j] == 1) {
-                j++;
-                continue;
-            }
+    // the batch dimensions are broadcast like numpy, the missing dimensions are 1
+    U32 nDims = UNI_MAX(matrixADesc.nDims, matrixBDesc.nDims);
+    U32 batchDims[6];
+    for (U32 i = 2; i < nDims; i++) {
+        U32 dimA = (i < matrixADesc.nDims) ? matrixADesc.dims[i] : 1;
+        U32 dimB = (i < matrixBDesc.nDims) ? matrixBDesc.dims[i] : 1;
+        if (dimA != dimB && dimA != 1 && dimB != 1) {
             CHECK_STATUS(NOT_MATCH);
-        } else {
-            i++;
-            j++;
         }
-    }
-    if (i != dimA - 2 || j != dimB - 2) {
-        CHECK_STATUS(NOT_MATCH);
+        batchDims[i] = (dimA == 1) ? dimB : dimA;
     }
 
     U32 kDimA, kDimB;
@@ -85,12 +74,12 @@ EE matmul_infer_output_size_cpu(TensorDesc matrixADesc,
         CHECK_STATUS(NOT_MATCH);
     }
 
-    *matrixCDesc = matrixADesc;
-    (*matrixCDesc).dims[kDimA] = matrixBDesc.dims[1 - kDimB];
-    if (transposeA) {
-        U32 tmp = (*matrixCDesc).dims[0];
-        (*matrixCDesc).dims[0] = (*matrixCDesc).dims[1];
-        (*matrixCDesc).dims[1] = tmp;
+    *matrixCDesc = (matrixADesc.nDims >= matrixBDesc.nDims) ? matrixADesc : matrixBDesc;
+    (*matrixCDesc).dt = matrixADesc.dt;
+    (*matrixCDesc).dims[0] = matrixBDesc.dims[1 - kDimB];
+    (*matrixCDesc).dims[1] = matrixADesc.dims[1 - kDimA];
+    for (U32 i = 2; i < nDims; i++) {
+        (*matrixCDesc).dims[i] = batchDims[i];
     }
     return SUCCESS;
 }
@@ -180,12 +169,12 @@ EE matmul_infer_forward_tmp_bytes(Tensor matrixATensor,
     bool quantA = false;
     bool quantB = false;
     if (DT_I8 == matrixADesc.dt || DT_I8 == matrixBDesc.dt) {
-        if (DT_F16 == matrixADesc.dt) {
+        if (DT_F16 == matrixADesc.dt || DT_F32 == matrixADesc.dt) {
             quantA = true;
             matrixADesc.dt = DT_I8;
         }
 
-        if (DT_F16 == matrixBDesc.dt) {
+        if (DT_F16 == matrixBDesc.dt || DT_F32 == matrixBDesc.dt) {
             quantB = true;
             matrixBDesc.dt = DT_I8;
         }
@@ -225,7 +214,9 @@ EE matmul_infer_forward_tmp_bytes(Tensor matrixATensor,
             tensor2df(matrixADesc.dt, dataFormatA, matrixADesc.dims[1], matrixADesc.dims[0]);
         TensorDesc matrixB2Ddesc =
             tensor2df(matrixBDesc.dt, dataFormatB, matrixBDesc.dims[1], matrixBDesc.dims[0]);
-        ret = matrix_matrix_multiply_tmp_bytes(matrixA2DDesc, matrixB2Ddesc, bytes, archInfo->arch);
+        U32 numB = tensorNumElements(matrixBDesc) / (matrixBDesc.dims[1] * matrixBDesc.dims[0]);
+        ret = matrix_matrix_multiply_batch_tmp_bytes(
+            matrixA2DDesc, matrixB2Ddesc, numB, bytes, archInfo->arch);
     }
 
     if (quantA) {
@@ -234,9 +225,67 @@ EE matmul_infer_forward_tmp_bytes(Tensor matrixATensor,
     if (quantB) {
         *bytes += tensorNumBytes(matrixBDesc);
     }
+    if (DT_I8 == matrixADesc.dt) {
+        // the int32 result
+        TensorDesc matrixCDesc;
+        CHECK_STATUS(matmul_infer_output_size_cpu(
+            matrixADesc, transposeA, matrixBDesc, transposeB, &matrixCDesc));
+        matrixCDesc.dt = DT_I32;
+        *bytes += tensorNumBytes(matrixCDesc);
+    }
     return ret;
 }
 
+#ifdef _USE_INT8
+// quantize the float matrix to the head of tmp and return its scale
+inline F32 matmul_quantize(TensorDesc *desc, void **data, void **tmp, F32 scale)
+{
+    INT8 *qData = (INT8 *)(*tmp);
+    if (DT_F32 == desc->dt) {
+        quantize_tensor(*desc, *data, desc, qData, &scale);
+    } else {
+#ifdef _USE_FP16
+        F16 scaleF16 = scale;
+        quantize_tensor(*desc, *data, desc, qData, &scaleF16);
+        scale = scaleF16;
+#endif
+    }
+    *data = qData;
+    *tmp = (U8 *)(*tmp) + tensorNumBytes(*desc);
+    return scale;
+}
+#endif
+
+// the 2D matrices of A and B that are multiplied to each 2D matrix of C, the batch dimensions of
+// size 1 are broadcast
+static void matmul_batch_index(TensorDesc matrixADesc,
+    TensorDesc matrixBDesc,
+    TensorDesc matrixCDesc,
+    std::vector<U32> *indexA,
+    std::vector<U32> *indexB)
+{
+    U32 batch = tensorNumElements(matrixCDesc) / (matrixCDesc.dims[1] * matrixCDesc.dims[0]);
+    indexA->resize(batch);
+    indexB->resize(batch);
+    for (U32 i = 0; i < batch; i++) {
+        U32 a = 0, b = 0, strideA = 1, strideB = 1;
+        for (U32 d = 2, id = i; d < matrixCDesc.nDims; d++) {
+            U32 x = id % matrixCDesc.dims[d];
+            id /= matrixCDesc.dims[d];
+            if (d < matrixADesc.nDims) {
+                a += (matrixADesc.dims[d] == 1) ? 0 : x * strideA;
+                strideA *= matrixADesc.dims[d];
+            }
+            if (d < matrixBDesc.nDims) {
+                b += (matrixBDesc.dims[d] == 1) ? 0 : x * strideB;
+                strideB *= matrixBDesc.dims[d];
+            }
+        }
+        (*indexA)[i] = a;
+        (*indexB)[i] = b;
+    }
+}
+
 EE matmul(Tensor matrixATensor,
     bool transposeA,
     Tensor matrixBTensor,
@@ -248,6 +297,7 @@ EE matmul(Tensor matrixATensor,
     auto arch = archInfo->arch;
     U32 tmpBytes = tmpTensor.bytes();
     void *tmp = get_ptr_from_tensor(tmpTensor, arch);
+    U8 *tmpStart = (U8 *)tmp;
     TensorDesc matrixADesc = matrixATensor.get_desc();
     void *matrixA = get_ptr_from_tensor(matrixATensor, arch);
     TensorDesc matrixBDesc = matrixBTensor.get_desc();
@@ -270,27 +320,15 @@ EE matmul(Tensor matrixATensor,
 #ifdef _USE_INT8
     F32 scaleO = 1;
     if (DT_I8 == matrixADesc.dt || DT_I8 == matrixBDesc.dt) {
-        if (DT_F16 == matrixADesc.dt) {
-            F16 *inD = (F16 *)matrixA;
-            INT8 *inQ = (INT8 *)tmp;
-            F16 scale = matrixATensor.get_scale();
-            quantize_tensor(matrixADesc, inD, &matrixADesc, inQ, &scale);
-            scaleO *= scale;
-            matrixA = (U8 *)tmp;
-            tmp = (U8 *)tmp + tensorNumBytes(matrixADesc);
-        } else {
+        if (DT_I8 == matrixADesc.dt) {
             scaleO *= matrixATensor.get_scale();
-        }
-        if (DT_F16 == matrixBDesc.dt) {
-            F16 *inD = (F16 *)matrixB;
-            INT8 *inQ = (INT8 *)tmp;
-            F16 scale = matrixBTensor.get_scale();
-            quantize_tensor(matrixBDesc, inD, &matrixBDesc, inQ, &scale);
-            scaleO *= scale;
-            matrixB = (U8 *)tmp;
-            tmp = (U8 *)tmp + tensorNumBytes(matrixBDesc);
         } else {
+            scaleO *= matmul_quantize(&matrixADesc, &matrixA, &tmp, matrixATensor.get_scale());
+        }
+        if (DT_I8 == matrixBDesc.dt) {
             scaleO *= matrixBTensor.get_scale();
+        } else {
+            scaleO *= matmul_quantize(&matrixBDesc, &matrixB, &tmp, matrixBTensor.get_scale());
         }
         matrixCDesc.dt = DT_I32;
         matrixC = tmp;
@@ -298,19 +336,27 @@ EE matmul(Tensor matrixATensor,
     }
 #endif
 
-    U32 sizeA = tensorNumElements(matrixADesc);
-    U32 loops = sizeA / (matrixADesc.dims[1] * matrixADesc.dims[0]);
+    std::vector<U32> indexA, indexB;
+    matmul_batch_index(matrixADesc, matrixBDesc, matrixCDesc, &indexA, &indexB);
+    U32 batch = indexA.size();
     U32 kDimA, kDimB;
+    DataFormat dataFormatA, dataFormatB;
     if (transposeA) {
         kDimA = 1;
+        dataFormatA = DF_TRANSPOSE;
     } else {
         kDimA = 0;
+        dataFormatA = DF_NORMAL;
     }
     if (transposeB) {
         kDimB = 0;
+        dataFormatB = DF_TRANSPOSE;
     } else {
         kDimB = 1;
+        dataFormatB = DF_NORMAL;
     }
+    // the quantized matrices are at the head of tmp
+    tmpBytes -= (U8 *)tmp - tmpStart;
 
     U32 matrixA2DBytes = (matrixADesc.dims[1] * matrixADesc.dims[0]) * bytesOf(matrixADesc.dt);
     U32 matrixB2DBytes = (matrixBDesc.dims[1] * matrixBDesc.dims[0]) * bytesOf(matrixBDesc.dt);
@@ -318,54 +364,40 @@ EE matmul(Tensor matrixATensor,
     U8 *matrixAPtr = (U8 *)matrixA;
     U8 *matrixBPtr = (U8 *)matrixB;
     U8 *matrixCPtr = (U8 *)matrixC;
-    memset(matrixC, 0, tensorNumBytes(matrixCDesc));
-    for (U32 i = 0; i < loops; i++) {
-        if (matrixADesc.dims[1 - kDimA] == 1) {
-            TensorDesc matrixA1DDesc = tensor1d(matrixADesc.dt, matrixADesc.dims[kDimA]);
-            TensorDesc matrixB2DDesc = tensor2df(matrixBDesc.dt,
-                transposeB ? DF_NORMAL : DF_TRANSPOSE, matrixBDesc.dims[1], matrixBDesc.dims[0]);
-            TensorDesc matrixC1DDesc = tensor1d(matrixCDesc.dt, matrixCDesc.dims[0]);
-            CHECK_STATUS(matrix_vector_multiply(matrixB2DDesc, matrixBPtr, matrixA1DDesc,
-                matrixAPtr, tmpBytes, tmp, matrixC1DDesc, matrixCPtr, archInfo->arch));
-        } else {
-            if (matrixBDesc.dims[1 - kDimB] == 1) {
-                TensorDesc matrixA2DDesc;
-                if (transposeA) {
-                    matrixA2DDesc = tensor2df(
-                        matrixADesc.dt, DF_TRANSPOSE, matrixADesc.dims[1], matrixADesc.dims[0]);
-                } else {
-                    matrixA2DDesc = tensor2df(
-                        matrixADesc.dt, DF_NORMAL, matrixADesc.dims[1], matrixADesc.dims[0]);
-                }
-                TensorDesc matrixB1DDesc = tensor1d(matrixBDesc.dt, matrixBDesc.dims[kDimB]);
-                TensorDesc matrixC1DDesc = tensor1d(matrixCDesc.dt, matrixCDesc.dims[1]);
-                CHECK_STATUS(matrix_vector_multiply(matrixA2DDesc, matrixAPtr, matrixB1DDesc,
-                    matrixBPtr, tmpBytes, tmp, matrixC1DDesc, matrixCPtr, archInfo->arch));
+    if (matrixADesc.dims[1 - kDimA] == 1 || matrixBDesc.dims[1 - kDimB] == 1) {
+        for (U32 i = 0; i < batch; i++) {
+            U8 *a = matrixAPtr + indexA[i] * matrixA2DBytes;
+            U8 *b = matrixBPtr + indexB[i] * matrixB2DBytes;
+            U8 *c = matrixCPtr + i * matrixC2DBytes;
+            memset(c, 0, matrixC2DBytes);
+            if (matrixADesc.dims[1 - kDimA] == 1) {
+                TensorDesc matrixA1DDesc = tensor1d(matrixADesc.dt, matrixADesc.dims[kDimA]);
+                TensorDesc matrixB2DDesc = tensor2df(matrixBDesc.dt,
+                    transposeB ? DF_NORMAL : DF_TRANSPOSE, matrixBDesc.dims[1],
+                    matrixBDesc.dims[0]);
+                TensorDesc matrixC1DDesc = tensor1d(matrixCDesc.dt, matrixCDesc.dims[0]);
+                CHECK_STATUS(matrix_vector_multiply(matrixB2DDesc, b, matrixA1DDesc, a, tmpBytes,
+                    tmp, matrixC1DDesc, c, archInfo->arch));
             } else {
-                DataFormat dataFormatA, dataFormatB;
-                if (transposeA) {
-                    dataFormatA = DF_TRANSPOSE;
-                } else {
-                    dataFormatA = DF_NORMAL;
-                }
-                if (transposeB) {
-                    dataFormatB = DF_TRANSPOSE;
-                } else {
-                    dataFormatB = DF_NORMAL;
-                }
                 TensorDesc matrixA2DDesc = tensor2df(
                     matrixADesc.dt, dataFormatA, matrixADesc.dims[1], matrixADesc.dims[0]);
-                TensorDesc matrixB2DDesc = tensor2df(
-                    matrixBDesc.dt, dataFormatB, matrixBDesc.dims[1], matrixBDesc.dims[0]);
-                TensorDesc matrixC2DDesc =
-                    tensor2df(matrixCDesc.dt, DF_NORMAL, matrixCDesc.dims[1], matrixCDesc.dims[0]);
-                CHECK_STATUS(matrix_matrix_multiply(matrixA2DDesc, matrixAPtr, matrixB2DDesc,
-                    matrixBPtr, tmpBytes, tmp, matrixC2DDesc, matrixCPtr, archInfo->arch));
+                TensorDesc matrixB1DDesc = tensor1d(matrixBDesc.dt, matrixBDesc.dims[kDimB]);
+                TensorDesc matrixC1DDesc = tensor1d(matrixCDesc.dt, matrixCDesc.dims[1]);
+                CHECK_STATUS(matrix_vector_multiply(matrixA2DDesc, a, matrixB1DDesc, b, tmpBytes,
+                    tmp, matrixC1DDesc, c, archInfo->arch));
             }
         }
-        matrixAPtr += matrixA2DBytes;
-        matrixBPtr += matrixB2DBytes;
-        matrixCPtr += matrixC2DBytes;
+    } else {
+        TensorDesc matrixA2DDesc =
+            tensor2df(matrixADesc.dt, dataFormatA, matrixADesc.dims[1], matrixADesc.dims[0]);
+        TensorDesc matrixB2DDesc =
+            tensor2df(matrixBDesc.dt, dataFormatB, matrixBDesc.dims[1], matrixBDesc.dims[0]);
+        TensorDesc matrixC2DDesc =
+            tensor2df(matrixCDesc.dt, DF_NORMAL, matrixCDesc.dims[1], matrixCDesc.dims[0]);
+        U32 numB = tensorNumElements(matrixBDesc) / (matrixBDesc.dims[1] * matrixBDesc.dims[0]);
+        CHECK_STATUS(matrix_matrix_multiply_batch(batch, matrixA2DDesc, matrixAPtr,
+            indexA.data(), matrixB2DDesc, matrixBPtr, numB, indexB.data(), tmpBytes, tmp,
+            matrixC2DDesc, matrixCPtr, archInfo->arch));
     }
 #ifdef _USE_INT8
     if (DT_I8 == matrixADesc.dt || DT_I8 == matrixBDesc.dt) {
@@ -373,10 +405,16 @@ EE matmul(Tensor matrixATensor,
             CHECK_STATUS(quantize_tensor(matrixCDesc, matrixC, &matrixCDesc,
                 get_ptr_from_tensor(matrixCTensor, arch), &scaleO));
             matrixCTensor.set_scale(scaleO);
+        } else if (DT_F32 == matrixCTensor.get_desc().dt) {
+            F32 *output = (F32 *)get_ptr_from_tensor(matrixCTensor, arch);
+            dequantize_int32_to_fp32(
+                tensorNumElements(matrixCDesc), (I32 *)matrixC, scaleO, output);
         } else {
             CHECK_REQUIREMENT(DT_F16 == matrixCTensor.get_desc().dt);
+#ifdef _USE_FP16
             F16 *output = (F16 *)get_ptr_from_tensor(matrixCTensor, arch);
             dequantize_int32_to_fp16(tensorNumElements(matrixCDesc), (I32 *)matrixC, scaleO, output);
+#endif
         }
     }
 #endif
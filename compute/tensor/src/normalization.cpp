@@ -45,7 +45,7 @@ EE layer_normalization(Tensor inputTensor,
         ret = layer_normalization_general(inputDesc, input, alpha, beta, outputDesc, output);
 #endif
 #ifdef _USE_X86
-    } else if (IS_X86_AVX2(arch)) {
+    } else if (IS_X86(arch)) {
         ret = layer_normalization_x86(inputDesc, input, alpha, beta, outputDesc, output);
 #endif
 #ifdef _USE_NEON
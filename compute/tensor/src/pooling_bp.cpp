@@ -35,7 +35,7 @@ EE pooling_bp(
         ret = pooling_bp_general(inputDesc, input, poolingParamSpec, outputDesc, output);
 #endif
 #ifdef _USE_X86
-    } else if (IS_X86_AVX2(arch)) {
+    } else if (IS_X86(arch)) {
         UNI_WARNING_LOG("The x86 pooling_bp operator is not optimized now.\n");
         ret = pooling_bp_general(inputDesc, input, poolingParamSpec, outputDesc, output);
 #endif
@@ -80,7 +80,7 @@ EE prelu(Tensor inputTensor,
         ret = prelu_general(inputDesc, input, weight, preluDesc, outputDesc, output);
 #endif
 #ifdef _USE_X86
-    } else if (IS_X86_AVX2(arch)) {
+    } else if (IS_X86(arch)) {
         UNI_WARNING_LOG("The x86 prelu operator is not optimized now.\n");
         ret = prelu_general(inputDesc, input, weight, preluDesc, outputDesc, output);
 #endif
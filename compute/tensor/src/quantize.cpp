@@ -21,12 +21,19 @@
 #include "cpu/arm/fp32/arm_functions_fp32.h"
 #endif
 #endif
+#ifdef _USE_X86
+#include "cpu/x86/tensor_computing_x86.h"
+#include "cpu/x86/fp32/x86_functions_fp32.h"
+#endif
 
 EE quantize_tensor(TensorDesc dDesc, const void *data, TensorDesc *qDesc, void *qData, void *scale)
 {
     EE ret = NOT_SUPPORTED;
 #ifdef _USE_NEON
     ret = quantize_tensor_arm(dDesc, data, qDesc, qData, scale);
+#endif
+#ifdef _USE_X86
+    ret = quantize_tensor_x86(dDesc, data, qDesc, qData, scale);
 #endif
     return ret;
 }
@@ -140,6 +147,36 @@ void update_histogram(U32 len, const F16 *data, int numBins, F32 interval, F32 *
         histo[index] += 1;
     }
 }
+#endif
+
+#ifdef _USE_INT8
+void dequantize_int8_to_fp32(U32 len, INT8 *q, F32 scale, F32 *d)
+{
+    F32 factor = 1 / scale;
+    for (U32 i = 0; i < len; i++) {
+        d[i] = q[i] * factor;
+    }
+}
+
+void dequantize_int32_to_fp32(U32 len, I32 *q, F32 scale, F32 *d, U32 biasLen, F32 *biasPtr)
+{
+    if (0 != biasLen) {
+        CHECK_REQUIREMENT(nullptr != biasPtr);
+        CHECK_REQUIREMENT(len % biasLen == 0);
+    }
+    F32 factor = 1 / scale;
+    if (0 == biasLen) {
+        for (U32 i = 0; i < len; i++) {
+            d[i] = q[i] * factor;
+        }
+        return;
+    }
+    for (U32 i = 0; i < len; i += biasLen) {
+        for (U32 j = 0; j < biasLen; j++) {
+            d[i + j] = q[i + j] * factor + biasPtr[j];
+        }
+    }
+}
 
 std::vector<F32> compress_histogram(std::vector<F32> &histogram, F32 numPerBin, F32 last_max)
 {
@@ -192,17 +229,21 @@ std::vector<F32> compute_scale_with_KL(std::vector<F32> &histogram, F32 interval
 {
     std::vector<F32> scale;
 #ifdef _USE_INT8
-    const int BINS = 2048;
+    const int BINS = histogram.size();
+    if (BINS <= 128) {
+        scale.push_back(127.99 / (BINS * interval));
+        return scale;
+    }
     F32 histoSum = array_sum_f32(histogram.data(), BINS);
     array_scale_f32(histogram.data(), histogram.data(), BINS, 1 / histoSum, 0);
 
-    F32 minKLD = 2048;
+    F32 minKLD = BINS;
     int bestThreshold = 128;
     F32 sumBin = array_sum_f32(histogram.data(), 128);
     UNI_DEBUG_LOG("First 128 bins contain %f of values", sumBin);
     F32 sumOver = 1 - sumBin;
 
-    for (U32 i = 128; i < 2048; i++) {
+    for (int i = 128; i < BINS; i++) {
         std::vector<F32> clipDist(histogram.begin(), histogram.begin() + i);
         clipDist[i - 1] += sumOver;
         sumOver -= histogram[i];  // Prepare for next round
@@ -211,7 +252,7 @@ std::vector<F32> compute_scale_with_KL(std::vector<F32> &histogram, F32 interval
 
         F32 numPerBin = (F32)i / 128.0;
 
-        for (U32 j = 0; j < 128; j++) {
+        for (int j = 0; j < 128; j++) {
             F32 start = j * numPerBin;
             F32 end = start + numPerBin;
 
@@ -232,7 +273,7 @@ std::vector<F32> compute_scale_with_KL(std::vector<F32> &histogram, F32 interval
 
         std::vector<F32> qExpand(i, 0);
 
-        for (U32 j = 0; j < 128; j++) {
+        for (int j = 0; j < 128; j++) {
             F32 start = j * numPerBin;
             F32 end = start + numPerBin;
 
@@ -278,10 +319,65 @@ std::vector<F32> compute_scale_with_KL(std::vector<F32> &histogram, F32 interval
             bestThreshold = i;
         }
     }
-    UNI_DEBUG_LOG(" %d/2048\n", bestThreshold);
+    UNI_DEBUG_LOG(" %d/%d\n", bestThreshold, BINS);
     F32 threshold = (F32)bestThreshold * interval;
     F32 quantScale = 127.99 / threshold;
     scale.push_back(quantScale);
 #endif
     return scale;
 }
+
+std::vector<F32> compute_scale_with_percentile(
+    std::vector<F32> &histogram, F32 interval, F32 percentile)
+{
+    std::vector<F32> scale;
+    F32 histoSum = 0;
+    for (U32 i = 0; i < histogram.size(); i++) {
+        histoSum += histogram[i];
+    }
+    // the threshold is the end of the first bin that reaches the percentile
+    F32 target = histoSum * percentile;
+    F32 sum = 0;
+    U32 threshold = histogram.size();
+    for (U32 i = 0; i < histogram.size(); i++) {
+        sum += histogram[i];
+        if (sum >= target) {
+            threshold = i + 1;
+            break;
+        }
+    }
+    UNI_DEBUG_LOG("%f of values are in %u/%u bins\n", percentile, threshold,
+        (U32)histogram.size());
+    scale.push_back(127.99 / (threshold * interval));
+    return scale;
+}
+
+std::vector<F32> compute_scale_with_MSE(std::vector<F32> &histogram, F32 interval)
+{
+    std::vector<F32> scale;
+    int bins = histogram.size();
+    // clipping at t costs (x - t)^2 for the values beyond t, which is summed from the tail with
+    // the moments of the bin centers, and the rounding error of a step s is s^2 / 12
+    std::vector<F64> count(bins + 1, 0), sum(bins + 1, 0), squareSum(bins + 1, 0);
+    for (int i = bins - 1; i >= 0; i--) {
+        F64 center = (i + 0.5) * interval;
+        count[i] = count[i + 1] + histogram[i];
+        sum[i] = sum[i + 1] + histogram[i] * center;
+        squareSum[i] = squareSum[i + 1] + histogram[i] * center * center;
+    }
+    F64 minError = -1;
+    int bestThreshold = bins;
+    for (int i = UNI_MIN(128, bins); i <= bins; i++) {
+        F64 threshold = i * interval;
+        F64 step = threshold / 127;
+        F64 error = (count[0] - count[i]) * step * step / 12 + squareSum[i] -
+            2 * threshold * sum[i] + threshold * threshold * count[i];
+        if (minError < 0 || error < minError) {
+            minError = error;
+            bestThreshold = i;
+        }
+    }
+    UNI_DEBUG_LOG("MSE threshold %d/%d\n", bestThreshold, bins);
+    scale.push_back(127.99 / (bestThreshold * interval));
+    return scale;
+}
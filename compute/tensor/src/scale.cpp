@@ -81,7 +81,7 @@ EE scale(Tensor inputTensor,
         ret = scale_general(inputDesc, input, alpha, beta, p, outputDesc, output);
 #endif
 #ifdef _USE_X86
-    } else if (IS_X86_AVX2(arch)) {
+    } else if (IS_X86(arch)) {
         ret = scale_x86(inputDesc, input, alpha, beta, p, outputDesc, output);
 #endif
 #ifdef _USE_NEON
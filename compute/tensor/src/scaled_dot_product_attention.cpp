@@ -0,0 +1,139 @@
+// Copyright (C) 2019. Huawei Technologies Co., Ltd. All rights reserved.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "tensor_computing.h"
+#ifdef _USE_GENERAL
+#include "cpu/general/tensor_computing_general.h"
+#endif
+#ifdef _USE_X86
+#include "cpu/x86/tensor_computing_x86.h"
+#endif
+
+// Q is [batch, qLength, heads, size], K is [batch, kLength, heads, size] and V is
+// [batch, kLength, heads, vSize], the heads are not transposed to the outer dimension
+static EE scaled_dot_product_attention_check(std::vector<TensorDesc> descs)
+{
+    if (descs.size() < 3 || descs.size() > 4) {
+        return NOT_MATCH;
+    }
+    TensorDesc qDesc = descs[0];
+    TensorDesc kDesc = descs[1];
+    TensorDesc vDesc = descs[2];
+    if (qDesc.nDims != 4 || kDesc.nDims != 4 || vDesc.nDims != 4) {
+        return NOT_MATCH;
+    }
+    if (qDesc.dims[3] != kDesc.dims[3] || qDesc.dims[3] != vDesc.dims[3] ||
+        qDesc.dims[1] != kDesc.dims[1] || qDesc.dims[1] != vDesc.dims[1] ||
+        qDesc.dims[0] != kDesc.dims[0] || kDesc.dims[2] != vDesc.dims[2]) {
+        return NOT_MATCH;
+    }
+    if (descs.size() == 4) {
+        // mask dimensions are 1 or the same as [batch, heads, qLength, kLength]
+        TensorDesc maskDesc = descs[3];
+        U32 scoreDims[4] = {kDesc.dims[2], qDesc.dims[2], qDesc.dims[1], qDesc.dims[3]};
+        if (maskDesc.nDims > 4) {
+            return NOT_MATCH;
+        }
+        for (U32 i = 0; i < maskDesc.nDims; i++) {
+            if (maskDesc.dims[i] != 1 && maskDesc.dims[i] != scoreDims[i]) {
+                return NOT_MATCH;
+            }
+        }
+    }
+    return SUCCESS;
+}
+
+EE scaled_dot_product_attention_infer_output_size(
+    std::vector<Tensor *> inputTensors, Tensor *outputTensor, ArchInfo_t archInfo)
+{
+    UNUSED(archInfo);
+    if (outputTensor == nullptr) {
+        CHECK_STATUS(NULL_POINTER);
+    }
+    std::vector<TensorDesc> descs;
+    for (U32 i = 0; i < inputTensors.size(); i++) {
+        if (inputTensors[i] == nullptr) {
+            CHECK_STATUS(NULL_POINTER);
+        }
+        descs.push_back(inputTensors[i]->get_desc());
+    }
+    EE ret = scaled_dot_product_attention_check(descs);
+    if (ret == SUCCESS) {
+        TensorDesc outputDesc = descs[0];
+        outputDesc.dims[0] = descs[2].dims[0];
+        outputTensor->resize(outputDesc);
+    }
+    return ret;
+}
+
+EE scaled_dot_product_attention_infer_forward_tmp_bytes(
+    std::vector<Tensor> inputTensors, U32 *bytes, ArchInfo_t archInfo)
+{
+    if (bytes == nullptr) {
+        CHECK_STATUS(NULL_POINTER);
+    }
+    auto arch = archInfo->arch;
+    TensorDesc qDesc = inputTensors[0].get_desc();
+    TensorDesc kDesc = inputTensors[1].get_desc();
+    EE ret = SUCCESS;
+    *bytes = 0;
+    if (IS_X86(arch)) {
+#ifdef _USE_X86
+        ret = scaled_dot_product_attention_infer_forward_tmp_bytes_x86(qDesc, kDesc, bytes);
+#endif
+    }
+    return ret;
+}
+
+EE scaled_dot_product_attention(std::vector<Tensor> inputTensors,
+    ScaledDotProductAttentionParamSpec p,
+    Tensor tmpTensor,
+    Tensor outputTensor,
+    ArchInfo_t archInfo)
+{
+    auto arch = archInfo->arch;
+    std::vector<TensorDesc> descs;
+    std::vector<void *> ptrs;
+    for (U32 i = 0; i < inputTensors.size(); i++) {
+        descs.push_back(inputTensors[i].get_desc());
+        ptrs.push_back(get_ptr_from_tensor(inputTensors[i], arch));
+    }
+    CHECK_STATUS(scaled_dot_product_attention_check(descs));
+    TensorDesc maskDesc;
+    maskDesc.nDims = 0;
+    void *mask = nullptr;
+    if (descs.size() == 4) {
+        maskDesc = descs[3];
+        mask = ptrs[3];
+    }
+    U32 tmpBytes = tmpTensor.bytes();
+    void *tmp = get_ptr_from_tensor(tmpTensor, arch);
+    TensorDesc outputDesc = outputTensor.get_desc();
+    void *output = get_ptr_from_tensor(outputTensor, arch);
+
+    EE ret = NOT_SUPPORTED;
+    if (IS_GENERAL(arch)) {
+#ifdef _USE_GENERAL
+        ret = scaled_dot_product_attention_general(descs[0], ptrs[0], descs[1], ptrs[1], descs[2],
+            ptrs[2], maskDesc, mask, p, outputDesc, output);
+#endif
+#ifdef _USE_X86
+    } else if (IS_X86(arch)) {
+        ret = scaled_dot_product_attention_x86(descs[0], ptrs[0], descs[1], ptrs[1], descs[2],
+            ptrs[2], maskDesc, mask, p, tmpBytes, tmp, outputDesc, output);
+#endif
+    }
+    UNUSED(tmpBytes);
+    UNUSED(tmp);
+    return ret;
+}
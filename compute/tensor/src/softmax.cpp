@@ -33,13 +33,32 @@ EE softmax(
     void *input = get_ptr_from_tensor(inputTensor, arch);
     TensorDesc outputDesc = outputTensor.get_desc();
     void *output = get_ptr_from_tensor(outputTensor, arch);
+    // The CPU output keeps the NCHWC8 of the input. For the other axes, the blocks of 8 channels
+    // and their lanes are dimensions of their own, so the kernels see [N, C/8, H, W, 8]. Only the
+    // channel axis is left to the NCHWC8 kernels, which reduce it over the blocks and the lanes.
+    if (IS_CPU(arch) && inputDesc.df == DF_NCHWC8) {
+        if (!tensorIs4d(inputDesc) || (inputDesc.dims[0] == 1 && inputDesc.dims[1] == 1)) {
+            inputDesc.df = DF_NCHW;
+        } else {
+            p.axis = (p.axis + inputDesc.nDims) % inputDesc.nDims;
+            if (p.axis != 1) {
+                for (I32 i = (I32)inputDesc.nDims; i > 0; i--) {
+                    inputDesc.dims[i] = inputDesc.dims[i - 1];
+                }
+                inputDesc.dims[inputDesc.nDims - 1] /= 8;
+                inputDesc.dims[0] = 8;
+                inputDesc.nDims += 1;
+                inputDesc.df = DF_NCHW;
+            }
+        }
+    }
     EE ret = NOT_SUPPORTED;
     if (IS_GENERAL(arch)) {
 #ifdef _USE_GENERAL
         ret = softmax_general(inputDesc, input, p, outputDesc, output);
 #endif
 #ifdef _USE_X86
-    } else if (IS_X86_AVX2(arch)) {
+    } else if (IS_X86(arch)) {
         ret = softmax_x86(inputDesc, input, p, outputDesc, output);
 #endif
 #ifdef _USE_NEON
@@ -62,9 +81,6 @@ inline EE softmax_infer_output_size_cpu(TensorDesc inputDesc, TensorDesc *output
         CHECK_STATUS(NULL_POINTER);
     }
     *outputDesc = inputDesc;
-    if (DF_NCHWC8 == (*outputDesc).df) {
-        (*outputDesc).df = DF_NCHW;
-    }
     return SUCCESS;
 }
 
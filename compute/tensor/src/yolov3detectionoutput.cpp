@@ -56,21 +56,43 @@ EE yolov3detectionoutput_infer_output_size(std::vector<Tensor *> inputTensor,
     return SUCCESS;
 }
 
+EE yolov3detectionoutput_infer_forward_tmp_bytes(std::vector<Tensor> inputTensor,
+    Yolov3DetectionOutputParamSpec yolov3DetectionOutputParamSpec,
+    Tensor outputTensor,
+    U32 *bytes,
+    ArchInfo_t archInfo)
+{
+    std::vector<TensorDesc> inputDesc = get_desc_from_tensors(inputTensor);
+    // the first box saves the number of available boxes
+    U32 maxOutput = outputTensor.get_desc().dims[1] - 1;
+    EE ret = NOT_SUPPORTED;
+    if (IS_CPU(archInfo->arch)) {
+#ifdef _USE_CPU
+        ret = yolov3detectionoutput_infer_forward_tmp_bytes_cpu(
+            inputDesc, yolov3DetectionOutputParamSpec, maxOutput, bytes);
+#endif
+    }
+    return ret;
+}
+
 EE yolov3detectionoutput(std::vector<Tensor> inputTensor,
     Yolov3DetectionOutputParamSpec yolov3DetectionOutputParamSpec,
+    Tensor tmpTensor,
     Tensor outputTensor,
     ArchInfo_t archInfo)
 {
     auto arch = archInfo->arch;
     std::vector<TensorDesc> inputDesc = get_desc_from_tensors(inputTensor);
     std::vector<void *> input = get_data_from_tensors<void *>(inputTensor, arch);
+    U32 tmpBytes = tmpTensor.bytes();
+    void *tmp = get_ptr_from_tensor(tmpTensor, arch);
     TensorDesc outputDesc = outputTensor.get_desc();
     void *output = get_ptr_from_tensor(outputTensor, arch);
     EE ret = NOT_SUPPORTED;
     if (IS_CPU(arch)) {
 #ifdef _USE_CPU
-        ret = yolov3detectionoutput_cpu(
-            inputDesc, input, yolov3DetectionOutputParamSpec, outputDesc, output, arch);
+        ret = yolov3detectionoutput_cpu(inputDesc, input, yolov3DetectionOutputParamSpec,
+            tmpBytes, tmp, outputDesc, output, arch);
 #endif
     }
     return ret;
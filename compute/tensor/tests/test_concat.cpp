@@ -123,13 +123,89 @@ int concatTest(int argc, char **argv, DataType dt)
     return 0;
 }
 
+// NCHW inputs concatenated with NCHWC8 inputs on the channel axis give an NCHWC8 output, which
+// has to match the NCHW concat of the same data whichever input comes first.
+int concatMixedLayoutTest(DataType dt)
+{
+    ArchInfo archInfo;
+    archInfo.arch = UT_ARCH;
+    ConcatParamSpec p;
+    p.axis = 1;
+    U32 in = 2, ih = 3, iw = 5;
+    U32 hw = ih * iw;
+    U32 bytes = bytesOf(dt);
+    std::vector<std::vector<std::pair<U32, DataFormat>>> cases = {
+        {{16, DF_NCHWC8}, {8, DF_NCHW}, {24, DF_NCHW}},
+        {{8, DF_NCHW}, {16, DF_NCHWC8}},
+        {{24, DF_NCHW}, {8, DF_NCHWC8}, {16, DF_NCHWC8}},
+    };
+    for (auto &inputs : cases) {
+        U32 num = inputs.size();
+        std::vector<Tensor> inTensors(num);
+        std::vector<Tensor *> inTensorPtr(num);
+        std::vector<U8 *> input(num);
+        U32 oc = 0;
+        for (U32 i = 0; i < num; i++) {
+            U32 ic = inputs[i].first;
+            TensorDesc nchwDesc = tensor4df(dt, DF_NCHW, in, ic, ih, iw);
+            TensorDesc inDesc = tensor4df(dt, inputs[i].second, in, ic, ih, iw);
+            input[i] = ut_input_v(in * ic * hw, dt, UT_INIT_RANDOM);
+            inTensors[i] = Tensor::alloc_sized<CPUMem>(inDesc);
+            if (inDesc.df == DF_NCHWC8) {
+                CHECK_STATUS(transformNCHWToNCHWC8(
+                    nchwDesc, input[i], inDesc, get_ptr_from_tensor(inTensors[i], UT_ARCH)));
+            } else {
+                memcpy(get_ptr_from_tensor(inTensors[i], UT_ARCH), input[i],
+                    tensorNumBytes(inDesc));
+            }
+            inTensorPtr[i] = &inTensors[i];
+            oc += ic;
+        }
+        U32 len = in * oc * hw;
+        TensorDesc outDescRef = tensor4df(dt, DF_NCHW, in, oc, ih, iw);
+        U8 *outputRef = ut_input_v(len, dt, UT_INIT_ZERO);
+        U8 *ptr = outputRef;
+        for (U32 n = 0; n < in; n++) {
+            for (U32 i = 0; i < num; i++) {
+                U32 blockBytes = inputs[i].first * hw * bytes;
+                memcpy(ptr, input[i] + n * blockBytes, blockBytes);
+                ptr += blockBytes;
+            }
+        }
+
+        Tensor outTensor;
+        CHECK_STATUS(concat_infer_output_size(inTensorPtr, p, &outTensor, &archInfo));
+        CHECK_REQUIREMENT(outTensor.get_desc().df == DF_NCHWC8 && len == outTensor.length());
+        outTensor.alloc();
+        U32 tmpBytes;
+        CHECK_STATUS(concat_infer_forward_tmp_bytes(inTensors, &tmpBytes, &archInfo));
+        Tensor tmpTensor;
+        tmpTensor.resize(tensor1d(DT_U8, tmpBytes));
+        tmpTensor.alloc();
+        Tensor resultTensor = Tensor::alloc_sized<CPUMem>(outDescRef);
+        CHECK_STATUS(concat(inTensors, p, tmpTensor, outTensor, &archInfo));
+        CHECK_STATUS(transformToNCHW(outTensor.get_desc(), get_ptr_from_tensor(outTensor, UT_ARCH),
+            outDescRef, get_ptr_from_tensor(resultTensor, UT_ARCH)));
+        ut_check_v(get_ptr_from_tensor(resultTensor, UT_ARCH), outputRef, len, dt, 0, __FILE__,
+            __LINE__);
+
+        free(outputRef);
+        for (U32 i = 0; i < num; i++) {
+            free(input[i]);
+        }
+    }
+    return 0;
+}
+
 int main(int argc, char **argv)
 {
 #ifdef _USE_FP16
     concatTest(argc, argv, DT_F16);
+    concatMixedLayoutTest(DT_F16);
 #endif
 #ifdef _USE_FP32
     concatTest(argc, argv, DT_F32);
+    concatMixedLayoutTest(DT_F32);
 #endif
     return 0;
 }
@@ -16,7 +16,8 @@
 #include "tensor_computing.h"
 #include "ut_util.h"
 
-#ifdef _USE_INT8
+// the int8 concat is only implemented for ARM
+#if defined(_USE_INT8) && defined(_USE_FP16)
 int int8ConcatTest(int argc, char **argv, DataType dt)
 {
     CHECK_REQUIREMENT(argc > 2);
@@ -138,7 +139,7 @@ int int8ConcatTest(int argc, char **argv, DataType dt)
 
 int main(int argc, char **argv)
 {
-#ifdef _USE_INT8
+#if defined(_USE_INT8) && defined(_USE_FP16)
     int8ConcatTest(argc, argv, DT_F16);
 #endif
     return 0;
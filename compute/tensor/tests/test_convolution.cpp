@@ -12,6 +12,7 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include <string.h>
+#include <vector>
 #include "tensor_computing.h"
 #include "ut_util.h"
 
@@ -43,6 +44,8 @@ int convolutionTest(int argc, char *argv[], DataType dt)
     archInfo.arch = UT_ARCH;
     ArchInfo archInfo_org;
     archInfo_org.arch = CPU_GENERAL;
+    ArchInfo archInfo_avx2;
+    archInfo_avx2.arch = X86_AVX2;
     ActivationParamSpec activationDesc;
     activationDesc.mode = ACTIVATION_RELU;
     activationDesc.value[0] = 0;
@@ -95,68 +98,131 @@ int convolutionTest(int argc, char *argv[], DataType dt)
     outputTensor.alloc();
     outputTensorRef.resize(outputTensor.get_desc());
     outputTensorRef.alloc();
+    U8 *residual = ut_input_v(outputTensor.length(), dt, UT_INIT_RANDOM);
+    Tensor residualTensor;
+    residualTensor.resize(outputDesc);
+    residualTensor.alloc();
+    memcpy(get_ptr_from_tensor(residualTensor, UT_ARCH), residual, outputTensor.bytes());
 
     // setup alg
     ConvolutionPolicy policy = CONVOLUTION_FASTEST;
     ConvolutionForwardAlgorithm alg = CONVOLUTION_ALGORITHM_NULL;
     CHECK_STATUS(convolution_infer_forward_algorithm(
         inputTensor, filterTensor, outputTensor, p, policy, &alg, dt, activationDesc, &archInfo));
-
-    // setup tmp
-    U32 tmpBytes;
-    CHECK_STATUS(convolution_infer_forward_tmp_bytes(
-        inputTensor, filterTensor, outputTensor, p, alg, &tmpBytes, &archInfo));
-    Tensor tmpTensor;
-    tmpTensor.resize(tensor1d(DT_U8, tmpBytes));
-    tmpTensor.alloc();
-
-    // setup filter trans
-    U32 ftmBytes;
-    CHECK_STATUS(convolution_transform_filter_bytes(filterTensor, p, alg, &ftmBytes, &archInfo));
-    // trans filter
-    Tensor ftmTensor;
-    ftmTensor.resize(tensor1d(DT_U8, ftmBytes));
-    ftmTensor.alloc();
-    CHECK_STATUS(
-        convolution_transform_filter(filterTensor, p, alg, tmpTensor, &ftmTensor, &archInfo));
-
-    if (UT_CHECK) {
-        CHECK_STATUS(convolution(inputTensor, ftmTensor, p, alg, nullptr, biasTensor, tmpTensor,
-            outputTensor, activationDesc, &archInfo));
-
-        // naive implement
-        CHECK_STATUS(convolution(inputTensorRef, filterTensorRef, p, alg, nullptr, biasTensor,
-            tmpTensor, outputTensorRef, activationDesc, &archInfo_org));
-
-        // check
-        ut_check_v(get_ptr_from_tensor(outputTensor, UT_ARCH),
-            get_ptr_from_tensor(outputTensorRef, UT_ARCH), outputTensor.length(), dt, 5, __FILE__,
-            __LINE__);
+    std::vector<ConvolutionForwardAlgorithm> algs = {alg};
+    std::vector<const char *> names = {"Convolution"};
+    std::vector<F32> thresholds = {5};
+#ifdef _USE_X86
+    // the Winograd convolution is also checked on the shapes that it supports
+    if (dt == DT_F32 && alg != CONVOLUTION_ALGORITHM_WINOGRAD && fh == 3 && fw == 3 &&
+        stride == 1 && group == 1 && ic % 8 == 0 && oc % 8 == 0) {
+        algs.push_back(CONVOLUTION_ALGORITHM_WINOGRAD);
+        names.push_back("Winograd");
+        thresholds.push_back(0.01);
     }
+#endif
+
+    for (U32 i = 0; i < algs.size(); i++) {
+        alg = algs[i];
+        // setup tmp
+        U32 tmpBytes;
+        CHECK_STATUS(convolution_infer_forward_tmp_bytes(
+            inputTensor, filterTensor, outputTensor, p, alg, &tmpBytes, &archInfo));
+        Tensor tmpTensor;
+        tmpTensor.resize(tensor1d(DT_U8, tmpBytes));
+        tmpTensor.alloc();
+
+        // setup filter trans
+        U32 ftmBytes;
+        CHECK_STATUS(
+            convolution_transform_filter_bytes(filterTensor, p, alg, &ftmBytes, &archInfo));
+        // trans filter
+        Tensor ftmTensor;
+        ftmTensor.resize(tensor1d(DT_U8, ftmBytes));
+        ftmTensor.alloc();
+        CHECK_STATUS(
+            convolution_transform_filter(filterTensor, p, alg, tmpTensor, &ftmTensor, &archInfo));
+
+        if (UT_CHECK) {
+            memset(get_ptr_from_tensor(outputTensor, UT_ARCH), 0, outputTensor.bytes());
+            CHECK_STATUS(convolution(inputTensor, ftmTensor, p, alg, nullptr, biasTensor,
+                tmpTensor, outputTensor, activationDesc, &archInfo));
+
+            // naive implement
+            CHECK_STATUS(convolution(inputTensorRef, filterTensorRef, p, alg, nullptr, biasTensor,
+                tmpTensor, outputTensorRef, activationDesc, &archInfo_org));
+
+            // check
+            ut_check_v(get_ptr_from_tensor(outputTensor, UT_ARCH),
+                get_ptr_from_tensor(outputTensorRef, UT_ARCH), outputTensor.length(), dt,
+                thresholds[i], __FILE__, __LINE__);
+#ifdef _USE_X86
+            // the AVX-512 kernels read the filter layout of the AVX2 ones, so both can run on it
+            if (IS_X86_AVX512(UT_ARCH)) {
+                CHECK_STATUS(convolution(inputTensor, ftmTensor, p, alg, nullptr, biasTensor,
+                    tmpTensor, outputTensorRef, activationDesc, &archInfo_avx2));
+                ut_check_v(get_ptr_from_tensor(outputTensor, UT_ARCH),
+                    get_ptr_from_tensor(outputTensorRef, UT_ARCH), outputTensor.length(), dt,
+                    0.01, __FILE__, __LINE__);
+            }
+#endif
 
-    // benchmark
-    double time_start = ut_time_ms();
-    for (int iter = 0; iter < UT_LOOPS; iter++) {
-        CHECK_STATUS(convolution(inputTensor, ftmTensor, p, alg, nullptr, biasTensor, tmpTensor,
-            outputTensor, activationDesc, &archInfo));
+            // residual add and activation fused into the convolution
+            CHECK_STATUS(convolution_with_epilogue(inputTensor, ftmTensor, p, alg, nullptr,
+                biasTensor, tmpTensor, outputTensor, &residualTensor, activationDesc, &archInfo));
+
+            ActivationParamSpec nullActivationDesc;
+            nullActivationDesc.mode = ACTIVATION_NULL;
+            CHECK_STATUS(convolution(inputTensorRef, filterTensorRef, p, alg, nullptr, biasTensor,
+                tmpTensor, outputTensorRef, nullActivationDesc, &archInfo_org));
+            EltwiseParamSpec eltwiseDesc;
+            eltwiseDesc.elt_mode = ELTWISE_SUM;
+            eltwiseDesc.elt_sum_spec.coeff_size = 0;
+            eltwiseDesc.activation_type = ACTIVATION_NULL;
+            CHECK_STATUS(eltwise({residualTensor, outputTensorRef}, eltwiseDesc, tmpTensor,
+                outputTensorRef, &archInfo_org));
+            CHECK_STATUS(
+                activation(outputTensorRef, activationDesc, outputTensorRef, &archInfo_org));
+            ut_check_v(get_ptr_from_tensor(outputTensor, UT_ARCH),
+                get_ptr_from_tensor(outputTensorRef, UT_ARCH), outputTensor.length(), dt,
+                thresholds[i], __FILE__, __LINE__);
+#ifdef _USE_X86
+            if (IS_X86_AVX512(UT_ARCH)) {
+                CHECK_STATUS(convolution_with_epilogue(inputTensor, ftmTensor, p, alg, nullptr,
+                    biasTensor, tmpTensor, outputTensorRef, &residualTensor, activationDesc,
+                    &archInfo_avx2));
+                ut_check_v(get_ptr_from_tensor(outputTensor, UT_ARCH),
+                    get_ptr_from_tensor(outputTensorRef, UT_ARCH), outputTensor.length(), dt,
+                    0.01, __FILE__, __LINE__);
+            }
+#endif
+        }
+
+        // benchmark
+        double time_start = ut_time_ms();
+        for (int iter = 0; iter < UT_LOOPS; iter++) {
+            CHECK_STATUS(convolution(inputTensor, ftmTensor, p, alg, nullptr, biasTensor,
+                tmpTensor, outputTensor, activationDesc, &archInfo));
+        }
+        double time_end = ut_time_ms();
+        double time = (time_end - time_start) / UT_LOOPS;
+
+        // log performance data
+        char buffer[150];
+        char params[120];
+        DataFormat df;
+        CHECK_STATUS(tensor4dGet(outputDesc, &dt, &df, &on, &oc, &oh, &ow));
+        sprintf(params, "(%u %u %u %u)+(%u %u %u %u)/(%u %u %u)=(%u %u %u %u)", in, ic, ih, iw,
+            fn, fc, fh, fw, group, stride, padding, on, oc, oh, ow);
+        sprintf(buffer, "%20s, %80s", names[i], params);
+        double ops = (1.0 * on * oc * oh * ow) * (2.0 * ic / group * fh * fw + 1);
+        ut_log(dt, buffer, ops, time);
     }
-    double time_end = ut_time_ms();
-    double time = (time_end - time_start) / UT_LOOPS;
-
-    // log performance data
-    char buffer[150];
-    char params[120];
-    DataFormat df;
-    CHECK_STATUS(tensor4dGet(outputDesc, &dt, &df, &on, &oc, &oh, &ow));
-    sprintf(params, "(%u %u %u %u)+(%u %u %u %u)/(%u %u %u)=(%u %u %u %u)", in, ic, ih, iw, fn, fc,
-        fh, fw, group, stride, padding, on, oc, oh, ow);
-    sprintf(buffer, "%20s, %80s", "Convolution", params);
-    double ops = (1.0 * on * oc * oh * ow) * (2.0 * ic / group * fh * fw + 1);
-    ut_log(dt, buffer, ops, time);
 
     free(input);
     free(filter);
     free(bias);
+    free(residual);
     return 0;
 }
 
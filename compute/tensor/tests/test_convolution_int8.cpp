@@ -15,7 +15,7 @@
 #include "tensor_computing.h"
 #include "ut_util.h"
 
-#ifdef _USE_INT8
+#if defined(_USE_INT8) && defined(_USE_FP16)
 int int8ConvolutionTest(int argc, char *argv[], DataType dt, DataType filterDataType)
 {
     CHECK_REQUIREMENT(argc == 16);
@@ -240,10 +240,146 @@ int int8ConvolutionTest(int argc, char *argv[], DataType dt, DataType filterData
 }
 #endif
 
+#if defined(_USE_INT8) && defined(_USE_X86)
+// the x86 int8 convolution quantizes the FP32 input itself and outputs FP32
+int int8ConvolutionTestX86(int argc, char *argv[])
+{
+    CHECK_REQUIREMENT(argc == 16);
+    // in data
+    U32 in = atoi(argv[1]);
+    U32 ic = atoi(argv[2]);
+    U32 ih = atoi(argv[3]);
+    U32 iw = atoi(argv[4]);
+    // weight
+    U32 fn = atoi(argv[5]);
+    U32 fc = atoi(argv[6]);
+    U32 fh = atoi(argv[7]);
+    U32 fw = atoi(argv[8]);
+    U32 group = atoi(argv[9]);
+    // stride & padding
+    U32 stride = atoi(argv[10]);
+    U32 padding = atoi(argv[11]);
+    // output
+    U32 on = atoi(argv[12]);
+    U32 oc = atoi(argv[13]);
+    U32 oh = atoi(argv[14]);
+    U32 ow = atoi(argv[15]);
+    CHECK_REQUIREMENT(in == 1 && on == 1);
+    if (ic % 8 != 0 || group != 1) {
+        printf("[WARN] can not quantize the first layer or the group convolution\n");
+        return 0;
+    }
+
+    DataType dt = DT_F32;
+    ArchInfo archInfo;
+    archInfo.arch = UT_ARCH;
+    ArchInfo archInfo_org;
+    archInfo_org.arch = CPU_GENERAL;
+    ActivationParamSpec activationDesc;
+    activationDesc.mode = ACTIVATION_RELU;
+    activationDesc.value[0] = 0;
+    ConvolutionParamSpec p = createConvolutionParamSpec(group, 1, fh, fw, 1, stride, stride, 0, 0,
+        padding, padding, padding, padding, 1, 1, 1, fn, Convolution_Pointwise);
+
+    TensorDesc inputDesc = tensor4df(dt, DF_NCHWC8, in, ic, ih, iw);
+    TensorDesc filterDesc = tensor4df(dt, DF_NCHW, oc, ic, fh, fw);
+    TensorDesc biasDesc = tensor1d(dt, oc);
+    U8 *input = ut_input_v(in * ic * ih * iw, dt, UT_INIT_RANDOM);
+    U8 *filter = ut_input_v(fn * fc * fh * fw, dt, UT_INIT_RANDOM);
+    U8 *bias = ut_input_v(oc, dt, UT_INIT_RANDOM);
+    Tensor inputTensor = Tensor::alloc_sized<CPUMem>(inputDesc);
+    Tensor filterTensor = Tensor::alloc_sized<CPUMem>(filterDesc);
+    Tensor biasTensor = Tensor::alloc_sized<CPUMem>(biasDesc);
+    memcpy(get_ptr_from_tensor(inputTensor, UT_ARCH), input, tensorNumBytes(inputDesc));
+    memcpy(get_ptr_from_tensor(filterTensor, UT_ARCH), filter, tensorNumBytes(filterDesc));
+    memcpy(get_ptr_from_tensor(biasTensor, UT_ARCH), bias, tensorNumBytes(biasDesc));
+
+    Tensor outputTensor, outputTensorRef;
+    CHECK_STATUS(convolution_infer_output_size(
+        &inputTensor, filterTensor, p, &outputTensor, dt, &archInfo));
+    outputTensor.alloc();
+    outputTensorRef = Tensor::alloc_sized<CPUMem>(outputTensor.get_desc());
+
+    ConvolutionForwardAlgorithm alg = CONVOLUTION_ALGORITHM_NULL;
+    CHECK_STATUS(convolution_infer_forward_algorithm(inputTensor, filterTensor, outputTensor, p,
+        CONVOLUTION_FASTEST, &alg, DT_I8, activationDesc, &archInfo));
+
+    // input, output and filter
+    F32 scales[3] = {-1, -1, -1};
+    TensorDesc qDesc;
+    Tensor qFilter = Tensor::alloc_sized<CPUMem>(filterDesc);
+    CHECK_STATUS(quantize_tensor(
+        filterDesc, filter, &qDesc, get_ptr_from_tensor(qFilter, UT_ARCH), scales + 2));
+    qFilter.resize(qDesc);
+    U32 ftBytes;
+    CHECK_STATUS(convolution_transform_filter_bytes(qFilter, p, alg, &ftBytes, &archInfo));
+    Tensor ftmTensor = Tensor::alloc_sized<CPUMem>(tensor1d(DT_U8, ftBytes));
+    Tensor tmpTensor;
+    CHECK_STATUS(convolution_transform_filter(qFilter, p, alg, tmpTensor, &ftmTensor, &archInfo));
+
+    U32 tmpBytes;
+    CHECK_STATUS(convolution_infer_forward_tmp_bytes(
+        inputTensor, ftmTensor, outputTensor, p, alg, &tmpBytes, &archInfo));
+    tmpTensor = Tensor::alloc_sized<CPUMem>(tensor1d(DT_U8, tmpBytes));
+
+    if (UT_CHECK) {
+        CHECK_STATUS(convolution(inputTensor, ftmTensor, p, alg, scales, biasTensor, tmpTensor,
+            outputTensor, activationDesc, &archInfo));
+
+        // naive implement
+        CHECK_STATUS(convolution(inputTensor, filterTensor, p, alg, nullptr, biasTensor,
+            tmpTensor, outputTensorRef, activationDesc, &archInfo_org));
+
+        ut_check_v(get_ptr_from_tensor(outputTensor, UT_ARCH),
+            get_ptr_from_tensor(outputTensorRef, UT_ARCH), outputTensor.length(), dt, 0.2,
+            __FILE__, __LINE__);
+
+        // the activations that are not done on the dequantized registers
+        ActivationParamSpec hswishDesc;
+        hswishDesc.mode = ACTIVATION_H_SWISH;
+        hswishDesc.value[0] = 0;
+        CHECK_STATUS(convolution(inputTensor, ftmTensor, p, alg, scales, biasTensor, tmpTensor,
+            outputTensor, hswishDesc, &archInfo));
+        CHECK_STATUS(convolution(inputTensor, filterTensor, p, alg, nullptr, biasTensor,
+            tmpTensor, outputTensorRef, hswishDesc, &archInfo_org));
+        ut_check_v(get_ptr_from_tensor(outputTensor, UT_ARCH),
+            get_ptr_from_tensor(outputTensorRef, UT_ARCH), outputTensor.length(), dt, 0.2,
+            __FILE__, __LINE__);
+    }
+
+    // benchmark
+    double time_start = ut_time_ms();
+    for (int iter = 0; iter < UT_LOOPS; iter++) {
+        CHECK_STATUS(convolution(inputTensor, ftmTensor, p, alg, scales, biasTensor, tmpTensor,
+            outputTensor, activationDesc, &archInfo));
+    }
+    double time_end = ut_time_ms();
+    double time = (time_end - time_start) / UT_LOOPS;
+
+    // log performance data
+    char buffer[150];
+    char params[120];
+    DataFormat df;
+    CHECK_STATUS(tensor4dGet(outputTensor.get_desc(), &dt, &df, &on, &oc, &oh, &ow));
+    sprintf(params, "(%u %u %u %u)+(%u %u %u %u)/(%u %u %u)=(%u %u %u %u)", in, ic, ih, iw, fn,
+        fc, fh, fw, group, stride, padding, on, oc, oh, ow);
+    sprintf(buffer, "%20s, %80s", "Convolution", params);
+    double ops = (1.0 * on * oc * oh * ow) * (2.0 * ic * fh * fw / group + 1);
+    ut_log(DT_I8, buffer, ops, time);
+
+    free(input);
+    free(filter);
+    free(bias);
+    return 0;
+}
+#endif
+
 int main(int argc, char **argv)
 {
-#ifdef _USE_INT8
+#if defined(_USE_INT8) && defined(_USE_FP16)
     int8ConvolutionTest(argc, argv, DT_F16, DT_F16_8Q);
+#elif defined(_USE_INT8) && defined(_USE_X86)
+    int8ConvolutionTestX86(argc, argv);
 #endif
     return 0;
 }
@@ -43,6 +43,8 @@ int depthwiseConvolutionTest(int argc, char *argv[], bool isFusedWithPw, DataTyp
     archInfo.arch = UT_ARCH;
     ArchInfo archInfo_org;
     archInfo_org.arch = CPU_GENERAL;
+    ArchInfo archInfo_avx2;
+    archInfo_avx2.arch = X86_AVX2;
     ActivationParamSpec dwActivationParamSpec;
     ActivationParamSpec pwActivationParamSpec;
     dwActivationParamSpec.mode = ACTIVATION_NULL;
@@ -200,6 +202,22 @@ int depthwiseConvolutionTest(int argc, char *argv[], bool isFusedWithPw, DataTyp
         ut_check_v(get_ptr_from_tensor(outputTensor, UT_ARCH),
             get_ptr_from_tensor(outputTensorRef, UT_ARCH), outputTensor.length(), dt, 0.1, __FILE__,
             __LINE__);
+#ifdef _USE_X86
+        // the AVX-512 kernels read the filter layout of the AVX2 ones, so both can run on it
+        if (IS_X86_AVX512(UT_ARCH)) {
+            if (isFusedWithPw) {
+                CHECK_STATUS(depthwise_pointwise_convolution(inputTensor, dwFtmTensor,
+                    pwFtmTensor, p, alg, dwBiasTensor, pwBiasTensor, tmpTensor, outputTensorRef,
+                    dwActivationParamSpec, pwActivationParamSpec, &archInfo_avx2));
+            } else {
+                CHECK_STATUS(depthwise_convolution(inputTensor, dwFtmTensor, p, alg, dwBiasTensor,
+                    tmpTensor, outputTensorRef, dwActivationParamSpec, &archInfo_avx2));
+            }
+            ut_check_v(get_ptr_from_tensor(outputTensor, UT_ARCH),
+                get_ptr_from_tensor(outputTensorRef, UT_ARCH), outputTensor.length(), dt, 0.01,
+                __FILE__, __LINE__);
+        }
+#endif
     }
 
     // benchmark
@@ -11,9 +11,122 @@
 // COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
+#include <algorithm>
+#include <numeric>
 #include "tensor_computing.h"
 #include "ut_util.h"
 
+// IoU of two [xmin, ymin, xmax, ymax] boxes, as the per-operator NMS computed it
+static F32 reference_iou(const F32 *a, const F32 *b, F32 area_a, F32 area_b)
+{
+    F32 inter = 0;
+    if (!(a[0] > b[2] || a[2] < b[0] || a[1] > b[3] || a[3] < b[1])) {
+        inter = (std::min(a[2], b[2]) - std::max(a[0], b[0])) *
+            (std::min(a[3], b[3]) - std::max(a[1], b[1]));
+    }
+    return inter / (area_a + area_b - inter);
+}
+
+// greedy NMS of the boxes in order, a box is kept if its IoU with every kept box is not greater
+// than threshold
+static std::vector<U32> reference_nms(
+    const std::vector<F32> &boxes, const std::vector<U32> &order, F32 threshold)
+{
+    std::vector<U32> picked;
+    for (U32 a : order) {
+        const F32 *ba = &boxes[a * 4];
+        F32 area_a = (ba[2] - ba[0]) * (ba[3] - ba[1]);
+        bool keep = true;
+        for (U32 b : picked) {
+            const F32 *bb = &boxes[b * 4];
+            F32 area_b = (bb[2] - bb[0]) * (bb[3] - bb[1]);
+            if (reference_iou(ba, bb, area_a, area_b) > threshold) {
+                keep = false;
+                break;
+            }
+        }
+        if (keep) {
+            picked.push_back(a);
+        }
+    }
+    return picked;
+}
+
+// The previous per-operator implementation, it does not share any code with the operator: the
+// prior boxes are decoded, every class but the background keeps its nms_top_k best boxes above
+// confidence_threshold and suppresses them one by one, and the keep_top_k best boxes of all the
+// classes are output. Equal scores keep the order of their indexes.
+template <typename T>
+static void detectionoutput_reference(const T *location,
+    const T *confidence,
+    const T *priorbox,
+    U32 priorbox_width,
+    DetectionOutputParamSpec p,
+    T *output)
+{
+    U32 num_prior = priorbox_width / 4;
+    const T *variance = priorbox + priorbox_width;
+    std::vector<F32> boxes(num_prior * 4);
+    for (U32 i = 0; i < num_prior; i++) {
+        const T *loc = location + i * 4;
+        const T *pb = priorbox + i * 4;
+        const T *var = variance + i * 4;
+        F32 pb_w = pb[2] - pb[0];
+        F32 pb_h = pb[3] - pb[1];
+        F32 pb_cx = (pb[0] + pb[2]) * 0.5f;
+        F32 pb_cy = (pb[1] + pb[3]) * 0.5f;
+        F32 box_cx = var[0] * loc[0] * pb_w + pb_cx;
+        F32 box_cy = var[1] * loc[1] * pb_h + pb_cy;
+        F32 box_w = static_cast<F32>(exp(var[2] * loc[2]) * pb_w);
+        F32 box_h = static_cast<F32>(exp(var[3] * loc[3]) * pb_h);
+        boxes[i * 4] = box_cx - box_w * 0.5f;
+        boxes[i * 4 + 1] = box_cy - box_h * 0.5f;
+        boxes[i * 4 + 2] = box_cx + box_w * 0.5f;
+        boxes[i * 4 + 3] = box_cy + box_h * 0.5f;
+    }
+    std::vector<U32> labels, ids;
+    std::vector<F32> scores;
+    for (U32 c = 1; c < p.num_class; c++) {
+        std::vector<U32> order;
+        for (U32 j = 0; j < num_prior; j++) {
+            if (confidence[j * p.num_class + c] > p.confidence_threshold) {
+                order.push_back(j);
+            }
+        }
+        std::stable_sort(order.begin(), order.end(), [&](U32 a, U32 b) {
+            return (F32)confidence[a * p.num_class + c] > (F32)confidence[b * p.num_class + c];
+        });
+        if (order.size() > p.nms_top_k) {
+            order.resize(p.nms_top_k);
+        }
+        std::vector<U32> picked = reference_nms(boxes, order, p.nms_threshold);
+        for (U32 j : picked) {
+            labels.push_back(c);
+            ids.push_back(j);
+            scores.push_back(confidence[j * p.num_class + c]);
+        }
+    }
+    std::vector<U32> rank(scores.size());
+    std::iota(rank.begin(), rank.end(), 0);
+    std::stable_sort(
+        rank.begin(), rank.end(), [&](U32 a, U32 b) { return scores[a] > scores[b]; });
+    if (rank.size() > p.keep_top_k) {
+        rank.resize(p.keep_top_k);
+    }
+    output[0] = rank.size();
+    output[1] = output[2] = output[3] = output[4] = output[5] = 0;
+    for (U32 i = 0; i < rank.size(); i++) {
+        T *out = output + (i + 1) * 6;
+        const F32 *box = &boxes[ids[rank[i]] * 4];
+        out[0] = labels[rank[i]];
+        out[1] = scores[rank[i]];
+        out[2] = box[0];
+        out[3] = box[1];
+        out[4] = box[2];
+        out[5] = box[3];
+    }
+}
+
 int detectionoutputTest(int argc, char **argv, DataType dt)
 {
     CHECK_REQUIREMENT(argc == 11);
@@ -80,16 +193,44 @@ int detectionoutputTest(int argc, char **argv, DataType dt)
     TensorDesc outputDesc_ref = outputTensor.get_desc();
     outputTensorRef.resize(outputDesc_ref);
     outputTensorRef.alloc();
+    // setup tmp
+    U32 tmpBytes;
+    CHECK_STATUS(detectionoutput_infer_forward_tmp_bytes(
+        inputTensors, detectionoutput_desc, &tmpBytes, &archInfo));
+    Tensor tmpTensor;
+    tmpTensor.resize(tensor1d(DT_U8, tmpBytes));
+    tmpTensor.alloc();
     U32 output_len = outputTensor.length();
     CHECK_REQUIREMENT(input_len_loc == ih0 * iw0 && input_len_conf == ih1 * iw1 &&
         input_len_priorbox == in2 * ic2 * ilens2 && output_len == oh * ow);
     if (UT_CHECK) {
-        CHECK_STATUS(detectionoutput(inputTensors, detectionoutput_desc, outputTensor, &archInfo));
-        CHECK_STATUS(
-            detectionoutput(inputTensors, detectionoutput_desc, outputTensorRef, &archInfo_org));
-        // check
-        ut_check_v(get_ptr_from_tensor(outputTensor, UT_ARCH),
-            get_ptr_from_tensor(outputTensorRef, UT_ARCH), output_len, dt, 0.05, __FILE__, __LINE__);
+        void *ref = get_ptr_from_tensor(outputTensorRef, UT_ARCH);
+        memset(ref, 0, outputTensorRef.bytes());
+        switch (dt) {
+#ifdef _USE_FP32
+            case DT_F32:
+                detectionoutput_reference((F32 *)input_loc, (F32 *)input_conf,
+                    (F32 *)input_priorbox, ilens2, detectionoutput_desc, (F32 *)ref);
+                break;
+#endif
+#ifdef _USE_FP16
+            case DT_F16:
+                detectionoutput_reference((F16 *)input_loc, (F16 *)input_conf,
+                    (F16 *)input_priorbox, ilens2, detectionoutput_desc, (F16 *)ref);
+                break;
+#endif
+            default:
+                break;
+        }
+        // both archs run the shared NMS of the operators, check them against the reference
+        ArchInfo archInfos[2] = {archInfo_org, archInfo};
+        for (U32 i = 0; i < 2; i++) {
+            memset(get_ptr_from_tensor(outputTensor, UT_ARCH), 0, outputTensor.bytes());
+            CHECK_STATUS(detectionoutput(
+                inputTensors, detectionoutput_desc, tmpTensor, outputTensor, &archInfos[i]));
+            ut_check_v(get_ptr_from_tensor(outputTensor, UT_ARCH), ref, output_len, dt, 0.05,
+                __FILE__, __LINE__);
+        }
     }
     U32 num_detected_max = detectionoutput_desc.keep_top_k;
 #ifdef _USE_FP16
@@ -95,13 +95,107 @@ int eltwiseTest(int argc, char **argv, DataType dt)
     return 0;
 }
 
+// A full NCHWC8 input combined with a per-channel, batch broadcast or scalar input gives an
+// NCHWC8 output, which has to match the NCHW result of the same inputs broadcast by hand.
+int eltwiseNCHWC8BroadcastTest(DataType dt)
+{
+    ArchInfo archInfo;
+    archInfo.arch = UT_ARCH;
+    ArchInfo archInfo_org;
+    archInfo_org.arch = CPU_GENERAL;
+    F32 threshold = (dt == DT_F32) ? 0.0001 : 0.01;
+    U32 in = 2, ic = 16, ih = 3, iw = 5;
+    U32 len = in * ic * ih * iw;
+    U32 hw = ih * iw;
+    U32 bytes = bytesOf(dt);
+    TensorDesc nchwDesc = tensor4df(dt, DF_NCHW, in, ic, ih, iw);
+    TensorDesc nchwc8Desc = tensor4df(dt, DF_NCHWC8, in, ic, ih, iw);
+    std::vector<TensorDesc> broadcastDescs = {tensor4df(dt, DF_NCHW, in, ic, 1, 1),
+        tensor4df(dt, DF_NCHWC8, in, ic, 1, 1), tensor4df(dt, DF_NCHW, 1, ic, 1, 1),
+        tensor1d(dt, 1)};
+    std::vector<EltwiseMode> modes = {ELTWISE_SUM, ELTWISE_PROD, ELTWISE_MAX};
+
+    U8 *input = ut_input_v(len, dt, UT_INIT_RANDOM);
+    Tensor fullTensor = Tensor::alloc_sized<CPUMem>(nchwc8Desc);
+    CHECK_STATUS(transformNCHWToNCHWC8(
+        nchwDesc, input, nchwc8Desc, get_ptr_from_tensor(fullTensor, UT_ARCH)));
+    // an NCHW tensor is copied as it is
+    Tensor fullTensorRef = Tensor::alloc_sized<CPUMem>(nchwDesc);
+    CHECK_STATUS(
+        transformToNCHW(nchwDesc, input, nchwDesc, get_ptr_from_tensor(fullTensorRef, UT_ARCH)));
+    ut_check_v(get_ptr_from_tensor(fullTensorRef, UT_ARCH), input, len, dt, 0, __FILE__, __LINE__);
+
+    for (auto &broadcastDesc : broadcastDescs) {
+        U32 broadcastLen = tensorNumElements(broadcastDesc);
+        U8 *broadcast = ut_input_v(broadcastLen, dt, UT_INIT_RANDOM);
+        Tensor broadcastTensor = Tensor::alloc_sized<CPUMem>(broadcastDesc);
+        memcpy(get_ptr_from_tensor(broadcastTensor, UT_ARCH), broadcast, broadcastLen * bytes);
+        Tensor expandTensorRef = Tensor::alloc_sized<CPUMem>(nchwDesc);
+        U8 *expand = (U8 *)get_ptr_from_tensor(expandTensorRef, UT_ARCH);
+        for (U32 n = 0; n < in; n++) {
+            for (U32 c = 0; c < ic; c++) {
+                U32 index = 0;
+                if (broadcastLen > 1) {
+                    index = (broadcastLen == ic) ? c : n * ic + c;
+                }
+                for (U32 i = 0; i < hw; i++) {
+                    memcpy(expand + ((n * ic + c) * hw + i) * bytes, broadcast + index * bytes,
+                        bytes);
+                }
+            }
+        }
+
+        for (int order = 0; order < 2; order++) {
+            std::vector<Tensor> inTensors = {fullTensor, broadcastTensor};
+            std::vector<Tensor> inTensorsRef = {fullTensorRef, expandTensorRef};
+            if (order == 1) {
+                std::swap(inTensors[0], inTensors[1]);
+                std::swap(inTensorsRef[0], inTensorsRef[1]);
+            }
+            std::vector<Tensor *> inTensorPtr = {&inTensors[0], &inTensors[1]};
+            Tensor outTensor;
+            CHECK_STATUS(eltwise_infer_output_size(inTensorPtr, &outTensor, &archInfo));
+            CHECK_REQUIREMENT(outTensor.get_desc().df == DF_NCHWC8 && len == outTensor.length());
+            outTensor.alloc();
+            U32 tmpBytes;
+            CHECK_STATUS(
+                eltwise_infer_forward_tmp_bytes(inTensors, outTensor, &tmpBytes, &archInfo));
+            CHECK_REQUIREMENT(tmpBytes == 0);
+            Tensor tmpTensor;
+            Tensor outTensorRef = Tensor::alloc_sized<CPUMem>(nchwDesc);
+            Tensor resultTensor = Tensor::alloc_sized<CPUMem>(nchwDesc);
+            for (auto mode : modes) {
+                EltwiseParamSpec eltwiseDesc;
+                eltwiseDesc.elt_mode = mode;
+                eltwiseDesc.activation_type = ACTIVATION_NULL;
+                CHECK_STATUS(
+                    eltwise(inTensorsRef, eltwiseDesc, tmpTensor, outTensorRef, &archInfo_org));
+                for (ArchInfo *arch : {&archInfo, &archInfo_org}) {
+                    CHECK_STATUS(eltwise(inTensors, eltwiseDesc, tmpTensor, outTensor, arch));
+                    CHECK_STATUS(transformToNCHW(outTensor.get_desc(),
+                        get_ptr_from_tensor(outTensor, UT_ARCH), nchwDesc,
+                        get_ptr_from_tensor(resultTensor, UT_ARCH)));
+                    ut_check_v(get_ptr_from_tensor(resultTensor, UT_ARCH),
+                        get_ptr_from_tensor(outTensorRef, UT_ARCH), len, dt, threshold, __FILE__,
+                        __LINE__);
+                }
+            }
+        }
+        free(broadcast);
+    }
+    free(input);
+    return 0;
+}
+
 int main(int argc, char **argv)
 {
 #ifdef _USE_FP16
     eltwiseTest(argc, argv, DT_F16);
+    eltwiseNCHWC8BroadcastTest(DT_F16);
 #endif
 #ifdef _USE_FP32
     eltwiseTest(argc, argv, DT_F32);
+    eltwiseNCHWC8BroadcastTest(DT_F32);
 #endif
     return 0;
 }
@@ -82,6 +82,30 @@ int fullyConnectedTest(int argc, char **argv, DataType dt)
         // check
         ut_check_v(get_ptr_from_tensor(outputTensor, UT_ARCH),
             get_ptr_from_tensor(outputTensorRef, UT_ARCH), m * n, dt, 1, __FILE__, __LINE__);
+
+        // residual add and activation fused into the multiplication
+        Tensor residualTensor;
+        residualTensor.resize(outputDesc_ref);
+        residualTensor.alloc();
+        U8 *residual = ut_input_v(m * n, dt, UT_INIT_RANDOM);
+        memcpy(
+            get_ptr_from_tensor(residualTensor, UT_ARCH), residual, tensorNumBytes(outputDesc_ref));
+        ActivationParamSpec activationDesc;
+        activationDesc.mode = ACTIVATION_RELU;
+        activationDesc.value[0] = 0;
+        CHECK_STATUS(fully_connected_with_epilogue(inputTensor, ftmTensor, biasTensor, tmpTensor,
+            outputTensor, &residualTensor, activationDesc, &archInfo));
+
+        EltwiseParamSpec eltwiseDesc;
+        eltwiseDesc.elt_mode = ELTWISE_SUM;
+        eltwiseDesc.elt_sum_spec.coeff_size = 0;
+        eltwiseDesc.activation_type = ACTIVATION_NULL;
+        CHECK_STATUS(eltwise({residualTensor, outputTensorRef}, eltwiseDesc, tmpTensor,
+            outputTensorRef, &archInfo_org));
+        CHECK_STATUS(activation(outputTensorRef, activationDesc, outputTensorRef, &archInfo_org));
+        ut_check_v(get_ptr_from_tensor(outputTensor, UT_ARCH),
+            get_ptr_from_tensor(outputTensorRef, UT_ARCH), m * n, dt, 1, __FILE__, __LINE__);
+        free(residual);
     }
     // benchmark
     double time_start = ut_time_ms();
@@ -11,9 +11,90 @@
 // COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
+#include <algorithm>
 #include "tensor_computing.h"
 #include "ut_util.h"
 
+// IoU of two [xmin, ymin, xmax, ymax] boxes, as the per-operator NMS computed it
+static F32 reference_iou(const F32 *a, const F32 *b, F32 area_a, F32 area_b)
+{
+    F32 inter = 0;
+    if (!(a[0] > b[2] || a[2] < b[0] || a[1] > b[3] || a[3] < b[1])) {
+        inter = (std::min(a[2], b[2]) - std::max(a[0], b[0])) *
+            (std::min(a[3], b[3]) - std::max(a[1], b[1]));
+    }
+    return inter / (area_a + area_b - inter);
+}
+
+// greedy NMS of the boxes in order, a box is kept if its IoU with every kept box is not greater
+// than threshold
+static std::vector<U32> reference_nms(
+    const std::vector<F32> &boxes, const std::vector<U32> &order, F32 threshold)
+{
+    std::vector<U32> picked;
+    for (U32 a : order) {
+        const F32 *ba = &boxes[a * 4];
+        F32 area_a = (ba[2] - ba[0]) * (ba[3] - ba[1]);
+        bool keep = true;
+        for (U32 b : picked) {
+            const F32 *bb = &boxes[b * 4];
+            F32 area_b = (bb[2] - bb[0]) * (bb[3] - bb[1]);
+            if (reference_iou(ba, bb, area_a, area_b) > threshold) {
+                keep = false;
+                break;
+            }
+        }
+        if (keep) {
+            picked.push_back(a);
+        }
+    }
+    return picked;
+}
+
+// The previous per-operator implementation, it does not share any code with the operator: the
+// boxes of every class above score_threshold are sorted by descending score, equal scores by
+// index, and suppressed one by one.
+template <typename T>
+static void non_max_suppression_reference(const T *box,
+    const T *score,
+    U32 spatial_dim,
+    U32 num_class,
+    NonMaxSuppressionParamSpec p,
+    T *output)
+{
+    std::vector<F32> boxes(spatial_dim * 4);
+    for (U32 i = 0; i < spatial_dim; i++) {
+        boxes[i * 4] = std::min<F32>(box[i * 4 + 1], box[i * 4 + 3]);
+        boxes[i * 4 + 1] = std::min<F32>(box[i * 4], box[i * 4 + 2]);
+        boxes[i * 4 + 2] = std::max<F32>(box[i * 4 + 1], box[i * 4 + 3]);
+        boxes[i * 4 + 3] = std::max<F32>(box[i * 4], box[i * 4 + 2]);
+    }
+    U32 num_detected = 0;
+    for (U32 c = 0; c < num_class; c++) {
+        const T *class_score = score + c * spatial_dim;
+        std::vector<U32> order;
+        for (U32 j = 0; j < spatial_dim; j++) {
+            if (class_score[j] > p.score_threshold) {
+                order.push_back(j);
+            }
+        }
+        std::stable_sort(order.begin(), order.end(),
+            [&](U32 a, U32 b) { return (F32)class_score[a] > (F32)class_score[b]; });
+        std::vector<U32> picked = reference_nms(boxes, order, p.iou_threshold);
+        if (picked.size() > p.max_output_boxes_per_class) {
+            picked.resize(p.max_output_boxes_per_class);
+        }
+        for (U32 j = 0; j < picked.size(); j++) {
+            num_detected++;
+            output[num_detected * 3] = 0;
+            output[num_detected * 3 + 1] = c;
+            output[num_detected * 3 + 2] = picked[j];
+        }
+    }
+    output[0] = num_detected;
+    output[1] = output[2] = 0;
+}
+
 int nonmaxsuppressionTest(int argc, char **argv, DataType dt)
 {
     CHECK_REQUIREMENT(argc == 12);
@@ -64,6 +145,13 @@ int nonmaxsuppressionTest(int argc, char **argv, DataType dt)
         inputTensorsPtr, nonMaxSuppressionParamSpec, &outputTensor, &archInfo));
     outputTensor.alloc();
     Tensor outputTensorRef = Tensor::alloc_sized<CPUMem>(outputTensor.get_desc());
+    // setup tmp
+    U32 tmpBytes;
+    CHECK_STATUS(non_max_suppression_infer_forward_tmp_bytes(
+        inputTensors, nonMaxSuppressionParamSpec, &tmpBytes, &archInfo));
+    Tensor tmpTensor;
+    tmpTensor.resize(tensor1d(DT_U8, tmpBytes));
+    tmpTensor.alloc();
     U32 output_len = outputTensor.length();
     CHECK_REQUIREMENT(input_len_boxes == in0 * ic0 * ilens0 &&
         input_len_scores == in1 * ic1 * ilens1 && output_len == oh * ow);
@@ -88,13 +176,33 @@ int nonmaxsuppressionTest(int argc, char **argv, DataType dt)
                        0,  1,  5 };
      */
     if (UT_CHECK) {
-        CHECK_STATUS(
-            non_max_suppression(inputTensors, nonMaxSuppressionParamSpec, outputTensor, &archInfo));
-        CHECK_STATUS(non_max_suppression(
-            inputTensors, nonMaxSuppressionParamSpec, outputTensorRef, &archInfo_org));
-        // check
-        ut_check_v(get_ptr_from_tensor(outputTensor, UT_ARCH),
-            get_ptr_from_tensor(outputTensorRef, UT_ARCH), output_len, dt, 0.05, __FILE__, __LINE__);
+        void *ref = get_ptr_from_tensor(outputTensorRef, UT_ARCH);
+        memset(ref, 0, outputTensorRef.bytes());
+        switch (dt) {
+#ifdef _USE_FP32
+            case DT_F32:
+                non_max_suppression_reference((F32 *)input_boxes, (F32 *)input_scores, ic0, ic1,
+                    nonMaxSuppressionParamSpec, (F32 *)ref);
+                break;
+#endif
+#ifdef _USE_FP16
+            case DT_F16:
+                non_max_suppression_reference((F16 *)input_boxes, (F16 *)input_scores, ic0, ic1,
+                    nonMaxSuppressionParamSpec, (F16 *)ref);
+                break;
+#endif
+            default:
+                break;
+        }
+        // both archs run the shared NMS of the operators, check them against the reference
+        ArchInfo archInfos[2] = {archInfo_org, archInfo};
+        for (U32 i = 0; i < 2; i++) {
+            memset(get_ptr_from_tensor(outputTensor, UT_ARCH), 0, outputTensor.bytes());
+            CHECK_STATUS(non_max_suppression(
+                inputTensors, nonMaxSuppressionParamSpec, tmpTensor, outputTensor, &archInfos[i]));
+            ut_check_v(get_ptr_from_tensor(outputTensor, UT_ARCH), ref, output_len, dt, 0.05,
+                __FILE__, __LINE__);
+        }
     }
 
     U32 num_detected_max = max_output_boxes_per_class * ic1;
@@ -63,9 +63,19 @@ int int8PoolingTest(int argc, char **argv, DataType dt)
     memcpy(get_ptr_from_tensor(inputTensorRef, UT_ARCH), input_ref, tensorNumBytes(in_desc_ref));
 
     inputTensor.alloc();
-    F16 inputScale = -1;
-    quantize_tensor(in_desc_ref, input_ref, &input_desc, get_ptr_from_tensor(inputTensor, UT_ARCH),
-        &inputScale);
+    // the type of scale is the same as the data
+    F32 inputScale = -1;
+    if (DT_F32 == dt) {
+        quantize_tensor(in_desc_ref, input_ref, &input_desc,
+            get_ptr_from_tensor(inputTensor, UT_ARCH), &inputScale);
+    } else {
+#ifdef _USE_FP16
+        F16 scale = -1;
+        quantize_tensor(in_desc_ref, input_ref, &input_desc,
+            get_ptr_from_tensor(inputTensor, UT_ARCH), &scale);
+        inputScale = scale;
+#endif
+    }
     inputTensor.set_scale(inputScale);
 
     outputTensor.alloc();
@@ -139,7 +149,11 @@ int int8PoolingTest(int argc, char **argv, DataType dt)
 int main(int argc, char **argv)
 {
 #ifdef _USE_INT8
+#ifdef _USE_FP16
     int8PoolingTest(argc, argv, DT_F16);
+#elif defined(_USE_X86)
+    int8PoolingTest(argc, argv, DT_F32);
+#endif
 #endif
     return 0;
 }
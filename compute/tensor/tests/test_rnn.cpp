@@ -16,9 +16,9 @@
 #include "tensor_computing.h"
 #include "ut_util.h"
 
-int rnnTest(int argc, char **argv, DataType dt)
+int rnnTest(int argc, char **argv, DataType dt, bool biDirection)
 {
-    CHECK_REQUIREMENT(argc == 5);
+    CHECK_REQUIREMENT(argc == 5 || argc == 7);
     U32 batch = atoi(argv[1]);
     U32 step = atoi(argv[2]);
     U32 xDim = atoi(argv[3]);
@@ -30,9 +30,13 @@ int rnnTest(int argc, char **argv, DataType dt)
 
     RNNParamSpec rnnParamSpec;
     rnnParamSpec.mode = RNN_LSTM;
-    rnnParamSpec.biDirection = false;
+    rnnParamSpec.biDirection = biDirection;
     rnnParamSpec.numOutput = hDim;
     rnnParamSpec.numProjection = 1024;
+    if (argc == 7) {
+        rnnParamSpec.biDirection = atoi(argv[5]);
+        rnnParamSpec.numProjection = atoi(argv[6]);
+    }
     rnnParamSpec.forgetBias = 1.0;
     rnnParamSpec.activationMode = ACTIVATION_TANH;
     rnnParamSpec.zoneoutCell = 0;
@@ -44,6 +48,7 @@ int rnnTest(int argc, char **argv, DataType dt)
 
     U32 column = (rnnParamSpec.numProjection > 0) ? rnnParamSpec.numProjection
                                                   : rnnParamSpec.numOutput;
+    U32 num1 = rnnParamSpec.biDirection ? 2 : 1;
     U32 num2 = (rnnParamSpec.numProjection > 0) ? 2 : 1;
     TensorDesc inputDesc = tensor3df(dt, DF_MTK, batch, step, xDim);
     Tensor inputTensor;
@@ -54,13 +59,19 @@ int rnnTest(int argc, char **argv, DataType dt)
     memcpy(get_ptr_from_tensor(inputTensor, UT_ARCH), input, tensorNumBytes(inputDesc));
 
     U32 tmpBytes;
-    std::vector<TensorDesc> filterDesc(2), biasDesc(2);
-    filterDesc[0] = tensor2df(dt, DF_NK, 4 * column, xDim + hDim);
-    filterDesc[1] = tensor2df(dt, DF_NK, rnnParamSpec.numOutput, rnnParamSpec.numProjection);
-    biasDesc[0] = tensor1d(dt, column * 4);
-    biasDesc[1] = tensor1d(dt, rnnParamSpec.numOutput);
-    std::vector<Tensor> filterTensor(num2), biasTensor(num2);
-    for (U32 i = 0; i < num2; i++) {
+    std::vector<TensorDesc> filterDesc(num1 * num2), biasDesc(num1 * num2);
+    for (U32 i = 0; i < num1 * num2; i++) {
+        if (i % num2 == 0) {
+            filterDesc[i] = tensor2df(dt, DF_NK, 4 * column, xDim + hDim);
+            biasDesc[i] = tensor1d(dt, column * 4);
+        } else {
+            filterDesc[i] =
+                tensor2df(dt, DF_NK, rnnParamSpec.numOutput, rnnParamSpec.numProjection);
+            biasDesc[i] = tensor1d(dt, rnnParamSpec.numOutput);
+        }
+    }
+    std::vector<Tensor> filterTensor(num1 * num2), biasTensor(num1 * num2);
+    for (U32 i = 0; i < num1 * num2; i++) {
         filterTensor[i].resize(filterDesc[i]);
         filterTensor[i].alloc();
         U8 *filter = ut_input_v(tensorNumBytes(filterDesc[i]) / bytesOf(dt), dt, UT_INIT_RANDOM);
@@ -86,11 +97,11 @@ int rnnTest(int argc, char **argv, DataType dt)
 
     CHECK_STATUS(rnn_infer_forward_tmp_bytes(
         inputTensor, filterTensor[0], outputTensor, rnnParamSpec, &tmpBytes, &archInfo));
-    std::vector<U32> ftmBytes(num2);
+    std::vector<U32> ftmBytes(num1 * num2);
     CHECK_STATUS(rnn_transform_filter_bytes(filterTensor, rnnParamSpec, ftmBytes.data(), &archInfo));
-    std::vector<Tensor> ftmTensor(num2);
-    std::vector<Tensor *> ftmTensorPtr(num2);
-    for (U32 i = 0; i < num2; i++) {
+    std::vector<Tensor> ftmTensor(num1 * num2);
+    std::vector<Tensor *> ftmTensorPtr(num1 * num2);
+    for (U32 i = 0; i < num1 * num2; i++) {
         ftmTensor[i].resize(tensor1d(DT_U8, ftmBytes[i]));
         ftmTensor[i].alloc();
         ftmTensorPtr[i] = &ftmTensor[i];
@@ -114,6 +125,24 @@ int rnnTest(int argc, char **argv, DataType dt)
         ut_check_v(get_ptr_from_tensor(outputTensor, UT_ARCH),
             get_ptr_from_tensor(outputTensorRef, UT_ARCH), outputLength, dt, threshold, __FILE__,
             __LINE__);
+
+        // the directions run at the same time on their own threads, which gives the result of
+        // one thread, also when the threads can not be split evenly
+        if (rnnParamSpec.biDirection) {
+            int threadNum = get_cpu_num_threads();
+            set_cpu_num_threads(1);
+            CHECK_STATUS(rnn(inputTensor, ftmTensor, biasTensor, rnnParamSpec, tmpTensor,
+                outputTensorRef, &archInfo));
+            for (int threads : {2, 3, 4}) {
+                set_cpu_num_threads(threads);
+                CHECK_STATUS(rnn(inputTensor, ftmTensor, biasTensor, rnnParamSpec, tmpTensor,
+                    outputTensor, &archInfo));
+                ut_check_v(get_ptr_from_tensor(outputTensor, UT_ARCH),
+                    get_ptr_from_tensor(outputTensorRef, UT_ARCH), outputLength, dt, 0.001,
+                    __FILE__, __LINE__);
+            }
+            set_cpu_num_threads(threadNum);
+        }
     }
 
     // benchmark
@@ -128,10 +157,11 @@ int rnnTest(int argc, char **argv, DataType dt)
     // log performance data
     char buffer[150];
     char params[120];
-    sprintf(params, "%u (%u %u %u)=(%u %u)", batch, step, xDim, hDim, batch, hDim);
+    sprintf(params, "%u (%u %u %u %u)=(%u %u)", batch, step, xDim, hDim, rnnParamSpec.biDirection,
+        batch, hDim);
     sprintf(buffer, "%20s, %80s", "RNN", params);
     double hxDim = hDim + xDim;
-    double ops = 1.0 * batch * step *
+    double ops = 1.0 * num1 * batch * step *
         (2.0 * hxDim * column * 4 + column * 4 + rnnParamSpec.numProjection * rnnParamSpec.numOutput);
     ut_log(dt, buffer, ops, time);
 
@@ -141,11 +171,17 @@ int rnnTest(int argc, char **argv, DataType dt)
 
 int main(int argc, char **argv)
 {
+    // without the direction in the arguments, the bidirectional case is also run
+    for (bool biDirection : {false, true}) {
+        if (biDirection && argc != 5) {
+            break;
+        }
 #ifdef _USE_FP16
-    rnnTest(argc, argv, DT_F16);
+        rnnTest(argc, argv, DT_F16, biDirection);
 #endif
 #ifdef _USE_FP32
-    rnnTest(argc, argv, DT_F32);
+        rnnTest(argc, argv, DT_F32, biDirection);
 #endif
+    }
     return 0;
 }
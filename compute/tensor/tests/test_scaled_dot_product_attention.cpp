@@ -0,0 +1,214 @@
+// Copyright (C) 2019. Huawei Technologies Co., Ltd. All rights reserved.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include <vector>
+
+#include "tensor_computing.h"
+#include "ut_util.h"
+
+static Tensor alloc_tensor(TensorDesc desc)
+{
+    Tensor tensor;
+    tensor.resize(desc);
+    tensor.alloc();
+    return tensor;
+}
+
+static Tensor alloc_tmp(U32 bytes)
+{
+    return alloc_tensor(tensor1d(DT_U8, bytes));
+}
+
+// the unfused graph of the models: transpose, matmul, scale and mask, softmax, matmul, transpose
+class UnfusedAttention {
+public:
+    UnfusedAttention(Tensor q, Tensor k, Tensor v, F32 *mask, F32 scale, ArchInfo_t archInfo)
+    {
+        this->q = q;
+        this->k = k;
+        this->v = v;
+        this->mask = mask;
+        this->scale = scale;
+        this->archInfo = archInfo;
+        this->p.trans_size = 4;
+        U32 dims[4] = {0, 2, 1, 3};
+        memcpy(this->p.trans_dims, dims, sizeof(dims));
+        CHECK_STATUS(transpose_infer_output_size(&q, this->p, &this->qT, archInfo));
+        CHECK_STATUS(transpose_infer_output_size(&k, this->p, &this->kT, archInfo));
+        CHECK_STATUS(transpose_infer_output_size(&v, this->p, &this->vT, archInfo));
+        this->qT.alloc();
+        this->kT.alloc();
+        this->vT.alloc();
+        CHECK_STATUS(
+            matmul_infer_output_size(&this->qT, false, &this->kT, true, &this->score, archInfo));
+        this->score.alloc();
+        CHECK_STATUS(softmax_infer_output_size(&this->score, &this->attention, archInfo));
+        this->attention.alloc();
+        CHECK_STATUS(matmul_infer_output_size(
+            &this->attention, false, &this->vT, false, &this->context, archInfo));
+        this->context.alloc();
+        U32 bytes0, bytes1;
+        CHECK_STATUS(
+            matmul_infer_forward_tmp_bytes(this->qT, false, this->kT, true, &bytes0, archInfo));
+        CHECK_STATUS(matmul_infer_forward_tmp_bytes(
+            this->attention, false, this->vT, false, &bytes1, archInfo));
+        this->tmp = alloc_tmp(UNI_MAX(bytes0, bytes1));
+    }
+
+    void run(Tensor output)
+    {
+        Tensor blankTensor;
+        CHECK_STATUS(transpose(this->q, this->p, blankTensor, this->qT, this->archInfo));
+        CHECK_STATUS(transpose(this->k, this->p, blankTensor, this->kT, this->archInfo));
+        CHECK_STATUS(transpose(this->v, this->p, blankTensor, this->vT, this->archInfo));
+        CHECK_STATUS(
+            matmul(this->qT, false, this->kT, true, this->tmp, this->score, this->archInfo));
+        // score is [batch, heads, qLength, kLength], mask is [batch, 1, 1, kLength]
+        TensorDesc scoreDesc = this->score.get_desc();
+        U32 kLength = scoreDesc.dims[0];
+        U32 rows = scoreDesc.dims[1] * scoreDesc.dims[2];
+        F32 *score = (F32 *)get_ptr_from_tensor(this->score, this->archInfo->arch);
+        for (U32 b = 0; b < scoreDesc.dims[3]; b++) {
+            for (U32 i = 0; i < rows * kLength; i++, score++) {
+                *score = *score * this->scale + this->mask[b * kLength + i % kLength];
+            }
+        }
+        SoftmaxParamSpec softmaxParamSpec;
+        softmaxParamSpec.axis = -1;
+        CHECK_STATUS(softmax(
+            this->score, softmaxParamSpec, blankTensor, this->attention, this->archInfo));
+        CHECK_STATUS(matmul(
+            this->attention, false, this->vT, false, this->tmp, this->context, this->archInfo));
+        CHECK_STATUS(transpose(this->context, this->p, blankTensor, output, this->archInfo));
+    }
+
+private:
+    Tensor q, k, v, qT, kT, vT, score, attention, context, tmp;
+    F32 *mask;
+    F32 scale;
+    TransposeParamSpec p;
+    ArchInfo_t archInfo;
+};
+
+int scaledDotProductAttentionTest(int argc, char **argv, DataType dt)
+{
+    // BERT base
+    U32 batch = 1;
+    U32 qLength = 128;
+    U32 kLength = 128;
+    U32 heads = 12;
+    U32 size = 64;
+    if (argc == 6) {
+        batch = atoi(argv[1]);
+        qLength = atoi(argv[2]);
+        kLength = atoi(argv[3]);
+        heads = atoi(argv[4]);
+        size = atoi(argv[5]);
+    } else {
+        CHECK_REQUIREMENT(argc == 1);
+    }
+    ArchInfo archInfo;
+    archInfo.arch = UT_ARCH;
+    ArchInfo archInfo_org;
+    archInfo_org.arch = CPU_GENERAL;
+    ScaledDotProductAttentionParamSpec p;
+    p.scale = 1.0 / sqrt(size);
+
+    std::vector<Tensor> inputTensors;
+    std::vector<TensorDesc> descs = {tensor4df(dt, DF_NCHW, batch, qLength, heads, size),
+        tensor4df(dt, DF_NCHW, batch, kLength, heads, size),
+        tensor4df(dt, DF_NCHW, batch, kLength, heads, size)};
+    for (U32 i = 0; i < descs.size(); i++) {
+        Tensor tensor = alloc_tensor(descs[i]);
+        ut_init_v((U8 *)get_ptr_from_tensor(tensor, UT_ARCH), tensorNumElements(descs[i]), dt,
+            UT_INIT_RANDOM);
+        inputTensors.push_back(tensor);
+    }
+    // padding mask of the last keys
+    TensorDesc maskDesc = tensor4df(dt, DF_NCHW, batch, 1, 1, kLength);
+    Tensor maskTensor = alloc_tensor(maskDesc);
+    F32 *mask = (F32 *)get_ptr_from_tensor(maskTensor, UT_ARCH);
+    for (U32 b = 0; b < batch; b++) {
+        for (U32 j = 0; j < kLength; j++) {
+            mask[b * kLength + j] = (j + b * 3 + 3 >= kLength) ? -10000 : 0;
+        }
+    }
+    inputTensors.push_back(maskTensor);
+
+    std::vector<Tensor *> inputTensorPtrs;
+    for (U32 i = 0; i < inputTensors.size(); i++) {
+        inputTensorPtrs.push_back(&inputTensors[i]);
+    }
+    Tensor outputTensor;
+    CHECK_STATUS(
+        scaled_dot_product_attention_infer_output_size(inputTensorPtrs, &outputTensor, &archInfo));
+    outputTensor.alloc();
+    Tensor outputTensorRef = alloc_tensor(outputTensor.get_desc());
+    U32 tmpBytes;
+    CHECK_STATUS(
+        scaled_dot_product_attention_infer_forward_tmp_bytes(inputTensors, &tmpBytes, &archInfo));
+    Tensor tmpTensor = alloc_tmp(tmpBytes);
+    UnfusedAttention unfused(
+        inputTensors[0], inputTensors[1], inputTensors[2], mask, p.scale, &archInfo);
+
+    if (UT_CHECK) {
+        CHECK_STATUS(scaled_dot_product_attention(
+            inputTensors, p, tmpTensor, outputTensor, &archInfo));
+        unfused.run(outputTensorRef);
+        ut_check_v(get_ptr_from_tensor(outputTensor, UT_ARCH),
+            get_ptr_from_tensor(outputTensorRef, UT_ARCH), outputTensor.length(), dt, 0.001,
+            __FILE__, __LINE__);
+
+        Tensor blankTensor;
+        CHECK_STATUS(scaled_dot_product_attention(
+            inputTensors, p, blankTensor, outputTensorRef, &archInfo_org));
+        ut_check_v(get_ptr_from_tensor(outputTensor, UT_ARCH),
+            get_ptr_from_tensor(outputTensorRef, UT_ARCH), outputTensor.length(), dt, 0.001,
+            __FILE__, __LINE__);
+    }
+
+    // benchmark
+    double time_start = ut_time_ms();
+    for (int iter = 0; iter < UT_LOOPS; iter++) {
+        CHECK_STATUS(scaled_dot_product_attention(
+            inputTensors, p, tmpTensor, outputTensor, &archInfo));
+    }
+    double time_end = ut_time_ms();
+    double time = (time_end - time_start) / UT_LOOPS;
+    time_start = ut_time_ms();
+    for (int iter = 0; iter < UT_LOOPS; iter++) {
+        unfused.run(outputTensorRef);
+    }
+    time_end = ut_time_ms();
+    double timeUnfused = (time_end - time_start) / UT_LOOPS;
+
+    // log performance data
+    char buffer[150];
+    char params[120];
+    sprintf(params, "(%u %u %u %u %u)=(%u %u %u %u)", batch, qLength, kLength, heads, size,
+        batch, qLength, heads, size);
+    double ops = 4.0 * batch * heads * qLength * kLength * size;
+    sprintf(buffer, "%20s, %80s", "ScaledDotProductAttention", params);
+    ut_log(dt, buffer, ops, time);
+    sprintf(buffer, "%20s, %80s", "UnfusedAttention", params);
+    ut_log(dt, buffer, ops, timeUnfused);
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+#ifdef _USE_FP32
+    scaledDotProductAttentionTest(argc, argv, DT_F32);
+#endif
+    return 0;
+}
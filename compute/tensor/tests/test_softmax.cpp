@@ -70,13 +70,62 @@ int softmaxTest(int argc, char **argv, DataType dt)
     return 0;
 }
 
+// An NCHWC8 input gives an NCHWC8 output, which has to be the softmax of the NCHW input on
+// every axis. The channel axis is reduced over the blocks of 8 channels and their lanes.
+int softmaxNCHWC8Test(DataType dt)
+{
+    ArchInfo archInfo;
+    archInfo.arch = UT_ARCH;
+    ArchInfo archInfo_org;
+    archInfo_org.arch = CPU_GENERAL;
+    F32 threshold = (dt == DT_F32) ? 0.0001 : 0.01;
+    std::vector<std::vector<U32>> shapes = {{2, 16, 3, 5}, {1, 32, 7, 7}, {3, 24, 1, 1}};
+    for (auto &shape : shapes) {
+        TensorDesc nchwDesc = tensor4df(dt, DF_NCHW, shape[0], shape[1], shape[2], shape[3]);
+        TensorDesc nchwc8Desc = tensor4df(dt, DF_NCHWC8, shape[0], shape[1], shape[2], shape[3]);
+        U32 len = tensorNumElements(nchwDesc);
+        U8 *input = ut_input_v(len, dt, UT_INIT_RANDOM);
+        Tensor inputTensor = Tensor::alloc_sized<CPUMem>(nchwc8Desc);
+        CHECK_STATUS(transformNCHWToNCHWC8(
+            nchwDesc, input, nchwc8Desc, get_ptr_from_tensor(inputTensor, UT_ARCH)));
+        Tensor nchwTensor = Tensor::alloc_sized<CPUMem>(nchwDesc);
+        memcpy(get_ptr_from_tensor(nchwTensor, UT_ARCH), input, tensorNumBytes(nchwDesc));
+
+        Tensor outputTensor;
+        CHECK_STATUS(softmax_infer_output_size(&inputTensor, &outputTensor, &archInfo));
+        CHECK_REQUIREMENT(outputTensor.get_desc().df == DF_NCHWC8);
+        outputTensor.alloc();
+        Tensor outputTensorRef = Tensor::alloc_sized<CPUMem>(nchwDesc);
+        Tensor resultTensor = Tensor::alloc_sized<CPUMem>(nchwDesc);
+        Tensor blankTensor;
+        for (int axis = -4; axis < 4; axis++) {
+            SoftmaxParamSpec p;
+            p.axis = axis;
+            CHECK_STATUS(softmax(nchwTensor, p, blankTensor, outputTensorRef, &archInfo_org));
+            for (ArchInfo *arch : {&archInfo, &archInfo_org}) {
+                CHECK_STATUS(softmax(inputTensor, p, blankTensor, outputTensor, arch));
+                CHECK_STATUS(transformToNCHW(outputTensor.get_desc(),
+                    get_ptr_from_tensor(outputTensor, UT_ARCH), nchwDesc,
+                    get_ptr_from_tensor(resultTensor, UT_ARCH)));
+                ut_check_v(get_ptr_from_tensor(resultTensor, UT_ARCH),
+                    get_ptr_from_tensor(outputTensorRef, UT_ARCH), len, dt, threshold, __FILE__,
+                    __LINE__);
+            }
+        }
+        free(input);
+    }
+    return 0;
+}
+
 int main(int argc, char **argv)
 {
 #ifdef _USE_FP16
     softmaxTest(argc, argv, DT_F16);
+    softmaxNCHWC8Test(DT_F16);
 #endif
 #ifdef _USE_FP32
     softmaxTest(argc, argv, DT_F32);
+    softmaxNCHWC8Test(DT_F32);
 #endif
     return 0;
 }
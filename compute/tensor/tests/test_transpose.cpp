@@ -16,20 +16,14 @@
 #include "tensor_computing.h"
 #include "ut_util.h"
 
-int transposeTest(int argc, char **argv, DataType dt)
+int transposeTest(U32 in, U32 ic, U32 ih, U32 iw, const U32 *dims, DataType dt)
 {
-    CHECK_REQUIREMENT(argc == 9);
-    U32 in = atoi(argv[1]);
-    U32 ic = atoi(argv[2]);
-    U32 ih = atoi(argv[3]);
-    U32 iw = atoi(argv[4]);
     TransposeParamSpec p, p_inv;
     p.trans_size = 4;
     p_inv.trans_size = 4;
     for (int i = 0; i < 4; i++) {
-        I32 value = atoi(argv[5 + i]);
-        p.trans_dims[i] = value;
-        p_inv.trans_dims[value] = i;
+        p.trans_dims[i] = dims[i];
+        p_inv.trans_dims[dims[i]] = i;
     }
     ArchInfo archInfo;
     archInfo.arch = UT_ARCH;
@@ -50,9 +44,15 @@ int transposeTest(int argc, char **argv, DataType dt)
     outputTensor1.alloc();
     outputTensor2.alloc();
     Tensor blankTensor;
+    TensorDesc outDesc = outputTensor1.get_desc();
+    U8 *outputRef = ut_input_v(len, dt, UT_INIT_ZERO);
 
     if (UT_CHECK) {
         CHECK_STATUS(transpose(inputTensor, p, blankTensor, outputTensor1, &archInfo));
+        CHECK_STATUS(array_transpose(
+            dt, inDesc.dims, input, outDesc.dims, outputRef, p.trans_dims, inDesc.nDims));
+        ut_check_v(get_ptr_from_tensor(outputTensor1, UT_ARCH), outputRef, len, dt, 0, __FILE__,
+            __LINE__);
 
         CHECK_STATUS(transpose(outputTensor1, p_inv, blankTensor, outputTensor2, &archInfo));
 
@@ -68,11 +68,20 @@ int transposeTest(int argc, char **argv, DataType dt)
     double time_end = ut_time_ms();
     double time = (time_end - time_start) / UT_LOOPS;
 
+    // the element-wise reference, to show the gain
+    time_start = ut_time_ms();
+    for (int iter = 0; iter < UT_LOOPS; iter++) {
+        CHECK_STATUS(array_transpose(
+            dt, inDesc.dims, input, outDesc.dims, outputRef, p.trans_dims, inDesc.nDims));
+    }
+    time_end = ut_time_ms();
+    double timeRef = (time_end - time_start) / UT_LOOPS;
+
     U32 on = 0;
     U32 oc = 0;
     U32 oh = 0;
     U32 ow = 0;
-    CHECK_STATUS(tensor4dGet(outputTensor1.get_desc(), &dt, &df, &on, &oc, &oh, &ow));
+    CHECK_STATUS(tensor4dGet(outDesc, &dt, &df, &on, &oc, &oh, &ow));
     // log performance data
     char buffer[150];
     char params[120];
@@ -80,12 +89,40 @@ int transposeTest(int argc, char **argv, DataType dt)
     sprintf(buffer, "%20s, %80s", "Transpose", params);
     double ops = len;
     ut_log(dt, buffer, ops, time);
+    sprintf(buffer, "%20s, %80s", "Transpose(ref)", params);
+    ut_log(dt, buffer, ops, timeRef);
 
     free(input);
+    free(outputRef);
 
     return 0;
 }
 
+int transposeTest(int argc, char **argv, DataType dt)
+{
+    if (argc == 1) {
+        // the permutations of the attention layers of BERT-base, sequence length 128
+        std::vector<std::vector<U32>> cases = {
+            {1, 128, 12, 64, 0, 2, 1, 3},
+            {1, 12, 128, 64, 0, 2, 1, 3},
+            {1, 128, 12, 64, 0, 2, 3, 1},
+            {1, 12, 128, 64, 0, 1, 3, 2},
+            {1, 12, 64, 128, 0, 1, 3, 2},
+            {8, 128, 12, 64, 0, 2, 1, 3},
+        };
+        for (auto c : cases) {
+            transposeTest(c[0], c[1], c[2], c[3], c.data() + 4, dt);
+        }
+        return 0;
+    }
+    CHECK_REQUIREMENT(argc == 9);
+    U32 dims[4];
+    for (int i = 0; i < 4; i++) {
+        dims[i] = atoi(argv[5 + i]);
+    }
+    return transposeTest(atoi(argv[1]), atoi(argv[2]), atoi(argv[3]), atoi(argv[4]), dims, dt);
+}
+
 int main(int argc, char **argv)
 {
 #ifdef _USE_FP16
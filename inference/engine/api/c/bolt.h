@@ -28,6 +28,9 @@ typedef void *ModelHandle;
 /** result data memory handle */
 typedef void *ResultHandle;
 
+/** batched inference handle */
+typedef void *BatchHandle;
+
 /** CPU affinity policy */
 typedef enum {
     CPU_HIGH_PERFORMANCE = 0,  ///< performance is high priority(use big core)
@@ -37,13 +40,14 @@ typedef enum {
 
 /** heterogeneous device type */
 typedef enum {
-    CPU_SERIAL = 0,    ///< CPU serial
-    CPU_ARM_V7 = 1,    ///< ARMv7 CPU
-    CPU_ARM_V8 = 2,    ///< ARMv8 CPU
-    CPU_ARM_A55 = 3,   ///< ARM A55 CPU
-    CPU_ARM_A76 = 4,   ///< ARM A76 CPU
-    CPU_X86_AVX2 = 5,  ///< X86_64 AVX2 CPU
-    GPU_MALI = 10      ///< ARM MALI GPU
+    CPU_SERIAL = 0,      ///< CPU serial
+    CPU_ARM_V7 = 1,      ///< ARMv7 CPU
+    CPU_ARM_V8 = 2,      ///< ARMv8 CPU
+    CPU_ARM_A55 = 3,     ///< ARM A55 CPU
+    CPU_ARM_A76 = 4,     ///< ARM A76 CPU
+    CPU_X86_AVX2 = 5,    ///< X86_64 AVX2 CPU
+    CPU_X86_AVX512 = 6,  ///< X86_64 AVX-512 CPU
+    GPU_MALI = 10        ///< ARM MALI GPU
 } DEVICE_TYPE;
 
 /** data precision */
@@ -237,6 +241,42 @@ void SetRuntimeDevice(ModelHandle ih, int cpu_id, DEVICE_TYPE device);
  */
 void SetRuntimeDeviceDynamic(ModelHandle ih);
 
+/**
+ * @brief set the number of CPU threads used by one inference of the model
+ * @param  ih            inference pipeline handle
+ * @param  threads       the number of threads(1, 2, 3...)
+ *
+ * @return
+ *
+ * @note
+ * The threads are pinned to the cores selected by the affinity policy, and they are reused by the
+ * following RunModel calls. This only works when the library is compiled with OpenMP.
+ */
+void SetNumThreads(ModelHandle ih, int threads);
+
+/**
+ * @brief switch on or off the per operator runtime profiler of all the models
+ * @param  enable        1 to record every operator run, 0 to stop recording
+ *
+ * @return
+ *
+ * @note
+ * It can also be switched on by setting the environment variable BOLT_RUNTIME_PROFILE=1.
+ * Each thread keeps its latest 2048 records, the older ones are overwritten.
+ */
+void SetRuntimeProfile(int enable);
+
+/**
+ * @brief write the recorded operator runs in Chrome trace format and clear them
+ * @param  path          the output json file, it can be opened in chrome://tracing
+ *
+ * @return 0 on success, -1 if the file can not be written
+ *
+ * @note
+ * Call it when no model is running, the per operator type summary is also printed.
+ */
+int DumpRuntimeProfile(const char *path);
+
 /**
  * @brief inference result from input
  * @param  ih            inference pipeline handle
@@ -249,6 +289,49 @@ void SetRuntimeDeviceDynamic(ModelHandle ih);
  */
 void RunModel(ModelHandle ih, ResultHandle ir, const int num_input, char **inputNames, void **mem);
 
+/**
+ * @brief create a batching front end of the model, which coalesces the RunBatchModel calls of many
+ * threads into one inference
+ * @param  ih            inference pipeline handle, PrepareModel must be called with the shape of one request
+ * @param  max_batch     the maximum number of requests in one inference
+ * @param  timeout_us    the longest time(microseconds) that a request waits for others
+ *
+ * @return batched inference handle
+ *
+ * @note
+ * The requests are concatenated along the n dimension, so the model must support n > 1 on the
+ * device. If an output is not batched along n, requests are run one by one.
+ * Memory is planned once for max_batch requests, so smaller batches do not re-plan it.
+ * Don't use RunModel or ResizeModelInput of ih until the handle is destroyed.
+ * @code
+ *     PrepareModel(ih, ...);
+ *     BatchHandle bh = CreateBatchModel(ih, 8, 2000);
+ *     // on each client thread
+ *     ResultHandle ir = AllocAllResultHandle(ih);
+ *     RunBatchModel(bh, ir, ...);
+ *     ...
+ *     DestroyBatchModel(bh);
+ * @endcode
+ */
+BatchHandle CreateBatchModel(ModelHandle ih, int max_batch, int timeout_us);
+
+/**
+ * @brief inference one request through the batching front end, it can be called by many threads
+ * @param  bh            batched inference handle
+ * @param  ir            result data memory handle, each thread should use its own
+ * @param  num_input     the number of input data
+ * @param  inputNames    the array of all input data's name in string format
+ * @param  mem           the array of all input data of one request
+ *
+ * @return
+ *
+ * @note
+ * The outputs of the request are copied to memory owned by ir, they stay valid until the next
+ * RunBatchModel with ir or FreeResultHandle.
+ */
+void RunBatchModel(
+    BatchHandle bh, ResultHandle ir, const int num_input, char **inputNames, void **mem);
+
 /**
  * @brief get the number of model output from ResultHandle
  * @param  ir            result data memory handle
@@ -329,6 +412,14 @@ void CopyOutputsFromResultHandle(ResultHandle ir, int num_outputs, const int *si
  */
 void FreeResultHandle(ResultHandle ir);
 
+/**
+ * @brief destroy batched inference handle, call it before DestroyModel
+ * @param  bh            batched inference handle
+ *
+ * @return
+ */
+void DestroyBatchModel(BatchHandle bh);
+
 /**
  * @brief destroy model
  * @param  ih            inference pipeline handle
@@ -31,13 +31,14 @@ enum AffinityType {
 
 /** heterogeneous device type */
 enum DeviceType {
-    CPU_ARM_V7,   ///< ARMv7 CPU
-    CPU_ARM_V8,   ///< ARMv8 CPU
-    CPU_ARM_A55,  ///< ARM A55 CPU
-    CPU_ARM_A76,  ///< ARM A76 CPU
-    GPU_MALI,     ///< ARM MALI GPU
-    CPU_X86_AVX2, ///< X86_64 AVX2 CPU
-    CPU_SERIAL    ///< CPU serial
+    CPU_ARM_V7,     ///< ARMv7 CPU
+    CPU_ARM_V8,     ///< ARMv8 CPU
+    CPU_ARM_A55,    ///< ARM A55 CPU
+    CPU_ARM_A76,    ///< ARM A76 CPU
+    GPU_MALI,       ///< ARM MALI GPU
+    CPU_X86_AVX2,   ///< X86_64 AVX2 CPU
+    CPU_X86_AVX512, ///< X86_64 AVX-512 CPU
+    CPU_SERIAL      ///< CPU serial
 }
 
 /** data precision */
@@ -155,6 +156,8 @@ public final class BoltModel implements Cloneable {
             ret = "GPU_MALI";
         } else if (device == DeviceType.CPU_X86_AVX2) {
             ret = "CPU_X86_AVX2";
+        } else if (device == DeviceType.CPU_X86_AVX512) {
+            ret = "CPU_X86_AVX512";
         } else if (device == DeviceType.CPU_SERIAL) {
             ret = "CPU_SERIAL";
         } else {
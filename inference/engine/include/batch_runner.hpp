@@ -0,0 +1,223 @@
+// Copyright (C) 2019. Huawei Technologies Co., Ltd. All rights reserved.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef _BATCH_RUNNER_H
+#define _BATCH_RUNNER_H
+
+#include <errno.h>
+#include <pthread.h>
+#include <time.h>
+#include <deque>
+#include "cnn.h"
+
+// Coalesce the requests of many threads into one inference with batch N > 1.
+// The requests are concatenated along the outermost (batch) dimension, and the model is run by
+// an internal thread, so the CNN should not be used by others until the runner is destroyed.
+class BatchRunner {
+public:
+    // cnn is ready with the input shape of one request. timeoutUs is the longest time that the
+    // first request of a batch waits for others.
+    BatchRunner(CNN *cnn, U32 maxBatch, U32 timeoutUs)
+    {
+        this->cnn = cnn;
+        this->maxBatch = UNI_MAX(maxBatch, 1);
+        this->timeoutUs = timeoutUs;
+        this->stop = false;
+        this->inputNames = cnn->get_model_input_tensor_names();
+        std::vector<std::string> outputNames = cnn->get_model_output_tensor_names();
+        for (std::string name : outputNames) {
+            this->outputBytes[name] = tensorNumBytes(cnn->get_tensor_desc_by_name(name));
+        }
+        for (U32 batch = 1; batch <= this->maxBatch; batch++) {
+            std::map<std::string, TensorDesc> descs;
+            for (std::string name : this->inputNames) {
+                TensorDesc desc = cnn->get_tensor_desc_by_name(name);
+                desc.dims[desc.nDims - 1] *= batch;
+                descs[name] = desc;
+            }
+            this->batchDescs.push_back(descs);
+        }
+        if (cnn->get_runtime_device() == MALI) {
+            UNI_ERROR_LOG("batch runner currently only supports CPU.\n");
+            this->maxBatch = 1;
+        }
+        if (this->maxBatch > 1) {
+            // plan the memory for the biggest batch once, smaller batches reuse it
+            cnn->reready(this->batchDescs[this->maxBatch - 1]);
+            for (std::string name : outputNames) {
+                TensorDesc desc = cnn->get_tensor_desc_by_name(name);
+                if (tensorNumBytes(desc) != this->outputBytes[name] * this->maxBatch) {
+                    UNI_WARNING_LOG("output %s is not batched along the outermost dimension, "
+                                    "requests will be run one by one.\n",
+                        name.c_str());
+                    this->maxBatch = 1;
+                }
+            }
+            cnn->reready(this->batchDescs[0]);
+        }
+        this->currentBatch = 1;
+
+        pthread_mutex_init(&(this->lock), NULL);
+        pthread_cond_init(&(this->requestCondition), NULL);
+        pthread_cond_init(&(this->finishCondition), NULL);
+        if (pthread_create(&(this->thread), NULL, worker, reinterpret_cast<void *>(this)) != 0) {
+            UNI_ERROR_LOG("batch runner can not create thread.\n");
+        }
+    }
+
+    ~BatchRunner()
+    {
+        pthread_mutex_lock(&(this->lock));
+        this->stop = true;
+        pthread_cond_broadcast(&(this->requestCondition));
+        pthread_mutex_unlock(&(this->lock));
+        pthread_join(this->thread, NULL);
+        pthread_mutex_destroy(&(this->lock));
+        pthread_cond_destroy(&(this->requestCondition));
+        pthread_cond_destroy(&(this->finishCondition));
+    }
+
+    // run one request and copy its part of the outputs, it is thread safe and blocks until the
+    // batch that contains the request has finished
+    EE run(std::map<std::string, const U8 *> inputs, std::map<std::string, U8 *> outputs)
+    {
+        if (this->cnn->get_runtime_device() == MALI) {
+            return NOT_SUPPORTED;
+        }
+        for (std::string name : this->inputNames) {
+            if (inputs.find(name) == inputs.end()) {
+                UNI_ERROR_LOG("batch runner request lacks input %s.\n", name.c_str());
+                return NOT_MATCH;
+            }
+        }
+        for (auto iter : outputs) {
+            if (this->outputBytes.find(iter.first) == this->outputBytes.end()) {
+                UNI_ERROR_LOG("batch runner can not find output %s.\n", iter.first.c_str());
+                return NOT_MATCH;
+            }
+        }
+        Request request;
+        request.inputs = inputs;
+        request.outputs = outputs;
+        request.finished = false;
+        clock_gettime(CLOCK_REALTIME, &(request.deadline));
+        I64 ns = request.deadline.tv_nsec + (I64)this->timeoutUs * 1000;
+        request.deadline.tv_sec += ns / 1000000000;
+        request.deadline.tv_nsec = ns % 1000000000;
+
+        pthread_mutex_lock(&(this->lock));
+        this->requests.push_back(&request);
+        pthread_cond_signal(&(this->requestCondition));
+        while (!request.finished) {
+            pthread_cond_wait(&(this->finishCondition), &(this->lock));
+        }
+        pthread_mutex_unlock(&(this->lock));
+        return SUCCESS;
+    }
+
+    U32 get_max_batch()
+    {
+        return this->maxBatch;
+    }
+
+private:
+    struct Request {
+        std::map<std::string, const U8 *> inputs;
+        std::map<std::string, U8 *> outputs;
+        struct timespec deadline;
+        bool finished;
+    };
+
+    static void *worker(void *arg)
+    {
+        BatchRunner *runner = reinterpret_cast<BatchRunner *>(arg);
+        // bind the OpenMP threads of this thread like the caller's
+        runner->cnn->set_num_threads(runner->cnn->get_num_threads());
+        std::vector<Request *> batch;
+        pthread_mutex_lock(&(runner->lock));
+        while (true) {
+            while (runner->requests.empty() && !runner->stop) {
+                pthread_cond_wait(&(runner->requestCondition), &(runner->lock));
+            }
+            if (runner->requests.empty()) {
+                break;
+            }
+            // wait until the batch is full or the first request times out
+            struct timespec deadline = runner->requests.front()->deadline;
+            while (runner->requests.size() < runner->maxBatch && !runner->stop) {
+                if (pthread_cond_timedwait(&(runner->requestCondition), &(runner->lock),
+                        &deadline) == ETIMEDOUT) {
+                    break;
+                }
+            }
+            U32 num = UNI_MIN(runner->requests.size(), runner->maxBatch);
+            batch.assign(runner->requests.begin(), runner->requests.begin() + num);
+            runner->requests.erase(runner->requests.begin(), runner->requests.begin() + num);
+            pthread_mutex_unlock(&(runner->lock));
+
+            runner->run_batch(batch);
+
+            pthread_mutex_lock(&(runner->lock));
+            for (auto request : batch) {
+                request->finished = true;
+            }
+            pthread_cond_broadcast(&(runner->finishCondition));
+        }
+        pthread_mutex_unlock(&(runner->lock));
+        return NULL;
+    }
+
+    void run_batch(const std::vector<Request *> &batch)
+    {
+        U32 num = batch.size();
+        if (num != this->currentBatch) {
+            // only the shapes change, the memory has been planned for the biggest batch
+            this->cnn->reready(this->batchDescs[num - 1]);
+            this->currentBatch = num;
+        }
+        for (std::string name : this->inputNames) {
+            Tensor tensor = this->cnn->get_tensor_by_name(name);
+            U8 *ptr = (U8 *)((CpuMemory *)tensor.get_memory())->get_ptr();
+            U32 bytes = tensorNumBytes(this->batchDescs[0][name]);
+            for (U32 i = 0; i < num; i++) {
+                UNI_memcpy(ptr + i * bytes, batch[i]->inputs[name], bytes);
+            }
+        }
+        this->cnn->run();
+        for (U32 i = 0; i < num; i++) {
+            for (auto iter : batch[i]->outputs) {
+                Tensor tensor = this->cnn->get_tensor_by_name(iter.first);
+                U8 *ptr = (U8 *)((CpuMemory *)tensor.get_memory())->get_ptr();
+                U32 bytes = this->outputBytes[iter.first];
+                UNI_memcpy(iter.second, ptr + i * bytes, bytes);
+            }
+        }
+    }
+
+    CNN *cnn;
+    U32 maxBatch;
+    U32 timeoutUs;
+    U32 currentBatch;
+    std::vector<std::string> inputNames;
+    std::map<std::string, U32> outputBytes;
+    // input descs of 1 to maxBatch requests
+    std::vector<std::map<std::string, TensorDesc>> batchDescs;
+
+    std::deque<Request *> requests;
+    bool stop;
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t requestCondition;
+    pthread_cond_t finishCondition;
+};
+#endif
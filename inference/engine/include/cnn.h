@@ -18,10 +18,21 @@
 #include <cstring>
 #include "model.hpp"
 #include "memory_tracker.hpp"
+#include "parallel_executor.hpp"
 #ifdef _USE_MALI
 #include "gcl_common.h"
 #endif
 
+// Gets the model inputs and the outputs of every operator while CNN::run goes, for example to
+// collect the ranges of the activations for quantization. The tensors are only valid in
+// observe, they may be reused by the next operators.
+class TensorObserver {
+public:
+    virtual ~TensorObserver() = default;
+
+    virtual void observe(const std::string &tensorName, Tensor &tensor) = 0;
+};
+
 class CNN : public Model {
 public:
     CNN()
@@ -33,14 +44,23 @@ public:
 
     virtual ~CNN() = default;
 
+    // A clone shares the weights, the transformed weights, the algorithms and the memory plans
+    // with this model. It gets its own tensors, and the arena is allocated on its first use, so
+    // a clone per session is cheap.
     CNN clone();
 
     void sort_operators_sequential(const ModelSpec *ms);
 
-    void initialize_ops(const ModelSpec *ms);
+    void initialize_ops(ModelSpec *ms);
+
+    // replace the packed weights of this architecture and precision in ms with
+    // the transformed weights and chosen algorithms, call it after ready.
+    EE export_packed_weights(ModelSpec *ms);
 
     void ready(std::map<std::string, TensorDesc> inputDescMap) override;
 
+    // change the input shapes after ready. The tmp buffer sizes and the memory layout of every
+    // input shape are kept, a shape seen before only re-infers the operators through indexes.
     void reready(std::map<std::string, TensorDesc> inputDescMap);
 
     EE mark_input_output();
@@ -71,12 +91,25 @@ public:
 
     void run() override;
 
+    // the observer is not owned by the model, and a clone shares the observer of this model,
+    // set nullptr to stop observing
+    void set_tensor_observer(TensorObserver *observer);
+
+    void set_num_threads(int threadNum) override;
+
+    // run up to branchNum independent operators at the same time on CPU, the threads are shared
+    // among them. Models with Repeat or Jump still run one operator after another. If it is
+    // called after ready, the tensors are moved, so set the inputs after it.
+    void set_parallel_branches(U32 branchNum);
+
 #ifdef _USE_MALI
     void mali_prepare(bool reset);
 #endif
 private:
     std::shared_ptr<Tensor> allocate_tensor(U32 size = 0);
 
+    Tensor get_arena_tensor(U32 offset, U32 size);
+
     void add(std::shared_ptr<Operator> op,
         std::vector<std::string> inputTensorsName,
         std::vector<std::string> outputTensorsName);
@@ -93,10 +126,25 @@ private:
 
     void check_memory_reuse_ratio();
 
+    void schedule_parallel_operators();
+
+    void build_graph();
+
+    void set_operator_tensors(U32 opIndex);
+
+    std::vector<TensorDesc> get_shape_plan_key(std::map<std::string, TensorDesc> &inputDescMap);
+
+    void record_shape_plan(std::vector<TensorDesc> key);
+
+    void apply_shape_plan(U32 planIndex);
+
+    void assign_session_memory();
+
+    void observe_operator_outputs(U32 opIndex);
+
 private:
     std::map<std::string, std::shared_ptr<Tensor>> tensorMap;
     std::map<std::string, std::shared_ptr<Operator>> operatorMap;
-    std::map<std::string, std::vector<std::vector<std::string>>> operatorTensorMap;
 
     std::set<std::string> weightOpOutputNames;
     std::map<std::string, std::shared_ptr<Tensor>> inputTensors;
@@ -106,6 +154,49 @@ private:
 
     std::vector<std::string> sortedOps;
 
+    // the indexes of the operators that can run at the same time, step by step
+    std::vector<std::vector<U32>> parallelSteps;
+    U32 branchNum = 1;
+    std::shared_ptr<ParallelExecutor> executor;
+    // operators share one tmp buffer after set_num_threads, they can not run at the same time
+    bool sharedTmp = false;
+    TensorObserver *observer = nullptr;
+
+    // memory layout of one input shape in the arena
+    struct ShapePlan {
+        std::vector<TensorDesc> inputDescs;
+        // offset and size of each tensor of assignTensors whose position is not -1
+        std::vector<std::pair<U32, U32>> tensorArena;
+        std::vector<std::pair<U32, U32>> tmpArena;
+        U32 arenaSize;
+    };
+    std::vector<ShapePlan> shapePlans;
+    // the tensors are placed by a plan instead of the memory tracker
+    bool shapePlanApplied = false;
+    // the tensors of a clone have no memory until it is used
+    bool sessionMemoryPending = false;
+
+    // The graph by integer ids, built once by initialize_ops and shared by the clones, it does
+    // not change after build_graph. Operators are numbered in the order of ops, and tensors in
+    // the order of tensorMap. The names are only used by the public API and the memory tracker.
+    struct GraphIndex {
+        std::vector<std::string> tensorNames;
+        std::vector<bool> weightTensors;
+        std::vector<bool> outputTensors;
+        std::vector<U32> inputIds;
+        std::vector<std::vector<U32>> opInputIds;
+        std::vector<std::vector<U32>> opOutputIds;
+        // the input and output tensor names of each operator
+        std::vector<std::vector<std::string>> opTensorNames;
+        // the k-th operator of operatorMap is ops[operatorMapOrder[k]]
+        std::vector<U32> operatorMapOrder;
+        // the tensors that assign_output_tensor gives memory to, with their storage positions
+        std::vector<std::pair<U32, I32>> assignTensors;
+    };
+    std::shared_ptr<GraphIndex> graph;
+    // the tensors of this model by their ids
+    std::vector<Tensor *> graphTensors;
+
     std::vector<std::string> modelInputTensorNames;
     std::vector<TensorDesc> modelInputTensorDescs;
     std::vector<std::string> modelOutputTensorNames;
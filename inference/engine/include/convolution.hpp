@@ -52,6 +52,44 @@ public:
         return resultDesc;
     }
 
+    double get_flops() override
+    {
+        TensorDesc inputDesc = desc_process(this->inputTensors[0].get_desc());
+        TensorDesc outputDesc = this->outputTensors[0].get_desc();
+        if (inputDesc.nDims < 3 || outputDesc.nDims < 3) {
+            return 0;
+        }
+        double ic = inputDesc.dims[inputDesc.nDims - 2];
+        double outputNum = tensorNumElements(outputDesc);
+        double kernel = UNI_MAX(this->p.kernel_t, 1) * this->p.kernel_h * this->p.kernel_w;
+        double flops = 0;
+        switch (this->p.convolution_type) {
+            case Convolution_Depthwise: {
+                flops = 2 * outputNum * kernel;
+                break;
+            }
+            case Convolution_Depthwise_Pointwise: {
+                double oc = outputDesc.dims[outputDesc.nDims - 2];
+                flops = 2 * outputNum / oc * ic * kernel + 2 * outputNum * ic;
+                break;
+            }
+            default: {
+                flops = 2 * outputNum * ic / UNI_MAX(this->p.group, 1) * kernel;
+                break;
+            }
+        }
+        return flops;
+    }
+
+    std::string get_algorithm() override
+    {
+        if (this->p.convolution_type == Convolution_Depthwise ||
+            this->p.convolution_type == Convolution_Depthwise_Pointwise) {
+            return DepthwiseConvolutionForwardAlgorithmName()[this->dwAlg];
+        }
+        return ConvolutionForwardAlgorithmName()[this->pwAlg];
+    }
+
 public:
     ConvolutionParamSpec p;
     ActivationParamSpec dwActivationParamSpec;
@@ -62,6 +100,10 @@ public:
 #ifdef _USE_FP16
     std::shared_ptr<F16> scales;
 #endif
+#ifdef _USE_INT8
+    // input, output and filter scales of the FP32 based int8 convolution
+    std::shared_ptr<F32> scalesF32;
+#endif
 };
 
 #endif  // _CONVOLUTION_H
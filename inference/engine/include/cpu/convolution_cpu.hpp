@@ -44,7 +44,7 @@ public:
         if (modelPtr != nullptr) {
             filterDt = this->dt;
         }
-        DataType dtNoQ = (this->dt == DT_F16_8Q) ? DT_F16 : this->dt;
+        DataType dtNoQ = noQuantDataType(this->dt);
         U32 isBNN = 0;
         if (filterDt == DT_BIN01 || filterDt == DT_BIN11) {
             isBNN = 1;
@@ -68,8 +68,8 @@ public:
             }
             this->biasTensors[i].resize(desc);
         }
-        std::shared_ptr<U8> weight_ptr(curOpWs.weight);
-        std::shared_ptr<U8> bias_ptr(curOpWs.vec);
+        std::shared_ptr<U8> weight_ptr = this->get_weightspec_shared_ptr(curOpWs.weight);
+        std::shared_ptr<U8> bias_ptr = this->get_weightspec_shared_ptr(curOpWs.vec);
         U32 weight_offset = 0;
         U32 bias_offset = 0;
         for (U32 j = 0; j < this->weightTensors.size(); j++) {
@@ -125,11 +125,23 @@ public:
         U8 *scalePtr = nullptr;
         Tensor biasTensor = this->biasTensors[0];
         Tensor outputTensor = this->outputTensors[0];
+        Tensor tmpTensor = this->temp;
+        Tensor *residualTensor = nullptr;
+        ActivationParamSpec activationDesc = this->pwActivationParamSpec;
+        bool residualEltwise = this->has_residual_eltwise();
+        if (residualEltwise) {
+            U32 offset = this->get_result_bytes();
+            outputTensor = this->get_tmp_tensor(0, this->resultDesc);
+            tmpTensor = this->get_tmp_tensor(offset, tensor1d(DT_U8, this->temp.bytes() - offset));
+            activationDesc.mode = ACTIVATION_NULL;
+        } else if (this->inputTensors.size() > 1) {
+            residualTensor = &this->inputTensors[1];
+        }
 
         switch (this->p.convolution_type) {
             case Convolution_Pointwise: {
                 if (DT_F16_8Q == this->dt) {
-#ifdef _USE_INT8
+#if defined(_USE_INT8) && defined(_USE_FP16)
                     F16 *ptr = this->scales.get();
                     scalePtr = (U8 *)ptr;
                     auto inputDesc = inputTensor.get_desc();
@@ -148,10 +160,22 @@ public:
                     }
 #endif
                 }
-                CHECK_STATUS(
-                    convolution(inputTensor, filterTensor, p, this->pwAlg, scalePtr, biasTensor,
-                        this->temp, outputTensor, this->pwActivationParamSpec, &this->archInfo));
 #ifdef _USE_INT8
+                if (DT_F32_8Q == this->dt) {
+                    // the input is quantized in the convolution and the output stays in FP32
+                    F32 *ptr = this->scalesF32.get();
+                    scalePtr = (U8 *)ptr;
+                    ptr[0] = -1;
+                    if (featureScale.size() > 0 && featureScale[0][0] > 0) {
+                        ptr[0] = featureScale[0][0];
+                    }
+                    ptr[1] = -1;
+                }
+#endif
+                CHECK_STATUS(convolution_with_epilogue(inputTensor, filterTensor, p, this->pwAlg,
+                    scalePtr, biasTensor, tmpTensor, outputTensor, residualTensor, activationDesc,
+                    &this->archInfo));
+#if defined(_USE_INT8) && defined(_USE_FP16)
                 auto outputDesc = outputTensor.get_desc();
                 if (DT_I8 == outputDesc.dt) {
                     F16 *ptr = (F16 *)scalePtr;
@@ -174,22 +198,50 @@ public:
                 break;
             }
             case Convolution_Dilation: {
-                CHECK_STATUS(
-                    convolution(inputTensor, filterTensor, p, this->pwAlg, scalePtr, biasTensor,
-                        this->temp, outputTensor, this->pwActivationParamSpec, &this->archInfo));
+                CHECK_STATUS(convolution_with_epilogue(inputTensor, filterTensor, p, this->pwAlg,
+                    scalePtr, biasTensor, tmpTensor, outputTensor, residualTensor, activationDesc,
+                    &this->archInfo));
                 break;
             }
             default: {
                 UNI_ERROR_LOG("unsupported convolution type %d\n", this->p.convolution_type);
             }
         }
+        if (residualEltwise) {
+            CHECK_STATUS(
+                this->residual_eltwise(outputTensor, tmpTensor, this->pwActivationParamSpec));
+        }
+    }
+
+    // the residual that is the second input is added to the output blocks by the kernels when
+    // it has the layout of the output, otherwise by an eltwise on the result in the tmp buffer
+    bool has_residual_eltwise()
+    {
+        return this->inputTensors.size() > 1 &&
+            (isQuantMixDataType(this->dt) || !this->is_fusible_residual(this->resultDesc));
+    }
+
+    U32 get_result_bytes()
+    {
+        return (tensorNumBytes(this->resultDesc) + 63) / 64 * 64;
+    }
+
+    // the tensor that the convolution writes
+    Tensor get_result_tensor()
+    {
+        Tensor tensor = this->outputTensors[0];
+        if (this->inputTensors.size() > 1) {
+            tensor = Tensor();
+            tensor.resize(this->resultDesc);
+        }
+        return tensor;
     }
 
     EE infer_forward_algorithm(std::shared_ptr<AlgorithmMap> algorithmMap) override
     {
         auto inputTensor = this->inputTensors[0];
         auto filterTensor = this->weightTensors[0];
-        auto outputTensor = this->outputTensors[0];
+        auto outputTensor = this->get_result_tensor();
         TensorDesc inputDesc = this->desc_process(inputTensor.get_desc());
         inputTensor.resize(inputDesc);
         TensorDesc filterDesc = filterTensor.get_desc();
@@ -199,7 +251,7 @@ public:
         I32 algo;
         switch (this->p.convolution_type) {
             case Convolution_Pointwise: {
-                if (this->dt == DT_F16_8Q) {
+                if (isQuantMixDataType(this->dt)) {
                     targetType = DT_I8;
                 }
                 if (algorithmMap->getAlgorithmInfoFromMap(this->name, &algo, 1)) {
@@ -209,6 +261,9 @@ public:
                                filterDesc.dims[3], filterDesc.dims[1], filterDesc.dims[0],
                                this->p.stride_h, this->p.stride_w, &algo, 1)) {
                     this->pwAlg = (ConvolutionForwardAlgorithm)algo;
+                } else if (algorithmMap->needTuning()) {
+                    this->tune_forward_algorithm(
+                        algorithmMap, inputTensor, filterTensor, outputTensor, targetType);
                 } else {
                     CHECK_STATUS(convolution_infer_forward_algorithm(inputTensor, filterTensor,
                         outputTensor, p, policy, &(this->pwAlg), targetType,
@@ -216,6 +271,9 @@ public:
                     algo = this->pwAlg;
                     algorithmMap->setAlgorithmInfoToMap(this->name, &algo, 1);
                 }
+                if (DT_F32_8Q == this->dt && CONVOLUTION_ALGORITHM_GEMM != this->pwAlg) {
+                    this->dt = DT_F32;
+                }
                 break;
             }
             case Convolution_Depthwise: {
@@ -246,6 +304,9 @@ public:
             case Convolution_Dilation: {
                 if (algorithmMap->getAlgorithmInfoFromMap(this->name, &algo, 1)) {
                     this->pwAlg = (ConvolutionForwardAlgorithm)algo;
+                } else if (algorithmMap->needTuning()) {
+                    this->tune_forward_algorithm(
+                        algorithmMap, inputTensor, filterTensor, outputTensor, targetType);
                 } else {
                     CHECK_STATUS(convolution_infer_forward_algorithm(inputTensor, filterTensor,
                         outputTensor, p, policy, &(this->pwAlg), targetType,
@@ -261,6 +322,21 @@ public:
         return SUCCESS;
     }
 
+    // time the algorithms on this machine, the choice is saved with its latency
+    void tune_forward_algorithm(std::shared_ptr<AlgorithmMap> algorithmMap,
+        Tensor inputTensor,
+        Tensor filterTensor,
+        Tensor outputTensor,
+        DataType targetType)
+    {
+        F32 time = 0;
+        CHECK_STATUS(convolution_tune_forward_algorithm(inputTensor, filterTensor, outputTensor,
+            this->p, &(this->pwAlg), &time, targetType, this->pwActivationParamSpec,
+            &this->archInfo));
+        I32 algoInfo[2] = {this->pwAlg, (I32)(time * 1000)};
+        algorithmMap->setAlgorithmInfoToMap(this->name, algoInfo, (time > 0) ? 2 : 1);
+    }
+
     EE infer_output_tensors_size(
         std::vector<Tensor *> inTensors, std::vector<Tensor *> outTensors) override
     {
@@ -283,10 +359,20 @@ public:
         if (DF_NCHW == idf && DT_F16_8Q == this->dt && DT_F16 == idt) {
             this->dt = DT_F16;
         }
+        // only the dense convolution of NCHWC8 data is quantized on x86, see
+        // convolution_infer_forward_algorithm_x86
+        if (DT_F32_8Q == this->dt &&
+            (!tensorIs4d(inDim) || DF_NCHWC8 != idf || ic % 8 != 0 || 1 != this->p.group ||
+                Convolution_Pointwise != this->p.convolution_type)) {
+            this->dt = DT_F32;
+        }
         DataType targetType = this->dt;
         if (DT_F16_8Q == this->dt && Convolution_Pointwise == this->p.convolution_type) {
             targetType = DT_I8;
         }
+        if (DT_F32_8Q == this->dt) {
+            targetType = DT_F32;
+        }
         int numChannels = ic;
         if (this->p.convolution_type == Convolution_Dilation ||
             this->p.convolution_type == Convolution_Pointwise) {
@@ -352,6 +438,11 @@ public:
             outputDesc.dt = DT_F16;
             outputTensor->resize(outputDesc);
         }
+        this->resultDesc = outputTensor->get_desc();
+        if (inTensors.size() > 1) {
+            CHECK_STATUS(
+                this->infer_residual_output_size(this->resultDesc, inTensors[1], outputTensor));
+        }
         if (this->weightTensors.size() == 0) {
             this->weightTensors = filterTensor;
         }
@@ -371,11 +462,11 @@ public:
         inputTensor.resize(inDim);
         auto filterTensor = this->weightTensors[0];
         TensorDesc filterDesc = filterTensor.get_desc();
-        if (DT_F16_8Q == filterDesc.dt) {
+        if (DT_F16_8Q == filterDesc.dt || DT_F32_8Q == this->dt) {
             filterDesc.dt = DT_I8;
             filterTensor.resize(filterDesc);
         }
-        auto outputTensor = this->outputTensors[0];
+        auto outputTensor = this->get_result_tensor();
 
         U32 bytes = 0;
         switch (this->p.convolution_type) {
@@ -403,6 +494,10 @@ public:
             default:
                 CHECK_STATUS(NOT_SUPPORTED);
         }
+        if (this->has_residual_eltwise()) {
+            bytes = this->get_result_bytes() +
+                UNI_MAX(bytes, this->infer_residual_eltwise_tmp_bytes(this->resultDesc));
+        }
         return bytes;
     }
 
@@ -445,7 +540,7 @@ public:
         TensorDesc wtmDesc;
         if (DT_F16_8Q == this->dt && Convolution_Pointwise == this->p.convolution_type &&
             CONVOLUTION_ALGORITHM_WINOGRAD == this->pwAlg) {  // int8 winograd
-#ifdef _USE_INT8
+#if defined(_USE_INT8) && defined(_USE_FP16)
             U32 ftBytes;
             CHECK_STATUS(convolution_transform_filter_bytes(
                 filterTensor, this->p, this->pwAlg, &ftBytes, &this->archInfo));
@@ -473,19 +568,34 @@ public:
                 ((CpuMemory *)(tFilter.get_memory()))->get_ptr(), &wtmDesc,
                 ((CpuMemory *)(wtm->get_memory()))->get_ptr(), this->scales.get() + 2));
             wtm->resize(wtmDesc);
-        } else if (DT_F16_8Q == this->dt &&
+#endif
+        } else if (isQuantMixDataType(this->dt) &&
             Convolution_Pointwise == this->p.convolution_type) {  // int8 tilegemm
+#ifdef _USE_INT8
             Tensor qFilterTensor;
             TensorDesc qDesc = filterTensor.get_desc();
             qDesc.dt = DT_I8;
             qFilterTensor.resize(qDesc);
             qFilterTensor.alloc();
-            std::shared_ptr<F16> fsp((F16 *)operator new(3 * bytesOf(DT_F16)));
-            this->scales = fsp;
-            this->scales.get()[2] = -1;
+            // the filter scale has the data type of the filter
+            void *filterScale = nullptr;
+#ifdef _USE_FP16
+            if (DT_F16_8Q == this->dt) {
+                std::shared_ptr<F16> fsp((F16 *)operator new(3 * bytesOf(DT_F16)));
+                this->scales = fsp;
+                this->scales.get()[2] = -1;
+                filterScale = this->scales.get() + 2;
+            }
+#endif
+            if (DT_F32_8Q == this->dt) {
+                std::shared_ptr<F32> fsp((F32 *)operator new(3 * bytesOf(DT_F32)));
+                this->scalesF32 = fsp;
+                this->scalesF32.get()[2] = -1;
+                filterScale = this->scalesF32.get() + 2;
+            }
             CHECK_STATUS(quantize_tensor(filterTensor.get_desc(),
                 ((CpuMemory *)(filterTensor.get_memory()))->get_ptr(), &qDesc,
-                ((CpuMemory *)(qFilterTensor.get_memory()))->get_ptr(), this->scales.get() + 2));
+                ((CpuMemory *)(qFilterTensor.get_memory()))->get_ptr(), filterScale));
 
             U32 ftmBytes;
             qFilterTensor.resize(qDesc);
@@ -538,6 +648,9 @@ public:
         this->weightTensors[0] = *this->get_wtm();
         return SUCCESS;
     }
+
+    // the output of the convolution before the residual is added
+    TensorDesc resultDesc;
 };
 
 #endif  // _CONVELTWISEPOOLING_H
@@ -37,7 +37,7 @@ public:
         if (curOpWs.weight == nullptr) {
             filterDt = this->dt;
         }
-        DataType dtNoQ = (this->dt == DT_F16_8Q) ? DT_F16 : this->dt;
+        DataType dtNoQ = noQuantDataType(this->dt);
         CHECK_REQUIREMENT(filterDt != DT_BIN01 && filterDt != DT_BIN11);
         DataFormat filterDf = DF_NCHW;
         TensorDesc filterTensorDesc = tensor4df(filterDt, filterDf, this->numInputs,
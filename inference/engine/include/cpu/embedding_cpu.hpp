@@ -73,7 +73,7 @@ public:
             auto curOpWs = this->get_weightspec();
             if (curOpWs.weight != nullptr) {
                 ((CpuMemory *)(modelWeightTensor->get_memory()))
-                    ->set_shared_ptr(std::shared_ptr<U8>(curOpWs.weight));
+                    ->set_shared_ptr(this->get_weightspec_shared_ptr(curOpWs.weight));
                 set_ptr = true;
             }
         }
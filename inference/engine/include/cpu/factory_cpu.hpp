@@ -60,6 +60,7 @@
 #include "cpu/tfslice_cpu.hpp"
 #include "cpu/splice_cpu.hpp"
 #include "cpu/shape_cpu.hpp"
+#include "scaled_dot_product_attention.hpp"
 
 class FactoryCPU : public Factory {
 public:
@@ -362,5 +363,12 @@ public:
         auto cep = new ShapeCPU();
         return std::shared_ptr<Operator>(cep);
     }
+
+    std::shared_ptr<Operator> createScaledDotProductAttention(
+        DataType dt, ScaledDotProductAttentionParamSpec p) override
+    {
+        auto cep = new ScaledDotProductAttention(dt, p);
+        return std::shared_ptr<Operator>(cep);
+    }
 };
 #endif  // _FACTORY_CPU_H
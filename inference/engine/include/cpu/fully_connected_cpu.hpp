@@ -33,7 +33,7 @@ public:
 
     EE infer_weight_desc() override
     {
-        DataType dtNoQ = (DT_F16_8Q == this->dt) ? DT_F16 : this->dt;
+        DataType dtNoQ = noQuantDataType(this->dt);
         this->weightTensors = std::vector<Tensor>(1);
         this->weightTensors[0].resize(
             tensor2df(dtNoQ, DF_TRANSPOSE, this->p.num_outputs, this->numInput));
@@ -105,6 +105,18 @@ public:
         inputTensor.resize(inputDesc);
 
         Tensor outputTensor = this->outputTensors[0];
+        Tensor tmpTensor = this->temp;
+        Tensor *residualTensor = nullptr;
+        ActivationParamSpec activationDesc = this->activationDesc;
+        bool residualEltwise = this->has_residual_eltwise();
+        if (residualEltwise) {
+            U32 offset = this->get_result_bytes();
+            outputTensor = this->get_tmp_tensor(0, this->resultDesc);
+            tmpTensor = this->get_tmp_tensor(offset, tensor1d(DT_U8, this->temp.bytes() - offset));
+            activationDesc.mode = ACTIVATION_NULL;
+        } else if (this->inputTensors.size() > 1) {
+            residualTensor = &this->inputTensors[1];
+        }
         TensorDesc outputDesc = outputTensor.get_desc();
         outputDesc.dims[0] = this->p.num_outputs;
         outputDesc = desc_process(outputDesc);
@@ -114,8 +126,24 @@ public:
             inputTensor.set_scale(featureScale[0][0]);
         }
 
-        CHECK_STATUS(fully_connected(inputTensor, weightTensors[0], biasTensors[0], this->temp,
-            outputTensor, &this->archInfo));
+        CHECK_STATUS(fully_connected_with_epilogue(inputTensor, weightTensors[0], biasTensors[0],
+            tmpTensor, outputTensor, residualTensor, activationDesc, &this->archInfo));
+        if (residualEltwise) {
+            outputTensor.resize(this->resultDesc);
+            CHECK_STATUS(this->residual_eltwise(outputTensor, tmpTensor, this->activationDesc));
+        }
+    }
+
+    // the residual that is the second input is added to the output blocks by the matrix
+    // multiplication when it has the layout of the output, otherwise by an eltwise
+    bool has_residual_eltwise()
+    {
+        return this->inputTensors.size() > 1 && !this->is_fusible_residual(this->resultDesc);
+    }
+
+    U32 get_result_bytes()
+    {
+        return (tensorNumBytes(this->resultDesc) + 63) / 64 * 64;
     }
 
     EE infer_output_tensors_size(
@@ -158,6 +186,11 @@ public:
                 }
             }
             outTensors[0]->resize(outputDesc);
+            this->resultDesc = outputDesc;
+            if (inTensors.size() > 1) {
+                CHECK_STATUS(
+                    this->infer_residual_output_size(outputDesc, inTensors[1], outTensors[0]));
+            }
         } else {
             UNI_ERROR_LOG("FC merge is deprecated\n");
             outputDesc = desc_process_reverse(inTensors[0]->get_desc(), outputDesc);
@@ -185,6 +218,10 @@ public:
 
         CHECK_STATUS(fully_connected_infer_forward_tmp_bytes(
             tmpInput, weightTensors[0], &bytes, &this->archInfo));
+        if (this->has_residual_eltwise()) {
+            bytes = this->get_result_bytes() +
+                UNI_MAX(bytes, this->infer_residual_eltwise_tmp_bytes(this->resultDesc));
+        }
         return bytes;
     }
 
@@ -224,17 +261,32 @@ public:
         }
 
 #ifdef _USE_INT8
-        if (DT_F16_8Q == this->dt) {
+        if (isQuantMixDataType(this->dt)) {
+            tmpDesc = tmpFilter.get_desc();
             std::shared_ptr<U8> qFilter = std::shared_ptr<U8>(
                 (U8 *)operator new(bytesOf(DT_I8) * tensorNumElements(tmpDesc)));
 
-            F16 scale = -1;
-            F16 *inD = (F16 *)((CpuMemory *)(tmpFilter.get_memory()))->get_ptr();
-            CHECK_STATUS(
-                quantize_tensor(tmpFilter.get_desc(), inD, &tmpDesc, qFilter.get(), &scale));
+            // the scale has the data type of the weight
+            F32 scale = -1;
+            void *inD = ((CpuMemory *)(tmpFilter.get_memory()))->get_ptr();
+#ifdef _USE_FP16
+            if (DT_F16_8Q == this->dt) {
+                F16 scaleF16 = -1;
+                CHECK_STATUS(quantize_tensor(tmpDesc, inD, &tmpDesc, qFilter.get(), &scaleF16));
+                scale = scaleF16;
+            }
+#endif
+            if (DT_F32_8Q == this->dt) {
+                CHECK_STATUS(quantize_tensor(tmpDesc, inD, &tmpDesc, qFilter.get(), &scale));
+            }
             tmpFilter.resize(tmpDesc);
             ((CpuMemory *)(tmpFilter.get_memory()))->set_shared_ptr(qFilter);
             tmpFilter.set_scale(scale);
+            // the packed int8 weight may be padded beyond the size of the float weight
+            U32 bytes = 0;
+            CHECK_STATUS(
+                fully_connected_transform_filter_bytes(tmpFilter, &bytes, &this->archInfo));
+            wtm_bytes = UNI_MAX(wtm_bytes, bytes);
         }
 #endif
         this->wtm = std::shared_ptr<Tensor>(new Tensor());
@@ -242,7 +294,7 @@ public:
         wtm->alloc();
         wtm->set_scale(tmpFilter.get_scale());
         if (this->mvm) {
-            if (X86_AVX2 != this->archInfo.arch) {
+            if (!IS_X86(this->archInfo.arch) || DT_I8 == tmpFilter.get_desc().dt) {
                 CHECK_STATUS(matrix_vector_multiply_transform_weight(tmpFilter.get_desc(),
                     ((CpuMemory *)(tmpFilter.get_memory()))->get_ptr(), &wtmDesc,
                     ((CpuMemory *)(wtm->get_memory()))->get_ptr(), this->archInfo.arch));
@@ -261,6 +313,8 @@ public:
     }
 
     bool mvm;
+    // the output of the fully connected layer before the residual is added
+    TensorDesc resultDesc;
 };
 
 #endif  // _FULLY_CONNECTED_CPU_H
@@ -32,7 +32,7 @@ public:
     EE infer_weight_desc() override
     {
         auto curOpWs = this->get_weightspec();
-        DataType dtNoQ = (DT_F16_8Q == this->dt) ? DT_F16 : this->dt;
+        DataType dtNoQ = noQuantDataType(this->dt);
         if (0 != curOpWs.bytes_of_weight) {
             this->weightNum = curOpWs.bytes_of_weight / bytesOf(curOpWs.mdt);
         }
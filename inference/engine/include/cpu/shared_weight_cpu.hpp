@@ -62,7 +62,7 @@ public:
         } else {
             auto curOpWs = this->get_weightspec();
             ((CpuMemory *)(modelWeightTensor.get_memory()))
-                ->set_shared_ptr(std::shared_ptr<U8>(curOpWs.weight));
+                ->set_shared_ptr(this->get_weightspec_shared_ptr(curOpWs.weight));
         }
         this->weightTensors.push_back(modelWeightTensor);
         (*this->tensorMapPtr)[this->outputTensorName]->reuse(&(this->weightTensors[0]));
@@ -32,6 +32,18 @@ public:
         return OT_Deconvolution;
     }
 
+    double get_flops() override
+    {
+        double kernel = UNI_MAX(this->p.kernel_t, 1) * this->p.kernel_h * this->p.kernel_w;
+        return 2.0 * tensorNumElements(this->inputTensors[0].get_desc()) * this->p.num_outputs /
+            UNI_MAX(this->p.group, 1) * kernel;
+    }
+
+    std::string get_algorithm() override
+    {
+        return ConvolutionForwardAlgorithmName()[this->alg];
+    }
+
 public:
     U32 numInputs;
 
@@ -174,6 +174,9 @@ public:
 
     virtual std::shared_ptr<Operator> createShape() = 0;
 
+    virtual std::shared_ptr<Operator> createScaledDotProductAttention(
+        DataType dt, ScaledDotProductAttentionParamSpec p) = 0;
+
     std::shared_ptr<Operator> createOperators(OperatorSpec curOps,
         DataType dt,
         std::map<std::string, U32> operatorIndexMap,
@@ -183,7 +186,7 @@ public:
         std::set<std::string> *weightOpOutputNames)
     {
         OperatorType opType = curOps.type;
-        DataType dtNoQ = (dt == DT_F16_8Q) ? DT_F16 : dt;
+        DataType dtNoQ = noQuantDataType(dt);
         std::string opName = curOps.name;
         std::shared_ptr<Operator> op;
         auto curPs = curOps.ps;
@@ -453,6 +456,10 @@ public:
                 op = createShape();
                 break;
             }
+            case OT_ScaledDotProductAttention: {
+                op = createScaledDotProductAttention(dt, curPs.scaled_dot_product_attention_spec);
+                break;
+            }
             default: {
                 UNI_ERROR_LOG("unsupported layer %s\n", OperatorTypeName()[opType]);
                 break;
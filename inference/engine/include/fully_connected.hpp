@@ -24,6 +24,8 @@ public:
         this->p = p;
         this->numInput = numInput;
         this->hasBias = false;
+        this->activationDesc.mode = ACTIVATION_NULL;
+        this->activationDesc.value[0] = 0;
     }
 
     OperatorType get_type() override
@@ -31,10 +33,18 @@ public:
         return OT_FC;
     }
 
+    double get_flops() override
+    {
+        return 2.0 * tensorNumElements(this->inputTensors[0].get_desc()) * this->p.num_outputs;
+    }
+
 public:
     U32 numInput;
 
     FullyConnectedParamSpec p;
+    // the activation that is fused into the operator by the graph optimizer, which is applied
+    // after the residual of the second input is added
+    ActivationParamSpec activationDesc;
 };
 
 #endif  // _FULLY_CONNECTED_H
@@ -64,7 +64,7 @@ inline std::shared_ptr<CNN> createPipeline(
 {
     // deserialize model from file
     ModelSpec ms;
-    CHECK_STATUS(deserialize_model_from_file(modelPath, &ms));
+    CHECK_STATUS(deserialize_model_from_file(modelPath, &ms, false, true));
 
     std::shared_ptr<CNN> pipeline = createPipelinefromMs(affinityPolicyName, &ms, algorithmMapPath);
 
@@ -29,6 +29,16 @@ public:
         return OT_MatMul;
     }
 
+    double get_flops() override
+    {
+        TensorDesc aDesc = this->inputTensors[0].get_desc();
+        if (aDesc.nDims == 0) {
+            return 0;
+        }
+        U32 k = (this->p.transpose_a && aDesc.nDims > 1) ? aDesc.dims[1] : aDesc.dims[0];
+        return 2.0 * tensorNumElements(this->outputTensors[0].get_desc()) * k;
+    }
+
 protected:
     MatMulParamSpec p;
 };
@@ -14,8 +14,14 @@
 #ifndef _MEMORY_TRACKER_H
 #define _MEMORY_TRACKER_H
 
+#include <algorithm>
+#include <climits>
+#include <map>
+#include <set>
 #include "tensor_desc.h"
 
+#define ARENA_ALIGNMENT 64
+
 class MemoryTracker {
 public:
     MemoryTracker()
@@ -23,43 +29,182 @@ public:
         this->storageSize.clear();
         this->tensorStoragePosition.clear();
         this->memoryNeedAssign = true;
+        this->lastOpIndex = -1;
+        this->arenaSize = 0;
+        this->arenaPlanned = false;
     }
 
-    void trackOpTensorSizes(std::shared_ptr<Operator> op, std::vector<std::string> tensorNames)
+    void trackOpTensorSizes(Operator *op, const std::vector<std::string> &tensorNames, I32 opIndex)
     {
         I32 *pos = op->get_tensor_positions().data();
-        auto inputTensors = op->get_input_tensors();
-        auto outputTensors = op->get_output_tensors();
+        std::vector<Tensor> &inputTensors = op->get_input_tensors();
+        std::vector<Tensor> &outputTensors = op->get_output_tensors();
         size_t numInput = inputTensors.size();
         size_t numOutput = outputTensors.size();
         for (size_t i = 0; i < numInput; i++) {
             U32 size = inputTensors[i].bytes();
             I32 slot = pos[i];
             this->tensorStoragePosition[tensorNames[i]] = slot;
+            // the tensor may also use memory given by user, see CNN::set_input_tensors_value
+            if (size > inputTensors[i].capacity()) {
+                this->memoryNeedAssign = true;
+            }
             if (-1 == slot) {
-                if (!memoryNeedAssign) {
-                    if (size > inputTensors[i].capacity()) {
-                        this->memoryNeedAssign = true;
-                    }
-                }
                 continue;
             }
             this->trackSlotSize(slot, size);
+            this->trackTensorLife(tensorNames[i], size, this->getOpStep(opIndex), true);
         }
         for (size_t i = 0; i < numOutput; i++) {
             U32 size = outputTensors[i].bytes();
             I32 slot = pos[numInput + i];
             this->tensorStoragePosition[tensorNames[numInput + i]] = slot;
+            // the tensor may also use memory given by user, see CNN::set_input_tensors_value
+            if (size > outputTensors[i].capacity()) {
+                this->memoryNeedAssign = true;
+            }
             if (-1 == slot) {
-                if (!memoryNeedAssign) {
-                    if (size > outputTensors[i].capacity()) {
-                        this->memoryNeedAssign = true;
-                    }
-                }
                 continue;
             }
             this->trackSlotSize(slot, size);
+            this->trackTensorLife(
+                tensorNames[numInput + i], size, this->getOpStep(opIndex), false);
+        }
+        this->lastOpIndex = UNI_MAX(this->lastOpIndex, this->getOpStep(opIndex));
+    }
+
+    // the step at which each operator runs, operators of the same step run at the same time and
+    // their tensors and tmp buffers must not overlap. It is the operator index by default.
+    void setOpSteps(std::vector<I32> steps)
+    {
+        this->opSteps = steps;
+        this->tensorLife.clear();
+        this->tensorReadFirst.clear();
+        this->lastOpIndex = -1;
+        this->memoryNeedAssign = true;
+    }
+
+    // operators between start and end (Repeat/Jump target and itself) may run several times
+    void trackLoop(I32 start, I32 end)
+    {
+        this->loops.insert(std::make_pair(UNI_MIN(start, end), UNI_MAX(start, end)));
+    }
+
+    // model outputs are read after the last operator
+    void trackModelOutput(std::string name)
+    {
+        this->modelOutputs.insert(name);
+    }
+
+    void trackOpTmpSize(I32 opIndex, U32 size)
+    {
+        if (opIndex >= (I32)this->tmpSize.size()) {
+            this->tmpSize.resize(opIndex + 1, 0);
+        }
+        this->tmpSize[opIndex] = size;
+        if (this->arenaPlanned && size > this->getTmpArena(opIndex).second) {
+            this->memoryNeedAssign = true;
+        }
+    }
+
+    // place all tensors that share memory and all operator tmp buffers in one arena, tensors
+    // whose lifetimes overlap get disjoint byte ranges. Blocks are placed from the biggest to
+    // the smallest, each into the smallest free range that fits (greedy by size, best fit).
+    U32 planArena()
+    {
+        std::vector<ArenaBlock> blocks;
+        for (auto &iter : this->tensorLife) {
+            ArenaBlock block;
+            block.name = iter.first;
+            block.opIndex = -1;
+            block.size = this->tensorSize[iter.first];
+            block.life = this->getPlannedLife(iter.first);
+            blocks.push_back(block);
+        }
+        for (U32 i = 0; i < this->tmpSize.size(); i++) {
+            ArenaBlock block;
+            block.opIndex = i;
+            block.size = this->tmpSize[i];
+            block.life = std::make_pair(this->getOpStep(i), this->getOpStep(i));
+            blocks.push_back(block);
+        }
+        std::stable_sort(
+            blocks.begin(), blocks.end(), [](const ArenaBlock &a, const ArenaBlock &b) {
+                return a.size > b.size || (a.size == b.size && a.life.first < b.life.first);
+            });
+
+        this->arenaSize = 0;
+        std::vector<ArenaBlock *> placed;
+        for (auto &block : blocks) {
+            std::vector<ArenaBlock *> alive;
+            for (auto p : placed) {
+                if (p->life.first <= block.life.second && block.life.first <= p->life.second) {
+                    alive.push_back(p);
+                }
+            }
+            std::sort(alive.begin(), alive.end(),
+                [](const ArenaBlock *a, const ArenaBlock *b) { return a->offset < b->offset; });
+            U32 size = align_size(block.size);
+            U32 end = 0;
+            U32 bestOffset = 0;
+            U32 bestGap = UINT_MAX;
+            for (auto p : alive) {
+                if (p->offset >= end && p->offset - end >= size && p->offset - end < bestGap) {
+                    bestOffset = end;
+                    bestGap = p->offset - end;
+                }
+                end = UNI_MAX(end, p->offset + align_size(p->size));
+            }
+            block.offset = (bestGap == UINT_MAX) ? end : bestOffset;
+            this->arenaSize = UNI_MAX(this->arenaSize, block.offset + size);
+            placed.push_back(&block);
+        }
+
+        this->tensorArena.clear();
+        this->tmpArena.assign(this->tmpSize.size(), std::make_pair(0, 0));
+        for (auto &block : blocks) {
+            if (block.opIndex < 0) {
+                this->tensorArena[block.name] = std::make_pair(block.offset, block.size);
+            } else {
+                this->tmpArena[block.opIndex] = std::make_pair(block.offset, block.size);
+            }
+        }
+        this->arenaPlanned = true;
+        return this->arenaSize;
+    }
+
+    // offset and size of the tensor in the arena
+    std::pair<U32, U32> getTensorArena(std::string name)
+    {
+        std::pair<U32, U32> ret(0, 0);
+        if (this->tensorArena.find(name) != this->tensorArena.end()) {
+            ret = this->tensorArena[name];
+        }
+        return ret;
+    }
+
+    // offset and size of the operator tmp buffer in the arena
+    std::pair<U32, U32> getTmpArena(I32 opIndex)
+    {
+        std::pair<U32, U32> ret(0, 0);
+        if (opIndex < (I32)this->tmpArena.size()) {
+            ret = this->tmpArena[opIndex];
         }
+        return ret;
+    }
+
+    U32 getArenaSize()
+    {
+        return this->arenaSize;
+    }
+
+    U32 getTmpSizeMax()
+    {
+        U32 ret = 0;
+        for (U32 size : this->tmpSize) {
+            ret = UNI_MAX(ret, size);
+        }
+        return ret;
     }
 
     I32 getSlotByTensorName(std::string name)
@@ -108,8 +253,85 @@ protected:
         }
     }
 
+    void trackTensorLife(std::string name, U32 size, I32 opIndex, bool isInput)
+    {
+        if (this->tensorLife.find(name) == this->tensorLife.end()) {
+            this->tensorLife[name] = std::make_pair(opIndex, opIndex);
+            this->tensorReadFirst[name] = isInput;
+        } else {
+            auto &life = this->tensorLife[name];
+            life.first = UNI_MIN(life.first, opIndex);
+            life.second = UNI_MAX(life.second, opIndex);
+        }
+        this->tensorSize[name] = size;
+        if (this->arenaPlanned && size > this->getTensorArena(name).second) {
+            this->memoryNeedAssign = true;
+        }
+    }
+
+    std::pair<I32, I32> getPlannedLife(std::string name)
+    {
+        std::pair<I32, I32> life = this->tensorLife[name];
+        // model inputs and values carried over loop iterations are read before being written
+        if (this->tensorReadFirst[name]) {
+            life.first = 0;
+        }
+        if (this->modelOutputs.find(name) != this->modelOutputs.end()) {
+            life.second = this->lastOpIndex;
+        }
+        // a tensor that crosses a loop boundary must survive all iterations of the loop,
+        // a tensor that lives within one iteration can be reused in the loop
+        bool changed = true;
+        while (changed) {
+            changed = false;
+            for (auto loop : this->loops) {
+                if (life.first <= loop.second && loop.first <= life.second &&
+                    (life.first < loop.first || life.second > loop.second)) {
+                    if (life.first > loop.first || life.second < loop.second) {
+                        life.first = UNI_MIN(life.first, loop.first);
+                        life.second = UNI_MAX(life.second, loop.second);
+                        changed = true;
+                    }
+                }
+            }
+        }
+        return life;
+    }
+
+    I32 getOpStep(I32 opIndex)
+    {
+        return (opIndex < (I32)this->opSteps.size()) ? this->opSteps[opIndex] : opIndex;
+    }
+
+    static U32 align_size(U32 size)
+    {
+        return (size + ARENA_ALIGNMENT - 1) / ARENA_ALIGNMENT * ARENA_ALIGNMENT;
+    }
+
+    struct ArenaBlock {
+        std::string name;
+        I32 opIndex;
+        U32 size;
+        std::pair<I32, I32> life;
+        U32 offset;
+    };
+
     std::vector<U32> storageSize;
     std::map<std::string, I32> tensorStoragePosition;
     bool memoryNeedAssign;
+
+    std::map<std::string, std::pair<I32, I32>> tensorLife;
+    std::map<std::string, bool> tensorReadFirst;
+    std::map<std::string, U32> tensorSize;
+    std::set<std::pair<I32, I32>> loops;
+    std::set<std::string> modelOutputs;
+    std::vector<U32> tmpSize;
+    std::vector<I32> opSteps;
+    I32 lastOpIndex;
+
+    std::map<std::string, std::pair<U32, U32>> tensorArena;
+    std::vector<std::pair<U32, U32>> tmpArena;
+    U32 arenaSize;
+    bool arenaPlanned;
 };
 #endif
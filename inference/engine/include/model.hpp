@@ -26,9 +26,12 @@
 class Model {
 public:
     Model()
-    {}
+    {
+        this->threadNum = get_cpu_num_threads();
+    }
     Model(AffinityPolicy affinityPolicy, DataType dt, std::string name)
     {
+        this->threadNum = get_cpu_num_threads();
         this->set_device_info(affinityPolicy);
         this->dt = dt;
         this->name = name;
@@ -80,6 +83,18 @@ public:
         return this->deviceInfo.schedule;
     }
 
+    virtual void set_num_threads(int threadNum)
+    {
+        set_cpu_num_threads(threadNum);
+        this->threadNum = get_cpu_num_threads();
+        thread_affinity_set_omp_threads(&this->deviceInfo, this->threadNum);
+    }
+
+    int get_num_threads()
+    {
+        return this->threadNum;
+    }
+
     virtual EE infer_output_tensors_size(std::map<std::string, TensorDesc>) = 0;
     virtual void assign_output_tensor() = 0;
     virtual void infer_tmp_memory_size() = 0;
@@ -184,6 +199,7 @@ public:
 protected:
     std::vector<std::shared_ptr<Operator>> ops;
     DeviceInfo deviceInfo;
+    int threadNum;
     DataType dt;
 #ifdef _USE_MALI
     std::shared_ptr<GCLHandle> handle;
@@ -46,7 +46,7 @@ public:
         TensorDesc vDesc[2];
         wDesc[0] = this->filterDesc;
         U32 filterNum = 1;
-        DataType dtNoQ = (this->dt == DT_F16_8Q) ? DT_F16 : this->dt;
+        DataType dtNoQ = noQuantDataType(this->dt);
         switch (this->p.convolution_type) {
             case Convolution_Pointwise: {
                 vDesc[0] = tensor1d(dtNoQ,
@@ -42,7 +42,7 @@ public:
         if (curOpWs.weight == nullptr) {
             dt = this->dt;
         }
-        DataType dtNoQ = (this->dt == DT_F16_8Q) ? DT_F16 : this->dt;
+        DataType dtNoQ = noQuantDataType(this->dt);
         DataFormat df = DF_NCHW;
         U32 fh, fw, fc, fn;
         fn = this->numInputs;
@@ -85,7 +85,7 @@ public:
         if (modelPtr) {
             weight_ptr = *modelPtr;
         } else {
-            weight_ptr = std::shared_ptr<U8>(curOpWs.weight);
+            weight_ptr = this->get_weightspec_shared_ptr(curOpWs.weight);
         }
         weight_mem_src.resize(weightDesc);
         weight_mem_src.set_shared_ptr(std::shared_ptr<U8>(weight_ptr));
@@ -353,5 +353,12 @@ public:
         OP_UNSUP(0);
         return std::shared_ptr<Operator>(cep);
     }
+
+    std::shared_ptr<Operator> createScaledDotProductAttention(
+        DataType dt, ScaledDotProductAttentionParamSpec p) override
+    {
+        OP_UNSUP(2, dt, p);
+        return std::shared_ptr<Operator>(cep);
+    }
 };
 #endif  // _FACTORY_OCL_H
@@ -40,7 +40,7 @@ public:
         if (0 != curOpWs.bytes_of_weight) {
             this->weightNum = curOpWs.bytes_of_weight / bytesOf(curOpWs.mdt);
         }
-        DataType dtNoQ = (DT_F16_8Q == this->dt) ? DT_F16 : this->dt;
+        DataType dtNoQ = noQuantDataType(this->dt);
         TensorDesc weightDesc = tensor1d(dtNoQ, this->weightNum);
         TensorDesc biasDesc = tensor1d(dtNoQ, this->weightNum);
         Tensor modelWeightTensor = Tensor(OCLMem);
@@ -76,7 +76,7 @@ public:
         if (modelPtr) {
             weight_ptr = *modelPtr;
         } else {
-            weight_ptr = std::shared_ptr<U8>(curOpWs.weight);
+            weight_ptr = this->get_weightspec_shared_ptr(curOpWs.weight);
         }
         U32 s0, s1, s2;
         s0 = this->desc.dims[0];
@@ -15,6 +15,7 @@
 #define _OPERATOR_H
 
 #include <string>
+#include <utility>
 #include "sys.h"
 #include "tensor.hpp"
 #include "algorithm_map.h"
@@ -70,8 +71,8 @@ public:
 
     virtual void set_input_output_tensors(std::vector<Tensor> it, std::vector<Tensor> ot)
     {
-        this->inputTensors = it;
-        this->outputTensors = ot;
+        this->inputTensors = std::move(it);
+        this->outputTensors = std::move(ot);
     }
 
     virtual void set_input_tensors(std::vector<Tensor> it)
@@ -79,7 +80,7 @@ public:
         this->inputTensors = it;
     }
 
-    virtual std::vector<Tensor> get_input_tensors()
+    virtual std::vector<Tensor> &get_input_tensors()
     {
         return this->inputTensors;
     }
@@ -89,7 +90,7 @@ public:
         this->outputTensors = ot;
     }
 
-    virtual std::vector<Tensor> get_output_tensors()
+    virtual std::vector<Tensor> &get_output_tensors()
     {
         return this->outputTensors;
     }
@@ -148,9 +149,7 @@ public:
     {
 #ifdef _USE_INT8
         if (1 == num && 0 == qs[0].scale[0]) {  // OP is labelled as no-quantization
-            if (DT_F16_8Q == this->dt) {
-                this->dt = DT_F16;
-            }
+            this->dt = noQuantDataType(this->dt);
             return;
         }
         featureScale.resize(num);
@@ -175,7 +174,8 @@ public:
         }
 
         U32 numScale = featureScale.size();
-        U32 numQuant = (DT_F16_8Q == this->dt) ? inputTensors.size() : 0;
+        // the convolutions of DT_F32_8Q models quantize their inputs and keep FP32 outputs
+        U32 numQuant = isQuantMixDataType(this->dt) ? inputTensors.size() : 0;
 
         if (0 != numScale && 0 == featureScale[0][0]) {  // OP is labelled as no-quantization
             return false;
@@ -232,6 +232,17 @@ public:
         this->algorithmMap = algorithmMap;
     }
 
+    // estimated floating point operations of run(), only for the compute intensive operators
+    virtual double get_flops()
+    {
+        return 0;
+    }
+
+    virtual std::string get_algorithm()
+    {
+        return "";
+    }
+
 protected:
     ArchInfo archInfo;
     DataType dt;
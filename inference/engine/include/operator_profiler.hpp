@@ -0,0 +1,88 @@
+// Copyright (C) 2019. Huawei Technologies Co., Ltd. All rights reserved.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef _OPERATOR_PROFILER_H
+#define _OPERATOR_PROFILER_H
+
+#include "operator.hpp"
+#include "weight_operator.hpp"
+#include "profiling.h"
+
+// copy at most length - 1 characters, the record strings are fixed size
+inline void profile_copy_string(char *dst, const std::string &src, U32 length)
+{
+    strncpy(dst, src.c_str(), length - 1);
+    dst[length - 1] = '\0';
+}
+
+inline void profile_tensor_shapes(std::vector<Tensor> &tensors, char *shapes, U32 length)
+{
+    std::string str;
+    for (U32 i = 0; i < tensors.size(); i++) {
+        TensorDesc desc = tensors[i].get_desc();
+        if (i > 0) {
+            str += ",";
+        }
+        for (int j = (int)desc.nDims - 1; j >= 0; j--) {
+            str += std::to_string(desc.dims[j]);
+            if (j > 0) {
+                str += "x";
+            }
+        }
+    }
+    profile_copy_string(shapes, str, length);
+}
+
+inline double profile_tensor_bytes(std::vector<Tensor> tensors)
+{
+    double bytes = 0;
+    for (auto &tensor : tensors) {
+        bytes += tensor.bytes();
+    }
+    return bytes;
+}
+
+// run the operator, and record it when the runtime profiler is on
+inline void run_operator(Operator *op)
+{
+    UNI_DEBUG_LOG(
+        "run() op: %s type: %s\n", op->get_name().c_str(), OperatorTypeName()[op->get_type()]);
+    if (!runtime_profile_enabled()) {
+        UNI_PROFILE(op->run(), op->get_name(),
+            std::string(OperatorTypeName()[op->get_type()]) + std::string("::run"));
+        return;
+    }
+    U32 transforms = runtime_profile_get_transforms();
+    double start = ut_time_ms();
+    op->run();
+    double end = ut_time_ms();
+
+    ProfileRecord *record = runtime_profile_new_record();
+    profile_copy_string(record->name, op->get_name(), sizeof(record->name));
+    profile_copy_string(record->type, OperatorTypeName()[op->get_type()], sizeof(record->type));
+    profile_copy_string(record->algorithm, op->get_algorithm(), sizeof(record->algorithm));
+    std::vector<Tensor> inputs = op->get_input_tensors();
+    profile_tensor_shapes(inputs, record->shapes, sizeof(record->shapes));
+    record->flops = op->get_flops();
+    record->bytes = profile_tensor_bytes(inputs) + profile_tensor_bytes(op->get_output_tensors());
+    WeightOperator *weightOp = dynamic_cast<WeightOperator *>(op);
+    if (weightOp != nullptr) {
+        record->bytes += profile_tensor_bytes(weightOp->get_weight_tensors());
+    }
+    record->start_ms = start;
+    record->duration_ms = end - start;
+    record->transforms = runtime_profile_get_transforms() - transforms;
+    runtime_profile_commit_record();
+}
+
+#endif  // _OPERATOR_PROFILER_H
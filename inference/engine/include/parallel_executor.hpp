@@ -0,0 +1,147 @@
+// Copyright (C) 2019. Huawei Technologies Co., Ltd. All rights reserved.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef _PARALLEL_EXECUTOR_H
+#define _PARALLEL_EXECUTOR_H
+
+#include <pthread.h>
+#include <vector>
+#include "operator_profiler.hpp"
+
+// A pool of threads that runs independent operators at the same time. The calling thread is
+// one of the workers, and each worker uses ompThreads threads inside an operator.
+class ParallelExecutor {
+public:
+    ParallelExecutor(U32 workerNum, int ompThreads)
+    {
+        this->ompThreads = UNI_MAX(ompThreads, 1);
+        this->next = 0;
+        this->unfinished = 0;
+        this->generation = 0;
+        this->stop = false;
+        pthread_mutex_init(&(this->lock), NULL);
+        pthread_cond_init(&(this->taskCondition), NULL);
+        pthread_cond_init(&(this->finishCondition), NULL);
+        for (U32 i = 1; i < workerNum; i++) {
+            pthread_t thread;
+            if (pthread_create(&thread, NULL, worker, reinterpret_cast<void *>(this)) != 0) {
+                UNI_WARNING_LOG("parallel executor can only create %u threads.\n", i);
+                break;
+            }
+            this->threads.push_back(thread);
+        }
+    }
+
+    ~ParallelExecutor()
+    {
+        pthread_mutex_lock(&(this->lock));
+        this->stop = true;
+        pthread_cond_broadcast(&(this->taskCondition));
+        pthread_mutex_unlock(&(this->lock));
+        for (pthread_t thread : this->threads) {
+            pthread_join(thread, NULL);
+        }
+        pthread_mutex_destroy(&(this->lock));
+        pthread_cond_destroy(&(this->taskCondition));
+        pthread_cond_destroy(&(this->finishCondition));
+    }
+
+    // run ops[indices[i]] for all i and return when all of them have finished
+    void run(const std::vector<std::shared_ptr<Operator>> &ops, const std::vector<U32> &indices)
+    {
+        // a single operator can use all threads by itself
+        if (indices.size() == 1 || this->threads.empty()) {
+            for (U32 index : indices) {
+                run_operator(ops[index].get());
+            }
+            return;
+        }
+        pthread_mutex_lock(&(this->lock));
+        this->ops = &ops;
+        this->indices = &indices;
+        this->next = 0;
+        this->unfinished = indices.size();
+        this->generation++;
+        pthread_cond_broadcast(&(this->taskCondition));
+        pthread_mutex_unlock(&(this->lock));
+
+        int threadNum = get_cpu_num_threads();
+        set_cpu_num_threads(this->ompThreads);
+        this->run_tasks();
+        set_cpu_num_threads(threadNum);
+
+        pthread_mutex_lock(&(this->lock));
+        while (this->unfinished > 0) {
+            pthread_cond_wait(&(this->finishCondition), &(this->lock));
+        }
+        pthread_mutex_unlock(&(this->lock));
+    }
+
+private:
+    static void *worker(void *arg)
+    {
+        ParallelExecutor *executor = reinterpret_cast<ParallelExecutor *>(arg);
+        set_cpu_num_threads(executor->ompThreads);
+        U32 generation = 0;
+        pthread_mutex_lock(&(executor->lock));
+        while (true) {
+            while (executor->generation == generation && !executor->stop) {
+                pthread_cond_wait(&(executor->taskCondition), &(executor->lock));
+            }
+            if (executor->stop) {
+                break;
+            }
+            generation = executor->generation;
+            pthread_mutex_unlock(&(executor->lock));
+            executor->run_tasks();
+            pthread_mutex_lock(&(executor->lock));
+        }
+        pthread_mutex_unlock(&(executor->lock));
+        return NULL;
+    }
+
+    // take the operators one by one until all of them have been taken
+    void run_tasks()
+    {
+        while (true) {
+            pthread_mutex_lock(&(this->lock));
+            if (this->next >= this->indices->size()) {
+                pthread_mutex_unlock(&(this->lock));
+                break;
+            }
+            Operator *op = (*this->ops)[(*this->indices)[this->next++]].get();
+            pthread_mutex_unlock(&(this->lock));
+
+            run_operator(op);
+
+            pthread_mutex_lock(&(this->lock));
+            if (--this->unfinished == 0) {
+                pthread_cond_broadcast(&(this->finishCondition));
+            }
+            pthread_mutex_unlock(&(this->lock));
+        }
+    }
+
+    int ompThreads;
+    std::vector<pthread_t> threads;
+    const std::vector<std::shared_ptr<Operator>> *ops;
+    const std::vector<U32> *indices;
+    U32 next;
+    U32 unfinished;
+    U32 generation;
+    bool stop;
+    pthread_mutex_t lock;
+    pthread_cond_t taskCondition;
+    pthread_cond_t finishCondition;
+};
+#endif
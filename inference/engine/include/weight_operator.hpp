@@ -30,6 +30,7 @@ public:
         this->ws.weight = nullptr;
         this->ws.bytes_of_vec = 0;
         this->ws.vec = nullptr;
+        this->wsMemoryBytes = 0;
     }
 
     bool is_weight() override
@@ -112,6 +113,15 @@ public:
         return this->ws;
     }
 
+    // set the memory of bytes that WeightSpec may point into, such as the memory mapped model
+    // file, WeightSpec's weight and vec that are in it will be released with it instead of by
+    // this operator.
+    void set_weightspec_memory(std::shared_ptr<U8> memory, U32 bytes)
+    {
+        this->wsMemory = memory;
+        this->wsMemoryBytes = bytes;
+    }
+
     virtual void set_hasBias(bool hasBiasOrNot)
     {
         this->hasBias = hasBiasOrNot;
@@ -135,8 +145,8 @@ public:
             weight_ptr = *modelPtr;
             bias_ptr = *modelPtr;
         } else {
-            weight_ptr = std::shared_ptr<U8>(curOpWs.weight);
-            bias_ptr = std::shared_ptr<U8>(curOpWs.vec);
+            weight_ptr = this->get_weightspec_shared_ptr(curOpWs.weight);
+            bias_ptr = this->get_weightspec_shared_ptr(curOpWs.vec);
         }
 
         U32 weight_offset = 0;
@@ -183,7 +193,118 @@ public:
         return SUCCESS;
     }
 
+    // a tensor of desc on the bytes of the tmp buffer that begin at offset, which is used to
+    // split the buffer between the operator and its fused epilogue
+    Tensor get_tmp_tensor(U32 offset, TensorDesc desc)
+    {
+        auto mem = (CpuMemory *)(this->temp.get_memory());
+        Tensor tensor;
+        tensor.resize(desc);
+        ((CpuMemory *)(tensor.get_memory()))
+            ->set_shared_ptr(std::shared_ptr<U8>(
+                mem->get_shared_ptr(), (U8 *)mem->get_ptr() + offset));
+        return tensor;
+    }
+
+    // whether the second input of an operator fused with the following eltwise can be added by
+    // the kernels, which requires it to have the layout of the result of the operator
+    bool is_fusible_residual(TensorDesc resultDesc)
+    {
+        TensorDesc residualDesc = this->inputTensors[1].get_desc();
+        auto isRowMajor = [](DataFormat df) {
+            return df == DF_NCHW || df == DF_NORMAL || df == DF_MTK;
+        };
+        bool ret = (resultDesc.dt == residualDesc.dt && resultDesc.nDims == residualDesc.nDims &&
+            (resultDesc.df == residualDesc.df ||
+                (isRowMajor(resultDesc.df) && isRowMajor(residualDesc.df))));
+        for (U32 i = 0; ret && i < resultDesc.nDims; i++) {
+            ret = (resultDesc.dims[i] == residualDesc.dims[i]);
+        }
+        return ret;
+    }
+
+    // the output is the activation of the sum of the result and the second input, which is done
+    // after the operator when the kernels can not add the second input
+    EE residual_eltwise(Tensor resultTensor, Tensor tmpTensor, ActivationParamSpec activationDesc)
+    {
+        EltwiseParamSpec eltwiseDesc;
+        eltwiseDesc.elt_mode = ELTWISE_SUM;
+        eltwiseDesc.elt_sum_spec.coeff_size = 0;
+        eltwiseDesc.activation_type = ACTIVATION_NULL;
+        Tensor outputTensor = this->outputTensors[0];
+        EE ret = eltwise({this->inputTensors[1], resultTensor}, eltwiseDesc, tmpTensor,
+            outputTensor, &this->archInfo);
+        if (ret == SUCCESS && activationDesc.mode != ACTIVATION_NULL) {
+            ret = activation(outputTensor, activationDesc, outputTensor, &this->archInfo);
+        }
+        return ret;
+    }
+
+    U32 infer_residual_eltwise_tmp_bytes(TensorDesc resultDesc)
+    {
+        Tensor resultTensor;
+        resultTensor.resize(resultDesc);
+        U32 bytes = 0;
+        CHECK_STATUS(eltwise_infer_forward_tmp_bytes({this->inputTensors[1], resultTensor},
+            this->outputTensors[0], &bytes, &this->archInfo));
+        return bytes;
+    }
+
+    // the desc of the output is the one of the eltwise that adds the result to the second input,
+    // which keeps the format of the residual when both of them are row major
+    EE infer_residual_output_size(
+        TensorDesc resultDesc, Tensor *residualTensor, Tensor *outputTensor)
+    {
+        Tensor resultTensor;
+        resultTensor.resize(resultDesc);
+        return eltwise_infer_output_size(
+            {residualTensor, &resultTensor}, outputTensor, &this->archInfo);
+    }
+
+    // set the weights that have been transformed offline for algorithm,
+    // they take the place of transform_filter.
+    void set_packed_weight_tensors(std::string algorithm, std::vector<Tensor> packedWeightTensors)
+    {
+        this->packedAlgorithm = algorithm;
+        this->packedWeightTensors = packedWeightTensors;
+    }
+
+    bool has_packed_weight_tensors()
+    {
+        return this->packedWeightTensors.size() > 0;
+    }
+
+    std::string get_packed_algorithm()
+    {
+        return this->packedAlgorithm;
+    }
+
+    EE use_packed_weight_tensors()
+    {
+        if (this->packedWeightTensors.size() != this->weightTensors.size()) {
+            UNI_ERROR_LOG("operator %s packed weight number %d is not equal to weight number %d\n",
+                this->get_name().c_str(), (int)this->packedWeightTensors.size(),
+                (int)this->weightTensors.size());
+            return NOT_MATCH;
+        }
+        this->weightTensors = this->packedWeightTensors;
+        this->packedWeightTensors.clear();
+        return SUCCESS;
+    }
+
 protected:
+    std::shared_ptr<U8> get_weightspec_shared_ptr(U8 *ptr)
+    {
+        std::shared_ptr<U8> ret;
+        U8 *memory = this->wsMemory.get();
+        if (memory != nullptr && ptr >= memory && ptr < memory + this->wsMemoryBytes) {
+            ret = std::shared_ptr<U8>(this->wsMemory, ptr);
+        } else {
+            ret = std::shared_ptr<U8>(ptr);
+        }
+        return ret;
+    }
+
     std::vector<Tensor> weightTensors;
     std::vector<Tensor> biasTensors;
     bool hasBias;
@@ -191,6 +312,10 @@ protected:
     U32 lenOfWtm;
     std::shared_ptr<Tensor> wtm;
     WeightSpec ws;
+    std::shared_ptr<U8> wsMemory;
+    U32 wsMemoryBytes;
+    std::string packedAlgorithm;
+    std::vector<Tensor> packedWeightTensors;
 };
 
 #endif  // _WEIGHTOPERATOR_H
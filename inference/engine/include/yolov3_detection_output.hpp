@@ -39,8 +39,16 @@ public:
 
     void run() override
     {
-        CHECK_STATUS(yolov3detectionoutput(
-            this->inputTensors, this->p, this->outputTensors[0], &this->archInfo));
+        CHECK_STATUS(yolov3detectionoutput(this->inputTensors, this->p, this->temp,
+            this->outputTensors[0], &this->archInfo));
+    }
+
+    U32 infer_tmp_memory_size() override
+    {
+        U32 bytes = 0;
+        CHECK_STATUS(yolov3detectionoutput_infer_forward_tmp_bytes(
+            this->inputTensors, this->p, this->outputTensors[0], &bytes, &this->archInfo));
+        return bytes;
     }
 
     EE infer_output_tensors_size(
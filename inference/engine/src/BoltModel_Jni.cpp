@@ -68,6 +68,8 @@ DEVICE_TYPE str2DEVICE_TYPE(std::string device_str)
         ret = GPU_MALI;
     } else if (device_str == "CPU_X86_AVX2") {
         ret = CPU_X86_AVX2;
+    } else if (device_str == "CPU_X86_AVX512") {
+        ret = CPU_X86_AVX512;
     } else if (device_str == "CPU_SERIAL") {
         ret = CPU_SERIAL;
     } else {
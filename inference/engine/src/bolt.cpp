@@ -12,6 +12,7 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include "inference.hpp"
+#include "batch_runner.hpp"
 #include "../api/c/bolt.h"
 
 struct ModelHandleInfo {
@@ -33,6 +34,7 @@ typedef struct {
     U32 num_outputs;
     DataDesc *outputArr;
     DEVICE_TYPE deviceType;
+    U8 *outputData;  // output copy of RunBatchModel
 } ResultHandleInner;
 
 DataType dt_mapping_user2bolt(DATA_TYPE dt_user)
@@ -177,6 +179,9 @@ inline Arch device_mapping_user2bolt(DEVICE_TYPE device)
         case CPU_X86_AVX2:
             ret = X86_AVX2;
             break;
+        case CPU_X86_AVX512:
+            ret = X86_AVX512;
+            break;
         case CPU_SERIAL:
             ret = CPU_GENERAL;
             break;
@@ -210,6 +215,9 @@ inline DEVICE_TYPE device_mapping_bolt2user(Arch arch)
         case X86_AVX2:
             ret = CPU_X86_AVX2;
             break;
+        case X86_AVX512:
+            ret = CPU_X86_AVX512;
+            break;
         case CPU_GENERAL:
             ret = CPU_SERIAL;
             break;
@@ -240,7 +248,7 @@ ModelHandle CreateModel(const char *modelPath, AFFINITY_TYPE affinity, const cha
 {
     ModelHandleInfo *handle = new ModelHandleInfo();
     ModelSpec *ms = new ModelSpec();
-    if (SUCCESS != deserialize_model_from_file(modelPath, ms)) {
+    if (SUCCESS != deserialize_model_from_file(modelPath, ms, false, true)) {
         UNI_ERROR_LOG("CreateModel failed\n");
         delete ms;
         handle->cnn = nullptr;
@@ -264,8 +272,7 @@ ModelHandle CloneModel(ModelHandle ih)
     ModelHandleInfo *handle = (ModelHandleInfo *)ih;
     ModelHandleInfo *cloneHandle = new ModelHandleInfo();
     *cloneHandle = *handle;
-    CNN *cloneCnn = new CNN();
-    *cloneCnn = ((CNN *)handle->cnn)->clone();
+    CNN *cloneCnn = new CNN(((CNN *)handle->cnn)->clone());
     cloneHandle->cnn = cloneCnn;
     return (ModelHandle)cloneHandle;
 }
@@ -506,6 +513,7 @@ ResultHandle AllocAllResultHandle(ModelHandle ih)
     model_result_ptr->num_outputs = model_num_outputs;
     model_result_ptr->outputArr = outputArrPtr;
     model_result_ptr->deviceType = device;
+    model_result_ptr->outputData = nullptr;
     return (void *)model_result_ptr;
 }
 
@@ -531,6 +539,7 @@ ResultHandle AllocSpecificResultHandle(ModelHandle ih, const int num_outputs, ch
     model_result_ptr->num_outputs = model_num_outputs;
     model_result_ptr->outputArr = outputArrPtr;
     model_result_ptr->deviceType = device;
+    model_result_ptr->outputData = nullptr;
     return (void *)model_result_ptr;
 }
 
@@ -550,6 +559,26 @@ void SetRuntimeDeviceDynamic(ModelHandle ih)
     ihInfo->deviceType = device_mapping_bolt2user(cnn->get_runtime_device());
 }
 
+void SetNumThreads(ModelHandle ih, int threads)
+{
+    ModelHandleInfo *ihInfo = (ModelHandleInfo *)ih;
+    CNN *cnn = (CNN *)ihInfo->cnn;
+    cnn->set_num_threads(threads);
+}
+
+void SetRuntimeProfile(int enable)
+{
+    runtime_profile_set_enable(enable != 0);
+}
+
+int DumpRuntimeProfile(const char *path)
+{
+    runtime_profile_summary();
+    EE ret = runtime_profile_dump_chrome_trace(path);
+    runtime_profile_clear();
+    return (ret == SUCCESS) ? 0 : -1;
+}
+
 void RunModel(ModelHandle ih, ResultHandle ir, const int num_input, char **inputNames, void **mem)
 {
     ModelHandleInfo *ihInfo = (ModelHandleInfo *)ih;
@@ -581,6 +610,55 @@ void RunModel(ModelHandle ih, ResultHandle ir, const int num_input, char **input
     }
 }
 
+BatchHandle CreateBatchModel(ModelHandle ih, int max_batch, int timeout_us)
+{
+    ModelHandleInfo *ihInfo = (ModelHandleInfo *)ih;
+    CNN *cnn = (CNN *)ihInfo->cnn;
+    BatchRunner *runner = new BatchRunner(cnn, UNI_MAX(max_batch, 1), UNI_MAX(timeout_us, 0));
+    return (BatchHandle)runner;
+}
+
+void RunBatchModel(
+    BatchHandle bh, ResultHandle ir, const int num_input, char **inputNames, void **mem)
+{
+    BatchRunner *runner = (BatchRunner *)bh;
+    ResultHandleInner *ir_inner = (ResultHandleInner *)ir;
+    DataDesc *outputArrPtr = ir_inner->outputArr;
+    std::vector<U32> bytes(ir_inner->num_outputs);
+    U32 totalBytes = 0;
+    for (U32 i = 0; i < ir_inner->num_outputs; i++) {
+        bytes[i] = bytesOf(outputArrPtr[i].dt);
+        for (U32 j = 0; j < 4; j++) {
+            bytes[i] *= outputArrPtr[i].dims[j];
+        }
+        totalBytes += bytes[i];
+    }
+    if (ir_inner->outputData == nullptr) {
+        ir_inner->outputData = (U8 *)malloc(totalBytes);
+    }
+
+    std::map<std::string, const U8 *> inputs;
+    for (int index = 0; index < num_input; index++) {
+        inputs[inputNames[index]] = (const U8 *)mem[index];
+    }
+    std::map<std::string, U8 *> outputs;
+    for (U32 i = 0, offset = 0; i < ir_inner->num_outputs; offset += bytes[i], i++) {
+        outputArrPtr[i].dataPtr = ir_inner->outputData + offset;
+        outputs[outputArrPtr[i].name] = ir_inner->outputData + offset;
+    }
+    CHECK_STATUS(runner->run(inputs, outputs));
+}
+
+void DestroyBatchModel(BatchHandle bh)
+{
+    BatchRunner *runner = (BatchRunner *)bh;
+    if (nullptr == runner) {
+        UNI_WARNING_LOG("DestroyBatchModel received null handle.\n");
+        return;
+    }
+    delete runner;
+}
+
 int GetNumOutputsFromResultHandle(ResultHandle ir)
 {
     ResultHandleInner *ir_inner = (ResultHandleInner *)ir;
@@ -655,6 +733,7 @@ ResultHandle CloneResultHandle(ResultHandle ir)
     U32 size = sizeof(DataDesc) * cloneIrInner->num_outputs;
     cloneIrInner->outputArr = (DataDesc *)malloc(size);
     memcpy(cloneIrInner->outputArr, irInner->outputArr, size);
+    cloneIrInner->outputData = nullptr;
     return (ResultHandle)cloneIrInner;
 }
 
@@ -664,6 +743,10 @@ void FreeResultHandle(ResultHandle ir)
     DataDesc *outputArrPtr = (*ir_inner).outputArr;
     free(outputArrPtr);
     (*ir_inner).outputArr = nullptr;
+    if (nullptr != (*ir_inner).outputData) {
+        free((*ir_inner).outputData);
+        (*ir_inner).outputData = nullptr;
+    }
     free(ir_inner);
 }
 
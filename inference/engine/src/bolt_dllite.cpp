@@ -40,6 +40,7 @@ typedef struct {
     U32 num_outputs;
     DataDesc *outputArr;
     DEVICE_TYPE deviceType;
+    U8 *outputData;  // output copy of RunBatchModel
 } ResultHandleInner;
 
 inline AFFINITY_TYPE AffinityMapDLLite2c(bolt::AffinityType affinity)
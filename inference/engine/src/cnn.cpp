@@ -12,6 +12,10 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include "cnn.h"
+#include "model_serialize_deserialize.hpp"
+#include "OPOptimizers/ScaledDotProductAttentionOptimizer.hpp"
+#include "OPOptimizers/EpilogueOptimizer.hpp"
+#include "fully_connected.hpp"
 #if defined(_USE_CPU)
 #include "cpu/factory_cpu.hpp"
 #endif
@@ -19,6 +23,34 @@
 #include "ocl/factory_ocl.hpp"
 #endif
 
+// the number of input shapes whose plans are kept by reready
+#define MAX_SHAPE_PLANS 16
+
+// the arena is allocated in buckets of a quarter of its power of 2, so that the growing shapes
+// of a model do not allocate it again and again
+static U32 arena_bucket_size(U32 size)
+{
+    U32 step = ARENA_ALIGNMENT;
+    while (step * 8 <= size) {
+        step *= 2;
+    }
+    return (size + step - 1) / step * step;
+}
+
+static bool is_same_descs(const std::vector<TensorDesc> &a, const std::vector<TensorDesc> &b)
+{
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (U32 i = 0; i < a.size(); i++) {
+        if (a[i].dt != b[i].dt || a[i].df != b[i].df || a[i].nDims != b[i].nDims ||
+            memcmp(a[i].dims, b[i].dims, a[i].nDims * sizeof(U32)) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
 bool is_same_tensor(Tensor a, Tensor b)
 {
     auto ptr_a = ((CpuMemory *)a.get_memory())->get_ptr();
@@ -37,29 +69,34 @@ CNN CNN::clone()
     CNN cnn = *this;
     for (U32 i = 0; i < cnn.ops.size(); i++) {
         cnn.ops[i] = cnn.ops[i]->clone();
-        cnn.operatorMap[cnn.ops[i]->get_name()] = cnn.ops[i];
     }
+    U32 opIndex = 0;
+    for (auto &op : cnn.operatorMap) {
+        op.second = cnn.ops[this->graph->operatorMapOrder[opIndex++]];
+    }
+    // the weights are shared, the tensors are in the same order as the ids
+    U32 tensorId = 0;
     for (auto &tensor : cnn.tensorMap) {
-        std::shared_ptr<Tensor> cloneTensor = std::shared_ptr<Tensor>(new Tensor());
-        *cloneTensor = tensor.second->clone(false);
-        tensor.second = cloneTensor;
-    }
-    cnn.assign_output_tensor();
-    cnn.tmpTensor = this->tmpTensor.clone();
-    for (auto &operatorTensor : cnn.operatorTensorMap) {
-        std::string operatorName = operatorTensor.first;
-        std::vector<std::vector<Tensor>> tensors(operatorTensor.second.size());
-        for (U32 i = 0; i < operatorTensor.second.size(); i++) {
-            for (U32 j = 0; j < operatorTensor.second[i].size(); j++) {
-                std::string tensorName = operatorTensor.second[i][j];
-                if (cnn.weightOpOutputNames.find(tensorName) != cnn.weightOpOutputNames.end()) {
-                    cnn.tensorMap[tensorName] = this->tensorMap[tensorName];
-                }
-                tensors[i].push_back(*(cnn.tensorMap[tensorName].get()));
-            }
+        if (!this->graph->weightTensors[tensorId]) {
+            std::shared_ptr<Tensor> cloneTensor = std::shared_ptr<Tensor>(new Tensor());
+            *cloneTensor = tensor.second->clone(false);
+            tensor.second = cloneTensor;
+        }
+        cnn.graphTensors[tensorId++] = tensor.second.get();
+    }
+    // the plans are shared, but the tensors get a new arena on the first use of the clone
+    cnn.storageMemory.clear();
+    // the threads of the executor only run the operators of one model at a time
+    cnn.executor = nullptr;
+    if (cnn.deviceInfo.schedule == MALI) {
+        cnn.assign_output_tensor();
+        cnn.tmpTensor = this->tmpTensor.clone();
+        for (auto &op : cnn.ops) {
+            op->set_tmp_memory(cnn.tmpTensor);
         }
-        cnn.operatorMap[operatorName]->set_input_output_tensors(tensors[0], tensors[1]);
-        cnn.operatorMap[operatorName]->set_tmp_memory(cnn.tmpTensor);
+    } else {
+        cnn.tmpTensor = Tensor();
+        cnn.sessionMemoryPending = true;
     }
     for (auto &tensor : cnn.inputTensors) {
         tensor.second = cnn.tensorMap[tensor.first];
@@ -68,16 +105,18 @@ CNN CNN::clone()
         tensor.second = cnn.tensorMap[tensor.first];
     }
 
-    // check
+#ifdef _DEBUG
+    // check that the clone shares nothing but the weights, the memory is assigned to compare
+    this->assign_session_memory();
+    cnn.assign_session_memory();
     CHECK_REQUIREMENT(!is_same_tensor(this->tmpTensor, cnn.tmpTensor));
     for (U32 i = 0; i < this->storageMemory.size(); i++) {
         CHECK_REQUIREMENT(
             !is_same_tensor(*(this->storageMemory[i].get()), *(cnn.storageMemory[i].get())));
     }
-    for (auto iter : this->tensorMap) {
-        if (cnn.weightOpOutputNames.find(iter.first) == cnn.weightOpOutputNames.end()) {
-            CHECK_REQUIREMENT(
-                !is_same_tensor(*(iter.second.get()), *(cnn.tensorMap[iter.first].get())));
+    for (U32 i = 0; i < this->graphTensors.size(); i++) {
+        if (!this->graph->weightTensors[i]) {
+            CHECK_REQUIREMENT(!is_same_tensor(*(this->graphTensors[i]), *(cnn.graphTensors[i])));
         }
     }
     for (auto iter : this->inputTensors) {
@@ -88,32 +127,27 @@ CNN CNN::clone()
         CHECK_REQUIREMENT(
             !is_same_tensor(*(iter.second.get()), *(cnn.outputTensors[iter.first].get())));
     }
-    for (auto iter : this->operatorMap) {
-        std::shared_ptr<Operator> op1 = iter.second;
-        std::shared_ptr<Operator> op2 = cnn.operatorMap[iter.first];
-        for (int i = 0; i < 2; i++) {
-            std::vector<std::string> names = this->operatorTensorMap[iter.first][i];
-            std::vector<Tensor> tensor1, tensor2;
-            if (i == 0) {
-                tensor1 = op1->get_input_tensors();
-                tensor2 = op2->get_input_tensors();
-            } else {
-                tensor1 = op1->get_output_tensors();
-                tensor2 = op2->get_output_tensors();
-            }
+    for (U32 i = 0; i < this->ops.size(); i++) {
+        for (int j = 0; j < 2; j++) {
+            std::vector<U32> &ids =
+                (j == 0) ? this->graph->opInputIds[i] : this->graph->opOutputIds[i];
+            std::vector<Tensor> &tensor1 = (j == 0) ? this->ops[i]->get_input_tensors()
+                                                    : this->ops[i]->get_output_tensors();
+            std::vector<Tensor> &tensor2 = (j == 0) ? cnn.ops[i]->get_input_tensors()
+                                                    : cnn.ops[i]->get_output_tensors();
             CHECK_REQUIREMENT(tensor1.size() == tensor2.size());
-            for (U32 j = 0; j < tensor1.size(); j++) {
-                if (tensor1[j].bytes() != 0) {
-                    CHECK_REQUIREMENT(
-                        is_same_tensor(tensor1[j], *(this->tensorMap[names[j]].get())));
-                    CHECK_REQUIREMENT(is_same_tensor(tensor2[j], *(cnn.tensorMap[names[j]].get())));
-                    if (this->weightOpOutputNames.find(names[j]) == this->weightOpOutputNames.end()) {
-                        CHECK_REQUIREMENT(!is_same_tensor(tensor1[j], tensor2[j]));
+            for (U32 k = 0; k < tensor1.size(); k++) {
+                if (tensor1[k].bytes() != 0) {
+                    CHECK_REQUIREMENT(is_same_tensor(tensor1[k], *(this->graphTensors[ids[k]])));
+                    CHECK_REQUIREMENT(is_same_tensor(tensor2[k], *(cnn.graphTensors[ids[k]])));
+                    if (!this->graph->weightTensors[ids[k]]) {
+                        CHECK_REQUIREMENT(!is_same_tensor(tensor1[k], tensor2[k]));
                     }
                 }
             }
         }
     }
+#endif
     return cnn;
 }
 
@@ -123,15 +157,29 @@ void CNN::sort_operators_sequential(const ModelSpec *ms)
     this->sortedOps.clear();
     for (int i = 0; i < opNum; i++) {
         std::string opName = ms->ops[i].name;
-        if (opName.compare("data") == 0) {
+        if (opName.compare("data") == 0 || ms->ops[i].type == OT_None) {
             continue;
         }
         this->sortedOps.push_back(opName);
     }
 }
 
-void CNN::initialize_ops(const ModelSpec *ms)
+void CNN::initialize_ops(ModelSpec *ms)
 {
+    // only the CPU implements the fused attention and the fused epilogues, so they are fused
+    // here instead of by X2bolt
+    Arch schedule = this->deviceInfo.schedule;
+    std::map<std::string, ActivationParamSpec> fcActivations;
+    if ((IS_X86(schedule) || IS_GENERAL(schedule)) && this->dt == DT_F32) {
+        std::shared_ptr<OPOptimizer> optimizer(new ScaledDotProductAttentionOptimizer());
+        bool hasOptimized = optimizer->optimize(ms);
+        std::shared_ptr<EpilogueOptimizer> epilogueOptimizer(new EpilogueOptimizer());
+        hasOptimized |= epilogueOptimizer->optimize(ms);
+        fcActivations = epilogueOptimizer->fcActivations;
+        if (hasOptimized) {
+            this->sort_operators_sequential(ms);
+        }
+    }
     int opNum = ms->num_operator_specs;
 
     for (int i = 0; i < ms->num_inputs; i++) {
@@ -142,12 +190,13 @@ void CNN::initialize_ops(const ModelSpec *ms)
         this->modelOutputTensorNames.push_back(ms->output_names[i]);
     }
 
+    this->graph = std::shared_ptr<GraphIndex>(new GraphIndex());
     U32 operatorIndex = 0;
     std::map<std::string, U32> operatorIndexMap;
     for (int i = 0; i < opNum; i++) {
         OperatorSpec curOps = ms->ops[i];
         std::string opName = curOps.name;
-        if (opName.compare("data") == 0) {
+        if (opName.compare("data") == 0 || curOps.type == OT_None) {
             continue;
         }
         operatorIndexMap[opName] = operatorIndex++;
@@ -156,7 +205,7 @@ void CNN::initialize_ops(const ModelSpec *ms)
     for (int i = 0; i < opNum; i++) {
         OperatorSpec curOps = ms->ops[i];
         std::string opName = curOps.name;
-        if (opName.compare("data") == 0) {
+        if (opName.compare("data") == 0 || curOps.type == OT_None) {
             continue;
         }
         std::vector<std::string> inputTensorsName;
@@ -200,12 +249,23 @@ void CNN::initialize_ops(const ModelSpec *ms)
         op->set_tensor_positions(tensorPositions);
         op->init_feature_scale(curOps.num_quant_feature, curOps.feature_scale);
         op->set_algorithm_map(this->algorithmMap);
+        if (fcActivations.find(opName) != fcActivations.end()) {
+            dynamic_cast<FullyConnected *>(op.get())->activationDesc = fcActivations[opName];
+        }
         this->ops.push_back(op);
 
-        // setup operatorMap, tensorMap, operatorTensorMap
+        // setup operatorMap, tensorMap and the tensor names of the operator
         this->add(op, inputTensorsName, outputTensorsName);
     }
+    this->build_graph();
 
+    // take over the memory mapped model file, it is released when no weight uses it
+    std::shared_ptr<U8> modelFile;
+    if (ms->mfd != nullptr) {
+        void *mfd = ms->mfd;
+        modelFile = std::shared_ptr<U8>((U8 *)((ModelFileDescriptor *)mfd)->bytes,
+            [mfd](U8 *ptr) { CHECK_STATUS(release_model_file(mfd)); });
+    }
     // setup WeightSpec ptr in WeightOperator
     for (int i = 0; i < ms->num_weight_specs; i++) {
         WeightSpec curOpWs = ms->ws[i];
@@ -213,6 +273,11 @@ void CNN::initialize_ops(const ModelSpec *ms)
         auto op = this->operatorMap[opName];
         auto weightOp = dynamic_cast<WeightOperator *>(op.get());
         weightOp->set_weightspec_ptr(curOpWs);
+        // a bias only WeightSpec has no weight, so both pointers are checked
+        if (is_model_file_memory(ms, curOpWs.weight) || is_model_file_memory(ms, curOpWs.vec)) {
+            weightOp->set_weightspec_memory(
+                modelFile, ((ModelFileDescriptor *)ms->mfd)->fileLength);
+        }
         if (curOpWs.bytes_of_vec != 0) {
             CHECK_REQUIREMENT(curOpWs.vec != nullptr);
             weightOp->set_hasBias(true);
@@ -221,11 +286,124 @@ void CNN::initialize_ops(const ModelSpec *ms)
         ms->ws[i].weight = nullptr;
         ms->ws[i].vec = nullptr;
     }
+    // setup offline transformed weights of this architecture and precision
+    for (int i = 0; i < ms->num_packed_weight_specs; i++) {
+        PackedWeightSpec *curOpPws = &(ms->pws[i]);
+        std::string opName = curOpPws->op_name;
+        WeightOperator *weightOp = nullptr;
+        if (curOpPws->arch == this->deviceInfo.schedule && curOpPws->dt == this->dt &&
+            this->deviceInfo.schedule != MALI &&
+            this->operatorMap.find(opName) != this->operatorMap.end()) {
+            weightOp = dynamic_cast<WeightOperator *>(this->operatorMap[opName].get());
+        }
+        std::vector<Tensor> packedWeightTensors;
+        for (U32 j = 0; j < curOpPws->num_weights; j++) {
+            U8 *weight = curOpPws->weights[j];
+            bool inModelFile = is_model_file_memory(ms, weight);
+            if (inModelFile) {
+                // the mapped file is released by engine, mt_destroy_model should not touch it
+                curOpPws->weights[j] = nullptr;
+            }
+            if (weightOp == nullptr) {
+                continue;
+            }
+            std::shared_ptr<U8> weightPtr;
+            if (inModelFile) {
+                weightPtr = std::shared_ptr<U8>(modelFile, weight);
+            } else {
+                // copy to the same address offset that the weight is transformed at
+                U32 bytes = curOpPws->weight_bytes[j];
+                std::shared_ptr<U8> buffer((U8 *)operator new(bytes + sg_weightAlignment));
+                uintptr_t address = (uintptr_t)buffer.get();
+                address += packed_weight_padding(
+                    address % sg_weightAlignment, curOpPws->weight_offsets[j]);
+                weightPtr = std::shared_ptr<U8>(buffer, (U8 *)address);
+                memcpy(weightPtr.get(), weight, bytes);
+            }
+            Tensor packedWeightTensor;
+            packedWeightTensor.resize(curOpPws->weight_descs[j]);
+            ((CpuMemory *)(packedWeightTensor.get_memory()))->set_shared_ptr(weightPtr);
+            packedWeightTensors.push_back(packedWeightTensor);
+        }
+        if (weightOp != nullptr) {
+            weightOp->set_packed_weight_tensors(curOpPws->algorithm, packedWeightTensors);
+        }
+    }
+    ms->mfd = nullptr;
+}
+
+EE CNN::export_packed_weights(ModelSpec *ms)
+{
+    if (this->deviceInfo.schedule == MALI || isQuantMixDataType(this->dt)) {
+        return NOT_SUPPORTED;
+    }
+    std::set<OperatorType> transformTypes = {OT_Conv, OT_Deconvolution, OT_FC, OT_RNN};
+    std::vector<PackedWeightSpec> pws;
+    // keep the packed weights of other architectures and precisions
+    for (int i = 0; i < ms->num_packed_weight_specs; i++) {
+        if (ms->pws[i].arch != this->deviceInfo.schedule || ms->pws[i].dt != this->dt) {
+            pws.push_back(ms->pws[i]);
+            continue;
+        }
+        for (U32 j = 0; j < ms->pws[i].num_weights; j++) {
+            if (!is_model_file_memory(ms, ms->pws[i].weights[j])) {
+                delete ms->pws[i].weights[j];
+            }
+        }
+        delete ms->pws[i].weights;
+        delete ms->pws[i].weight_descs;
+        delete ms->pws[i].weight_bytes;
+        delete ms->pws[i].weight_offsets;
+    }
+    for (auto op : this->ops) {
+        if (!op->is_weight() || transformTypes.find(op->get_type()) == transformTypes.end()) {
+            continue;
+        }
+        auto weightOp = dynamic_cast<WeightOperator *>(op.get());
+        std::vector<Tensor> weightTensors = weightOp->get_weight_tensors();
+        std::string algorithm = this->algorithmMap->getAlgorithmInfoFromMap(op->get_name());
+        if (algorithm.size() >= NAME_LEN) {
+            UNI_WARNING_LOG("skip to pack operator %s weight, algorithm info is too long\n",
+                op->get_name().c_str());
+            continue;
+        }
+        PackedWeightSpec curOpPws;
+        str_copy(curOpPws.op_name, op->get_name().c_str(), NAME_LEN);
+        curOpPws.arch = this->deviceInfo.schedule;
+        curOpPws.dt = this->dt;
+        str_copy(curOpPws.algorithm, algorithm.c_str(), NAME_LEN);
+        U32 num = weightTensors.size();
+        curOpPws.num_weights = num;
+        curOpPws.weight_descs = (TensorDesc *)mt_new_storage(num * sizeof(TensorDesc));
+        curOpPws.weight_bytes = (U32 *)mt_new_storage(num * sizeof(U32));
+        curOpPws.weight_offsets = (U32 *)mt_new_storage(num * sizeof(U32));
+        curOpPws.weights = (U8 **)mt_new_storage(num * sizeof(U8 *));
+        for (U32 j = 0; j < num; j++) {
+            // save the whole buffer, kernels may use an aligned address inside it
+            auto mem = (CpuMemory *)(weightTensors[j].get_memory());
+            U8 *ptr = (U8 *)mem->get_ptr();
+            U32 bytes = UNI_MAX(mem->capacity(), mem->bytes());
+            curOpPws.weight_descs[j] = weightTensors[j].get_desc();
+            curOpPws.weight_bytes[j] = bytes;
+            curOpPws.weight_offsets[j] = (uintptr_t)ptr % sg_weightAlignment;
+            curOpPws.weights[j] = (U8 *)mt_new_storage(bytes);
+            memcpy(curOpPws.weights[j], ptr, bytes);
+        }
+        pws.push_back(curOpPws);
+    }
+    if (nullptr != ms->pws) {
+        delete ms->pws;
+    }
+    ms->num_packed_weight_specs = pws.size();
+    ms->pws = (PackedWeightSpec *)mt_new_storage(pws.size() * sizeof(PackedWeightSpec));
+    memcpy(ms->pws, pws.data(), pws.size() * sizeof(PackedWeightSpec));
+    return SUCCESS;
 }
 
 void CNN::ready(std::map<std::string, TensorDesc> inputDescMap)
 {
     UNI_DEBUG_LOG("ready() schedule: %d\n", (int)(this->deviceInfo.schedule));
+    set_cpu_num_threads(this->threadNum);
     UNI_PROFILE(
         {
             this->infer_output_tensors_size(inputDescMap);
@@ -236,6 +414,11 @@ void CNN::ready(std::map<std::string, TensorDesc> inputDescMap)
                 if (op->is_weight()) {
                     auto weightOpPtr = dynamic_cast<WeightOperator *>(op.get());
                     CHECK_STATUS(weightOpPtr->init_weight_bias_from_model(nullptr));
+                    // packed weights can only be used with the algorithm they are transformed for
+                    std::string algorithm = weightOpPtr->get_packed_algorithm();
+                    if (weightOpPtr->has_packed_weight_tensors() && !algorithm.empty()) {
+                        this->algorithmMap->setAlgorithmInfoToMap(op->get_name(), algorithm);
+                    }
                 }
                 CHECK_STATUS(op->infer_forward_algorithm(this->algorithmMap));
             }
@@ -248,11 +431,17 @@ void CNN::ready(std::map<std::string, TensorDesc> inputDescMap)
                 UNI_DEBUG_LOG("ready() op: %s transform filter\n", op->get_name().c_str());
                 if (op->is_weight()) {
                     auto weightOpPtr = dynamic_cast<WeightOperator *>(op.get());
-                    CHECK_STATUS(weightOpPtr->transform_filter());
+                    if (weightOpPtr->has_packed_weight_tensors()) {
+                        CHECK_STATUS(weightOpPtr->use_packed_weight_tensors());
+                    } else {
+                        CHECK_STATUS(weightOpPtr->transform_filter());
+                    }
                 }
             }
             this->infer_tmp_memory_size();
-            this->tmpTensor.alloc();
+            if (this->deviceInfo.schedule == MALI) {
+                this->tmpTensor.alloc();
+            }
             this->assign_output_tensor();
         },
         std::string("ready"), std::string("prepare"));
@@ -260,12 +449,29 @@ void CNN::ready(std::map<std::string, TensorDesc> inputDescMap)
 
 void CNN::reready(std::map<std::string, TensorDesc> inputDescMap)
 {
+    set_cpu_num_threads(this->threadNum);
+    std::vector<TensorDesc> key;
+    if (this->deviceInfo.schedule != MALI) {
+        key = this->get_shape_plan_key(inputDescMap);
+        for (U32 i = 0; i < this->shapePlans.size(); i++) {
+            if (is_same_descs(this->shapePlans[i].inputDescs, key)) {
+                this->apply_shape_plan(i);
+                return;
+            }
+        }
+    }
     this->infer_output_tensors_size(inputDescMap);
-    if (this->memoryTracker.getMemoryNeedAssign()) {
+    this->infer_tmp_memory_size();
+    // the memory tracker does not know where a plan put the tensors
+    if (this->memoryTracker.getMemoryNeedAssign() || this->shapePlanApplied ||
+        this->sessionMemoryPending) {
         this->assign_output_tensor();
     }
-    this->infer_tmp_memory_size();
-    this->tmpTensor.alloc();
+    if (this->deviceInfo.schedule == MALI) {
+        this->tmpTensor.alloc();
+    } else {
+        this->record_shape_plan(key);
+    }
 }
 
 EE CNN::mark_input_output()
@@ -293,6 +499,7 @@ EE CNN::mark_input_output()
 
 void CNN::copy_to_named_input(std::string inputName, const U8 *data)
 {
+    this->assign_session_memory();
     if (inputTensors.find(inputName) == inputTensors.end()) {
         CHECK_STATUS(NOT_MATCH);
     }
@@ -306,6 +513,7 @@ void CNN::copy_to_named_input(std::string inputName, const U8 *data)
 
 void CNN::set_input_tensors_value(std::map<std::string, std::shared_ptr<U8>> modelTensorsInput)
 {
+    this->assign_session_memory();
     for (auto &modelTensorInput : modelTensorsInput) {
         std::string inputName = modelTensorInput.first;
         std::shared_ptr<U8> data = modelTensorInput.second;
@@ -322,6 +530,7 @@ void CNN::set_input_tensors_value(std::map<std::string, std::shared_ptr<U8>> mod
 
 std::map<std::string, std::shared_ptr<Tensor>> CNN::get_inputs()
 {
+    this->assign_session_memory();
     std::map<std::string, std::shared_ptr<Tensor>> ret;
     if (this->deviceInfo.schedule == MALI) {
 #ifdef _USE_MALI
@@ -342,11 +551,13 @@ std::map<std::string, std::shared_ptr<Tensor>> CNN::get_inputs()
 
 std::map<std::string, std::shared_ptr<Tensor>> CNN::get_outputs()
 {
+    this->assign_session_memory();
     return this->outputTensors;
 }
 
 Tensor CNN::get_tensor_by_name(std::string tensorName)
 {
+    this->assign_session_memory();
     if (this->tensorMap.find(tensorName) == this->tensorMap.end()) {
         CHECK_STATUS(NOT_MATCH);
     }
@@ -391,62 +602,118 @@ EE CNN::infer_output_tensors_size(std::map<std::string, TensorDesc> inputDescMap
 
 void CNN::assign_output_tensor()
 {
-    this->storageMemory.clear();
-    auto storageSize = this->memoryTracker.getStorageSize();
-    for (U32 size : storageSize) {
-        auto tensor = this->allocate_tensor(size);
-        this->storageMemory.push_back(tensor);
-    }
-
-    std::set<std::string> input_set(modelInputTensorNames.begin(), modelInputTensorNames.end());
-    std::set<std::string> output_set(modelOutputTensorNames.begin(), modelOutputTensorNames.end());
-    for (std::string opName : this->sortedOps) {
-        std::shared_ptr<Operator> op = this->operatorMap[opName];
-        std::vector<I32> tensorPositions = op->get_tensor_positions();
-        std::vector<std::vector<Tensor>> tensors(this->operatorTensorMap[opName].size());
-        for (U32 i = 0, tensorIter = 0; i < this->operatorTensorMap[opName].size(); i++) {
-            std::vector<std::string> &tensorNames = this->operatorTensorMap[opName][i];
-            for (std::string &tensorName : tensorNames) {
-                UNI_DEBUG_LOG("assign_output_tensor() tensor %s slot %d\n", tensorName.c_str(),
-                    tensorPositions[tensorIter]);
-                auto tensor = this->tensorMap[tensorName];
-                if (i == 1 || input_set.find(tensorName) != input_set.end()) {
-                    if (tensorPositions[tensorIter] != -1) {
-                        auto mem = this->storageMemory[tensorPositions[tensorIter]].get();
-                        tensor->reuse(mem);
-                    } else if (this->weightOpOutputNames.find(tensorName) ==
-                        this->weightOpOutputNames.end()) {
-                        if (this->deviceInfo.schedule == MALI &&
-                            output_set.find(tensorName) != output_set.end()) {
+    if (this->deviceInfo.schedule == MALI) {
+        this->storageMemory.clear();
+        auto storageSize = this->memoryTracker.getStorageSize();
+        for (U32 size : storageSize) {
+            auto tensor = this->allocate_tensor(size);
+            this->storageMemory.push_back(tensor);
+        }
+    } else {
+        // tensors and tmp buffers are placed in one arena by their lifetimes, the arena only
+        // grows so that the plans of the smaller shapes still fit in it
+        U32 arenaSize = this->memoryTracker.planArena() + ARENA_ALIGNMENT;
+        if (this->storageMemory.empty() || this->storageMemory[0]->bytes() < arenaSize) {
+            this->storageMemory.clear();
+            this->storageMemory.push_back(this->allocate_tensor(arena_bucket_size(arenaSize)));
+        }
+        for (U32 i = 0; i < this->ops.size(); i++) {
+            auto tmp = this->memoryTracker.getTmpArena(i);
+            this->ops[i]->set_tmp_memory(this->get_arena_tensor(tmp.first, tmp.second));
+        }
+        // the tmp buffer shared by operators is only needed before the arena is planned
+        this->tmpTensor = Tensor();
+        this->sharedTmp = false;
+    }
+
+    for (auto &assign : this->graph->assignTensors) {
+        Tensor *tensor = this->graphTensors[assign.first];
+        I32 position = assign.second;
+        UNI_DEBUG_LOG("assign_output_tensor() tensor %s slot %d\n",
+            this->graph->tensorNames[assign.first].c_str(), position);
+        if (position != -1 && this->deviceInfo.schedule == MALI) {
+            tensor->reuse(this->storageMemory[position].get());
+        } else if (position != -1) {
+            auto block = this->memoryTracker.getTensorArena(this->graph->tensorNames[assign.first]);
+            Tensor mem = this->get_arena_tensor(block.first, block.second);
+            tensor->reuse(&mem);
+        } else if (this->deviceInfo.schedule == MALI && this->graph->outputTensors[assign.first]) {
 #ifdef _USE_MALI
-                            auto mem = (OclMemory *)tensor->get_memory();
-                            mem->mapped_alloc();
+            auto mem = (OclMemory *)tensor->get_memory();
+            mem->mapped_alloc();
 #endif
-                        } else {
-                            tensor->alloc();
-                        }
-                    }
-                }
-                tensorIter++;
-                tensors[i].push_back(*(tensor.get()));
-            }
+        } else {
+            tensor->alloc();
         }
-        op->set_input_output_tensors(tensors[0], tensors[1]);
+    }
+    for (U32 i = 0; i < this->ops.size(); i++) {
+        this->set_operator_tensors(i);
     }
     this->memoryTracker.setMemoryAssigned();
+    this->shapePlanApplied = false;
+    this->sessionMemoryPending = false;
+    check_memory_reuse_ratio();
+}
+
+Tensor CNN::get_arena_tensor(U32 offset, U32 size)
+{
+    auto arena = (CpuMemory *)(this->storageMemory[0]->get_memory());
+    uintptr_t address = (uintptr_t)arena->get_ptr();
+    address = (address + ARENA_ALIGNMENT - 1) / ARENA_ALIGNMENT * ARENA_ALIGNMENT + offset;
+    Tensor tensor;
+    tensor.resize(tensor1d(DT_U8, size));
+    ((CpuMemory *)(tensor.get_memory()))
+        ->set_shared_ptr(std::shared_ptr<U8>(arena->get_shared_ptr(), (U8 *)address));
+    return tensor;
+}
+
+void CNN::set_tensor_observer(TensorObserver *observer)
+{
+    this->observer = observer;
+}
+
+void CNN::observe_operator_outputs(U32 opIndex)
+{
+    for (U32 id : this->graph->opOutputIds[opIndex]) {
+        this->observer->observe(this->graph->tensorNames[id], *(this->graphTensors[id]));
+    }
 }
 
 void CNN::run()
 {
+    set_cpu_num_threads(this->threadNum);
+    this->assign_session_memory();
+    if (this->observer != nullptr) {
+        for (U32 id : this->graph->inputIds) {
+            this->observer->observe(this->graph->tensorNames[id], *(this->graphTensors[id]));
+        }
+    }
+    if (!this->parallelSteps.empty() && !this->sharedTmp) {
+        if (this->executor == nullptr) {
+            this->executor = std::shared_ptr<ParallelExecutor>(new ParallelExecutor(
+                this->branchNum, this->threadNum / (int)this->branchNum));
+        }
+        for (auto &step : this->parallelSteps) {
+            this->executor->run(this->ops, step);
+            if (this->observer != nullptr) {
+                for (U32 opIndex : step) {
+                    this->observe_operator_outputs(opIndex);
+                }
+            }
+        }
+        return;
+    }
     for (U32 opIndex = 0; opIndex < ops.size();) {
         std::shared_ptr<Operator> op = this->ops[opIndex];
-        UNI_DEBUG_LOG(
-            "run() op: %s type: %s\n", op->get_name().c_str(), OperatorTypeName()[op->get_type()]);
         if (op->get_type() == OT_Repeat || op->get_type() == OT_Jump) {
+            UNI_DEBUG_LOG("run() op: %s type: %s\n", op->get_name().c_str(),
+                OperatorTypeName()[op->get_type()]);
             opIndex = op->get_next_operator_index();
         } else {
-            UNI_PROFILE(op->run(), op->get_name(),
-                std::string(OperatorTypeName()[op->get_type()]) + std::string("::run"));
+            run_operator(op.get());
+            if (this->observer != nullptr) {
+                this->observe_operator_outputs(opIndex);
+            }
             opIndex++;
         }
 #ifdef _DEBUG
@@ -460,6 +727,24 @@ void CNN::run()
     }
 }
 
+void CNN::set_num_threads(int threadNum)
+{
+    Model::set_num_threads(threadNum);
+    this->executor = nullptr;
+    this->shapePlans.clear();
+    // some operators' tmp buffer size depends on the number of threads
+    if (!this->storageMemory.empty() || this->sessionMemoryPending) {
+        this->infer_tmp_memory_size();
+        if (this->deviceInfo.schedule == MALI) {
+            this->tmpTensor.alloc();
+        } else if (!this->sessionMemoryPending &&
+            (this->memoryTracker.getMemoryNeedAssign() || this->shapePlanApplied)) {
+            // keep the tensors in place, operators share one tmp buffer until the next reready
+            this->assign_tmp_tensor();
+        }
+    }
+}
+
 std::shared_ptr<Tensor> CNN::allocate_tensor(U32 size)
 {
     MemoryType type = CPUMem;
@@ -477,13 +762,10 @@ void CNN::add(std::shared_ptr<Operator> op,
     std::vector<std::string> outputTensorsName)
 {
     std::string operatorName = op->get_name();
-    this->operatorMap[operatorName] = op;
-
-    if (this->operatorTensorMap.find(operatorName) == this->operatorTensorMap.end()) {
-        this->operatorTensorMap[operatorName] = {inputTensorsName, outputTensorsName};
-    } else {
+    if (this->operatorMap.find(operatorName) != this->operatorMap.end()) {
         UNI_ERROR_LOG("duplicate tensor: %s\n", operatorName.c_str());
     }
+    this->operatorMap[operatorName] = op;
 
     for (std::string &inputName : inputTensorsName) {
         if (this->tensorMap.find(inputName) == this->tensorMap.end()) {
@@ -496,60 +778,72 @@ void CNN::add(std::shared_ptr<Operator> op,
             this->tensorMap[outputName] = this->allocate_tensor();
         }
     }
+    // the ids are given by build_graph after all the tensors are added
+    this->graph->opInputIds.push_back(std::vector<U32>(inputTensorsName.size()));
+    this->graph->opOutputIds.push_back(std::vector<U32>(outputTensorsName.size()));
+    inputTensorsName.insert(
+        inputTensorsName.end(), outputTensorsName.begin(), outputTensorsName.end());
+    this->graph->opTensorNames.push_back(inputTensorsName);
 }
 
 void CNN::infer_layout_desc()
 {
-    for (std::string opName : this->sortedOps) {
-        auto op = this->operatorMap[opName];
-        UNI_DEBUG_LOG("op: %s type: %s\n", opName.c_str(), OperatorTypeName()[op->get_type()]);
-        std::vector<std::string> curOpInputTensorName = this->operatorTensorMap[opName][0];
-        std::vector<std::string> curOpOutputTensorName = this->operatorTensorMap[opName][1];
-        std::vector<Tensor *> inputTensors;
-        std::vector<Tensor *> outputTensors;
-        for (std::string inputTensorName : curOpInputTensorName) {
-            auto tensor = this->tensorMap[inputTensorName].get();
-            inputTensors.push_back(tensor);
-            UNI_DEBUG_LOG("    input: %s desc %s\n", inputTensorName.c_str(),
-                tensorDesc2Str(tensor->get_desc()).c_str());
+    std::vector<Tensor *> inputs, outputs;
+    for (U32 i = 0; i < this->ops.size(); i++) {
+        auto &op = this->ops[i];
+        UNI_DEBUG_LOG(
+            "op: %s type: %s\n", op->get_name().c_str(), OperatorTypeName()[op->get_type()]);
+        inputs.clear();
+        outputs.clear();
+        for (U32 id : this->graph->opInputIds[i]) {
+            inputs.push_back(this->graphTensors[id]);
+            UNI_DEBUG_LOG("    input: %s desc %s\n", this->graph->tensorNames[id].c_str(),
+                tensorDesc2Str(this->graphTensors[id]->get_desc()).c_str());
         }
-        for (std::string outputTensorName : curOpOutputTensorName) {
-            auto tensor = this->tensorMap[outputTensorName].get();
-            outputTensors.push_back(tensor);
+        for (U32 id : this->graph->opOutputIds[i]) {
+            outputs.push_back(this->graphTensors[id]);
         }
-        CHECK_STATUS(op->infer_output_tensors_size(inputTensors, outputTensors));
-        for (std::string outputTensorName : curOpOutputTensorName) {
-            UNI_DEBUG_LOG("    output: %s desc %s\n", outputTensorName.c_str(),
-                tensorDesc2Str(this->tensorMap[outputTensorName]->get_desc()).c_str());
+        CHECK_STATUS(op->infer_output_tensors_size(inputs, outputs));
+        for (U32 id : this->graph->opOutputIds[i]) {
+            UNI_DEBUG_LOG("    output: %s desc %s\n", this->graph->tensorNames[id].c_str(),
+                tensorDesc2Str(this->graphTensors[id]->get_desc()).c_str());
         }
     }
 }
 
 void CNN::update_op_tensors()
 {
-    for (auto opName : this->sortedOps) {
-        auto op = this->operatorMap[opName];
-        UNI_DEBUG_LOG("update_op_tensors() op: %s type: %s\n", opName.c_str(),
+    for (U32 opIndex = 0; opIndex < this->ops.size(); opIndex++) {
+        auto &op = this->ops[opIndex];
+        UNI_DEBUG_LOG("update_op_tensors() op: %s type: %s\n", op->get_name().c_str(),
             OperatorTypeName()[op->get_type()]);
-        std::vector<std::string> curOpInputTensorName = this->operatorTensorMap[opName][0];
-        std::vector<std::string> curOpOutputTensorName = this->operatorTensorMap[opName][1];
-        std::vector<Tensor> inTensors, outTensors;
-        for (std::string inputTensorName : curOpInputTensorName) {
-            auto tensorTmp = this->tensorMap[inputTensorName];
-            inTensors.push_back(*tensorTmp.get());
-        }
-
-        for (std::string outputTensorName : curOpOutputTensorName) {
-            auto tensorTmp = this->tensorMap[outputTensorName];
-            outTensors.push_back(*tensorTmp.get());
+        this->set_operator_tensors(opIndex);
+        memoryTracker.trackOpTensorSizes(op.get(), this->graph->opTensorNames[opIndex], opIndex);
+        if (op->get_type() == OT_Repeat || op->get_type() == OT_Jump) {
+            auto iter = std::find(this->sortedOps.begin(), this->sortedOps.end(),
+                this->graph->opTensorNames[opIndex][0]);
+            if (iter != this->sortedOps.end()) {
+                memoryTracker.trackLoop(iter - this->sortedOps.begin(), opIndex);
+            }
         }
-        op->set_input_output_tensors(inTensors, outTensors);
+    }
+    for (std::string outputName : this->modelOutputTensorNames) {
+        memoryTracker.trackModelOutput(outputName);
+    }
+}
 
-        curOpInputTensorName.insert(
-            curOpInputTensorName.end(), curOpOutputTensorName.begin(), curOpOutputTensorName.end());
-        memoryTracker.trackOpTensorSizes(op, curOpInputTensorName);
+void CNN::set_operator_tensors(U32 opIndex)
+{
+    std::vector<Tensor> inputs, outputs;
+    inputs.reserve(this->graph->opInputIds[opIndex].size());
+    outputs.reserve(this->graph->opOutputIds[opIndex].size());
+    for (U32 id : this->graph->opInputIds[opIndex]) {
+        inputs.push_back(*(this->graphTensors[id]));
     }
-    check_memory_reuse_ratio();
+    for (U32 id : this->graph->opOutputIds[opIndex]) {
+        outputs.push_back(*(this->graphTensors[id]));
+    }
+    this->ops[opIndex]->set_input_output_tensors(std::move(inputs), std::move(outputs));
 }
 
 void CNN::set_input_tensors_desc(std::map<std::string, TensorDesc> inputDescMap)
@@ -575,15 +869,227 @@ void CNN::infer_tmp_memory_size()
     }
 
     // operator tmp buffer
-    for (auto &op : this->ops) {
-        auto len = op->infer_tmp_memory_size();
+    for (U32 i = 0; i < this->ops.size(); i++) {
+        auto len = this->ops[i]->infer_tmp_memory_size();
         tmpSize = UNI_MAX(tmpSize, len);
+        if (this->deviceInfo.schedule != MALI) {
+            this->memoryTracker.trackOpTmpSize(i, len);
+        }
     }
     this->tmpTensor.resize(tensor1d(DT_U8, tmpSize));
 }
 
+void CNN::set_parallel_branches(U32 branchNum)
+{
+    this->branchNum = UNI_MAX(branchNum, 1);
+    this->executor = nullptr;
+    this->schedule_parallel_operators();
+    std::vector<I32> steps(this->ops.size(), 0);
+    for (U32 i = 0; i < this->parallelSteps.size(); i++) {
+        for (U32 opIndex : this->parallelSteps[i]) {
+            steps[opIndex] = i;
+        }
+    }
+    if (this->parallelSteps.empty()) {
+        steps.clear();
+    }
+    // the operators of a step run at the same time, so the memory is planned by steps
+    this->memoryTracker.setOpSteps(steps);
+    this->shapePlans.clear();
+    if (!this->storageMemory.empty() || this->sessionMemoryPending) {
+        this->update_op_tensors();
+        this->infer_tmp_memory_size();
+        if (!this->sessionMemoryPending) {
+            this->assign_output_tensor();
+        }
+    }
+}
+
+// An operator runs after the operators that write its inputs (read after write), and after the
+// operators that read or write its outputs before it in sequential order (write after read and
+// write after write), so that in-place operators and copies keep their order.
+void CNN::schedule_parallel_operators()
+{
+    this->parallelSteps.clear();
+    if (this->branchNum <= 1 || this->deviceInfo.schedule == MALI) {
+        return;
+    }
+    std::vector<U32> opSteps(this->ops.size(), 0);
+    // -1 if the tensor is not written or read since the last write
+    std::vector<I32> writeStep(this->graphTensors.size(), -1);
+    std::vector<I32> readStep(this->graphTensors.size(), -1);
+    U32 stepNum = 0;
+    for (U32 i = 0; i < this->ops.size(); i++) {
+        auto &op = this->ops[i];
+        if (op->get_type() == OT_Repeat || op->get_type() == OT_Jump) {
+            UNI_WARNING_LOG("model with Repeat or Jump runs operators one by one.\n");
+            return;
+        }
+        I32 step = 0;
+        for (U32 id : this->graph->opInputIds[i]) {
+            step = UNI_MAX(step, writeStep[id] + 1);
+        }
+        for (U32 id : this->graph->opOutputIds[i]) {
+            step = UNI_MAX(step, writeStep[id] + 1);
+            step = UNI_MAX(step, readStep[id] + 1);
+        }
+        for (U32 id : this->graph->opInputIds[i]) {
+            readStep[id] = UNI_MAX(readStep[id], step);
+        }
+        for (U32 id : this->graph->opOutputIds[i]) {
+            writeStep[id] = step;
+            readStep[id] = -1;
+        }
+        opSteps[i] = step;
+        stepNum = UNI_MAX(stepNum, (U32)step + 1);
+    }
+    this->parallelSteps.resize(stepNum);
+    for (U32 i = 0; i < opSteps.size(); i++) {
+        this->parallelSteps[opSteps[i]].push_back(i);
+    }
+    UNI_DEBUG_LOG("%d operators run in %u steps.\n", (int)this->ops.size(), stepNum);
+}
+
+// Number the tensors and operators, and find the tensors that assign_output_tensor gives memory
+// to. A tensor visited several times keeps the position of its last visit.
+void CNN::build_graph()
+{
+    std::map<std::string, U32> tensorIds;
+    this->graphTensors.clear();
+    for (auto &tensor : this->tensorMap) {
+        tensorIds[tensor.first] = this->graphTensors.size();
+        this->graphTensors.push_back(tensor.second.get());
+        this->graph->tensorNames.push_back(tensor.first);
+        this->graph->weightTensors.push_back(
+            this->weightOpOutputNames.find(tensor.first) != this->weightOpOutputNames.end());
+    }
+    this->graph->outputTensors.assign(this->graphTensors.size(), false);
+    for (std::string &name : this->modelOutputTensorNames) {
+        if (tensorIds.find(name) != tensorIds.end()) {
+            this->graph->outputTensors[tensorIds[name]] = true;
+        }
+    }
+    for (std::string &name : this->modelInputTensorNames) {
+        CHECK_REQUIREMENT(tensorIds.find(name) != tensorIds.end());
+        this->graph->inputIds.push_back(tensorIds[name]);
+    }
+
+    std::set<std::string> inputSet(modelInputTensorNames.begin(), modelInputTensorNames.end());
+    std::map<std::string, U32> opIndexes;
+    std::vector<std::pair<U32, I32>> visits;
+    for (U32 i = 0; i < this->ops.size(); i++) {
+        opIndexes[this->ops[i]->get_name()] = i;
+        std::vector<I32> &tensorPositions = this->ops[i]->get_tensor_positions();
+        U32 inputNum = this->graph->opInputIds[i].size();
+        for (U32 j = 0; j < this->graph->opTensorNames[i].size(); j++) {
+            std::string &name = this->graph->opTensorNames[i][j];
+            U32 id = tensorIds[name];
+            if (j < inputNum) {
+                this->graph->opInputIds[i][j] = id;
+            } else {
+                this->graph->opOutputIds[i][j - inputNum] = id;
+            }
+            if ((j < inputNum && inputSet.find(name) == inputSet.end()) ||
+                (tensorPositions[j] == -1 && this->graph->weightTensors[id])) {
+                continue;
+            }
+            visits.push_back(std::make_pair(id, tensorPositions[j]));
+        }
+    }
+    for (auto &op : this->operatorMap) {
+        this->graph->operatorMapOrder.push_back(opIndexes[op.first]);
+    }
+    std::vector<bool> assigned(this->graphTensors.size(), false);
+    for (I32 i = (I32)visits.size() - 1; i >= 0; i--) {
+        if (!assigned[visits[i].first]) {
+            assigned[visits[i].first] = true;
+            this->graph->assignTensors.push_back(visits[i]);
+        }
+    }
+    std::reverse(this->graph->assignTensors.begin(), this->graph->assignTensors.end());
+}
+
+std::vector<TensorDesc> CNN::get_shape_plan_key(std::map<std::string, TensorDesc> &inputDescMap)
+{
+    std::vector<TensorDesc> key;
+    for (U32 i = 0; i < this->modelInputTensorNames.size(); i++) {
+        auto iter = inputDescMap.find(this->modelInputTensorNames[i]);
+        if (iter != inputDescMap.end()) {
+            key.push_back(iter->second);
+        } else {
+            key.push_back(this->graphTensors[this->graph->inputIds[i]]->get_desc());
+        }
+    }
+    return key;
+}
+
+// The tensors are where the memory tracker planned them, and they fit in the planned blocks,
+// otherwise they would have been assigned again.
+void CNN::record_shape_plan(std::vector<TensorDesc> key)
+{
+    ShapePlan plan;
+    plan.inputDescs = key;
+    for (auto &assign : this->graph->assignTensors) {
+        if (assign.second != -1) {
+            plan.tensorArena.push_back(
+                this->memoryTracker.getTensorArena(this->graph->tensorNames[assign.first]));
+        }
+    }
+    for (U32 i = 0; i < this->ops.size(); i++) {
+        plan.tmpArena.push_back(this->memoryTracker.getTmpArena(i));
+    }
+    plan.arenaSize = this->memoryTracker.getArenaSize() + ARENA_ALIGNMENT;
+    if (this->shapePlans.size() >= MAX_SHAPE_PLANS) {
+        this->shapePlans.erase(this->shapePlans.begin());
+    }
+    this->shapePlans.push_back(plan);
+}
+
+void CNN::apply_shape_plan(U32 planIndex)
+{
+    const ShapePlan &plan = this->shapePlans[planIndex];
+    for (U32 i = 0; i < plan.inputDescs.size(); i++) {
+        this->graphTensors[this->graph->inputIds[i]]->resize(plan.inputDescs[i]);
+    }
+    // operators keep some states of the shapes, such as the loops of Repeat
+    this->infer_layout_desc();
+
+    if (this->storageMemory.empty() || this->storageMemory[0]->bytes() < plan.arenaSize) {
+        this->storageMemory.clear();
+        this->storageMemory.push_back(this->allocate_tensor(arena_bucket_size(plan.arenaSize)));
+    }
+    U32 arenaIndex = 0;
+    for (auto &assign : this->graph->assignTensors) {
+        Tensor *tensor = this->graphTensors[assign.first];
+        if (assign.second != -1) {
+            auto block = plan.tensorArena[arenaIndex++];
+            Tensor mem = this->get_arena_tensor(block.first, block.second);
+            tensor->reuse(&mem);
+        } else {
+            tensor->alloc();
+        }
+    }
+    for (U32 i = 0; i < this->ops.size(); i++) {
+        this->set_operator_tensors(i);
+        this->ops[i]->set_tmp_memory(
+            this->get_arena_tensor(plan.tmpArena[i].first, plan.tmpArena[i].second));
+    }
+    this->tmpTensor = Tensor();
+    this->sharedTmp = false;
+    this->shapePlanApplied = true;
+    this->sessionMemoryPending = false;
+}
+
+void CNN::assign_session_memory()
+{
+    if (this->sessionMemoryPending) {
+        this->assign_output_tensor();
+    }
+}
+
 void CNN::assign_tmp_tensor()
 {
+    this->sharedTmp = true;
     this->tmpTensor.alloc();
     for (auto &op : this->ops) {
         op->set_tmp_memory(this->tmpTensor);
@@ -607,4 +1113,12 @@ void CNN::check_memory_reuse_ratio()
                   "for standalone tensors (e.g. loop topology). reuse rate: %f\n",
         this->memoryTracker.getNumSlots(), this->memoryTracker.getSizeSum(), standaloneSize,
         (F32)originalSize / (this->memoryTracker.getSizeSum() + standaloneSize));
+    if (this->deviceInfo.schedule != MALI) {
+        U32 slotSize = this->memoryTracker.getSizeSum() + this->memoryTracker.getTmpSizeMax();
+        U32 arenaSize = this->memoryTracker.getArenaSize();
+        UNI_DEBUG_LOG("tensor memory: tensors and tmp buffers take %u bytes in slots, %u bytes in "
+                      "arena. reuse rate: %f -> %f\n",
+            slotSize, arenaSize, (F32)originalSize / (slotSize + standaloneSize),
+            (F32)originalSize / (arenaSize + standaloneSize));
+    }
 }
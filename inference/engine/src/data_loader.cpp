@@ -85,16 +85,18 @@ std::vector<Tensor> load_jpeg(
     U32 width = info.output_width;
     U32 height = info.output_height;
     U32 numChannels = info.output_components;
-    U32 dataSize = numChannels * height * width;
 
     UNI_DEBUG_LOG("%s: channels %u , out color space %d\n", dataPath.c_str(), numChannels,
         info.out_color_space);
     CHECK_REQUIREMENT(2 == info.out_color_space);  // Support RGB for now
 
-    U8 *data = (U8 *)malloc(dataSize);
+    // the decoded pixels are interleaved, they are resized and normalized in one pass
+    TensorDesc rgbDesc = tensor4df(DT_U8, DF_NHWC, 1, numChannels, height, width);
+    Tensor rgbTensor = Tensor::alloc_sized<CPUMem>(rgbDesc);
+    U8 *rgb = (U8 *)((CpuMemory *)(rgbTensor.get_memory()))->get_ptr();
     JSAMPROW row_pointer[1];
     while (info.output_scanline < info.output_height) {
-        row_pointer[0] = data + info.output_scanline * width * numChannels;
+        row_pointer[0] = rgb + info.output_scanline * width * numChannels;
         int ret = jpeg_read_scanlines(&info, row_pointer, 1);
         CHECK_REQUIREMENT(ret == 1);
     }
@@ -103,22 +105,6 @@ std::vector<Tensor> load_jpeg(
     jpeg_destroy_decompress(&info);
     fclose(file);
 
-    TensorDesc rgbDesc = tensor4df(DT_U8, DF_RGB, 1, 3, height, width);
-    Tensor rgbTensor = Tensor::alloc_sized<CPUMem>(rgbDesc);
-    U8 *rgb = (U8 *)((CpuMemory *)(rgbTensor.get_memory()))->get_ptr();
-    U8 *r = rgb;
-    U8 *g = r + height * width;
-    U8 *b = g + height * width;
-
-    U8 *dataMov = data;
-    for (U32 i = 0; i < height * width; i++) {
-        r[i] = dataMov[0];
-        g[i] = dataMov[1];
-        b[i] = dataMov[2];
-        dataMov += numChannels;
-    }
-    free(data);
-
     std::shared_ptr<Tensor> imageTensor =
         load_resize_image(rgbTensor, imageDesc[0], ImageFormat, scaleValue);
     std::vector<Tensor> result;
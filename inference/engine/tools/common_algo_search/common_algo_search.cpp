@@ -16,19 +16,16 @@
 #include "algorithm_map.h"
 #include "parse_command.h"
 
-int convolutionCPUFloatAlgorithmSearch(Arch arch, DataType dt, std::string path)
+// Time the convolution algorithms on the bucketed shapes of the common algorithm map. The shapes
+// are measured in parallel, every worker is bound to its own core and runs with one thread. The
+// algorithm of every shape that is tuned successfully is saved, even if the tuning of the arch
+// only chooses it without timing.
+int convolutionCPUFloatAlgorithmSearch(Arch arch, DataType dt, std::string path, int workers)
 {
-    TensorDesc inputDesc, filterDesc;
-    ConvolutionPolicy policy = CONVOLUTION_TUNNING;
     ActivationParamSpec activationDesc;
     activationDesc.mode = ACTIVATION_RELU;
     activationDesc.value[0] = 0;
-    ConvolutionParamSpec convParamSpec;
-    convParamSpec.dilatedRate_h = 1;
-    convParamSpec.dilatedRate_w = 1;
     U32 in = 1;
-    ArchInfo archInfo;
-    archInfo.arch = UT_ARCH;
     U32 ic_step, ihw_step, fn_step, ic_max, ihw_max, fn_max;
     std::set<U32> fwh;
     std::set<U32> stride;
@@ -37,47 +34,71 @@ int convolutionCPUFloatAlgorithmSearch(Arch arch, DataType dt, std::string path)
     AlgorithmMap *algoMap = new AlgorithmMap(arch, modelName, deviceName, dt);
     algoMap->getCommonAlgoMapPara(
         &ic_step, &ihw_step, &fn_step, &ic_max, &ihw_max, &fn_max, &fwh, &stride);
+    // stride, filter size, fn, ic, ih, iw
+    std::vector<std::vector<U32>> shapes;
     for (auto sv : stride) {
         for (auto fv : fwh) {
-            U32 pl = fv / 2;
-            U32 pr = (fv - 1) / 2;
-            U32 pt = fv / 2;
-            U32 pb = (fv - 1) / 2;
             for (U32 fn = fn_step; fn <= fn_max; fn += fn_step) {
                 for (U32 ic = ic_step; ic <= ic_max; ic += ic_step) {
                     for (U32 ih = ihw_step; ih <= ihw_max; ih += ihw_step) {
                         for (U32 iw = ihw_step; iw <= ihw_max; iw += ihw_step) {
-                            if (ic % 8 != 0) {
-                                inputDesc = tensor4df(dt, DF_NCHW, in, ic, ih, ih);
-                            } else {
-                                inputDesc = tensor4df(dt, DF_NCHWC8, in, ic, ih, ih);
-                            }
-                            convParamSpec.stride_h = sv;
-                            convParamSpec.stride_w = sv;
-                            convParamSpec.padding_left = pl;
-                            convParamSpec.padding_right = pr;
-                            convParamSpec.padding_top = pt;
-                            convParamSpec.padding_bottom = pb;
-                            filterDesc = tensor4df(dt, DF_NCHW, fn, ic, fv, fv);
-                            Tensor inputTensor;
-                            Tensor outputTensor;
-                            Tensor filterTensor;
-                            inputTensor.resize(inputDesc);
-                            filterTensor.resize(filterDesc);
-                            CHECK_STATUS(convolution_infer_output_size(&inputTensor, filterTensor,
-                                convParamSpec, &outputTensor, dt, &archInfo));
-                            ConvolutionForwardAlgorithm algorithm = CONVOLUTION_ALGORITHM_NULL;
-                            CHECK_STATUS(convolution_infer_forward_algorithm(inputTensor,
-                                filterTensor, outputTensor, convParamSpec, policy, &algorithm, dt,
-                                activationDesc, &archInfo));
-                            algoMap->setCommonAlgoInfoToMap(OT_Conv, dt, ic, ih, iw, fn, fv, fv, sv,
-                                sv, (I32 *)(&algorithm), 1);
+                            shapes.push_back({sv, fv, fn, ic, ih, iw});
                         }
                     }
                 }
             }
         }
     }
+    // algorithm and latency in us of each shape
+    std::vector<I32> results(shapes.size() * 2, 0);
+    std::vector<EE> status(shapes.size(), NOT_SUPPORTED);
+#ifdef _USE_OPENMP
+#pragma omp parallel for num_threads(workers) schedule(dynamic)
+#endif
+    for (U32 i = 0; i < shapes.size(); i++) {
+        set_cpu_num_threads(1);
+        U32 sv = shapes[i][0], fv = shapes[i][1], fn = shapes[i][2];
+        U32 ic = shapes[i][3], ih = shapes[i][4], iw = shapes[i][5];
+        TensorDesc inputDesc, filterDesc;
+        if (ic % 8 != 0) {
+            inputDesc = tensor4df(dt, DF_NCHW, in, ic, ih, iw);
+        } else {
+            inputDesc = tensor4df(dt, DF_NCHWC8, in, ic, ih, iw);
+        }
+        filterDesc = tensor4df(dt, DF_NCHW, fn, ic, fv, fv);
+        ConvolutionParamSpec convParamSpec;
+        convParamSpec.group = 1;
+        convParamSpec.dilatedRate_h = 1;
+        convParamSpec.dilatedRate_w = 1;
+        convParamSpec.stride_h = sv;
+        convParamSpec.stride_w = sv;
+        convParamSpec.padding_left = fv / 2;
+        convParamSpec.padding_right = (fv - 1) / 2;
+        convParamSpec.padding_top = fv / 2;
+        convParamSpec.padding_bottom = (fv - 1) / 2;
+        ArchInfo archInfo;
+        archInfo.arch = arch;
+        Tensor inputTensor;
+        Tensor outputTensor;
+        Tensor filterTensor;
+        inputTensor.resize(inputDesc);
+        filterTensor.resize(filterDesc);
+        CHECK_STATUS(convolution_infer_output_size(
+            &inputTensor, filterTensor, convParamSpec, &outputTensor, dt, &archInfo));
+        ConvolutionForwardAlgorithm algorithm = CONVOLUTION_ALGORITHM_NULL;
+        F32 time = 0;
+        status[i] = convolution_tune_forward_algorithm(inputTensor, filterTensor, outputTensor,
+            convParamSpec, &algorithm, &time, dt, activationDesc, &archInfo);
+        results[i * 2] = algorithm;
+        results[i * 2 + 1] = time * 1000;
+    }
+    for (U32 i = 0; i < shapes.size(); i++) {
+        if (status[i] == SUCCESS) {
+            algoMap->setCommonAlgoInfoToMap(OT_Conv, dt, shapes[i][3], shapes[i][4],
+                shapes[i][5], shapes[i][2], shapes[i][1], shapes[i][1], shapes[i][0],
+                shapes[i][0], results.data() + i * 2, 2);
+        }
+    }
     algoMap->saveAlgorithmMapToText(path);
     delete algoMap;
     return 0;
@@ -100,19 +121,29 @@ int main(int argc, char *argv[])
     if (affinityPolicyName == "CPU_AFFINITY_HIGH_PERFORMANCE" ||
         affinityPolicyName == "CPU_AFFINITY_LOW_POWER") {
         Arch arch;
+        int workers = 1;
 #ifndef _USE_IOS
         DeviceInfo deviceInfo = get_cpu_info(affinityPolicy);
         set_cpu_dynamic(&deviceInfo, 0);
         arch = deviceInfo.schedule;
+        // one worker on every idle core of the schedule arch
+        workers = 0;
+        for (int i = 0; i < deviceInfo.cpuNum; i++) {
+            if (deviceInfo.archs[i] == arch && deviceInfo.cpuids[i] != -1) {
+                workers++;
+            }
+        }
+        workers = UNI_MAX(workers, 1);
+        thread_affinity_set_omp_threads(&deviceInfo, workers);
 #else
         arch = ARM_A76;
 #endif
 #ifdef _USE_FP16
-        convolutionCPUFloatAlgorithmSearch(arch, DT_F16, algorithmMapPath);
+        convolutionCPUFloatAlgorithmSearch(arch, DT_F16, algorithmMapPath, workers);
 
 #endif
 #ifdef _USE_FP32
-        convolutionCPUFloatAlgorithmSearch(arch, DT_F32, algorithmMapPath);
+        convolutionCPUFloatAlgorithmSearch(arch, DT_F32, algorithmMapPath, workers);
 #endif
     } else if (affinityPolicyName == "GPU") {
         UNI_ERROR_LOG("Unsupport GPU now\n");
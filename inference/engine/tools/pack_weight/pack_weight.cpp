@@ -0,0 +1,72 @@
+// Copyright (C) 2019. Huawei Technologies Co., Ltd. All rights reserved.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "inference.hpp"
+#include "parse_command.h"
+#include "model_print.h"
+
+// transform the weights of model for the target architecture offline, and store them with
+// the chosen algorithms in the packed weight section of model, so that inference engine
+// can skip algorithm search and transform_filter at startup.
+int main(int argc, char *argv[])
+{
+    std::string affinityPolicyName = "CPU_AFFINITY_HIGH_PERFORMANCE";
+    std::string algorithmMapPath = "";
+    ParseRes parse_res;
+    parseCommandLine(argc, argv, &parse_res, "examples");
+    if (!parse_res.model.second) {
+        UNI_ERROR_LOG("please use -m to specify the .bolt model\n");
+        exit(-1);
+    }
+    char *modelPath = parse_res.model.first;
+    if (parse_res.archInfo.second) {
+        affinityPolicyName = parse_res.archInfo.first;
+    }
+    if (parse_res.algoPath.second) {
+        algorithmMapPath = parse_res.algoPath.first;
+    }
+    if (affinityPolicyName == "GPU") {
+        UNI_ERROR_LOG("Unsupport GPU now\n");
+        exit(-1);
+    }
+
+    ModelSpec ms;
+    CHECK_STATUS(deserialize_model_from_file(modelPath, &ms));
+    ModelSpec resultMs;
+    CHECK_STATUS(deserialize_model_from_file(modelPath, &resultMs));
+
+    // always search algorithms and transform weights again
+    ModelSpec tmpMs;
+    CHECK_STATUS(mt_create_model(&tmpMs));
+    tmpMs.num_packed_weight_specs = ms.num_packed_weight_specs;
+    tmpMs.pws = ms.pws;
+    ms.num_packed_weight_specs = 0;
+    ms.pws = nullptr;
+    CHECK_STATUS(mt_destroy_model(&tmpMs));
+
+    auto cnn = createPipelinefromMs(affinityPolicyName.c_str(), &ms, algorithmMapPath.c_str());
+    EE ret = cnn->export_packed_weights(&resultMs);
+    if (SUCCESS != ret) {
+        UNI_ERROR_LOG("can not pack weights for %s\n", affinityPolicyName.c_str());
+        exit(-1);
+    }
+    print_packed_weights(resultMs);
+
+    resultMs.version = sg_boltVersion;
+    CHECK_STATUS(serialize_model_to_file(&resultMs, modelPath));
+
+    CHECK_STATUS(mt_destroy_model(&ms));
+    CHECK_STATUS(mt_destroy_model(&resultMs));
+    UNI_INFO_LOG("packed weights are saved to %s\n", modelPath);
+    return 0;
+}
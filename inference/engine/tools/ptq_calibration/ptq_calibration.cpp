@@ -11,37 +11,217 @@
 // COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
+
 #include <iostream>
-#include <limits.h>
-#include <float.h>
+#include <math.h>
+#include <pthread.h>
 #include "inference.hpp"
 #include "tensor.hpp"
 #include "data_loader.hpp"
-#include "result_format.hpp"
 #include "profiling.h"
 #include "tensor_computing.h"
 #include "model_print.h"
-#ifdef _USE_FP16
-#include "../../../../compute/tensor/src/cpu/arm/fp16/arm_functions_fp16.h"
-#endif
-#ifdef _USE_FP32
-#include "../../../../compute/tensor/src/cpu/arm/fp32/arm_functions_fp32.h"
-#endif
 
 #define BINS 2048
-#define NUM_IMAGES_INPUT 100
+// the initial range of the histograms, it grows with the values
+#define MIN_RANGE (1.0f / 65536)
+#define PERCENTILE 0.9999
 
 void print_help(char *argv[])
 {
     std::cout << "usage: " << argv[0]
               << " modelPath dataDirectory dataFormat scaleValue affinityPolicyName "
-                 "algorithmMapPath"
+                 "algorithmMapPath method(KL|PERCENTILE|MSE) threadNum"
               << std::endl;
 }
 
-int main(int argc, char *argv[])
+// The histogram of the absolute values of a tensor over the samples. Its range is a power of 2
+// and doubles by merging neighbouring bins when a larger value comes, so one pass over the
+// samples is enough, and the histograms of different threads can be added up exactly.
+struct ActivationStatistics {
+    F32 range;
+    std::vector<F32> histogram;
+};
+
+static void grow_statistics_range(ActivationStatistics *statistics, F32 range)
+{
+    std::vector<F32> &histogram = statistics->histogram;
+    while (statistics->range < range) {
+        for (U32 i = 0; i < BINS / 2; i++) {
+            histogram[i] = histogram[2 * i] + histogram[2 * i + 1];
+        }
+        std::fill(histogram.begin() + BINS / 2, histogram.end(), 0);
+        statistics->range *= 2;
+    }
+}
+
+template <typename T>
+static void update_statistics(const T *data, U32 len, ActivationStatistics *statistics)
+{
+    F32 max = 0;
+    for (U32 i = 0; i < len; i++) {
+        max = UNI_MAX(max, UNI_ABS((F32)data[i]));
+    }
+    if (max >= statistics->range) {
+        int exponent;
+        frexp(max, &exponent);
+        grow_statistics_range(statistics, ldexp(1.0f, exponent));
+    }
+    F32 factor = BINS / statistics->range;
+    F32 *histogram = statistics->histogram.data();
+    for (U32 i = 0; i < len; i++) {
+        U32 index = UNI_ABS((F32)data[i]) * factor;
+        histogram[UNI_MIN(index, BINS - 1)] += 1;
+    }
+}
+
+static void merge_statistics(ActivationStatistics *dst, ActivationStatistics src)
 {
+    grow_statistics_range(dst, src.range);
+    grow_statistics_range(&src, dst->range);
+    for (U32 i = 0; i < BINS; i++) {
+        dst->histogram[i] += src.histogram[i];
+    }
+}
+
+// collects the statistics of the tensors in tensorIds during CNN::run
+class ActivationObserver : public TensorObserver {
+public:
+    ActivationObserver(const std::map<std::string, U32> *tensorIds)
+    {
+        this->tensorIds = tensorIds;
+        ActivationStatistics initial;
+        initial.range = MIN_RANGE;
+        initial.histogram.resize(BINS, 0);
+        this->statistics.resize(tensorIds->size(), initial);
+    }
+
+    void observe(const std::string &tensorName, Tensor &tensor) override
+    {
+        auto iter = this->tensorIds->find(tensorName);
+        if (iter == this->tensorIds->end()) {
+            return;
+        }
+        TensorDesc desc = tensor.get_desc();
+        void *ptr = ((CpuMemory *)(tensor.get_memory()))->get_ptr();
+        ActivationStatistics *statistics = &(this->statistics[iter->second]);
+        switch (desc.dt) {
+#ifdef _USE_FP32
+            case DT_F32: {
+                update_statistics<F32>((F32 *)ptr, tensorNumElements(desc), statistics);
+                break;
+            }
+#endif
 #ifdef _USE_FP16
+            case DT_F16: {
+                update_statistics<F16>((F16 *)ptr, tensorNumElements(desc), statistics);
+                break;
+            }
+#endif
+            default:
+                UNI_WARNING_LOG(
+                    "can not calibrate tensor %s of type %d\n", tensorName.c_str(), desc.dt);
+                break;
+        }
+    }
+
+    std::vector<ActivationStatistics> statistics;
+
+private:
+    const std::map<std::string, U32> *tensorIds;
+};
+
+struct SampleTask {
+    U32 threadId;
+    U32 threadNum;
+    CNN *session;
+    ActivationObserver *observer;
+    std::vector<std::vector<Tensor>> *images;
+    std::vector<std::string> *inputNames;
+};
+
+// run the samples of this thread on its own session
+static void *run_samples(void *arg)
+{
+    SampleTask *task = (SampleTask *)arg;
+    // the main thread is bound to one core by the affinity policy, let the workers use all
+    std::vector<int> cpuIds(get_cpus_num());
+    for (U32 i = 0; i < cpuIds.size(); i++) {
+        cpuIds[i] = i;
+    }
+    set_thread_affinity(task->threadId, cpuIds.data(), cpuIds.size());
+    task->session->set_tensor_observer(task->observer);
+    std::vector<std::vector<Tensor>> &images = *(task->images);
+    for (U32 i = task->threadId; i < images.size(); i += task->threadNum) {
+        for (U32 j = 0; j < task->inputNames->size(); j++) {
+            task->session->copy_to_named_input((*(task->inputNames))[j],
+                (U8 *)((CpuMemory *)images[i][j].get_memory())->get_ptr());
+        }
+        task->session->run();
+    }
+    task->session->set_tensor_observer(nullptr);
+    return NULL;
+}
+
+struct ScaleTask {
+    U32 threadId;
+    U32 threadNum;
+    std::string method;
+    std::vector<ActivationStatistics> *statistics;
+    std::vector<std::vector<F32>> *scales;
+};
+
+static void *search_scales(void *arg)
+{
+    ScaleTask *task = (ScaleTask *)arg;
+    for (U32 i = task->threadId; i < task->statistics->size(); i += task->threadNum) {
+        ActivationStatistics &statistics = (*(task->statistics))[i];
+        F32 sum = 0;
+        for (U32 j = 0; j < BINS; j++) {
+            sum += statistics.histogram[j];
+        }
+        // a tensor that is not observed is quantized with its own range at run time
+        if (0 == sum) {
+            (*(task->scales))[i] = std::vector<F32>(1, -1);
+            continue;
+        }
+        F32 interval = statistics.range / BINS;
+        if (task->method == "PERCENTILE") {
+            (*(task->scales))[i] =
+                compute_scale_with_percentile(statistics.histogram, interval, PERCENTILE);
+        } else if (task->method == "MSE") {
+            (*(task->scales))[i] = compute_scale_with_MSE(statistics.histogram, interval);
+        } else {
+            // the range is up to twice the maximum, KL searches the thresholds below the maximum
+            U32 used = BINS;
+            while (used > 1 && 0 == statistics.histogram[used - 1]) {
+                used--;
+            }
+            std::vector<F32> histogram(statistics.histogram.begin(),
+                statistics.histogram.begin() + UNI_MAX(used, 128));
+            for (U32 j = 0; j < histogram.size(); j++) {
+                histogram[j] = UNI_MAX(histogram[j], 0.00001f);
+            }
+            (*(task->scales))[i] = compute_scale_with_KL(histogram, interval);
+        }
+    }
+    return NULL;
+}
+
+template <typename T>
+static void run_in_threads(void *(*func)(void *), std::vector<T> &tasks)
+{
+    std::vector<pthread_t> threads(tasks.size());
+    for (U32 i = 0; i < tasks.size(); i++) {
+        CHECK_REQUIREMENT(0 == pthread_create(&threads[i], NULL, func, &tasks[i]));
+    }
+    for (U32 i = 0; i < tasks.size(); i++) {
+        pthread_join(threads[i], NULL);
+    }
+}
+
+int main(int argc, char *argv[])
+{
     UNI_TIME_INIT
 
     char *modelPath = (char *)"";
@@ -50,6 +230,8 @@ int main(int argc, char *argv[])
     char *algorithmMapPath = (char *)"";
     ImageFormat imageFormat = RGB;
     F32 scaleValue = 1;
+    std::string method = "KL";
+    U32 threadNum = get_cpus_num();
     if (argc < 5) {
         print_help(argv);
         return 1;
@@ -76,29 +258,48 @@ int main(int argc, char *argv[])
         algorithmMapPath = argv[6];
     }
 
+    if (argc > 7) {
+        method = argv[7];
+        if (method != "KL" && method != "PERCENTILE" && method != "MSE") {
+            print_help(argv);
+            return 1;
+        }
+    }
+
+    if (argc > 8) {
+        threadNum = UNI_MAX(atoi(argv[8]), 1);
+    }
+
     ModelSpec int8Ms;
     CHECK_STATUS(deserialize_model_from_file(modelPath, &int8Ms));
-    CHECK_REQUIREMENT(DT_F16_8Q == int8Ms.dt || DT_F16 == int8Ms.dt);
-    int8Ms.dt = DT_F16_8Q;
+    DataType floatDt = noQuantDataType(int8Ms.dt);
+    CHECK_REQUIREMENT(DT_F16 == floatDt || DT_F32 == floatDt);
+    DataType quantDt = (DT_F16 == floatDt) ? DT_F16_8Q : DT_F32_8Q;
+    int8Ms.dt = quantDt;
 
-    ModelSpec f16Ms;
-    CHECK_STATUS(deserialize_model_from_file(modelPath, &f16Ms));
-    f16Ms.dt = DT_F16;
+    ModelSpec floatMs;
+    CHECK_STATUS(deserialize_model_from_file(modelPath, &floatMs));
+    floatMs.dt = floatDt;
 
     ModelSpec resultMs;
     CHECK_STATUS(deserialize_model_from_file(modelPath, &resultMs));
-    resultMs.dt = DT_F16_8Q;
+    resultMs.dt = quantDt;
 
     auto relationNum = resultMs.num_op_tensor_entries;
     auto relationPtr = resultMs.op_relationship_entries;
     resultMs.num_op_tensor_entries = 0;
     resultMs.op_relationship_entries = nullptr;
 
+    // the int8 model tells which tensors need scales, and the float model gives their values
     auto int8CNN = createPipelinefromMs(affinityPolicyName, &int8Ms, algorithmMapPath);
-    auto f16CNN = createPipelinefromMs(affinityPolicyName, &f16Ms, algorithmMapPath);
+    // every session runs one sample at a time with one thread
+    if (threadNum > 1) {
+        set_cpu_num_threads(1);
+    }
+    auto floatCNN = createPipelinefromMs(affinityPolicyName, &floatMs, algorithmMapPath);
 
     // load images
-    std::map<std::string, std::shared_ptr<Tensor>> inMap = int8CNN->get_inputs();
+    std::map<std::string, std::shared_ptr<Tensor>> inMap = floatCNN->get_inputs();
     TensorDesc imageDesc = (*(inMap.begin()->second)).get_desc();
     std::vector<TensorDesc> imageDescs;
     imageDescs.push_back(imageDesc);
@@ -108,288 +309,111 @@ int main(int argc, char *argv[])
 
     std::cout << "[Calibration]:" << std::endl;
 
-    std::vector<U8> dBuf;
-    //std::vector<U8> qBuf;
+    // find the operators to calibrate and the float tensors whose scales they need
     std::vector<U32> calibratedOpIdx;
+    std::map<std::string, U32> tensorIds;
+    U32 opIdx = int8CNN->find_next_dynamic_scale_op(calibratedOpIdx, 0);
+    while (0 != opIdx) {
+        auto op = int8CNN->get_operator_by_index(opIdx);
+        CHECK_REQUIREMENT(op->get_name() == std::string(int8Ms.ops[opIdx].name));
+        auto inputTensors = op->get_input_tensors();
+        auto outputTensors = op->get_output_tensors();
+        for (U32 i = 0; i < int8Ms.ops[opIdx].num_inputs; i++) {
+            std::string tensorName = int8Ms.ops[opIdx].input_tensors_name[i];
+            // the scale of int8 input is given by int8 pooling or concat
+            if (DT_I8 != inputTensors[i].get_desc().dt &&
+                tensorIds.find(tensorName) == tensorIds.end()) {
+                U32 id = tensorIds.size();
+                tensorIds[tensorName] = id;
+            }
+        }
+        for (U32 i = 0; i < int8Ms.ops[opIdx].num_outputs; i++) {
+            std::string tensorName = int8Ms.ops[opIdx].output_tensors_name[i];
+            if (DT_I8 == outputTensors[i].get_desc().dt &&
+                tensorIds.find(tensorName) == tensorIds.end()) {
+                U32 id = tensorIds.size();
+                tensorIds[tensorName] = id;
+            }
+        }
+        calibratedOpIdx.push_back(opIdx);
+        opIdx = int8CNN->find_next_dynamic_scale_op(calibratedOpIdx, opIdx);
+    }
 
-    auto curModelInputTensorNames = int8CNN->get_model_input_tensor_names();
-    for (int index = 0; index < (int)curModelInputTensorNames.size(); index++) {
-        int8CNN->copy_to_named_input(curModelInputTensorNames[index],
-            (U8 *)((CpuMemory *)images[0][index].get_memory())->get_ptr());
+    // one forward pass of the float model per sample, the samples run on cloned sessions
+    double timeBegin = ut_time_ms();
+    threadNum = UNI_MAX(UNI_MIN(threadNum, (U32)images.size()), 1);
+    std::vector<CNN> sessions;
+    std::vector<std::shared_ptr<ActivationObserver>> observers;
+    for (U32 i = 0; i < threadNum; i++) {
+        sessions.push_back(floatCNN->clone());
+        observers.push_back(
+            std::shared_ptr<ActivationObserver>(new ActivationObserver(&tensorIds)));
+    }
+    auto inputNames = floatCNN->get_model_input_tensor_names();
+    std::vector<SampleTask> sampleTasks(threadNum);
+    for (U32 i = 0; i < threadNum; i++) {
+        sampleTasks[i] = {i, threadNum, &sessions[i], observers[i].get(), &images, &inputNames};
+    }
+    run_in_threads(run_samples, sampleTasks);
+    std::vector<ActivationStatistics> statistics = observers[0]->statistics;
+    for (U32 i = 1; i < threadNum; i++) {
+        for (U32 j = 0; j < statistics.size(); j++) {
+            merge_statistics(&statistics[j], observers[i]->statistics[j]);
+        }
+    }
+    sessions.clear();
+    double timeStatistics = ut_time_ms();
+    std::cout << "  collect " << statistics.size() << " tensors of " << images.size()
+              << " samples with " << threadNum << " threads in " << timeStatistics - timeBegin
+              << " ms" << std::endl;
+
+    std::vector<std::vector<F32>> tensorScales(statistics.size());
+    std::vector<ScaleTask> scaleTasks(threadNum);
+    for (U32 i = 0; i < threadNum; i++) {
+        scaleTasks[i] = {i, threadNum, method, &statistics, &tensorScales};
     }
+    run_in_threads(search_scales, scaleTasks);
+    std::cout << "  search " << method << " scales in " << ut_time_ms() - timeStatistics << " ms"
+              << std::endl;
 
-    U32 opIdx = int8CNN->find_next_dynamic_scale_op(calibratedOpIdx, 0);
     std::map<std::string, std::vector<F32>> tensorScale;
-
-    while (0 != opIdx) {
+    for (U32 opIdx : calibratedOpIdx) {
         auto op = int8CNN->get_operator_by_index(opIdx);
         std::string opName = op->get_name();
         std::cout << "Calibrating OP " << opIdx << ": " << opName << std::endl;
-        std::string opsName = int8Ms.ops[opIdx].name;
-        CHECK_REQUIREMENT(opName == opsName);
 
         std::vector<std::vector<F32>> scales;
         auto inputTensors = op->get_input_tensors();
         auto outputTensors = op->get_output_tensors();
-        std::cout << "  Inputs:\n";
-
         for (U32 i = 0; i < int8Ms.ops[opIdx].num_inputs; i++) {
             std::string tensorName = int8Ms.ops[opIdx].input_tensors_name[i];
-            TensorDesc inDesc = inputTensors[i].get_desc();
-
             auto it = tensorScale.find(tensorName);
             if (it != tensorScale.end()) {
-                scales.push_back(tensorScale[tensorName]);
                 std::cout << "    InputTensor " << i << " " << tensorName << " inherits scale "
-                          << tensorScale[tensorName][0] << std::endl;
-                continue;
-            }
-
-            if (DT_I8 == inDesc.dt) {  // Gets scale from int8 pooling or concat. Label with -1
-                std::vector<F32> scale;
-                scale.push_back(-1);
-                scales.push_back(scale);
-                tensorScale[tensorName] = scale;
+                          << it->second[0] << std::endl;
+            } else if (DT_I8 == inputTensors[i].get_desc().dt) {
+                // Gets scale from int8 pooling or concat. Label with -1
+                tensorScale[tensorName] = std::vector<F32>(1, -1);
                 std::cout << "    InputTensor " << i << " " << tensorName
                           << " inherits transformed scale " << std::endl;
-                continue;
-            }
-
-            U32 dBytes = tensorNumBytes(inDesc);
-            dBuf.resize(dBytes * NUM_IMAGES_INPUT);
-            U8 *d = dBuf.data();
-            std::vector<F32> histogram;
-            F32 last_max = 0;
-            F32 interval = 0;
-
-            for (U32 j = 0; j < images.size(); j++) {
-                for (int index = 0; index < (int)curModelInputTensorNames.size(); index++) {
-                    int8CNN->copy_to_named_input(curModelInputTensorNames[index],
-                        (U8 *)((CpuMemory *)images[j][index].get_memory())->get_ptr());
-                }
-
-                int8CNN->run_till_breakpoint(opIdx);
-                memcpy(d, ((CpuMemory *)(inputTensors[i].get_memory()))->get_ptr(), dBytes);
-                d += dBytes;
-
-                if ((j != images.size() - 1) && ((j + 1) % NUM_IMAGES_INPUT != 0)) {
-                    continue;
-                }
-
-                if (j == NUM_IMAGES_INPUT - 1 ||
-                    ((j == images.size() - 1) && (j < NUM_IMAGES_INPUT - 1))) {
-                    UNI_DEBUG_LOG("----------  start getting 1 - %u images input tensors  "
-                                  "----------\n",
-                        j + 1);
-                    F16 *ptr_d = (F16 *)dBuf.data();
-                    F32 max = array_maxabs_f16(ptr_d, (I32)(tensorNumElements(inDesc) * (j + 1)));
-                    UNI_DEBUG_LOG("      %f is the maximum value\n", max);
-                    interval = max / BINS;
-                    histogram.resize(BINS, 0.00001f);
-                    //update histogram first time
-                    update_histogram(tensorNumElements(inDesc) * (j + 1), ptr_d, BINS, interval,
-                        histogram.data());
-                    last_max = max;
-                    d = dBuf.data();
-                    dBuf.clear();
-                    continue;
-                }
-
-                if ((j + 1) % NUM_IMAGES_INPUT == 0 && j != (NUM_IMAGES_INPUT - 1)) {
-                    UNI_DEBUG_LOG("----------  start getting %d - %u images input tensors  "
-                                  "----------\n",
-                        j + 1 - 100, j + 1);
-                    F16 *ptr_d = (F16 *)dBuf.data();
-                    F32 max = array_maxabs_f16(
-                        ptr_d, (I32)(tensorNumElements(inDesc) * NUM_IMAGES_INPUT));
-                    if (max <= last_max) {
-                        UNI_DEBUG_LOG("      %f is the maximum value\n", last_max);
-                        interval = last_max / BINS;
-                        //update histogram if no new max
-                        update_histogram(tensorNumElements(inDesc) * NUM_IMAGES_INPUT, ptr_d, BINS,
-                            interval, histogram.data());
-                    } else {
-                        UNI_DEBUG_LOG("      %f is the maximum value\n", max);
-                        interval = max / BINS;
-                        F32 numPerBin = (F32)max / last_max;
-                        //last_max = max; -> may optimize accuracy.
-                        histogram = compress_histogram(histogram, numPerBin, last_max);
-                        last_max = max;
-                        update_histogram((tensorNumElements(inDesc) * NUM_IMAGES_INPUT), ptr_d,
-                            BINS, interval, histogram.data());
-                    }
-                    d = dBuf.data();
-                    dBuf.clear();
-                    continue;
-                }
-
-                if ((j == images.size() - 1) && ((j + 1) % NUM_IMAGES_INPUT != 0)) {
-                    UNI_DEBUG_LOG("----------  start getting %d - %u images input tensors  "
-                                  "----------\n",
-                        j + 1 - ((j + 1) % NUM_IMAGES_INPUT), j + 1);
-                    dBuf.resize(dBytes * ((j + 1) % NUM_IMAGES_INPUT));
-                    F16 *ptr_d = (F16 *)dBuf.data();
-                    F32 max = array_maxabs_f16(
-                        ptr_d, (I32)(tensorNumElements(inDesc) * ((j + 1) % NUM_IMAGES_INPUT)));
-                    if (max <= last_max) {
-                        UNI_DEBUG_LOG("      %f is the maximum value\n", last_max);
-                        interval = last_max / BINS;
-                        //update histogram if no new max
-                        update_histogram(tensorNumElements(inDesc) * ((j + 1) % NUM_IMAGES_INPUT),
-                            ptr_d, BINS, interval, histogram.data());
-                    } else {
-                        UNI_DEBUG_LOG("      %f is the maximum value\n", max);
-                        interval = max / BINS;
-                        F32 numPerBin = (F32)max / last_max;
-                        //last_max = max;  -> may optimize accuracy
-                        histogram = compress_histogram(histogram, numPerBin, last_max);
-                        last_max = max;
-                        update_histogram((tensorNumElements(inDesc) * NUM_IMAGES_INPUT), ptr_d,
-                            BINS, interval, histogram.data());
-                    }
-                    d = dBuf.data();
-                    dBuf.clear();
-                    continue;
-                }
+            } else {
+                tensorScale[tensorName] = tensorScales[tensorIds[tensorName]];
+                std::cout << "    InputTensor " << i << " " << tensorName << " gets scale "
+                          << tensorScale[tensorName][0] << std::endl;
             }
-
-            UNI_DEBUG_LOG("----------  compute KL  ----------\n");
-            std::vector<F32> scale = compute_scale_with_KL(histogram, interval);
-            UNI_DEBUG_LOG("--------- finish compute KL ---------\n");
-            scales.push_back(scale);
-            tensorScale[tensorName] = scale;
-            UNI_DEBUG_LOG("    InputTensor %u %s gets scale %f\n", i, tensorName.c_str(),
-                tensorScale[tensorName][0]);
+            scales.push_back(tensorScale[tensorName]);
         }
 
-        op->set_feature_scale(scales);
-        UNI_DEBUG_LOG("  Outputs:\n");
-
         for (U32 i = 0; i < int8Ms.ops[opIdx].num_outputs; i++) {
             std::string tensorName = int8Ms.ops[opIdx].output_tensors_name[i];
-            TensorDesc desc = outputTensors[i].get_desc();
-
-            auto it = tensorScale.find(tensorName);
-            CHECK_REQUIREMENT(it == tensorScale.end());
-
-            if (DT_F16 == desc.dt) {
+            CHECK_REQUIREMENT(tensorScale.find(tensorName) == tensorScale.end());
+            if (DT_I8 != outputTensors[i].get_desc().dt) {
                 continue;
             }
-
-            CHECK_REQUIREMENT(DT_I8 == desc.dt);
-
-            auto opF16 = f16CNN->get_operator_by_index(opIdx);
-            auto outputs = opF16->get_output_tensors();
-
-            TensorDesc outDesc = outputs[i].get_desc();
-            U32 dBytes = tensorNumBytes(outDesc);
-            dBuf.resize(dBytes * NUM_IMAGES_INPUT);
-            std::vector<F32> histogram;
-            F32 last_max = 0;
-            F32 interval = 0;
-
-            U8 *d = dBuf.data();
-
-            for (U32 j = 0; j < images.size(); j++) {
-                for (int index = 0; index < (int)curModelInputTensorNames.size(); index++) {
-                    f16CNN->copy_to_named_input(curModelInputTensorNames[index],
-                        (U8 *)((CpuMemory *)images[j][index].get_memory())->get_ptr());
-                }
-
-                f16CNN->run_till_breakpoint(opIdx);
-                memcpy(d, ((CpuMemory *)outputs[i].get_memory())->get_ptr(), dBytes);
-                d += dBytes;
-
-                if ((j != images.size() - 1) && ((j + 1) % NUM_IMAGES_INPUT != 0)) {
-                    continue;
-                }
-
-                if (j == NUM_IMAGES_INPUT - 1 ||
-                    ((j == images.size() - 1) && (j < NUM_IMAGES_INPUT - 1))) {
-                    UNI_DEBUG_LOG("----------  start getting 1 - %u images output tensors  "
-                                  "----------\n",
-                        j + 1);
-
-                    F16 *ptr_d = (F16 *)dBuf.data();
-                    F32 max = array_maxabs_f16(ptr_d, (I32)(tensorNumElements(outDesc) * (j + 1)));
-                    UNI_DEBUG_LOG("      %f is the maximum value\n", max);
-                    interval = max / BINS;
-                    histogram.resize(BINS, 0.00001f);
-                    //update histogram first time
-                    update_histogram(tensorNumElements(outDesc) * (j + 1), ptr_d, BINS, interval,
-                        histogram.data());
-                    last_max = max;
-                    d = dBuf.data();
-                    dBuf.clear();
-                    continue;
-                }
-
-                if ((j + 1) % NUM_IMAGES_INPUT == 0 && j != (NUM_IMAGES_INPUT - 1)) {
-                    F16 *ptr_d = (F16 *)dBuf.data();
-                    F32 max =
-                        array_maxabs_f16(ptr_d, (I32)tensorNumElements(outDesc) * NUM_IMAGES_INPUT);
-
-                    UNI_DEBUG_LOG("----------  start getting %d - %u images output tensors  "
-                                  "----------\n",
-                        j + 1 - 100, j + 1);
-
-                    if (max <= last_max) {
-                        UNI_DEBUG_LOG("      %f is the maximum value\n", last_max);
-                        interval = last_max / BINS;
-                        //update histogram if no new max
-                        update_histogram(tensorNumElements(outDesc) * NUM_IMAGES_INPUT, ptr_d, BINS,
-                            interval, histogram.data());
-                    } else {
-                        UNI_DEBUG_LOG("      %f is the maximum value\n", max);
-                        interval = max / BINS;
-                        F32 numPerBin = (F32)max / last_max;
-                        //last_max = max;  -> may optimize accuracy
-                        histogram = compress_histogram(histogram, numPerBin, last_max);
-                        last_max = max;
-                        update_histogram(tensorNumElements(outDesc) * NUM_IMAGES_INPUT, ptr_d, BINS,
-                            interval, histogram.data());
-                    }
-                    d = dBuf.data();
-                    dBuf.clear();
-                    continue;
-                }
-
-                if ((j == images.size() - 1) && ((j + 1) % NUM_IMAGES_INPUT != 0)) {
-                    UNI_DEBUG_LOG("----------  start getting %d - %u images output tensors  "
-                                  "----------\n",
-                        j + 1 - ((j + 1) % NUM_IMAGES_INPUT), j + 1);
-                    dBuf.resize(dBytes * ((j + 1) % NUM_IMAGES_INPUT));
-                    F16 *ptr_d = (F16 *)dBuf.data();
-                    F32 max = array_maxabs_f16(
-                        ptr_d, (I32)(tensorNumElements(outDesc) * ((j + 1) % NUM_IMAGES_INPUT)));
-                    if (max <= last_max) {
-                        UNI_DEBUG_LOG("      %f is the maximum value\n", last_max);
-                        interval = last_max / BINS;
-                        //update histogram if no new max
-                        update_histogram(tensorNumElements(outDesc) * ((j + 1) % NUM_IMAGES_INPUT),
-                            ptr_d, BINS, interval, histogram.data());
-                    } else {
-                        UNI_DEBUG_LOG("      %f is the maximum value\n", max);
-                        interval = max / BINS;
-                        F32 numPerBin = (F32)max / last_max;
-                        //last_max = max;  -> may optimize accuracy
-                        histogram = compress_histogram(histogram, numPerBin, last_max);
-                        last_max = max;
-                        update_histogram(tensorNumElements(outDesc) * ((j + 1) % NUM_IMAGES_INPUT),
-                            ptr_d, BINS, interval, histogram.data());
-                    }
-                    d = dBuf.data();
-                    dBuf.clear();
-                    continue;
-                }
-            }
-            UNI_DEBUG_LOG("----------  compute KL  ----------\n");
-            std::vector<F32> scale = compute_scale_with_KL(histogram, interval);
-            UNI_DEBUG_LOG("----------  finish compute KL  ---------\n");
-            scales.push_back(scale);
-            tensorScale[tensorName] = scale;
-            UNI_DEBUG_LOG("    OutputTensor %u %s gets scale %f\n", i, tensorName.c_str(),
-                tensorScale[tensorName][0]);
+            tensorScale[tensorName] = tensorScales[tensorIds[tensorName]];
+            std::cout << "    OutputTensor " << i << " " << tensorName << " gets scale "
+                      << tensorScale[tensorName][0] << std::endl;
+            scales.push_back(tensorScale[tensorName]);
         }
         if (int8Ms.ops[opIdx].num_quant_feature == 1 &&
             -2 == int8Ms.ops[opIdx].feature_scale[0].scale[0]) {
@@ -398,8 +422,6 @@ int main(int argc, char *argv[])
             scales.push_back(outputScale);
         }
 
-        op->set_feature_scale(scales);
-
         // Store scales into result model
         if (nullptr != resultMs.ops[opIdx].feature_scale) {  // Could be labelled with -2
             for (U32 i = 0; i < resultMs.ops[opIdx].num_quant_feature; i++) {
@@ -420,9 +442,6 @@ int main(int argc, char *argv[])
             resultMs.ops[opIdx].feature_scale[i].scale = (F32 *)mt_new_storage(scaleBytes);
             memcpy(resultMs.ops[opIdx].feature_scale[i].scale, scales[i].data(), scaleBytes);
         }
-
-        calibratedOpIdx.push_back(opIdx);
-        opIdx = int8CNN->find_next_dynamic_scale_op(calibratedOpIdx, opIdx);
     }
 
     print_ms(resultMs);
@@ -430,14 +449,13 @@ int main(int argc, char *argv[])
     std::string modelStorePath = std::string(argv[1]);
     auto suffixPos = modelStorePath.find(".bolt");
     modelStorePath.erase(suffixPos, 5);
-    modelStorePath += "_KL.bolt";
+    modelStorePath += "_" + method + ".bolt";
     CHECK_STATUS(serialize_model_to_file(&resultMs, modelStorePath.c_str()));
 
     CHECK_STATUS(mt_destroy_model(&int8Ms));
-    CHECK_STATUS(mt_destroy_model(&f16Ms));
+    CHECK_STATUS(mt_destroy_model(&floatMs));
     resultMs.num_op_tensor_entries = relationNum;
     resultMs.op_relationship_entries = relationPtr;
     CHECK_STATUS(mt_destroy_model(&resultMs));
-#endif
     return 0;
 }
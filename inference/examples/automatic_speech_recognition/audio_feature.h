@@ -14,13 +14,59 @@
 #ifndef AUDIO_FEATURE_H_
 #define AUDIO_FEATURE_H_
 
+#include <fftw3.h>
+#include <map>
+#include <memory>
+#include <string>
 #include <vector>
-#include <complex>
-
-using cd = std::complex<double>;
+#include "tensor.hpp"
 
+// Log mel filter bank features of 16kHz audio. An extractor keeps its FFT plans and buffers,
+// so it is created once and used by one thread, the static functions use one extractor per
+// thread.
 class AudioFeatureExtractor {
 public:
+    AudioFeatureExtractor();
+
+    ~AudioFeatureExtractor();
+
+    // the FFT plans and buffers are not shared
+    AudioFeatureExtractor(const AudioFeatureExtractor &) = delete;
+
+    AudioFeatureExtractor &operator=(const AudioFeatureExtractor &) = delete;
+
+    // streaming interface, appends the samples to the stream and the features of the frames
+    // that they complete to features, returns the number of new frames
+    int push(const short *samples, int num, std::vector<float> &features);
+
+    // clears the samples of the stream
+    void reset();
+
+    // features of nFrames frames of the pre-emphasized signal, frame i starts at sample
+    // i * FRAME_STEP and its samples after length are zero, features is [nFrames][N_FILTERS]
+    void extract(const float *signal, int length, int nFrames, float *features);
+
+    static int getFeatureLength()
+    {
+        return N_FILTERS;
+    }
+
+    static int getFrameStep()
+    {
+        return FRAME_STEP;
+    }
+
+    // frames of a signal of length samples without padding
+    static int getFrameNum(int length)
+    {
+        return (length < W_LENGTH) ? 0 : (length - W_LENGTH) / FRAME_STEP + 1;
+    }
+
+    // the extractor of the calling thread
+    static AudioFeatureExtractor *getThreadExtractor();
+
+    static std::vector<short> readWav(const std::string &wavName);
+
     static std::vector<std::vector<std::vector<float>>> getEncoderInputFromWav(
         std::string wavFilePath);
 
@@ -34,44 +80,44 @@ private:
     static constexpr int N_FFT = 512;     // Num of FFT length
     static constexpr int N_DIM = N_FFT / 2 + 1;
     static constexpr int N_FILTERS = 128;  // N_FILTERS = 41;
+    // frames that are transformed by one FFT call
+    static constexpr int FRAME_BATCH = 16;
+    // spectrums are 32 bytes aligned, so that a frame is also transformed by the plan of one
+    static constexpr int FFT_OUTPUT_STRIDE = (N_DIM + 3) / 4 * 4;
 
-    static constexpr int SAMPLE_RATE = 16000;
-    static constexpr double LOWER_HERZ_FREQ = 0;
-    static constexpr double UPPER_HERZ_FREQ = 8000;
     static constexpr float EPSILON = 2.2204460492503131e-16F;
     static constexpr float LOG_EPSILON = -36.043653389F;
 
-    static constexpr float _MEL_BREAK_FREQUENCY_HERTZ = 700.0F;
-    static constexpr float _MEL_HIGH_FREQUENCY_Q = 1127.0F;
+    void transform(int nFrames, float *features);
 
     static void PreEmphasis(std::vector<short> &signal, short lastPoint, std::vector<float> &output);
 
-    static void SplitToFrames(
-        std::vector<float> &signal, std::vector<std::vector<float>> &output, int nFrames);
-
-    static void CentralPadding(std::vector<float> &signal, std::vector<float> &output);
-
-    static std::vector<float> GetMelBankForSingleFrame(std::vector<float> frame);
-
-    static void AddHammingWindow(std::vector<float> &data);
-
-    static void fft(std::vector<cd> &a, bool invert);
+    static void ComputePowerSpec(const fftwf_complex *fft, float *powerSpec);
 
-    static std::vector<float> ComputePowerSpec(std::vector<double> fft);
+    static void ComputeLogMel(const float *powerSpec, float *melSpec);
 
     static std::vector<float> GetHammingWindow(bool periodic);
 
-    static std::vector<std::vector<float>> GetLinearToMelMatrix();
-
-    static std::vector<double> LineSpace(double lower, double upper, int number);
-
-    static std::vector<double> HerzToMel(std::vector<double> herzVec);
-
-    static double HerzToMel(double herz);
-
     static int getWavHead(FILE *file);
 
-    static std::vector<short> readWav(const std::string &wavName);
+    // hamming window in the middle of the N_FFT points, the others are zero
+    std::vector<float> window;
+    // FRAME_BATCH windowed frames and their spectrums
+    float *fftInput;
+    fftwf_complex *fftOutput;
+    fftwf_plan singlePlan;
+    fftwf_plan batchPlan;
+    std::vector<float> powerSpec;
+    // pre-emphasized samples of the stream that have not been framed
+    std::vector<float> stream;
+    short lastPoint;
 };
 
+// Flow preprocess function, parameter[1] is the input of the samples (default "audio") and
+// parameter[2] is the output of the features (default "sounds", [1, frames, N_FILTERS])
+EE audioFeaturePreProcess(std::map<std::string, std::shared_ptr<Tensor>> &inputs,
+    std::shared_ptr<Tensor> &tmp,
+    std::map<std::string, std::shared_ptr<Tensor>> &outputs,
+    std::vector<std::string> parameter = std::vector<std::string>());
+
 #endif  // AUDIO_FEATURE_H_
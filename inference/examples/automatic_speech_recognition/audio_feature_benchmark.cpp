@@ -0,0 +1,72 @@
+// Copyright (C) 2019. Huawei Technologies Co., Ltd. All rights reserved.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include <iostream>
+#include "audio_feature.h"
+#include "ut_util.h"
+
+// throughput of the log mel features of a 16kHz wav, computed for the whole signal at once and
+// streamed in pieces of one frame step
+int main(int argc, char *argv[])
+{
+    if (argc < 2) {
+        UNI_ERROR_LOG("usage: %s wav_file [loops]\n", argv[0]);
+        return 1;
+    }
+    std::string wavFilePath = argv[1];
+    int loops = (argc > 2) ? atoi(argv[2]) : 10;
+    std::vector<short> signal = AudioFeatureExtractor::readWav(wavFilePath);
+    std::vector<short> lastPoints(10);
+    int step = AudioFeatureExtractor::getFrameStep();
+    int featureLength = AudioFeatureExtractor::getFeatureLength();
+
+    // the first call creates the extractor of this thread, FFTW_MEASURE planning is not timed
+    std::vector<std::vector<std::vector<float>>> feature =
+        AudioFeatureExtractor::getEncoderInput(signal, lastPoints, false);
+    double timeStart = ut_time_ms();
+    for (int i = 0; i < loops; i++) {
+        feature = AudioFeatureExtractor::getEncoderInput(signal, lastPoints, false);
+    }
+    double timeEnd = ut_time_ms();
+    int frames = feature[0].size();
+    double batchTime = (timeEnd - timeStart) / loops;
+
+    AudioFeatureExtractor extractor;
+    std::vector<float> stream;
+    timeStart = ut_time_ms();
+    for (int i = 0; i < loops; i++) {
+        extractor.reset();
+        stream.clear();
+        for (int j = 0; j < (int)signal.size(); j += step) {
+            extractor.push(signal.data() + j, UNI_MIN(step, (int)signal.size() - j), stream);
+        }
+    }
+    timeEnd = ut_time_ms();
+    double streamTime = (timeEnd - timeStart) / loops;
+
+    // the frames are transformed by different FFT plans
+    F32 maxDiff = 0;
+    CHECK_REQUIREMENT((int)stream.size() == frames * featureLength);
+    for (int i = 0; i < frames; i++) {
+        for (int j = 0; j < featureLength; j++) {
+            maxDiff = UNI_MAX(maxDiff, fabs(feature[0][i][j] - stream[i * featureLength + j]));
+        }
+    }
+    std::cout << "[RESULT] frames: " << frames << ", max difference of stream: " << maxDiff
+              << std::endl;
+    std::cout << "[PROFILE] batch: " << batchTime << " ms, " << frames * 1000.0 / batchTime
+              << " frames/s" << std::endl;
+    std::cout << "[PROFILE] stream: " << streamTime << " ms, " << frames * 1000.0 / streamTime
+              << " frames/s" << std::endl;
+    return 0;
+}
@@ -760,11 +760,11 @@ int main(int argc, char *argv[])
     flowRegisterFunction("jointInferOutputSize", jointInferOutputSize);
     flowRegisterFunction("pinyin2hanziInferOutputSize", pinyin2hanziInferOutputSize);
     flowRegisterFunction("pinyin2hanziPreProcess", pinyin2hanziPreProcess);
+    flowRegisterFunction("audioFeaturePreProcess", audioFeaturePreProcess);
 
     std::string wavFilePath = argv[6];
-    AudioFeatureExtractor audioFeatureExtractor;
     std::vector<std::vector<std::vector<float>>> feature =
-        audioFeatureExtractor.getEncoderInputFromWav(wavFilePath);
+        AudioFeatureExtractor::getEncoderInputFromWav(wavFilePath);
 
     std::string encoderGraphPath = argv[1];
     std::string predictionGraphPath = argv[2];
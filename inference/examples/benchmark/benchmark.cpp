@@ -14,6 +14,7 @@
 #include <iostream>
 #include <getopt.h>
 #include "inference.hpp"
+#include "batch_runner.hpp"
 #include "data_loader.hpp"
 
 char *modelPath = (char *)"";
@@ -22,12 +23,17 @@ char *affinityPolicyName = (char *)"CPU_AFFINITY_HIGH_PERFORMANCE";
 char *algorithmMapPath = (char *)"";
 int loopTime = 1;
 int warmUp = 10;
+int threadsNum = 0;
+int batchSize = 0;
+int branchNum = 0;
+char *tracePath = (char *)"";
 
 void print_benchmark_usage()
 {
     std::cout << "benchmark usage: (<> must be filled in with exact value; [] is optional)\n"
                  "./benchmark -m <boltModelPath> -i [inputDataPath] -a [affinityPolicyName] -p "
-                 "[algorithmMapPath] -l [loopTime]\n"
+                 "[algorithmMapPath] -l [loopTime] -t [threadsNum] -b [batchSize] -g [branchNum] "
+                 "-f [tracePath]\n"
                  "\nParameter description:\n"
                  "1. -m <boltModelPath>: The path where .bolt is stored.\n"
                  "2. -i [inputDataPath]: The input data absolute path. If not input the option, "
@@ -38,6 +44,16 @@ void print_benchmark_usage()
                  "4. -p [algorithmMapPath]: The algorithm configration path.\n"
                  "5. -l [loopTime]: The running loopTimes.\n"
                  "6. -w [warmUp]: WarmUp times. The default value is 10.\n"
+                 "7. -t [threadsNum]: The number of CPU threads used by each inference. If it is "
+                 "set, the time of 1 to threadsNum threads will also be reported.\n"
+                 "8. -b [batchSize]: If it is set, batchSize threads also send loopTime requests "
+                 "each through the batching front end, which runs up to batchSize requests in one "
+                 "inference, and the throughput is reported.\n"
+                 "9. -g [branchNum]: The number of independent operators that run at the same "
+                 "time on CPU, the threads are shared among them. The default value is 1.\n"
+                 "10. -f [tracePath]: If it is set, loopTime more inferences are profiled, the "
+                 "time, GFLOP/s and GB/s of each operator type are reported, and every operator "
+                 "run is written to tracePath in Chrome trace format.\n"
                  "Example: ./benchmark -m /local/models/resnet50_f16.bolt"
               << std::endl;
 }
@@ -55,7 +71,7 @@ void parse_options(int argc, char *argv[])
     }
 
     int option;
-    const char *optionstring = "m:i:a:p:l:w:";
+    const char *optionstring = "m:i:a:p:l:w:t:b:g:f:";
     while ((option = getopt(argc, argv, optionstring)) != -1) {
         switch (option) {
             case 'm':
@@ -82,6 +98,22 @@ void parse_options(int argc, char *argv[])
                 std::cout << "option is -w [warmUp], value is: " << optarg << std::endl;
                 warmUp = atoi(optarg);
                 break;
+            case 't':
+                std::cout << "option is -t [threadsNum], value is: " << optarg << std::endl;
+                threadsNum = atoi(optarg);
+                break;
+            case 'b':
+                std::cout << "option is -b [batchSize], value is: " << optarg << std::endl;
+                batchSize = atoi(optarg);
+                break;
+            case 'g':
+                std::cout << "option is -g [branchNum], value is: " << optarg << std::endl;
+                branchNum = atoi(optarg);
+                break;
+            case 'f':
+                std::cout << "option is -f [tracePath], value is: " << optarg << std::endl;
+                tracePath = optarg;
+                break;
             default:
                 std::cout << "Input option gets error, please check the params meticulously.\n";
                 print_benchmark_usage();
@@ -148,6 +180,21 @@ std::map<std::string, std::shared_ptr<Tensor>> get_output(
     return outMap;
 }
 
+struct BatchClient {
+    BatchRunner *runner;
+    std::map<std::string, const U8 *> inputs;
+    std::map<std::string, U8 *> outputs;
+};
+
+void *batch_client(void *arg)
+{
+    BatchClient *client = (BatchClient *)arg;
+    for (int i = 0; i < loopTime; i++) {
+        CHECK_STATUS(client->runner->run(client->inputs, client->outputs));
+    }
+    return NULL;
+}
+
 int main(int argc, char *argv[])
 {
     UNI_TIME_INIT
@@ -155,6 +202,12 @@ int main(int argc, char *argv[])
 
     // 1: set up the pipeline
     auto pipeline = createPipeline(affinityPolicyName, modelPath, algorithmMapPath);
+    if (threadsNum > 0) {
+        pipeline->set_num_threads(threadsNum);
+    }
+    if (branchNum > 1) {
+        pipeline->set_parallel_branches(branchNum);
+    }
 
     // 2: create input data and feed the pipeline with it
     auto model_tensors_input = create_tensors_from_path(inputData, pipeline);
@@ -180,6 +233,77 @@ int main(int argc, char *argv[])
     // 4: process result
     print_result(outMap);
 
+    // 5: profile every operator, the profiled runs are not in the total time
+    if (std::string(tracePath) != "") {
+        runtime_profile_clear();
+        runtime_profile_set_enable(true);
+        for (int i = 0; i < loopTime; i++) {
+            pipeline->set_input_tensors_value(model_tensors_input);
+            pipeline->run();
+            get_output(pipeline, affinityPolicyName);
+        }
+        runtime_profile_set_enable(false);
+        std::cout << "\nOperator Profile:\n";
+        runtime_profile_summary();
+        CHECK_STATUS(runtime_profile_dump_chrome_trace(tracePath));
+    }
+
+    // 6: measure the scalability from 1 to threadsNum threads
+    if (threadsNum > 1) {
+        std::cout << "\nThreads Scaling:\n";
+        double baseTime = 0;
+        for (int threads = 1; threads <= threadsNum; threads++) {
+            pipeline->set_num_threads(threads);
+            for (int i = 0; i < warmUp; i++) {
+                pipeline->set_input_tensors_value(model_tensors_input);
+                pipeline->run();
+            }
+            double scaleBegin = ut_time_ms();
+            for (int i = 0; i < loopTime; i++) {
+                pipeline->set_input_tensors_value(model_tensors_input);
+                pipeline->run();
+                get_output(pipeline, affinityPolicyName);
+            }
+            double avgTime = (ut_time_ms() - scaleBegin) / loopTime;
+            if (threads == 1) {
+                baseTime = avgTime;
+            }
+            UNI_CI_LOG("threads:%d avg_time:%fms/data speedup:%f\n", threads, avgTime,
+                baseTime / avgTime);
+        }
+        pipeline->set_num_threads(threadsNum);
+    }
+
+    // 7: measure the throughput of batchSize clients through the batching front end
+    if (batchSize > 1) {
+        std::vector<std::shared_ptr<U8>> buffers;
+        std::vector<BatchClient> clients(batchSize);
+        BatchRunner runner(pipeline.get(), batchSize, 1000);
+        for (int i = 0; i < batchSize; i++) {
+            clients[i].runner = &runner;
+            for (auto iter : model_tensors_input) {
+                clients[i].inputs[iter.first] = iter.second.get();
+            }
+            for (auto iter : outMap) {
+                std::shared_ptr<U8> buffer((U8 *)operator new(iter.second->bytes()));
+                buffers.push_back(buffer);
+                clients[i].outputs[iter.first] = buffer.get();
+            }
+        }
+        std::vector<pthread_t> threads(batchSize);
+        double batchBegin = ut_time_ms();
+        for (int i = 0; i < batchSize; i++) {
+            pthread_create(&threads[i], NULL, batch_client, &clients[i]);
+        }
+        for (int i = 0; i < batchSize; i++) {
+            pthread_join(threads[i], NULL);
+        }
+        double batchTime = ut_time_ms() - batchBegin;
+        UNI_CI_LOG("batch:%d throughput:%f data/s, without batching:%f data/s\n",
+            runner.get_max_batch(), 1000.0 * batchSize * loopTime / batchTime,
+            1000.0 * loopTime / totalTime);
+    }
+
     UNI_TIME_STATISTICS
     UNI_CI_LOG("total_time:%fms(loops=%d)\n", 1.0 * totalTime, loopTime);
     UNI_CI_LOG("avg_time:%fms/data\n", 1.0 * totalTime / loopTime);
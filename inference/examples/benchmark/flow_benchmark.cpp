@@ -0,0 +1,140 @@
+// Copyright (C) 2019. Huawei Technologies Co., Ltd. All rights reserved.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include <iostream>
+#include <algorithm>
+#include "task.h"
+#include "flow.h"
+
+// the flow graph only contains a tiny post process node, so that the cost of
+// task dispatch and completion notification dominates the measurement.
+EE benchmarkInferOutputSize(std::map<std::string, std::shared_ptr<Tensor>> &inputs,
+    std::shared_ptr<Tensor> &tmp,
+    std::map<std::string, std::shared_ptr<Tensor>> &outputs,
+    std::vector<std::string> parameter = std::vector<std::string>())
+{
+    TensorDesc inputDesc = inputs["benchmark_input"]->get_desc();
+    outputs["benchmark_output"]->resize(inputDesc);
+    return SUCCESS;
+}
+
+EE benchmarkWork(std::map<std::string, std::shared_ptr<Tensor>> &inputs,
+    std::shared_ptr<Tensor> &tmp,
+    std::map<std::string, std::shared_ptr<Tensor>> &outputs,
+    std::vector<std::string> parameter = std::vector<std::string>())
+{
+    int loops = 1;
+    if (parameter.size() > 1) {
+        loops = atoi(parameter[1].c_str());
+    }
+    TensorDesc desc = inputs["benchmark_input"]->get_desc();
+    U32 length = tensorNumElements(desc);
+    F32 *input = (F32 *)((CpuMemory *)inputs["benchmark_input"]->get_memory())->get_ptr();
+    F32 *output = (F32 *)((CpuMemory *)outputs["benchmark_output"]->get_memory())->get_ptr();
+    for (U32 i = 0; i < length; i++) {
+        output[i] = input[i];
+    }
+    for (int j = 0; j < loops; j++) {
+        for (U32 i = 0; i < length; i++) {
+            output[i] = output[i] * 0.5f + input[i];
+        }
+    }
+    return SUCCESS;
+}
+
+std::map<std::string, std::shared_ptr<Tensor>> inputOutput()
+{
+    std::map<std::string, std::shared_ptr<Tensor>> tensors;
+    TensorDesc desc = tensor2df(DT_F32, DF_NORMAL, 1, 256);
+    tensors["benchmark_input"] = std::shared_ptr<Tensor>(new Tensor());
+    tensors["benchmark_input"]->resize(desc);
+    tensors["benchmark_input"]->alloc();
+    F32 *input = (F32 *)((CpuMemory *)tensors["benchmark_input"]->get_memory())->get_ptr();
+    for (U32 i = 0; i < tensorNumElements(desc); i++) {
+        input[i] = i % 7;
+    }
+    tensors["benchmark_output"] = std::shared_ptr<Tensor>(new Tensor());
+    tensors["benchmark_output"]->resize(desc);
+    tensors["benchmark_output"]->alloc();
+    return tensors;
+}
+
+void print_flow_benchmark_usage()
+{
+    std::cout << "flow_benchmark usage: (<> must be filled in with exact value; [] is optional)\n"
+                 "./flow_benchmark <graphPath> [taskNum] [threadsNum]\n"
+                 "\nParameter description:\n"
+                 "1. <graphPath>: The flow graph prototxt, such as flow_benchmark.prototxt.\n"
+                 "2. [taskNum]: The number of tasks. The default value is 10000.\n"
+                 "3. [threadsNum]: The number of schedule worker threads. The default value is 2.\n"
+              << std::endl;
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2) {
+        print_flow_benchmark_usage();
+        return 1;
+    }
+    std::string graphPath = argv[1];
+    int taskNum = 10000;
+    int threads = 2;
+    if (argc > 2) {
+        taskNum = atoi(argv[2]);
+    }
+    if (argc > 3) {
+        threads = atoi(argv[3]);
+    }
+    flowRegisterFunction("benchmarkInferOutputSize", benchmarkInferOutputSize);
+    flowRegisterFunction("benchmarkWork", benchmarkWork);
+
+    Flow flowExample;
+    flowExample.init({graphPath}, DT_F32, AFFINITY_CPU_HIGH_PERFORMANCE, threads, false);
+
+    std::vector<std::map<std::string, std::shared_ptr<Tensor>>> data(taskNum);
+    for (int i = 0; i < taskNum; i++) {
+        data[i] = inputOutput();
+    }
+
+    // throughput, all tasks are submitted at once
+    double timeStart = ut_time_ms();
+    for (int i = 0; i < taskNum; i++) {
+        Task task(i, graphPath, data[i]);
+        flowExample.enqueue(task);
+    }
+    std::vector<Task> results = flowExample.dequeue(true);
+    double timeEnd = ut_time_ms();
+    CHECK_REQUIREMENT((int)results.size() == taskNum);
+    double throughput = taskNum / (timeEnd - timeStart) * 1000;
+
+    // latency, one task is in flight at a time
+    int latencyNum = UNI_MAX(taskNum / 10, 1);
+    std::vector<double> latency(latencyNum);
+    for (int i = 0; i < latencyNum; i++) {
+        Task task(i, graphPath, data[i]);
+        timeStart = ut_time_ms();
+        flowExample.enqueue(task);
+        results = flowExample.dequeue(true);
+        latency[i] = ut_time_ms() - timeStart;
+    }
+    std::sort(latency.begin(), latency.end());
+    double sum = 0;
+    for (int i = 0; i < latencyNum; i++) {
+        sum += latency[i];
+    }
+
+    UNI_CI_LOG("tasks:%d threads:%d throughput:%f tasks/s\n", taskNum, threads, throughput);
+    UNI_CI_LOG("latency avg:%fms p50:%fms p99:%fms\n", sum / latencyNum, latency[latencyNum / 2],
+        latency[UNI_MIN((int)(latencyNum * 0.99), latencyNum - 1)]);
+    return 0;
+}
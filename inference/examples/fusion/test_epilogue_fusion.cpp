@@ -0,0 +1,154 @@
+// Copyright (C) 2019. Huawei Technologies Co., Ltd. All rights reserved.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#include <string.h>
+#include "inference.hpp"
+#include "ut_util.h"
+
+// The model is fc1 -> relu, fc2 -> eltwise sum with the input of fc2 -> relu and fc3 -> gelu.
+// When the outputs of the fully connected layers are also model outputs, they can not be fused,
+// which gives the reference.
+static void create_model(ModelSpec *ms, U32 m, U32 k, U32 n, bool fuse)
+{
+    CHECK_STATUS(mt_create_model(ms));
+    str_copy(ms->model_name, "epilogue", strlen("epilogue"));
+    ms->dt = DT_F32;
+    ms->num_inputs = 1;
+    ms->input_names = (I8 **)mt_new_storage(sizeof(I8 *));
+    ms->input_names[0] = (I8 *)mt_new_storage(NAME_LEN);
+    str_copy(ms->input_names[0], "data", strlen("data"));
+    ms->input_dims = (TensorDesc *)mt_new_storage(sizeof(TensorDesc));
+    ms->input_dims[0] = tensor2df(DT_F32, DF_NORMAL, m, k);
+
+    std::vector<std::string> outputs = {"prob"};
+    if (!fuse) {
+        outputs.insert(outputs.end(), {"fc1", "fc2", "fc3"});
+    }
+    ms->num_outputs = outputs.size();
+    ms->output_names = (I8 **)mt_new_storage(sizeof(I8 *) * outputs.size());
+    for (U32 i = 0; i < outputs.size(); i++) {
+        ms->output_names[i] = (I8 *)mt_new_storage(NAME_LEN);
+        str_copy(ms->output_names[i], outputs[i].c_str(), outputs[i].length());
+    }
+
+    // name, type, inputs and output
+    std::vector<std::vector<std::string>> ops = {{"fc1", "FC", "data", "fc1"},
+        {"relu1", "Relu", "fc1", "relu1"}, {"fc2", "FC", "relu1", "fc2"},
+        {"add2", "Eltwise", "fc2", "relu1", "add2"}, {"relu2", "Relu", "add2", "relu2"},
+        {"fc3", "FC", "relu2", "fc3"}, {"gelu3", "Gelu", "fc3", "prob"}};
+    std::vector<U32> weightK = {k, n, n};
+    ms->num_operator_specs = ops.size();
+    ms->ops = (OperatorSpec *)mt_new_storage(sizeof(OperatorSpec) * ops.size());
+    ms->num_weight_specs = weightK.size();
+    ms->ws = (WeightSpec *)mt_new_storage(sizeof(WeightSpec) * weightK.size());
+    srand(1);
+    for (U32 i = 0, w = 0; i < ops.size(); i++) {
+        std::vector<std::string> &op = ops[i];
+        OperatorType type = OT_FC;
+        if (op[1] == "Relu") {
+            type = OT_Relu;
+        } else if (op[1] == "Eltwise") {
+            type = OT_Eltwise;
+        } else if (op[1] == "Gelu") {
+            type = OT_Gelu;
+        }
+        U32 num_inputs = op.size() - 3;
+        ms->ops[i] = mt_create_operator(op[0].c_str(), type, num_inputs, 1);
+        for (U32 j = 0; j < num_inputs; j++) {
+            str_copy(ms->ops[i].input_tensors_name[j], op[2 + j].c_str(), op[2 + j].length());
+        }
+        str_copy(ms->ops[i].output_tensors_name[0], op.back().c_str(), op.back().length());
+        // -1 means that the tensor does not reuse the memory of others
+        ms->ops[i].tensor_positions = (I32 *)mt_new_storage((num_inputs + 1) * sizeof(I32));
+        for (U32 j = 0; j <= num_inputs; j++) {
+            ms->ops[i].tensor_positions[j] = -1;
+        }
+        ParameterSpec *ps = &(ms->ops[i].ps);
+        initialization_zero(ps, sizeof(ParameterSpec));
+        if (type == OT_FC) {
+            ps->fc_spec.num_outputs = n;
+            ps->fc_spec.num_slices = 1;
+            ps->fc_spec.slice_point[0] = n;
+            ms->ws[w] = mt_create_weight(op[0].c_str(), DT_F32, weightK[w] * n * bytesOf(DT_F32),
+                n * bytesOf(DT_F32), 0);
+            F32 *weight = (F32 *)ms->ws[w].weight;
+            for (U32 j = 0; j < weightK[w] * n; j++) {
+                weight[j] = (rand() % 2000 - 1000) / 1000.0 / sqrt(weightK[w]);
+            }
+            F32 *bias = (F32 *)ms->ws[w].vec;
+            for (U32 j = 0; j < n; j++) {
+                bias[j] = (rand() % 2000 - 1000) / 1000.0;
+            }
+            w++;
+        } else if (type == OT_Eltwise) {
+            ps->eltwise_spec.elt_mode = ELTWISE_SUM;
+            ps->eltwise_spec.activation_type = ACTIVATION_NULL;
+        }
+    }
+}
+
+static std::vector<F32> run_model(U32 m, U32 k, U32 n, bool fuse, U32 *validOps)
+{
+    ModelSpec ms;
+    create_model(&ms, m, k, n, fuse);
+    auto pipeline = createPipelinefromMs("CPU_AFFINITY_HIGH_PERFORMANCE", &ms, "");
+    *validOps = 0;
+    for (I32 i = 0; i < ms.num_operator_specs; i++) {
+        if (ms.ops[i].type != OT_None) {
+            (*validOps)++;
+        }
+    }
+    CHECK_STATUS(mt_destroy_model(&ms));
+
+    U32 length = m * k;
+    std::shared_ptr<U8> data((U8 *)operator new(length * bytesOf(DT_F32)));
+    F32 *input = (F32 *)data.get();
+    for (U32 i = 0; i < length; i++) {
+        input[i] = (rand() % 2000 - 1000) / 1000.0;
+    }
+    std::map<std::string, std::shared_ptr<U8>> inputs;
+    inputs["data"] = data;
+    pipeline->set_input_tensors_value(inputs);
+    pipeline->run();
+    Tensor output = pipeline->get_tensor_by_name("prob");
+    std::vector<F32> result(output.length());
+    for (U32 i = 0; i < result.size(); i++) {
+        result[i] = output.element(i);
+    }
+    return result;
+}
+
+int main(int argc, char *argv[])
+{
+    U32 k = (argc > 1) ? atoi(argv[1]) : 96;
+    U32 n = (argc > 2) ? atoi(argv[2]) : 72;
+    // 1 row goes through the matrix vector multiplication
+    for (U32 m : {1, 24}) {
+        U32 fusedOps, unfusedOps;
+        std::vector<F32> fused = run_model(m, k, n, true, &fusedOps);
+        std::vector<F32> unfused = run_model(m, k, n, false, &unfusedOps);
+#ifdef _USE_X86
+        // the activations and the eltwise are fused into the fully connected layers
+        if (fusedOps != 3 || unfusedOps != 7) {
+            UNI_ERROR_LOG("%u operators are left after fusion, %u without it\n", fusedOps,
+                unfusedOps);
+        }
+#endif
+        CHECK_REQUIREMENT(fused.size() == unfused.size() && fused.size() == m * n);
+        ut_check_v(fused.data(), unfused.data(), fused.size(), DT_F32, 1e-5, __FILE__, __LINE__);
+        UNI_INFO_LOG("epilogue fusion of %u x %u x %u: %u operators instead of %u\n", m, k, n,
+            fusedOps, unfusedOps);
+    }
+    return 0;
+}
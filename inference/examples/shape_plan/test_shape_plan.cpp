@@ -0,0 +1,174 @@
+// Copyright (C) 2019. Huawei Technologies Co., Ltd. All rights reserved.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#include <string.h>
+#include "inference.hpp"
+#include "ut_util.h"
+
+// The model is fc1 -> relu1 -> fc2 -> softmax2 -> fc3, the number of rows of the input is the
+// sequence length. The hidden tensors reuse two storage positions, so they are in the arena.
+static void create_model(ModelSpec *ms, U32 m, U32 k, U32 n)
+{
+    CHECK_STATUS(mt_create_model(ms));
+    str_copy(ms->model_name, "shape_plan", strlen("shape_plan"));
+    ms->dt = DT_F32;
+    ms->num_inputs = 1;
+    ms->input_names = (I8 **)mt_new_storage(sizeof(I8 *));
+    ms->input_names[0] = (I8 *)mt_new_storage(NAME_LEN);
+    str_copy(ms->input_names[0], "data", strlen("data"));
+    ms->input_dims = (TensorDesc *)mt_new_storage(sizeof(TensorDesc));
+    ms->input_dims[0] = tensor2df(DT_F32, DF_NORMAL, m, k);
+    ms->num_outputs = 1;
+    ms->output_names = (I8 **)mt_new_storage(sizeof(I8 *));
+    ms->output_names[0] = (I8 *)mt_new_storage(NAME_LEN);
+    str_copy(ms->output_names[0], "prob", strlen("prob"));
+
+    // name, type, input, output and the storage position of the output
+    std::vector<std::vector<std::string>> ops = {{"fc1", "FC", "data", "fc1", "0"},
+        {"relu1", "Relu", "fc1", "relu1", "1"}, {"fc2", "FC", "relu1", "fc2", "0"},
+        {"softmax2", "Softmax", "fc2", "softmax2", "1"}, {"fc3", "FC", "softmax2", "prob", "-1"}};
+    std::vector<U32> weightK = {k, n, n};
+    ms->num_operator_specs = ops.size();
+    ms->ops = (OperatorSpec *)mt_new_storage(sizeof(OperatorSpec) * ops.size());
+    ms->num_weight_specs = weightK.size();
+    ms->ws = (WeightSpec *)mt_new_storage(sizeof(WeightSpec) * weightK.size());
+    srand(1);
+    for (U32 i = 0, w = 0; i < ops.size(); i++) {
+        std::vector<std::string> &op = ops[i];
+        OperatorType type = OT_FC;
+        if (op[1] == "Relu") {
+            type = OT_Relu;
+        } else if (op[1] == "Softmax") {
+            type = OT_Softmax;
+        }
+        ms->ops[i] = mt_create_operator(op[0].c_str(), type, 1, 1);
+        str_copy(ms->ops[i].input_tensors_name[0], op[2].c_str(), op[2].length());
+        str_copy(ms->ops[i].output_tensors_name[0], op[3].c_str(), op[3].length());
+        ms->ops[i].tensor_positions = (I32 *)mt_new_storage(2 * sizeof(I32));
+        ms->ops[i].tensor_positions[0] = (i == 0) ? -1 : atoi(ops[i - 1][4].c_str());
+        ms->ops[i].tensor_positions[1] = atoi(op[4].c_str());
+        ParameterSpec *ps = &(ms->ops[i].ps);
+        initialization_zero(ps, sizeof(ParameterSpec));
+        if (type == OT_FC) {
+            ps->fc_spec.num_outputs = n;
+            ps->fc_spec.num_slices = 1;
+            ps->fc_spec.slice_point[0] = n;
+            ms->ws[w] = mt_create_weight(op[0].c_str(), DT_F32, weightK[w] * n * bytesOf(DT_F32),
+                n * bytesOf(DT_F32), 0);
+            F32 *weight = (F32 *)ms->ws[w].weight;
+            for (U32 j = 0; j < weightK[w] * n; j++) {
+                weight[j] = (rand() % 2000 - 1000) / 1000.0 / sqrt(weightK[w]);
+            }
+            F32 *bias = (F32 *)ms->ws[w].vec;
+            for (U32 j = 0; j < n; j++) {
+                bias[j] = (rand() % 2000 - 1000) / 1000.0;
+            }
+            w++;
+        } else if (type == OT_Softmax) {
+            ps->softmax_spec.axis = -1;
+        }
+    }
+}
+
+static std::shared_ptr<U8> create_input(U32 m, U32 k)
+{
+    std::shared_ptr<U8> data((U8 *)operator new(m * k * bytesOf(DT_F32)));
+    F32 *input = (F32 *)data.get();
+    for (U32 i = 0; i < m * k; i++) {
+        input[i] = ((i * 37 + m) % 2000 - 1000.0) / 1000.0;
+    }
+    return data;
+}
+
+static std::vector<F32> run_model(std::shared_ptr<CNN> pipeline, std::shared_ptr<U8> data)
+{
+    std::map<std::string, std::shared_ptr<U8>> inputs;
+    inputs["data"] = data;
+    pipeline->set_input_tensors_value(inputs);
+    pipeline->run();
+    Tensor output = pipeline->get_tensor_by_name("prob");
+    std::vector<F32> result(output.length());
+    for (U32 i = 0; i < result.size(); i++) {
+        result[i] = output.element(i);
+    }
+    return result;
+}
+
+// the hidden tensors point into the arena, so the memory that owns them is the arena
+static std::shared_ptr<U8> get_arena(std::shared_ptr<CNN> pipeline)
+{
+    Tensor tensor = pipeline->get_tensor_by_name("relu1");
+    return ((CpuMemory *)tensor.get_memory())->get_shared_ptr();
+}
+
+static bool is_same_arena(std::shared_ptr<U8> a, std::shared_ptr<U8> b)
+{
+    return !a.owner_before(b) && !b.owner_before(a);
+}
+
+int main(int argc, char *argv[])
+{
+    U32 k = (argc > 1) ? atoi(argv[1]) : 64;
+    U32 n = (argc > 2) ? atoi(argv[2]) : 48;
+    // the sequence lengths alternate and grow, the largest one comes early, and the shapes seen
+    // after it are partly new and partly planned before. One row is left out, because the fully
+    // connected layers transform their weights for the matrix vector multiplication in ready.
+    std::vector<U32> lengths = {8, 64, 8, 64, 16, 8, 33, 64, 16, 2, 33, 8};
+    U32 largest = 1;
+
+    std::map<U32, std::vector<F32>> references;
+    for (U32 m : lengths) {
+        if (references.find(m) == references.end()) {
+            ModelSpec ms;
+            create_model(&ms, m, k, n);
+            auto pipeline = createPipelinefromMs("CPU_AFFINITY_HIGH_PERFORMANCE", &ms, "");
+            CHECK_STATUS(mt_destroy_model(&ms));
+            references[m] = run_model(pipeline, create_input(m, k));
+        }
+    }
+
+    ModelSpec ms;
+    create_model(&ms, lengths[0], k, n);
+    auto pipeline = createPipelinefromMs("CPU_AFFINITY_HIGH_PERFORMANCE", &ms, "");
+    CHECK_STATUS(mt_destroy_model(&ms));
+    std::shared_ptr<U8> arena;
+    U32 reallocations = 0;
+    for (U32 i = 0; i < lengths.size(); i++) {
+        U32 m = lengths[i];
+        if (i > 0) {
+            std::map<std::string, TensorDesc> inputDescs;
+            inputDescs["data"] = tensor2df(DT_F32, DF_NORMAL, m, k);
+            pipeline->reready(inputDescs);
+        }
+        std::vector<F32> result = run_model(pipeline, create_input(m, k));
+        CHECK_REQUIREMENT(result.size() == m * n);
+        ut_check_v(result.data(), references[m].data(), result.size(), DT_F32, 1e-5, __FILE__,
+            __LINE__);
+
+        // the arena only changes when a shape larger than all before it does not fit in it
+        std::shared_ptr<U8> current = get_arena(pipeline);
+        if (arena != nullptr && !is_same_arena(arena, current)) {
+            reallocations++;
+            if (m <= largest) {
+                UNI_ERROR_LOG("the arena is allocated again for the sequence length %u after %u\n",
+                    m, largest);
+            }
+        }
+        arena = current;
+        largest = UNI_MAX(largest, m);
+    }
+    UNI_INFO_LOG("%u input shapes of %u rows at most, the arena is allocated again %u times\n",
+        (U32)references.size(), largest, reallocations);
+    return 0;
+}
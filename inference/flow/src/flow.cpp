@@ -40,8 +40,9 @@ void Flow::enqueue(Task task)
         UNI_ERROR_LOG("task is not ready to add queue\n");
     }
     std::shared_ptr<Task> taskPtr = std::shared_ptr<Task>(new Task(&task));
-    this->tasks.emplace(taskPtr);
-    this->schedule.enqueue(taskPtr.get());
+    if (this->schedule.enqueue(taskPtr.get()) == 0) {
+        this->tasks.emplace(taskPtr);
+    }
     UNI_DEBUG_LOG("user enqueues task: end\n");
 }
 
@@ -51,19 +52,19 @@ std::vector<Task> Flow::dequeue(bool block)
     if (this->tasks.size() == 0) {
         return outputs;
     }
-    for (;;) {
-        if (this->tasks.size() == 0) {
-            break;
-        }
+    while (this->tasks.size() > 0) {
         auto task = this->tasks.front();
-        if (task->status == TASK_END) {
-            outputs.push_back(*task.get());
-            this->tasks.pop();
+        bool finished;
+        if (block) {
+            finished = this->schedule.wait(task.get());
         } else {
-            if (!block) {
-                break;
-            }
+            finished = this->schedule.finished(task.get());
+        }
+        if (!finished) {
+            break;
         }
+        outputs.push_back(*task.get());
+        this->tasks.pop();
     }
     if (outputs.size() > 0) {
         UNI_DEBUG_LOG("user get result (num=%d) end\n", (int)outputs.size());
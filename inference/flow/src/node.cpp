@@ -93,7 +93,8 @@ void Node::setTmpBuffer(std::shared_ptr<Tensor> tmpTensor)
 
 void Node::initInference(AffinityPolicy affinityPolicy)
 {
-    if (this->inferenceParameter.size() == 0) {
+    if (this->inferenceParameter.size() == 0 ||
+        this->inferenceParameter[0] == std::string("NULL")) {
         UNI_DEBUG_LOG("node %s has no inference\n", this->nodeParameter.name().c_str());
         return;
     }
@@ -106,7 +107,7 @@ void Node::initInference(AffinityPolicy affinityPolicy)
         this->nodeParameter.name().c_str(), this->precision, affinityPolicy, algorithmMapPath,
         modelPath.c_str());
     ModelSpec ms;
-    CHECK_STATUS(deserialize_model_from_file(modelPath.c_str(), &ms));
+    CHECK_STATUS(deserialize_model_from_file(modelPath.c_str(), &ms, false, true));
     CNN cnn(affinityPolicy, precision, ms.model_name);
     cnn.sort_operators_sequential(&ms);
     cnn.initialize_ops(&ms);
@@ -147,7 +148,8 @@ void Node::setRuntime(int cpuId, Arch arch)
 {
     UNI_DEBUG_LOG("node %s setRuntime(core:%d arch:%d)begin\n", this->nodeParameter.name().c_str(),
         cpuId, arch);
-    if (this->inferenceParameter[0] != std::string("NULL") && cpuId >= 0) {
+    if (this->inferenceParameter.size() > 0 &&
+        this->inferenceParameter[0] != std::string("NULL") && cpuId >= 0) {
         this->boltModel.set_runtime_device(cpuId, arch);
     } else {
         UNI_DEBUG_LOG("currently not support to setRuntime for no inference node\n");
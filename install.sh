@@ -176,7 +176,7 @@ If you don't want to  use ARM MALI GPU, you can add -g option to close ARM MALI
             -DUSE_ARMV7=OFF \
             -DUSE_FP32=ON \
             -DUSE_FP16=OFF \
-            -DUSE_INT8=OFF \
+            -DUSE_INT8=ON \
             -DCMAKE_C_COMPILER=`which gcc` \
             -DCMAKE_CXX_COMPILER=`which g++` \
             -DCMAKE_STRIP=`which strip` "
@@ -194,7 +194,7 @@ If you don't want to  use ARM MALI GPU, you can add -g option to close ARM MALI
             -DUSE_ARMV7=OFF \
             -DUSE_FP32=ON \
             -DUSE_FP16=OFF \
-            -DUSE_INT8=OFF \
+            -DUSE_INT8=ON \
             -DCMAKE_C_COMPILER=`which x86_64-linux-android21-clang` \
             -DCMAKE_CXX_COMPILER=`which x86_64-linux-android21-clang++` \
             -DCMAKE_STRIP=`which x86_64-linux-android-strip` "
@@ -0,0 +1,248 @@
+// Copyright (C) 2019. Huawei Technologies Co., Ltd. All rights reserved.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef _H_EPILOGUEOPTIMIZER
+#define _H_EPILOGUEOPTIMIZER
+
+#include <map>
+#include <utility>
+#include "OPOptimizer.hpp"
+
+// Fuse the epilogues of the convolutions and the fully connected layers
+//     Conv, Eltwise(sum with the residual), [activation]
+//     FC, [Eltwise(sum with the residual)], [activation]
+// into the Conv or FC, which takes the residual as its second input, and adds it and applies the
+// activation to each block of the output while the block is in the cache. FullyConnectedParamSpec
+// has no room for the activation, so it is kept in fcActivations for the engine to set. Only the
+// CPU implements the epilogues, so the engine applies this optimizer when the model is loaded for
+// the CPU instead of X2bolt.
+class EpilogueOptimizer : public OPOptimizer {
+public:
+    bool optimize(ModelSpec *spec) override
+    {
+        bool hasOptimized = false;
+        for (int i = 0; i < spec->num_operator_specs; i++) {
+            if (spec->ops[i].type == OT_Conv || spec->ops[i].type == OT_FC) {
+                hasOptimized |= fuse(spec, i);
+            }
+        }
+        return hasOptimized;
+    }
+
+    // the activations of the fused fully connected layers by their names
+    std::map<std::string, ActivationParamSpec> fcActivations;
+
+private:
+    // the only reader of the tensor written by index, or -1. The output of the model can only be
+    // read by the in-place operator that writes the final value of it.
+    int uniqueConsumer(ModelSpec *spec, int index, const char *tensorName)
+    {
+        std::vector<std::pair<int, int>> consumers =
+            searchOperatorIndexByInput(spec, tensorName, index + 1);
+        if (consumers.size() != 1) {
+            return -1;
+        }
+        int next = consumers[0].first;
+        if (searchString(spec->output_names, spec->num_outputs, tensorName).size() > 0 &&
+            searchString(spec->ops[next].output_tensors_name, spec->ops[next].num_outputs,
+                tensorName)
+                    .size() == 0) {
+            return -1;
+        }
+        return next;
+    }
+
+    // the activations that the epilogues apply without any parameter
+    bool getActivationMode(OperatorSpec *op, ActivationMode *mode)
+    {
+        if (op->num_inputs != 1 || op->num_outputs != 1) {
+            return false;
+        }
+        switch (op->type) {
+            case OT_Relu: {
+                if (op->ps.relu_spec.neg_slope != 0) {
+                    return false;
+                }
+                *mode = ACTIVATION_RELU;
+                break;
+            }
+            case OT_Relu6: {
+                *mode = ACTIVATION_RELU6;
+                break;
+            }
+            case OT_Sigmoid: {
+                *mode = ACTIVATION_SIGMOID;
+                break;
+            }
+            case OT_TanH: {
+                *mode = ACTIVATION_TANH;
+                break;
+            }
+            case OT_HSwish: {
+                *mode = ACTIVATION_H_SWISH;
+                break;
+            }
+            case OT_HSigmoid: {
+                *mode = ACTIVATION_H_SIGMOID;
+                break;
+            }
+            case OT_Gelu: {
+                *mode = ACTIVATION_GELU;
+                break;
+            }
+            case OT_Mish: {
+                *mode = ACTIVATION_MISH;
+                break;
+            }
+            default:
+                return false;
+        }
+        return true;
+    }
+
+    // whether the tensor read by index is written by the operators before last
+    bool isOverwritten(ModelSpec *spec, const char *tensorName, int index, int last)
+    {
+        for (int j = index + 1; j < last; j++) {
+            if (isValidOperator(spec, j) &&
+                searchString(spec->ops[j].output_tensors_name, spec->ops[j].num_outputs, tensorName)
+                        .size() > 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool fuse(ModelSpec *spec, int index)
+    {
+        OperatorSpec *op = &(spec->ops[index]);
+        // the fused operators are visited again in their new places
+        if (op->num_inputs != 1 || op->num_outputs != 1 || searchWeightIndex(spec, op->name) < 0 ||
+            this->fcActivations.find(op->name) != this->fcActivations.end()) {
+            return false;
+        }
+        if (op->type == OT_Conv) {
+            ConvolutionParamSpec p = op->ps.conv_spec;
+            if ((p.convolution_type != Convolution_Pointwise &&
+                    p.convolution_type != Convolution_Dilation) ||
+                p.pw_activation_type != ACTIVATION_NULL) {
+                return false;
+            }
+        } else if (op->ps.fc_spec.num_slices != 1) {
+            return false;
+        }
+
+        std::string input = op->input_tensors_name[0];
+        std::string residual;
+        I32 residualPosition = -1;
+        int residualIndex = -1;
+        ActivationMode mode = ACTIVATION_NULL;
+        int last = index;
+        std::vector<int> fused;
+        int next = uniqueConsumer(spec, index, op->output_tensors_name[0]);
+        if (next >= 0 && spec->ops[next].type == OT_Eltwise) {
+            OperatorSpec *eltwise = &(spec->ops[next]);
+            EltwiseParamSpec p = eltwise->ps.eltwise_spec;
+            bool unitCoeff = true;
+            for (int j = 0; j < p.elt_sum_spec.coeff_size; j++) {
+                unitCoeff = unitCoeff && (p.elt_sum_spec.coeff_values[j] == 1);
+            }
+            if (eltwise->num_inputs != 2 || eltwise->num_outputs != 1 ||
+                p.elt_mode != ELTWISE_SUM || !unitCoeff ||
+                (p.activation_type == ACTIVATION_RELU &&
+                    p.activation_spec.relu_spec.neg_slope != 0) ||
+                std::string(eltwise->input_tensors_name[0]) == eltwise->input_tensors_name[1]) {
+                return false;
+            }
+            // the kernels write the output blocks before they read the residual
+            if (searchString(eltwise->input_tensors_name, 2, eltwise->output_tensors_name[0])
+                    .size() > 0) {
+                return false;
+            }
+            int residualInput =
+                (std::string(eltwise->input_tensors_name[0]) == op->output_tensors_name[0]) ? 1 : 0;
+            residual = eltwise->input_tensors_name[residualInput];
+            if (eltwise->tensor_positions != nullptr) {
+                residualPosition = eltwise->tensor_positions[residualInput];
+            }
+            residualIndex = next;
+            mode = p.activation_type;
+            last = next;
+            fused.push_back(next);
+            next = uniqueConsumer(spec, next, eltwise->output_tensors_name[0]);
+        }
+        if (mode == ACTIVATION_NULL && next >= 0 && getActivationMode(&(spec->ops[next]), &mode)) {
+            last = next;
+            fused.push_back(next);
+        }
+        // the convolutions apply the activations by themselves
+        if (last == index || (op->type == OT_Conv && residualIndex < 0)) {
+            return false;
+        }
+        OperatorSpec *target = &(spec->ops[last]);
+        std::string output = target->output_tensors_name[0];
+        if (output == input || output == residual ||
+            isOverwritten(spec, input.c_str(), index, last) ||
+            (residualIndex >= 0 && isOverwritten(spec, residual.c_str(), residualIndex, last))) {
+            return false;
+        }
+
+        // the fused operator runs in place of the last one, which keeps its output
+        std::vector<std::string> inputs = {input};
+        if (residualIndex >= 0) {
+            inputs.push_back(residual);
+        }
+        if (target->tensor_positions != nullptr && op->tensor_positions != nullptr) {
+            std::vector<I32> positions = {op->tensor_positions[0]};
+            if (residualIndex >= 0) {
+                positions.push_back(residualPosition);
+            }
+            positions.push_back(target->tensor_positions[target->num_inputs]);
+            delete target->tensor_positions;
+            target->tensor_positions = (I32 *)mt_new_storage(positions.size() * sizeof(I32));
+            memcpy(target->tensor_positions, positions.data(), positions.size() * sizeof(I32));
+        }
+        for (U32 j = 0; j < target->num_inputs; j++) {
+            delete target->input_tensors_name[j];
+        }
+        delete target->input_tensors_name;
+        target->num_inputs = inputs.size();
+        target->input_tensors_name = (I8 **)mt_new_storage(target->num_inputs * sizeof(I8 *));
+        for (U32 j = 0; j < target->num_inputs; j++) {
+            target->input_tensors_name[j] = (I8 *)mt_new_storage(NAME_LEN * sizeof(I8));
+            str_copy(target->input_tensors_name[j], inputs[j].c_str(), NAME_LEN);
+        }
+        str_copy(target->name, op->name, NAME_LEN);
+        target->type = op->type;
+        target->ps = op->ps;
+        std::swap(target->num_quant_feature, op->num_quant_feature);
+        std::swap(target->feature_scale, op->feature_scale);
+        if (op->type == OT_Conv) {
+            target->ps.conv_spec.pw_activation_type = mode;
+            target->ps.conv_spec.activation_spec.relu_spec.neg_slope = 0;
+        } else if (mode != ACTIVATION_NULL) {
+            ActivationParamSpec activationDesc;
+            activationDesc.mode = mode;
+            activationDesc.value[0] = 0;
+            this->fcActivations[target->name] = activationDesc;
+        }
+        setOperatorInvalid(spec, index);
+        for (int j : fused) {
+            if (j != last) {
+                setOperatorInvalid(spec, j);
+            }
+        }
+        return true;
+    }
+};
+#endif
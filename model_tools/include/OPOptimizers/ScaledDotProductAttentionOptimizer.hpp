@@ -0,0 +1,237 @@
+// Copyright (C) 2019. Huawei Technologies Co., Ltd. All rights reserved.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef _H_SCALEDDOTPRODUCTATTENTIONOPTIMIZER
+#define _H_SCALEDDOTPRODUCTATTENTIONOPTIMIZER
+
+#include <algorithm>
+#include "OPOptimizer.hpp"
+
+// Fuse the attention of the transformer models
+//     Transpose(Q), Transpose(K), Transpose(V), MatMul, [Power], [Eltwise(mask)], Softmax,
+//     MatMul, Transpose
+// into OT_ScaledDotProductAttention, which reads Q/K/V as [batch, length, heads, size] and
+// writes [batch, length, heads, size]. Only the CPU implements the operator, so the engine
+// applies this optimizer when the model is loaded for the CPU instead of X2bolt.
+class ScaledDotProductAttentionOptimizer : public OPOptimizer {
+    bool optimize(ModelSpec *spec) override
+    {
+        bool hasOptimized = false;
+        for (int i = 0; i < spec->num_operator_specs; i++) {
+            if (spec->ops[i].type == OT_Softmax) {
+                hasOptimized |= fuse(spec, i);
+            }
+        }
+        return hasOptimized;
+    }
+
+    // the nearest operator before index that writes the tensor
+    int producer(ModelSpec *spec, int index, const char *tensorName)
+    {
+        for (int i = index - 1; i >= 0; i--) {
+            if (!isValidOperator(spec, i)) {
+                continue;
+            }
+            for (U32 j = 0; j < spec->ops[i].num_outputs; j++) {
+                if (std::string(spec->ops[i].output_tensors_name[j]) == tensorName) {
+                    return i;
+                }
+            }
+        }
+        return -1;
+    }
+
+    // the only reader of the tensor written by index, or -1
+    int uniqueConsumer(ModelSpec *spec, int index, const char *tensorName)
+    {
+        if (searchString(spec->output_names, spec->num_outputs, tensorName).size() > 0) {
+            return -1;
+        }
+        std::vector<std::pair<int, int>> consumers =
+            searchOperatorIndexByInput(spec, tensorName, index + 1);
+        if (consumers.size() != 1) {
+            return -1;
+        }
+        return consumers[0].first;
+    }
+
+    bool isTranspose(ModelSpec *spec, int index, const U32 *dims)
+    {
+        if (index < 0 || spec->ops[index].type != OT_Transpose) {
+            return false;
+        }
+        TransposeParamSpec p = spec->ops[index].ps.transpose_spec;
+        if (p.trans_size != 4) {
+            return false;
+        }
+        for (U32 i = 0; i < p.trans_size; i++) {
+            if (p.trans_dims[i] != dims[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool fuse(ModelSpec *spec, int softmaxIndex)
+    {
+        const U32 headsFirst[4] = {0, 2, 1, 3};
+        const U32 keysLast[4] = {0, 2, 3, 1};
+        int axis = spec->ops[softmaxIndex].ps.softmax_spec.axis;
+        if (axis != -1 && axis != 3) {
+            return false;
+        }
+        std::vector<int> fused = {softmaxIndex};
+        F32 scale = 1;
+        const char *mask = nullptr;
+        I32 maskPosition = -1;
+        int maskIndex = -1;
+
+        int index = producer(spec, softmaxIndex, spec->ops[softmaxIndex].input_tensors_name[0]);
+        if (index >= 0 && spec->ops[index].type == OT_Eltwise) {
+            EltwiseParamSpec p = spec->ops[index].ps.eltwise_spec;
+            if (spec->ops[index].num_inputs != 2 || p.elt_mode != ELTWISE_SUM ||
+                p.activation_type != ACTIVATION_NULL || p.elt_sum_spec.coeff_size > 0) {
+                return false;
+            }
+            int scoreInput = -1;
+            for (int j = 0; j < 2; j++) {
+                // the mask may also be scaled by a power
+                int prev = producer(spec, index, spec->ops[index].input_tensors_name[j]);
+                if (prev >= 0 && spec->ops[prev].type == OT_Power) {
+                    prev = producer(spec, prev, spec->ops[prev].input_tensors_name[0]);
+                }
+                if (prev >= 0 && spec->ops[prev].type == OT_MatMul) {
+                    scoreInput = j;
+                    break;
+                }
+            }
+            if (scoreInput < 0) {
+                return false;
+            }
+            mask = spec->ops[index].input_tensors_name[1 - scoreInput];
+            maskIndex = index;
+            if (spec->ops[index].tensor_positions != nullptr) {
+                maskPosition = spec->ops[index].tensor_positions[1 - scoreInput];
+            }
+            fused.push_back(index);
+            index = producer(spec, index, spec->ops[index].input_tensors_name[scoreInput]);
+        }
+        if (index >= 0 && spec->ops[index].type == OT_Power) {
+            PowerParamSpec p = spec->ops[index].ps.power_spec;
+            if (p.shift != 0 || p.power != 1) {
+                return false;
+            }
+            scale = p.scale;
+            fused.push_back(index);
+            index = producer(spec, index, spec->ops[index].input_tensors_name[0]);
+        }
+        if (index < 0 || spec->ops[index].type != OT_MatMul ||
+            spec->ops[index].ps.matmul_spec.transpose_a) {
+            return false;
+        }
+        int scoreIndex = index;
+        fused.push_back(scoreIndex);
+        int qIndex = producer(spec, scoreIndex, spec->ops[scoreIndex].input_tensors_name[0]);
+        int kIndex = producer(spec, scoreIndex, spec->ops[scoreIndex].input_tensors_name[1]);
+        bool transposeB = spec->ops[scoreIndex].ps.matmul_spec.transpose_b;
+        if (!isTranspose(spec, qIndex, headsFirst) ||
+            !isTranspose(spec, kIndex, transposeB ? headsFirst : keysLast)) {
+            return false;
+        }
+        fused.push_back(qIndex);
+        fused.push_back(kIndex);
+
+        int contextIndex =
+            uniqueConsumer(spec, softmaxIndex, spec->ops[softmaxIndex].output_tensors_name[0]);
+        if (contextIndex < 0 || spec->ops[contextIndex].type != OT_MatMul ||
+            spec->ops[contextIndex].ps.matmul_spec.transpose_a ||
+            spec->ops[contextIndex].ps.matmul_spec.transpose_b ||
+            std::string(spec->ops[contextIndex].input_tensors_name[0]) !=
+                spec->ops[softmaxIndex].output_tensors_name[0]) {
+            return false;
+        }
+        fused.push_back(contextIndex);
+        int vIndex = producer(spec, contextIndex, spec->ops[contextIndex].input_tensors_name[1]);
+        if (!isTranspose(spec, vIndex, headsFirst)) {
+            return false;
+        }
+        fused.push_back(vIndex);
+        int outputIndex =
+            uniqueConsumer(spec, contextIndex, spec->ops[contextIndex].output_tensors_name[0]);
+        if (!isTranspose(spec, outputIndex, headsFirst)) {
+            return false;
+        }
+
+        // every intermediate tensor is only read by the next fused operator
+        for (int j : fused) {
+            if (spec->ops[j].num_outputs != 1 || searchWeightIndex(spec, spec->ops[j].name) >= 0) {
+                return false;
+            }
+            int next = uniqueConsumer(spec, j, spec->ops[j].output_tensors_name[0]);
+            bool isFused = std::find(fused.begin(), fused.end(), next) != fused.end();
+            if (next < 0 || (next != outputIndex && !isFused)) {
+                return false;
+            }
+        }
+        // the inputs are not overwritten before the fused operator runs in place of the last
+        // transpose
+        std::vector<std::pair<std::string, int>> inputs = {
+            {spec->ops[qIndex].input_tensors_name[0], qIndex},
+            {spec->ops[kIndex].input_tensors_name[0], kIndex},
+            {spec->ops[vIndex].input_tensors_name[0], vIndex}};
+        if (mask != nullptr) {
+            inputs.push_back(std::make_pair(std::string(mask), maskIndex));
+        }
+        for (auto input : inputs) {
+            for (int j = input.second + 1; j < outputIndex; j++) {
+                if (isValidOperator(spec, j) &&
+                    searchString(spec->ops[j].output_tensors_name, spec->ops[j].num_outputs,
+                        input.first.c_str())
+                            .size() > 0) {
+                    return false;
+                }
+            }
+        }
+
+        OperatorSpec *op = &(spec->ops[outputIndex]);
+        std::vector<I32> positions;
+        if (op->tensor_positions != nullptr) {
+            positions = {spec->ops[qIndex].tensor_positions[0],
+                spec->ops[kIndex].tensor_positions[0], spec->ops[vIndex].tensor_positions[0]};
+            if (mask != nullptr) {
+                positions.push_back(maskPosition);
+            }
+            positions.push_back(op->tensor_positions[1]);
+            delete op->tensor_positions;
+            op->tensor_positions = (I32 *)mt_new_storage(positions.size() * sizeof(I32));
+            memcpy(op->tensor_positions, positions.data(), positions.size() * sizeof(I32));
+        }
+        for (U32 j = 0; j < op->num_inputs; j++) {
+            delete op->input_tensors_name[j];
+        }
+        delete op->input_tensors_name;
+        op->num_inputs = inputs.size();
+        op->input_tensors_name = (I8 **)mt_new_storage(op->num_inputs * sizeof(I8 *));
+        for (U32 j = 0; j < op->num_inputs; j++) {
+            op->input_tensors_name[j] = (I8 *)mt_new_storage(NAME_LEN * sizeof(I8));
+            str_copy(op->input_tensors_name[j], inputs[j].first.c_str(), NAME_LEN);
+        }
+        op->type = OT_ScaledDotProductAttention;
+        op->ps.scaled_dot_product_attention_spec.scale = scale;
+        for (int j : fused) {
+            setOperatorInvalid(spec, j);
+        }
+        return true;
+    }
+};
+#endif
@@ -419,5 +419,8 @@ EE ms_datatype_converter(
         targetMs->num_op_tensor_entries = 0;
         targetMs->op_relationship_entries = nullptr;
     }
+    // packed weights are only valid for the original precision
+    targetMs->num_packed_weight_specs = 0;
+    targetMs->pws = nullptr;
     return SUCCESS;
 }
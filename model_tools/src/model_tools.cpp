@@ -35,6 +35,9 @@ extern "C" EE mt_create_model(ModelSpec *ms)
     ms->ws = nullptr;
     ms->num_op_tensor_entries = 0;
     ms->op_relationship_entries = nullptr;
+    ms->num_packed_weight_specs = 0;
+    ms->pws = nullptr;
+    ms->mfd = nullptr;
 
     return SUCCESS;
 }
@@ -118,11 +121,11 @@ extern "C" EE mt_destroy_model(ModelSpec *ms)
     if (nullptr != ms->ws) {
         int weightOpNum = ms->num_weight_specs;
         for (int i = 0; i < weightOpNum; i++) {
-            if (nullptr != ms->ws[i].weight) {
+            if (nullptr != ms->ws[i].weight && !is_model_file_memory(ms, ms->ws[i].weight)) {
                 delete ms->ws[i].weight;
             }
             ms->ws[i].weight = nullptr;
-            if (nullptr != ms->ws[i].vec) {
+            if (nullptr != ms->ws[i].vec && !is_model_file_memory(ms, ms->ws[i].vec)) {
                 delete ms->ws[i].vec;
             }
             ms->ws[i].vec = nullptr;
@@ -159,6 +162,29 @@ extern "C" EE mt_destroy_model(ModelSpec *ms)
         ms->op_relationship_entries = nullptr;
     }
 
+    if (nullptr != ms->pws) {
+        for (int i = 0; i < ms->num_packed_weight_specs; i++) {
+            for (U32 j = 0; j < ms->pws[i].num_weights; j++) {
+                if (nullptr != ms->pws[i].weights[j] &&
+                    !is_model_file_memory(ms, ms->pws[i].weights[j])) {
+                    delete ms->pws[i].weights[j];
+                }
+                ms->pws[i].weights[j] = nullptr;
+            }
+            delete ms->pws[i].weights;
+            delete ms->pws[i].weight_descs;
+            delete ms->pws[i].weight_bytes;
+            delete ms->pws[i].weight_offsets;
+        }
+        delete ms->pws;
+        ms->pws = nullptr;
+    }
+
+    if (nullptr != ms->mfd) {
+        CHECK_STATUS(release_model_file(ms->mfd));
+        ms->mfd = nullptr;
+    }
+
     return SUCCESS;
 }
 
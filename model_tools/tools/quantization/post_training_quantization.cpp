@@ -26,7 +26,8 @@ void print_quantization_usage()
                  "_ptq_input.bolt.\n"
                  "2. -i [inferencePrecision]: The inference precision. Currently, you can only "
                  "choose one of "
-                 "{FP32, FP16, INT8}. Default is INT8.\n"
+                 "{FP32, FP16, INT8, INT8_FP32}. Default is INT8. INT8_FP32 keeps the "
+                 "unquantized operators in FP32 for x86.\n"
                  "3. -b [BatchNormFusion]: Whether to fuse convolution or FC with BN. Default is "
                  "true.\n"
                  "4. -q [quantStorage]: Store model in quantized form. You can choose one of"
@@ -115,6 +116,8 @@ int main(int argc, char *argv[])
     DataConvertType converterMode = F32_to_F16;
     if (inferPrecision == std::string("INT8")) {
         converterMode = F32_to_F16;
+    } else if (inferPrecision == std::string("INT8_FP32")) {
+        converterMode = F32_to_F32;
     } else if (inferPrecision == std::string("HIDDEN")) {
         converterMode = F32_to_F16;
     } else if (inferPrecision == std::string("FP16")) {
@@ -134,6 +137,8 @@ int main(int argc, char *argv[])
     CHECK_STATUS(ms_datatype_converter(&ms, targetMs, converterMode, quantStorage));
     if ("INT8" == std::string(inferPrecision)) {
         targetMs->dt = DT_F16_8Q;
+    } else if ("INT8_FP32" == std::string(inferPrecision)) {
+        targetMs->dt = DT_F32_8Q;
     }
 
     if (nullptr != scaleFile) {
@@ -146,6 +151,8 @@ int main(int argc, char *argv[])
 #if _USE_INT8
     } else if (std::string(inferPrecision).compare(std::string("INT8")) == 0) {
         storePath += std::string("int8_q.bolt");
+    } else if (std::string(inferPrecision).compare(std::string("INT8_FP32")) == 0) {
+        storePath += std::string("int8_f32_q.bolt");
 #endif
 #if _USE_FP16
     } else if (std::string(inferPrecision).compare(std::string("FP16")) == 0) {
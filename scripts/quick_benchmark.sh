@@ -118,6 +118,9 @@ adb -s ${device} push ${host_dir}/tests/test_mmm_int8 ${device_dir} > /dev/null
 adb -s ${device} push ${host_dir}/tests/test_mmm ${device_dir} > /dev/null || exit 1
 echo " " ; echo "--- Matrix Matrix Multiplication"
 device_excute ${device_dir}/test_mmm 384 768 768
+# the attention score and context of BERT base with 12 heads and 128 words
+device_excute ${device_dir}/test_mmm 128 64 128 12 12
+device_excute ${device_dir}/test_mmm 128 128 64 12 12
 
 # conv_ic=3
 adb -s ${device} push ${host_dir}/tests/test_convolution ${device_dir} > /dev/null || exit 1